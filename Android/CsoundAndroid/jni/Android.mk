@@ -33,7 +33,11 @@ $(CSOUND_SRC_ROOT)/Engine/entry1.c \
 $(CSOUND_SRC_ROOT)/Engine/envvar.c \
 $(CSOUND_SRC_ROOT)/Engine/extract.c \
 $(CSOUND_SRC_ROOT)/Engine/fgens.c \
+$(CSOUND_SRC_ROOT)/Engine/fgens_cache.c \
+$(CSOUND_SRC_ROOT)/Engine/fgens_mipmap.c \
+$(CSOUND_SRC_ROOT)/Engine/housekeep.c \
 $(CSOUND_SRC_ROOT)/Engine/insert.c \
+$(CSOUND_SRC_ROOT)/Engine/iouring.c \
 $(CSOUND_SRC_ROOT)/Engine/linevent.c \
 $(CSOUND_SRC_ROOT)/Engine/memalloc.c \
 $(CSOUND_SRC_ROOT)/Engine/memfiles.c \
@@ -63,6 +67,7 @@ $(CSOUND_SRC_ROOT)/InOut/circularbuffer.c \
 $(CSOUND_SRC_ROOT)/OOps/aops.c \
 $(CSOUND_SRC_ROOT)/OOps/bus.c \
 $(CSOUND_SRC_ROOT)/OOps/cmath.c \
+$(CSOUND_SRC_ROOT)/OOps/delayline.c \
 $(CSOUND_SRC_ROOT)/OOps/diskin2.c \
 $(CSOUND_SRC_ROOT)/OOps/disprep.c \
 $(CSOUND_SRC_ROOT)/OOps/dumpf.c \
@@ -74,11 +79,13 @@ $(CSOUND_SRC_ROOT)/OOps/midiinterop.c \
 $(CSOUND_SRC_ROOT)/OOps/midiops.c \
 $(CSOUND_SRC_ROOT)/OOps/midiout.c \
 $(CSOUND_SRC_ROOT)/OOps/mxfft.c \
+$(CSOUND_SRC_ROOT)/OOps/oscbank.c \
 $(CSOUND_SRC_ROOT)/OOps/oscils.c \
 $(CSOUND_SRC_ROOT)/OOps/pstream.c \
 $(CSOUND_SRC_ROOT)/OOps/pvfileio.c \
 $(CSOUND_SRC_ROOT)/OOps/pvsanal.c \
 $(CSOUND_SRC_ROOT)/OOps/random.c \
+$(CSOUND_SRC_ROOT)/OOps/resample.c \
 $(CSOUND_SRC_ROOT)/OOps/remote.c \
 $(CSOUND_SRC_ROOT)/OOps/schedule.c \
 $(CSOUND_SRC_ROOT)/OOps/sndinfUG.c \
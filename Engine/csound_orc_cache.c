@@ -0,0 +1,351 @@
+/*
+    csound_orc_cache.c:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Persistent cache of parsed orchestras.
+ *
+ * When the CSORCCACHE environment variable names a directory, the AST
+ * produced by the bison parser for a given preprocessed orchestra is
+ * written there, and later compilations of the same text load it instead
+ * of running the lexer and parser again.  The cache key combines the
+ * preprocessed source, the set of opcodes known to the instance (the lexer
+ * tells opcodes from identifiers by looking them up) and the engine
+ * version.  Semantic analysis still runs on the loaded tree, since its
+ * results refer to per-instance opcode entries and variable pools.
+ */
+
+#include "csoundCore.h"
+#include "csound_orc.h"
+#include "corfile.h"
+#include "tok.h"
+
+
+extern int add_udo_definition(CSOUND*, char *, char *, char *);
+extern int check_udo_definition(CSOUND*, char *, char *, char *);
+
+#define ORC_CACHE_MAGIC     "CSORCC01"
+
+#define NODE_HAS_VALUE      1
+#define NODE_HAS_LEFT       2
+#define NODE_HAS_RIGHT      4
+#define NODE_HAS_NEXT       8
+
+#define NO_STRING           0xFFFFFFFFU
+
+static inline uint64_t fnv1a(uint64_t h, const void *p, size_t n)
+{
+    const uint8_t *s = (const uint8_t*) p;
+    while (n--) {
+      h ^= *s++;
+      h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static uint64_t opcode_set_fingerprint(CSOUND *csound)
+{
+    CONS_CELL *top, *head, *items;
+    uint64_t  sum = 0, cnt = 0;
+
+    top = head = opcode_table_values(csound);
+    for ( ; head != NULL; head = head->next) {
+      for (items = head->value; items != NULL; items = items->next) {
+        OENTRY   *ep = items->value;
+        uint64_t h = 0xcbf29ce484222325ULL;
+        h = fnv1a(h, ep->opname, strlen(ep->opname) + 1);
+        if (ep->outypes != NULL)
+          h = fnv1a(h, ep->outypes, strlen(ep->outypes) + 1);
+        if (ep->intypes != NULL)
+          h = fnv1a(h, ep->intypes, strlen(ep->intypes) + 1);
+        /* the table is unordered, so combine commutatively */
+        sum += h * 0x9e3779b97f4a7c15ULL;
+        cnt++;
+      }
+    }
+    cs_cons_free(csound, top);
+    return sum ^ cnt;
+}
+
+static uint64_t orc_cache_key(CSOUND *csound, CORFIL *src)
+{
+    uint64_t h = 0xcbf29ce484222325ULL, fp;
+    int32_t  ver[6];
+
+    ver[0] = CS_VERSION; ver[1] = CS_SUBVER; ver[2] = CS_PATCHLEVEL;
+    ver[3] = CS_APIVERSION; ver[4] = (int32_t) sizeof(MYFLT);
+    ver[5] = T_HIGHEST;
+    h = fnv1a(h, ORC_CACHE_MAGIC, sizeof(ORC_CACHE_MAGIC));
+    h = fnv1a(h, ver, sizeof(ver));
+    fp = opcode_set_fingerprint(csound);
+    h = fnv1a(h, &fp, sizeof(fp));
+    h = fnv1a(h, corfile_body(src), (size_t) corfile_tell(src));
+    return h;
+}
+
+static char *orc_cache_path(CSOUND *csound, uint64_t key, const char *ext)
+{
+    const char *dir = csoundGetEnv(csound, "CSORCCACHE");
+    char       *path;
+    size_t     len;
+
+    if (dir == NULL || dir[0] == '\0')
+      return NULL;
+    len = strlen(dir) + 32;
+    path = csound->Malloc(csound, len);
+    snprintf(path, len, "%s%c%016llx.%s", dir, DIRSEP,
+             (unsigned long long) key, ext);
+    return path;
+}
+
+/* WRITING */
+
+static int write_string(FILE *f, const char *s)
+{
+    uint32_t len = (s == NULL ? NO_STRING : (uint32_t) strlen(s));
+    if (fwrite(&len, sizeof(uint32_t), 1, f) != 1)
+      return -1;
+    if (s != NULL && len > 0 && fwrite(s, 1, len, f) != len)
+      return -1;
+    return 0;
+}
+
+static int write_tree(FILE *f, TREE *l)
+{
+    for ( ; l != NULL; l = l->next) {
+      int32_t  hdr[4];
+      uint64_t locn = l->locn;
+      uint8_t  flags = (l->value != NULL ? NODE_HAS_VALUE : 0) |
+                       (l->left != NULL ? NODE_HAS_LEFT : 0) |
+                       (l->right != NULL ? NODE_HAS_RIGHT : 0) |
+                       (l->next != NULL ? NODE_HAS_NEXT : 0);
+      hdr[0] = l->type; hdr[1] = l->rate; hdr[2] = l->len; hdr[3] = l->line;
+      if (fwrite(hdr, sizeof(hdr), 1, f) != 1 ||
+          fwrite(&locn, sizeof(locn), 1, f) != 1 ||
+          fwrite(&flags, 1, 1, f) != 1)
+        return -1;
+      if (l->value != NULL) {
+        int32_t tok[2];
+        double  fvalue = l->value->fvalue;
+        tok[0] = l->value->type; tok[1] = l->value->value;
+        if (fwrite(tok, sizeof(tok), 1, f) != 1 ||
+            fwrite(&fvalue, sizeof(fvalue), 1, f) != 1 ||
+            write_string(f, l->value->lexeme) != 0 ||
+            write_string(f, l->value->optype) != 0)
+          return -1;
+      }
+      if (l->left != NULL && write_tree(f, l->left) != 0)
+        return -1;
+      if (l->right != NULL && write_tree(f, l->right) != 0)
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Stores the AST of a freshly parsed orchestra under 'key'. Must be called
+ * before semantic analysis modifies the tree. Failures are not fatal; the
+ * cache entry is simply not written.
+ */
+void csound_orc_cache_store(CSOUND *csound, uint64_t key, TREE *root)
+{
+    char  *path, *tmp;
+    FILE  *f;
+    int   err;
+
+    if ((path = orc_cache_path(csound, key, "orcc")) == NULL)
+      return;
+    tmp = orc_cache_path(csound, key, "tmp");
+    if ((f = fopen(tmp, "wb")) == NULL) {
+      csound->Warning(csound, Str("orchestra cache: cannot write %s\n"), tmp);
+      goto done;
+    }
+    err = (fwrite(ORC_CACHE_MAGIC, 1, 8, f) != 8 ||
+           fwrite(&key, sizeof(key), 1, f) != 1 ||
+           write_tree(f, root) != 0);
+    err |= (fclose(f) != 0);
+    /* write then rename, so that concurrent readers never see a partial file */
+    if (err || rename(tmp, path) != 0) {
+      csound->Warning(csound, Str("orchestra cache: cannot write %s\n"), path);
+      remove(tmp);
+    }
+    else if (UNLIKELY(csound->oparms->odebug))
+      csound->Message(csound, Str("orchestra cache: stored %s\n"), path);
+ done:
+    csound->Free(csound, tmp);
+    csound->Free(csound, path);
+}
+
+/* READING */
+
+static char *read_string(CSOUND *csound, FILE *f, int *err)
+{
+    uint32_t len;
+    char     *s;
+    if (fread(&len, sizeof(uint32_t), 1, f) != 1) {
+      *err = 1;
+      return NULL;
+    }
+    if (len == NO_STRING)
+      return NULL;
+    if (len > 0x7FFFFFF) {
+      *err = 1;
+      return NULL;
+    }
+    s = csound->Malloc(csound, len + 1);
+    if (len > 0 && fread(s, 1, len, f) != len)
+      *err = 1;
+    s[len] = '\0';
+    return s;
+}
+
+static TREE *read_tree(CSOUND *csound, FILE *f, int *err)
+{
+    TREE    *first = NULL, **prev = &first;
+    uint8_t flags;
+
+    do {
+      int32_t  hdr[4];
+      uint64_t locn;
+      TREE     *l;
+      if (fread(hdr, sizeof(hdr), 1, f) != 1 ||
+          fread(&locn, sizeof(locn), 1, f) != 1 ||
+          fread(&flags, 1, 1, f) != 1) {
+        *err = 1;
+        break;
+      }
+      l = make_leaf(csound, hdr[3], (int) locn, hdr[0], NULL);
+      l->rate = hdr[1];
+      l->len = hdr[2];
+      l->locn = locn;
+      *prev = l;
+      prev = &l->next;
+      if (flags & NODE_HAS_VALUE) {
+        int32_t  tok[2];
+        ORCTOKEN *v = new_token(csound, 0);
+        l->value = v;
+        if (fread(tok, sizeof(tok), 1, f) != 1 ||
+            fread(&v->fvalue, sizeof(double), 1, f) != 1) {
+          *err = 1;
+          break;
+        }
+        v->type = tok[0];
+        v->value = tok[1];
+        v->lexeme = read_string(csound, f, err);
+        v->optype = read_string(csound, f, err);
+        if (*err) break;
+      }
+      if (flags & NODE_HAS_LEFT) {
+        l->left = read_tree(csound, f, err);
+        if (*err) break;
+      }
+      if (flags & NODE_HAS_RIGHT) {
+        l->right = read_tree(csound, f, err);
+        if (*err) break;
+      }
+    } while (flags & NODE_HAS_NEXT);
+    return first;
+}
+
+/* redo what the parser does as a side effect while reading UDO headers;
+   every header is checked before any is added, since a definition cannot
+   be taken back, so that an invalid entry leaves the instance untouched */
+static int replay_udo_definitions(CSOUND *csound, TREE *root)
+{
+    TREE *l;
+
+    for (l = root; l != NULL; l = l->next) {
+      if (l->type == UDO_TOKEN) {
+        TREE *ident = l->left;
+        if (UNLIKELY(ident == NULL || ident->value == NULL ||
+                     ident->left == NULL || ident->left->value == NULL ||
+                     ident->right == NULL || ident->right->value == NULL ||
+                     ident->value->lexeme == NULL ||
+                     ident->left->value->lexeme == NULL ||
+                     ident->right->value->lexeme == NULL))
+          return -1;
+        if (UNLIKELY(check_udo_definition(csound, ident->value->lexeme,
+                                          ident->left->value->lexeme,
+                                          ident->right->value->lexeme) != 0))
+          return -1;
+      }
+    }
+    for (l = root; l != NULL; l = l->next) {
+      if (l->type == UDO_TOKEN) {
+        TREE *ident = l->left;
+        add_udo_definition(csound, ident->value->lexeme,
+                           ident->left->value->lexeme,
+                           ident->right->value->lexeme);
+      }
+    }
+    return 0;
+}
+
+/**
+ * Computes the cache key for the preprocessed orchestra 'src' and, if a
+ * valid cache entry exists, loads its AST into *root. Returns non-zero on
+ * a cache hit. *key is set whenever caching is enabled (and to zero
+ * otherwise), so that a miss can be stored after parsing.
+ */
+int csound_orc_cache_load(CSOUND *csound, CORFIL *src,
+                          uint64_t *key, TREE **root)
+{
+    char     magic[8], *path;
+    uint64_t fkey;
+    FILE     *f;
+    TREE     *tree = NULL;
+    int      err = 0;
+
+    *key = 0;
+    *root = NULL;
+    /* the multicore analysis collects instrument data during the parse */
+    if (csound->oparms->numThreads > 1 ||
+        csoundGetEnv(csound, "CSORCCACHE") == NULL)
+      return 0;
+    *key = orc_cache_key(csound, src);
+    if (*key == 0) *key = 1;
+    path = orc_cache_path(csound, *key, "orcc");
+    f = fopen(path, "rb");
+    if (f == NULL) {
+      csound->Free(csound, path);
+      return 0;
+    }
+    if (fread(magic, 1, 8, f) != 8 || memcmp(magic, ORC_CACHE_MAGIC, 8) != 0 ||
+        fread(&fkey, sizeof(fkey), 1, f) != 1 || fkey != *key)
+      err = 1;
+    else
+      tree = read_tree(csound, f, &err);
+    fclose(f);
+    if (!err && replay_udo_definitions(csound, tree) != 0)
+      err = 1;
+    if (UNLIKELY(err)) {
+      csound->Warning(csound, Str("orchestra cache: ignoring invalid %s\n"),
+                      path);
+      csoundDeleteTree(csound, tree);
+      csound->Free(csound, path);
+      return 0;
+    }
+    if (UNLIKELY(csound->oparms->odebug))
+      csound->Message(csound, Str("orchestra cache: loaded %s\n"), path);
+    csound->Free(csound, path);
+    *root = tree;
+    return 1;
+}
@@ -34,6 +34,7 @@
 #include "insert.h"
 #include "oload.h"
 #include "pstream.h"
+#include "housekeep.h"
 //#include "typetabl.h"
 #include "csound_orc_semantics.h"
 #include "csound_standard_types.h"
@@ -57,7 +58,6 @@ void named_instr_assign_numbers(CSOUND *csound, ENGINE_STATE *engineState);
 int named_instr_alloc(CSOUND *csound, char *s, INSTRTXT *ip, int32 insno,
                       ENGINE_STATE *engineState, int merge);
 int check_instr_name(char *s);
-void free_instr_var_memory(CSOUND *, INSDS *);
 void mergeState_enqueue(CSOUND *csound, ENGINE_STATE *e, TYPE_TABLE *t,
                         OPDS *ids);
 
@@ -962,17 +962,13 @@ void deleteVarPoolMemory(void *csound, CS_VAR_POOL *pool);
 */
 void free_instrtxt(CSOUND *csound, INSTRTXT *instrtxt) {
   INSTRTXT *ip = instrtxt;
-  INSDS *active = ip->instance;
+  INSDS *active;
+  /* instances queued for housekeeping refer to the definition */
+  csoundHousekeepSync(csound);
+  active = ip->instance;
   while (active != NULL) { /* remove instance memory */
     INSDS *nxt = active->nxtinstance;
-    if (active->fdchp != NULL)
-      fdchclose(csound, active);
-    if (active->auxchp != NULL)
-      auxchfree(csound, active);
-    free_instr_var_memory(csound, active);
-    if (active->opcod_iobufs != NULL)
-      csound->Free(csound, active->opcod_iobufs);
-    csound->Free(csound, active);
+    csoundFreeInstance(csound, active);
     active = nxt;
   }
   OPTXT *t = ip->nxtop;
@@ -1589,6 +1585,201 @@ void merge_state(CSOUND *csound, ENGINE_STATE *engineState,
     csoundUnlockMutex(csound->init_pass_threadlock);
 }
 
+/* DEFINITION FINGERPRINTS
+
+   Each instrument and UDO body that has been compiled is fingerprinted, so
+   that a later compilation containing an identical definition (for instance
+   a live-coding client resending a whole file) keeps the existing template
+   instead of building and merging a new one.  The fingerprint covers the
+   verified tree of the body, without line numbers, and the signature of
+   every opcode it resolved to.  UDO bodies are bound at init time through
+   their OENTRY, so an instrument does not need recompiling when only the
+   body of a UDO it calls changes. */
+
+#define DEFN_FINGERPRINTS "::definitionFingerprints"
+
+typedef struct {
+  char *key;
+  uint64_t fp;
+} DEFN_FINGERPRINT;
+
+static CS_HASH_TABLE *definition_fingerprints(CSOUND *csound) {
+  CS_HASH_TABLE **p = (CS_HASH_TABLE **)
+    csound->QueryGlobalVariable(csound, DEFN_FINGERPRINTS);
+  if (p == NULL) {
+    if (UNLIKELY(csound->CreateGlobalVariable(csound, DEFN_FINGERPRINTS,
+                                              sizeof(CS_HASH_TABLE *)) != 0))
+      return NULL;
+    p = (CS_HASH_TABLE **)
+      csound->QueryGlobalVariable(csound, DEFN_FINGERPRINTS);
+    *p = cs_hash_table_create(csound);
+  }
+  return *p;
+}
+
+static inline uint64_t fp_mix(uint64_t h, const void *p, size_t n) {
+  const uint8_t *c = (const uint8_t *)p;
+  while (n--) {
+    h ^= *c++;
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+static inline uint64_t fp_mix_str(uint64_t h, const char *s) {
+  return (s == NULL) ? fp_mix(h, "", 1) : fp_mix(h, s, strlen(s) + 1);
+}
+
+static uint64_t fingerprint_node(uint64_t h, TREE *l, int statements) {
+  for (; l != NULL; l = l->next) {
+    int32_t hdr[3];
+    hdr[0] = l->type; hdr[1] = l->rate; hdr[2] = l->len;
+    h = fp_mix(h, hdr, sizeof(hdr));
+    if (l->value != NULL) {
+      h = fp_mix(h, &l->value->type, sizeof(int));
+      h = fp_mix(h, &l->value->value, sizeof(int));
+      h = fp_mix(h, &l->value->fvalue, sizeof(double));
+      h = fp_mix_str(h, l->value->lexeme);
+      h = fp_mix_str(h, l->value->optype);
+    }
+    if (statements && l->markup != NULL &&
+        (l->type == '=' || l->type == GOTO_TOKEN || l->type == IGOTO_TOKEN ||
+         l->type == KGOTO_TOKEN || l->type == T_OPCODE ||
+         l->type == T_OPCODE0)) {
+      OENTRY *ep = (OENTRY *)l->markup;
+      h = fp_mix_str(h, ep->opname);
+      h = fp_mix_str(h, ep->outypes);
+      h = fp_mix_str(h, ep->intypes);
+    }
+    h = fp_mix(h, "(", 1);
+    h = fingerprint_node(h, l->left, 0);
+    h = fp_mix(h, "|", 1);
+    h = fingerprint_node(h, l->right, 0);
+    h = fp_mix(h, ")", 1);
+  }
+  return h;
+}
+
+/* fingerprint of an INSTR_TOKEN or UDO_TOKEN node */
+static uint64_t fingerprint_definition(TREE *root) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  int32_t type = root->type;
+  h = fp_mix(h, &type, sizeof(type));
+  h = fingerprint_node(h, root->left, 0);
+  return fingerprint_node(h, root->right, 1);
+}
+
+static CONS_CELL *fingerprint_add(CSOUND *csound, CONS_CELL *pending,
+                                  const char *key, uint64_t fp) {
+  DEFN_FINGERPRINT *d = csound->Malloc(csound, sizeof(DEFN_FINGERPRINT));
+  d->key = cs_strdup(csound, (char *)key);
+  d->fp = fp;
+  return cs_cons(csound, d, pending);
+}
+
+static int fingerprint_matches(CSOUND *csound, CS_HASH_TABLE *table,
+                               const char *key, uint64_t fp) {
+  uint64_t *old;
+  if (table == NULL)
+    return 0;
+  old = (uint64_t *)cs_hash_table_get(csound, table, (char *)key);
+  return (old != NULL && *old == fp);
+}
+
+/* stores the fingerprints of a successful compilation (if 'store' is set)
+   and frees the pending list */
+static void fingerprints_commit(CSOUND *csound, CONS_CELL *pending,
+                                int store) {
+  CS_HASH_TABLE *table = store ? definition_fingerprints(csound) : NULL;
+  CONS_CELL *cell;
+  for (cell = pending; cell != NULL; cell = cell->next) {
+    DEFN_FINGERPRINT *d = (DEFN_FINGERPRINT *)cell->value;
+    if (table != NULL) {
+      uint64_t *old = (uint64_t *)cs_hash_table_get(csound, table, d->key);
+      if (old == NULL) {
+        old = csound->Malloc(csound, sizeof(uint64_t));
+        cs_hash_table_put(csound, table, d->key, old);
+      }
+      *old = d->fp;
+    }
+    csound->Free(csound, d->key);
+  }
+  cs_cons_free_complete(csound, pending);
+}
+
+static void instr_fingerprint_key(char *buf, size_t len, TREE *id) {
+  if (id->type == INTEGER_TOKEN)
+    snprintf(buf, len, "instr:%d", id->value->value);
+  else
+    snprintf(buf, len, "instr:%s", id->value->lexeme);
+}
+
+/* checks whether the instrument defined by 'root' is already compiled with
+   an identical body under all of its numbers and names; the fingerprints
+   are added to 'pending' in either case */
+static int instr_unchanged(CSOUND *csound, TREE *root, uint64_t fp,
+                           CONS_CELL **pending) {
+  CS_HASH_TABLE *table = (CS_HASH_TABLE *)
+    csound->QueryGlobalVariable(csound, DEFN_FINGERPRINTS);
+  ENGINE_STATE *engineState = &csound->engineState;
+  TREE *p = root->left, *id;
+  char key[256];
+  int same = 1;
+
+  if (table != NULL)
+    table = *(CS_HASH_TABLE **)table;
+  while (p != NULL) {
+    if (p->type == T_INSTLIST) {
+      id = (p->left != NULL) ? p->left : p;
+      p = (p->left != NULL) ? p->right : NULL;
+    } else {
+      id = p;
+      p = NULL;
+    }
+    if (id->type != INTEGER_TOKEN && id->type != T_IDENT)
+      continue;
+    instr_fingerprint_key(key, sizeof(key), id);
+    if (!fingerprint_matches(csound, table, key, fp))
+      same = 0;
+    /* the instrument may have been removed since */
+    else if (id->type == INTEGER_TOKEN &&
+             (id->value->value > engineState->maxinsno ||
+              engineState->instrtxtp[id->value->value] == NULL))
+      same = 0;
+    else if (id->type == T_IDENT &&
+             named_instr_find(csound, id->value->lexeme) <= 0)
+      same = 0;
+    *pending = fingerprint_add(csound, *pending, key, fp);
+  }
+  return same;
+}
+
+/* for an unchanged UDO body, returns the template compiled for the previous
+   definition with the same signature; the new OPCODINFO gets argument pools
+   identical to the old ones from semantic analysis, so the old template can
+   be used with it */
+static INSTRTXT *udo_unchanged(CSOUND *csound, OPCODINFO *opinfo, uint64_t fp,
+                               CONS_CELL **pending) {
+  CS_HASH_TABLE *table = (CS_HASH_TABLE *)
+    csound->QueryGlobalVariable(csound, DEFN_FINGERPRINTS);
+  OPCODINFO *prv;
+  char key[512];
+
+  snprintf(key, sizeof(key), "udo:%s:%s:%s", opinfo->name, opinfo->outtypes,
+           opinfo->intypes);
+  *pending = fingerprint_add(csound, *pending, key, fp);
+  if (table == NULL ||
+      !fingerprint_matches(csound, *(CS_HASH_TABLE **)table, key, fp))
+    return NULL;
+  for (prv = opinfo->prv; prv != NULL; prv = prv->prv) {
+    if (strcmp(prv->name, opinfo->name) == 0 &&
+        strcmp(prv->intypes, opinfo->intypes) == 0 &&
+        strcmp(prv->outtypes, opinfo->outtypes) == 0)
+      return prv->ip;
+  }
+  return NULL;
+}
+
 /**
  * Compile the given TREE node into structs
 
@@ -1624,8 +1815,12 @@ int csoundCompileTreeInternal(CSOUND *csound, TREE *root, int async) {
   ENGINE_STATE *engineState;
   CS_VARIABLE *var;
   TYPE_TABLE *typeTable = (TYPE_TABLE *)current->markup;
+  CONS_CELL *fingerprints = NULL;
+  int recompile;
 
   current = current->next;
+  /* definitions are only reused on recompilation */
+  recompile = (csound->instr0 != NULL);
   if (csound->instr0 == NULL) {
     engineState = &csound->engineState;
     engineState->varPool = typeTable->globalPool;
@@ -1685,6 +1880,14 @@ int csoundCompileTreeInternal(CSOUND *csound, TREE *root, int async) {
       break;
     case INSTR_TOKEN:
       // print_tree(csound, "Instrument found\n", current);
+      if (instr_unchanged(csound, current, fingerprint_definition(current),
+                          &fingerprints) && recompile) {
+        if (UNLIKELY(csound->oparms->odebug))
+          csound->Message(csound, Str("instr at line %d unchanged, "
+                                      "keeping current definition\n"),
+                          current->line);
+        break;
+      }
       instrtxt = create_instrument(csound, current, engineState);
 
       prvinstxt = prvinstxt->nxtinstxt = instrtxt;
@@ -1804,15 +2007,29 @@ int csoundCompileTreeInternal(CSOUND *csound, TREE *root, int async) {
         }
       }
       break;
-    case UDO_TOKEN:
+    case UDO_TOKEN: {
       /* csound->Message(csound, "UDO found\n"); */
-      instrtxt = create_instrument(csound, current, engineState);
-      prvinstxt = prvinstxt->nxtinstxt = instrtxt;
       opname = current->left->value->lexeme;
       OPCODINFO *opinfo =
           find_opcode_info(csound, opname, current->left->left->value->lexeme,
                            current->left->right->value->lexeme);
 
+      if (opinfo != NULL) {
+        INSTRTXT *prvip = udo_unchanged(csound, opinfo,
+                                        fingerprint_definition(current),
+                                        &fingerprints);
+        if (prvip != NULL && recompile) {
+          if (UNLIKELY(csound->oparms->odebug))
+            csound->Message(csound, Str("opcode %s unchanged, "
+                                        "keeping current definition\n"),
+                            opname);
+          opinfo->ip = prvip;
+          break;
+        }
+      }
+      instrtxt = create_instrument(csound, current, engineState);
+      prvinstxt = prvinstxt->nxtinstxt = instrtxt;
+
       if (UNLIKELY(opinfo == NULL)) {
         csound->Message(csound,
                         Str("ERROR: Could not find OPCODINFO for opname: %s\n"),
@@ -1828,6 +2045,7 @@ int csoundCompileTreeInternal(CSOUND *csound, TREE *root, int async) {
        */
 
       break;
+    }
     case T_OPCODE:
     case T_OPCODE0:
     case LABEL:
@@ -1850,8 +2068,10 @@ int csoundCompileTreeInternal(CSOUND *csound, TREE *root, int async) {
                                 "compilation invalid\n"),
                     csound->synterrcnt);
     free_typetable(csound, typeTable);
+    fingerprints_commit(csound, fingerprints, 0);
     return CSOUND_ERROR;
   }
+  fingerprints_commit(csound, fingerprints, 1);
 
 
   if (engineState != &csound->engineState) {
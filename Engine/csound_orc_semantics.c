@@ -627,7 +627,7 @@ OENTRY* find_opcode(CSOUND *csound, char *opname)
 
     shortName = get_opcode_short_name(csound, opname);
 
-    head = cs_hash_table_get(csound, csound->opcodes, shortName);
+    head = find_opcode_entries(csound, shortName);
 
     retVal = (head != NULL) ? head->value : NULL;
     if (shortName != opname) csound->Free(csound, shortName);
@@ -656,7 +656,7 @@ OENTRIES* find_opcode2(CSOUND* csound, char* opname)
     }
 
     shortName = get_opcode_short_name(csound, opname);
-    head = cs_hash_table_get(csound, csound->opcodes, shortName);
+    head = find_opcode_entries(csound, shortName);
     retVal = get_entries(csound, cs_cons_length(head));
     while (head != NULL) {
       retVal->entries[i++] = head->value;
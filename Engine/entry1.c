@@ -404,30 +404,30 @@ OENTRY opcodlst_1[] = {
     (SUBR)table3r_kontrol                                                   },
   { "table3.a", S(TABL),TR, 3,      "a",    "xiooo",(SUBR)tabl_setup,
     (SUBR)table3r_audio                                                     },
-  { "ptable.i",  S(TABLE),TR|_QQ, 1,"i",    "iiooo",(SUBR)tabler_init       },
-  { "ptable.k",  S(TABLE),TR|_QQ, 3,     "k",    "xiooo",(SUBR)tabl_setup,
+  { "ptable.i",  S(TABL),TR|_QQ, 1,"i",    "iiooo",(SUBR)tabler_init       },
+  { "ptable.k",  S(TABL),TR|_QQ, 3,     "k",    "xiooo",(SUBR)tabl_setup,
     (SUBR)tabler_kontrol                                                    },
-  { "ptable.a",  S(TABLE),TR|_QQ, 3,     "a",    "xiooo",(SUBR)tabl_setup,
+  { "ptable.a",  S(TABL),TR|_QQ, 3,     "a",    "xiooo",(SUBR)tabl_setup,
     (SUBR)tabler_audio                                                      },
-  { "ptablei.i", S(TABLE),TR|_QQ, 1,"i",    "iiooo",(SUBR)tableir_init      },
-  { "ptablei.k", S(TABLE),TR|_QQ, 3,     "k",    "xiooo",(SUBR)tabl_setup,
+  { "ptablei.i", S(TABL),TR|_QQ, 1,"i",    "iiooo",(SUBR)tableir_init      },
+  { "ptablei.k", S(TABL),TR|_QQ, 3,     "k",    "xiooo",(SUBR)tabl_setup,
     (SUBR)tableir_kontrol                                                   },
-  { "ptablei.a", S(TABLE),TR|_QQ, 3,     "a",    "xiooo",(SUBR)tabl_setup,
+  { "ptablei.a", S(TABL),TR|_QQ, 3,     "a",    "xiooo",(SUBR)tabl_setup,
     (SUBR)tableir_audio                                                     },
-  { "ptable3.i", S(TABLE),TR|_QQ, 1,"i",    "iiooo",(SUBR)table3r_init      },
-  { "ptable3.k", S(TABLE),TR|_QQ, 3,     "k",    "xiooo",(SUBR)tabl_setup,
+  { "ptable3.i", S(TABL),TR|_QQ, 1,"i",    "iiooo",(SUBR)table3r_init      },
+  { "ptable3.k", S(TABL),TR|_QQ, 3,     "k",    "xiooo",(SUBR)tabl_setup,
     (SUBR)table3r_kontrol                                                   },
-  { "ptable3.a", S(TABLE),TR|_QQ, 3,     "a",    "xiooo",(SUBR)tabl_setup,
+  { "ptable3.a", S(TABL),TR|_QQ, 3,     "a",    "xiooo",(SUBR)tabl_setup,
     (SUBR)table3r_audio         },
   { "oscil1", S(OSCIL1), TR, 3,     "k",    "ikij", ko1set, kosc1          },
   { "oscil1i",S(OSCIL1), TR, 3,     "k",    "ikij", ko1set, kosc1i         },
   { "osciln", S(OSCILN), TR, 3,     "a",    "kiii", oscnset,   osciln },
-  { "oscil.a",S(OSC),TR,    3,       "a",    "kkjo", oscset,   osckk  },
+  { "oscil.a",S(OSC),TR,    3,       "a",    "kkjoo", oscset,   osckk  },
   { "oscil.kkk",S(OSC),TR,   3,      "k",    "kkjo", oscset, koscil  },
-  { "oscil.kka",S(OSC),TR,   3,      "a",    "kkjo", oscset, osckk  },
-  { "oscil.ka",S(OSC),TR,    3,      "a",    "kajo", oscset,   oscka  },
-  { "oscil.ak",S(OSC),TR,    3,      "a",    "akjo", oscset,   oscak  },
-  { "oscil.aa",S(OSC),TR,    3,      "a",    "aajo", oscset,   oscaa  },
+  { "oscil.kka",S(OSC),TR,   3,      "a",    "kkjoo", oscset, osckk  },
+  { "oscil.ka",S(OSC),TR,    3,      "a",    "kajoo", oscset,   oscka  },
+  { "oscil.ak",S(OSC),TR,    3,      "a",    "akjoo", oscset,   oscak  },
+  { "oscil.aa",S(OSC),TR,    3,      "a",    "aajoo", oscset,   oscaa  },
   { "oscil.kkA",S(OSC),0,   3,      "k",    "kki[]o", oscsetA, koscil       },
   { "oscil.kkA",S(OSC),0,   3,      "a",    "kki[]o", oscsetA, osckk },
   { "oscil.kaA",S(OSC),0,   3,      "a",    "kai[]o", oscsetA, oscka },
@@ -441,21 +441,21 @@ OENTRY opcodlst_1[] = {
      { "oscil.aa", S(POSC),TR, 3, "a", "aajo", posc_set,  poscaa },
      { "oscil3.kk",  S(POSC),TR,  7, "s", "kkjo", posc_set, kposc3, posc3 },
   */
-  { "oscili.a",S(OSC),TR,   3,      "a",    "kkjo", oscset, osckki  },
+  { "oscili.a",S(OSC),TR,   3,      "a",    "kkjoo", oscset, osckki  },
   { "oscili.kk",S(OSC),TR,   3,      "k",   "kkjo", oscset, koscli, NULL  },
-  { "oscili.ka",S(OSC),TR,   3,      "a",   "kajo", oscset,   osckai  },
-  { "oscili.ak",S(OSC),TR,   3,      "a",   "akjo", oscset,   oscaki  },
-  { "oscili.aa",S(OSC),TR,   3,      "a",   "aajo", oscset,   oscaai  },
+  { "oscili.ka",S(OSC),TR,   3,      "a",   "kajoo", oscset,   osckai  },
+  { "oscili.ak",S(OSC),TR,   3,      "a",   "akjoo", oscset,   oscaki  },
+  { "oscili.aa",S(OSC),TR,   3,      "a",   "aajoo", oscset,   oscaai  },
   { "oscili.aA",S(OSC),0,   3,      "a",   "kki[]o", oscsetA, osckki  },
   { "oscili.kkA",S(OSC),0,   3,      "k",  "kki[]o", oscsetA, koscli, NULL  },
   { "oscili.kaA",S(OSC),0,   3,      "a",  "kai[]o", oscsetA,   osckai  },
   { "oscili.akA",S(OSC),0,   3,      "a",  "aki[]o", oscsetA,   oscaki  },
   { "oscili.aaA",S(OSC),0,   3,      "a",  "aai[]o", oscsetA,   oscaai  },
-  { "oscil3.a",S(OSC),TR,   3,      "a",    "kkjo", oscset, osckk3  },
+  { "oscil3.a",S(OSC),TR,   3,      "a",    "kkjoo", oscset3, osckk3  },
   { "oscil3.kk",S(OSC),TR,   3,      "k",   "kkjo", oscset, koscl3, NULL  },
-  { "oscil3.ka",S(OSC),TR,   3,      "a",   "kajo", oscset,   oscka3  },
-  { "oscil3.ak",S(OSC),TR,   3,      "a",   "akjo", oscset,   oscak3  },
-  { "oscil3.aa",S(OSC),TR,   3,      "a",   "aajo", oscset,   oscaa3  },
+  { "oscil3.ka",S(OSC),TR,   3,      "a",   "kajoo", oscset3,   oscka3  },
+  { "oscil3.ak",S(OSC),TR,   3,      "a",   "akjoo", oscset3,   oscak3  },
+  { "oscil3.aa",S(OSC),TR,   3,      "a",   "aajoo", oscset3,   oscaa3  },
   { "oscil3.aA",S(OSC),0,   3,      "a",   "kki[]o", oscsetA, osckk3 },
   { "oscil3.kkA",S(OSC),0,   3,      "k",  "kki[]o", oscsetA, koscl3, NULL },
   { "oscil3.kaA",S(OSC),0,   3,      "a",  "kai[]o", oscsetA, oscka3 },
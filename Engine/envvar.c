@@ -24,6 +24,7 @@
 #include "csoundCore.h"
 #include "soundio.h"
 #include "envvar.h"
+#include "iouring.h"
 #include <stdio.h>
 #include <ctype.h>
 #include <math.h>
@@ -42,13 +43,25 @@
 #  define getcwd(x,y) "/"
 #endif
 
+#if defined(HAVE_DIRENT_H)
+#  include <dirent.h>
+#endif
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#  include <sys/inotify.h>
+#  define HAVE_INOTIFY
+#endif
+
 
 #include "namedins.h"
 
 /* list of environment variables used by Csound */
 
 static const char *envVar_list[] = {
+    "CSFTCACHE",
+    "CSFTCACHESIZE",
     "CSNOSTOP",
+    "CSORCCACHE",
     "CSOUND6RC",
     "CSSTRNGS",
     "CS_LANG",
@@ -75,6 +88,7 @@ typedef struct CSFILE_ {
     SNDFILE         *sf;
     void            *cb;
     int             async_flag;
+    void            *uring;
     int             items;
     int             pos;
     MYFLT           *buf;
@@ -110,6 +124,8 @@ typedef struct nameChain_s {
     char    s[1];
 } nameChain_t;
 
+static void file_index_invalidate(CSOUND *csound);
+
 /* Space for 16 global environment variables, */
 /* 32 bytes for name and 480 bytes for value. */
 /* Only written by csoundSetGlobalEnv().      */
@@ -213,6 +229,8 @@ int csoundSetEnv(CSOUND *csound, const char *name, const char *value)
       ep = nxt;
     }
     csound->searchPathCache = NULL;
+    /* and the names resolved through it */
+    file_index_invalidate(csound);
 
 
     oldValue = cs_hash_table_get(csound, csound->envVarDB, (char*)name);
@@ -770,21 +788,420 @@ char *csoundGetDirectoryForPath(CSOUND* csound, const char * path) {
     return retval;
 }
 
+/* Index of the directories searched for input files.
+
+   The directory a name is looked for in, under the current directory or
+   one of a search path, is listed once into a hash set of its entries,
+   without holding the lock, and the names resolved through the listings
+   are remembered, so that opening the same file again costs one open()
+   and no failed probes. On Linux the directories are watched with
+   inotify, which keeps the listings up to date and makes a name missing
+   from all of them a definite miss. Elsewhere files created through this
+   file are added to the listings, a missing name is still searched for
+   on disk, and csoundClearFileCache() drops everything.                 */
+
+typedef struct dirIndex_s {
+    struct dirIndex_s   *nxt;
+    CS_HASH_TABLE       *names;       /* entries, NULL until listed */
+    int                 missing;      /* could not be listed */
+    int                 wd;           /* inotify watch, or -1 */
+    unsigned int        changes;      /* counts updates of the listing */
+    char                path[1];      /* full directory, "" for . */
+} dirIndex_t;
+
+typedef struct fileIndex_s {
+    dirIndex_t          *dirs;
+    CS_HASH_TABLE       *resolved;    /* "envList\nname" -> full name */
+    int                 inotify;      /* -1 if not watching */
+    unsigned int        changes;      /* counts drops of 'resolved' */
+    spin_lock_t         lock;
+} fileIndex_t;
+
+static fileIndex_t *file_index_get(CSOUND *csound)
+{
+    fileIndex_t *fi = (fileIndex_t*) csound->file_index;
+
+    if (fi == NULL) {
+      fi = (fileIndex_t*) csound->Calloc(csound, sizeof(fileIndex_t));
+#if defined(HAVE_INOTIFY)
+      fi->inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#else
+      fi->inotify = -1;
+#endif
+      csoundSpinLockInit(&fi->lock);
+      csound->file_index = (void*) fi;
+    }
+    return fi;
+}
+
+/* forget the names resolved, after any change to the listings */
+
+static void file_index_forget(CSOUND *csound, fileIndex_t *fi)
+{
+    fi->changes++;
+    if (fi->resolved != NULL) {
+      cs_hash_table_mfree_complete(csound, fi->resolved);
+      fi->resolved = NULL;
+    }
+}
+
+static void file_index_invalidate(CSOUND *csound)
+{
+    fileIndex_t *fi = (fileIndex_t*) csound->file_index;
+
+    if (fi == NULL)
+      return;
+    csoundSpinLock(&fi->lock);
+    file_index_forget(csound, fi);
+    csoundSpinUnLock(&fi->lock);
+}
+
+static void dir_index_drop(CSOUND *csound, dirIndex_t *d)
+{
+    if (d->names != NULL)
+      cs_hash_table_free(csound, d->names);
+    d->names = NULL;
+    d->missing = 0;
+    d->changes++;
+}
+
+static void dir_index_add(CSOUND *csound, dirIndex_t *d, char *name)
+{
+    if (cs_hash_table_get_key(csound, d->names, name) == NULL)
+      cs_hash_table_put_key(csound, d->names, name);
+}
+
+static void dir_index_remove(CSOUND *csound, dirIndex_t *d, char *name)
+{
+    char *key = cs_hash_table_get_key(csound, d->names, name);
+    if (key != NULL) {
+      cs_hash_table_remove(csound, d->names, name);
+      csound->Free(csound, key);
+    }
+}
+
+/* apply the changes reported by inotify since the last lookup */
+
+static void file_index_events(CSOUND *csound, fileIndex_t *fi)
+{
+#if defined(HAVE_INOTIFY)
+    char        buf[4096]
+                  __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    ssize_t     len;
+    char        *s;
+    dirIndex_t  *d;
+
+    if (fi->inotify < 0)
+      return;
+    while ((len = read(fi->inotify, buf, sizeof(buf))) > 0) {
+      for (s = buf; s < buf + len;
+           s += sizeof(struct inotify_event) + ((struct inotify_event*) s)->len) {
+        struct inotify_event *ev = (struct inotify_event*) s;
+        file_index_forget(csound, fi);
+        if (ev->mask & IN_Q_OVERFLOW) {
+          for (d = fi->dirs; d != NULL; d = d->nxt)
+            dir_index_drop(csound, d);
+          continue;
+        }
+        /* the watch would follow the directory moved: watch the path
+           again when it is listed */
+        if (ev->mask & IN_MOVE_SELF)
+          inotify_rm_watch(fi->inotify, ev->wd);
+        /* a directory reached through several paths has one watch */
+        for (d = fi->dirs; d != NULL; d = d->nxt) {
+          if (d->wd != ev->wd)
+            continue;
+          d->changes++;
+          if (ev->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+            if (ev->mask & (IN_IGNORED | IN_MOVE_SELF))
+              d->wd = -1;
+            dir_index_drop(csound, d);
+          }
+          else if (d->names != NULL && ev->len > 0) {
+            if (ev->mask & (IN_CREATE | IN_MOVED_TO))
+              dir_index_add(csound, d, ev->name);
+            else if (ev->mask & (IN_DELETE | IN_MOVED_FROM))
+              dir_index_remove(csound, d, ev->name);
+          }
+        }
+      }
+    }
+#else
+    IGN(csound); IGN(fi);
+#endif
+}
+
+/* the length of the directory part of a full name, as kept in the
+   listings: without the final separator, unless it is the root */
+
+static size_t dir_index_length(const char *fullName)
+{
+    const char  *base = strrchr(fullName, DIRSEP);
+
+    if (base == NULL)
+      return 0;
+    return (base == fullName ? 1 : (size_t) (base - fullName));
+}
+
+static dirIndex_t *dir_index_find(CSOUND *csound, fileIndex_t *fi,
+                                  const char *path, size_t len)
+{
+    dirIndex_t  *d;
+
+    for (d = fi->dirs; d != NULL; d = d->nxt)
+      if (strlen(d->path) == len && strncmp(d->path, path, len) == 0)
+        return d;
+    d = (dirIndex_t*) csound->Calloc(csound, sizeof(dirIndex_t) + len);
+    strncpy(d->path, path, len);
+    d->wd = -1;
+    d->nxt = fi->dirs;
+    fi->dirs = d;
+    return d;
+}
+
+/* the listing of the directory of a full name, made on first use.
+   Called with the lock held, which is released while the directory is
+   read; the listing is kept only if nothing changed the entry in the
+   meantime, so that the one returned may still have no names. */
+
+static dirIndex_t *dir_index_get(CSOUND *csound, fileIndex_t *fi,
+                                 const char *fullName)
+{
+    dirIndex_t    *d = dir_index_find(csound, fi, fullName,
+                                      dir_index_length(fullName));
+    CS_HASH_TABLE *names;
+    char          *dname;
+    unsigned int  changes;
+    int           missing = 1;
+
+    if (d->names != NULL || d->missing)
+      return d;
+    dname = cs_strdup(csound, (d->path[0] != '\0' ? d->path : "."));
+#if defined(HAVE_INOTIFY)
+    /* watch first, so that nothing created while listing is missed */
+    if (fi->inotify >= 0 && d->wd < 0)
+      d->wd = inotify_add_watch(fi->inotify, dname,
+                                IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                IN_MOVED_TO | IN_DELETE_SELF |
+                                IN_MOVE_SELF | IN_ONLYDIR);
+#endif
+    changes = d->changes;
+    csoundSpinUnLock(&fi->lock);
+    names = cs_hash_table_create(csound);
+#if defined(HAVE_DIRENT_H)
+    {
+      DIR           *dir;
+      struct dirent *ent;
+      if ((dir = opendir(dname)) != NULL) {
+        while ((ent = readdir(dir)) != NULL)
+          cs_hash_table_put_key(csound, names, ent->d_name);
+        closedir(dir);
+        missing = 0;
+      }
+    }
+#endif
+    csound->Free(csound, dname);
+    csoundSpinLock(&fi->lock);
+    /* entries are only freed with the index, so d is still valid */
+    if (d->names == NULL && !d->missing && d->changes == changes) {
+      d->names = names;
+      d->missing = missing;
+    }
+    else
+      cs_hash_table_free(csound, names);
+    return d;
+}
+
+/**
+ * Where the input file 'name', relative and converted to native format,
+ * is expected in the current directory or the search path of 'envList'.
+ * Returns the full name to open, to be freed by the caller, or NULL if
+ * it is not in the listings, with *absent set if they are all watched.
+ */
+
+static char *file_index_resolve(CSOUND *csound, const char *name,
+                                const char *envList, int *absent)
+{
+    fileIndex_t  *fi = file_index_get(csound);
+    dirIndex_t   *d;
+    char         **searchPath = NULL, *key, *s, *fullName = NULL;
+    const char   *path, *base;
+    unsigned int changes;
+    int          i, watched;
+
+    *absent = 0;
+    if (envList == NULL)
+      envList = "";
+    csoundSpinLock(&fi->lock);
+    file_index_events(csound, fi);
+    key = (char*) csound->Malloc(csound, strlen(envList) + strlen(name) + 2);
+    sprintf(key, "%s\n%s", envList, name);
+    if (fi->resolved != NULL &&
+        (s = (char*) cs_hash_table_get(csound, fi->resolved, key)) != NULL) {
+      fullName = cs_strdup(csound, s);
+      goto done;
+    }
+    if (envList[0] != '\0')
+      searchPath = csoundGetSearchPathFromEnv(csound, envList);
+    changes = fi->changes;
+    watched = (fi->inotify >= 0);
+    for (i = -1, path = ""; path != NULL;
+         path = (searchPath != NULL ? searchPath[++i] : NULL)) {
+      /* the directory holding the file, which for a name with directory
+         components is a subdirectory of the one searched */
+      s = (path[0] != '\0' ? csoundConcatenatePaths(csound, path, name) :
+           cs_strdup(csound, (char*) name));
+      base = strrchr(s, DIRSEP);
+      base = (base != NULL ? base + 1 : s);
+      d = dir_index_get(csound, fi, s);
+      if (d->names == NULL) {
+        /* changed while it was listed: search the disk this time */
+        csound->Free(csound, s);
+        watched = 0;
+        break;
+      }
+      watched &= (!d->missing && d->wd >= 0);
+      if (cs_hash_table_get_key(csound, d->names, (char*) base) != NULL) {
+        fullName = s;
+        break;
+      }
+      csound->Free(csound, s);
+    }
+    /* remembered unless a listing changed while the lock was released */
+    if (fullName != NULL && fi->changes == changes) {
+      if (fi->resolved == NULL)
+        fi->resolved = cs_hash_table_create(csound);
+      cs_hash_table_put(csound, fi->resolved, key,
+                        cs_strdup(csound, fullName));
+    }
+    if (fullName == NULL)
+      *absent = watched;
+ done:
+    csound->Free(csound, key);
+    csoundSpinUnLock(&fi->lock);
+    return fullName;
+}
+
+/* a file was found or created outside the listings: add it */
+
+static void file_index_add(CSOUND *csound, const char *fullName)
+{
+    fileIndex_t *fi = (fileIndex_t*) csound->file_index;
+    dirIndex_t  *d;
+    const char  *base;
+    size_t      len;
+
+    if (fi == NULL)
+      return;
+    base = strrchr(fullName, DIRSEP);
+    base = (base != NULL ? base + 1 : fullName);
+    len = dir_index_length(fullName);
+    csoundSpinLock(&fi->lock);
+    file_index_forget(csound, fi);
+    for (d = fi->dirs; d != NULL; d = d->nxt) {
+      if (strlen(d->path) != len || strncmp(d->path, fullName, len) != 0)
+        continue;
+      d->changes++;
+      if (d->missing)
+        dir_index_drop(csound, d);    /* it exists now: list it again */
+      else if (d->names != NULL)
+        dir_index_add(csound, d, (char*) base);
+    }
+    csoundSpinUnLock(&fi->lock);
+}
+
+/* a cached name that could not be opened: list its directory again */
+
+static void file_index_stale(CSOUND *csound, const char *fullName)
+{
+    fileIndex_t *fi = (fileIndex_t*) csound->file_index;
+    dirIndex_t  *d;
+    size_t      len = dir_index_length(fullName);
+
+    csoundSpinLock(&fi->lock);
+    file_index_forget(csound, fi);
+    for (d = fi->dirs; d != NULL; d = d->nxt)
+      if (strlen(d->path) == len && strncmp(d->path, fullName, len) == 0)
+        dir_index_drop(csound, d);
+    csoundSpinUnLock(&fi->lock);
+}
+
+/* the entries are kept, as a lookup may be listing one without the lock */
+
+PUBLIC void csoundClearFileCache(CSOUND *csound)
+{
+    fileIndex_t *fi = (fileIndex_t*) csound->file_index;
+    dirIndex_t  *d;
+
+    if (fi == NULL)
+      return;
+    csoundSpinLock(&fi->lock);
+    file_index_forget(csound, fi);
+    for (d = fi->dirs; d != NULL; d = d->nxt) {
+      dir_index_drop(csound, d);
+#if defined(HAVE_INOTIFY)
+      if (d->wd >= 0)
+        inotify_rm_watch(fi->inotify, d->wd);
+#endif
+      d->wd = -1;
+    }
+    /* events of the watches removed are dropped with them */
+    file_index_events(csound, fi);
+    csoundSpinUnLock(&fi->lock);
+}
+
+static void file_index_free(CSOUND *csound)
+{
+    fileIndex_t *fi = (fileIndex_t*) csound->file_index;
+    dirIndex_t  *d;
+
+    if (fi == NULL)
+      return;
+    csoundClearFileCache(csound);
+    while ((d = fi->dirs) != NULL) {
+      fi->dirs = d->nxt;
+      csound->Free(csound, d);
+    }
+    if (fi->inotify >= 0)
+      close(fi->inotify);
+    csound->Free(csound, fi);
+    csound->file_index = NULL;
+}
+
 static FILE *csoundFindFile_Std(CSOUND *csound, char **fullName,
                                 const char *filename, const char *mode,
                                 const char *envList)
 {
     FILE  *f;
     char  *name, *name2, **searchPath;
+    int   absent;
 
     *fullName = NULL;
     if ((name = csoundConvertPathname(csound, filename)) == NULL)
       return (FILE*) NULL;
+    if (mode[0] != 'w' && !csoundIsNameFullpath(name)) {
+      /* read: where the directory listings have it */
+      if ((name2 = file_index_resolve(csound, name, envList, &absent))
+          != NULL) {
+        if ((f = fopen(name2, mode)) != NULL) {
+          csound->Free(csound, name);
+          *fullName = name2;
+          return f;
+        }
+        file_index_stale(csound, name2);
+        csound->Free(csound, name2);
+      }
+      else if (absent) {
+        csound->Free(csound, name);
+        return (FILE*) NULL;
+      }
+    }
     if (mode[0] != 'w') {
       /* read: try the specified name first */
       f = fopen(name, mode);
       if (f != NULL) {
         *fullName = name;
+        file_index_add(csound, name);
         return f;
       }
       /* if full path, and not found: */
@@ -796,8 +1213,10 @@ static FILE *csoundFindFile_Std(CSOUND *csound, char **fullName,
     else if (csoundIsNameFullpath(name)) {
       /* if write and full path: */
       f = fopen(name, mode);
-      if (f != NULL)
+      if (f != NULL) {
         *fullName = name;
+        file_index_add(csound, name);
+      }
       else
         csound->Free(csound, name);
       return f;
@@ -813,6 +1232,7 @@ static FILE *csoundFindFile_Std(CSOUND *csound, char **fullName,
         if (f != NULL) {
           csound->Free(csound, name);
           *fullName = name2;
+          file_index_add(csound, name2);
           return f;
         }
         csound->Free(csound, name2);
@@ -824,6 +1244,7 @@ static FILE *csoundFindFile_Std(CSOUND *csound, char **fullName,
       f = fopen(name, mode);
       if (f != NULL) {
         *fullName = name;
+        file_index_add(csound, name);
         return f;
       }
     }
@@ -837,16 +1258,34 @@ static int csoundFindFile_Fd(CSOUND *csound, char **fullName,
                              const char *envList)
 {
     char  *name, *name2, **searchPath;
-    int   fd;
+    int   fd, absent;
 
     *fullName = NULL;
     if ((name = csoundConvertPathname(csound, filename)) == NULL)
       return -1;
+    if (!write_mode && !csoundIsNameFullpath(name)) {
+      /* read: where the directory listings have it */
+      if ((name2 = file_index_resolve(csound, name, envList, &absent))
+          != NULL) {
+        if ((fd = open(name2, RD_OPTS)) >= 0) {
+          csound->Free(csound, name);
+          *fullName = name2;
+          return fd;
+        }
+        file_index_stale(csound, name2);
+        csound->Free(csound, name2);
+      }
+      else if (absent) {
+        csound->Free(csound, name);
+        return -1;
+      }
+    }
     if (!write_mode) {
       /* read: try the specified name first */
       fd = open(name, RD_OPTS);
       if (fd >= 0) {
         *fullName = name;
+        file_index_add(csound, name);
         return fd;
       }
       /* if full path, and not found: */
@@ -858,8 +1297,10 @@ static int csoundFindFile_Fd(CSOUND *csound, char **fullName,
     else if (csoundIsNameFullpath(name)) {
       /* if write and full path: */
       fd = open(name, WR_OPTS);
-      if (fd >= 0)
+      if (fd >= 0) {
         *fullName = name;
+        file_index_add(csound, name);
+      }
       else
         csound->Free(csound, name);
       return fd;
@@ -878,6 +1319,7 @@ static int csoundFindFile_Fd(CSOUND *csound, char **fullName,
         if (fd >= 0) {
           csound->Free(csound, name);
           *fullName = name2;
+          file_index_add(csound, name2);
           return fd;
         }
         csound->Free(csound, name2);
@@ -889,6 +1331,7 @@ static int csoundFindFile_Fd(CSOUND *csound, char **fullName,
       fd = open(name, WR_OPTS);
       if (fd >= 0) {
         *fullName = name;
+        file_index_add(csound, name);
         return fd;
       }
     }
@@ -1067,6 +1510,9 @@ void *csoundFileOpenWithType(CSOUND *csound, void *fd, int type,
         if (tmp_fd < 0)
           goto err_return;
       }
+      if (type == CSFILE_SND_W || type == CSFILE_FD_W ||
+          (type == CSFILE_STD && ((char*) param)[0] == 'w'))
+        file_index_add(csound, fullName);
     }
     else {
       if (type == CSFILE_STD) {
@@ -1172,9 +1618,12 @@ void *csoundFileOpenWithType(CSOUND *csound, void *fd, int type,
       *((int*) fd) = tmp_fd;
     }
     /* link into chain of open files */
+    csoundSpinLock(&csound->open_files_lock);
+    p->nxt = (CSFILE*) csound->open_files;
     if (csound->open_files != NULL)
       ((CSFILE*) csound->open_files)->prv = p;
     csound->open_files = (void*) p;
+    csoundSpinUnLock(&csound->open_files_lock);
     /* notify the host if it asked */
     if (csound->FileOpenCallback_ != NULL) {
       int writing = (type == CSFILE_SND_W || type == CSFILE_FD_W ||
@@ -1187,6 +1636,7 @@ void *csoundFileOpenWithType(CSOUND *csound, void *fd, int type,
     /* return with opaque file handle */
     p->cb = NULL;
     p->async_flag = 0;
+    p->uring = NULL;
     p->buf = NULL;
     p->bufsize = 0;
     return (void*) p;
@@ -1264,9 +1714,12 @@ void *csoundCreateFileHandle(CSOUND *csound,
       return NULL;
     }
     /* link into chain of open files */
+    csoundSpinLock(&csound->open_files_lock);
+    p->nxt = (CSFILE*) csound->open_files;
     if (csound->open_files != NULL)
       ((CSFILE*) csound->open_files)->prv = p;
     csound->open_files = (void*) p;
+    csoundSpinUnLock(&csound->open_files_lock);
     /* return with opaque file handle */
     p->cb = NULL;
     return (void*) p;
@@ -1289,6 +1742,15 @@ int csoundFileClose(CSOUND *csound, void *fd)
 {
     CSFILE  *p = (CSFILE*) fd;
     int     retval = -1;
+    if (p->async_flag == ASYNC_URING) {
+      /* the io_uring engine finishes the stream, and closes the SNDFILE,
+         the buffer and the descriptor, on its own thread */
+      retval = csoundIoUringClose(csound, p->uring);
+      p->cb = NULL;
+      p->sf = NULL;
+      p->fd = -1;
+      p->async_flag = 0;
+    }
     if (p->async_flag == ASYNC_GLOBAL) {
       csound->WaitThreadLockNoTimeout(csound->file_io_threadlock);
       /* close file */
@@ -1310,12 +1772,14 @@ int csoundFileClose(CSOUND *csound, void *fd)
         break;
       }
       /* unlink from chain of open files */
+      csoundSpinLock(&csound->open_files_lock);
       if (p->prv == NULL)
         csound->open_files = (void*) p->nxt;
       else
         p->prv->nxt = p->nxt;
       if (p->nxt != NULL)
         p->nxt->prv = p->prv;
+      csoundSpinUnLock(&csound->open_files_lock);
       if (p->buf != NULL) csound->Free(csound, p->buf);
       p->bufsize = 0;
       csound->DestroyCircularBuffer(csound, p->cb);
@@ -1332,18 +1796,21 @@ int csoundFileClose(CSOUND *csound, void *fd)
         break;
       case CSFILE_SND_R:
       case CSFILE_SND_W:
-        retval = sf_close(p->sf);
+        if (p->sf)
+          retval = sf_close(p->sf);
         if (p->fd >= 0)
           retval |= close(p->fd);
         break;
       }
       /* unlink from chain of open files */
+      csoundSpinLock(&csound->open_files_lock);
       if (p->prv == NULL)
         csound->open_files = (void*) p->nxt;
       else
         p->prv->nxt = p->nxt;
       if (p->nxt != NULL)
         p->nxt->prv = p->prv;
+      csoundSpinUnLock(&csound->open_files_lock);
     }
     /* free allocated memory */
     csound->Free(csound, fd);
@@ -1365,6 +1832,8 @@ void close_all_files(CSOUND *csound)
       if (csound->file_io_threadlock != NULL)
         csound->DestroyThreadLock(csound->file_io_threadlock);
     }
+    csoundIoUringStop(csound);
+    file_index_free(csound);
 }
 
 /* The fromScore parameter should be 1 if opening a score include file,
@@ -1411,6 +1880,20 @@ void *csoundFileOpenWithType_Async(CSOUND *csound, void *fd, int type,
                                                csFileType,isTemporary)) == NULL)
       return NULL;
 
+    p->cb = csound->CreateCircularBuffer(csound, buffsize*4, sizeof(MYFLT));
+    p->items = 0;
+    p->pos = 0;
+    p->bufsize = buffsize;
+    /* sound files are streamed by io_uring where available */
+    if (p->cb != NULL && (type == CSFILE_SND_R || type == CSFILE_SND_W) &&
+        (p->uring = csoundIoUringOpen(csound, p->fd, &p->sf, (SF_INFO*) param,
+                                      type == CSFILE_SND_W, p->cb,
+                                      buffsize)) != NULL) {
+      p->async_flag = ASYNC_URING;
+      *((SNDFILE**) fd) = p->sf;
+      return (void *) p;
+    }
+
     if (csound->file_io_start == 0) {
       csound->file_io_start = 1;
       csound->file_io_threadlock = csound->CreateThreadLock();
@@ -1420,11 +1903,6 @@ void *csoundFileOpenWithType_Async(CSOUND *csound, void *fd, int type,
     }
     csound->WaitThreadLockNoTimeout(csound->file_io_threadlock);
     p->async_flag = ASYNC_GLOBAL;
-
-    p->cb = csound->CreateCircularBuffer(csound, buffsize*4, sizeof(MYFLT));
-    p->items = 0;
-    p->pos = 0;
-    p->bufsize = buffsize;
     p->buf = (MYFLT *) csound->Calloc(csound, sizeof(MYFLT)*buffsize);
     csound->NotifyThreadLock(csound->file_io_threadlock);
 
@@ -1443,6 +1921,8 @@ unsigned int csoundReadAsync(CSOUND *csound, void *handle,
                              MYFLT *buf, int items)
 {
     CSFILE *p = handle;
+    if (p != NULL && p->async_flag == ASYNC_URING)
+      return csoundIoUringRead(csound, p->uring, buf, items);
     if (p != NULL &&  p->cb != NULL)
       return csound->ReadCircularBuffer(csound, p->cb, buf, items);
     else return 0;
@@ -1452,6 +1932,8 @@ unsigned int csoundWriteAsync(CSOUND *csound, void *handle,
                               MYFLT *buf, int items)
 {
     CSFILE *p = handle;
+    if (p != NULL && p->async_flag == ASYNC_URING)
+      return csoundIoUringWrite(csound, p->uring, buf, items);
     if (p != NULL &&  p->cb != NULL)
       return csound->WriteCircularBuffer(csound, p->cb, buf, items);
     else return 0;
@@ -1460,6 +1942,8 @@ unsigned int csoundWriteAsync(CSOUND *csound, void *handle,
 int csoundFSeekAsync(CSOUND *csound, void *handle, int pos, int whence){
     CSFILE *p = handle;
     int ret = 0;
+    if (p->async_flag == ASYNC_URING)     /* does not wait for the seek */
+      return csoundIoUringSeek(csound, p->uring, pos, whence);
     csound->WaitThreadLockNoTimeout(csound->file_io_threadlock);
     switch (p->type) {
     case CSFILE_FD_R:
@@ -32,6 +32,8 @@
 #include "fgens.h"
 #include "pstream.h"
 #include "pvfileio.h"
+#include "housekeep.h"
+#include "ftmipmap.h"
 #include <stdlib.h>
 /* #undef ISSTRCOD */
 
@@ -111,13 +113,35 @@ typedef struct namedgen {
     struct namedgen *next;
 } NAMEDGEN;
 
+/* named GEN routines of the plugins shipped with Csound that depend on
+   their arguments only, with the p-field of the table read (0 if none) */
+
+static const struct {
+    const char  *name;
+    int         src;
+} ft_named[] = {
+    { "exp",        0 },
+    { "farey",      0 },
+    { "padsynth",   0 },
+    { "quadbezier", 0 },
+    { "sone",       0 },
+    { "tanh",       0 },
+    { "wave",       5 },
+    { NULL,         0 }
+};
+
 #define tpd360  (FL(0.0174532925199433))
 
 #define FTAB_SEARCH_BASE (100)
 
 CS_NOINLINE int  fterror(const FGDATA *, const char *, ...);
 static CS_NOINLINE void ftresdisp(const FGDATA *, FUNC *);
+static CS_NOINLINE void ftdisplay(CSOUND *, FUNC *);
 static CS_NOINLINE FUNC *ftalloc(const FGDATA *);
+static int ftpending(CSOUND *, int);
+static int ftcancel(CSOUND *, int);
+static void ftrelease(CSOUND *, const FUNC *);
+static int ftcached(FGDATA *, uint64_t, FUNC **);
 
 static int GENUL(FGDATA *ff, FUNC *ftp)
 {
@@ -129,65 +153,174 @@ static inline unsigned int isPowerOfTwo (unsigned int x) {
   return (x > 0) && !(x & (x - 1)) ? 1 : 0;
 }
 
+/* where ftalloc() puts the table: the ftable list, or a private slot
+   for tables generated in the background                            */
+
+static inline FUNC **ftslot(const FGDATA *ff)
+{
+    return (ff->bg != NULL ? ff->bg : &(ff->csound->flist[ff->fno]));
+}
+
+static void gensub_init(CSOUND *csound)
+{
+    if (UNLIKELY(csound->gensub == NULL)) {
+      csound->gensub = (GEN*) csound->Malloc(csound, sizeof(GEN) * (GENMAX + 1));
+      memcpy(csound->gensub, or_sub, sizeof(GEN) * (GENMAX + 1));
+      csound->genmax = GENMAX + 1;
+    }
+}
+
 /**
- * Create ftable using evtblk data, and store pointer to new table in *ftpp.
- * If mode is zero, a zero table number is ignored, otherwise a new table
- * number is automatically assigned.
- * Returns zero on success.
+ * Tables read by GEN genum (name, if not NULL, for a named GEN): those
+ * numbered by p-fields *first, *first + *step, ... (only *first if *step
+ * is 0). Returns 1 if it reads tables, 0 if it does not, and -1 if that
+ * is not known.
  */
 
-int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
+int ftsources(int genum, const char *name, int *first, int *step)
+{
+    int i;
+
+    *first = 5;
+    *step = 0;
+    if (name != NULL) {
+      for (i = 0; ft_named[i].name != NULL; i++)
+        if (strcmp(ft_named[i].name, name) == 0)
+          return ((*first = ft_named[i].src) != 0);
+      return -1;
+    }
+    switch (genum) {
+    case 4: case 24: case 30: case 31: case 33: case 34: case 40:
+      return 1;
+    case 18: case 32:                           /* every fourth argument */
+      *step = 4;
+      return 1;
+    case 52:                                    /* every third, from p6 */
+      *first = 6;
+      *step = 3;
+      return 1;
+    case 53:                                    /* source, and window */
+      *step = 2;
+      return 1;
+    }
+    return (genum > 0 && genum <= GENMAX ? 0 : -1);
+}
+
+FUNC *ftsource(const FGDATA *ff, int fno)
+{
+    CSOUND  *csound = ff->csound;
+    int     i;
+
+    if (ff->bg != NULL) {
+      for (i = 0; i < ff->nsrc; i++)
+        if (ff->src[i].fno == fno)
+          return ff->src[i].ftp;
+      return NULL;
+    }
+    if (fno <= 0 || fno > csound->maxfnum)
+      return NULL;
+    return csound->flist[fno];
+}
+
+/* csoundGetTable() for the tables read by a GEN routine */
+
+static int ftsrctable(const FGDATA *ff, MYFLT **tablePtr, int fno)
+{
+    FUNC    *ftp;
+
+    if (ff->bg == NULL)
+      return csoundGetTable(ff->csound, tablePtr, fno);
+    if ((ftp = ftsource(ff, fno)) == NULL) {
+      *tablePtr = NULL;
+      return -1;
+    }
+    *tablePtr = ftp->ftable;
+    return (int) ftp->flen;
+}
+
+/* first free automatic table number */
+
+static int ftnumber(CSOUND *csound)
+{
+    int fno = FTAB_SEARCH_BASE;
+
+    do {
+      ++fno;
+    } while (fno <= csound->maxfnum &&
+             (csound->flist[fno] != NULL || ftpending(csound, fno)));
+    return fno;
+}
+
+static void ftlist_extend(CSOUND *csound, int fno)
+{
+    FUNC  **nn;
+    int   i, size;
+
+    if (LIKELY(fno <= csound->maxfnum))
+      return;
+    for (size = csound->maxfnum; size < fno; size += MAXFNUM)
+      ;
+    nn = (FUNC**) csound->ReAlloc(csound,
+                                  csound->flist, (size + 1) * sizeof(FUNC*));
+    csound->flist = nn;
+    for (i = csound->maxfnum + 1; i <= size; i++)
+      csound->flist[i] = NULL;                  /*  Clear new section       */
+    csound->maxfnum = size;
+}
+
+/* hfgens(), or with bg not NULL the generation of the table numbered by
+   evtblkp in a background thread, stored in *bg, reading the nsrc tables
+   of src                                                                */
+
+static int fgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode,
+                 FUNC **bg, const FTSRC *src, int nsrc)
 {
     int32    genum, ltest;
     int     lobits, msg_enabled, i;
     FUNC    *ftp;
     FGDATA  ff;
+    const char *gname = NULL;
+    uint64_t key;
     int nonpowof2_flag=0; /* gab: fixed for non-powoftwo function tables*/
 
     *ftpp = NULL;
-    if (UNLIKELY(csound->gensub == NULL)) {
-      csound->gensub = (GEN*) csound->Malloc(csound, sizeof(GEN) * (GENMAX + 1));
-      memcpy(csound->gensub, or_sub, sizeof(GEN) * (GENMAX + 1));
-      csound->genmax = GENMAX + 1;
-    }
     msg_enabled = csound->oparms->msglevel & 7;
     memset(&ff, '\0', sizeof(ff)); /* for Valgrind */
     ff.csound = csound;
+    ff.bg = bg;
+    ff.src = src;
+    ff.nsrc = nsrc;
     memcpy((char*) &(ff.e), (char*) evtblkp,
            (size_t) ((char*) &(evtblkp->p[2]) - (char*) evtblkp));
     ff.fno = (int) MYFLT2LRND(ff.e.p[1]);
-    if (!ff.fno) {
+    if (bg != NULL)
+      ;                                         /*  numbered and listed     */
+    else if (!ff.fno) {
       if (!mode)
         return 0;                               /*  fno = 0: return,        */
-      ff.fno = FTAB_SEARCH_BASE;
-      do {                                      /*      or automatic number */
-        ++ff.fno;
-      } while (ff.fno <= csound->maxfnum && csound->flist[ff.fno] != NULL);
+      ff.fno = ftnumber(csound);                /*      or automatic number */
       ff.e.p[1] = (MYFLT) (ff.fno);
     }
     else if (ff.fno < 0) {                      /*  fno < 0: remove         */
       ff.fno = -(ff.fno);
+      if (ftcancel(csound, ff.fno) &&           /*  and forget its request  */
+          (ff.fno > csound->maxfnum || csound->flist[ff.fno] == NULL))
+        return 0;
       if (UNLIKELY(ff.fno > csound->maxfnum ||
                    (ftp = csound->flist[ff.fno]) == NULL)) {
         return fterror(&ff, Str("ftable does not exist"));
       }
+      ftrelease(csound, ftp);                   /*  once no GEN reads it    */
       csound->flist[ff.fno] = NULL;
-      csound->Free(csound, (void*) ftp);
+      ftmipmap_discard(csound, ff.fno);
+      csoundHousekeepTable(csound, ftp);        /*  freed in background     */
       if (UNLIKELY(msg_enabled))
         csoundMessage(csound, Str("ftable %d now deleted\n"), ff.fno);
       return 0;
     }
-    if (UNLIKELY(ff.fno > csound->maxfnum)) {   /* extend list if necessary */
-      FUNC  **nn;
-      int   size;
-      for (size = csound->maxfnum; size < ff.fno; size += MAXFNUM)
-        ;
-      nn = (FUNC**) csound->ReAlloc(csound,
-                                    csound->flist, (size + 1) * sizeof(FUNC*));
-      csound->flist = nn;
-      for (i = csound->maxfnum + 1; i <= size; i++)
-        csound->flist[i] = NULL;                /*  Clear new section       */
-      csound->maxfnum = size;
+    if (bg == NULL) {
+      ftlist_extend(csound, ff.fno);            /* extend list if necessary */
+      ftcancel(csound, ff.fno);                 /*  & supersede requests    */
     }
     if (UNLIKELY(ff.e.pcnt <= 4)) {             /*  chk minimum arg count   */
       return fterror(&ff, Str("insufficient gen arguments"));
@@ -220,6 +353,7 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
       if (UNLIKELY(n == NULL)) {
         return fterror(&ff, Str("Named gen \"%s\" not defined"), ff.e.strarg);
       }
+      gname = n->name;
     }
     else {
       genum = (int32) MYFLT2LRND(ff.e.p[4]);
@@ -230,6 +364,9 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
       }
     }
     ff.flen = (int32) MYFLT2LRND(ff.e.p[3]);
+    key = ftcache_key(csound, &ff, genum, gname);
+    if (key != 0 && ftcached(&ff, key, ftpp) == 0)
+      return 0;                                 /* read from the cache      */
     if (!ff.flen) {
       /* defer alloc to gen01|gen23|gen28 */
       ff.guardreq = 1;
@@ -240,12 +377,15 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
       if (UNLIKELY(msg_enabled))
         csoundMessage(csound, Str("ftable %d:\n"), ff.fno);
       i = (*csound->gensub[genum])(&ff, NULL);
-      ftp = csound->flist[ff.fno];
+      ftp = *ftslot(&ff);
       if (i != 0) {
-        csound->flist[ff.fno] = NULL;
-        csound->Free(csound, ftp);
+        *ftslot(&ff) = NULL;
+        if (ftp != NULL)
+          csound->Free(csound, ftp);
         return -1;
       }
+      if (key != 0)
+        ftcache_store(csound, key, ftp);
       *ftpp = ftp;
       return 0;
     }
@@ -294,7 +434,7 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
     if (UNLIKELY(msg_enabled))
       csoundMessage(csound, Str("ftable %d:\n"), ff.fno);
     if ((*csound->gensub[genum])(&ff, ftp) != 0) {
-      csound->flist[ff.fno] = NULL;
+      *ftslot(&ff) = NULL;
       csound->Free(csound, ftp);
       return -1;
     }
@@ -312,9 +452,24 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
       /*for (k=0; k < size; k++)
         csound->Message(csound, "%f\n", ftp->args[k]);*/
     }
+    if (key != 0)
+      ftcache_store(csound, key, ftp);
     return 0;
 }
 
+/**
+ * Create ftable using evtblk data, and store pointer to new table in *ftpp.
+ * If mode is zero, a zero table number is ignored, otherwise a new table
+ * number is automatically assigned.
+ * Returns zero on success.
+ */
+
+int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
+{
+    gensub_init(csound);
+    return fgens(csound, ftpp, evtblkp, mode, NULL, NULL, 0);
+}
+
 /**
  * Allocates space for 'tableNum' with a length (not including the guard
  * point) of 'len' samples. The table data is not cleared to zero.
@@ -341,6 +496,9 @@ int csoundFTAlloc(CSOUND *csound, int tableNum, int len)
     /* allocate space for table */
     size = (int) (len * (int) sizeof(MYFLT));
     ftp = csound->flist[tableNum];
+    ftmipmap_discard(csound, tableNum);
+    if (ftp != NULL)
+      ftrelease(csound, ftp);
     if (ftp == NULL) {
       csound->flist[tableNum] = (FUNC*) csound->Malloc(csound, sizeof(FUNC));
       csound->flist[tableNum]->ftable =
@@ -386,14 +544,19 @@ int csoundFTAlloc(CSOUND *csound, int tableNum, int len)
 int csoundFTDelete(CSOUND *csound, int tableNum)
 {
     FUNC  *ftp;
+    int   cancelled;
 
     if (UNLIKELY((unsigned int) (tableNum - 1) >= (unsigned int) csound->maxfnum))
       return -1;
+    /* a table still being generated is discarded when done */
+    cancelled = ftcancel(csound, tableNum);
     ftp = csound->flist[tableNum];
     if (UNLIKELY(ftp == NULL))
-      return -1;
+      return (cancelled ? 0 : -1);
+    ftrelease(csound, ftp);
     csound->flist[tableNum] = NULL;
-    csound->Free(csound, ftp);
+    ftmipmap_discard(csound, tableNum);
+    csoundHousekeepTable(csound, ftp);
 
     return 0;
 }
@@ -473,8 +636,8 @@ static int gen04(FGDATA *ff, FUNC *ftp)
     if (UNLIKELY(ff->e.pcnt < 6)) {
       return fterror(ff, Str("insufficient arguments"));
     }
-    if (UNLIKELY((srcno = (int)ff->e.p[5]) <= 0 || srcno > csound->maxfnum ||
-                 (srcftp = csound->flist[srcno]) == NULL)) {
+    if (UNLIKELY((srcno = (int)ff->e.p[5]) <= 0 ||
+                 (srcftp = ftsource(ff, srcno)) == NULL)) {
       return fterror(ff, Str("unknown srctable number"));
     }
     if (!ff->e.p[6]) {
@@ -1192,7 +1355,9 @@ static int gen18(FGDATA *ff, FUNC *ftp)
         return fterror(ff, Str("a range given exceeds table length"));
       }
 
-      if (LIKELY((fnp=csoundFTFind(csound,&fn))!=NULL)) { /* make sure fn exists */
+      fnp = (ff->bg == NULL ? csoundFTFind(csound, &fn) :
+             ftsource(ff, (int) MYFLT2LONG(fn)));
+      if (LIKELY(fnp!=NULL)) {                  /* make sure fn exists */
         fp = fnp->ftable, fnlen = fnp->flen-1;        /* and set it up */
       }
       else {
@@ -1456,8 +1621,7 @@ static int gen24(FGDATA *ff, FUNC *ftp)
       return fterror(ff, Str("insufficient arguments"));
     }
     if (UNLIKELY((srcno = (int) ff->e.p[5]) <= 0 ||
-        srcno > csound->maxfnum         ||
-                 (srcftp = csound->flist[srcno]) == NULL)) {
+                 (srcftp = ftsource(ff, srcno)) == NULL)) {
       return fterror(ff, Str("unknown srctable number"));
     }
     fp_source = srcftp->ftable;
@@ -1718,7 +1882,7 @@ static int gen30(FGDATA *ff, FUNC *ftp)
     xsr = FL(1.0);
     if ((nargs > 3) && (ff->e.p[8] > FL(0.0)))
       xsr = csound->esr / ff->e.p[8];
-    l2 = csoundGetTable(csound, &f2, (int) ff->e.p[5]);
+    l2 = ftsrctable(ff, &f2, (int) ff->e.p[5]);
     if (UNLIKELY(l2 < 0)) {
       return fterror(ff, Str("GEN30: source ftable not found"));
     }
@@ -1801,7 +1965,7 @@ static int gen31(FGDATA *ff, FUNC *ftp)
     if (UNLIKELY(nargs < 4)) {
       return fterror(ff, Str("insufficient gen arguments"));
     }
-    l2 = csoundGetTable(csound, &f2, (int) ff->e.p[5]);
+    l2 = ftsrctable(ff, &f2, (int) ff->e.p[5]);
     if (UNLIKELY(l2 < 0)) {
       return fterror(ff, Str("GEN31: source ftable not found"));
     }
@@ -1914,7 +2078,7 @@ static int gen32(FGDATA *ff, FUNC *ftp)
     while (++j < ntabl) {
       p = paccess(ff,pnum[j]);                /* table number */
       i = (int) MYFLT2LRND(p);
-      l2 = csoundGetTable(csound, &f2, abs(i));
+      l2 = ftsrctable(ff, &f2, abs(i));
       if (UNLIKELY(l2 < 0)) {
         fterror(ff, Str("GEN32: source ftable %d not found"), abs(i));
         if (x != NULL) csound->Free(csound,x);
@@ -2009,7 +2173,7 @@ static int gen33(FGDATA *ff, FUNC *ftp)
     /* table length and data */
     ft = ftp->ftable; flen = (int) ftp->flen;
     /* source table */
-    srclen = csoundGetTable(csound, &srcft, (int) ff->e.p[5]);
+    srclen = ftsrctable(ff, &srcft, (int) ff->e.p[5]);
     if (UNLIKELY(srclen < 0)) {
       return fterror(ff, Str("GEN33: source ftable not found"));
     }
@@ -2090,7 +2254,12 @@ static int gen34(FGDATA *ff, FUNC *ftp)
     /* table length and data */
     ft = ftp->ftable; flen = (int32) ftp->flen;
     /* source table */
-    if (UNLIKELY((src = csoundFTnp2Findint(csound, &(ff->e.p[5]), 1)) == NULL))
+    if (ff->bg != NULL) {
+      if (UNLIKELY((src = ftsource(ff, (int) MYFLT2LONG(ff->e.p[5]))) == NULL))
+        return fterror(ff, Str("unknown srctable number"));
+    }
+    else if (UNLIKELY((src = csoundFTnp2Findint(csound,
+                                                &(ff->e.p[5]), 1)) == NULL))
       return NOTOK;
     srcft = src->ftable; srclen = (int32) src->flen;
     /* number of partials */
@@ -2178,8 +2347,7 @@ static int gen40(FGDATA *ff, FUNC *ftp)               /*gab d5*/
     MYFLT   last_value = FL(0.0), lenratio;
 
     if (UNLIKELY((srcno = (int) ff->e.p[5]) <= 0 ||
-                 srcno > csound->maxfnum         ||
-                 (srcftp = csound->flist[srcno]) == NULL)) {
+                 (srcftp = ftsource(ff, srcno)) == NULL)) {
       return fterror(ff, Str("unknown source table number"));
     }
     fp_source = srcftp->ftable;
@@ -2312,8 +2480,6 @@ static CS_NOINLINE void ftresdisp(const FGDATA *ff, FUNC *ftp)
     CSOUND  *csound = ff->csound;
     MYFLT   *fp, *finp = &ftp->ftable[ff->flen];
     MYFLT   abs, maxval;
-    WINDAT  dwindow;
-    char    strmsg[64];
 
     if (!ff->guardreq)                      /* if no guardpt yet, do it */
       ftp->ftable[ff->flen] = ftp->ftable[0];
@@ -2328,12 +2494,21 @@ static CS_NOINLINE void ftresdisp(const FGDATA *ff, FUNC *ftp)
         for (fp=ftp->ftable; fp<=finp; fp++)
           *fp /= maxval;
     }
+    if (ff->bg == NULL)                     /* else displayed when listed */
+      ftdisplay(csound, ftp);
+}
+
+static CS_NOINLINE void ftdisplay(CSOUND *csound, FUNC *ftp)
+{
+    WINDAT  dwindow;
+    char    strmsg[64];
+
     if (!csound->oparms->displays)
       return;
     memset(&dwindow, 0, sizeof(WINDAT));
-    snprintf(strmsg, 64, Str("ftable %d:"), (int) ff->fno);
+    snprintf(strmsg, 64, Str("ftable %d:"), (int) ftp->fno);
     if (csound->csoundMakeGraphCallback_ == NULL) dispinit(csound);
-    dispset(csound, &dwindow, ftp->ftable, (int32) (ff->flen),
+    dispset(csound, &dwindow, ftp->ftable, (int32) (ftp->flen),
               strmsg, 0, "ftable");
     display(csound, &dwindow);
 }
@@ -2366,21 +2541,67 @@ static void generate_sine_tab(CSOUND *csound)
     return;
 }
 
+/* install a table read from the cache as ftalloc() would, and */
+/*  set *ftpp to point to it; returns 0 if there was one         */
+
+static int ftcached(FGDATA *ff, uint64_t key, FUNC **ftpp)
+{
+    CSOUND  *csound = ff->csound;
+    FUNC    hdr, *ftp;
+    MYFLT   *data;
+
+    if ((data = ftcache_load(csound, key, &hdr)) == NULL)
+      return -1;
+    if (UNLIKELY((ftp = *ftslot(ff)) != NULL)) {
+      csound->Warning(csound, Str("replacing previous ftable %d"), ff->fno);
+      if (ff->bg == NULL)
+        ftrelease(csound, ftp);
+      ftmipmap_discard(csound, ff->fno);
+      if (hdr.flen == ftp->flen) {              /* same size: overwrite */
+        memcpy(ftp->ftable, data, sizeof(MYFLT) * (hdr.flen + 1));
+        csound->Free(csound, data);
+        data = ftp->ftable;
+      }
+      else {
+        csound->Free(csound, ftp->ftable);
+        if (UNLIKELY(csound->actanchor.nxtact != NULL)) {
+          csound->Warning(csound, Str("ftable %d relocating due to size change"
+                                      "\n         currently active instruments "
+                                      "may find this disturbing"), ff->fno);
+        }
+      }
+    }
+    else
+      *ftslot(ff) = ftp = (FUNC*) csound->Malloc(csound, sizeof(FUNC));
+    memcpy(ftp, &hdr, sizeof(FUNC));
+    ftp->ftable = data;
+    ftp->fno = (int32) ff->fno;
+    if (UNLIKELY(csound->oparms->msglevel & 7))
+      csoundMessage(csound, Str("ftable %d:\n"), ff->fno);
+    if (ff->bg == NULL)                     /* else displayed when listed */
+      ftdisplay(csound, ftp);
+    *ftpp = ftp;
+    return 0;
+}
+
 /* alloc ftable space for fno (or replace one) */
 /*  set ftp to point to that structure         */
 
 static CS_NOINLINE FUNC *ftalloc(const FGDATA *ff)
 {
     CSOUND  *csound = ff->csound;
-    FUNC    *ftp = csound->flist[ff->fno];
+    FUNC    *ftp = *ftslot(ff);
 
  
     if (UNLIKELY(ftp != NULL)) {
       csound->Warning(csound, Str("replacing previous ftable %d"), ff->fno);
+      if (ff->bg == NULL)
+        ftrelease(csound, ftp);
+      ftmipmap_discard(csound, ff->fno);
       if (ff->flen != (int32)ftp->flen) {       /* if redraw & diff len, */
         csound->Free(csound, ftp->ftable);
         csound->Free(csound, (void*) ftp);             /*   release old space   */
-        csound->flist[ff->fno] = ftp = NULL;
+        *ftslot(ff) = ftp = NULL;
         if (UNLIKELY(csound->actanchor.nxtact != NULL)) { /*   & chk for danger */
           csound->Warning(csound, Str("ftable %d relocating due to size change"
                                       "\n         currently active instruments "
@@ -2396,7 +2617,7 @@ static CS_NOINLINE FUNC *ftalloc(const FGDATA *ff)
       }
     }
     if (ftp == NULL) {                      /*   alloc space as reqd */
-      csound->flist[ff->fno] = ftp = (FUNC*) csound->Calloc(csound, sizeof(FUNC));
+      *ftslot(ff) = ftp = (FUNC*) csound->Calloc(csound, sizeof(FUNC));
       ftp->ftable = (MYFLT*) csound->Calloc(csound, (1+ff->flen) * sizeof(MYFLT));
     }
     ftp->fno = (int32) ff->fno;
@@ -3215,8 +3436,11 @@ static int gen52(FGDATA *ff, FUNC *ftp)
       MYFLT *pp;
       if (LIKELY((n * 3) + 6<PMAX-1)) pp = &(ff->e.p[(n * 3) + 6]);
       else pp = &(ff->e.c.extra[(n * 3) + 6-PMAX]);
-      f = csoundFTFind(csound, pp);
-      if (UNLIKELY(f == NULL))
+      if (ff->bg != NULL) {
+        if (UNLIKELY((f = ftsource(ff, (int) MYFLT2LONG(*pp))) == NULL))
+          return fterror(ff, Str("an input function does not exist"));
+      }
+      else if (UNLIKELY((f = csoundFTFind(csound, pp)) == NULL))
         return NOTOK;
       len2 = (int) f->flen;
       src = f->ftable;
@@ -3377,7 +3601,7 @@ static int gen53(FGDATA *ff, FUNC *ftp)
     if (UNLIKELY(dstflen < 8 || (dstflen & (dstflen - 1)))) {
       return fterror(ff, Str("GEN53: invalid table length"));
     }
-    srcflen = csoundGetTable(csound, &srcftp, srcftno);
+    srcflen = ftsrctable(ff, &srcftp, srcftno);
     if (UNLIKELY(srcflen < 0)) {
       return fterror(ff, Str("GEN53: invalid source table number"));
     }
@@ -3389,7 +3613,7 @@ static int gen53(FGDATA *ff, FUNC *ftp)
       return fterror(ff, Str("GEN53: invalid source table length:"));
     }
     if (winftno) {
-      winflen = csoundGetTable(csound, &winftp, winftno);
+      winflen = ftsrctable(ff, &winftp, winftno);
       if (UNLIKELY(winflen <= 0 || (winflen & (winflen - 1)))) {
         return fterror(ff, Str("GEN53: invalid window table"));
       }
@@ -3521,3 +3745,497 @@ static CS_NOINLINE FUNC *gen01_defer_load(CSOUND *csound, int fno)
     }
     return csound->flist[fno];
 }
+
+/* Background generation of function tables.
+
+   csoundFTGenAsync() numbers a table and queues its f-statement to a
+   small pool of threads, which run the GEN routine into a private FUNC
+   (FGDATA.bg) instead of the ftable list. The performance thread lists
+   the finished tables at the start of the next k-cycle, so that opcodes
+   see a table complete or not at all. Until then its number is reserved:
+   it is not assigned automatically, and deleting it discards the table.
+
+   Score f-statements due at the same time are generated by the same
+   threads, as many as the -j option asks for: csoundFTGenScore() queues
+   them in order, waiting first for the tables they read, and
+   csoundFTGenSync() waits for all of them before any other event.
+
+   The worker threads never read the ftable list, which the performance
+   thread may grow or change meanwhile. The tables a GEN routine reads are
+   looked up when it is queued (FGDATA.src); a table that is missing, not
+   loaded yet, or read by a GEN not known to this file is made at once on
+   the calling thread instead, where its errors are reported as usual.
+   A table read by a queued GEN is not freed or cleared until that GEN is
+   done. */
+
+#define FTGEN_WORKERS   (2)
+#define FTGEN_MAXWORKERS (32)
+
+enum { FTJOB_QUEUED, FTJOB_RUNNING, FTJOB_DONE };
+
+typedef struct ftjob {
+    struct ftjob *nxt;
+    EVTBLK  e;                  /* owns its string and extra arguments */
+    FUNC    *ftp;               /* the table made, NULL on error */
+    FTSRC   *src;               /* the tables it reads */
+    int     nsrc;
+    int     fno, state, cancelled;
+    int     score;                  /* from csoundFTGenScore() */
+} FTJOB;
+
+typedef struct {
+    CSOUND  *csound;
+    void    *threads[FTGEN_MAXWORKERS];
+    int     nthreads;
+    void    *mutex, *cond;
+    void    *donecond;          /* signalled when a job is done */
+    FTJOB   *jobs, *last;       /* requests not yet listed, in order */
+    volatile int done;          /* jobs done but not listed */
+    int     quit;
+    int     score;              /* score jobs queued since the last sync */
+} FTGEN_ASYNC;
+
+/* is a table being generated for fno? */
+
+static int ftpending(CSOUND *csound, int fno)
+{
+    FTGEN_ASYNC *fa = (FTGEN_ASYNC*) csound->fgens_async;
+    FTJOB       *j;
+
+    if (LIKELY(fa == NULL))
+      return 0;
+    csoundLockMutex(fa->mutex);
+    for (j = fa->jobs; j != NULL; j = j->nxt)
+      if (j->fno == fno && !j->cancelled)
+        break;
+    csoundUnlockMutex(fa->mutex);
+    return (j != NULL);
+}
+
+/* discard the tables being generated for fno, returns their count */
+
+static int ftcancel(CSOUND *csound, int fno)
+{
+    FTGEN_ASYNC *fa = (FTGEN_ASYNC*) csound->fgens_async;
+    FTJOB       *j;
+    int         n = 0;
+
+    if (LIKELY(fa == NULL))
+      return 0;
+    csoundLockMutex(fa->mutex);
+    for (j = fa->jobs; j != NULL; j = j->nxt)
+      if (j->fno == fno && !j->cancelled) {
+        j->cancelled = 1;
+        n++;
+      }
+    csoundUnlockMutex(fa->mutex);
+    return n;
+}
+
+/* does a job not done yet read table ftp? */
+
+static int ftreading(FTGEN_ASYNC *fa, const FUNC *ftp)
+{
+    FTJOB   *j;
+    int     i;
+
+    for (j = fa->jobs; j != NULL; j = j->nxt)
+      if (j->state != FTJOB_DONE)
+        for (i = 0; i < j->nsrc; i++)
+          if (j->src[i].ftp == ftp)
+            return 1;
+    return 0;
+}
+
+/* wait until no job reads ftp, before it is freed or overwritten */
+
+static void ftrelease(CSOUND *csound, const FUNC *ftp)
+{
+    FTGEN_ASYNC *fa = (FTGEN_ASYNC*) csound->fgens_async;
+
+    if (LIKELY(fa == NULL))
+      return;
+    csoundLockMutex(fa->mutex);
+    while (ftreading(fa, ftp))
+      csoundCondWait(fa->donecond, fa->mutex);
+    csoundUnlockMutex(fa->mutex);
+}
+
+static uintptr_t ftgen_thread(void *p)
+{
+    FTGEN_ASYNC *fa = (FTGEN_ASYNC*) p;
+    FTJOB       *j;
+    FUNC        *ftp;
+
+    csoundLockMutex(fa->mutex);
+    while (!fa->quit) {
+      for (j = fa->jobs; j != NULL && j->state != FTJOB_QUEUED; j = j->nxt)
+        ;
+      if (j == NULL) {
+        csoundCondWait(fa->cond, fa->mutex);
+        continue;
+      }
+      j->state = FTJOB_RUNNING;
+      if (!j->cancelled) {
+        csoundUnlockMutex(fa->mutex);
+        fgens(fa->csound, &ftp, &j->e, 1, &j->ftp, j->src, j->nsrc);
+        csoundLockMutex(fa->mutex);
+      }
+      j->state = FTJOB_DONE;
+      ATOMIC_INCR(fa->done);
+      csoundCondSignal(fa->donecond);
+    }
+    csoundUnlockMutex(fa->mutex);
+    return 0;
+}
+
+static int ftgen_stop(CSOUND *csound, void *p)
+{
+    FTGEN_ASYNC *fa = (FTGEN_ASYNC*) csound->fgens_async;
+    int         i;
+    (void) p;
+
+    if (fa == NULL)
+      return OK;
+    csoundLockMutex(fa->mutex);
+    fa->quit = 1;
+    for (i = 0; i < fa->nthreads; i++)
+      csoundCondSignal(fa->cond);
+    csoundUnlockMutex(fa->mutex);
+    for (i = 0; i < fa->nthreads; i++)
+      csoundJoinThread(fa->threads[i]);
+    csoundDestroyCondVar(fa->donecond);
+    csoundDestroyCondVar(fa->cond);
+    csoundDestroyMutex(fa->mutex);
+    csound->fgens_async = NULL;
+    return OK;
+}
+
+/* the thread pool, with at least nthreads threads if possible */
+
+static FTGEN_ASYNC *ftgen_async_get(CSOUND *csound, int nthreads)
+{
+    FTGEN_ASYNC *fa = (FTGEN_ASYNC*) csound->fgens_async;
+
+    if (nthreads > FTGEN_MAXWORKERS)
+      nthreads = FTGEN_MAXWORKERS;
+    if (fa != NULL) {
+      while (fa->nthreads < nthreads) {
+        void *t = csoundCreateThread(ftgen_thread, (void*) fa);
+        if (UNLIKELY(t == NULL))
+          break;
+        fa->threads[fa->nthreads++] = t;
+      }
+      return fa;
+    }
+#ifndef __EMSCRIPTEN__
+    fa = (FTGEN_ASYNC*) csound->Calloc(csound, sizeof(FTGEN_ASYNC));
+    fa->csound = csound;
+    fa->mutex = csoundCreateMutex(0);
+    fa->cond = csoundCreateCondVar();
+    fa->donecond = csoundCreateCondVar();
+    if (LIKELY(fa->mutex != NULL && fa->cond != NULL &&
+               fa->donecond != NULL)) {
+      while (fa->nthreads < nthreads) {
+        void *t = csoundCreateThread(ftgen_thread, (void*) fa);
+        if (UNLIKELY(t == NULL))
+          break;
+        fa->threads[fa->nthreads++] = t;
+      }
+    }
+    if (LIKELY(fa->nthreads > 0)) {
+      csound->fgens_async = (void*) fa;
+      csoundRegisterResetCallback(csound, NULL, ftgen_stop);
+      return fa;
+    }
+    csound->Warning(csound, Str("could not start table generation threads"));
+    if (fa->donecond != NULL)
+      csoundDestroyCondVar(fa->donecond);
+    if (fa->cond != NULL)
+      csoundDestroyCondVar(fa->cond);
+    if (fa->mutex != NULL)
+      csoundDestroyMutex(fa->mutex);
+    csound->Free(csound, fa);
+#endif
+    return NULL;
+}
+
+static void ftgen_wait(CSOUND *, FTGEN_ASYNC *, int);
+
+/* add table fno to the list of sources; 0 if it cannot be read at once */
+
+static int ftgen_source(CSOUND *csound, FTSRC *src, int *nsrc, int fno,
+                        int strict)
+{
+    FUNC    *ftp;
+    int     i;
+
+    for (i = 0; i < *nsrc; i++)
+      if (src[i].fno == fno)
+        return 1;
+    if (fno <= 0 || fno > csound->maxfnum ||
+        (ftp = csound->flist[fno]) == NULL || ftp->flen == 0)
+      return 0;                                 /* missing or deferred */
+    if (strict && (ftp->lenmask == -1 || ftp->lenmask == 0))
+      return 0;                                 /* refused by csoundFTFind */
+    src[*nsrc].fno = fno;
+    src[*nsrc].ftp = ftp;
+    (*nsrc)++;
+    return 1;
+}
+
+/* look up the tables read by f-statement evtblkp, after those being made;
+   returns 0 and sets *srcp and *nsrcp, or -1 if the table is to be made
+   on this thread                                                        */
+
+static int ftgen_sources(CSOUND *csound, FTGEN_ASYNC *fa,
+                         const EVTBLK *evtblkp, FTSRC **srcp, int *nsrcp)
+{
+    NAMEDGEN *n;
+    FTSRC   *src;
+    int     genum, first, step, i, k, nsrc = 0;
+
+    *srcp = NULL;
+    *nsrcp = 0;
+    if (evtblkp->pcnt <= 4)
+      return 0;                                 /* an error of fgens() */
+    if (isstrcod(evtblkp->p[4])) {
+      for (n = (NAMEDGEN*) csound->namedgen; n != NULL; n = n->next)
+        if (evtblkp->strarg != NULL && strcmp(n->name, evtblkp->strarg) == 0)
+          break;
+      if (n == NULL)
+        return 0;
+      /* plugin GENs look tables up themselves */
+      return (ftsources(n->genum, n->name, &first, &step) == 0 ? 0 : -1);
+    }
+    genum = abs((int) MYFLT2LRND(evtblkp->p[4]));
+    if (!genum || genum > csound->genmax)
+      return 0;                                 /* an error of fgens() */
+    if (genum == 43 ||                          /* shares loaded files */
+        genum == 21)                            /* shares the random state */
+      return -1;
+    if ((i = ftsources(genum, NULL, &first, &step)) <= 0)
+      return i;
+    if (evtblkp->pcnt > PMAX)
+      return -1;                                /* extended arguments */
+    src = (FTSRC*) csound->Malloc(csound, sizeof(FTSRC) * 2 * evtblkp->pcnt);
+    for (i = first; i <= evtblkp->pcnt; i += step) {
+      MYFLT x = evtblkp->p[i];
+      int   fno[2];
+      fno[0] = (int) x;                         /* as GENs read it */
+      fno[1] = (int) MYFLT2LRND(x);
+      for (k = 0; k < 2; k++) {
+        if (genum == 32)
+          fno[k] = abs(fno[k]);
+        if (fno[k] == 0 && genum == 53 && i > first)
+          continue;                             /* no window */
+        if (fno[k] > 0 && ftpending(csound, fno[k]))
+          ftgen_wait(csound, fa, fno[k]);       /* tables read come first */
+        if (!ftgen_source(csound, src, &nsrc, fno[k],
+                          genum == 18 || genum == 52)) {
+          csound->Free(csound, src);
+          return -1;
+        }
+      }
+      if (step == 0)
+        break;
+    }
+    *srcp = src;
+    *nsrcp = nsrc;
+    return 0;
+}
+
+/* queue f-statement evtblkp for table fno, reading the nsrc tables of
+   src, which the job takes                                           */
+
+static void ftgen_queue(CSOUND *csound, FTGEN_ASYNC *fa,
+                        const EVTBLK *evtblkp, int fno, int score,
+                        FTSRC *src, int nsrc)
+{
+    FTJOB   *j;
+
+    ftlist_extend(csound, fno);
+    ftcancel(csound, fno);                      /* superseded */
+    j = (FTJOB*) csound->Calloc(csound, sizeof(FTJOB));
+    memcpy(&(j->e), evtblkp, sizeof(EVTBLK));
+    j->e.p[1] = (MYFLT) fno;
+    if (evtblkp->strarg != NULL) {
+      j->e.strarg = (char*) csound->Malloc(csound, strlen(evtblkp->strarg) + 1);
+      strcpy(j->e.strarg, evtblkp->strarg);
+    }
+    if (evtblkp->pcnt > PMAX) {
+      size_t n = sizeof(MYFLT) * (size_t) (evtblkp->c.extra[0] + 1);
+      j->e.c.extra = (MYFLT*) csound->Malloc(csound, n);
+      memcpy(j->e.c.extra, evtblkp->c.extra, n);
+    }
+    j->src = src;
+    j->nsrc = nsrc;
+    j->fno = fno;
+    j->score = score;
+    fa->score |= score;
+    csoundLockMutex(fa->mutex);
+    if (fa->last != NULL)
+      fa->last->nxt = j;
+    else
+      fa->jobs = j;
+    fa->last = j;
+    csoundCondSignal(fa->cond);
+    csoundUnlockMutex(fa->mutex);
+}
+
+/* list the tables of the jobs for fno (or of all score jobs if fno is
+   0) when they are done                                              */
+
+static void ftgen_wait(CSOUND *csound, FTGEN_ASYNC *fa, int fno)
+{
+    FTJOB   *j;
+
+    csoundLockMutex(fa->mutex);
+    for (;;) {
+      for (j = fa->jobs; j != NULL; j = j->nxt)
+        if (j->state != FTJOB_DONE &&
+            (fno == 0 ? j->score : (j->fno == fno && !j->cancelled)))
+          break;
+      if (j == NULL)
+        break;
+      csoundCondWait(fa->donecond, fa->mutex);
+    }
+    csoundUnlockMutex(fa->mutex);
+    csoundFTGenPublish(csound);
+}
+
+int csoundFTGenAsync(CSOUND *csound, const EVTBLK *evtblkp, int mode)
+{
+    FTGEN_ASYNC *fa;
+    FUNC        *ftp;
+    FTSRC       *src;
+    int         fno = (int) MYFLT2LRND(evtblkp->p[1]);
+    int         nsrc;
+
+    gensub_init(csound);
+    if (fno < 0 || (fa = ftgen_async_get(csound, FTGEN_WORKERS)) == NULL ||
+        ftgen_sources(csound, fa, evtblkp, &src, &nsrc) != 0) {
+      /* deletions, everything without threads, GENs sharing state with
+         this thread (21, 43), and tables reading tables that are missing
+         or not known here, at once                                      */
+      if (fgens(csound, &ftp, evtblkp, mode, NULL, NULL, 0) != 0)
+        return -1;
+      return (ftp != NULL ? (int) ftp->fno : 0);
+    }
+    if (fno == 0) {
+      if (!mode) {
+        if (src != NULL)
+          csound->Free(csound, src);
+        return 0;
+      }
+      fno = ftnumber(csound);
+    }
+    ftgen_queue(csound, fa, evtblkp, fno, 0, src, nsrc);
+    return fno;
+}
+
+int csoundFTGenScore(CSOUND *csound, const EVTBLK *evtblkp)
+{
+    FTGEN_ASYNC *fa;
+    FUNC        *ftp;
+    FTSRC       *src;
+    int         fno = (int) MYFLT2LRND(evtblkp->p[1]);
+    int         nsrc;
+
+    gensub_init(csound);
+    /* replacing a table may change what queued GENs read; a table that
+       reads a missing one is made here, to report the error at once     */
+    if (csound->oparms->numThreads < 2 || csound->oparms->realtime ||
+        fno <= 0 || evtblkp->pcnt <= 4 || evtblkp->pcnt > PMAX ||
+        (fno <= csound->maxfnum && csound->flist[fno] != NULL) ||
+        ftpending(csound, fno) ||
+        (fa = ftgen_async_get(csound, csound->oparms->numThreads)) == NULL ||
+        ftgen_sources(csound, fa, evtblkp, &src, &nsrc) != 0) {
+      csoundFTGenSync(csound);
+      return hfgens(csound, &ftp, evtblkp, 0);
+    }
+    ftgen_queue(csound, fa, evtblkp, fno, 1, src, nsrc);
+    return 0;
+}
+
+void csoundFTGenSync(CSOUND *csound)
+{
+    FTGEN_ASYNC *fa = (FTGEN_ASYNC*) csound->fgens_async;
+
+    if (fa != NULL && fa->score) {
+      ftgen_wait(csound, fa, 0);
+      fa->score = 0;
+    }
+}
+
+int csoundFTGenReady(CSOUND *csound, int fno)
+{
+    if (ftpending(csound, fno))
+      return 0;
+    if ((unsigned int) (fno - 1) < (unsigned int) csound->maxfnum &&
+        csound->flist[fno] != NULL)
+      return 1;
+    return -1;
+}
+
+void csoundFTGenPublish(CSOUND *csound)
+{
+    FTGEN_ASYNC *fa = (FTGEN_ASYNC*) csound->fgens_async;
+    FTJOB       *j, **pp, *done = NULL, **dp = &done;
+    int         realtime = csound->oparms->realtime, kept = 0;
+
+    if (fa == NULL || !ATOMIC_GET(fa->done))
+      return;
+    /* instances are initialised on another thread in realtime mode */
+    if (realtime &&
+        csoundSpinTryLock(&csound->alloc_spinlock) != CSOUND_SUCCESS)
+      return;
+    csoundLockMutex(fa->mutex);
+    fa->last = NULL;
+    for (pp = &fa->jobs; (j = *pp) != NULL; ) {
+      /* a table replaced while a queued GEN reads it waits for the GEN */
+      if (j->state == FTJOB_DONE && j->ftp != NULL && !j->cancelled &&
+          csound->flist[j->fno] != NULL &&
+          ftreading(fa, csound->flist[j->fno])) {
+        kept++;
+        fa->last = j;
+        pp = &j->nxt;
+      }
+      else if (j->state == FTJOB_DONE) {
+        *pp = j->nxt;
+        *dp = j;
+        dp = &j->nxt;
+      }
+      else {
+        fa->last = j;
+        pp = &j->nxt;
+      }
+    }
+    *dp = NULL;
+    fa->done = kept;
+    csoundUnlockMutex(fa->mutex);
+    while ((j = done) != NULL) {
+      done = j->nxt;
+      if (j->ftp != NULL && j->cancelled)
+        csoundHousekeepTable(csound, j->ftp);
+      else if (j->ftp != NULL) {
+        FUNC *old = csound->flist[j->fno];
+        if (old != NULL) {
+          csound->Warning(csound, Str("replacing previous ftable %d"), j->fno);
+          ftmipmap_discard(csound, j->fno);
+          csoundHousekeepTable(csound, old);
+        }
+        csound->flist[j->fno] = j->ftp;
+        ftdisplay(csound, j->ftp);
+      }
+      if (j->src != NULL)
+        csound->Free(csound, j->src);
+      if (j->e.strarg != NULL)
+        csound->Free(csound, j->e.strarg);
+      if (j->e.pcnt > PMAX)
+        csound->Free(csound, j->e.c.extra);
+      csound->Free(csound, j);
+    }
+    if (realtime)
+      csoundSpinUnLock(&csound->alloc_spinlock);
+}
@@ -0,0 +1,433 @@
+/*
+    fgens_cache.c:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Persistent cache of generated function tables.
+ *
+ * When the CSFTCACHE environment variable names a directory, tables of
+ * FT_CACHE_MINLEN points or more are stored there after their GEN routine
+ * has run, and later requests for the same table are read back instead
+ * of being computed again.  The key combines the GEN routine, all of its
+ * arguments, the sample rate, the contents of the tables it reads, and
+ * the path, size and modification time of the files it reads.  GEN21 and
+ * GEN routines of plugins unknown to ftsources() are never cached.
+ *
+ * A cache file holds a header, the FUNC structure and the table data as
+ * raw MYFLT values.  Where possible the file is mapped privately and the
+ * mapping is used as the table memory, so that pages are only read when
+ * the table is, and writes to the table stay in memory.  Cache files are
+ * replaced by rename and never modified, so removing them is safe at any
+ * time.
+ *
+ * The cache is limited to CSFTCACHESIZE megabytes (FT_CACHE_MAXMB if not
+ * set).  When a table is stored and the files of the directory take more
+ * than that, the least recently used ones are removed, a hit making its
+ * file the most recently used.  This needs <dirent.h>; elsewhere the
+ * directory is left to grow.
+ */
+
+#include "csoundCore.h"
+#include "fgens.h"
+#include <sys/stat.h>
+#if defined(HAVE_DIRENT_H)
+#  include <dirent.h>
+#  include <utime.h>
+#endif
+#ifdef CS_MMAPBLOCK
+#include <sys/mman.h>
+#endif
+
+extern int isstrcod(MYFLT);
+
+#define FT_CACHE_MAGIC      "CSFTC001"
+#define FT_CACHE_MINLEN     4096
+#define FT_CACHE_ALIGN      64
+#define FT_CACHE_MAXMB      256
+
+typedef struct {
+    char      magic[8];
+    uint64_t  key;
+    uint64_t  datalen;          /* bytes of table data          */
+    uint32_t  funclen;          /* sizeof(FUNC)                 */
+    uint32_t  offset;           /* of the table data            */
+} FTCACHEHDR;
+
+/* GEN routines reading files: name prefix of numbered files, and search
+   path, as used by the GEN routine                                      */
+
+static const struct {
+    int         genum;
+    const char  *prefix;
+    const char  *env;
+} ft_files[] = {
+    {  1, "soundin.", "SFDIR;SSDIR"         },
+    { 23, NULL,       "SFDIR;SSDIR;INCDIR"  },
+    { 28, NULL,       "SFDIR;SSDIR;INCDIR"  },
+    { 43, "pvoc.",    "SADIR"               },
+    { 44, "stiff.",   "SFDIR;SSDIR;INCDIR"  },
+    { 49, "soundin.", "SFDIR;SSDIR"         },
+    {  0, NULL,       NULL                  }
+};
+
+static inline uint64_t fnv1a(uint64_t h, const void *p, size_t n)
+{
+    const uint8_t *s = (const uint8_t*) p;
+    while (n--) {
+      h ^= *s++;
+      h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/* table data, a word at a time */
+
+static uint64_t hash_data(uint64_t h, const MYFLT *p, size_t n)
+{
+    const uint8_t *s = (const uint8_t*) p;
+    size_t        i, nb = n * sizeof(MYFLT);
+    uint64_t      w;
+
+    for (i = 0; i + 8 <= nb; i += 8) {
+      memcpy(&w, s + i, 8);
+      h = (h ^ w) * 0x100000001b3ULL;
+      h ^= h >> 29;
+    }
+    return fnv1a(h, s + i, nb - i);
+}
+
+/* contents of the table numbered by p-field n; 0 if there is none */
+
+static uint64_t hash_table(CSOUND *csound, uint64_t h, const FGDATA *ff,
+                           int n)
+{
+    FUNC  *ftp;
+    int   fno;
+
+    if (n >= PMAX - 1 || n > ff->e.pcnt)
+      return 0;
+    fno = (int) MYFLT2LRND(ff->e.p[n]);
+    if ((ftp = ftsource(ff, fno)) == NULL || ftp->ftable == NULL)
+      return 0;
+    h = fnv1a(h, &fno, sizeof(int));
+    h = fnv1a(h, &(ftp->flen), sizeof(ftp->flen));
+    h = hash_data(h, ftp->ftable, (size_t) ftp->flen + 1);
+    return (h != 0 ? h : 1);
+}
+
+/* path, size and modification time of the file of p5; 0 if not found */
+
+static uint64_t hash_file(CSOUND *csound, uint64_t h, const FGDATA *ff,
+                          const char *prefix, const char *env)
+{
+    char        name[256], *path;
+    struct stat st;
+    int64_t     v[3];
+
+    if (isstrcod(ff->e.p[5])) {
+      if (ff->e.strarg == NULL)
+        return 0;
+      strNcpy(name, ff->e.strarg, sizeof(name));
+    }
+    else if (prefix != NULL)
+      snprintf(name, sizeof(name), "%s%d", prefix,
+               (int) MYFLT2LRND(ff->e.p[5]));
+    else
+      return 0;
+    if ((path = csoundFindInputFile(csound, name, env)) == NULL)
+      return 0;
+    if (stat(path, &st) != 0) {
+      csound->Free(csound, path);
+      return 0;
+    }
+    v[0] = (int64_t) st.st_size;
+    v[1] = (int64_t) st.st_mtime;
+    v[2] = (int64_t) st.st_ino;
+    h = fnv1a(h, path, strlen(path) + 1);
+    h = fnv1a(h, v, sizeof(v));
+    csound->Free(csound, path);
+    return (h != 0 ? h : 1);
+}
+
+static char *ft_cache_path(CSOUND *csound, uint64_t key, const char *ext)
+{
+    const char *dir = csoundGetEnv(csound, "CSFTCACHE");
+    char       *path;
+    size_t     len;
+
+    if (dir == NULL || dir[0] == '\0')
+      return NULL;
+    len = strlen(dir) + 32;
+    path = csound->Malloc(csound, len);
+    snprintf(path, len, "%s%c%016llx.%s", dir, DIRSEP,
+             (unsigned long long) key, ext);
+    return path;
+}
+
+#if defined(HAVE_DIRENT_H)
+
+typedef struct {
+    char      *path;
+    int64_t   size;
+    time_t    mtime;
+} FTCACHEFILE;
+
+static int ft_cache_older(const void *a, const void *b)
+{
+    const FTCACHEFILE *x = (const FTCACHEFILE*) a, *y = (const FTCACHEFILE*) b;
+    return (x->mtime < y->mtime ? -1 : (x->mtime > y->mtime ? 1 : 0));
+}
+
+/* remove the least recently used files of the cache, other than keep,
+   until they fit in its size limit */
+
+static void ft_cache_trim(CSOUND *csound, const char *keep)
+{
+    const char    *dir = csoundGetEnv(csound, "CSFTCACHE");
+    const char    *s = csoundGetEnv(csound, "CSFTCACHESIZE");
+    int64_t       maxsize, total = 0;
+    DIR           *d;
+    struct dirent *ent;
+    struct stat   st;
+    FTCACHEFILE   *files = NULL;
+    int           i, cnt = 0, max = 0;
+    size_t        len;
+
+    maxsize = (int64_t) (s != NULL && atoi(s) > 0 ? atoi(s) : FT_CACHE_MAXMB)
+                << 20;
+    if ((d = opendir(dir)) == NULL)
+      return;
+    while ((ent = readdir(d)) != NULL) {
+      len = strlen(ent->d_name);
+      if (len != 19 || strcmp(ent->d_name + 16, ".ft") != 0)
+        continue;
+      if (cnt == max) {
+        max = (max ? 2 * max : 64);
+        files = (FTCACHEFILE*) csound->ReAlloc(csound, files,
+                                               max * sizeof(FTCACHEFILE));
+      }
+      len += strlen(dir) + 2;
+      files[cnt].path = csound->Malloc(csound, len);
+      snprintf(files[cnt].path, len, "%s%c%s", dir, DIRSEP, ent->d_name);
+      if (stat(files[cnt].path, &st) != 0) {
+        csound->Free(csound, files[cnt].path);
+        continue;
+      }
+      files[cnt].size = (int64_t) st.st_size;
+      files[cnt].mtime = st.st_mtime;
+      total += files[cnt++].size;
+    }
+    closedir(d);
+    if (total > maxsize) {
+      qsort(files, cnt, sizeof(FTCACHEFILE), ft_cache_older);
+      for (i = 0; i < cnt && total > maxsize; i++)
+        if (strcmp(files[i].path, keep) != 0 && remove(files[i].path) == 0)
+          total -= files[i].size;
+    }
+    for (i = 0; i < cnt; i++)
+      csound->Free(csound, files[i].path);
+    csound->Free(csound, files);
+}
+
+#endif
+
+/**
+ * Cache key of the table described by ff, made by GEN genum (name, if
+ * not NULL, for a named GEN routine); 0 if the table is not cached.
+ */
+
+uint64_t ftcache_key(CSOUND *csound, const FGDATA *ff, int genum,
+                     const char *name)
+{
+    const char *dir = csoundGetEnv(csound, "CSFTCACHE");
+    uint64_t   h = 0xcbf29ce484222325ULL;
+    int32_t    ver[7];
+    int        i, n, flen, src, first, step;
+
+    if (dir == NULL || dir[0] == '\0')
+      return 0;
+    flen = (ff->flen < 0 ? -(ff->flen) : ff->flen);
+    if (flen != 0 && flen < FT_CACHE_MINLEN)
+      return 0;                         /* cheaper to make than to read */
+    if (genum == 21)                    /* random */
+      return 0;
+    if ((src = ftsources(genum, name, &first, &step)) < 0)
+      return 0;                         /* unknown plugin GEN */
+    if ((genum == 1 || genum == 49) && csound->oparms->gen01defer)
+      return 0;                         /* loaded when first used */
+
+    ver[0] = CS_VERSION; ver[1] = CS_SUBVER; ver[2] = CS_PATCHLEVEL;
+    ver[3] = CS_APIVERSION; ver[4] = (int32_t) sizeof(MYFLT);
+    ver[5] = (int32_t) sizeof(FUNC); ver[6] = 1;
+    h = fnv1a(h, FT_CACHE_MAGIC, sizeof(FT_CACHE_MAGIC));
+    h = fnv1a(h, ver, sizeof(ver));    /* ver[6] for the byte order */
+    h = fnv1a(h, &(csound->esr), sizeof(MYFLT));
+    if (name != NULL)
+      h = fnv1a(h, name, strlen(name) + 1);
+    else {
+      h = fnv1a(h, &genum, sizeof(int));
+      if (ff->e.strarg != NULL)
+        h = fnv1a(h, ff->e.strarg, strlen(ff->e.strarg) + 1);
+    }
+    /* arguments from the size on; for named GENs, p4 is the name */
+    n = (ff->e.pcnt > PMAX ? PMAX - 1 : ff->e.pcnt);
+    h = fnv1a(h, &(ff->e.pcnt), sizeof(ff->e.pcnt));
+    for (i = 3; i <= n; i++)
+      if (i != 4 || name == NULL)
+        h = fnv1a(h, &(ff->e.p[i]), sizeof(MYFLT));
+    if (ff->e.pcnt > PMAX && ff->e.c.extra != NULL)
+      h = fnv1a(h, &(ff->e.c.extra[1]),
+                sizeof(MYFLT) * (size_t) ff->e.c.extra[0]);
+
+    /* what the GEN routine reads */
+    for (i = 0; name == NULL && ft_files[i].genum != 0; i++)
+      if (ft_files[i].genum == genum)
+        return hash_file(csound, h, ff, ft_files[i].prefix, ft_files[i].env);
+    for (i = first; src > 0 && i <= ff->e.pcnt; i += step) {
+      if ((h = hash_table(csound, h, ff, i)) == 0)
+        return 0;                       /* left to the GEN to report */
+      if (step == 0)
+        break;
+    }
+    return h;                           /* 0 if a source table is missing */
+}
+
+/**
+ * Read table key from the cache: its header is copied to ftp, and the
+ * data returned as memory to be released with csound->Free().
+ * Returns NULL if the table is not in the cache.
+ */
+
+MYFLT *ftcache_load(CSOUND *csound, uint64_t key, FUNC *ftp)
+{
+    FTCACHEHDR  hdr;
+    FILE        *f;
+    char        *path;
+    MYFLT       *data = NULL;
+    long        len;
+
+    if ((path = ft_cache_path(csound, key, "ft")) == NULL)
+      return NULL;
+    if ((f = fopen(path, "rb")) == NULL) {
+      csound->Free(csound, path);
+      return NULL;
+    }
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+        memcmp(hdr.magic, FT_CACHE_MAGIC, 8) != 0 || hdr.key != key ||
+        hdr.funclen != (uint32_t) sizeof(FUNC) ||
+        fread(ftp, sizeof(FUNC), 1, f) != 1 ||
+        hdr.datalen != ((uint64_t) ftp->flen + 1) * sizeof(MYFLT) ||
+        hdr.offset < sizeof(hdr) + sizeof(FUNC) ||
+        fseek(f, 0L, SEEK_END) != 0 || (len = ftell(f)) < 0 ||
+        (uint64_t) len != hdr.offset + hdr.datalen) {
+      csound->Warning(csound, Str("ftable cache: ignoring invalid %s\n"),
+                      path);
+      fclose(f);
+      csound->Free(csound, path);
+      return NULL;
+    }
+#ifdef CS_MMAPBLOCK
+    {
+      void *map = mmap(NULL, (size_t) len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, fileno(f), 0);
+      if (map != MAP_FAILED)
+        data = (MYFLT*) mmapblock(csound, map, (size_t) len,
+                                  (size_t) hdr.offset);
+    }
+#endif
+    if (data == NULL) {
+      data = (MYFLT*) csound->Malloc(csound, (size_t) hdr.datalen);
+      if (fseek(f, (long) hdr.offset, SEEK_SET) != 0 ||
+          fread(data, 1, (size_t) hdr.datalen, f) != (size_t) hdr.datalen) {
+        csound->Warning(csound, Str("ftable cache: cannot read %s\n"), path);
+        csound->Free(csound, data);
+        data = NULL;
+      }
+    }
+    fclose(f);
+#if defined(HAVE_DIRENT_H)
+    if (data != NULL)
+      utime(path, NULL);                /* most recently used */
+#endif
+    if (data != NULL && UNLIKELY(csound->oparms->odebug))
+      csound->Message(csound, Str("ftable cache: loaded %s\n"), path);
+    csound->Free(csound, path);
+    return data;
+}
+
+/**
+ * Store table ftp under key, if it is long enough to be worth it.
+ */
+
+void ftcache_store(CSOUND *csound, uint64_t key, const FUNC *ftp)
+{
+    FTCACHEHDR  hdr;
+    FUNC        *fn;
+    FILE        *f;
+    char        *path, *tmp, pad[FT_CACHE_ALIGN];
+    int         err;
+
+    if (ftp->ftable == NULL || ftp->flen < FT_CACHE_MINLEN)
+      return;
+    if ((path = ft_cache_path(csound, key, "ft")) == NULL)
+      return;
+    tmp = ft_cache_path(csound, key, "tmp");
+    if ((f = fopen(tmp, "wb")) == NULL) {
+      csound->Warning(csound, Str("ftable cache: cannot write %s\n"), tmp);
+      csound->Free(csound, tmp);
+      csound->Free(csound, path);
+      return;
+    }
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, FT_CACHE_MAGIC, 8);
+    hdr.key = key;
+    hdr.datalen = ((uint64_t) ftp->flen + 1) * sizeof(MYFLT);
+    hdr.funclen = (uint32_t) sizeof(FUNC);
+    hdr.offset = (uint32_t) ((sizeof(hdr) + sizeof(FUNC) + FT_CACHE_ALIGN - 1)
+                             & ~(FT_CACHE_ALIGN - 1));
+    fn = (FUNC*) csound->Malloc(csound, sizeof(FUNC));
+    memcpy(fn, ftp, sizeof(FUNC));
+    fn->fno = 0;
+    fn->ftable = NULL;
+    memset(pad, 0, sizeof(pad));
+    err = (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+           fwrite(fn, sizeof(FUNC), 1, f) != 1 ||
+           fwrite(pad, 1, hdr.offset - sizeof(hdr) - sizeof(FUNC), f) !=
+             hdr.offset - sizeof(hdr) - sizeof(FUNC) ||
+           fwrite(ftp->ftable, 1, (size_t) hdr.datalen, f) !=
+             (size_t) hdr.datalen);
+    err |= (fclose(f) != 0);
+    csound->Free(csound, fn);
+    /* write then rename, so that readers never see a partial file */
+    if (err || rename(tmp, path) != 0) {
+      csound->Warning(csound, Str("ftable cache: cannot write %s\n"), path);
+      remove(tmp);
+    }
+    else {
+      if (UNLIKELY(csound->oparms->odebug))
+        csound->Message(csound, Str("ftable cache: stored %s\n"), path);
+#if defined(HAVE_DIRENT_H)
+      ft_cache_trim(csound, path);
+#endif
+    }
+    csound->Free(csound, tmp);
+    csound->Free(csound, path);
+}
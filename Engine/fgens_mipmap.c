@@ -0,0 +1,200 @@
+/*
+    fgens_mipmap.c:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Band-limited mip-maps of function tables.
+ *
+ * Level k of a table of N points holds its harmonics up to N >> (k + 1),
+ * so that an oscillator advancing by up to 2^k table points per sample
+ * reads it without aliasing.  Levels are made from one FFT of the table:
+ * the spectrum is cut and transformed back at a length of FT_MIP_OVERSAMP
+ * points per period of the highest harmonic, but not above N nor below
+ * FT_MIP_MINLEN, so that they interpolate no worse than the table itself
+ * would; level 0 is a copy of the table.  Every level has guard points
+ * before and after it for cubic interpolation.
+ *
+ * The copies of a table are made the first time an oscillator asks for
+ * them, and kept per table number.  When the table is replaced they are
+ * marked stale and made again on the next request: in the same memory if
+ * the length is unchanged, so that opcodes still holding them keep
+ * reading valid data.  Otherwise the old entry is retired, and freed when
+ * the last opcode holding it gives it back.
+ */
+
+#include "csoundCore.h"
+#include "fgens.h"
+#include "ftmipmap.h"
+
+#define FT_MIP_MINLEN   4096
+#define FT_MIP_OVERSAMP 64
+
+typedef struct {
+    FTMIPMAP  mip;              /* first, so that &e->mip is e */
+    MYFLT     *src;             /* ftp->ftable the levels were made from */
+    uint32_t  flen;
+    int       stale;
+    int       refs;             /* references taken by csoundFTMipMap() */
+    int       retired;          /* no longer in the map */
+    MYFLT     *data;            /* all levels, with their guard points */
+} MIPENTRY;
+
+typedef struct {
+    int       size;
+    MIPENTRY  **map;            /* indexed by table number */
+} MIPMAPS;
+
+static int32 mip_len(uint32_t flen, int k)
+{
+    uint32_t  len = (k == 0 ? flen : (flen >> (k + 1)) * FT_MIP_OVERSAMP);
+
+    if (len < FT_MIP_MINLEN)
+      len = FT_MIP_MINLEN;
+    return (int32) (len > flen ? flen : len);
+}
+
+static void mip_level(FTMIPLEVEL *l, MYFLT *data, int32 len)
+{
+    int32   ltest;
+
+    l->flen = len;
+    for (ltest = len, l->lobits = 0; (ltest & MAXLEN) == 0; ltest <<= 1)
+      l->lobits++;
+    l->lomask = (1 << l->lobits) - 1;
+    l->lodiv = FL(1.0) / (MYFLT) (1 << l->lobits);
+    l->ftable = data + 1;
+}
+
+/* guard points: one before, three after */
+
+static void mip_guard(FTMIPLEVEL *l)
+{
+    MYFLT   *t = l->ftable;
+
+    t[-1] = t[l->flen - 1];
+    t[l->flen] = t[0];
+    t[l->flen + 1] = t[1];
+    t[l->flen + 2] = t[2];
+}
+
+static void mip_make(CSOUND *csound, MIPENTRY *e, FUNC *ftp)
+{
+    uint32_t  flen = ftp->flen;
+    MYFLT     *spec, *x, *data, scl;
+    int32     k, i, len, h;
+
+    if (e->data == NULL || e->flen != flen) {
+      csound->Free(csound, e->data);
+      e->mip.nlevels = 0;
+      for (h = flen; h > 1; h >>= 1)
+        e->mip.nlevels++;
+      for (k = 0, len = 0; k < e->mip.nlevels; k++)
+        len += mip_len(flen, k) + 4;
+      e->data = data = (MYFLT*) csound->Malloc(csound, sizeof(MYFLT) * len);
+      for (k = 0; k < e->mip.nlevels; k++) {
+        mip_level(&e->mip.level[k], data, mip_len(flen, k));
+        data += e->mip.level[k].flen + 4;
+      }
+      e->flen = flen;
+    }
+    memcpy(e->mip.level[0].ftable, ftp->ftable, sizeof(MYFLT) * flen);
+    mip_guard(&e->mip.level[0]);
+    spec = (MYFLT*) csound->Malloc(csound, sizeof(MYFLT) * (2 * flen + 4));
+    x = spec + flen + 2;
+    memcpy(spec, ftp->ftable, sizeof(MYFLT) * flen);
+    csound->RealFFT(csound, spec, (int) flen);
+    spec[flen] = spec[1];
+    spec[1] = spec[flen + 1] = FL(0.0);
+    for (k = 1; k < e->mip.nlevels; k++) {
+      FTMIPLEVEL *l = &e->mip.level[k];
+      len = l->flen;
+      h = flen >> (k + 1);
+      scl = csound->GetInverseRealFFTScale(csound, (int) len)
+            * (MYFLT) len / (MYFLT) flen;
+      for (i = 0; i < 2 * (h + 1); i++)
+        x[i] = spec[i] * scl;
+      for ( ; i < len + 2; i++)
+        x[i] = FL(0.0);
+      x[1] = x[len];
+      csound->InverseRealFFT(csound, x, (int) len);
+      memcpy(l->ftable, x, sizeof(MYFLT) * len);
+      mip_guard(l);
+    }
+    csound->Free(csound, spec);
+    e->mip.ftp = ftp;
+    e->src = ftp->ftable;
+    e->stale = 0;
+}
+
+FTMIPMAP *csoundFTMipMap(CSOUND *csound, FUNC *ftp)
+{
+    MIPMAPS   *mm = (MIPMAPS*) csound->ft_mipmaps;
+    MIPENTRY  *e;
+    int       fno, i;
+
+    if (UNLIKELY(ftp == NULL || ftp->flen < 4 || (ftp->flen & (ftp->flen - 1))
+                 || ftp->nchanls > 1))
+      return NULL;
+    fno = (int) ftp->fno;
+    if (UNLIKELY(fno <= 0 || fno > csound->maxfnum ||
+                 csound->flist[fno] != ftp))
+      return NULL;
+    if (mm == NULL)
+      csound->ft_mipmaps = mm = (MIPMAPS*) csound->Calloc(csound,
+                                                          sizeof(MIPMAPS));
+    if (fno >= mm->size) {
+      mm->map = (MIPENTRY**) csound->ReAlloc(csound, mm->map,
+                                             sizeof(MIPENTRY*) * (fno + 1));
+      for (i = mm->size; i <= fno; i++)
+        mm->map[i] = NULL;
+      mm->size = fno + 1;
+    }
+    if ((e = mm->map[fno]) != NULL && e->refs > 0 && e->flen != ftp->flen) {
+      /* the levels would move: leave them to their users */
+      e->retired = 1;
+      e = NULL;
+    }
+    if (e == NULL)
+      e = mm->map[fno] = (MIPENTRY*) csound->Calloc(csound, sizeof(MIPENTRY));
+    if (e->data == NULL || e->stale || e->mip.ftp != ftp ||
+        e->src != ftp->ftable || e->flen != ftp->flen)
+      mip_make(csound, e, ftp);
+    e->refs++;
+    return &e->mip;
+}
+
+void ftmipmap_release(CSOUND *csound, FTMIPMAP *mip)
+{
+    MIPENTRY  *e = (MIPENTRY*) mip;
+
+    if (e == NULL || --e->refs > 0 || !e->retired)
+      return;
+    csound->Free(csound, e->data);
+    csound->Free(csound, e);
+}
+
+void ftmipmap_discard(CSOUND *csound, int fno)
+{
+    MIPMAPS   *mm = (MIPMAPS*) csound->ft_mipmaps;
+
+    if (mm != NULL && fno > 0 && fno < mm->size && mm->map[fno] != NULL)
+      mm->map[fno]->stale = 1;
+}
@@ -0,0 +1,368 @@
+/*
+    housekeep.c:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Background reclamation of idle instrument instances and deleted tables.
+
+   Inactive instances wait on the free chain of their instrument
+   (INSTRTXT.act_instance) to be reused by the next note. deact() stamps
+   them with the k-cycle at which they were released, and as the chain is
+   LIFO the stamps decrease along it. Once a second the performance thread
+   cuts each chain after the number of instances kept, at the first one
+   idle for longer than the housekeeping age, and passes the tail to a
+   low priority thread which frees the instances with their AUXCH and
+   variable memory. Deleted function tables go the same way, so that
+   neither path calls free() on the performance thread.
+   The thread keeps the default priority: it takes the memory lock and
+   the queue spin lock that the performance thread also needs, and must
+   not be kept from releasing them by other work.                        */
+
+#include "csoundCore.h"
+#include "housekeep.h"
+
+#define HK_TABLES   (256)
+
+typedef struct {
+    CSOUND      *csound;
+    void        *thread;
+    void        *lock;            /* wakes up the thread */
+    void        *mutex, *done;    /* signalled after each run */
+    spin_lock_t spin;             /* protects the queues and the stats */
+    INSDS       *instances;       /* pending, chained through nxtact */
+    FUNC        *tables[HK_TABLES];
+    int         ntables;
+    int         busy;
+    volatile int quit;
+    /* statistics */
+    uint64_t    allocated, peak, reclaimed, bytes, tables_reclaimed;
+} HOUSEKEEP;
+
+extern void free_instr_var_memory(CSOUND*, INSDS*);
+
+static HOUSEKEEP *housekeep_get(CSOUND *csound)
+{
+    HOUSEKEEP *hk = (HOUSEKEEP*) csound->housekeep;
+
+    if (hk == NULL) {
+      hk = (HOUSEKEEP*) csound->Calloc(csound, sizeof(HOUSEKEEP));
+      hk->csound = csound;
+      csoundSpinLockInit(&hk->spin);
+      csound->housekeep = (void*) hk;
+    }
+    return hk;
+}
+
+size_t csoundFreeInstance(CSOUND *csound, INSDS *ip)
+{
+    AUXCH   *auxchp;
+    size_t  bytes = 0;
+
+    for (auxchp = ip->auxchp; auxchp != NULL; auxchp = auxchp->nxtchp)
+      bytes += auxchp->size;
+    if (ip->opcod_iobufs != NULL && ip->instr->opcode_info != NULL)
+      csound->Free(csound, ip->opcod_iobufs);
+    if (ip->fdchp != NULL)
+      fdchclose(csound, ip);
+    if (ip->auxchp != NULL)
+      auxchfree(csound, ip);
+    free_instr_var_memory(csound, ip);
+    csound->Free(csound, ip);
+    if (csound->housekeep != NULL) {
+      HOUSEKEEP *hk = (HOUSEKEEP*) csound->housekeep;
+      csoundSpinLock(&hk->spin);
+      hk->allocated--;
+      hk->reclaimed++;
+      hk->bytes += bytes;
+      csoundSpinUnLock(&hk->spin);
+    }
+    return bytes;
+}
+
+static void free_table(CSOUND *csound, FUNC *ftp)
+{
+    if (ftp->ftable != NULL)
+      csound->Free(csound, ftp->ftable);
+    csound->Free(csound, ftp);
+}
+
+/* free everything queued so far */
+
+static void housekeep_run(CSOUND *csound, HOUSEKEEP *hk)
+{
+    FUNC    *tables[HK_TABLES];
+    INSDS   *ip;
+    int     i, ntables;
+
+    csoundSpinLock(&hk->spin);
+    ip = hk->instances;
+    hk->instances = NULL;
+    ntables = hk->ntables;
+    memcpy(tables, hk->tables, ntables * sizeof(FUNC*));
+    hk->ntables = 0;
+    hk->busy = 1;
+    csoundSpinUnLock(&hk->spin);
+
+    while (ip != NULL) {
+      INSDS *nxt = ip->nxtact;
+      csoundFreeInstance(csound, ip);
+      ip = nxt;
+    }
+    for (i = 0; i < ntables; i++)
+      free_table(csound, tables[i]);
+
+    csoundSpinLock(&hk->spin);
+    hk->tables_reclaimed += ntables;
+    hk->busy = 0;
+    csoundSpinUnLock(&hk->spin);
+    csoundLockMutex(hk->mutex);
+    csoundCondSignal(hk->done);
+    csoundUnlockMutex(hk->mutex);
+}
+
+static uintptr_t housekeep_thread(void *p)
+{
+    HOUSEKEEP *hk = (HOUSEKEEP*) p;
+
+    while (!ATOMIC_GET(hk->quit)) {
+      csoundWaitThreadLock(hk->lock, 1000);
+      housekeep_run(hk->csound, hk);
+    }
+    housekeep_run(hk->csound, hk);
+    return 0;
+}
+
+static int housekeep_stop(CSOUND *csound, void *p)
+{
+    HOUSEKEEP *hk = (HOUSEKEEP*) csound->housekeep;
+    (void) p;
+
+    if (hk == NULL || hk->thread == NULL)
+      return OK;
+    ATOMIC_SET(hk->quit, 1);
+    csoundNotifyThreadLock(hk->lock);
+    csoundJoinThread(hk->thread);
+    csoundDestroyThreadLock(hk->lock);
+    csoundDestroyCondVar(hk->done);
+    csoundDestroyMutex(hk->mutex);
+    hk->thread = hk->lock = hk->done = hk->mutex = NULL;
+    return OK;
+}
+
+void csoundHousekeepStart(CSOUND *csound)
+{
+    HOUSEKEEP *hk = housekeep_get(csound);
+
+    csound->housekeep_kcnt = (int) csound->ekr;
+    if (hk->thread != NULL)
+      return;
+#ifndef __EMSCRIPTEN__
+    hk->lock = csoundCreateThreadLock();
+    hk->mutex = csoundCreateMutex(0);
+    hk->done = csoundCreateCondVar();
+    if (UNLIKELY(hk->lock == NULL || hk->mutex == NULL || hk->done == NULL ||
+                 (hk->thread = csoundCreateThread(housekeep_thread,
+                                                  (void*) hk)) == NULL)) {
+      if (hk->lock != NULL)
+        csoundDestroyThreadLock(hk->lock);
+      if (hk->mutex != NULL)
+        csoundDestroyMutex(hk->mutex);
+      if (hk->done != NULL)
+        csoundDestroyCondVar(hk->done);
+      hk->lock = hk->mutex = hk->done = NULL;
+      csound->Warning(csound, Str("could not start housekeeping thread"));
+      return;
+    }
+    csoundRegisterResetCallback(csound, NULL, housekeep_stop);
+#endif
+}
+
+void csoundHousekeepAlloc(CSOUND *csound)
+{
+    HOUSEKEEP *hk = housekeep_get(csound);
+
+    csoundSpinLock(&hk->spin);
+    if (++hk->allocated > hk->peak)
+      hk->peak = hk->allocated;
+    csoundSpinUnLock(&hk->spin);
+}
+
+/* queue the list first..last */
+
+static void housekeep_push(HOUSEKEEP *hk, INSDS *first, INSDS *last)
+{
+    csoundSpinLock(&hk->spin);
+    last->nxtact = hk->instances;
+    hk->instances = first;
+    csoundSpinUnLock(&hk->spin);
+}
+
+void csoundHousekeepInstances(CSOUND *csound, INSDS *list)
+{
+    HOUSEKEEP *hk = (HOUSEKEEP*) csound->housekeep;
+    INSDS     *last;
+
+    if (list == NULL)
+      return;
+    if (hk == NULL || hk->thread == NULL) {
+      while (list != NULL) {
+        INSDS *nxt = list->nxtact;
+        csoundFreeInstance(csound, list);
+        list = nxt;
+      }
+      return;
+    }
+    for (last = list; last->nxtact != NULL; last = last->nxtact)
+      ;
+    housekeep_push(hk, list, last);
+    csoundNotifyThreadLock(hk->lock);
+}
+
+void csoundHousekeepTable(CSOUND *csound, FUNC *ftp)
+{
+    HOUSEKEEP *hk = (HOUSEKEEP*) csound->housekeep;
+
+    if (hk != NULL && hk->thread != NULL) {
+      int queued = 0;
+      csoundSpinLock(&hk->spin);
+      if (hk->ntables < HK_TABLES) {
+        hk->tables[hk->ntables++] = ftp;
+        queued = 1;
+      }
+      csoundSpinUnLock(&hk->spin);
+      if (queued) {
+        csoundNotifyThreadLock(hk->lock);
+        return;
+      }
+    }
+    free_table(csound, ftp);
+    if (hk != NULL) {
+      csoundSpinLock(&hk->spin);
+      hk->tables_reclaimed++;
+      csoundSpinUnLock(&hk->spin);
+    }
+}
+
+void csoundHousekeepSync(CSOUND *csound)
+{
+    HOUSEKEEP *hk = (HOUSEKEEP*) csound->housekeep;
+    int       pending;
+
+    if (hk == NULL || hk->thread == NULL)
+      return;
+    /* the thread signals under the mutex, so no run ends unseen between
+       the test and the wait                                             */
+    csoundLockMutex(hk->mutex);
+    for (;;) {
+      csoundSpinLock(&hk->spin);
+      pending = (hk->instances != NULL || hk->ntables || hk->busy);
+      csoundSpinUnLock(&hk->spin);
+      if (!pending)
+        break;
+      csoundNotifyThreadLock(hk->lock);
+      csoundCondWait(hk->done, hk->mutex);
+    }
+    csoundUnlockMutex(hk->mutex);
+}
+
+void csoundHousekeep(CSOUND *csound)
+{
+    HOUSEKEEP *hk = (HOUSEKEEP*) csound->housekeep;
+    INSTRTXT  *tp;
+    INSDS     *first = NULL, *last = NULL;
+    uint64_t  age, old;
+    int       realtime = csound->oparms->realtime;
+
+    csound->housekeep_kcnt = (int) csound->ekr;
+    if (hk == NULL || hk->thread == NULL || csound->housekeep_idle <= 0.0)
+      return;
+    age = (uint64_t) (csound->housekeep_idle * csound->ekr);
+    if (csound->kcounter <= age)
+      return;
+    old = csound->kcounter - age;
+    /* instances are inserted on another thread in realtime mode */
+    if (realtime &&
+        csoundSpinTryLock(&csound->alloc_spinlock) != CSOUND_SUCCESS)
+      return;
+    for (tp = csound->engineState.instxtanchor.nxtinstxt;
+         tp != NULL; tp = tp->nxtinstxt) {
+      INSDS *ip, **pp = &tp->act_instance;
+      int   n = (tp->nkeep > csound->housekeep_keep ?
+                 tp->nkeep : csound->housekeep_keep);
+      for ( ; (ip = *pp) != NULL; pp = &ip->nxtact) {
+        if (n > 0)
+          n--;
+        else if (ip->kcounter <= old)
+          break;
+      }
+      if (ip == NULL)
+        continue;
+      *pp = NULL;
+      /* unlink the tail from the list of allocated instances */
+      for ( ; ip != NULL; ip = ip->nxtact) {
+        if (ip->prvinstance != NULL)
+          ip->prvinstance->nxtinstance = ip->nxtinstance;
+        else
+          tp->instance = ip->nxtinstance;
+        if (ip->nxtinstance != NULL)
+          ip->nxtinstance->prvinstance = ip->prvinstance;
+        else
+          tp->lst_instance = ip->prvinstance;
+        if (first == NULL)
+          first = ip;
+        else
+          last->nxtact = ip;
+        last = ip;
+      }
+    }
+    if (realtime)
+      csoundSpinUnLock(&csound->alloc_spinlock);
+    if (first != NULL) {
+      last->nxtact = NULL;
+      housekeep_push(hk, first, last);
+      csoundNotifyThreadLock(hk->lock);
+    }
+}
+
+PUBLIC int csoundGetMemoryStats(CSOUND *csound, CS_MEMORY_STATS *stats)
+{
+    HOUSEKEEP *hk = (HOUSEKEEP*) csound->housekeep;
+
+    if (UNLIKELY(stats == NULL))
+      return CSOUND_ERROR;
+    memset(stats, 0, sizeof(CS_MEMORY_STATS));
+    if (hk == NULL)
+      return CSOUND_SUCCESS;
+    csoundSpinLock(&hk->spin);
+    stats->instances = hk->allocated;
+    stats->instances_peak = hk->peak;
+    stats->instances_reclaimed = hk->reclaimed;
+    stats->bytes_reclaimed = hk->bytes;
+    stats->tables_reclaimed = hk->tables_reclaimed;
+    csoundSpinUnLock(&hk->spin);
+    return CSOUND_SUCCESS;
+}
+
+PUBLIC void csoundSetHousekeeping(CSOUND *csound, double idle, int keep)
+{
+    csound->housekeep_idle = idle;
+    csound->housekeep_keep = (keep > 0 ? keep : 0);
+}
@@ -33,10 +33,12 @@
 #include "interlocks.h"
 #include "csound_type_system.h"
 #include "csound_standard_types.h"
+#include "housekeep.h"
 #include <inttypes.h>
 
 static  void    showallocs(CSOUND *);
 static  void    deact(CSOUND *, INSDS *);
+static  void    deact_batch(CSOUND *, INSDS *);
 static  void    schedofftim(CSOUND *, INSDS *);
 void    beatexpire(CSOUND *, double);
 void    timexpire(CSOUND *, double);
@@ -811,6 +813,11 @@ int insert_midi(CSOUND *csound, int insno, MCHNBLK *chn, MEVENT *mep)
     xturnoff_now(csound, ip);
     return csound->inerrcnt;
   }
+  /* sample-accurate start from the MIDI timestamp */
+  ip->ksmps_offset = (O->sampleAccurate && mep->ofs < (int32) ip->ksmps ?
+                      mep->ofs : 0);
+  ip->ksmps_no_end = 0;
+  ip->no_end = 0;
   ip->tieflag = ip->reinitflag = 0;
   csound->tieflag = csound->reinitflag = 0;
 
@@ -893,8 +900,69 @@ static void schedofftim(CSOUND *csound, INSDS *ip)
   }
 }
 
+/* Batched turnoff: lists of instances linked through nxtoff are sorted */
+/* and merged into the turnoff list, so that n notes entering their     */
+/* release stage at once cost O(n log n) instead of n list insertions.  */
+
+static INSDS *offlist_merge(INSDS *a, INSDS *b)
+{                               /* merge two sorted lists, a first on ties */
+  INSDS *head = NULL, **tail = &head;
+
+  while (a != NULL && b != NULL) {
+    if (b->offtim < a->offtim) {
+      *tail = b;
+      b = b->nxtoff;
+    }
+    else {
+      *tail = a;
+      a = a->nxtoff;
+    }
+    tail = &((*tail)->nxtoff);
+  }
+  *tail = (a != NULL ? a : b);
+  return head;
+}
+
+static INSDS *offlist_sort(INSDS *list)
+{                               /* stable merge sort by turnoff time */
+  INSDS *slow, *fast, *b;
+
+  if (list == NULL || list->nxtoff == NULL)
+    return list;
+  slow = list;
+  fast = list->nxtoff;
+  while (fast != NULL && fast->nxtoff != NULL) {
+    slow = slow->nxtoff;
+    fast = fast->nxtoff->nxtoff;
+  }
+  b = slow->nxtoff;
+  slow->nxtoff = NULL;
+  return offlist_merge(offlist_sort(list), offlist_sort(b));
+}
+
+static void offlist_add(CSOUND *csound, INSDS *list)
+{                               /* schedofftim() for a list of instances */
+  INSDS *frst = csound->frstoff;
+
+  if (list == NULL)
+    return;
+  csound->frstoff = offlist_merge(frst, offlist_sort(list));
+  if (csound->frstoff == frst)
+    return;
+  /* as schedofftim(): check if the new first note needs to be turned off */
+  if (csound->oparms_.Beatmode) {
+    double  tval = csound->curBeat + (0.505 * csound->curBeat_inc);
+    if (csound->frstoff->offbet <= tval) beatexpire(csound, tval);
+  }
+  else {
+    double  tval = (csound->icurTime + (0.505 * csound->ksmps))/csound->esr;
+    if (csound->frstoff->offtim <= tval) timexpire(csound, tval);
+  }
+}
+
 /* csound.c */
 extern  int     csoundDeinitialiseOpcodes(CSOUND *csound, INSDS *ip);
+extern  int     csoundDeinitialiseOpcodesBatch(CSOUND *csound, INSDS *list);
 int     useropcd(CSOUND *, UOPCODE*);
 
 static void deact(CSOUND *csound, INSDS *ip)
@@ -944,9 +1012,62 @@ static void deact(CSOUND *csound, INSDS *ip)
   }
   if (ip->fdchp != NULL)
     fdchclose(csound, ip);
+  ip->kcounter = csound->kcounter;      /* idle since, for housekeeping */
   csound->dag_changed++;
 }
 
+static INSDS *insno_sort(INSDS *list)
+{                               /* stable merge sort by instrument */
+  INSDS *slow, *fast, *a, *b, *head = NULL, **tail = &head;
+
+  if (list == NULL || list->nxtoff == NULL)
+    return list;
+  slow = list;
+  fast = list->nxtoff;
+  while (fast != NULL && fast->nxtoff != NULL) {
+    slow = slow->nxtoff;
+    fast = fast->nxtoff->nxtoff;
+  }
+  b = slow->nxtoff;
+  slow->nxtoff = NULL;
+  a = insno_sort(list);
+  b = insno_sort(b);
+  while (a != NULL && b != NULL) {
+    if (b->insno < a->insno) {
+      *tail = b;
+      b = b->nxtoff;
+    }
+    else {
+      *tail = a;
+      a = a->nxtoff;
+    }
+    tail = &((*tail)->nxtoff);
+  }
+  *tail = (a != NULL ? a : b);
+  return head;
+}
+
+/* deactivate a list of instances linked through nxtoff: the instances  */
+/* are grouped by instrument, so that the deinit callbacks of each      */
+/* opcode of an instrument run together for all of its instances, and  */
+/* then unlinked and returned to their free chains in one pass          */
+
+static void deact_batch(CSOUND *csound, INSDS *list)
+{
+  INSDS *ip, *nxt;
+
+  if (list == NULL)
+    return;
+  if (list->nxtoff != NULL) {
+    list = insno_sort(list);
+    csoundDeinitialiseOpcodesBatch(csound, list);
+  }
+  for (ip = list; ip != NULL; ip = nxt) {
+    nxt = ip->nxtoff;
+    deact(csound, ip);
+  }
+}
+
 
 int kill_instance(CSOUND *csound, KILLOP *p) {
   if (LIKELY(*p->inst)) xturnoff(csound, (INSDS *) ((uintptr_t)*p->inst));
@@ -957,14 +1078,10 @@ int kill_instance(CSOUND *csound, KILLOP *p) {
 /* Turn off a particular insalloc, also remove from list of active */
 /* MIDI notes. Allows for releasing if ip->xtratim > 0. */
 
-void xturnoff(CSOUND *csound, INSDS *ip)  /* turnoff a particular insalloc  */
-{                                         /* called by inexclus on ctrl 111 */
-  MCHNBLK *chn;
-
-  if (UNLIKELY(ip->relesing))
-    return;                             /* already releasing: nothing to do */
+static void xturnoff_midi(INSDS *ip)    /* remove from active MIDI notes */
+{
+  MCHNBLK *chn = ip->m_chnbp;
 
-  chn = ip->m_chnbp;
   if (chn != NULL) {                    /* if this was a MIDI note */
     INSDS *prvip;
     prvip = chn->kinsptr[ip->m_pitch];  /*    remov from activ lst */
@@ -982,6 +1099,14 @@ void xturnoff(CSOUND *csound, INSDS *ip)  /* turnoff a particular insalloc  */
       }
     }
   }
+}
+
+void xturnoff(CSOUND *csound, INSDS *ip)  /* turnoff a particular insalloc  */
+{                                         /* called by inexclus on ctrl 111 */
+  if (UNLIKELY(ip->relesing))
+    return;                             /* already releasing: nothing to do */
+
+  xturnoff_midi(ip);
   /* remove from schedoff chain first if finite duration */
   if (csound->frstoff != NULL && ip->offtim >= 0.0) {
     INSDS *prvip;
@@ -1020,6 +1145,63 @@ void xturnoff_now(CSOUND *csound, INSDS *ip)
   xturnoff(csound, ip);
 }
 
+/* Turn off many instances at once (all notes off, turnoff2, end of     */
+/* performance): the instances are marked with xturnoff_mark(), then    */
+/* xturnoff_marked() takes all of them off the turnoff list in a single */
+/* pass, and releases or deactivates them as a batch. This replaces a   */
+/* search of the turnoff list and a deactivation per instance.          */
+
+#define ACT_TURNOFF     2       /* actflg of a marked instance */
+
+void xturnoff_mark(CSOUND *csound, INSDS *ip, int now)
+{
+  (void) csound;
+  if (now) {
+    ip->xtratim = 0;
+    ip->relesing = 0;
+  }
+  else if (UNLIKELY(ip->relesing))
+    return;                             /* already releasing: nothing to do */
+  xturnoff_midi(ip);
+  ip->actflg = ACT_TURNOFF;
+}
+
+void xturnoff_marked(CSOUND *csound, INSDS *ip)
+{                               /* ip: first marked instance in activ chain */
+  INSDS *nxt, **prvloc, *rel = NULL, **reltail = &rel;
+  INSDS *dead = NULL, **deadtail = &dead;
+
+  /* remove from schedoff chain */
+  prvloc = &(csound->frstoff);
+  while ((nxt = *prvloc) != NULL) {
+    if (nxt->actflg == ACT_TURNOFF)
+      *prvloc = nxt->nxtoff;
+    else
+      prvloc = &(nxt->nxtoff);
+  }
+  /* collect the instances to release, and those to deactivate now */
+  for ( ; ip != NULL; ip = ip->nxtact) {
+    if (ip->actflg != ACT_TURNOFF)
+      continue;
+    ip->actflg = 1;
+    if (ip->xtratim > 0) {
+      set_xtratim(csound, ip);
+      *reltail = ip;
+      reltail = &(ip->nxtoff);
+    }
+    else {
+      *deadtail = ip;
+      deadtail = &(ip->nxtoff);
+    }
+  }
+  *reltail = *deadtail = NULL;
+  offlist_add(csound, rel);
+  if (dead != NULL) {
+    deact_batch(csound, dead);
+    csound->dag_changed++;      /* Need to remake DAG */
+  }
+}
+
 extern void free_instrtxt(CSOUND *csound, INSTRTXT *instrtxt);
 
 
@@ -1041,7 +1223,7 @@ void free_instr_var_memory(CSOUND* csound, INSDS* ip) {
 void orcompact(CSOUND *csound)          /* free all inactive instr spaces */
 {
   INSTRTXT  *txtp;
-  INSDS     *ip, *nxtip, *prvip, **prvnxtloc;
+  INSDS     *ip, *nxtip, *prvip, **prvnxtloc, *freed = NULL;
   int       cnt = 0;
   for (txtp = &(csound->engineState.instxtanchor);
        txtp != NULL;  txtp = txtp->nxtinstxt) {
@@ -1052,17 +1234,11 @@ void orcompact(CSOUND *csound)          /* free all inactive instr spaces */
       do {
         if (!ip->actflg) {
           cnt++;
-          if (ip->opcod_iobufs && ip->insno > csound->engineState.maxinsno)
-            csound->Free(csound, ip->opcod_iobufs);   /* IV - Nov 10 2002 */
-          if (ip->fdchp != NULL)
-            fdchclose(csound, ip);
-          if (ip->auxchp != NULL)
-            auxchfree(csound, ip);
-          free_instr_var_memory(csound, ip);
           if ((nxtip = ip->nxtinstance) != NULL)
             nxtip->prvinstance = prvip;
           *prvnxtloc = nxtip;
-          csound->Free(csound, (char *)ip);
+          ip->nxtact = freed;                 /* freed by housekeeping */
+          freed = ip;
         }
         else {
           prvip = ip;
@@ -1083,6 +1259,7 @@ void orcompact(CSOUND *csound)          /* free all inactive instr spaces */
 
     txtp->act_instance = NULL;                /* no free instances */
   }
+  csoundHousekeepInstances(csound, freed);
   /* check current items in deadpool to see if they need deleting */
   {
     int i;
@@ -1735,80 +1912,60 @@ int nstrstr(CSOUND *csound, NSTRSTR *p)
     p->ans->size = strlen(ss);
     return OK;
 }
-
 /* unlink expired notes from activ chain */
 /*      and mark them inactive           */
 /*    close any files in each fdchain    */
 
-/* IV - Feb 05 2005: changed to double */
+/* the expired notes are taken off the turnoff list in one pass: those */
+/* with extra time enter their release stage and are merged back into  */
+/* the list as a batch, and the others are deactivated as a batch      */
 
-void beatexpire(CSOUND *csound, double beat)
+static void expire(CSOUND *csound, double t, int beats)
 {
-  INSDS  *ip;
- strt:
-  if ((ip = csound->frstoff) != NULL && ip->offbet <= beat) {
+  INSDS  *ip, *rel, **reltail, *dead, **deadtail;
+
+  while ((ip = csound->frstoff) != NULL &&
+         (beats ? ip->offbet : ip->offtim) <= t) {
+    rel = dead = NULL;
+    reltail = &rel;
+    deadtail = &dead;
     do {
       if (!ip->relesing && ip->xtratim) {
         /* IV - Nov 30 2002: */
         /*   allow extra time for finite length (p3 > 0) score notes */
         set_xtratim(csound, ip);      /* enter release stage */
-        csound->frstoff = ip->nxtoff; /* update turnoff list */
-#ifdef BETA
-        if (UNLIKELY(csound->oparms->odebug))
-          csound->Message(csound, "Calling schedofftim line %d\n", __LINE__);
-#endif
-        schedofftim(csound, ip);
-        goto strt;                    /* and start again */
+        *reltail = ip;
+        reltail = &(ip->nxtoff);
       }
-      else
-        deact(csound, ip);    /* IV - Sep 5 2002: use deact() as it also */
-    }                         /* deactivates subinstrument instances */
-    while ((ip = ip->nxtoff) != NULL && ip->offbet <= beat);
-    csound->frstoff = ip;
+      else {                          /* IV - Sep 5 2002: use deact() as it */
+        *deadtail = ip;               /* also deactivates subinstrument     */
+        deadtail = &(ip->nxtoff);     /* instances                          */
+      }
+      ip = ip->nxtoff;
+    } while (ip != NULL && (beats ? ip->offbet : ip->offtim) <= t);
+    *reltail = *deadtail = NULL;
+    /* update turnoff list, notes with a release time of zero are */
+    /* turned off by the next iteration                            */
+    csound->frstoff = offlist_merge(ip, offlist_sort(rel));
+    deact_batch(csound, dead);
     if (UNLIKELY(csound->oparms->odebug)) {
-      csound->Message(csound, "deactivated all notes to beat %7.3f\n", beat);
+      csound->Message(csound, "deactivated all notes to %s %7.3f\n",
+                      (beats ? "beat" : "time"), t);
       csound->Message(csound, "frstoff = %p\n", (void*) csound->frstoff);
     }
   }
 }
 
-/* unlink expired notes from activ chain */
-/*      and mark them inactive           */
-/*    close any files in each fdchain    */
-
 /* IV - Feb 05 2005: changed to double */
 
-void timexpire(CSOUND *csound, double time)
+void beatexpire(CSOUND *csound, double beat)
 {
-  INSDS  *ip;
-
- strt:
-  if ((ip = csound->frstoff) != NULL && ip->offtim <= time) {
-    do {
-      if (!ip->relesing && ip->xtratim) {
-        /* IV - Nov 30 2002: */
-        /*   allow extra time for finite length (p3 > 0) score notes */
-        set_xtratim(csound, ip);      /* enter release stage */
-        csound->frstoff = ip->nxtoff; /* update turnoff list */
-#ifdef BETA
-        if (UNLIKELY(csound->oparms->odebug))
-          csound->Message(csound, "Calling schedofftim line %d\n", __LINE__);
-#endif
-        schedofftim(csound, ip);
+  expire(csound, beat, 1);
+}
 
-        goto strt;                    /* and start again */
-      }
-      else {
-        deact(csound, ip);    /* IV - Sep 5 2002: use deact() as it also */
-      }
-    }                         /* deactivates subinstrument instances */
-    while ((ip = ip->nxtoff) != NULL && ip->offtim <= time);
-    csound->frstoff = ip;
-    if (UNLIKELY(csound->oparms->odebug)) {
-      csound->Message(csound, "deactivated all notes to time %7.3f\n", time);
-      csound->Message(csound, "frstoff = %p\n", (void*) csound->frstoff);
-    }
-  }
+void timexpire(CSOUND *csound, double time)
+{
+  expire(csound, time, 0);
 }
 
 /**
@@ -2395,6 +2552,8 @@ static void instance(CSOUND *csound, int insno)
   ip->csound = csound;
   ip->m_chnbp = (MCHNBLK*) NULL;
   ip->instr = tp;
+  ip->kcounter = csound->kcounter;
+  csoundHousekeepAlloc(csound);
   /* IV - Oct 26 2002: replaced with faster version (no search) */
   ip->prvinstance = tp->lst_instance;
   if (tp->lst_instance)
@@ -2601,6 +2760,9 @@ int prealloc_(CSOUND *csound, AOP *p, int instname)
     if (csound->oparms->realtime)
       csoundSpinLock(&csound->alloc_spinlock);
     a = (int) *p->a - csound->engineState.instrtxtp[n]->active;
+    /* preallocated instances are kept by housekeeping */
+    if ((int) *p->a > csound->engineState.instrtxtp[n]->nkeep)
+      csound->engineState.instrtxtp[n]->nkeep = (int) *p->a;
     for ( ; a > 0; a--)
       instance(csound, n);
     if (csound->oparms->realtime)
@@ -2635,7 +2797,6 @@ int delete_instr(CSOUND *csound, DELETEIN *p)
   ip = csound->engineState.instrtxtp[n];
   active = ip->instance;
   while (active != NULL) {    /* Check there are no active instances */
-    INSDS   *nxt = active->nxtinstance;
     if (UNLIKELY(active->actflg)) { /* Can only remove non-active instruments */
       char *name = csound->engineState.instrtxtp[n]->insname;
       if (name)
@@ -2645,16 +2806,14 @@ int delete_instr(CSOUND *csound, DELETEIN *p)
         return csound->InitError(csound,
                                  Str("Instrument %d is still active"), n);
     }
-#if 0
-    if (active->opcod_iobufs && active->insno > csound->engineState.maxinsno)
-      csound->Free(csound, active->opcod_iobufs);        /* IV - Nov 10 2002 */
-#endif
-    if (active->fdchp != NULL)
-      fdchclose(csound, active);
-    if (active->auxchp != NULL)
-      auxchfree(csound, active);
-    free_instr_var_memory(csound, active);
-    csound->Free(csound, active);
+    active = active->nxtinstance;
+  }
+  /* instances queued for housekeeping refer to the definition */
+  csoundHousekeepSync(csound);
+  active = ip->instance;
+  while (active != NULL) {
+    INSDS   *nxt = active->nxtinstance;
+    csoundFreeInstance(csound, active);
     active = nxt;
   }
   csound->engineState.instrtxtp[n] = NULL;
@@ -2683,7 +2842,7 @@ void killInstance_enqueue(CSOUND *csound, MYFLT instr, int insno,
 
 void killInstance(CSOUND *csound, MYFLT instr, int insno, INSDS *ip,
                   int mode, int allow_release) {
-  INSDS *ip2 = NULL, *nip;
+  INSDS *ip2 = NULL, *nip, *first = NULL;
   do {                        /* This loop does not terminate in mode=0 */
     nip = ip->nxtact;
     if (((mode & 8) && ip->offtim >= 0.0) ||
@@ -2693,13 +2852,9 @@ void killInstance(CSOUND *csound, MYFLT instr, int insno, INSDS *ip,
       continue;
     }
     if (!(mode & 3)) {
-      if (allow_release) {
-        xturnoff(csound, ip);
-      }
-      else {
-        nip = ip->nxtact;
-        xturnoff_now(csound, ip);
-      }
+      if (first == NULL)
+        first = ip;
+      xturnoff_mark(csound, ip, !allow_release);
     }
     else {
       ip2 = ip;
@@ -2709,6 +2864,8 @@ void killInstance(CSOUND *csound, MYFLT instr, int insno, INSDS *ip,
     ip = nip;
   } while (ip != NULL && (int) ip->insno == insno);
 
+  if (first != NULL)
+    xturnoff_marked(csound, first);
   if (ip2 != NULL) {
     if (allow_release) {
       xturnoff(csound, ip2);
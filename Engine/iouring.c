@@ -0,0 +1,823 @@
+/*
+    iouring.c:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+
+/* io_uring engine for the sound file streams of
+   csoundFileOpenWithType_Async() on Linux.
+
+   A stream read is reopened with libsndfile virtual I/O over a read-ahead
+   cache of URING_CHUNKS chunks, chunk k of the file being held in slot
+   k % URING_CHUNKS. IORING_OP_READ requests fill the chunks following the
+   position of the decoder, sized from the rate at which the performance
+   thread consumes the stream. The ring thread only waits in
+   io_uring_enter() for completions and queues the reads, so that it never
+   blocks on anything but the ring.
+
+   Everything that goes through libsndfile runs on a second, stream
+   thread: it decodes as far as the cache allows straight into the
+   circular buffer of a stream, writes the streams written, and does the
+   seeks and closes, any of which may block on the file. The performance
+   thread wakes it when a buffer falls below half full or a block has been
+   queued for writing, and it wakes the ring thread, through an eventfd on
+   which the ring keeps a read queued, when the decoder has moved.
+
+   Seeks and closes are requests: the performance thread returns at once.
+   A seek of a stream written applies after the samples queued before it,
+   and the reader of a stream read drops what was buffered before the
+   seek, reading nothing in between. A closed stream is finished and
+   released by the stream thread, which owns its buffer and descriptor
+   from then on.
+
+   Without io_uring, csoundIoUringOpen() returns NULL and the caller uses
+   the file I/O thread of envvar.c.                                       */
+
+#include "csoundCore.h"
+#include "soundio.h"
+#include "iouring.h"
+
+#if defined(LINUX) && defined(HAVE_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#if defined(LINUX) && defined(HAVE_IO_URING) && \
+    defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+
+#define URING_ENTRIES   (64)
+#define URING_CHUNKS    (4)
+#define URING_MINCHUNK  (16384)
+#define URING_MAXCHUNK  (1048576)
+#define URING_AHEAD     (0.05)    /* seconds of the stream per chunk */
+#define URING_WAKE      (~((uint64_t) 0))
+#define URING_SEEKS     (16)      /* seek requests pending at most */
+
+#define LOAD_ACQ(x)     __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define STORE_REL(x, v) __atomic_store_n(&(x), v, __ATOMIC_RELEASE)
+
+enum { CHUNK_EMPTY = 0, CHUNK_BUSY, CHUNK_READY };
+
+typedef struct URING_ URING;
+
+typedef struct {
+    int         pos, whence;
+    unsigned int at;              /* items queued before it (written) */
+} URING_SEEK;
+
+typedef struct URING_FILE_ {
+    struct URING_FILE_ *nxt;
+    URING       *u;
+    SNDFILE     *sf;
+    int         fd, write, chans;
+    void        *cb;
+    int         size;             /* items decoded or written at a time */
+    /* read-ahead cache; the slots, inflight and vpos are changed under
+       lock, vpos only by the stream thread                             */
+    spin_lock_t lock;
+    char        *cache;
+    int         chunk;            /* bytes */
+    int64_t     key[URING_CHUNKS];
+    int         len[URING_CHUNKS], state[URING_CHUNKS];
+    int         inflight;
+    sf_count_t  flen, vpos;
+    double      bpi;              /* file bytes per sample, estimated */
+    /* stream thread */
+    int         started, eof, released;
+    /* shared with the performance thread */
+    unsigned int in, out;         /* items put into and taken from cb */
+    int         wake, closing;
+    URING_SEEK  seeks[URING_SEEKS];
+    int         seek_req, seek_done, seek_ack;
+} URING_FILE;
+
+struct URING_ {
+    CSOUND      *csound;
+    int         ok, ring, efd, armed;
+    void        *thread;          /* ring thread */
+    void        *worker, *wlock;  /* stream thread and its wake-up */
+    /* submission and completion rings */
+    void        *sqmap, *cqmap;
+    size_t      sqsize, cqsize;
+    struct io_uring_sqe *sqes;
+    unsigned int *sqhead, *sqtail, *sqmask, *sqarray, nsq;
+    unsigned int *cqhead, *cqtail, *cqmask, ncq;
+    struct io_uring_cqe *cqes;
+    unsigned int tosubmit, inflight;
+    uint64_t    event;
+    /* streams, linked and unlinked by the stream thread under spin */
+    URING_FILE  *files;
+    URING_FILE  *pending;         /* new streams, under spin */
+    spin_lock_t spin;
+    int         quit;
+};
+
+static void uring_signal(URING *u)
+{
+    uint64_t one = 1;
+    if (write(u->efd, &one, sizeof(uint64_t)) < 0)
+      return;
+}
+
+/* performance thread: make the stream thread look at a stream */
+
+static void uring_wake(URING_FILE *f, int force)
+{
+    if (force || !ATOMIC_GET(f->wake)) {
+      ATOMIC_SET(f->wake, 1);
+      csoundNotifyThreadLock(f->u->wlock);
+    }
+}
+
+/* ring thread: queue requests */
+
+static struct io_uring_sqe *uring_sqe(URING *u)
+{
+    unsigned int tail = *u->sqtail, i;
+    struct io_uring_sqe *sqe;
+
+    if (tail - LOAD_ACQ(*u->sqhead) >= u->nsq || u->inflight >= u->ncq)
+      return NULL;
+    i = tail & *u->sqmask;
+    sqe = &u->sqes[i];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    u->sqarray[i] = i;
+    return sqe;
+}
+
+static void uring_queue(URING *u, struct io_uring_sqe *sqe, int fd,
+                        void *addr, unsigned int len, uint64_t off,
+                        uint64_t data)
+{
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) (uintptr_t) addr;
+    sqe->len = len;
+    sqe->off = off;
+    sqe->user_data = data;
+    STORE_REL(*u->sqtail, *u->sqtail + 1);
+    u->tosubmit++;
+    u->inflight++;
+}
+
+static void uring_arm(URING *u)
+{
+    struct io_uring_sqe *sqe = uring_sqe(u);
+    if (sqe != NULL) {
+      uring_queue(u, sqe, u->efd, &u->event, sizeof(uint64_t), 0,
+                  URING_WAKE);
+      u->armed = 1;
+    }
+}
+
+/* ring thread: queue the reads of the chunks following the decoder */
+
+static void uring_readahead(URING *u, URING_FILE *f)
+{
+    int64_t k, k0;
+    struct io_uring_sqe *sqe;
+    int     s;
+
+    csoundSpinLock(&f->lock);
+    k0 = f->vpos / f->chunk;
+    for (k = k0; k < k0 + URING_CHUNKS; k++) {
+      if (k * f->chunk >= f->flen)
+        break;
+      s = (int) (k % URING_CHUNKS);
+      if (f->state[s] == CHUNK_BUSY ||
+          (f->key[s] == k && f->state[s] == CHUNK_READY))
+        continue;
+      if ((sqe = uring_sqe(u)) == NULL)
+        break;
+      f->key[s] = k;
+      f->state[s] = CHUNK_BUSY;
+      f->inflight++;
+      uring_queue(u, sqe, f->fd, f->cache + (size_t) s * f->chunk,
+                  (unsigned int) f->chunk, (uint64_t) (k * f->chunk),
+                  (uint64_t) (uintptr_t) f | (uint64_t) s);
+    }
+    csoundSpinUnLock(&f->lock);
+}
+
+/* stream thread: is the file read ahead for the next items samples? */
+
+static int uring_cached(URING_FILE *f, int items)
+{
+    sf_count_t end = f->vpos + (sf_count_t) (items * f->bpi) + 1;
+    int64_t    k, k0 = f->vpos / f->chunk;
+    int        ok = 1;
+
+    if (end > f->flen)
+      end = f->flen;
+    if ((end - 1) / f->chunk - k0 >= URING_CHUNKS)
+      return 1;                 /* more than the cache: read it directly */
+    csoundSpinLock(&f->lock);
+    for (k = k0; k * f->chunk < end; k++) {
+      int s = (int) (k % URING_CHUNKS);
+      if (f->key[s] != k || f->state[s] != CHUNK_READY) {
+        ok = 0;
+        break;
+      }
+    }
+    csoundSpinUnLock(&f->lock);
+    return ok;
+}
+
+/* virtual I/O of streams read, on the stream thread */
+
+static sf_count_t uring_vio_filelen(void *user)
+{
+    return ((URING_FILE*) user)->flen;
+}
+
+static sf_count_t uring_vio_seek(sf_count_t offset, int whence, void *user)
+{
+    URING_FILE *f = (URING_FILE*) user;
+    sf_count_t pos = f->vpos;
+
+    switch (whence) {
+    case SEEK_SET:
+      pos = offset;
+      break;
+    case SEEK_CUR:
+      pos += offset;
+      break;
+    case SEEK_END:
+      pos = f->flen + offset;
+      break;
+    }
+    csoundSpinLock(&f->lock);
+    f->vpos = pos;
+    csoundSpinUnLock(&f->lock);
+    return pos;
+}
+
+static sf_count_t uring_vio_read(void *ptr, sf_count_t count, void *user)
+{
+    URING_FILE *f = (URING_FILE*) user;
+    char       *dst = (char*) ptr;
+    sf_count_t done = 0, n;
+
+    csoundSpinLock(&f->lock);
+    while (done < count) {
+      int64_t k = f->vpos / f->chunk;
+      int     s = (int) (k % URING_CHUNKS);
+      int     o = (int) (f->vpos - k * f->chunk);
+      if (f->key[s] != k || f->state[s] != CHUNK_READY || o >= f->len[s])
+        break;
+      n = f->len[s] - o;
+      if (n > count - done)
+        n = count - done;
+      memcpy(dst + done, f->cache + (size_t) s * f->chunk + o, (size_t) n);
+      done += n;
+      f->vpos += n;
+    }
+    csoundSpinUnLock(&f->lock);
+    if (done < count) {         /* not read ahead: read it now */
+      n = (sf_count_t) pread(f->fd, dst + done, (size_t) (count - done),
+                             (off_t) f->vpos);
+      if (n > 0) {
+        done += n;
+        csoundSpinLock(&f->lock);
+        f->vpos += n;
+        csoundSpinUnLock(&f->lock);
+      }
+    }
+    return done;
+}
+
+static sf_count_t uring_vio_write(const void *ptr, sf_count_t count,
+                                  void *user)
+{
+    IGN(ptr); IGN(count); IGN(user);
+    return 0;
+}
+
+static sf_count_t uring_vio_tell(void *user)
+{
+    return ((URING_FILE*) user)->vpos;
+}
+
+static SF_VIRTUAL_IO uring_vio = {
+    uring_vio_filelen, uring_vio_seek, uring_vio_read, uring_vio_write,
+    uring_vio_tell
+};
+
+/* stream thread: decode into the circular buffer; returns non-zero if
+   the decoder has moved                                              */
+
+static int uring_decode(CSOUND *csound, URING_FILE *f)
+{
+    CS_CIRCULAR_REGION r;
+    int n, m, m0, got, moved = 0;
+
+    while (!f->eof) {
+      n = csound->WriteCircularBufferReserve(csound, f->cb, f->size, &r);
+      m = n - n % f->chans;
+      if (m == 0 || !uring_cached(f, m))
+        break;
+      m0 = (r.items[0] < m ? r.items[0] : m);
+      got = (int) sf_read_MYFLT(f->sf, (MYFLT*) r.data[0], m0);
+      if (got == m0 && m > m0)
+        got += (int) sf_read_MYFLT(f->sf, (MYFLT*) r.data[1], m - m0);
+      csound->WriteCircularBufferCommit(csound, f->cb, got);
+      ATOMIC_SET(f->in, f->in + got);
+      moved = 1;
+      if (got < m)
+        f->eof = 1;
+    }
+    return moved;
+}
+
+/* stream thread: write what has been queued, up to item count end */
+
+static void uring_drain(CSOUND *csound, URING_FILE *f, unsigned int end)
+{
+    CS_CIRCULAR_REGION r;
+    int n, m, m0;
+
+    while (end != f->out) {
+      n = (int) (end - f->out);
+      if ((n = csound->ReadCircularBufferReserve(csound, f->cb,
+                                                 n < f->size ? n : f->size,
+                                                 &r)) <= 0)
+        break;
+      /* whole frames only */
+      if ((m = n - n % f->chans) == 0)
+        break;
+      m0 = (r.items[0] < m ? r.items[0] : m);
+      sf_write_MYFLT(f->sf, (MYFLT*) r.data[0], m0);
+      if (m > m0)
+        sf_write_MYFLT(f->sf, (MYFLT*) r.data[1], m - m0);
+      csound->ReadCircularBufferCommit(csound, f->cb, m);
+      ATOMIC_SET(f->out, f->out + m);
+    }
+}
+
+/* stream thread: serve a stream; returns 1 once it is closed */
+
+static int uring_serve(URING *u, URING_FILE *f)
+{
+    CSOUND *csound = u->csound;
+    int    done, moved = 0;
+
+    if (ATOMIC_GET(f->wake)) {
+      ATOMIC_SET(f->wake, 0);
+      f->started = 1;
+    }
+    /* seeks, in the order they were asked for */
+    while ((done = f->seek_done) != ATOMIC_GET(f->seek_req)) {
+      URING_SEEK *s = &f->seeks[done % URING_SEEKS];
+      if (f->write)
+        uring_drain(csound, f, s->at);
+      sf_seek(f->sf, (sf_count_t) s->pos, s->whence);
+      f->eof = 0;
+      moved = 1;
+      ATOMIC_SET(f->seek_done, done + 1);
+    }
+    if (ATOMIC_GET(f->closing)) {
+      if (!f->released) {
+        if (f->write)
+          uring_drain(csound, f, ATOMIC_GET(f->in));
+        if (UNLIKELY(sf_close(f->sf) != 0))
+          csound->Warning(csound, Str("error closing a sound file stream"));
+        csound->DestroyCircularBuffer(csound, f->cb);
+        f->released = 1;
+      }
+      return 1;
+    }
+    if (f->write)
+      uring_drain(csound, f, ATOMIC_GET(f->in));
+    /* after a seek, wait for the reader to drop the old samples */
+    else if (f->started && ATOMIC_GET(f->seek_ack) == f->seek_done)
+      moved |= uring_decode(csound, f);
+    if (moved && !f->write)
+      uring_signal(u);          /* read ahead of the decoder */
+    return 0;
+}
+
+static void uring_release(CSOUND *csound, URING_FILE *f)
+{
+    close(f->fd);
+    if (f->cache != NULL)
+      csound->Free(csound, f->cache);
+    csound->Free(csound, f);
+}
+
+static uintptr_t uring_worker(void *arg)
+{
+    URING  *u = (URING*) arg;
+    URING_FILE *f, **pf;
+    int    quit, idle, added;
+
+    while (1) {
+      csoundWaitThreadLock(u->wlock, 100);
+      /* new streams, read ahead from now on */
+      csoundSpinLock(&u->spin);
+      added = (u->pending != NULL);
+      while ((f = u->pending) != NULL) {
+        u->pending = f->nxt;
+        f->nxt = u->files;
+        u->files = f;
+      }
+      csoundSpinUnLock(&u->spin);
+      if (added)
+        uring_signal(u);
+      /* serve them, freeing those closed once their reads are done;
+         the ring thread queues reads under spin, and none once closing */
+      for (pf = &u->files; (f = *pf) != NULL; ) {
+        if (uring_serve(u, f)) {
+          csoundSpinLock(&u->spin);
+          csoundSpinLock(&f->lock);
+          idle = (f->inflight == 0);
+          csoundSpinUnLock(&f->lock);
+          if (idle)
+            *pf = f->nxt;
+          csoundSpinUnLock(&u->spin);
+          if (idle) {
+            uring_release(u->csound, f);
+            continue;
+          }
+        }
+        pf = &f->nxt;
+      }
+      csoundSpinLock(&u->spin);
+      quit = (ATOMIC_GET(u->quit) && u->files == NULL && u->pending == NULL);
+      csoundSpinUnLock(&u->spin);
+      if (quit)
+        break;
+    }
+    return (uintptr_t) 0;
+}
+
+static uintptr_t uring_thread(void *arg)
+{
+    URING  *u = (URING*) arg;
+    URING_FILE *f;
+
+    while (1) {
+      unsigned int head = *u->cqhead, tail;
+      int ret, wait, quit, got = 0;
+
+      if (!u->armed)
+        uring_arm(u);
+      wait = (LOAD_ACQ(*u->cqtail) == head);
+      ret = (int) syscall(__NR_io_uring_enter, u->ring, u->tosubmit,
+                          wait ? 1 : 0, wait ? IORING_ENTER_GETEVENTS : 0,
+                          NULL, 0);
+      if (ret < 0 && errno != EINTR)
+        csoundSleep(1);         /* out of resources: try again */
+      if (ret > 0)
+        u->tosubmit -= ret;
+      /* completions */
+      tail = LOAD_ACQ(*u->cqtail);
+      for ( ; head != tail; head++) {
+        struct io_uring_cqe *cqe = &u->cqes[head & *u->cqmask];
+        u->inflight--;
+        if (cqe->user_data == URING_WAKE)
+          u->armed = 0;
+        else {
+          int s = (int) (cqe->user_data & 7);
+          f = (URING_FILE*) (uintptr_t) (cqe->user_data & ~((uint64_t) 7));
+          csoundSpinLock(&f->lock);
+          f->inflight--;
+          f->state[s] = (cqe->res >= 0 ? CHUNK_READY : CHUNK_EMPTY);
+          f->len[s] = (cqe->res >= 0 ? cqe->res : 0);
+          csoundSpinUnLock(&f->lock);
+          got = 1;
+        }
+      }
+      STORE_REL(*u->cqhead, head);
+      if (got)
+        csoundNotifyThreadLock(u->wlock);
+      /* read ahead of the decoders */
+      csoundSpinLock(&u->spin);
+      for (f = u->files; f != NULL; f = f->nxt)
+        if (!f->write && !ATOMIC_GET(f->closing))
+          uring_readahead(u, f);
+      quit = (ATOMIC_GET(u->quit) && u->files == NULL && u->pending == NULL);
+      csoundSpinUnLock(&u->spin);
+      if (quit)
+        break;
+    }
+    return (uintptr_t) 0;
+}
+
+static int uring_setup(URING *u)
+{
+    struct io_uring_params par;
+    unsigned char *sq, *cq;
+
+    memset(&par, 0, sizeof(struct io_uring_params));
+    u->ring = (int) syscall(__NR_io_uring_setup, URING_ENTRIES, &par);
+    if (u->ring < 0)
+      return -1;
+    /* IORING_OP_READ needs 5.6, which also brought this */
+    if (!(par.features & IORING_FEAT_RW_CUR_POS))
+      return -1;
+    u->sqsize = par.sq_off.array + par.sq_entries * sizeof(unsigned int);
+    u->cqsize = par.cq_off.cqes + par.cq_entries * sizeof(struct io_uring_cqe);
+    if (par.features & IORING_FEAT_SINGLE_MMAP) {
+      if (u->cqsize > u->sqsize)
+        u->sqsize = u->cqsize;
+      u->cqsize = 0;
+    }
+    u->sqmap = mmap(NULL, u->sqsize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, u->ring, IORING_OFF_SQ_RING);
+    if (u->sqmap == MAP_FAILED) {
+      u->sqmap = NULL;
+      return -1;
+    }
+    if (u->cqsize) {
+      u->cqmap = mmap(NULL, u->cqsize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, u->ring, IORING_OFF_CQ_RING);
+      if (u->cqmap == MAP_FAILED) {
+        u->cqmap = NULL;
+        return -1;
+      }
+    }
+    u->sqes = (struct io_uring_sqe*)
+      mmap(NULL, par.sq_entries * sizeof(struct io_uring_sqe),
+           PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->ring,
+           IORING_OFF_SQES);
+    if (u->sqes == MAP_FAILED) {
+      u->sqes = NULL;
+      return -1;
+    }
+    sq = (unsigned char*) u->sqmap;
+    cq = (unsigned char*) (u->cqmap != NULL ? u->cqmap : u->sqmap);
+    u->sqhead = (unsigned int*) (sq + par.sq_off.head);
+    u->sqtail = (unsigned int*) (sq + par.sq_off.tail);
+    u->sqmask = (unsigned int*) (sq + par.sq_off.ring_mask);
+    u->sqarray = (unsigned int*) (sq + par.sq_off.array);
+    u->nsq = par.sq_entries;
+    u->cqhead = (unsigned int*) (cq + par.cq_off.head);
+    u->cqtail = (unsigned int*) (cq + par.cq_off.tail);
+    u->cqmask = (unsigned int*) (cq + par.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe*) (cq + par.cq_off.cqes);
+    u->ncq = par.cq_entries;
+    if ((u->efd = eventfd(0, EFD_CLOEXEC)) < 0)
+      return -1;
+    return 0;
+}
+
+static void uring_free(CSOUND *csound, URING *u)
+{
+    if (u->sqes != NULL)
+      munmap(u->sqes, u->nsq * sizeof(struct io_uring_sqe));
+    if (u->cqmap != NULL)
+      munmap(u->cqmap, u->cqsize);
+    if (u->sqmap != NULL)
+      munmap(u->sqmap, u->sqsize);
+    if (u->efd >= 0)
+      close(u->efd);
+    if (u->ring >= 0)
+      close(u->ring);
+    if (u->wlock != NULL)
+      csoundDestroyThreadLock(u->wlock);
+    csound->Free(csound, u);
+}
+
+static URING *uring_get(CSOUND *csound)
+{
+    URING *u = (URING*) csound->file_uring;
+
+    if (u == NULL) {
+      u = (URING*) csound->Calloc(csound, sizeof(URING));
+      u->csound = csound;
+      u->ring = u->efd = -1;
+      csoundSpinLockInit(&u->spin);
+      csound->file_uring = (void*) u;
+      if (uring_setup(u) == 0 &&
+          (u->wlock = csoundCreateThreadLock()) != NULL &&
+          (u->worker = csound->CreateThread(uring_worker, (void*) u)) != NULL) {
+        if ((u->thread = csound->CreateThread(uring_thread, (void*) u)) != NULL)
+          u->ok = 1;
+        else {
+          ATOMIC_SET(u->quit, 1);
+          csoundNotifyThreadLock(u->wlock);
+          csound->JoinThread(u->worker);
+        }
+      }
+      if (UNLIKELY(!u->ok && csound->oparms->odebug))
+        csound->Message(csound, Str("io_uring not available, "
+                                    "using the file I/O thread\n"));
+    }
+    return (u->ok ? u : NULL);
+}
+
+void *csoundIoUringOpen(CSOUND *csound, int fd, SNDFILE **sf,
+                        SF_INFO *sfinfo, int writing, void *cb, int bufsize)
+{
+    URING      *u;
+    URING_FILE *f;
+    SF_INFO    info;
+    struct stat st;
+    double     rate;
+    int        k;
+
+    if (fd < 0 || sfinfo->channels < 1 || bufsize % sfinfo->channels ||
+        (u = uring_get(csound)) == NULL)
+      return NULL;
+    f = (URING_FILE*) csound->Calloc(csound, sizeof(URING_FILE));
+    f->u = u;
+    f->fd = fd;
+    f->write = writing;
+    f->chans = sfinfo->channels;
+    f->cb = cb;
+    f->size = bufsize;
+    csoundSpinLockInit(&f->lock);
+    if (writing)
+      f->sf = *sf;
+    else {
+      if (fstat(fd, &st) != 0) {
+        csound->Free(csound, f);
+        return NULL;
+      }
+      f->flen = (sf_count_t) st.st_size;
+      f->bpi = (sfinfo->frames > 0 && sfinfo->frames < SF_COUNT_MAX ?
+                (double) f->flen / ((double) sfinfo->frames * f->chans) :
+                4.0);
+      /* a chunk for URING_AHEAD seconds at the orchestra rate, and for
+         at least two buffers */
+      rate = csound->esr * f->chans * f->bpi;
+      f->chunk = (int) (rate * URING_AHEAD);
+      if (f->chunk < (int) (2 * bufsize * f->bpi))
+        f->chunk = (int) (2 * bufsize * f->bpi);
+      f->chunk = (f->chunk + 4095) & ~4095;
+      f->chunk = (f->chunk < URING_MINCHUNK ? URING_MINCHUNK :
+                  (f->chunk > URING_MAXCHUNK ? URING_MAXCHUNK : f->chunk));
+      f->cache = (char*) csound->Malloc(csound,
+                                        (size_t) f->chunk * URING_CHUNKS);
+      for (k = 0; k < URING_CHUNKS; k++)
+        f->key[k] = -1;
+      /* reopen with reads going through the cache */
+      memcpy(&info, sfinfo, sizeof(SF_INFO));
+      if ((info.format & SF_FORMAT_TYPEMASK) != SF_FORMAT_RAW)
+        info.format = 0;
+      f->sf = sf_open_virtual(&uring_vio, SFM_READ, &info, (void*) f);
+      if (f->sf == NULL) {
+        csound->Free(csound, f->cache);
+        csound->Free(csound, f);
+        return NULL;
+      }
+      sf_command(f->sf, SFC_SET_VBR_ENCODING_QUALITY,
+                 &csound->oparms->quality, sizeof(double));
+      sf_close(*sf);
+      *sf = f->sf;
+    }
+    csoundSpinLock(&u->spin);
+    f->nxt = u->pending;
+    u->pending = f;
+    csoundSpinUnLock(&u->spin);
+    /* the read-ahead starts once the stream thread has taken it, decoding
+       once the stream is first read or seeked */
+    csoundNotifyThreadLock(u->wlock);
+    return (void*) f;
+}
+
+unsigned int csoundIoUringRead(CSOUND *csound, void *stream,
+                               MYFLT *buf, int items)
+{
+    URING_FILE *f = (URING_FILE*) stream;
+    int done = ATOMIC_GET(f->seek_done), n;
+
+    if (ATOMIC_GET(f->seek_req) != done)
+      return 0;
+    if (f->seek_ack != done) {
+      /* the engine has seeked and waits for the old samples to go */
+      csound->FlushCircularBuffer(csound, f->cb);
+      ATOMIC_SET(f->out, ATOMIC_GET(f->in));
+      ATOMIC_SET(f->seek_ack, done);
+      uring_wake(f, 1);
+      return 0;
+    }
+    n = csound->ReadCircularBuffer(csound, f->cb, buf, items);
+    ATOMIC_SET(f->out, f->out + n);
+    if ((int) (ATOMIC_GET(f->in) - f->out) < 2 * f->size)
+      uring_wake(f, 0);
+    return (unsigned int) n;
+}
+
+unsigned int csoundIoUringWrite(CSOUND *csound, void *stream,
+                                MYFLT *buf, int items)
+{
+    URING_FILE *f = (URING_FILE*) stream;
+    int n = csound->WriteCircularBuffer(csound, f->cb, buf, items);
+
+    ATOMIC_SET(f->in, f->in + n);
+    if ((int) (f->in - ATOMIC_GET(f->out)) >= f->size)
+      uring_wake(f, 0);
+    return (unsigned int) n;
+}
+
+int csoundIoUringSeek(CSOUND *csound, void *stream, int pos, int whence)
+{
+    URING_FILE *f = (URING_FILE*) stream;
+    int        req = f->seek_req;
+    URING_SEEK *s = &f->seeks[req % URING_SEEKS];
+
+    IGN(csound);
+    if (UNLIKELY(req - ATOMIC_GET(f->seek_done) >= URING_SEEKS))
+      return -1;
+    s->pos = pos;
+    s->whence = whence;
+    s->at = f->in;
+    ATOMIC_SET(f->seek_req, req + 1);
+    uring_wake(f, 1);
+    return (whence == SEEK_SET ? pos : 0);
+}
+
+int csoundIoUringClose(CSOUND *csound, void *stream)
+{
+    URING_FILE *f = (URING_FILE*) stream;
+
+    IGN(csound);
+    ATOMIC_SET(f->closing, 1);
+    uring_wake(f, 1);
+    return 0;
+}
+
+void csoundIoUringStop(CSOUND *csound)
+{
+    URING *u = (URING*) csound->file_uring;
+
+    if (u == NULL)
+      return;
+    if (u->ok) {
+      /* the stream thread finishes the streams closed */
+      ATOMIC_SET(u->quit, 1);
+      csoundNotifyThreadLock(u->wlock);
+      csound->JoinThread(u->worker);
+      uring_signal(u);
+      csound->JoinThread(u->thread);
+    }
+    uring_free(csound, u);
+    csound->file_uring = NULL;
+}
+
+#else
+
+void *csoundIoUringOpen(CSOUND *csound, int fd, SNDFILE **sf,
+                        SF_INFO *sfinfo, int writing, void *cb, int bufsize)
+{
+    IGN(csound); IGN(fd); IGN(sf); IGN(sfinfo);
+    IGN(writing); IGN(cb); IGN(bufsize);
+    return NULL;
+}
+
+unsigned int csoundIoUringRead(CSOUND *csound, void *stream,
+                               MYFLT *buf, int items)
+{
+    IGN(csound); IGN(stream); IGN(buf); IGN(items);
+    return 0;
+}
+
+unsigned int csoundIoUringWrite(CSOUND *csound, void *stream,
+                                MYFLT *buf, int items)
+{
+    IGN(csound); IGN(stream); IGN(buf); IGN(items);
+    return 0;
+}
+
+int csoundIoUringSeek(CSOUND *csound, void *stream, int pos, int whence)
+{
+    IGN(csound); IGN(stream); IGN(pos); IGN(whence);
+    return 0;
+}
+
+int csoundIoUringClose(CSOUND *csound, void *stream)
+{
+    IGN(csound); IGN(stream);
+    return 0;
+}
+
+void csoundIoUringStop(CSOUND *csound)
+{
+    IGN(csound);
+}
+
+#endif
@@ -60,6 +60,91 @@ static void memdie(CSOUND *csound, size_t nbytes)
     csound->LongJmp(csound, CSOUND_MEMORY);
 }
 
+#ifdef CS_MMAPBLOCK
+#include <sys/mman.h>
+
+/* Private file mappings handed out by mmapblock(), found by address in
+   mfree() and mrealloc(): they have no header in front of their data. */
+
+typedef struct memMapBlock_s {
+    void                    *ptr;       /* data pointer handed out      */
+    void                    *map;       /* start of the mapping         */
+    size_t                  length;     /* length of the mapping        */
+    struct memMapBlock_s    *nxt;       /* next block in hash chain     */
+} memMapBlock_t;
+
+#define MEMMAP_SLOTS    256
+#define MEMMAP_HASH(p)  \
+    ((((uintptr_t) (p) >> 12) ^ ((uintptr_t) (p) >> 20)) & (MEMMAP_SLOTS - 1))
+
+#define MEMMAP_DB   ((memMapBlock_t**) csound->memalloc_maps)
+
+/* find the mapping of p; returns its link in the hash chain, or NULL */
+static memMapBlock_t **mapfind(CSOUND *csound, void *p)
+{
+    memMapBlock_t **pp = &(MEMMAP_DB[MEMMAP_HASH(p)]);
+
+    while (*pp != NULL && (*pp)->ptr != p)
+      pp = &((*pp)->nxt);
+    return (*pp != NULL ? pp : NULL);
+}
+
+/* unmap p if it is a mapped block; returns its data size, 0 if not */
+static size_t mapfree(CSOUND *csound, void *p, void *copy, size_t size)
+{
+    memMapBlock_t **pp, *mp = NULL;
+    size_t        n;
+
+    CSOUND_MEM_SPINLOCK
+    if ((pp = mapfind(csound, p)) != NULL) {
+      mp = *pp;
+      *pp = mp->nxt;
+    }
+    CSOUND_MEM_SPINUNLOCK
+    if (mp == NULL)
+      return 0;
+    n = mp->length - (size_t) ((char*) p - (char*) mp->map);
+    if (copy != NULL)
+      memcpy(copy, p, (n < size ? n : size));
+    munmap(mp->map, mp->length);
+    free(mp);
+    return n;
+}
+
+/* Hand out bytes from offset to the end of a private, writable mapping
+   of length bytes at map, as if allocated: csound->Free() unmaps it,
+   csound->ReAlloc() moves the data to allocated memory.              */
+
+void *mmapblock(CSOUND *csound, void *map, size_t length, size_t offset)
+{
+    memMapBlock_t *mp;
+    void          *p = (void*) ((char*) map + offset);
+
+    if (UNLIKELY((mp = (memMapBlock_t*) malloc(sizeof(memMapBlock_t)))
+                 == NULL)) {
+      munmap(map, length);
+      memdie(csound, sizeof(memMapBlock_t));
+    }
+    mp->ptr = p;
+    mp->map = map;
+    mp->length = length;
+    CSOUND_MEM_SPINLOCK
+    if (MEMMAP_DB == NULL &&
+        (csound->memalloc_maps =
+           calloc(MEMMAP_SLOTS, sizeof(memMapBlock_t*))) == NULL) {
+      CSOUND_MEM_SPINUNLOCK
+      free(mp);
+      munmap(map, length);
+      memdie(csound, MEMMAP_SLOTS * sizeof(memMapBlock_t*));
+    }
+    mp->nxt = MEMMAP_DB[MEMMAP_HASH(p)];
+    MEMMAP_DB[MEMMAP_HASH(p)] = mp;
+    CSOUND_MEM_SPINUNLOCK
+    return p;
+}
+#endif
+
+
 void *mmalloc(CSOUND *csound, size_t size)
 {
     void  *p;
@@ -143,6 +228,11 @@ void mfree(CSOUND *csound, void *p)
 
     if (UNLIKELY(p == NULL))
       return;
+#ifdef CS_MMAPBLOCK
+    if (UNLIKELY(csound->memalloc_maps != NULL) &&
+        mapfree(csound, p, NULL, 0) > 0)
+      return;
+#endif
     pp = HDR_PTR(p);
  #ifdef MEMDEBUG
     if (UNLIKELY(pp->magic != MEMALLOC_MAGIC || pp->ptr != p)) {
@@ -191,6 +281,19 @@ void *mrealloc(CSOUND *csound, void *oldp, size_t size)
       mfree(csound, oldp);
       return NULL;
     }
+#ifdef CS_MMAPBLOCK
+    if (UNLIKELY(csound->memalloc_maps != NULL)) {
+      int mapped;
+      CSOUND_MEM_SPINLOCK
+      mapped = (mapfind(csound, oldp) != NULL);
+      CSOUND_MEM_SPINUNLOCK
+      if (mapped) {                     /* copy to allocated memory */
+        p = mmalloc(csound, size);
+        mapfree(csound, oldp, p, size);
+        return p;
+      }
+    }
+#endif
     pp = HDR_PTR(oldp);
 #ifdef MEMDEBUG
     if (UNLIKELY(pp->magic != MEMALLOC_MAGIC || pp->ptr != oldp)) {
@@ -259,4 +362,19 @@ void memRESET(CSOUND *csound)
       free((void*) pp);
       pp = nxtp;
     }
+#ifdef CS_MMAPBLOCK
+    if (MEMMAP_DB != NULL) {
+      memMapBlock_t *mp, *nxtmp;
+      int           i;
+      for (i = 0; i < MEMMAP_SLOTS; i++) {
+        for (mp = MEMMAP_DB[i]; mp != NULL; mp = nxtmp) {
+          nxtmp = mp->nxt;
+          munmap(mp->map, mp->length);
+          free(mp);
+        }
+      }
+      free(csound->memalloc_maps);
+      csound->memalloc_maps = NULL;
+    }
+#endif
 }
@@ -30,6 +30,8 @@
 #include "remote.h"
 #include <math.h>
 #include "corfile.h"
+#include "housekeep.h"
+#include "fgens.h"
 
 #include "csdebug.h"
 
@@ -405,6 +407,7 @@ int musmon(CSOUND *csound)
                       csound->alloc_queue, csound->event_insert_thread );
     }
 #endif
+    csoundHousekeepStart(csound);
 
     /* since we are running in components, we exit here to playevents later */
     return 0;
@@ -414,15 +417,11 @@ static void deactivate_all_notes(CSOUND *csound)
 {
     INSDS *ip = csound->actanchor.nxtact;
 
-    while (ip != NULL) {
-      INSDS *nxt = ip->nxtact;
-#ifdef BETA
-      csound->Message(csound, "deativate: ip, nxt = %p , %p\n", ip, nxt);
-#endif
-      xturnoff_now(csound, ip);
-      // should not be needed -- if (ip == nxt) break;
-      ip = nxt;
-    }
+    if (ip == NULL)
+      return;
+    for ( ; ip != NULL; ip = ip->nxtact)
+      xturnoff_mark(csound, ip, 1);
+    xturnoff_marked(csound, csound->actanchor.nxtact);
 }
 
 static void delete_pending_rt_events(CSOUND *csound)
@@ -756,6 +755,9 @@ static int process_score_event(CSOUND *csound, EVTBLK *evt, int rtEvt)
 
   saved_currevent = csound->currevent;
   csound->currevent = evt;
+  /* f-statements generated in parallel are listed before anything else */
+  if (UNLIKELY(csound->fgens_async != NULL) && (evt->opcod != 'f' || rtEvt))
+    csoundFTGenSync(csound);
   switch (evt->opcod) {                       /* scorevt or Linevt:     */
   case 'e':           /* quit realtime */
     csound->event_insert_loop = 0;
@@ -868,7 +870,10 @@ static int process_score_event(CSOUND *csound, EVTBLK *evt, int rtEvt)
   case 'f':                   /* f event: */
     {
       FUNC  *dummyftp;
-      csound->hfgens(csound, &dummyftp, evt, 0); /* construct locally */
+      if (!rtEvt)                 /* with others due now, in parallel */
+        csoundFTGenScore(csound, evt);
+      else
+        csound->hfgens(csound, &dummyftp, evt, 0); /* construct locally */
       if (getRemoteInsRfdCount(csound))
         insGlobevt(csound, evt); /* RM: & optionally send to all remotes      */
     }
@@ -1142,6 +1147,8 @@ int sensevents(CSOUND *csound)
       }
     }
   }
+  if (UNLIKELY(csound->fgens_async != NULL))
+    csoundFTGenSync(csound);      /* tables of this k-cycle are complete */
 
   /* handle any real time events now: */
   /* FIXME: the initialisation pass of real time */
@@ -1222,6 +1229,8 @@ int sensevents(CSOUND *csound)
  scode:
   /* end of section (retval == 1), score (retval == 2), */
   /* or lplay list (retval == 3) */
+  if (UNLIKELY(csound->fgens_async != NULL))
+    csoundFTGenSync(csound);
   if (getRemoteInsRfdCount(csound))
     insGlobevt(csound, e);/* RM: send s,e, or l to any remotes */
   e->opcod = '\0';
@@ -214,6 +214,7 @@ TREE *csoundParseOrc(CSOUND *csound, const char *str)
       TREE* newRoot;
       PARSE_PARM  pp;
       TYPE_TABLE* typeTable = NULL;
+      uint64_t    cacheKey;
 
       /* Parse */
       memset(&pp, '\0', sizeof(PARSE_PARM));
@@ -224,12 +225,23 @@ TREE *csoundParseOrc(CSOUND *csound, const char *str)
 
 
       csound_orcset_extra(&pp, pp.yyscanner);
-      csound_orc_scan_buffer(corfile_body(csound->expanded_orc),
-                             corfile_tell(csound->expanded_orc), pp.yyscanner);
-
-      //csound_orcset_lineno(csound->orcLineOffset, pp.yyscanner);
-      //printf("%p\n", astTree);
-      err = csound_orcparse(&pp, pp.yyscanner, csound, &astTree);
+      if (csound_orc_cache_load(csound, csound->expanded_orc,
+                                &cacheKey, &astTree)) {
+        err = 0;
+      }
+      else {
+        csound_orc_scan_buffer(corfile_body(csound->expanded_orc),
+                               corfile_tell(csound->expanded_orc),
+                               pp.yyscanner);
+
+        //csound_orcset_lineno(csound->orcLineOffset, pp.yyscanner);
+        //printf("%p\n", astTree);
+        err = csound_orcparse(&pp, pp.yyscanner, csound, &astTree);
+        /* store before verify_tree() rewrites the tree */
+        if (cacheKey != 0 && err == 0 && csound->synterrcnt == 0 &&
+            astTree != NULL)
+          csound_orc_cache_store(csound, cacheKey, astTree);
+      }
       //printf("%p\n", astTree);
       //print_tree(csound, "AST - AFTER csound_orcparse()\n", astTree);
       //csp_orc_sa_cleanup(csound);
@@ -0,0 +1,353 @@
+/*
+    opcode_table.c:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Built-in opcode table.
+ *
+ * The entries of opcodlst_1[] (Engine/entry1.c) are indexed once per
+ * process with a minimal perfect hash (hash and displace) and the resulting
+ * overload lists are shared read-only by every CSOUND instance.  Each
+ * instance keeps its own csound->opcodes hash table, which only holds
+ * opcodes appended at runtime (static modules, plugins and UDOs).  When an
+ * opcode is appended under a name that also exists in the built-in table,
+ * the built-in overloads are copied into the instance table first, so a
+ * name is always resolved by one list: the instance one if present,
+ * otherwise the shared one.
+ */
+
+#include "csoundCore.h"
+#include "csound_data_structures.h"
+
+extern OENTRY opcodlst_1[];
+
+typedef struct {
+    char      *name;            /* short name (up to the first '.') */
+    CONS_CELL *entries;         /* overloads, in opcodlst_1[] order */
+} STATIC_OPCODE_SLOT;
+
+static STATIC_OPCODE_SLOT *static_slots = NULL;
+static int32_t  *static_displace = NULL;
+static CONS_CELL *static_cells = NULL;
+static int      static_nnames = 0;
+static int      static_nentries = 0;
+
+/* FNV-1a, with the displacement value used as the offset basis */
+static inline uint32_t opcode_name_hash(uint32_t d, const char *s, size_t len)
+{
+    uint32_t h = (d == 0 ? 0x811c9dc5U : d);
+    while (len--) {
+      h ^= (uint8_t) *s++;
+      h *= 16777619U;
+    }
+    return h;
+}
+
+static size_t short_name_length(const char *opname)
+{
+    return strcspn(opname, ".");
+}
+
+static int same_short_name(const char *a, const char *b)
+{
+    size_t la = short_name_length(a);
+    return (la == short_name_length(b) && strncmp(a, b, la) == 0);
+}
+
+static const char **sort_names;
+
+static int cmp_entry_index(const void *a, const void *b)
+{
+    int ia = *(const int*) a, ib = *(const int*) b;
+    size_t la = short_name_length(sort_names[ia]);
+    size_t lb = short_name_length(sort_names[ib]);
+    int    c = strncmp(sort_names[ia], sort_names[ib], la < lb ? la : lb);
+    if (c == 0 && la != lb)
+      c = (la < lb ? -1 : 1);
+    /* keep table order within an overload list */
+    return (c != 0 ? c : ia - ib);
+}
+
+static int cmp_bucket_size(const void *a, const void *b)
+{
+    const int *ba = *(const int* const*) a, *bb = *(const int* const*) b;
+    return bb[0] - ba[0];
+}
+
+static void free_static_opcode_table(void)
+{
+    int i;
+    if (static_slots != NULL) {
+      for (i = 0; i < static_nnames; i++)
+        free(static_slots[i].name);
+    }
+    free(static_slots);
+    free(static_displace);
+    free(static_cells);
+    static_slots = NULL;
+    static_displace = NULL;
+    static_cells = NULL;
+    static_nnames = static_nentries = 0;
+}
+
+/**
+ * Builds the shared table of built-in opcodes. Called once per process from
+ * csoundInitialize(); returns zero on success.
+ */
+int init_static_opcode_table(void)
+{
+    const char **names = NULL;
+    int     *order = NULL, *first = NULL, **buckets = NULL, *bucket_mem = NULL;
+    int     *group = NULL;
+    char    *taken = NULL;
+    int     i, j, n, nnames = 0, retval = -1;
+
+    if (static_slots != NULL)
+      return 0;
+
+    for (n = 0; opcodlst_1[n].opname != NULL; n++);
+    names = (const char**) malloc(sizeof(char*) * (n + 1));
+    order = (int*) malloc(sizeof(int) * (n + 1));
+    first = (int*) malloc(sizeof(int) * (n + 1));
+    static_cells = (CONS_CELL*) calloc(n + 1, sizeof(CONS_CELL));
+    if (UNLIKELY(names == NULL || order == NULL || first == NULL ||
+                 static_cells == NULL))
+      goto done;
+    for (i = 0; i < n; i++) {
+      names[i] = opcodlst_1[i].opname;
+      order[i] = i;
+    }
+    sort_names = names;
+    qsort(order, n, sizeof(int), cmp_entry_index);
+
+    /* group overloads: first[] holds the position of each unique name */
+    for (i = 0, nnames = 0; i < n; i++) {
+      int k = order[i];
+      static_cells[k].value = &opcodlst_1[k];
+      static_cells[k].next = NULL;
+      if (i > 0 && same_short_name(names[order[i-1]], names[k]))
+        static_cells[order[i-1]].next = &static_cells[k];
+      else
+        first[nnames++] = i;
+    }
+    first[nnames] = n;
+
+    static_slots = (STATIC_OPCODE_SLOT*) calloc(nnames + 1,
+                                                sizeof(STATIC_OPCODE_SLOT));
+    static_displace = (int32_t*) calloc(nnames + 1, sizeof(int32_t));
+    buckets = (int**) calloc(nnames + 1, sizeof(int*));
+    /* per bucket: [count, name indices...]; sizes sum to 2 * nnames */
+    bucket_mem = (int*) calloc(2 * nnames + 1, sizeof(int));
+    taken = (char*) calloc(nnames + 1, 1);
+    group = (int*) calloc(nnames + 1, sizeof(int));
+    if (UNLIKELY(static_slots == NULL || static_displace == NULL ||
+                 buckets == NULL || bucket_mem == NULL || taken == NULL ||
+                 group == NULL))
+      goto done;
+
+    /* first level hash: distribute the names over nnames buckets */
+    {
+      int *counts = static_displace, *p = bucket_mem;
+      for (i = 0; i < nnames; i++) {
+        const char *s = names[order[first[i]]];
+        counts[opcode_name_hash(0, s, short_name_length(s)) % nnames]++;
+      }
+      for (i = 0; i < nnames; i++) {
+        buckets[i] = p;
+        p += counts[i] + 1;
+        counts[i] = 0;
+      }
+      for (i = 0; i < nnames; i++) {
+        const char *s = names[order[first[i]]];
+        int *b = buckets[opcode_name_hash(0, s, short_name_length(s)) % nnames];
+        b[++b[0]] = i;
+      }
+    }
+    qsort(buckets, nnames, sizeof(int*), cmp_bucket_size);
+
+    /* second level: find a displacement for every multi-name bucket */
+    for (i = 0; i < nnames && buckets[i][0] > 1; i++) {
+      int      *b = buckets[i], cnt = b[0], k;
+      const char *s = names[order[first[b[1]]]];
+      uint32_t d = 1, slot[64];
+      int      h = (int) (opcode_name_hash(0, s, short_name_length(s))
+                          % nnames);
+      if (UNLIKELY(cnt > 64))
+        goto done;
+      for (;;) {
+        for (k = 0; k < cnt; k++) {
+          int m;
+          s = names[order[first[b[k+1]]]];
+          slot[k] = opcode_name_hash(d, s, short_name_length(s)) % nnames;
+          if (taken[slot[k]])
+            break;
+          for (m = 0; m < k && slot[m] != slot[k]; m++);
+          if (m < k)
+            break;
+        }
+        if (k == cnt)
+          break;
+        d++;
+      }
+      for (k = 0; k < cnt; k++) {
+        taken[slot[k]] = 1;
+        group[slot[k]] = b[k+1];
+      }
+      static_displace[h] = (int32_t) d;
+    }
+    /* single-name buckets go straight into the remaining free slots */
+    for (j = 0; i < nnames && buckets[i][0] == 1; i++) {
+      int        *b = buckets[i];
+      const char *s = names[order[first[b[1]]]];
+      int        h = (int) (opcode_name_hash(0, s, short_name_length(s))
+                            % nnames);
+      while (taken[j]) j++;
+      taken[j] = 1;
+      group[j] = b[1];
+      static_displace[h] = -j - 1;
+    }
+
+    /* fill the slots with names and overload lists */
+    for (i = 0; i < nnames; i++) {
+      int        k = order[first[group[i]]];
+      size_t     len = short_name_length(names[k]);
+      static_slots[i].name = (char*) malloc(len + 1);
+      if (UNLIKELY(static_slots[i].name == NULL))
+        goto done;
+      memcpy(static_slots[i].name, names[k], len);
+      static_slots[i].name[len] = '\0';
+      static_slots[i].entries = &static_cells[k];
+    }
+    static_nnames = nnames;
+    static_nentries = n;
+    retval = 0;
+
+ done:
+    free(names);
+    free(order);
+    free(first);
+    free(buckets);
+    free(bucket_mem);
+    free(taken);
+    free(group);
+    if (retval != 0) {
+      static_nnames = nnames;
+      free_static_opcode_table();
+    }
+    return retval;
+}
+
+/**
+ * Returns the shared overload list of the built-in opcode 'shortName', or
+ * NULL if it is not a built-in.
+ */
+CONS_CELL *find_static_opcode_entries(const char *shortName)
+{
+    size_t  len;
+    int32_t d;
+    int     slot;
+
+    if (UNLIKELY(static_nnames == 0 || shortName == NULL))
+      return NULL;
+    len = strlen(shortName);
+    d = static_displace[opcode_name_hash(0, shortName, len) % static_nnames];
+    if (d < 0)
+      slot = -d - 1;
+    else
+      slot = (int) (opcode_name_hash((uint32_t) d, shortName, len)
+                    % static_nnames);
+    if (strcmp(static_slots[slot].name, shortName) != 0)
+      return NULL;
+    return static_slots[slot].entries;
+}
+
+/**
+ * Returns non-zero if 'ep' points into the shared built-in table (and must
+ * therefore not be modified).
+ */
+int is_static_opcode_entry(const OENTRY *ep)
+{
+    return (ep >= &opcodlst_1[0] && ep < &opcodlst_1[static_nentries]);
+}
+
+/**
+ * Returns the overload list for 'shortName', looking at the instance table
+ * first and then at the built-in one.
+ */
+CONS_CELL *find_opcode_entries(CSOUND *csound, char *shortName)
+{
+    CONS_CELL *head;
+
+    if (UNLIKELY(shortName == NULL))
+      return NULL;
+    if (csound->opcodes != NULL) {
+      head = cs_hash_table_get(csound, csound->opcodes, shortName);
+      if (head != NULL)
+        return head;
+    }
+    return find_static_opcode_entries(shortName);
+}
+
+/**
+ * Copies the built-in overloads of 'shortName' (if any) into the instance
+ * table, so that they can be extended or modified. Returns the instance
+ * list for the name, which may be NULL.
+ */
+CONS_CELL *materialise_opcode_entries(CSOUND *csound, char *shortName)
+{
+    CONS_CELL *head, *items, *list = NULL;
+    OENTRY    *entryCopy;
+
+    head = cs_hash_table_get(csound, csound->opcodes, shortName);
+    if (head != NULL)
+      return head;
+    items = find_static_opcode_entries(shortName);
+    if (items == NULL)
+      return NULL;
+    for ( ; items != NULL; items = items->next) {
+      entryCopy = csound->Malloc(csound, sizeof(OENTRY));
+      memcpy(entryCopy, items->value, sizeof(OENTRY));
+      entryCopy->useropinfo = NULL;
+      list = cs_cons_append(list, cs_cons(csound, entryCopy, NULL));
+    }
+    cs_hash_table_put(csound, csound->opcodes, shortName, list);
+    return list;
+}
+
+/**
+ * Returns a cons list of all overload lists visible to this instance, in
+ * the same form as cs_hash_table_values(). Free with cs_cons_free().
+ */
+CONS_CELL *opcode_table_values(CSOUND *csound)
+{
+    CONS_CELL *head = NULL;
+    int       i;
+
+    if (csound->opcodes != NULL)
+      head = cs_hash_table_values(csound, csound->opcodes);
+    for (i = 0; i < static_nnames; i++) {
+      if (csound->opcodes == NULL ||
+          cs_hash_table_get(csound, csound->opcodes,
+                            static_slots[i].name) == NULL)
+        head = cs_cons(csound, static_slots[i].entries, head);
+    }
+    return head;
+}
@@ -87,7 +87,7 @@ void init_symbtab(CSOUND *csound)
      * T_OPCODE0, or T_OPCODE00)
      */
 
-    top = head = cs_hash_table_values(csound, csound->opcodes);
+    top = head = opcode_table_values(csound);
 
     while (head != NULL) {
       items = head->value;
@@ -107,7 +107,7 @@ void init_symbtab(CSOUND *csound)
       }
       head = head->next;
     }
-    csound->Free(csound, top);
+    cs_cons_free(csound, top);
     }
 }
 
@@ -502,7 +502,7 @@ OENTRY* csound_find_internal_oentry(CSOUND* csound, OENTRY* oentry) {
     }
     shortName = get_opcode_short_name(csound, oentry->opname);
 
-    items = cs_hash_table_get(csound, csound->opcodes, shortName);
+    items = find_opcode_entries(csound, shortName);
 
     while (items != NULL) {
         ep = items->value;
@@ -526,6 +526,86 @@ OENTRY* csound_find_internal_oentry(CSOUND* csound, OENTRY* oentry) {
 }
 
 
+/* the entry a UDO with this header would redefine, if any; the optional
+   local ksmps argument is part of the signature */
+static OENTRY *find_udo_entry(CSOUND *csound, char *opname,
+                              char *outtypes, char *intypes)
+{
+    OENTRY *opc;
+    int    len = strlen(intypes);
+
+    if (len == 1 && *intypes == '0') {
+      opc = find_opcode_exact(csound, opname, outtypes, "o");
+    } else {
+      char* adjusted_intypes = csound->Malloc(csound, sizeof(char) * (len + 2));
+      sprintf(adjusted_intypes, "%so", intypes);
+      opc = find_opcode_exact(csound, opname, outtypes, adjusted_intypes);
+      csound->Free(csound, adjusted_intypes);
+    }
+    return opc;
+}
+
+/* opcodes that a UDO cannot redefine */
+static int is_reserved_opcode(char *opname)
+{
+    return (!strcmp(opname, "instr") ||
+            !strcmp(opname, "endin") ||
+            !strcmp(opname, "opcode") ||
+            !strcmp(opname, "endop") ||
+            !strcmp(opname, "$label") ||
+            !strcmp(opname, "pset") ||
+            !strcmp(opname, "xin") ||
+            !strcmp(opname, "xout") ||
+            !strcmp(opname, "subinstr"));
+}
+
+/* checks UDO argument types the way parse_opcode_args() reads them,
+   without reporting anything; returns zero if they are all known */
+static int check_udo_arg_types(CSOUND *csound, char *types, int input)
+{
+    char typeSpecifier[2];
+
+    typeSpecifier[1] = '\0';
+    if (*types == '0')
+      return 0;
+    while (*types != '\0') {
+      if (types[1] == '[') {
+        typeSpecifier[0] = *types++;
+        while (*types == '[') {
+          if (UNLIKELY(types[1] != ']'))
+            return -1;
+          types += 2;
+        }
+      } else {
+        typeSpecifier[0] = (input ? map_udo_in_arg_type(*types) :
+                            map_udo_out_arg_type(*types));
+        types++;
+      }
+      if (UNLIKELY(csoundGetTypeWithVarTypeName(csound->typePool,
+                                                typeSpecifier) == NULL))
+        return -1;
+    }
+    return 0;
+}
+
+/** Checks, without reporting errors or changing any state, that
+ * add_udo_definition() would accept a UDO header.  Returns zero if it
+ * would, or the error code add_udo_definition() would return.
+ */
+int check_udo_definition(CSOUND *csound, char *opname,
+        char *outtypes, char *intypes) {
+
+    if (UNLIKELY(!check_instr_name(opname)))
+      return -1;
+    if (UNLIKELY(is_reserved_opcode(opname) &&
+                 find_udo_entry(csound, opname, outtypes, intypes) != NULL))
+      return -2;
+    if (UNLIKELY(check_udo_arg_types(csound, intypes, 1) != 0 ||
+                 check_udo_arg_types(csound, outtypes, 0) != 0))
+      return -3;
+    return 0;
+}
+
 /** Adds a UDO definition as an T_OPCODE or T_OPCODE0 type to the symbol table
  * used at parse time.  An OENTRY is also added at this time so that at
  * verification time the opcode can be looked up to get its signature.
@@ -535,35 +615,18 @@ int add_udo_definition(CSOUND *csound, char *opname,
 
     OENTRY    tmpEntry, *opc, *newopc;
     OPCODINFO *inm;
-    int len;
 
     if (UNLIKELY(!check_instr_name(opname))) {
       synterr(csound, Str("invalid name for opcode"));
       return -1;
     }
 
-    len = strlen(intypes);
-    if (len == 1 && *intypes == '0') {
-      opc = find_opcode_exact(csound, opname, outtypes, "o");
-    } else {
-      char* adjusted_intypes = csound->Malloc(csound, sizeof(char) * (len + 2));
-      sprintf(adjusted_intypes, "%so", intypes);
-      opc = find_opcode_exact(csound, opname, outtypes, adjusted_intypes);
-      csound->Free(csound, adjusted_intypes);
-    }
+    opc = find_udo_entry(csound, opname, outtypes, intypes);
 
     /* check if opcode is already defined */
     if (UNLIKELY(opc != NULL)) {
       /* IV - Oct 31 2002: redefine old opcode if possible */
-      if (UNLIKELY(!strcmp(opname, "instr") ||
-                   !strcmp(opname, "endin") ||
-                   !strcmp(opname, "opcode") ||
-                   !strcmp(opname, "endop") ||
-                   !strcmp(opname, "$label") ||
-                   !strcmp(opname, "pset") ||
-                   !strcmp(opname, "xin") ||
-                   !strcmp(opname, "xout") ||
-                   !strcmp(opname, "subinstr"))) {
+      if (UNLIKELY(is_reserved_opcode(opname))) {
         synterr(csound, Str("cannot redefine %s"), opname);
         return -2;
       }
@@ -585,6 +648,13 @@ int add_udo_definition(CSOUND *csound, char *opname,
     if (opc != NULL) {
       /* printf("**** Redefining case: %s %s %s\n", */
       /*        inm->name, inm->outtypes, inm->intypes); */
+      if (is_static_opcode_entry(opc)) {
+        /* shared built-in entries are read-only: redefine a local copy */
+        char *shortName = get_opcode_short_name(csound, opc->opname);
+        materialise_opcode_entries(csound, shortName);
+        if (shortName != opc->opname) csound->Free(csound, shortName);
+        opc = csound_find_internal_oentry(csound, opc);
+      }
       opc->useropinfo = inm;
       newopc = opc;
     } else {
@@ -64,4 +64,18 @@ typedef struct RtJackGlobals_ {
     int     xrunFlag;                   /* non-zero if an xrun has occured  */
     jack_client_t   *listclient;
     int outDevNum, inDevNum;            /* select devs by number */
+    int     callbackMode;               /* non-zero: engine runs in the     */
+                                        /* process callback (no ring)       */
+    int     cbState;                    /* -1: off, 0: waiting for the      */
+                                        /* Csound thread, 1: running,       */
+                                        /* 2: performance finished          */
+    int     cbResult;                   /* return value of the last period  */
+    int     cbFrames;                   /* frames in the current period     */
+    int     cbInPos;                    /* input position in the period     */
+    int     cbOutPos;                   /* output position in the period    */
+#ifdef LINUX
+    pthread_mutex_t cbLock;             /* signaled at end of performance   */
+#else
+    void    *cbLock;                    /* signaled at end of performance   */
+#endif
 } RtJackGlobals;
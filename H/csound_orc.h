@@ -68,6 +68,10 @@ ORCTOKEN *make_token(CSOUND *csound, char *s);
 extern int ksmps, nchnls; */
 
 void query_deprecated_opcode(CSOUND *, ORCTOKEN *);
+
+/* persistent parse cache (csound_orc_cache.c) */
+int  csound_orc_cache_load(CSOUND *, CORFIL *, uint64_t *, TREE **);
+void csound_orc_cache_store(CSOUND *, uint64_t, TREE *);
 int  query_reversewrite_opcode(CSOUND *, ORCTOKEN *);
 
     // holds matching oentries from opcodeList
@@ -0,0 +1,133 @@
+/*
+    delayline.h:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_DELAYLINE_H
+#define CSOUND_DELAYLINE_H
+
+#if !defined(__BUILDING_LIBCSOUND)
+#  error "Csound plugins and host applications should not include delayline.h"
+#endif
+
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /**
+   * Delay line setup
+   *
+   * aux:      memory of the lines, owned by the calling opcode
+   * count:    number of lines, laid out one after the other
+   * len:      length of each line; delays are taken modulo len
+   * maxblock: longest block read or written at once, plus the longest
+   *           sinc window read (or written) with it
+   *
+   * The lines start silent, and are cleared when aux is reused.
+   * returns: the first line, or NULL on invalid arguments
+   */
+  CS_DELAYLINE *csoundDelayLineCreate(CSOUND *csound, AUXCH *aux, int count,
+                                      const int32 *len, int32 maxblock);
+
+  /**
+   * Append nsmps samples of in to the line
+   */
+  void csoundDelayLineWrite(CSOUND *csound, CS_DELAYLINE *line,
+                            const MYFLT *in, int32 nsmps);
+
+  /**
+   * Read ntaps taps for samples offset to nsmps - 1 of a block, sample n
+   * standing at position start + n of the line; a delay of 0 is the
+   * sample at that position.  Delays wrap as they would in a circular
+   * buffer of line->len samples: a sample not written yet is the one
+   * written len samples before it.
+   *
+   * interp: CS_DELAY_NONE, CS_DELAY_LINEAR, CS_DELAY_CUBIC or
+   *         CS_DELAY_SINC with a window of wsize points (4 to
+   *         CS_DELAY_MAXWIN, a multiple of 4); CS_DELAY_CUBICX and
+   *         CS_DELAY_SINC compute positions in double precision
+   */
+  void csoundDelayLineRead(CSOUND *csound, CS_DELAYLINE *line,
+                           const CS_DELAYTAP *taps, int ntaps, int32 start,
+                           int32 offset, int32 nsmps, int interp, int wsize);
+
+  /**
+   * Delay d as csoundDelayLineRead() takes it, for a sample c - 1 samples
+   * after the first one not written yet (c = 0 for a sample written):
+   * in [c, c + len)
+   */
+  static inline double csoundDelayLineWrap(double d, int32 c, int32 len,
+                                           double rlen)
+  {
+      double  x = d - (double) c;
+
+      x -= (double) (int32) (x * rlen) * len;   /* in (-len, len) */
+      x += (double) ((x < 0.0) - (x >= len)) * len;
+      return x + (double) c;
+  }
+
+  /**
+   * Weight constant of the windowed sinc of wsize points
+   * (wsize = 4: 1 - 1/3, wsize = 64: 1 - 1/36)
+   */
+  static inline double csoundDelayLineD2x(int wsize)
+  {
+      int     i2 = wsize >> 1;
+
+      return (1.0 - pow((double) wsize * 0.85172, -0.89624))
+        / (double) (i2 * i2);
+  }
+
+  /**
+   * Add x to the line at position pos of the buffer (not wrapped), spread
+   * over the windowed sinc of wsize points, as vdelayxw and deltapxw
+   * write; d2x from csoundDelayLineD2x()
+   */
+  static inline void csoundDelayLineAddSinc(CS_DELAYLINE *line, double pos,
+                                            MYFLT x, int wsize, double d2x)
+  {
+      MYFLT   *buf = line->buf;
+      int32   mask = line->mask, i = (int32) pos, k, i2 = wsize >> 1;
+      double  x1, d, w, n1;
+
+      i -= (pos < i);
+      x1 = pos - i;
+      if (x1 * (1.0 - x1) > 0.00000001) {
+        n1 = (double) x * sin(PI * x1) / PI;
+        i += 1 - i2;
+        d = (double) (1 - i2) - x1;
+        for (k = 0; k < wsize; k++, d++) {
+          w = 1.0 - d * d * d2x;
+          w *= w / d;
+          buf[(i + k) & mask] += (MYFLT) (k & 1 ? -(n1 * w) : n1 * w);
+        }
+      }
+      else                                      /* integer sample */
+        buf[(i + (x1 > 0.5)) & mask] += x;
+  }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      /* CSOUND_DELAYLINE_H */
@@ -73,6 +73,10 @@ typedef struct {
     void    *cb;
     int     async;
   MYFLT     transpose;
+    void    *rs;                /* polyphase filter for sr conversion */
+    AUXCH   auxRs;              /* its coefficients */
+    int32   rsTaps;
+    int64_t rsInc;              /* pos_frac_inc at transpose 1 */
 } DISKIN2;
 
 typedef struct {
@@ -179,7 +179,7 @@ int32_t ko1set(CSOUND *, void *);
 int32_t kosc1(CSOUND *, void *), kosc1i(CSOUND *, void *);
 int32_t oscnset(CSOUND *, void *), osciln(CSOUND *, void *);
 int32_t oscset(CSOUND *, void *), koscil(CSOUND *, void *);
-int32_t oscsetA(CSOUND *, void *);
+int32_t oscsetA(CSOUND *, void *), oscset3(CSOUND *, void *);
 int32_t osckk(CSOUND *, void *), oscka(CSOUND *, void *);
 int32_t oscak(CSOUND *, void *), oscaa(CSOUND *, void *);
 int32_t koscli(CSOUND *, void *), osckki(CSOUND *, void *);
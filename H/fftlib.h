@@ -99,8 +99,7 @@ extern "C" {
    * buf:     array of FFTsize + 2 MYFLT values; output is in interleaved
    *          real/imaginary format (note: the real part of the Nyquist
    *          frequency is stored in buf[FFTsize], and not in buf[1]).
-   * FFTsize: FFT length in samples; not required to be an integer power of two,
-   *          but should be even and not have too many factors.
+   * FFTsize: FFT length in samples; not required to be an integer power of two.
    */
   void csoundRealFFTnp2(CSOUND *csound, MYFLT *buf, int FFTsize);
 
@@ -111,18 +110,24 @@ extern "C" {
    * buf:     array of FFTsize + 2 MYFLT values, in interleaved real/imaginary
    *          format (note: the real part of the Nyquist frequency is stored
    *          in buf[FFTsize], and not in buf[1]).
-   * FFTsize: FFT length in samples; not required to be an integer power of two,
-   *          but should be even and not have too many factors.
+   * FFTsize: FFT length in samples; not required to be an integer power of two.
    */
   void csoundInverseRealFFTnp2(CSOUND *csound, MYFLT *buf, int FFTsize);
 
+  /**
+   * Compute in-place complex FFT of FFTsize interleaved complex values,
+   * allowing non power of two sizes. The inverse is scaled by 1/FFTsize.
+   */
+  void csoundComplexFFTnp2(CSOUND *csound, MYFLT *buf, int FFTsize);
+  void csoundInverseComplexFFTnp2(CSOUND *csound, MYFLT *buf, int FFTsize);
+
 
    /**
    * New Real FFT interface
    * Creates a setup for a series of FFT operations.
    *
    * FFTsize: FFT length in samples; not required to be an integer power of two,
-   *          but should be even and not have too many factors.
+   *          but must be even. Other sizes use a cached mixed-radix plan.
    * d:       direction (FFT_FWD or FFT_INV). Scaling by 1/FFTsize is done on
    *          the inverse direction (as with the other RealFFT functions above).
    *
@@ -134,13 +139,46 @@ extern "C" {
    * New Real FFT interface
    * Compute in-place real FFT.
    *
-   * buf:     array of FFTsize + 2 MYFLT values, in interleaved real/imaginary
+   * buf:     array of FFTsize MYFLT values, in interleaved real/imaginary
    *          format (note: the real part of the Nyquist frequency is stored
-   *          in buf[FFTsize], and not in buf[1]).
+   *          in buf[1], as with csoundRealFFT()).
    * setup:   an FFT setup created with csoundRealFFT2Setup()
    */
   void csoundRealFFT2(CSOUND *csound, void *setup, MYFLT *sig);
 
+  /**
+   * Planned mixed-radix FFT (OOps/mxfft.c), used by the functions above for
+   * sizes that are not powers of two.
+   */
+  typedef struct CS_FFT_PLAN_ CS_FFT_PLAN;
+
+  /**
+   * Returns the cached plan for complex transforms of length n, or for real
+   * transforms of length N.
+   */
+  CS_FFT_PLAN *csoundGetFFTPlan(CSOUND *csound, int32_t n);
+  CS_FFT_PLAN *csoundGetRealFFTPlan(CSOUND *csound, int32_t N);
+
+  /**
+   * Size, in MYFLT values, of the work buffer needed by a plan.
+   */
+  int32_t csoundFFTPlanWorkSize(const CS_FFT_PLAN *plan);
+
+  /**
+   * In-place complex FFT of plan->n interleaved values. The inverse is
+   * scaled by 1/n.
+   */
+  void csoundFFTPlanComplex(const CS_FFT_PLAN *plan, MYFLT *buf, MYFLT *work,
+                            int32_t inverse);
+
+  /**
+   * In-place real FFT of N values. With packed == 0, buf holds N + 2 values
+   * laid out as in csoundRealFFTnp2(); otherwise N must be even and the
+   * layout is that of csoundRealFFT(). The inverse is scaled by 1/N.
+   */
+  void csoundFFTPlanReal(const CS_FFT_PLAN *plan, MYFLT *buf, MYFLT *work,
+                         int32_t N, int32_t inverse, int32_t packed);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,5 +48,67 @@ int csoundFTAlloc(CSOUND *csound, int tableNum, int len);
  */
 int csoundFTDelete(CSOUND *csound, int tableNum);
 
+/**
+ * Generate a function table in the background: as hfgens(), but the GEN
+ * routine runs on a worker thread, and the table is added to the list by
+ * the performance thread at the start of the k-cycle after it is done.
+ * Deletions (negative table numbers) are done at once.
+ * Returns the table number, zero if none was needed, or -1 on error.
+ */
+int csoundFTGenAsync(CSOUND *csound, const EVTBLK *evtblkp, int mode);
+
+/**
+ * Returns 1 if table fno is available, 0 while it is being generated
+ * in the background, and -1 if it does not exist.
+ */
+int csoundFTGenReady(CSOUND *csound, int fno);
+
+/**
+ * List the tables generated in the background since the last call;
+ * called by the performance thread every k-cycle.
+ */
+void csoundFTGenPublish(CSOUND *csound);
+
+/**
+ * Score f-statement: with -j above 1, the table is generated in the
+ * background with the other f-statements due at the same time, after
+ * the tables it reads. Otherwise, and for replacements, deletions,
+ * GENs of unknown plugins and tables reading missing tables, as hfgens()
+ * once the others are listed.
+ */
+int csoundFTGenScore(CSOUND *csound, const EVTBLK *evtblkp);
+
+/**
+ * Wait for the tables of score f-statements and list them.
+ */
+void csoundFTGenSync(CSOUND *csound);
+
+/**
+ * Tables read by GEN genum (name, if not NULL, for a named GEN): those
+ * numbered by p-fields *first, *first + *step, ... (only *first if *step
+ * is 0). Returns 1 if it reads tables, 0 if it does not, and -1 if that
+ * is not known.
+ */
+int ftsources(int genum, const char *name, int *first, int *step);
+
+/**
+ * Source table fno of the table described by ff: from the tables looked
+ * up for it if it is generated in the background, otherwise from the
+ * ftable list. Returns NULL if there is none; never reports an error.
+ */
+FUNC *ftsource(const FGDATA *ff, int fno);
+
+/**
+ * Persistent table cache (Engine/fgens_cache.c), used when CSFTCACHE
+ * names a directory: the key of a table, 0 if it is not cached; reading
+ * the header and data of a cached table; storing a table, which removes
+ * the least recently used tables once the cache is over CSFTCACHESIZE
+ * megabytes.
+ */
+uint64_t ftcache_key(CSOUND *csound, const FGDATA *ff, int genum,
+                     const char *name);
+MYFLT *ftcache_load(CSOUND *csound, uint64_t key, FUNC *ftp);
+void ftcache_store(CSOUND *csound, uint64_t key, const FUNC *ftp);
+
 #endif  /* CSOUND_FGENS_H */
 
@@ -0,0 +1,138 @@
+/*
+    ftmipmap.h:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_FTMIPMAP_H
+#define CSOUND_FTMIPMAP_H
+
+#if !defined(__BUILDING_LIBCSOUND)
+#  error "Csound plugins and host applications should not include ftmipmap.h"
+#endif
+
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /**
+   * Band-limited copies of table ftp, made when first asked for and
+   * shared by all users of the table until it is replaced or deleted.
+   * Changes made to the table data by opcodes are not seen.
+   * Every call takes a reference to the copies, which stay valid until
+   * it is given back with ftmipmap_release().
+   *
+   * returns: the copies, or NULL if ftp is not a mono table with a
+   *          power of two length of 4 or more
+   */
+  FTMIPMAP *csoundFTMipMap(CSOUND *csound, FUNC *ftp);
+
+  /**
+   * Give back a reference taken by csoundFTMipMap(); mip may be NULL.
+   */
+  void ftmipmap_release(CSOUND *csound, FTMIPMAP *mip);
+
+  /**
+   * Forget the copies of table fno; called when the table is replaced
+   * or deleted. Copies still in use are remade in place if the new table
+   * has the same length, and kept as they are until released otherwise.
+   */
+  void ftmipmap_discard(CSOUND *csound, int fno);
+
+  /**
+   * The level to read at a phase increment of inc samples of the original
+   * table per output sample; *w is the weight of the next level.
+   * Level k has no partials above the Nyquist frequency while inc is at
+   * most 2^k, so both levels mixed are alias free: from just above
+   * 2^(k - 1) to 2^k the mix fades from level k to level k + 1.
+   */
+  static inline int ftmip_level(const FTMIPMAP *mip, double inc, MYFLT *w)
+  {
+      int     k;
+      double  x;
+
+      inc = fabs(inc);
+      if (inc <= 0.5) {
+        *w = FL(0.0);
+        return 0;
+      }
+      x = log2(inc);
+      k = (int) ceil(x);
+      if (k >= mip->nlevels - 1) {
+        *w = FL(0.0);
+        return mip->nlevels - 1;
+      }
+      *w = (MYFLT) (x - k + 1.0);
+      return k;
+  }
+
+  /* level l at phase phs (MAXLEN a cycle), linear interpolation */
+  static inline MYFLT ftmip_read(const FTMIPLEVEL *l, int32 phs)
+  {
+      MYFLT   *t = l->ftable + (phs >> l->lobits);
+      MYFLT   fract = (MYFLT) (phs & l->lomask) * l->lodiv;
+
+      return t[0] + (t[1] - t[0]) * fract;
+  }
+
+  /* level l at phase phs, cubic interpolation as in oscil3 */
+  static inline MYFLT ftmip_read3(const FTMIPLEVEL *l, int32 phs)
+  {
+      MYFLT   *t = l->ftable + (phs >> l->lobits);
+      MYFLT   fract = (MYFLT) (phs & l->lomask) * l->lodiv;
+      MYFLT   ym1 = t[-1], y0 = t[0], y1 = t[1], y2 = t[2];
+      MYFLT   frsq = fract * fract, frcu = frsq * ym1;
+      MYFLT   t1 = y2 + y0 + y0 + y0;
+
+      return (y0 + FL(0.5) * frcu +
+              fract * (y1 - frcu / FL(6.0) - t1 / FL(6.0) - ym1 / FL(3.0)) +
+              frsq * fract * (t1 / FL(6.0) - FL(0.5) * y1) +
+              frsq * (FL(0.5) * y1 - y0));
+  }
+
+  /**
+   * Mix of levels k and k + 1 with weight w for the latter, read with
+   * linear (order 1) or cubic (order 3) interpolation
+   */
+  static inline MYFLT ftmip_mix(const FTMIPMAP *mip, int k, MYFLT w,
+                                int32 phs, int order)
+  {
+      MYFLT   v;
+
+      if (order == 3) {
+        v = ftmip_read3(&mip->level[k], phs);
+        if (w != FL(0.0))
+          v += w * (ftmip_read3(&mip->level[k + 1], phs) - v);
+      }
+      else {
+        v = ftmip_read(&mip->level[k], phs);
+        if (w != FL(0.0))
+          v += w * (ftmip_read(&mip->level[k + 1], phs) - v);
+      }
+      return v;
+  }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      /* CSOUND_FTMIPMAP_H */
@@ -0,0 +1,88 @@
+/*
+    housekeep.h:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_HOUSEKEEP_H
+#define CSOUND_HOUSEKEEP_H
+
+#if !defined(__BUILDING_LIBCSOUND)
+#  error "Csound plugins and host applications should not include housekeep.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* default age in seconds after which free instances are reclaimed */
+#define HOUSEKEEP_IDLE  (10.0)
+  /* default number of free instances kept per instrument */
+#define HOUSEKEEP_KEEP  (1)
+
+  /**
+   * Start the housekeeping thread, called by musmon() before performance
+   */
+  void csoundHousekeepStart(CSOUND *csound);
+
+  /**
+   * Periodic pass of the performance thread, once a second: the free
+   * instances of each instrument that have been idle for longer than
+   * the housekeeping age, beyond the number kept, are unlinked and
+   * handed to the housekeeping thread. Nothing is freed here.
+   */
+  void csoundHousekeep(CSOUND *csound);
+
+  /**
+   * Hand a list of inactive instances, unlinked from their instruments
+   * and chained through nxtact, to the housekeeping thread. Without a
+   * running thread they are freed at once.
+   */
+  void csoundHousekeepInstances(CSOUND *csound, INSDS *list);
+
+  /**
+   * Hand a deleted function table to the housekeeping thread, or free it
+   * at once if there is no thread or its queue is full
+   */
+  void csoundHousekeepTable(CSOUND *csound, FUNC *ftp);
+
+  /**
+   * Wait until everything handed to the housekeeping thread has been
+   * freed; to be called before freeing an instrument definition
+   */
+  void csoundHousekeepSync(CSOUND *csound);
+
+  /**
+   * Count a new instance, called by instance()
+   */
+  void csoundHousekeepAlloc(CSOUND *csound);
+
+  /**
+   * Free an inactive instance and its AUXCH and variable memory, which
+   * must already be unlinked from its instrument.
+   * returns: bytes of AUXCH memory released
+   */
+  size_t csoundFreeInstance(CSOUND *csound, INSDS *ip);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      /* CSOUND_HOUSEKEEP_H */
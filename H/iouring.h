@@ -0,0 +1,94 @@
+/*
+    iouring.h:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+
+#ifndef CSOUND_IOURING_H
+#define CSOUND_IOURING_H
+
+#if !defined(__BUILDING_LIBCSOUND)
+#  error "Csound plugins and host applications should not include iouring.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /**
+   * Attach an asynchronous sound file stream to the io_uring engine,
+   * starting it on first use
+   *
+   * fd:      descriptor of the file, closed by csoundIoUringClose()
+   * sf:      the SNDFILE opened on fd. Streams read are reopened with
+   *          virtual I/O over the read-ahead cache, and *sf replaced.
+   * sfinfo:  the SF_INFO the file was opened with
+   * writing: non-zero for a stream written to the file
+   * cb:      circular buffer of MYFLT between the stream and the
+   *          performance thread, of 4 * bufsize items
+   * bufsize: items moved at a time
+   *
+   * returns: the stream, or NULL if io_uring is not available, in which
+   *          case the caller falls back to the file I/O thread
+   */
+  void *csoundIoUringOpen(CSOUND *csound, int fd, SNDFILE **sf,
+                          SF_INFO *sfinfo, int writing, void *cb,
+                          int bufsize);
+
+  /**
+   * Read up to items samples of a stream; nothing is read until a
+   * pending seek has been done
+   */
+  unsigned int csoundIoUringRead(CSOUND *csound, void *stream,
+                                 MYFLT *buf, int items);
+
+  /**
+   * Queue up to items samples to be written
+   */
+  unsigned int csoundIoUringWrite(CSOUND *csound, void *stream,
+                                  MYFLT *buf, int items);
+
+  /**
+   * Request a seek, returning at once. Samples queued for writing before
+   * the seek are written before it; samples read come from after it.
+   * returns: pos for SEEK_SET, otherwise 0, or -1 if too many seeks are
+   *          pending
+   */
+  int csoundIoUringSeek(CSOUND *csound, void *stream, int pos, int whence);
+
+  /**
+   * Request the close of a stream, returning at once: the engine writes
+   * what is queued and closes the SNDFILE, the circular buffer and the
+   * file descriptor, which the caller must no longer use
+   * returns: 0
+   */
+  int csoundIoUringClose(CSOUND *csound, void *stream);
+
+  /**
+   * Stop the engine, after all streams have been closed
+   */
+  void csoundIoUringStop(CSOUND *csound);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      /* CSOUND_IOURING_H */
@@ -0,0 +1,84 @@
+/*
+    oscbank.h:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_OSCBANK_H
+#define CSOUND_OSCBANK_H
+
+#if !defined(__BUILDING_LIBCSOUND)
+#  error "Csound plugins and host applications should not include oscbank.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /**
+   * Sinusoidal oscillator bank setup
+   *
+   * aux:      memory of the bank, owned by the calling opcode
+   * count:    number of oscillators
+   * maxblock: longest block rendered by csoundOscBankRun()
+   * ftp:      waveform, or NULL for a sine. Tables holding a sinusoid of
+   *           any amplitude and phase are rendered as such; other
+   *           waveforms are read with linear interpolation.
+   *
+   * All oscillators start silent, at phase 0.
+   * returns: the bank, or NULL on invalid arguments
+   */
+  void *csoundOscBankCreate(CSOUND *csound, AUXCH *aux, int count,
+                            int maxblock, FUNC *ftp);
+
+  /**
+   * Targets of oscillator n at the end of the next block
+   *
+   * amp:   amplitude, reached by a linear ramp across the block
+   * freq:  frequency in Hz
+   * phase: radians, used by CS_OSCBANK_PHASE and CS_OSCBANK_START
+   * mode:  CS_OSCBANK_GLIDE, the frequency glides linearly across the
+   *        block; CS_OSCBANK_PHASE, cubic phase interpolation reaching
+   *        phase at the end of the block; CS_OSCBANK_START, restart from
+   *        amplitude 0 at phase, with the frequency given by the last
+   *        call before the next block
+   *
+   * An oscillator not set for a block holds its amplitude and frequency.
+   */
+  void csoundOscBankSet(CSOUND *csound, void *bank, int n, MYFLT amp,
+                        MYFLT freq, MYFLT phase, int mode);
+
+  /**
+   * Copy the state of oscillator src to dst
+   */
+  void csoundOscBankMove(CSOUND *csound, void *bank, int dst, int src);
+
+  /**
+   * Render the sum of oscillators 0 to count - 1 over nsmps <= maxblock
+   * samples into out
+   */
+  void csoundOscBankRun(CSOUND *csound, void *bank, MYFLT *out, int nsmps,
+                        int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      /* CSOUND_OSCBANK_H */
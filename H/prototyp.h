@@ -38,6 +38,10 @@ void    *mmallocDebug(CSOUND *, size_t, char*, int);
 void    *mcallocDebug(CSOUND *, size_t, char*, int);
 void    *mreallocDebug(CSOUND *, void *, size_t, char*, int);
 void    mfreeDebug(CSOUND *, void *, char*, int);
+#if !defined(WIN32) && !defined(__wasi__) && !defined(__EMSCRIPTEN__)
+#define CS_MMAPBLOCK 1
+void    *mmapblock(CSOUND *, void *, size_t, size_t);
+#endif
 char    *cs_strdup(CSOUND*, char*);
 char    *cs_strndup(CSOUND*, char*, size_t);
 void    csoundAuxAlloc(CSOUND *, size_t, AUXCH *), auxchfree(CSOUND *, INSDS *);
@@ -87,6 +91,8 @@ void    remove_tmpfiles(CSOUND *);
 void    add_tmpfile(CSOUND *, char *);
 void    xturnoff(CSOUND *, INSDS *);
 void    xturnoff_now(CSOUND *, INSDS *);
+void    xturnoff_mark(CSOUND *, INSDS *, int);
+void    xturnoff_marked(CSOUND *, INSDS *);
 int     insert_score_event(CSOUND *, EVTBLK *, double);
 //MEMFIL  *ldmemfile(CSOUND *, const char *);
 //MEMFIL  *ldmemfile2(CSOUND *, const char *, int);
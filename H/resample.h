@@ -0,0 +1,93 @@
+/*
+    resample.h:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_RESAMPLE_H
+#define CSOUND_RESAMPLE_H
+
+#if !defined(__BUILDING_LIBCSOUND)
+#  error "Csound plugins and host applications should not include resample.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /**
+   * Polyphase sample rate converter setup
+   *
+   * insr, outsr: input and output sample rates
+   * nchnls:      number of interleaved channels; with 0 the converter can
+   *              only be used with csoundResamplerCoefs(), is shared and
+   *              lives until the instance is reset
+   * quality:     1 to 8, the filter length being 16 * quality taps at
+   *              the lower of the two rates
+   *
+   * returns: opaque converter, or NULL on invalid arguments
+   */
+  void *csoundResamplerCreate(CSOUND *csound, MYFLT insr, MYFLT outsr,
+                              int nchnls, int quality);
+
+  /**
+   * Convert a block of input
+   *
+   * chn: channel to process, or -1 for all of them. Different channels of
+   *      one converter may be processed on different threads at once.
+   * in:  nin interleaved input frames, all of which are used; NULL marks
+   *      the end of the input, and the output is then completed to the
+   *      length of the input times outsr / insr.
+   * out: interleaved output, with room for csoundResamplerFrames(nin)
+   *      frames
+   *
+   * returns: number of output frames written
+   */
+  int csoundResample(CSOUND *csound, void *rs, int chn,
+                     const MYFLT *in, int nin, MYFLT *out);
+
+  /**
+   * Maximum number of output frames of csoundResample() for nin input
+   * frames (including the end of input)
+   */
+  int csoundResamplerFrames(CSOUND *csound, void *rs, int nin);
+
+  /**
+   * Filter coefficients for an output at position n + frac of the input,
+   * 0 <= frac < 1, for use by readers with random access to the input.
+   * The taps apply to input frames n - ntaps / 2 + 1 to n + ntaps / 2.
+   *
+   * coefs: ntaps values, or NULL
+   *
+   * returns: ntaps
+   */
+  int csoundResamplerCoefs(CSOUND *csound, void *rs, double frac,
+                           MYFLT *coefs);
+
+  /**
+   * Free a converter created with nchnls > 0
+   */
+  void csoundResamplerDestroy(CSOUND *csound, void *rs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      /* CSOUND_RESAMPLE_H */
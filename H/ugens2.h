@@ -64,8 +64,11 @@ typedef struct  {
 
 typedef struct {
         OPDS    h;
-        MYFLT   *sr, *xamp, *xcps, *ifn, *iphs;
+        MYFLT   *sr, *xamp, *xcps, *ifn, *iphs, *ibl;
         int32   lphs;
         FUNC    *ftp;
         FUNC    FF;
+        /* band-limited mode: table levels, interpolation order */
+        FTMIPMAP *mip;
+        int16   order, ampcod, cpscod;
 } OSC;
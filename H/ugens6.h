@@ -58,17 +58,17 @@ typedef struct {
 typedef struct {
         OPDS    h;
         MYFLT   *ar, *asig, *idlt, *istor;
-        MYFLT   *curp;
         int32    npts;
         AUXCH   auxch;
+        CS_DELAYLINE *line;
 } DELAY;
 
 typedef struct DELAYR {
         OPDS    h;
         MYFLT   *ar, *indx, *idlt, *istor;
-        MYFLT   *curp;
         uint32_t npts;
         AUXCH   auxch;
+        CS_DELAYLINE *line;
         struct DELAYR  *next_delayr; /* fifo for delayr pointers by Jens Groh */
 } DELAYR;
 
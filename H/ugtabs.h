@@ -30,6 +30,9 @@ typedef struct _tabl {
   int32 len;
   int iwrap;
   FUNC *ftp;
+  /* reading kernel of the audio rate readers, chosen on first use */
+  void (*kern)(const struct _tabl *, MYFLT *, const MYFLT *,
+               uint32_t, uint32_t);
 } TABL;
 
 typedef struct _tlen {
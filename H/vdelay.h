@@ -30,42 +30,44 @@ typedef struct {
         MYFLT   *sr, *ain, *adel, *imaxd, *istod;
         uint32 maxd;
         AUXCH   aux;
-        int32   left;
+        CS_DELAYLINE *line;
 } VDEL;
 
+/* the lines of all channels are in aux1 */
+
 typedef struct {
         OPDS    h;
         MYFLT   *sr1, *sr2, *sr3, *sr4;
         MYFLT   *ain1, *ain2, *ain3, *ain4, *adel, *imaxd, *iquality, *istod;
-        AUXCH   aux1, aux2, aux3, aux4;
-        uint32 maxd;
+        AUXCH   aux1;
+        CS_DELAYLINE *line;
         int     interp_size;
-        int32   left;
 } VDELXQ;
 
 typedef struct {
         OPDS    h;
         MYFLT   *sr1, *sr2, *ain1, *ain2, *adel, *imaxd, *iquality, *istod;
-        AUXCH   aux1, aux2;
-        uint32 maxd;
+        AUXCH   aux1;
+        CS_DELAYLINE *line;
         int     interp_size;
-        int32   left;
 } VDELXS;
 
 typedef struct {
         OPDS    h;
         MYFLT   *sr1, *ain1, *adel, *imaxd, *iquality, *istod;
         AUXCH   aux1;
-        uint32 maxd;
+        CS_DELAYLINE *line;
         int     interp_size;
-        int32   left;
 } VDELX;
 
 typedef struct {
         OPDS    h;
         MYFLT   *sr, *ain, *ndel[VARGMAX-1];
         AUXCH   aux;
-        int32   left, max;
+        AUXCH   auxt;           /* the taps, and their delays */
+        CS_DELAYLINE *line;
+        CS_DELAYTAP  *taps;
+        int     ntaps;
 } MDEL;
 
 #if 0
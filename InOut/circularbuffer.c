@@ -23,22 +23,46 @@
 
 #include <csoundCore.h>
 
+/* Single producer, single consumer ring. Each side owns its index and
+   keeps a copy of the other side's, which is only reloaded (with acquire
+   ordering) when the copy shows too little data or space; indices are
+   published with release ordering once the elements have been written or
+   read. The two sides are kept on separate cache lines. */
+
+#define CB_LINE 64
+
+#if defined(MSVC)
+#define CB_LOAD_ACQ(x)      InterlockedCompareExchange((volatile long*) &(x), 0, 0)
+#define CB_STORE_REL(x, v)  InterlockedExchange((volatile long*) &(x), v)
+#elif defined(HAVE_ATOMIC_BUILTIN)
+#define CB_LOAD_ACQ(x)      __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define CB_STORE_REL(x, v)  __atomic_store_n(&(x), v, __ATOMIC_RELEASE)
+#else
+#define CB_LOAD_ACQ(x)      (x)
+#define CB_STORE_REL(x, v)  ((x) = (v))
+#endif
+
 typedef struct _circular_buffer {
   char *buffer;
-  int  wp;
-  int rp;
   int numelem;
   int elemsize; /* in number of bytes */
+  char pad0[CB_LINE];
+  int  wp;      /* producer: write position */
+  int  rpc;     /* producer: last read position seen */
+  char pad1[CB_LINE];
+  int rp;       /* consumer: read position */
+  int wpc;      /* consumer: last write position seen */
+  char pad2[CB_LINE];
 } circular_buffer;
 
 void *csoundCreateCircularBuffer(CSOUND *csound, int numelem, int elemsize){
     circular_buffer *p;
     if ((p = (circular_buffer *)
-         csound->Malloc(csound, sizeof(circular_buffer))) == NULL) {
+         csound->Calloc(csound, sizeof(circular_buffer))) == NULL) {
       return NULL;
     }
     p->numelem = numelem;
-    p->wp = p->rp = 0;
+    p->wp = p->rp = p->rpc = p->wpc = 0;
     p->elemsize = elemsize;
 
     if ((p->buffer = (char *) csound->Malloc(csound, numelem*elemsize)) == NULL) {
@@ -48,127 +72,170 @@ void *csoundCreateCircularBuffer(CSOUND *csound, int numelem, int elemsize){
     return (void *)p;
 }
 
+static inline int write_space(int wp, int rp, int numelem)
+{
+    return (rp > wp ? rp - wp - 1 : rp - wp + numelem - 1);
+}
+
+static inline int read_space(int wp, int rp, int numelem)
+{
+    return (wp >= rp ? wp - rp : wp - rp + numelem);
+}
+
 int checkspace(circular_buffer *p, int writeCheck){
-    int wp = p->wp, rp = p->rp, numelem = p->numelem;
-    if(writeCheck){
-      if (wp > rp) return rp - wp + numelem - 1;
-      else if (wp < rp) return rp - wp - 1;
-      else return numelem - 1;
+    int wp = CB_LOAD_ACQ(p->wp), rp = CB_LOAD_ACQ(p->rp);
+    return (writeCheck ? write_space(wp, rp, p->numelem) :
+            read_space(wp, rp, p->numelem));
+}
+
+/* elements that can be written, up to items */
+
+static inline int writable(circular_buffer *p, int items)
+{
+    int n = write_space(p->wp, p->rpc, p->numelem);
+    if (n < items) {
+      p->rpc = CB_LOAD_ACQ(p->rp);
+      n = write_space(p->wp, p->rpc, p->numelem);
     }
-    else {
-      if (wp > rp) return wp - rp;
-      else if (wp < rp) return wp - rp + numelem;
-      else return 0;
+    return (items < n ? items : n);
+}
+
+/* elements that can be read, up to items */
+
+static inline int readable(circular_buffer *p, int items)
+{
+    int n = read_space(p->wpc, p->rp, p->numelem);
+    if (n < items) {
+      p->wpc = CB_LOAD_ACQ(p->wp);
+      n = read_space(p->wpc, p->rp, p->numelem);
     }
+    return (items < n ? items : n);
+}
+
+/* split items elements from position pos into at most two spans */
+
+static inline void make_region(circular_buffer *p, int pos, int items,
+                               CS_CIRCULAR_REGION *r)
+{
+    int n = p->numelem - pos;
+    if (n > items)
+      n = items;
+    r->data[0] = p->buffer + (size_t) pos * p->elemsize;
+    r->items[0] = n;
+    r->data[1] = (items > n ? p->buffer : NULL);
+    r->items[1] = items - n;
+}
+
+static void copy_out(circular_buffer *p, int rp, void *out, int items)
+{
+    CS_CIRCULAR_REGION r;
+    size_t es = p->elemsize;
+    make_region(p, rp, items, &r);
+    memcpy(out, r.data[0], r.items[0] * es);
+    if (r.items[1])
+      memcpy((char *) out + r.items[0] * es, r.data[1], r.items[1] * es);
+}
+
+static inline int advance(circular_buffer *p, int pos, int items)
+{
+    pos += items;
+    return (pos >= p->numelem ? pos - p->numelem : pos);
 }
 
 int csoundReadCircularBuffer(CSOUND *csound, void *p, void *out, int items)
 {
+    circular_buffer *cb = (circular_buffer *) p;
     IGN(csound);
-    if (p == NULL) return 0;
-    {
-      int remaining;
-      int itemsread, numelem = ((circular_buffer *)p)->numelem;
-      int elemsize = ((circular_buffer *)p)->elemsize;
-      int i=0, rp = ((circular_buffer *)p)->rp;
-      char *buffer = ((circular_buffer *)p)->buffer;
-      if ((remaining = checkspace(p, 0)) == 0) {
-        return 0;
-      }
-      itemsread = items > remaining ? remaining : items;
-      for (i=0; i < itemsread; i++){
-        memcpy((char *) out + (i * elemsize),
-               &(buffer[elemsize * rp++]),  elemsize);
-        if (rp == numelem) {
-          rp = 0;
-        }
-      }
-#if defined(MSVC)
-      InterlockedExchange(&((circular_buffer *)p)->rp, rp);
-#elif defined(HAVE_ATOMIC_BUILTIN)
-      __atomic_exchange_n(&((circular_buffer *)p)->rp,rp, __ATOMIC_SEQ_CST);
-#else
-      ((circular_buffer *)p)->rp = rp;
-#endif
-      return itemsread;
-    }
+    if (p == NULL || items <= 0) return 0;
+    if ((items = readable(cb, items)) == 0)
+      return 0;
+    copy_out(cb, cb->rp, out, items);
+    CB_STORE_REL(cb->rp, advance(cb, cb->rp, items));
+    return items;
 }
 
 int csoundPeekCircularBuffer(CSOUND *csound, void *p, void *out, int items)
 {
+    circular_buffer *cb = (circular_buffer *) p;
     IGN(csound);
-    if (p == NULL) return 0;
-    int remaining;
-    int itemsread, numelem = ((circular_buffer *)p)->numelem;
-    int elemsize = ((circular_buffer *)p)->elemsize;
-    int i=0, rp = ((circular_buffer *)p)->rp;
-    char *buffer = ((circular_buffer *)p)->buffer;
-    if ((remaining = checkspace(p, 0)) == 0) {
-        return 0;
-    }
-    itemsread = items > remaining ? remaining : items;
-    for(i=0; i < itemsread; i++){
-        memcpy((char *) out + (i * elemsize),
-               &(buffer[elemsize * rp++]),  elemsize);
-        if (rp == numelem) {
-            rp = 0;
-        }
-    }
-    return itemsread;
+    if (p == NULL || items <= 0) return 0;
+    if ((items = readable(cb, items)) == 0)
+      return 0;
+    copy_out(cb, cb->rp, out, items);
+    return items;
 }
 
 void csoundFlushCircularBuffer(CSOUND *csound, void *p)
 {
+    circular_buffer *cb = (circular_buffer *) p;
     IGN(csound);
     if (p == NULL) return;
-    int remaining;
-    int itemsread, numelem = ((circular_buffer *)p)->numelem;
-    int i=0, rp = ((circular_buffer *)p)->rp;
-    //MYFLT *buffer = ((circular_buffer *)p)->buffer;
-    if ((remaining = checkspace(p, 0)) == 0) {
-        return;
-    }
-    itemsread = numelem > remaining ? remaining: numelem;
-    for (i=0; i < itemsread; i++){
-        rp++;
-        if(rp == numelem) rp = 0;
-    }
-#if defined(MSVC)
-      InterlockedExchange(&((circular_buffer *)p)->rp, rp);
-#elif defined(HAVE_ATOMIC_BUILTIN)
-      __atomic_store_n(&((circular_buffer *)p)->rp,rp, __ATOMIC_SEQ_CST);
-#else
-      ((circular_buffer *)p)->rp = rp;
-#endif
+    cb->wpc = CB_LOAD_ACQ(cb->wp);
+    CB_STORE_REL(cb->rp, cb->wpc);
 }
 
-
 int csoundWriteCircularBuffer(CSOUND *csound, void *p, const void *in, int items)
 {
+    circular_buffer *cb = (circular_buffer *) p;
+    CS_CIRCULAR_REGION r;
+    size_t es;
+    IGN(csound);
+    if (p == NULL || items <= 0) return 0;
+    if ((items = writable(cb, items)) == 0)
+      return 0;
+    es = cb->elemsize;
+    make_region(cb, cb->wp, items, &r);
+    memcpy(r.data[0], in, r.items[0] * es);
+    if (r.items[1])
+      memcpy(r.data[1], (const char *) in + r.items[0] * es, r.items[1] * es);
+    CB_STORE_REL(cb->wp, advance(cb, cb->wp, items));
+    return items;
+}
+
+int csoundWriteCircularBufferReserve(CSOUND *csound, void *p, int items,
+                                     CS_CIRCULAR_REGION *region)
+{
+    circular_buffer *cb = (circular_buffer *) p;
     IGN(csound);
-    if (p == NULL) return 0;
-    int remaining;
-    int itemswrite, numelem = ((circular_buffer *)p)->numelem;
-    int elemsize = ((circular_buffer *)p)->elemsize;
-    int i=0, wp = ((circular_buffer *)p)->wp;
-    char *buffer = ((circular_buffer *)p)->buffer;
-    if ((remaining = checkspace(p, 1)) == 0) {
-        return 0;
+    if (p == NULL || items <= 0) items = 0;
+    else items = writable(cb, items);
+    if (items == 0) {
+      memset(region, 0, sizeof(CS_CIRCULAR_REGION));
+      return 0;
     }
-    itemswrite = items > remaining ? remaining : items;
-    for(i=0; i < itemswrite; i++){
-        memcpy(&(buffer[elemsize * wp++]),
-                ((char *) in) + (i * elemsize),  elemsize);
-        if(wp == numelem) wp = 0;
+    make_region(cb, cb->wp, items, region);
+    return items;
+}
+
+void csoundWriteCircularBufferCommit(CSOUND *csound, void *p, int items)
+{
+    circular_buffer *cb = (circular_buffer *) p;
+    IGN(csound);
+    if (p == NULL || items <= 0) return;
+    CB_STORE_REL(cb->wp, advance(cb, cb->wp, items));
+}
+
+int csoundReadCircularBufferReserve(CSOUND *csound, void *p, int items,
+                                    CS_CIRCULAR_REGION *region)
+{
+    circular_buffer *cb = (circular_buffer *) p;
+    IGN(csound);
+    if (p == NULL || items <= 0) items = 0;
+    else items = readable(cb, items);
+    if (items == 0) {
+      memset(region, 0, sizeof(CS_CIRCULAR_REGION));
+      return 0;
     }
-#if defined(MSVC)
-      InterlockedExchange(&((circular_buffer *)p)->wp, wp);
-#elif defined(HAVE_ATOMIC_BUILTIN)
-      __atomic_store_n(&((circular_buffer *)p)->wp,wp, __ATOMIC_SEQ_CST);
-#else
-      ((circular_buffer *)p)->wp = wp;
-#endif
-    return itemswrite;
+    make_region(cb, cb->rp, items, region);
+    return items;
+}
+
+void csoundReadCircularBufferCommit(CSOUND *csound, void *p, int items)
+{
+    circular_buffer *cb = (circular_buffer *) p;
+    IGN(csound);
+    if (p == NULL || items <= 0) return;
+    CB_STORE_REL(cb->rp, advance(cb, cb->rp, items));
 }
 
 void csoundDestroyCircularBuffer(CSOUND *csound, void *p){
@@ -43,6 +43,15 @@
       as a note on status without the data bytes) should not be
       returned.
 
+    int (*MidiReadTimedCallback)(CSOUND *csound, void *userData,
+                                 unsigned char *buf, int nbytes, int *age);
+
+      Optional. Same as MidiReadCallback, but also stores in age[i] the
+      number of sample frames elapsed between the arrival of buf[i] and
+      the call (-1 if not known). If set, it is used instead of
+      MidiReadCallback, and with --sample-accurate note-ons are started
+      at the offset ksmps - 1 - age of their last byte in the k-cycle.
+
     int (*MidiInCloseCallback)(CSOUND *csound, void *userData);
 
       Close MIDI input device associated with 'userData'.
@@ -84,6 +93,9 @@
     void csoundSetExternalMidiReadCallback(CSOUND *csound,
                     int (*func)(CSOUND *, void *, unsigned char *, int));
 
+    void csoundSetExternalMidiReadTimedCallback(CSOUND *csound,
+                    int (*func)(CSOUND *, void *, unsigned char *, int, int *));
+
     void csoundSetExternalMidiInCloseCallback(CSOUND *csound,
                     int (*func)(CSOUND *, void *));
 
@@ -130,7 +142,7 @@ void MidiOpen(CSOUND *csound)
     if (O->Midiin) {
       if (p->MidiInOpenCallback == NULL)
         csound->Die(csound, Str(" *** no callback for opening MIDI input"));
-      if (p->MidiReadCallback == NULL)
+      if (p->MidiReadCallback == NULL && p->MidiReadTimedCallback == NULL)
         csound->Die(csound, Str(" *** no callback for reading MIDI data"));
       err = p->MidiInOpenCallback(csound, &(p->midiInUserData), O->Midiname);
       if (err != 0) {
@@ -473,6 +485,25 @@ static void midNotesOff(CSOUND *csound)
     } while (++chan < MAXCHAN);
 }
 
+/* mark bytes without a timestamp */
+
+static void mage_unknown(MGLOBAL *p, int start, int n)
+{
+    int *age = &(p->mage[start]);
+    while (n--)
+      *age++ = -1;
+}
+
+/* a message that arrived 'age' samples before it was read starts at
+   sample ksmps - 1 - age of the k-cycle; older or untimed ones at 0 */
+
+static inline int32 mage_to_offset(CSOUND *csound, int age)
+{
+    if (age < 0 || age >= (int) csound->ksmps)
+      return 0;
+    return (int32) csound->ksmps - 1 - age;
+}
+
 /* sense a MIDI event, collect the data & dispatch */
 /* called from sensevents(), returns 2 if MIDI on/off */
 
@@ -489,7 +520,14 @@ int sensMidi(CSOUND *csound)
       p->bufp = &(p->mbuf[0]);
       p->endatp = p->bufp;
       if (O->Midiin && !csound->advanceCnt) {   /* read MIDI device */
-        n = p->MidiReadCallback(csound, p->midiInUserData, p->bufp, MBUFSIZ);
+        if (p->MidiReadTimedCallback != NULL)
+          n = p->MidiReadTimedCallback(csound, p->midiInUserData, p->bufp,
+                                       MBUFSIZ, &(p->mage[0]));
+        else {
+          n = p->MidiReadCallback(csound, p->midiInUserData, p->bufp, MBUFSIZ);
+          if (n > 0)
+            mage_unknown(p, 0, n);
+        }
         if (n < 0)
           csoundErrorMsg(csound, Str(" *** error reading MIDI device: %d (%s)"),
                                  n, csoundExternalMidiErrorString(csound, n));
@@ -499,8 +537,10 @@ int sensMidi(CSOUND *csound)
       if (O->FMidiin) {                         /* read MIDI file */
         n = csoundMIDIFileRead(csound, p->endatp,
                                MBUFSIZ - (int) (p->endatp - p->bufp));
-        if (n > 0)
+        if (n > 0) {
+          mage_unknown(p, (int) (p->endatp - p->bufp), n);
           p->endatp += (int) n;
+        }
       }
       if (p->endatp <= p->bufp)
         return 0;               /* no events were received */
@@ -584,6 +624,8 @@ int sensMidi(CSOUND *csound)
     else mep->dat2 = c;
     if (++p->datcnt < p->datreq)        /* if msg incomplete    */
       goto nxtchr;                      /*   get next char      */
+    /* timestamp of the complete message: its last byte */
+    mep->ofs = mage_to_offset(csound, p->mage[(p->bufp - p->mbuf) - 1]);
     /* Enter the input event into a buffer used by 'midiin'. */
     /* VL -- changed to allow higher-mapped channels */
     if (mep->type != SYSTEM_TYPE) {
@@ -32,6 +32,10 @@
 #ifndef _DEFAULT_SOURCE
 #define _DEFAULT_SOURCE 1
 #endif
+/* for pthread_setaffinity_np() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
 /* _BSD_SOURCE definition can be dropped once support for glibc < 2.19 is dropped */
 #ifndef _BSD_SOURCE
 #define _BSD_SOURCE 1
@@ -50,10 +54,12 @@
 #include <stdio.h>
 #include <alsa/asoundlib.h>
 #include <sched.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <signal.h>
 #include <sys/mman.h>
 #include <sys/resource.h>
+#include <time.h>
 
 
 #include "soundio.h"
@@ -116,19 +122,38 @@ typedef struct devparams_ {
     /* record sample conversion function */
     void            (*rec_conv)(int, void *, MYFLT *);
     int             seed;           /* random seed for dithering        */
+    int             mmap;           /* non-zero: mmap transfer          */
+    int             wakeup;         /* mmap wait, see ALSA_OPTIONS      */
+    int             cpu;            /* CPU for the I/O thread, -1: done */
 } DEVPARAMS;
 
+/* module options (-+alsa_mmap etc.) */
+
+typedef struct alsaOptions_ {
+    int             mmap;           /* use mmap transfers               */
+    int             wakeup;         /* 0, 1: poll, 2: timer wakeups     */
+    int             cpu;            /* CPU to pin the I/O thread to     */
+    int             fifo;           /* SCHED_FIFO for -+rtscheduler     */
+} ALSA_OPTIONS;
+
 #ifdef BUF_SIZE
 #undef BUF_SIZE
 #endif
 #define BUF_SIZE  4096
 
+/* raw MIDI input timestamps need alsa-lib 1.2.6 */
+#if defined(SND_LIB_VERSION) && SND_LIB_VERSION >= 0x010206
+#define ALSA_RAWMIDI_TSTAMP 1
+#endif
+
 typedef struct alsaMidiInputDevice_ {
     unsigned char  buf[BUF_SIZE];
     snd_rawmidi_t  *dev;
     int            bufpos, nbytes, datreq;
     unsigned char  prvStatus, dat1, dat2;
     struct alsaMidiInputDevice_ *next;
+    int            timed;           /* non-zero: buf is timestamped     */
+    struct timespec tstamp;         /* CLOCK_MONOTONIC arrival of buf   */
 } alsaMidiInputDevice;
 
 
@@ -145,15 +170,26 @@ typedef struct alsaseqMidi_ {
     snd_seq_event_t       sev;
     snd_seq_client_info_t *cinfo;
     snd_seq_port_info_t   *pinfo;
+    int                   queue;    /* timestamping queue, -1: none     */
+    snd_seq_queue_status_t *qstatus;
 } alsaseqMidi;
 
+/* age in samples of an event received at 'then', seen at 'now' */
+
+static inline int midi_age(CSOUND *csound, long sec, long nsec)
+{
+    double age = ((double) sec + (double) nsec * 1.0e-9) * csound->GetSr(csound);
+    return (age < 0.0 ? 0 : (age > 1.0e9 ? 1000000000 : (int) age));
+}
+
 static const unsigned char dataBytes[16] = {
     0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 1, 1, 2, 0
 };
 
-int set_scheduler_priority(CSOUND *csound, int priority)
+int set_scheduler_priority(CSOUND *csound, int priority, int fifo)
 {
     struct sched_param p;
+    int                policy = (fifo ? SCHED_FIFO : SCHED_RR);
 
     memset(&p, 0, sizeof(struct sched_param));
     if (UNLIKELY(priority < -20 || priority > sched_get_priority_max(SCHED_RR))) {
@@ -171,12 +207,14 @@ int set_scheduler_priority(CSOUND *csound, int priority)
     /* set scheduling policy and priority */
     if (priority > 0) {
       p.sched_priority = priority;
-      if (UNLIKELY(sched_setscheduler(0, SCHED_RR, &p) != 0)) {
+      if (UNLIKELY(sched_setscheduler(0, policy, &p) != 0)) {
         csound->Message(csound,
-                        Str("csound: cannot set scheduling policy to SCHED_RR"));
+                        Str("csound: cannot set scheduling policy to %s"),
+                        (fifo ? "SCHED_FIFO" : "SCHED_RR"));
       }
       else   csound->Message(csound,
-                        Str("csound: setting scheduling policy to SCHED_RR\n"));
+                        Str("csound: setting scheduling policy to %s\n"),
+                        (fifo ? "SCHED_FIFO" : "SCHED_RR"));
     }
     else {
       /* nice requested */
@@ -433,7 +471,16 @@ static int set_device_params(CSOUND *csound, DEVPARAMS *dev, int play)
 
     /* now set the various hardware parameters: */
     /* access method, */
-    if (UNLIKELY(snd_pcm_hw_params_set_access(dev->handle, hw_params,
+    if (dev->mmap &&
+        snd_pcm_hw_params_set_access(dev->handle, hw_params,
+                                     SND_PCM_ACCESS_MMAP_INTERLEAVED) < 0) {
+      p->MessageS(p, CSOUNDMSG_WARNING,
+                  Str(" *** ALSA: mmap access not supported by '%s', "
+                      "using read/write transfers\n"), devName);
+      dev->mmap = 0;
+    }
+    if (UNLIKELY(!dev->mmap &&
+                 snd_pcm_hw_params_set_access(dev->handle, hw_params,
                                               SND_PCM_ACCESS_RW_INTERLEAVED) < 0)) {
       strNcpy(msg, Str("Error setting access type for soundcard"), MSGLEN);
       goto err_return_msg;
@@ -534,6 +581,16 @@ static int set_device_params(CSOUND *csound, DEVPARAMS *dev, int play)
         }
       }
     }
+    /* timer driven mmap transfers do not need period interrupts */
+    if (!dev->mmap)
+      dev->wakeup = 0;
+    else if (dev->wakeup == 2 &&
+             snd_pcm_hw_params_set_period_wakeup(dev->handle, hw_params, 0) < 0) {
+      p->MessageS(p, CSOUNDMSG_WARNING,
+                  Str(" *** ALSA: cannot disable period wakeups on '%s', "
+                      "using poll wakeups\n"), devName);
+      dev->wakeup = 1;
+    }
     /* set up device according to the above parameters */
     if (UNLIKELY(snd_pcm_hw_params(dev->handle, hw_params) < 0)) {
       strNcpy(msg,
@@ -560,6 +617,9 @@ static int set_device_params(CSOUND *csound, DEVPARAMS *dev, int play)
               Str("Error setting software parameters for real-time audio"),MSGLEN);
       goto err_return_msg;
     }
+    /* mmap transfers convert directly into the DMA area */
+    if (dev->mmap)
+      return 0;
     /* allocate memory for sample conversion buffer */
     n = (dev->format == AE_SHORT ? 2 : 4) * dev->nchns * alloc_smps;
     dev->buf = (void*) csound->Malloc(csound, (size_t) n);
@@ -717,6 +777,16 @@ static int open_device(CSOUND *csound, const csRtAudioParams *parm, int play)
     dev->playconv = (void (*)(int, MYFLT*, void*, int*)) NULL;
     dev->rec_conv = (void (*)(int, void*, MYFLT*)) NULL;
     dev->seed = 1;
+    dev->cpu = -1;
+    {
+      ALSA_OPTIONS *opts =
+        (ALSA_OPTIONS*) csound->QueryGlobalVariable(csound, "_alsaOptions");
+      if (opts != NULL) {
+        dev->mmap = opts->mmap;
+        dev->wakeup = opts->wakeup;
+        dev->cpu = opts->cpu;
+      }
+    }
     /* open device */
     retval = set_device_params(csound, dev, play);
     if (retval != 0) {
@@ -726,6 +796,26 @@ static int open_device(CSOUND *csound, const csRtAudioParams *parm, int play)
     return retval;
 }
 
+/* pin the thread doing the device I/O (which is not necessarily the one */
+/* that opened the device) to dev->cpu, once, on its first transfer      */
+
+static void pin_io_thread(CSOUND *csound, DEVPARAMS *dev)
+{
+    cpu_set_t cpus;
+    int       err;
+
+    CPU_ZERO(&cpus);
+    CPU_SET(dev->cpu, &cpus);
+    err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus);
+    if (UNLIKELY(err != 0))
+      csound->Warning(csound, Str("ALSA: cannot pin audio thread to CPU %d"),
+                      dev->cpu);
+    else if (csound->GetMessageLevel(csound) & 0x400)
+      csound->Message(csound, Str("ALSA: audio thread pinned to CPU %d\n"),
+                      dev->cpu);
+    dev->cpu = -1;
+}
+
 /* open for audio input */
 
 static int recopen_(CSOUND *csound, const csRtAudioParams *parm)
@@ -750,6 +840,144 @@ static int playopen_(CSOUND *csound, const csRtAudioParams *parm)
         csound->Warning(csound, Str(x));                  \
   }
 
+/* mmap transfers: wait until at least 'need' frames can be transferred */
+
+static void mmap_wait(DEVPARAMS *dev, snd_pcm_sframes_t avail,
+                      snd_pcm_sframes_t need)
+{
+    if (dev->wakeup == 2) {
+      /* sleep for the time the missing frames take at the sample rate */
+      struct timespec ts;
+      long  ns = (long) ((double) (need - avail) * 1.0e9 / (double) dev->srate);
+      ts.tv_sec = (time_t) (ns / 1000000000L);
+      ts.tv_nsec = ns % 1000000000L;
+      clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+    }
+    else
+      snd_pcm_wait(dev->handle, 1000);
+}
+
+/* mmap transfers: recover from an xrun or suspend, returns zero on success */
+
+static int mmap_recover(CSOUND *csound, DEVPARAMS *dev, int err, int play)
+{
+    if (err == -EPIPE) {
+      if (play)
+        warning(Str("Buffer underrun in real-time audio output"))
+      else
+        warning(Str("Buffer overrun in real-time audio input"))
+      return (snd_pcm_prepare(dev->handle) < 0);
+    }
+    if (err == -ESTRPIPE) {
+      if (play)
+        warning(Str("Real-time audio output suspended"))
+      else
+        warning(Str("Real-time audio input suspended"))
+      while (snd_pcm_resume(dev->handle) == -EAGAIN) sleep(1);
+      return (snd_pcm_prepare(dev->handle) < 0);
+    }
+    return 1;
+}
+
+/* address of frame 'offset' of an interleaved mmap area */
+
+static inline void *mmap_addr(const snd_pcm_channel_area_t *areas,
+                              snd_pcm_uframes_t offset)
+{
+    return (void*) ((char*) areas[0].addr
+                    + ((areas[0].first + offset * areas[0].step) >> 3));
+}
+
+static int rtrecord_mmap(CSOUND *csound, DEVPARAMS *dev, MYFLT *inbuf, int n)
+{
+    const snd_pcm_channel_area_t *areas;
+    snd_pcm_uframes_t offset, frames;
+    snd_pcm_sframes_t avail, need;
+    int               err, m = 0;
+
+    while (n) {
+      need = (n < dev->period_smps ? n : dev->period_smps);
+      avail = snd_pcm_avail_update(dev->handle);
+      if (UNLIKELY(avail < 0)) {
+        if (mmap_recover(csound, dev, (int) avail, 0) == 0) continue;
+        break;
+      }
+      if (avail < need) {
+        if (snd_pcm_state(dev->handle) == SND_PCM_STATE_PREPARED)
+          snd_pcm_start(dev->handle);
+        mmap_wait(dev, avail, need);
+        continue;
+      }
+      frames = (snd_pcm_uframes_t) (avail < n ? avail : n);
+      err = snd_pcm_mmap_begin(dev->handle, &areas, &offset, &frames);
+      if (LIKELY(err >= 0)) {
+        /* convert samples to MYFLT straight from the DMA area */
+        dev->rec_conv((int) frames * dev->nchns, mmap_addr(areas, offset),
+                      inbuf + m * dev->nchns);
+        err = (int) snd_pcm_mmap_commit(dev->handle, offset, frames);
+        if (LIKELY(err >= 0 && (snd_pcm_uframes_t) err == frames)) {
+          n -= (int) frames; m += (int) frames; continue;
+        }
+        if (err >= 0) err = -EPIPE;
+      }
+      if (mmap_recover(csound, dev, err, 0) == 0) continue;
+      break;
+    }
+    if (UNLIKELY(n)) {
+      /* could not recover from error */
+      csound->ErrorMsg(csound,
+                       Str("Error reading data from audio input device"));
+      snd_pcm_close(dev->handle);
+      dev->handle = NULL;
+    }
+    return (m * dev->sampleSize);
+}
+
+static void rtplay_mmap(CSOUND *csound, DEVPARAMS *dev,
+                        const MYFLT *outbuf, int n)
+{
+    const snd_pcm_channel_area_t *areas;
+    snd_pcm_uframes_t offset, frames;
+    snd_pcm_sframes_t avail, need;
+    int               err;
+
+    while (n) {
+      need = (n < dev->period_smps ? n : dev->period_smps);
+      avail = snd_pcm_avail_update(dev->handle);
+      if (UNLIKELY(avail < 0)) {
+        if (mmap_recover(csound, dev, (int) avail, 1) == 0) continue;
+        break;
+      }
+      if (avail < need) {
+        if (snd_pcm_state(dev->handle) == SND_PCM_STATE_PREPARED)
+          snd_pcm_start(dev->handle);
+        mmap_wait(dev, avail, need);
+        continue;
+      }
+      frames = (snd_pcm_uframes_t) (avail < n ? avail : n);
+      err = snd_pcm_mmap_begin(dev->handle, &areas, &offset, &frames);
+      if (LIKELY(err >= 0)) {
+        /* convert samples from MYFLT straight into the DMA area */
+        dev->playconv((int) frames * dev->nchns, (MYFLT*) outbuf,
+                      mmap_addr(areas, offset), &(dev->seed));
+        err = (int) snd_pcm_mmap_commit(dev->handle, offset, frames);
+        if (LIKELY(err >= 0 && (snd_pcm_uframes_t) err == frames)) {
+          n -= (int) frames; outbuf += (int) frames * dev->nchns; continue;
+        }
+        if (err >= 0) err = -EPIPE;
+      }
+      if (mmap_recover(csound, dev, err, 1) == 0) continue;
+      break;
+    }
+    if (UNLIKELY(n)) {
+      /* could not recover from error */
+      csound->ErrorMsg(csound,
+                       Str("Error writing data to audio output device"));
+      snd_pcm_close(dev->handle);
+      dev->handle = NULL;
+    }
+}
+
 static int rtrecord_(CSOUND *csound, MYFLT *inbuf, int nbytes)
 {
     DEVPARAMS *dev;
@@ -761,8 +989,12 @@ static int rtrecord_(CSOUND *csound, MYFLT *inbuf, int nbytes)
       memset(inbuf, 0, (size_t) nbytes);
       return nbytes;
     }
+    if (UNLIKELY(dev->cpu >= 0))
+      pin_io_thread(csound, dev);
     /* calculate the number of samples to record */
     n = nbytes / dev->sampleSize;
+    if (dev->mmap)
+      return rtrecord_mmap(csound, dev, inbuf, n);
 
     m = 0;
     while (n) {
@@ -804,8 +1036,14 @@ static void rtplay_(CSOUND *csound, const MYFLT *outbuf, int nbytes)
     dev = (DEVPARAMS*) *(csound->GetRtPlayUserData(csound));
     if (dev->handle == NULL)
       return;
+    if (UNLIKELY(dev->cpu >= 0))
+      pin_io_thread(csound, dev);
     /* calculate the number of samples to play */
     n = nbytes / dev->sampleSize;
+    if (dev->mmap) {
+      rtplay_mmap(csound, dev, outbuf, n);
+      return;
+    }
 
     /* convert samples from MYFLT */
     dev->playconv(n * dev->nchns, (MYFLT*) outbuf, dev->buf, &(dev->seed));
@@ -883,6 +1121,20 @@ static alsaMidiInputDevice* open_midi_device(CSOUND *csound, const char  *s)
       return NULL;
     }
     MSG(csound, Str("ALSA: opened MIDI input device '%s'\n"), s);
+#ifdef ALSA_RAWMIDI_TSTAMP
+    {
+      /* ask for framed input with monotonic arrival times */
+      snd_rawmidi_params_t *params;
+      snd_rawmidi_params_alloca(&params);
+      if (snd_rawmidi_params_current(dev->dev, params) == 0 &&
+          snd_rawmidi_params_set_read_mode(dev->dev, params,
+                                           SND_RAWMIDI_READ_TSTAMP) == 0 &&
+          snd_rawmidi_params_set_clock_type(dev->dev, params,
+                                            SND_RAWMIDI_CLOCK_MONOTONIC) == 0 &&
+          snd_rawmidi_params(dev->dev, params) == 0)
+        dev->timed = 1;
+    }
+#endif
     return dev;
 }
 
@@ -966,33 +1218,45 @@ static int midi_in_open(CSOUND *csound, void **userData, const char *devName)
     return 0;
 }
 
-static int midi_in_read(CSOUND *csound,
-                        void *userData, unsigned char *buf, int nbytes)
+static int midi_in_read_timed(CSOUND *csound, void *userData,
+                              unsigned char *buf, int nbytes, int *age)
 {
     alsaMidiInputDevice *dev = (alsaMidiInputDevice*) userData;
-    int             bufpos = 0;
+    int             bufpos = 0, a = -1;
     unsigned char   c;
-    IGN(csound);
+    struct timespec now;
 
     if (!dev) { /* No devices */
       /*  fprintf(stderr, "No devices!"); */
       return 0;
     }
-    /* (void) csound; */
+    clock_gettime(CLOCK_MONOTONIC, &now);
     dev->bufpos = 0;
     while (dev && dev->dev) {
       while ((nbytes - bufpos) >= 3) {
         if (dev->bufpos >= dev->nbytes) { /* read from device */
-          int n = (int) snd_rawmidi_read(dev->dev, &(dev->buf[0]), BUF_SIZE);
+          int n;
+#ifdef ALSA_RAWMIDI_TSTAMP
+          if (dev->timed)
+            n = (int) snd_rawmidi_tread(dev->dev, &(dev->tstamp),
+                                        &(dev->buf[0]), BUF_SIZE);
+          else
+#endif
+            n = (int) snd_rawmidi_read(dev->dev, &(dev->buf[0]), BUF_SIZE);
           dev->bufpos = 0;
           if (n <= 0) {                   /* until there is no more data left */
             dev->nbytes = 0;
             break;
           }
           dev->nbytes = n;
+          a = (dev->timed ?
+               midi_age(csound, (long) (now.tv_sec - dev->tstamp.tv_sec),
+                        now.tv_nsec - dev->tstamp.tv_nsec) : -1);
         }
         c = dev->buf[dev->bufpos++];
         if (c >= (unsigned char) 0xF8) {          /* real time message */
+          if (age != NULL)
+            age[bufpos] = a;
           buf[bufpos++] = c;
           continue;
         }
@@ -1011,6 +1275,8 @@ static int midi_in_read(CSOUND *csound,
           buf[bufpos] = dev->prvStatus;
           buf[bufpos + 1] = dev->dat1;
           buf[bufpos + 2] = dev->dat2;
+          if (age != NULL)
+            age[bufpos] = age[bufpos + 1] = age[bufpos + 2] = a;
           bufpos += (dev->datreq + 1);
           continue;
         }
@@ -1027,6 +1293,12 @@ static int midi_in_read(CSOUND *csound,
     return bufpos;
 }
 
+static int midi_in_read(CSOUND *csound,
+                        void *userData, unsigned char *buf, int nbytes)
+{
+    return midi_in_read_timed(csound, userData, buf, nbytes, NULL);
+}
+
 static int midi_in_close(CSOUND *csound, void *userData)
 {
     int ret = 0, retval = 0;
@@ -1505,25 +1777,72 @@ static int alsaseq_in_open(CSOUND *csound, void **userData, const char *devName)
       return -1;
     }
     snd_midi_event_init(amidi->mev);
+    /* timestamp incoming events in real time on a private queue */
+    amidi->queue = snd_seq_alloc_queue(amidi->seq);
+    if (amidi->queue >= 0) {
+      snd_seq_port_info_t *pinfo;
+      snd_seq_port_info_alloca(&pinfo);
+      err = snd_seq_get_port_info(amidi->seq, port_id, pinfo);
+      if (err >= 0) {
+        snd_seq_port_info_set_timestamping(pinfo, 1);
+        snd_seq_port_info_set_timestamp_real(pinfo, 1);
+        snd_seq_port_info_set_timestamp_queue(pinfo, amidi->queue);
+        err = snd_seq_set_port_info(amidi->seq, port_id, pinfo);
+      }
+      if (err >= 0)
+        err = snd_seq_queue_status_malloc(&(amidi->qstatus));
+      if (err >= 0)
+        err = snd_seq_start_queue(amidi->seq, amidi->queue, NULL);
+      if (err < 0) {
+        if (amidi->qstatus != NULL)
+          snd_seq_queue_status_free(amidi->qstatus);
+        snd_seq_free_queue(amidi->seq, amidi->queue);
+        amidi->queue = -1;
+        csound->Warning(csound, Str("ALSASEQ: no input timestamps (%s)"),
+                        snd_strerror(err));
+      }
+      else
+        snd_seq_drain_output(amidi->seq);
+    }
     alsaseq_connect(csound, amidi, SND_SEQ_PORT_CAP_READ, devName);
     *userData = (void*) amidi;
     return OK;
 }
 
-static int alsaseq_in_read(CSOUND *csound,
-                           void *userData, unsigned char *buf, int nbytes)
+static int alsaseq_in_read_timed(CSOUND *csound, void *userData,
+                                 unsigned char *buf, int nbytes, int *age)
 {
-    int               err;
+    int               err, a = -1;
     alsaseqMidi       *amidi = (alsaseqMidi*) userData;
     snd_seq_event_t   *ev;
-    IGN(csound);
 
     err = snd_seq_event_input(amidi->seq, &ev);
     if (err <= 0)
       return 0;
     else
       err = snd_midi_event_decode(amidi->mev, buf, nbytes, ev);
-    return (err==-ENOENT) ? 0 : err;
+    if (err == -ENOENT)
+      return 0;
+    if (age != NULL && err > 0) {
+      if (amidi->queue >= 0 &&
+          (ev->flags & SND_SEQ_TIME_STAMP_MASK) == SND_SEQ_TIME_STAMP_REAL &&
+          snd_seq_get_queue_status(amidi->seq, amidi->queue,
+                                   amidi->qstatus) >= 0) {
+        const snd_seq_real_time_t *now =
+          snd_seq_queue_status_get_real_time(amidi->qstatus);
+        a = midi_age(csound, (long) now->tv_sec - (long) ev->time.time.tv_sec,
+                     (long) now->tv_nsec - (long) ev->time.time.tv_nsec);
+      }
+      for (nbytes = 0; nbytes < err; nbytes++)
+        age[nbytes] = a;
+    }
+    return err;
+}
+
+static int alsaseq_in_read(CSOUND *csound,
+                           void *userData, unsigned char *buf, int nbytes)
+{
+    return alsaseq_in_read_timed(csound, userData, buf, nbytes, NULL);
 }
 
 static int alsaseq_in_close(CSOUND *csound, void *userData)
@@ -1533,6 +1852,10 @@ static int alsaseq_in_close(CSOUND *csound, void *userData)
 
     if (amidi != NULL) {
       snd_midi_event_free(amidi->mev);
+      if (amidi->queue >= 0) {
+        snd_seq_free_queue(amidi->seq, amidi->queue);
+        snd_seq_queue_status_free(amidi->qstatus);
+      }
       snd_seq_close(amidi->seq);
       csound->Free(csound,amidi);
     }
@@ -1651,6 +1974,33 @@ PUBLIC int csoundModuleCreate(CSOUND *csound)
                                         CSOUNDCFG_INTEGER, 0, &minsched, &maxsched,
                                         Str("RT scheduler priority, alsa module"),
                                         NULL);
+    if (csound->CreateGlobalVariable(csound, "_alsaOptions",
+                                     sizeof(ALSA_OPTIONS)) == 0) {
+      ALSA_OPTIONS *opts =
+        (ALSA_OPTIONS*) csound->QueryGlobalVariable(csound, "_alsaOptions");
+      int minval, maxval;
+      opts->cpu = -1;
+      csound->CreateConfigurationVariable(csound, "alsa_mmap", &(opts->mmap),
+                                          CSOUNDCFG_BOOLEAN, 0, NULL, NULL,
+                                          Str("Use mmap transfers for ALSA "
+                                              "audio (default: off)"), NULL);
+      minval = 0; maxval = 2;
+      csound->CreateConfigurationVariable(csound, "alsa_wakeup", &(opts->wakeup),
+                                          CSOUNDCFG_INTEGER, 0, &minval, &maxval,
+                                          Str("ALSA mmap wakeups: 0 or 1: poll, "
+                                              "2: timer (default: 0)"), NULL);
+      minval = -1; maxval = CPU_SETSIZE - 1;
+      csound->CreateConfigurationVariable(csound, "alsa_cpu", &(opts->cpu),
+                                          CSOUNDCFG_INTEGER, 0, &minval, &maxval,
+                                          Str("Pin the ALSA audio thread to a "
+                                              "CPU (default: -1, off)"), NULL);
+      csound->CreateConfigurationVariable(csound, "alsa_fifo",
+                                          &(opts->fifo),
+                                          CSOUNDCFG_BOOLEAN, 0, NULL, NULL,
+                                          Str("Use SCHED_FIFO rather than "
+                                              "SCHED_RR for -+rtscheduler"),
+                                          NULL);
+    }
     maxlen = 64;
     alsaseq_client = (char*) csound->Calloc(csound, maxlen*sizeof(char));
     strcpy(alsaseq_client, "Csound");
@@ -1910,9 +2260,13 @@ PUBLIC int csoundModuleInit(CSOUND *csound)
 
     csCfgVariable_t *cfg;
     int priority;
+    ALSA_OPTIONS *opts =
+      (ALSA_OPTIONS*) csound->QueryGlobalVariable(csound, "_alsaOptions");
     if ((cfg=csound->QueryConfigurationVariable(csound, "rtscheduler")) != NULL) {
       priority = *(cfg->i.p);
-      if (priority != 0) set_scheduler_priority(csound, priority);
+      if (priority != 0)
+        set_scheduler_priority(csound, priority,
+                               (opts != NULL ? opts->fifo : 0));
       csound->DeleteConfigurationVariable(csound, "rtscheduler");
       csound->DestroyGlobalVariable(csound, "::priority");
     }
@@ -1947,6 +2301,7 @@ PUBLIC int csoundModuleInit(CSOUND *csound)
         csound->Message(csound, Str("rtmidi: ALSA Raw MIDI module enabled\n"));
       csound->SetExternalMidiInOpenCallback(csound, midi_in_open);
       csound->SetExternalMidiReadCallback(csound, midi_in_read);
+      csound->SetExternalMidiReadTimedCallback(csound, midi_in_read_timed);
       csound->SetExternalMidiInCloseCallback(csound, midi_in_close);
       csound->SetExternalMidiOutOpenCallback(csound, midi_out_open);
       csound->SetExternalMidiWriteCallback(csound, midi_out_write);
@@ -1959,6 +2314,7 @@ PUBLIC int csoundModuleInit(CSOUND *csound)
         csound->Message(csound, Str("rtmidi: ALSASEQ module enabled\n"));
       csound->SetExternalMidiInOpenCallback(csound, alsaseq_in_open);
       csound->SetExternalMidiReadCallback(csound, alsaseq_in_read);
+      csound->SetExternalMidiReadTimedCallback(csound, alsaseq_in_read_timed);
       csound->SetExternalMidiInCloseCallback(csound, alsaseq_in_close);
       csound->SetExternalMidiOutOpenCallback(csound, alsaseq_out_open);
       csound->SetExternalMidiWriteCallback(csound, alsaseq_out_write);
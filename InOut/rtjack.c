@@ -235,6 +235,12 @@ static void shutDownCallback(void *arg)
     RtJackGlobals *p = (RtJackGlobals*) arg;
 
     p->jackState = 2;
+    if (p->cbState == 1) {
+      /* wake up the Csound thread parked in callback mode */
+      p->cbState = 2;
+      p->cbResult = CSOUND_ERROR;
+      rtJack_Unlock(p->csound, &(p->cbLock));
+    }
     if (p->bufs != NULL) {
       int   i;
       for (i = 0; i < p->nBuffers; i++) {
@@ -421,19 +427,62 @@ static void openJackStreams(RtJackGlobals *p)
     }
     if (UNLIKELY(p->bufSize < 8 || p->bufSize > 32768))
       rtJack_Error(csound, -1, Str("invalid period size (-b)"));
+    if (p->callbackMode) {
+      /* the engine runs in the process callback: this needs realtime */
+      /* mode, as no API lock is taken, and whole -b buffers of whole */
+      /* control periods in each JACK period */
+      if (UNLIKELY(!oparms.realtime)) {
+        csound->Warning(csound, "%s",
+                        Str("rtjack: callback mode needs --realtime, "
+                            "using ring buffers\n"));
+        p->callbackMode = 0;
+      }
+      else if (UNLIKELY(oparms.numThreads > 1)) {
+        /* the -j threads are stopped at the end of csoundPerform(), */
+        /* which the process callback does not go through */
+        csound->Warning(csound, "%s",
+                        Str("rtjack: callback mode does not support -j, "
+                            "using ring buffers\n"));
+        p->callbackMode = 0;
+      }
+      else if (UNLIKELY(p->bufSize % csound->GetKsmps(csound) != 0 ||
+                        (int) jack_get_buffer_size(p->client)
+                        % p->bufSize != 0)) {
+        csound->Warning(csound,
+                        Str("rtjack: callback mode needs a JACK period (%d) "
+                            "that is a multiple of -b (%d), and -b a multiple "
+                            "of ksmps, using ring buffers\n"),
+                        (int) jack_get_buffer_size(p->client), p->bufSize);
+        p->callbackMode = 0;
+      }
+    }
     if (p->nBuffers < 2)
       p->nBuffers = 2;
-    if (UNLIKELY((unsigned int) (p->nBuffers * p->bufSize) > (unsigned int) 65536))
-      rtJack_Error(csound, -1, Str("invalid buffer size (-B)"));
-    if (UNLIKELY(((p->nBuffers - 1) * p->bufSize)
-                 < (int) jack_get_buffer_size(p->client)))
-      rtJack_Error(csound, -1, Str("buffer size (-B) is too small"));
+    if (!p->callbackMode) {
+      if (UNLIKELY((unsigned int) (p->nBuffers * p->bufSize)
+                   > (unsigned int) 65536))
+        rtJack_Error(csound, -1, Str("invalid buffer size (-B)"));
+      if (UNLIKELY(((p->nBuffers - 1) * p->bufSize)
+                   < (int) jack_get_buffer_size(p->client)))
+        rtJack_Error(csound, -1, Str("buffer size (-B) is too small"));
+    }
 
     /* register ports */
     rtJack_RegisterPorts(p);
 
     /* allocate ring buffers if not done yet */
-    if (p->bufs == NULL)
+    if (p->callbackMode) {
+      if (p->cbState < 0) {
+        /* the Csound thread waits on this lock while the process */
+        /* callback runs the performance */
+        if (UNLIKELY(rtJack_CreateLock(csound, &(p->cbLock)) != 0))
+          rtJack_Error(csound, CSOUND_MEMORY,
+                       Str("memory allocation failure"));
+        rtJack_TryLock(csound, &(p->cbLock));
+      }
+      p->cbState = 0;
+    }
+    else if (p->bufs == NULL)
       rtJack_AllocateBuffers(p);
 
     /* initialise ring buffers */
@@ -441,7 +490,7 @@ static void openJackStreams(RtJackGlobals *p)
     p->csndBufPos = 0;
     p->jackBufCnt = 0;
     p->jackBufPos = 0;
-    for (i = 0; i < p->nBuffers; i++) {
+    for (i = 0; p->bufs != NULL && i < p->nBuffers; i++) {
       rtJack_TryLock(p->csound, &(p->bufs[i]->csndLock));
       rtJack_Unlock(p->csound, &(p->bufs[i]->jackLock));
       if (p->inputEnabled) {
@@ -780,6 +829,60 @@ static int playopen_(CSOUND *csound, const csRtAudioParams *parm)
     return 0;
 }
 
+/* in callback mode the process callback runs the engine for the */
+/* whole JACK period; rtrecord_ and rtplay_, called from inside the */
+/* engine, then read and write the port buffers directly */
+
+static int processCallbackEngine(RtJackGlobals *p, jack_nframes_t nframes)
+{
+    CSOUND  *csound = p->csound;
+    int     i, ret;
+
+    if (p->inputEnabled) {
+      for (i = 0; i < p->nChannels_i; i++)
+        p->inPortBufs[i] = (jack_default_audio_sample_t*)
+          jack_port_get_buffer(p->inPorts[i], nframes);
+    }
+    if (p->outputEnabled) {
+      for (i = 0; i < p->nChannels; i++)
+        p->outPortBufs[i] = (jack_default_audio_sample_t*)
+          jack_port_get_buffer(p->outPorts[i], nframes);
+    }
+    p->cbFrames = (int) nframes;
+    p->cbInPos = p->cbOutPos = 0;
+    if (p->cbState == 1) {
+      if (UNLIKELY(p->jackState != 0 || (int) nframes % p->bufSize != 0)) {
+        /* sample rate or period size changed: stop the performance */
+        if (p->jackState == 0)
+          csound->ErrorMsg(csound, Str(" *** rtjack: JACK period size (%d) "
+                                       "changed in callback mode"),
+                           (int) nframes);
+        p->cbResult = CSOUND_ERROR;
+        p->cbState = 2;
+        rtJack_Unlock(csound, &(p->cbLock));
+      }
+      else {
+        while ((p->outputEnabled ? p->cbOutPos : p->cbInPos) < (int) nframes) {
+          if ((ret = csound->PerformKsmpsInCallback(csound)) != 0) {
+            /* end of performance: wake up the Csound thread */
+            p->cbResult = ret;
+            p->cbState = 2;
+            rtJack_Unlock(csound, &(p->cbLock));
+            break;
+          }
+        }
+      }
+    }
+    /* silence whatever the engine has not written */
+    if (p->outputEnabled && p->cbOutPos < (int) nframes) {
+      for (i = 0; i < p->nChannels; i++)
+        memset(&(p->outPortBufs[i][p->cbOutPos]), 0,
+               sizeof(jack_default_audio_sample_t)
+               * (size_t) ((int) nframes - p->cbOutPos));
+    }
+    return 0;
+}
+
 /* the process callback is called by the JACK client thread, */
 /* and copies data to the input and from the output ring buffers */
 
@@ -789,6 +892,8 @@ static int processCallback(jack_nframes_t nframes, void *arg)
     int           i, j, k, l;
 
     p = (RtJackGlobals*) arg;
+    if (p->callbackMode)
+      return processCallbackEngine(p, nframes);
     /* get pointers to port buffers */
     if (p->inputEnabled) {
       for (i = 0; i < p->nChannels_i; i++)
@@ -874,6 +979,22 @@ static CS_NOINLINE void rtJack_Restart(RtJackGlobals *p)
     openJackStreams(p);
 }
 
+/* callback mode: hand the engine over to the process callback, and */
+/* park the Csound thread until the callback reports the end of the */
+/* performance; then unwind to the performance function, which returns */
+/* what the callback's performance ended with (an error if JACK failed) */
+/* (any buffer passed to rtplay_ before the hand-over is dropped) */
+
+static CS_NOINLINE CS_NORETURN void rtJack_Handover(CSOUND *csound,
+                                                    RtJackGlobals *p)
+{
+    p->cbState = 1;
+    rtJack_Lock(csound, &(p->cbLock));
+    if (p->jackState != 0)
+      rtJack_Abort(csound, p->jackState);
+    csound->LongJmp(csound, (p->cbResult < 0 ? CSOUND_ERROR : 0));
+}
+
 /* get samples from ADC */
 
 static int rtrecord_(CSOUND *csound, MYFLT *inbuf_, int bytes_)
@@ -883,6 +1004,21 @@ static int rtrecord_(CSOUND *csound, MYFLT *inbuf_, int bytes_)
 
     p = (RtJackGlobals*) *(csound->GetRtPlayUserData(csound));
     if (UNLIKELY(p==NULL)) rtJack_Abort(csound, 0);
+    nframes = bytes_ / (p->nChannels_i * (int) sizeof(MYFLT));
+    if (p->cbState == 1) {
+      /* callback mode, called from the process callback */
+      if (UNLIKELY(p->cbInPos + nframes > p->cbFrames)) {
+        memset(inbuf_, 0, bytes_);
+        return bytes_;
+      }
+      for (k = 0; k < p->nChannels_i; k++) {
+        jack_default_audio_sample_t *srcp = &(p->inPortBufs[k][p->cbInPos]);
+        for (i = 0, j = k; i < nframes; i++, j += p->nChannels_i)
+          inbuf_[j] = (MYFLT) srcp[i];
+      }
+      p->cbInPos += nframes;
+      return bytes_;
+    }
     if (p->jackState != 0) {
       if (p->jackState < 0)
         openJackStreams(p);     /* open audio input */
@@ -891,7 +1027,8 @@ static int rtrecord_(CSOUND *csound, MYFLT *inbuf_, int bytes_)
       else
         rtJack_Abort(csound, p->jackState);
     }
-    nframes = bytes_ / (p->nChannels_i * (int) sizeof(MYFLT));
+    if (p->callbackMode)
+      rtJack_Handover(csound, p);
     bufpos = p->csndBufPos;
     bufcnt = p->csndBufCnt;
     for (i = j = 0; i < nframes; i++) {
@@ -948,6 +1085,25 @@ static void rtplay_(CSOUND *csound, const MYFLT *outbuf_, int bytes_)
     p = (RtJackGlobals*) *(csound->GetRtPlayUserData(csound));
     if (p == NULL)
       return;
+    nframes = bytes_ / (p->nChannels * (int) sizeof(MYFLT));
+    if (p->cbState == 1) {
+      /* callback mode, called from the process callback */
+      if (UNLIKELY(p->cbOutPos + nframes > p->cbFrames)) {
+        p->xrunFlag = 1;
+        return;
+      }
+      for (k = 0; k < p->nChannels; k++) {
+        jack_default_audio_sample_t *dstp = &(p->outPortBufs[k][p->cbOutPos]);
+        for (i = 0, j = k; i < nframes; i++, j += p->nChannels)
+          dstp[i] = (jack_default_audio_sample_t) outbuf_[j];
+      }
+      p->cbOutPos += nframes;
+      if (p->xrunFlag) {
+        p->xrunFlag = 0;
+        csound->Warning(csound, "%s", Str("rtjack: xrun in real time audio"));
+      }
+      return;
+    }
     if (p->jackState != 0) {
       if (p->jackState == 2)
         rtJack_Restart(p);
@@ -955,7 +1111,8 @@ static void rtplay_(CSOUND *csound, const MYFLT *outbuf_, int bytes_)
         rtJack_Abort(csound, p->jackState);
       return;
     }
-    nframes = bytes_ / (p->nChannels * (int) sizeof(MYFLT));
+    if (p->callbackMode)
+      rtJack_Handover(csound, p);
     for (i = j = 0; i < nframes; i++) {
       if (p->csndBufPos == 0) {
         /* wait until there is enough free space in ring buffer */
@@ -1030,6 +1187,10 @@ static CS_NOINLINE void rtclose_(CSOUND *csound)
       jack_deactivate(p.client);
       //}
       csound->Sleep((size_t) 50);
+      if (pp->cbState >= 0) {
+        rtJack_DestroyLock(csound, &(pp->cbLock));
+        pp->cbState = -1;
+      }
       /* unregister and free all ports */
       if (p.inPorts != NULL) {
         for (i = 0; i < p.nChannels_i; i++) {
@@ -1199,6 +1360,15 @@ PUBLIC int csoundModuleCreate(CSOUND *csound)
                                         (void*) &(p->sleepTime),
                                         CSOUNDCFG_INTEGER, 0, &i, &j,
                                         Str("Deprecated"), NULL);
+    /* run the engine in the process callback */
+    p->callbackMode = 0;
+    p->cbState = -1;
+    csound->CreateConfigurationVariable(csound, "jack_callback",
+                                        (void*) &(p->callbackMode),
+                                        CSOUNDCFG_BOOLEAN, 0, NULL, NULL,
+                                        Str("Run Csound in the JACK process "
+                                            "callback, with no ring buffers "
+                                            "(needs --realtime)"), NULL);
     /* done */
     p->listclient = NULL;
 
@@ -1252,27 +1422,44 @@ PUBLIC int csoundModuleCreate(CSOUND *csound)
 }
 
 #define JACK_MIDI_BUFFSIZE 1024
+#define JACK_MIDI_CHUNK 64
 typedef struct jackMidiDevice_ {
   jack_client_t *client;
   jack_port_t *port;
   CSOUND *csound;
   void *cb;
+  double srratio;         /* csound sr / JACK sr, for timestamps */
 } jackMidiDevice;
 
+/* MIDI input is queued with the JACK frame time of each byte */
+typedef struct jackMidiByte_ {
+  jack_nframes_t time;
+  unsigned char data;
+} jackMidiByte;
+
 int MidiInProcessCallback(jack_nframes_t nframes, void *userData){
 
     jack_midi_event_t event;
     jackMidiDevice *dev = (jackMidiDevice *) userData;
     CSOUND *csound = dev->csound;
+    jackMidiByte tmp[JACK_MIDI_CHUNK];
+    jack_nframes_t start = jack_last_frame_time(dev->client);
     int n = 0;
     while(jack_midi_event_get(&event,
                               jack_port_get_buffer(dev->port,nframes),
                               n++) == 0) {
-      if (UNLIKELY(csound->WriteCircularBuffer(csound,dev->cb,
-                                              event.buffer,event.size)
-                  != (int) event.size)){
-        csound->Warning(csound, "%s", Str("Jack MIDI module: buffer overflow"));
-        return 1;
+      size_t i = 0, j;
+      while (i < event.size) {
+        for (j = 0; j < JACK_MIDI_CHUNK && i < event.size; j++, i++) {
+          tmp[j].time = start + event.time;
+          tmp[j].data = event.buffer[i];
+        }
+        if (UNLIKELY(csound->WriteCircularBuffer(csound,dev->cb,tmp,(int) j)
+                     != (int) j)){
+          csound->Warning(csound, "%s",
+                          Str("Jack MIDI module: buffer overflow"));
+          return 1;
+        }
       }
     }
     return 0;
@@ -1320,7 +1507,9 @@ static int midi_in_open(CSOUND *csound,
     dev->csound = csound;
     dev->cb = csound->CreateCircularBuffer(csound,
                                            JACK_MIDI_BUFFSIZE,
-                                           sizeof(char));
+                                           sizeof(jackMidiByte));
+    dev->srratio = (double) csound->GetSr(csound)
+                   / (double) jack_get_sample_rate(jack_client);
 
     if (UNLIKELY(jack_set_process_callback(jack_client,
                                           MidiInProcessCallback,
@@ -1356,11 +1545,31 @@ static int midi_in_open(CSOUND *csound,
     return OK;
 }
 
+static int midi_in_read_timed(CSOUND *csound, void *userData,
+                              unsigned char *buf, int nbytes, int *age)
+{
+    jackMidiDevice *dev = (jackMidiDevice *) userData;
+    jackMidiByte tmp[JACK_MIDI_CHUNK];
+    jack_nframes_t now = jack_frame_time(dev->client);
+    int n = 0, i, m;
+    while (n < nbytes) {
+      m = nbytes - n < JACK_MIDI_CHUNK ? nbytes - n : JACK_MIDI_CHUNK;
+      m = csound->ReadCircularBuffer(csound,dev->cb,tmp,m);
+      for (i = 0; i < m; i++, n++) {
+        buf[n] = tmp[i].data;
+        if (age != NULL)
+          age[n] = (int) ((double) (now - tmp[i].time) * dev->srratio);
+      }
+      if (m < JACK_MIDI_CHUNK)
+        break;
+    }
+    return n;
+}
+
 static int midi_in_read(CSOUND *csound,
                         void *userData, unsigned char *buf, int nbytes)
 {
-    jackMidiDevice *dev = (jackMidiDevice *) userData;
-    return csound->ReadCircularBuffer(csound,dev->cb,buf,nbytes);
+    return midi_in_read_timed(csound, userData, buf, nbytes, NULL);
 }
 
 static int midi_in_close(CSOUND *csound, void *userData){
@@ -1616,6 +1825,7 @@ PUBLIC int csoundModuleInit(CSOUND *csound)
     {
       csound->SetExternalMidiInOpenCallback(csound, midi_in_open);
       csound->SetExternalMidiReadCallback(csound, midi_in_read);
+      csound->SetExternalMidiReadTimedCallback(csound, midi_in_read_timed);
       csound->SetExternalMidiInCloseCallback(csound, midi_in_close);
       csound->SetExternalMidiOutOpenCallback(csound, midi_out_open);
       csound->SetExternalMidiWriteCallback(csound, midi_out_write);
@@ -0,0 +1,349 @@
+/*
+    delayline.c:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Multi-tap delay lines, shared by the vdelay, multitap, delayr/deltap
+ * and delay opcodes.  Opcodes whose lines are fed back within a block
+ * (flanger and wguide from the output of the previous sample, the combs
+ * and allpasses of freeverb and the lines of reverbsc from each other)
+ * cannot write a block before reading it, and keep their own buffers.
+ *
+ * A line is a buffer of a power of two samples, indexed by masking, long
+ * enough to hold its nominal length, a block and an interpolation window,
+ * so that blocks are written with at most two copies and read with no
+ * wrap-around tests.  Delays are still taken modulo the nominal length,
+ * as they were in the circular buffers of the opcodes, for the samples
+ * read both after and before the block is written.
+ *
+ * Taps are read a block at a time, with a kernel for each interpolation,
+ * rate of the delay and output mode.  The kernels have no branches, so
+ * that the compiler can vectorise them and gather the points read (the
+ * buffer is passed as a restrict parameter for that).  A k-rate delay
+ * whose points do not cross the end of the buffer is read as a plain
+ * array instead.  Positions are computed in MYFLT, as vdelay and deltapi
+ * did; vdelayx and deltapx (CS_DELAY_SINC and CS_DELAY_CUBICX) keep them
+ * in double precision.
+ */
+
+#include "csoundCore.h"
+#include "delayline.h"
+#include <math.h>
+
+#define DL_ALIGN    64
+
+static int32 dl_size(int32 len, int32 maxblock)
+{
+    int32   size = 16;
+
+    /* the line, a block, and the points on either side of a tap */
+    while (size < len + maxblock + 4)
+      size <<= 1;
+    return size;
+}
+
+CS_DELAYLINE *csoundDelayLineCreate(CSOUND *csound, AUXCH *aux, int count,
+                                    const int32 *len, int32 maxblock)
+{
+    CS_DELAYLINE *line;
+    size_t  nbytes;
+    char    *mem;
+    int     i;
+
+    if (UNLIKELY(count < 1 || maxblock < 1))
+      return NULL;
+    nbytes = (sizeof(CS_DELAYLINE) * count + DL_ALIGN - 1) & ~(DL_ALIGN - 1);
+    for (i = 0; i < count; i++) {
+      if (UNLIKELY(len[i] < 1 || len[i] > 0x10000000 - maxblock))
+        return NULL;
+      nbytes += sizeof(MYFLT) * dl_size(len[i], maxblock);
+    }
+    nbytes += DL_ALIGN;
+    if (aux->auxp == NULL || aux->size < nbytes)
+      csound->AuxAlloc(csound, nbytes, aux);
+    else
+      memset(aux->auxp, 0, nbytes);
+    line = (CS_DELAYLINE*) aux->auxp;
+    mem = (char*) aux->auxp +
+      ((sizeof(CS_DELAYLINE) * count + DL_ALIGN - 1) & ~(DL_ALIGN - 1));
+    mem += (DL_ALIGN - ((uintptr_t) mem & (DL_ALIGN - 1))) & (DL_ALIGN - 1);
+    for (i = 0; i < count; i++) {
+      line[i].buf = (MYFLT*) mem;
+      line[i].size = dl_size(len[i], maxblock);
+      line[i].mask = line[i].size - 1;
+      line[i].len = len[i];
+      line[i].wpos = 0;
+      mem += sizeof(MYFLT) * line[i].size;
+    }
+    return line;
+}
+
+void csoundDelayLineWrite(CSOUND *csound, CS_DELAYLINE *line,
+                          const MYFLT *in, int32 nsmps)
+{
+    int32   n1 = line->size - line->wpos;
+
+    IGN(csound);
+    if (n1 > nsmps)
+      n1 = nsmps;
+    memcpy(line->buf + line->wpos, in, sizeof(MYFLT) * n1);
+    if (nsmps > n1)
+      memcpy(line->buf, in + n1, sizeof(MYFLT) * (nsmps - n1));
+    line->wpos = (line->wpos + nsmps) & line->mask;
+}
+
+/* csoundDelayLineWrap() in MYFLT, as vdelay and deltapi computed their
+   positions */
+
+static inline MYFLT dl_wrap(MYFLT d, int32 c, int32 len, MYFLT rlen)
+{
+    MYFLT   x = d - (MYFLT) c;
+
+    x -= (MYFLT) (int32) (x * rlen) * len;      /* in (-len, len) */
+    x += (MYFLT) ((x < FL(0.0)) - (x >= len)) * len;
+    return x + (MYFLT) c;
+}
+
+/* the delay of sample n, taken modulo the length */
+
+#define DL_POS(ARATE)                                                   \
+    c = ahead + (int32) n + 1;                                          \
+    c = (c > 0 ? c : 0);                                                \
+    eff = dl_wrap((ARATE ? del[n] : del[0]) * scale, c, len, rlen);
+
+/* the interpolations between point I and the next one, at fraction F */
+
+#define DL_LIN(I, F)                                                    \
+    {                                                                   \
+      MYFLT x0 = b[(I) & mask], x1 = b[((I) + 1) & mask];               \
+      v = x0 + (F) * (x1 - x0);                                         \
+    }
+
+/* as in vdelay3, optimized by Istvan Varga (Oct 2001) */
+
+#define DL_CUB(I, F)                                                    \
+    {                                                                   \
+      MYFLT w, x, y, z;                                                 \
+      z = (F) * (F); z--; z *= FL(0.1666666667);                        \
+      y = (F); y++; w = (y *= FL(0.5)); w--;                            \
+      x = FL(3.0) * z; y -= x; w -= z; x -= (F);                        \
+      v = (w * b[((I) - 1) & mask] + x * b[(I) & mask] +                \
+           y * b[((I) + 1) & mask] + z * b[((I) + 2) & mask]) * (F) +   \
+        b[(I) & mask];                                                  \
+    }
+
+/* sample n at delay eff: truncated for no interpolation, or split into
+   the index of the point before it and the fraction after it */
+
+#define DL_SPLIT                                                        \
+    MYFLT   pos = (MYFLT) n - eff, frac;                                \
+    int32   i = (int32) pos;                                            \
+    i -= (pos < i);                                                     \
+    frac = pos - i;                                                     \
+    i += start;
+
+#define DL_READ0    v = b[(start + n - (int32) eff) & mask];
+#define DL_READ1    { DL_SPLIT DL_LIN(i, frac) }
+#define DL_READ3    { DL_SPLIT DL_CUB(i, frac) }
+
+#define DL_KERNEL(NAME, ARATE, READ, ADD)                               \
+static void NAME(const CS_DELAYLINE *l, const MYFLT *CS_RESTRICT b,     \
+                 const CS_DELAYTAP *tp, int32 start, int32 ahead,       \
+                 int32 offset, int32 nsmps)                             \
+{                                                                       \
+    const MYFLT *del = tp->del;                                         \
+    MYFLT   *out = tp->out, scale = tp->scale, gain = tp->gain;       \
+    MYFLT   rlen = FL(1.0) / l->len, eff, v;                            \
+    int32   len = l->len, mask = l->mask, c, n;                         \
+    for (n = offset; n < nsmps; n++) {                                  \
+      DL_POS(ARATE)                                                     \
+      READ                                                              \
+      out[n] = (ADD ? out[n] + gain * v : gain * v);                    \
+    }                                                                   \
+}
+
+/* a k-rate delay the same over the block, on points that do not wrap
+   around the buffer: read as a plain array, with no gathers */
+
+#define DL_SPAN(NAME, READ, ADD)                                        \
+static void NAME(const MYFLT *CS_RESTRICT b, MYFLT *CS_RESTRICT out,    \
+                 MYFLT frac, MYFLT gain, int32 offset, int32 nsmps)     \
+{                                                                       \
+    const int32 mask = -1;                                              \
+    MYFLT   v;                                                          \
+    int32   n;                                                          \
+    for (n = offset; n < nsmps; n++) {                                  \
+      READ                                                              \
+      out[n] = (ADD ? out[n] + gain * v : gain * v);                    \
+    }                                                                   \
+}
+
+DL_KERNEL(dl_k0, 0, DL_READ0, 0)
+DL_KERNEL(dl_a0, 1, DL_READ0, 0)
+DL_KERNEL(dl_k0_add, 0, DL_READ0, 1)
+DL_KERNEL(dl_a0_add, 1, DL_READ0, 1)
+DL_KERNEL(dl_k1, 0, DL_READ1, 0)
+DL_KERNEL(dl_a1, 1, DL_READ1, 0)
+DL_KERNEL(dl_k1_add, 0, DL_READ1, 1)
+DL_KERNEL(dl_a1_add, 1, DL_READ1, 1)
+DL_KERNEL(dl_k3, 0, DL_READ3, 0)
+DL_KERNEL(dl_a3, 1, DL_READ3, 0)
+DL_KERNEL(dl_k3_add, 0, DL_READ3, 1)
+DL_KERNEL(dl_a3_add, 1, DL_READ3, 1)
+DL_SPAN(dl_s0, v = b[n & mask];, 0)
+DL_SPAN(dl_s0_add, v = b[n & mask];, 1)
+DL_SPAN(dl_s1, DL_LIN(n, frac), 0)
+DL_SPAN(dl_s1_add, DL_LIN(n, frac), 1)
+DL_SPAN(dl_s3, DL_CUB(n, frac), 0)
+DL_SPAN(dl_s3_add, DL_CUB(n, frac), 1)
+
+typedef void (*DL_KERN)(const CS_DELAYLINE *, const MYFLT *,
+                        const CS_DELAYTAP *, int32, int32, int32, int32);
+typedef void (*DL_SPANK)(const MYFLT *, MYFLT *, MYFLT, MYFLT,
+                         int32, int32);
+
+/* [none, linear, cubic][k-rate, a-rate][set, add] */
+static const DL_KERN dl_kernels[3][2][2] = {
+    { { dl_k0, dl_k0_add }, { dl_a0, dl_a0_add } },
+    { { dl_k1, dl_k1_add }, { dl_a1, dl_a1_add } },
+    { { dl_k3, dl_k3_add }, { dl_a3, dl_a3_add } }
+};
+
+/* [none, linear, cubic][set, add] */
+static const DL_SPANK dl_spans[3][2] = {
+    { dl_s0, dl_s0_add }, { dl_s1, dl_s1_add }, { dl_s3, dl_s3_add }
+};
+
+/* the first point of a k-rate tap read as a span, or -1 */
+
+static int32 dl_span(const CS_DELAYLINE *l, const CS_DELAYTAP *tp,
+                     int32 start, int32 ahead, int32 offset, int32 nsmps,
+                     int interp, MYFLT *frac)
+{
+    MYFLT   d = *tp->del * tp->scale, rlen = FL(1.0) / l->len, eff, pos;
+    int32   c0 = ahead + offset + 1, c1 = ahead + nsmps, j;
+
+    c0 = (c0 > 0 ? c0 : 0);
+    c1 = (c1 > 0 ? c1 : 0);
+    eff = dl_wrap(d, c0, l->len, rlen);
+    if (eff != dl_wrap(d, c1, l->len, rlen))
+      return -1;                        /* wraps within the block */
+    pos = -eff;
+    j = (int32) pos;
+    j -= (pos < j);
+    *frac = pos - j;
+    if (interp == 0)
+      j = -(int32) eff;
+    j = (start + j) & l->mask;
+    return (j >= 1 && j + nsmps + 2 <= l->size ? j : -1);
+}
+
+/* windowed sinc of vdelayx and deltapx, the window summed over points
+   with no dependency between them; samples at integer positions are
+   read as they are.  A window of 0 is the cubic interpolation of deltapx
+   with a window of 4.  Positions are in double, as in those opcodes. */
+
+static void dl_sinc(const CS_DELAYLINE *l, const MYFLT *CS_RESTRICT b,
+                    const CS_DELAYTAP *tp, int32 start, int32 ahead,
+                    int32 offset, int32 nsmps, int wsize)
+{
+    const MYFLT *del = tp->del;
+    MYFLT   *out = tp->out, gain = tp->gain, v;
+    int32   len = l->len, mask = l->mask, c, i, n, k;
+    int32   i2 = wsize >> 1;
+    double  rlen = 1.0 / len, scale = tp->scale, pos;
+    double  d2x = (wsize ? csoundDelayLineD2x(wsize) : 0.0);
+
+    for (n = offset; n < nsmps; n++) {
+      double  x1, d, w, n1 = 0.0;
+      c = ahead + n + 1;
+      c = (c > 0 ? c : 0);
+      pos = (double) n - csoundDelayLineWrap((double) del[tp->arate ? n : 0]
+                                             * scale, c, len, rlen);
+      i = (int32) pos;
+      i -= (pos < i);
+      x1 = pos - i;
+      i += start;
+      if (!wsize) {
+        double  a0, a1, a2, am1 = x1;
+        a0  = am1 * am1; a2 = (am1 * a0 - am1) / 6.0;          /* +2 */
+        a1  = 0.5 * (a0 + am1) - 3.0 * a2;                      /* +1 */
+        am1 = 0.5 * (a0 - am1) - a2;                            /* -1 */
+        a0  = 3.0 * a2 - a0; a0++;                              /*  0 */
+        v = (MYFLT) (am1 * (double) b[(i - 1) & mask] +
+                     a0 * (double) b[i & mask] +
+                     a1 * (double) b[(i + 1) & mask] +
+                     a2 * (double) b[(i + 2) & mask]);
+      }
+      else if (x1 * (1.0 - x1) > 0.00000001) {
+        i += 1 - i2;
+        d = (double) (1 - i2) - x1;
+        for (k = 0; k < wsize; k++) {
+          double  dk = d + k;
+          w = 1.0 - dk * dk * d2x;
+          w *= w / dk;
+          n1 += (double) (1 - 2 * (k & 1)) * w * (double) b[(i + k) & mask];
+        }
+        v = (MYFLT) (n1 * sin(PI * x1) / PI);
+      }
+      else                                      /* integer sample */
+        v = b[(i + (x1 > 0.5)) & mask];
+      out[n] = (tp->add ? out[n] + gain * v : gain * v);
+    }
+}
+
+void csoundDelayLineRead(CSOUND *csound, CS_DELAYLINE *line,
+                         const CS_DELAYTAP *taps, int ntaps, int32 start,
+                         int32 offset, int32 nsmps, int interp, int wsize)
+{
+    int32   ahead = (start - line->wpos) & line->mask;
+    int     t;
+
+    IGN(csound);
+    if (UNLIKELY(nsmps <= offset))
+      return;
+    /* samples from start on not written yet, or already written if < 0 */
+    if (ahead >= (line->size >> 1))
+      ahead -= line->size;
+    start &= line->mask;
+    if (interp == CS_DELAY_SINC || interp == CS_DELAY_CUBICX) {
+      wsize = ((wsize + 2) >> 2) << 2;
+      wsize = (interp == CS_DELAY_CUBICX ? 0 : wsize < 4 ? 4 :
+               wsize > CS_DELAY_MAXWIN ? CS_DELAY_MAXWIN : wsize);
+      for (t = 0; t < ntaps; t++)
+        dl_sinc(line, line->buf, &taps[t], start, ahead, offset, nsmps, wsize);
+      return;
+    }
+    interp = (interp == CS_DELAY_CUBIC ? 2 : interp == CS_DELAY_LINEAR);
+    for (t = 0; t < ntaps; t++) {
+      const CS_DELAYTAP *tp = &taps[t];
+      MYFLT   frac;
+      int32   j;
+      if (!tp->arate &&
+          (j = dl_span(line, tp, start, ahead, offset, nsmps, interp,
+                       &frac)) >= 0)
+        dl_spans[interp][tp->add != 0](line->buf + j, tp->out, frac,
+                                       tp->gain, offset, nsmps);
+      else
+        dl_kernels[interp][tp->arate != 0][tp->add != 0]
+          (line, line->buf, tp, start, ahead, offset, nsmps);
+    }
+}
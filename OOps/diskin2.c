@@ -24,6 +24,7 @@
 #include "csoundCore.h"
 #include "soundio.h"
 #include "diskin2.h"
+#include "resample.h"
 #include <math.h>
 #include <inttypes.h>
 
@@ -150,6 +151,24 @@ static inline void diskin2_get_sample(CSOUND *csound,
     }
 }
 
+/* resample from the file rate to the orchestra rate with the polyphase */
+/* filter of the library, which replaces the sinc window at transpose 1 */
+
+static inline void diskin2_resample(CSOUND *csound,
+                                    DISKIN2 *p, int32_t ndx, int32_t n)
+{
+    MYFLT   *coefs = (MYFLT*) p->auxRs.auxp;
+    double  frac_d;
+    int32_t i;
+
+    frac_d = (double)((int32_t)(p->pos_frac & (int64_t)POS_FRAC_MASK))
+      * (1.0 / (double)POS_FRAC_SCALE);
+    csoundResamplerCoefs(csound, p->rs, frac_d, coefs);
+    ndx += (int32_t)(1 - (p->rsTaps >> 1));
+    for (i = 0; i < p->rsTaps; i++, ndx++)
+      diskin2_get_sample(csound, p, ndx, n, coefs[i]);
+}
+
 /* ------------- set up fast sine generator ------------- */
 /* Input args:                                            */
 /*   a: amplitude                                         */
@@ -197,6 +216,8 @@ static int32_t diskin2_calc_buffer_size(DISKIN2 *p, int32_t n_monoSamps)
     /* limit to sane range */
     if (i < p->winSize)
       i = p->winSize;
+    if (i < p->rsTaps)
+      i = p->rsTaps;
     else if (i > 1048576)
       i = 1048576;
     /* buffer size must be an integer power of two, so round up */
@@ -390,6 +411,24 @@ static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
                         sfinfo.samplerate, MYFLT2LONG(csound->esr));
       }
     }
+    /* with sinc interpolation, sample rate conversion at transpose 1 uses */
+    /* the shared polyphase filter, of a length set by the window size */
+    p->rs = NULL;
+    p->rsTaps = 0;
+    p->rsInc = (int64_t)0;
+    if (p->winSize > 4 && p->warpScale != 1.0) {
+      int32_t q = (p->winSize + 15) >> 4;
+      p->rs = csoundResamplerCreate(csound, (MYFLT)sfinfo.samplerate,
+                                    csound->esr, 0, (q > 8 ? 8 : q));
+      if (p->rs != NULL) {
+        double f = p->warpScale * (double)POS_FRAC_SCALE;
+        p->rsTaps = csoundResamplerCoefs(csound, p->rs, 0.0, NULL);
+        p->rsInc = (int64_t)(f + 0.5);
+        n = p->rsTaps * (int32_t)sizeof(MYFLT);
+        if (n != (int32_t)p->auxRs.size)
+          csound->AuxAlloc(csound, (int32_t) n, &(p->auxRs));
+      }
+    }
     /* wrap mode */
     p->wrapMode = (*(p->iWrapMode) == FL(0.0) ? 0 : 1);
     if (UNLIKELY(p->fileLength < 1L))
@@ -636,6 +675,14 @@ int32_t diskin2_perf_synchronous(CSOUND *csound, DISKIN2 *p)
       }
       break;
     default:                  /* ---- sinc interpolation ---- */
+      if (p->rs != NULL && p->pos_frac_inc == p->rsInc) {
+        for (nn = offset; nn < nsmps; nn++) {
+          diskin2_resample(csound, p, ndx, nn);
+          /* update file position */
+          diskin2_file_pos_inc(p, &ndx);
+        }
+        break;
+      }
       wsized2 = p->winSize >> 1;
       nn = POS_FRAC_SCALE + (POS_FRAC_SCALE >> 12);
       if (p->pos_frac_inc > (int64_t) nn ||
@@ -744,27 +791,20 @@ int32_t diskin2_perf_synchronous(CSOUND *csound, DISKIN2 *p)
     return NOTOK;
 }
 
-int checkspace(void *p, int writeCheck);
+/* render nsmps frames to p->aOut_buf, which points into the circular */
+/* buffer                                                              */
 
-int32_t diskin_file_read(CSOUND *csound, DISKIN2 *p)
+static void diskin_file_fill(CSOUND *csound, DISKIN2 *p, int32_t nsmps)
 {
-    /* nsmps is bufsize in frames */
-  int32_t nsmps = checkspace(p->cb,1); // suggest in issue #1535 (no patch supplied though, but seems to work)
-   //p->aOut_bufsize;// - p->h.insdshead->ksmps_offset;
     int32_t i, nn;
     int32_t chn, chans = p->nChannels;
     double  d, frac_d, x, c, v, pidwarp_d;
     MYFLT   frac, a0, a1, a2, a3, onedwarp, winFact;
     int32_t ndx;
     int32_t wsized2, warp;
-    MYFLT   *aOut = (MYFLT *)p->aOut_buf; /* needs to be allocated */
+    MYFLT   *aOut = (MYFLT *)p->aOut_buf;
     MYFLT transpose = p->transpose;
 
-    if (UNLIKELY(p->fdch.fd == NULL) ) goto file_error;
-    if (!p->initDone && !p->SkipInit) {
-      return csound->PerfError(csound, &(p->h),
-                               Str("diskin2: not initialised"));
-    }
     if (transpose != p->prv_kTranspose) {
       double  f;
       p->prv_kTranspose = transpose;
@@ -824,6 +864,14 @@ int32_t diskin_file_read(CSOUND *csound, DISKIN2 *p)
       }
       break;
     default:                  /* ---- sinc interpolation ---- */
+      if (p->rs != NULL && p->pos_frac_inc == p->rsInc) {
+        for (nn = 0; nn < nsmps; nn++) {
+          diskin2_resample(csound, p, ndx, nn);
+          /* update file position */
+          diskin2_file_pos_inc(p, &ndx);
+        }
+        break;
+      }
       wsized2 = p->winSize >> 1;
       nn = POS_FRAC_SCALE + (POS_FRAC_SCALE >> 12);
       if (p->pos_frac_inc > (int64_t) nn ||
@@ -922,29 +970,76 @@ int32_t diskin_file_read(CSOUND *csound, DISKIN2 *p)
         diskin2_file_pos_inc(p, &ndx);
       }
     }
-    {
-      /* write to circular buffer */
-      int32_t lc, mc=0, nc=nsmps*p->nChannels;
-      int32_t *start = csound->QueryGlobalVariable(csound,"DISKIN_THREAD_START");
-      do{
-        lc =  csound->WriteCircularBuffer(csound, p->cb, &aOut[mc], nc);
-        nc -= lc;
-        mc += lc;
-      } while(nc && *start);
+}
+
+int32_t diskin_file_read(CSOUND *csound, DISKIN2 *p)
+{
+    CS_CIRCULAR_REGION r;
+    MYFLT   *aOut = p->aOut_buf;
+    int32_t i, frames, chans = p->nChannels;
+
+    if (UNLIKELY(p->fdch.fd == NULL) ) goto file_error;
+    if (!p->initDone && !p->SkipInit) {
+      return csound->PerfError(csound, &(p->h),
+                               Str("diskin2: not initialised"));
     }
+    /* render whole frames straight into the free space of the circular */
+    /* buffer, up to the output buffer size; as the buffer size is a    */
+    /* multiple of the frame size, a span only ends within a frame      */
+    /* where the region ends                                            */
+    csound->WriteCircularBufferReserve(csound, p->cb,
+                                       (int) p->aOut_bufsize * chans, &r);
+    for (i = 0; i < 2; i++) {
+      if ((frames = r.items[i] / chans) == 0)
+        break;
+      p->aOut_buf = (MYFLT*) r.data[i];
+      diskin_file_fill(csound, p, frames);
+      csound->WriteCircularBufferCommit(csound, p->cb, frames * chans);
+    }
+    p->aOut_buf = aOut;
     return OK;
  file_error:
     csound->ErrorMsg(csound, Str("diskin2: file descriptor closed or invalid\n"));
     return NOTOK;
 }
 
+/* deinterleave frames offset to nsmps - 1 from the circular buffer */
+/* in place to the outputs out[chn], or zeros where data is missing  */
+
+static void diskin2_read_cb(CSOUND *csound, void *cb, int32_t chans,
+                            MYFLT **out, uint32_t offset, uint32_t nsmps,
+                            MYFLT scl)
+{
+    CS_CIRCULAR_REGION r;
+    uint32_t nn = offset, frames;
+    int32_t  n, chn = 0;
+
+    frames = csound->ReadCircularBufferReserve(csound, cb,
+                                               (nsmps - offset) * chans,
+                                               &r) / chans;
+    for (n = 0; n < 2; n++) {
+      MYFLT   *in = (MYFLT*) r.data[n];
+      int32_t cnt = r.items[n];
+      for ( ; cnt > 0 && nn < offset + frames; cnt--) {
+        out[chn][nn] = scl * *in++;
+        if (++chn == chans) {
+          chn = 0;
+          nn++;
+        }
+      }
+    }
+    csound->ReadCircularBufferCommit(csound, cb, frames * chans);
+    for ( ; nn < nsmps; nn++)
+      for (chn = 0; chn < chans; chn++)
+        out[chn][nn] = FL(0.0);
+}
+
 
 int32_t diskin2_perf_asynchronous(CSOUND *csound, DISKIN2 *p)
 {
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t nn, nsmps = CS_KSMPS;
-    MYFLT samp;
     int32_t chn;
     void *cb = p->cb;
     int32_t chans = p->nChannels;
@@ -962,17 +1057,7 @@ int32_t diskin2_perf_asynchronous(CSOUND *csound, DISKIN2 *p)
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
     }
-    for (nn = offset; nn < nsmps; nn++){
-
-      for (chn = 0; chn < chans; chn++) {
-        //int32_t i =0;
-        //do {
-        // i =
-        csound->ReadCircularBuffer(csound, cb, &samp, 1);
-        //} while(i==0);
-        p->aOut[chn][nn] = csound->e0dbfs*samp;
-      }
-    }
+    diskin2_read_cb(csound, cb, chans, p->aOut, offset, nsmps, csound->e0dbfs);
     return OK;
 }
 
@@ -1993,11 +2078,11 @@ int32_t diskin2_perf_asynchronous_array(CSOUND *csound, DISKIN2_ARRAY *p)
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t nn, nsmps = CS_KSMPS, ksmps = CS_KSMPS;
-    MYFLT samp;
     int32_t chn;
     void *cb = p->cb;
     int32_t chans = p->nChannels;
     MYFLT *aOut = (MYFLT *) p->aOut->data;
+    MYFLT *outs[DISKIN2_MAXCHN];
 
     if (offset || early) {
       for (chn = 0; chn < chans; chn++)
@@ -2011,17 +2096,9 @@ int32_t diskin2_perf_asynchronous_array(CSOUND *csound, DISKIN2_ARRAY *p)
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
     }
-    for (nn = offset; nn < nsmps; nn++){
-
-      for (chn = 0; chn < chans; chn++) {
-        //int32_t i =0;
-        //do {
-        // i =
-        csound->ReadCircularBuffer(csound, cb, &samp, 1);
-        //} while(i==0);
-        aOut[chn*ksmps+nn] = csound->e0dbfs*samp;
-      }
-    }
+    for (chn = 0; chn < chans; chn++)
+      outs[chn] = &aOut[chn*ksmps];
+    diskin2_read_cb(csound, cb, chans, outs, offset, nsmps, csound->e0dbfs);
     return OK;
 }
 
@@ -3445,6 +3445,44 @@ int32_t isPowTwo(int32_t N) {
   return (N != 0) ? !(N & (N - 1)) : 0;
 }
 
+/* pffft real transforms need N = 32 * 2^a * 3^b * 5^c */
+static int32_t pffft_size_ok(int32_t N) {
+  if (N <= 0 || N % 32)
+    return 0;
+  while (N % 2 == 0) N /= 2;
+  while (N % 3 == 0) N /= 3;
+  while (N % 5 == 0) N /= 5;
+  return N == 1;
+}
+
+/* non power-of-two sizes handled by the mixed-radix code in mxfft.c */
+typedef struct {
+  CS_FFT_PLAN *plan;
+  MYFLT *work;
+} FFT_PLAN_SETUP;
+
+static void *plan_setup(CSOUND *csound, int32_t FFTsize) {
+  FFT_PLAN_SETUP *ps;
+  if (UNLIKELY(FFTsize & 1)) {
+    csound->Warning(csound,
+                    Str("csoundRealFFT2Setup(): odd FFT size %d not supported,"
+                        " use csoundRealFFTnp2()"), FFTsize);
+    return NULL;
+  }
+  ps = (FFT_PLAN_SETUP *) csound->Malloc(csound, sizeof(FFT_PLAN_SETUP));
+  ps->plan = csoundGetRealFFTPlan(csound, FFTsize);
+  ps->work = (MYFLT *) csound->Malloc(csound, sizeof(MYFLT) *
+                                      csoundFFTPlanWorkSize(ps->plan));
+  return ps;
+}
+
+static inline void plan_execute(CSOUND_FFT_SETUP *setup, MYFLT *sig,
+                                int32_t N, int32_t inverse) {
+  FFT_PLAN_SETUP *ps = (FFT_PLAN_SETUP *) setup->setup;
+  if (LIKELY(ps != NULL))
+    csoundFFTPlanReal(ps->plan, sig, ps->work, N, inverse, 1);
+}
+
 void *csoundRealFFT2Setup(CSOUND *csound,
                          int32_t FFTsize,
                          int32_t d){
@@ -3462,6 +3500,12 @@ void *csoundRealFFT2Setup(CSOUND *csound,
     csound->Calloc(csound, sizeof(CSOUND_FFT_SETUP));
   setup->N = FFTsize;
   setup->p2 = isPowTwo(FFTsize);
+  if (!setup->p2 && !(lib == PFFT_LIB && pffft_size_ok(FFTsize))) {
+    setup->lib = 0;
+    setup->d = d;
+    setup->setup = plan_setup(csound, FFTsize);
+    return (void *) setup;
+  }
   switch(lib){
 #if defined(__MACH__)
   case VDSP_LIB:
@@ -3512,6 +3556,9 @@ void csoundRealFFT2(CSOUND *csound,
     pffft_execute(setup,sig);
     break;
   default:
+    if (!setup->p2)
+      plan_execute(setup, sig, setup->N, setup->d != FFT_FWD);
+    else
     (setup->d == FFT_FWD ?
       csoundRealFFT(csound,
                      sig,setup->N) :
@@ -3656,7 +3703,10 @@ void DCT_execute(CSOUND *csound,
     buffer[i] = FL(0.0);
     buffer[i+1] = sig[j];
   }
-  csoundRealFFT(csound,buffer,N);
+  if (setup->p2)
+    csoundRealFFT(csound,buffer,N);
+  else
+    plan_execute(setup, buffer, N, 0);
   for(i=j=0; i < N/2; i+=2, j++){
     sig[j] = buffer[i];
   }
@@ -3672,7 +3722,10 @@ void DCT_execute(CSOUND *csound,
     buffer[i] = -sig[j];
     buffer[i+1] = FL(0.0);
   }
-  csoundInverseRealFFT(csound,buffer,N);
+  if (setup->p2)
+    csoundInverseRealFFT(csound,buffer,N);
+  else
+    plan_execute(setup, buffer, N, 1);
   for(i=j=0; i < N/2; i+=2, j++){
     sig[j] = buffer[i+1];
   }
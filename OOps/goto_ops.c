@@ -182,7 +182,7 @@ int32_t turnoff(CSOUND *csound, LINK *p)/* terminate the current instrument  */
 int32_t turnoff2(CSOUND *csound, TURNOFF2 *p, int32_t isStringArg)
 {
   MYFLT p1;                     /* Shoud e a float */
-  INSDS *ip, *ip2, *nip;
+  INSDS *ip, *ip2, *nip, *first = NULL;
   int32_t   mode, insno, allow_release;
 
   if (isStringArg) {
@@ -233,13 +233,9 @@ int32_t turnoff2(CSOUND *csound, TURNOFF2 *p, int32_t isStringArg)
       continue;
     }
     if (!(mode & 3)) {
-      if (allow_release) {
-        xturnoff(csound, ip);
-      }
-      else {
-        nip = ip->nxtact;
-        xturnoff_now(csound, ip);
-      }
+      if (first == NULL)
+        first = ip;
+      xturnoff_mark(csound, ip, !allow_release);
     }
     else {
       ip2 = ip;
@@ -248,6 +244,8 @@ int32_t turnoff2(CSOUND *csound, TURNOFF2 *p, int32_t isStringArg)
     }
     ip = nip;
   } while (ip != NULL && (int32_t) ip->insno == insno);
+  if (first != NULL)
+    xturnoff_marked(csound, first);
   if (ip2 != NULL) {
     if (allow_release) {
       xturnoff(csound, ip2);
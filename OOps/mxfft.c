@@ -1,7 +1,7 @@
 /*
     mxfft.c:
 
-    Copyright (C) 2002 Trevor Wishart, Keith Henderson
+    Copyright (C) 2026
 
     This file is part of Csound.
 
@@ -21,903 +21,522 @@
     02110-1301 USA
 */
 
-/* This program converted from the FORTRAN routines by Singleton in
- * Section 1.4 of  "Programs for Digital Signal Processing", IEEE Press, 1979.
- *  Conversion by Trevor Wishart and Keith Henderson, York Univ.
- */
-/*
-static char *rcsid = "$Id$";
- */
-/*
- *      $Log$
- *      Revision 1.15  2008-12-04 14:55:04  jpff
- *      Branch prediction
- *
- *      Revision 1.14  2005/08/13 14:44:37  istvanv
- *      Minor code changes
- *
- *      Revision 1.13  2005/08/12 19:01:23  istvanv
- *      Renamed ENVIRON to CSOUND
- *
- *      Revision 1.12  2005/08/10 09:57:07  istvanv
- *      Use CSOUND* type for Csound instance pointers instead of void*
- *
- *      Revision 1.11  2005/07/15 10:13:28  istvanv
- *      Removed cs.h
- *
- *      Revision 1.10  2005/06/05 16:36:24  istvanv
- *      Minor code improvements
- *
- *      Revision 1.9  2005/06/05 13:07:08  istvanv
- *      Added mxfft.c functions to API
+/* Planned mixed-radix FFT for arbitrary sizes.
  *
- *      Revision 1.8  2005/05/28 13:00:02  istvanv
- *      Minor code changes (tabs etc.)
+ * Lengths with factors 2, 3, 5 and 7 only are computed with a self-sorting
+ * (Stockham) mixed-radix transform; any other length is computed with
+ * Bluestein's algorithm on top of a power-of-two transform.  A plan holds
+ * the factorisation and all twiddle factors for one complex length; plans
+ * are created on first use and cached for the lifetime of the instance,
+ * so repeated transforms of the same size do no trigonometry and, when a
+ * work buffer is supplied (see csoundRealFFT2Setup()), no allocation.
  *
- *      Revision 1.7  2005/04/17 17:56:25  jpff
- *      Warnings
- *
- *      Revision 1.6  2005/02/18 16:21:14  istvanv
- *      added csound pointer to csound->Malloc, auxalloc, and other functions
- *
- *      Revision 1.5  2005/01/27 19:22:50  istvanv
- *      Merged changes from 4.24.1, including new localization system,
- *      timers, and allow use of underscore character in opcode names
- *
- *      Revision 1.4  2004/09/27 05:52:31  jpff
- *      Minor coding
- *
- *      Revision 1.3  2004/06/07 11:33:09  jpff
- *      line endings
- *
- *      Revision 1.2  2004/05/31 15:53:06  jpff
- *      Removing warnings mainly
- *
- *      Revision 1.1.1.1  2003/06/19 11:11:53  jpff
- *      Initial upload of sources
- *
- *      Revision 1.2  2003/05/21 11:31:06  jpff
- *      Added Copyright notices
- *
- * Revision 3.4  1994/10/31  17:37:28  martin
- * Starting with rcs
+ * The radix 2, 3, 4, 5 and 7 butterflies are straight-line code with no
+ * per-sample branches, so that the compiler can schedule and vectorise
+ * them for both float and double MYFLT.
  *
+ * Conventions follow the other Csound FFTs: forward transforms are
+ * unscaled with a negative exponent, inverse transforms are scaled
+ * by 1/N.
  */
+
 #include "csoundCore.h"
+#include "fftlib.h"
 #include <math.h>
-#include <assert.h>
 
-static void fft_(CSOUND *,MYFLT *, MYFLT *, int32_t, int32_t, int32_t, int32_t);
-static void fftmx(MYFLT *, MYFLT *, int32_t, int32_t, int32_t, int32_t, int32_t,
-                  int32_t*, MYFLT *, MYFLT *, MYFLT *, MYFLT *, int32_t *,
-                  int32_t[]);
-static void reals_(CSOUND *,MYFLT *, MYFLT *, int32_t, int32_t);
-
-/*
- *-----------------------------------------------------------------------
- * subroutine:  fft
- * multivariate complex fourier transform, computed in place
- * using mixed-radix fast fourier transform algorithm.
- *-----------------------------------------------------------------------
- *
- *      this is the call from C:
- *              fft_(anal,banal,&one,&N2,&one,&mtwo);
- *      CHANGED TO:-
- *              fft_(csound,anal,banal,one,N2,one,mtwo);
- */
+#define FFT_PLAN_CACHE  "::fftPlanCache"
+#define FFT_MAX_STAGES  32
+
+struct CS_FFT_PLAN_ {
+    int32_t     n;                      /* complex transform length */
+    int32_t     nstages;
+    int32_t     radix[FFT_MAX_STAGES];
+    MYFLT       *tw[FFT_MAX_STAGES];    /* per stage, ns * (radix - 1) */
+    MYFLT       *rtw;                   /* exp(-i pi k / n), 0 <= k <= n/2 */
+    /* Bluestein */
+    int32_t     m;                      /* convolution length, or zero */
+    CS_FFT_PLAN *sub;                   /* plan of length m */
+    MYFLT       *chirp;                 /* exp(-i pi k^2 / n), 0 <= k < n */
+    MYFLT       *bfilt;                 /* transformed conjugate chirp / m */
+    CS_FFT_PLAN *nxt;
+};
+
+/* BUTTERFLIES */
+
+/* Each stage reads n/p butterflies of radix p from x, with inputs n/p
+   apart, and writes them to y with outputs ns apart (ns = product of the
+   earlier radices), so that the result ends up in natural order.  Input j
+   and output (j / ns) * ns * p + j % ns use twiddle index k = j % ns.  The
+   butterflies are written for one (input, output, twiddle) triple and the
+   stage loops run the longer of the two index ranges innermost. */
+
+#define C_MUL(r, i, w) { MYFLT t_ = (r) * (w)[0] - (i) * (w)[1];      \
+                         (i) = (r) * (w)[1] + (i) * (w)[0]; (r) = t_; }
+
+static inline void bf2(const MYFLT *x, int32_t xs, MYFLT *y, int32_t ys,
+                       const MYFLT *w)
+{
+    MYFLT br = x[xs], bi = x[xs+1];
+    C_MUL(br, bi, w);
+    y[0] = x[0] + br;    y[1] = x[1] + bi;
+    y[ys] = x[0] - br;   y[ys+1] = x[1] - bi;
+}
 
-static void fft_(CSOUND *csound, MYFLT *a, MYFLT *b,
-                                  int32_t nseg, int32_t n, int32_t nspn, int32_t isn)
-  /*    *a,       pointer to array 'anal'  */
-  /*    *b;       pointer to array 'banal' */
+static inline void bf3(const MYFLT *x, int32_t xs, MYFLT *y, int32_t ys,
+                       const MYFLT *w)
 {
-    int32_t nfac[32];           /*  These are one bigger than needed   */
-                                /*  because wish to use Fortran array  */
-                                /* index which runs 1 to n, not 0 to n */
-
-    int32_t     m = 0,
-                k,
-                kt,
-                jj,
-                j,
-                nf,
-                ntot,
-                maxf, maxp=-1;
-
-    /* work space pointers */
-    void        *buf;
-    MYFLT       *at, *ck, *bt, *sk;
-    int32_t         *np;
-
-    /* reduce the pointers to input arrays - by doing this, FFT uses FORTRAN
-       indexing but retains compatibility with C arrays */
-    a--;        b--;
-
-    /*
-     * determine the factors of n
-     */
-    k = nf = abs(n);
-    if (nf==1)
-      return;
+    const MYFLT c = FL(-0.5), s = FL(0.86602540378443864676);
+    MYFLT br = x[xs], bi = x[xs+1], cr = x[2*xs], ci = x[2*xs+1];
+    MYFLT sr, si, ar, ai, dr, di;
+    C_MUL(br, bi, w);
+    C_MUL(cr, ci, w + 2);
+    sr = br + cr;  si = bi + ci;
+    dr = s * (br - cr);  di = s * (bi - ci);
+    ar = x[0] + c * sr;  ai = x[1] + c * si;
+    y[0] = x[0] + sr;     y[1] = x[1] + si;
+    y[ys] = ar + di;      y[ys+1] = ai - dr;
+    y[2*ys] = ar - di;    y[2*ys+1] = ai + dr;
+}
 
-    nspn = abs(nf*nspn);
-    ntot = abs(nspn*nseg);
+static inline void bf4(const MYFLT *x, int32_t xs, MYFLT *y, int32_t ys,
+                       const MYFLT *w)
+{
+    MYFLT ar = x[0], ai = x[1], br = x[xs], bi = x[xs+1];
+    MYFLT cr = x[2*xs], ci = x[2*xs+1], dr = x[3*xs], di = x[3*xs+1];
+    MYFLT t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+    C_MUL(br, bi, w);
+    C_MUL(cr, ci, w + 2);
+    C_MUL(dr, di, w + 4);
+    t0r = ar + cr; t0i = ai + ci;
+    t1r = ar - cr; t1i = ai - ci;
+    t2r = br + dr; t2i = bi + di;
+    t3r = br - dr; t3i = bi - di;
+    y[0] = t0r + t2r;       y[1] = t0i + t2i;
+    y[ys] = t1r + t3i;      y[ys+1] = t1i - t3r;
+    y[2*ys] = t0r - t2r;    y[2*ys+1] = t0i - t2i;
+    y[3*ys] = t1r - t3i;    y[3*ys+1] = t1i + t3r;
+}
 
-    for (m=0; !(k%16); nfac[++m]=4,k/=16);
-    assert(m<16);
-    for (j=3,jj=9; jj<=k; j+=2,jj=j*j)
-      for (; !(k%jj); nfac[++m]=j,k/=jj);
+static inline void bf5(const MYFLT *x, int32_t xs, MYFLT *y, int32_t ys,
+                       const MYFLT *w)
+{
+    const MYFLT c1 = FL(0.30901699437494742410);
+    const MYFLT c2 = FL(-0.80901699437494742410);
+    const MYFLT s1 = FL(0.95105651629515357212);
+    const MYFLT s2 = FL(0.58778525229247312917);
+    MYFLT v1r = x[xs], v1i = x[xs+1], v2r = x[2*xs], v2i = x[2*xs+1];
+    MYFLT v3r = x[3*xs], v3i = x[3*xs+1], v4r = x[4*xs], v4i = x[4*xs+1];
+    MYFLT s1r, s1i, s2r, s2i, d1r, d1i, d2r, d2i, ar, ai, br, bi;
+    C_MUL(v1r, v1i, w);
+    C_MUL(v2r, v2i, w + 2);
+    C_MUL(v3r, v3i, w + 4);
+    C_MUL(v4r, v4i, w + 6);
+    s1r = v1r + v4r; s1i = v1i + v4i; d1r = v1r - v4r; d1i = v1i - v4i;
+    s2r = v2r + v3r; s2i = v2i + v3i; d2r = v2r - v3r; d2i = v2i - v3i;
+    y[0] = x[0] + s1r + s2r;  y[1] = x[1] + s1i + s2i;
+    ar = x[0] + c1 * s1r + c2 * s2r;  ai = x[1] + c1 * s1i + c2 * s2i;
+    br = s1 * d1r + s2 * d2r;         bi = s1 * d1i + s2 * d2i;
+    y[ys] = ar + bi;     y[ys+1] = ai - br;
+    y[4*ys] = ar - bi;   y[4*ys+1] = ai + br;
+    ar = x[0] + c2 * s1r + c1 * s2r;  ai = x[1] + c2 * s1i + c1 * s2i;
+    br = s2 * d1r - s1 * d2r;         bi = s2 * d1i - s1 * d2i;
+    y[2*ys] = ar + bi;   y[2*ys+1] = ai - br;
+    y[3*ys] = ar - bi;   y[3*ys+1] = ai + br;
+}
 
-    if (k<=4) {
-      kt = m;
-      nfac[m+1] = k;
-      if (k != 1)
-        m++;
+static inline void bf7(const MYFLT *x, int32_t xs, MYFLT *y, int32_t ys,
+                       const MYFLT *w)
+{
+    static const MYFLT c[3][3] = {
+      { FL(0.62348980185873353053), FL(-0.22252093395631440429),
+        FL(-0.90096886790241912624) },
+      { FL(-0.22252093395631440429), FL(-0.90096886790241912624),
+        FL(0.62348980185873353053) },
+      { FL(-0.90096886790241912624), FL(0.62348980185873353053),
+        FL(-0.22252093395631440429) } };
+    static const MYFLT s[3][3] = {
+      { FL(0.78183148246802980871), FL(0.97492791218182360702),
+        FL(0.43388373911755812048) },
+      { FL(0.97492791218182360702), FL(-0.43388373911755812048),
+        FL(-0.78183148246802980871) },
+      { FL(0.43388373911755812048), FL(-0.78183148246802980871),
+        FL(0.97492791218182360702) } };
+    MYFLT vr[7], vi[7], sr[3], si[3], dr[3], di[3];
+    int32_t r, u;
+    for (r = 1; r < 7; r++) {
+      vr[r] = x[r*xs]; vi[r] = x[r*xs+1];
+      C_MUL(vr[r], vi[r], w + 2 * (r - 1));
     }
-    else {
-      if (k%4==0) {
-        nfac[++m]=2;
-        k/=4;
-      }
+    y[0] = x[0]; y[1] = x[1];
+    for (r = 0; r < 3; r++) {
+      sr[r] = vr[r+1] + vr[6-r]; si[r] = vi[r+1] + vi[6-r];
+      dr[r] = vr[r+1] - vr[6-r]; di[r] = vi[r+1] - vi[6-r];
+      y[0] += sr[r]; y[1] += si[r];
+    }
+    for (u = 0; u < 3; u++) {
+      MYFLT ar = x[0] + c[u][0] * sr[0] + c[u][1] * sr[1] + c[u][2] * sr[2];
+      MYFLT ai = x[1] + c[u][0] * si[0] + c[u][1] * si[1] + c[u][2] * si[2];
+      MYFLT br = s[u][0] * dr[0] + s[u][1] * dr[1] + s[u][2] * dr[2];
+      MYFLT bi = s[u][0] * di[0] + s[u][1] * di[1] + s[u][2] * di[2];
+      y[(u+1)*ys] = ar + bi;    y[(u+1)*ys+1] = ai - br;
+      y[(6-u)*ys] = ar - bi;    y[(6-u)*ys+1] = ai + br;
+    }
+}
 
-      kt = m;
-      maxp = (kt+kt+2 > k-1 ? kt+kt+2 : k-1);
-      for (j=2; j<=k; j=1+((j+1)/2)*2)
-        if (k%j==0) {
-          nfac[++m]=j;
-          k/=j;
-        }
+#define FFT_STAGE(name, bf, p)                                          \
+static void name(const MYFLT *x, MYFLT *y, int32_t n, int32_t ns,       \
+                 const MYFLT *tw)                                       \
+{                                                                       \
+    int32_t stride = n / p, b, k;                                       \
+    if (stride / ns >= ns) {                                            \
+      for (k = 0; k < ns; k++) {                                        \
+        const MYFLT *w = tw + 2 * (p - 1) * k;                          \
+        for (b = 0; b < stride; b += ns)                                \
+          bf(x + 2 * (b + k), 2 * stride, y + 2 * (b * p + k), 2 * ns, w); \
+      }                                                                 \
+    }                                                                   \
+    else {                                                              \
+      for (b = 0; b < stride; b += ns)                                  \
+        for (k = 0; k < ns; k++)                                        \
+          bf(x + 2 * (b + k), 2 * stride, y + 2 * (b * p + k), 2 * ns,  \
+             tw + 2 * (p - 1) * k);                                     \
+    }                                                                   \
+}
+
+FFT_STAGE(stage_radix2, bf2, 2)
+FFT_STAGE(stage_radix3, bf3, 3)
+FFT_STAGE(stage_radix4, bf4, 4)
+FFT_STAGE(stage_radix5, bf5, 5)
+FFT_STAGE(stage_radix7, bf7, 7)
+
+/* COMPLEX TRANSFORMS */
+
+static void swap_re_im(MYFLT *buf, int32_t n)
+{
+    int32_t i;
+    for (i = 0; i < n; i++) {
+      MYFLT t = buf[2*i];
+      buf[2*i] = buf[2*i+1];
+      buf[2*i+1] = t;
     }
-    if (m <= kt+1)
-      maxp = m + kt + 1;
-    if (UNLIKELY(m+kt > 15)) {
-      csound->Warning(csound, Str("\nerror - fft parameter n has "
-                                  "more than 15 factors : %d"), n);
+}
+
+/* forward transform of buf (n complex values); work holds
+   csoundFFTPlanWorkSize() MYFLTs */
+static void fft_forward(const CS_FFT_PLAN *plan, MYFLT *buf, MYFLT *work)
+{
+    int32_t n = plan->n, i, ns = 1;
+
+    if (plan->m) {
+      /* Bluestein: X_k = c_k sum_j (x_j c_j) conj(c_{k-j}) */
+      int32_t m = plan->m;
+      MYFLT   *a = work, *w = plan->chirp;
+      for (i = 0; i < n; i++) {
+        a[2*i] = buf[2*i] * w[2*i] - buf[2*i+1] * w[2*i+1];
+        a[2*i+1] = buf[2*i] * w[2*i+1] + buf[2*i+1] * w[2*i];
+      }
+      memset(a + 2 * n, 0, 2 * (m - n) * sizeof(MYFLT));
+      fft_forward(plan->sub, a, work + 2 * m);
+      w = plan->bfilt;
+      /* multiply and conjugate in one pass: the inverse transform is then
+         a forward transform followed by another conjugation */
+      for (i = 0; i < m; i++) {
+        MYFLT re = a[2*i] * w[2*i] - a[2*i+1] * w[2*i+1];
+        MYFLT im = a[2*i] * w[2*i+1] + a[2*i+1] * w[2*i];
+        a[2*i] = re;
+        a[2*i+1] = -im;
+      }
+      fft_forward(plan->sub, a, work + 2 * m);
+      w = plan->chirp;
+      for (i = 0; i < n; i++) {
+        MYFLT re = a[2*i], im = -a[2*i+1];
+        buf[2*i] = re * w[2*i] - im * w[2*i+1];
+        buf[2*i+1] = re * w[2*i+1] + im * w[2*i];
+      }
       return;
     }
-    if (kt!=0) {
-      j = kt;
-      while (j)
-        nfac[++m]=nfac[j--];
+    else {
+      MYFLT *src = buf, *dst = work, *t;
+      for (i = 0; i < plan->nstages; i++) {
+        int32_t p = plan->radix[i];
+        switch (p) {
+        case 4: stage_radix4(src, dst, n, ns, plan->tw[i]); break;
+        case 2: stage_radix2(src, dst, n, ns, plan->tw[i]); break;
+        case 3: stage_radix3(src, dst, n, ns, plan->tw[i]); break;
+        case 5: stage_radix5(src, dst, n, ns, plan->tw[i]); break;
+        default: stage_radix7(src, dst, n, ns, plan->tw[i]);
+        }
+        ns *= p;
+        t = src; src = dst; dst = t;
+      }
+      if (src != buf)
+        memcpy(buf, src, 2 * n * sizeof(MYFLT));
     }
-    maxf = nfac[m-kt];
-    if (kt > 0 && maxf <nfac[kt])
-      maxf = nfac[kt];
-
-    /* allocate workspace - assume no errors! */
-    buf = csound->Calloc(csound, sizeof(MYFLT) * 4 * maxf + sizeof(int32_t) * maxp);
-    at = (MYFLT*) buf;
-    ck = (MYFLT*) at + (int32_t) maxf;
-    bt = (MYFLT*) ck + (int32_t) maxf;
-    sk = (MYFLT*) bt + (int32_t) maxf;
-    np = (int32_t*) ((void*) ((MYFLT*) sk + (int32_t) maxf));
-
-    /* decrement pointers to allow FORTRAN type usage in fftmx */
-    at--; bt--; ck--; sk--; np--;
-
-    /* call fft driver */
-    fftmx(a, b, ntot, nf, nspn, isn, m, &kt, at, ck, bt, sk, np, nfac);
-
-    /* release working storage before returning - assume no problems */
-    csound->Free(csound,buf);
 }
 
-/*
- *-----------------------------------------------------------------------
- * subroutine:  fftmx
- * called by subroutine 'fft' to compute mixed-radix fourier transform
- *-----------------------------------------------------------------------
+/**
+ * Complex FFT of 'buf' (plan->n interleaved complex values) using a plan
+ * from csoundGetFFTPlan(). 'work' must hold csoundFFTPlanWorkSize() values.
+ * The inverse transform is scaled by 1/n.
  */
-
-static void fftmx(MYFLT *a, MYFLT *b,
-                  int32_t ntot, int32_t n, int32_t nspan, int32_t isn, int32_t m,
-                  int32_t *kt, MYFLT *at, MYFLT *ck, MYFLT *bt, MYFLT *sk,
-                  int32_t *np, int32_t nfac[])
+void csoundFFTPlanComplex(const CS_FFT_PLAN *plan, MYFLT *buf, MYFLT *work,
+                          int32_t inverse)
 {
-    int32_t i,inc,
-        j,jc,jf, jj,
-        k, k1, k2, k3=0, k4,
-        kk,klim,ks,kspan, kspnn,
-        lim,
-        maxf,mm,
-        nn,nt;
-    double  aa, aj, ajm, ajp, ak, akm, akp,
-      bb, bj, bjm, bjp, bk, bkm, bkp,
-      c1, c2=0, c3=0, c72, cd,
-      dr,
-      rad,
-      sd, s1, s2=0, s3=0, s72, s120;
-
-    double      xx;     /****** ADDED APRIL 1991 *********/
-    inc=abs(isn);
-    nt = inc*ntot;
-    ks = inc*nspan;
-/******************* REPLACED MARCH 29: ***********************
-                                        rad = atan(1.0);
-**************************************************************/
-    rad = 0.785398163397448278900;
-/******************* REPLACED MARCH 29: ***********************
-                                        s72 = rad/0.625;
-                                        c72 = cos(s72);
-                                        s72 = sin(s72);
-**************************************************************/
-    c72 = 0.309016994374947451270;
-    s72 = 0.951056516295153531190;
-/******************* REPLACED MARCH 29: ***********************
-                                        s120 = sqrt(0.75);
-**************************************************************/
-    s120 = 0.866025403784438707600;
-
-/* scale by 1/n for isn > 0 ( reverse transform ) */
-
-    if (isn < 0) {
-      s72 = -s72;
-      s120 = -s120;
-      rad = -rad;}
-    else {
-      ak = 1.0/(double)n;
-      for (j=1; j<=nt;j += inc) {
-        a[j] *= (MYFLT)ak;
-        b[j] *= (MYFLT)ak;
+    if (inverse) {
+      int32_t i, n = plan->n;
+      MYFLT   scal = FL(1.0) / (MYFLT) n;
+      /* ifft(x) = swap(fft(swap(x))) / n */
+      swap_re_im(buf, n);
+      fft_forward(plan, buf, work);
+      for (i = 0; i < n; i++) {
+        MYFLT t = buf[2*i];
+        buf[2*i] = buf[2*i+1] * scal;
+        buf[2*i+1] = t * scal;
       }
     }
-    kspan = ks;
-    nn = nt - inc;
-    jc = ks/n;
+    else
+      fft_forward(plan, buf, work);
+}
 
-/* sin, cos values are re-initialised each lim steps  */
+/* REAL TRANSFORMS */
 
-    lim = 32;
-    klim = lim * jc;
-    i = 0;
-    jf = 0;
-    maxf = m - (*kt);
-    maxf = nfac[maxf];
-    if ((*kt) > 0 && maxf < nfac[*kt])
-      maxf = nfac[*kt];
+/* N = 2n real values are transformed as n complex values and separated
+   into the spectra of the even and odd samples afterwards */
 
-/*
- * compute Fourier transform
- */
+static void real_forward_even(const CS_FFT_PLAN *plan, MYFLT *buf,
+                              MYFLT *work, int32_t packed)
+{
+    int32_t n = plan->n, k;
+    MYFLT   z0r, z0i;
+
+    fft_forward(plan, buf, work);
+    for (k = 1; 2 * k <= n; k++) {
+      const MYFLT *w = plan->rtw + 2 * k;
+      MYFLT *zk = buf + 2 * k, *zn = buf + 2 * (n - k);
+      /* E = (Z_k + conj Z_n-k) / 2, O = (Z_k - conj Z_n-k) / 2i */
+      MYFLT er = FL(0.5) * (zk[0] + zn[0]), ei = FL(0.5) * (zk[1] - zn[1]);
+      MYFLT qr = FL(0.5) * (zk[1] + zn[1]), qi = -FL(0.5) * (zk[0] - zn[0]);
+      MYFLT tr = w[0] * qr - w[1] * qi, ti = w[0] * qi + w[1] * qr;
+      /* X_k = E + W^k O, X_n-k = conj(E - W^k O) */
+      zk[0] = er + tr;   zk[1] = ei + ti;
+      zn[0] = er - tr;   zn[1] = ti - ei;
+    }
+    z0r = buf[0]; z0i = buf[1];
+    buf[0] = z0r + z0i;
+    if (packed)
+      buf[1] = z0r - z0i;
+    else {
+      buf[2 * n] = z0r - z0i;
+      buf[1] = buf[2 * n + 1] = FL(0.0);
+    }
+}
 
- lbl40:
-    dr = (8.0 * (double)jc)/((double)kspan);
-/*************************** APRIL 1991 POW & POW2 not WORKING.. REPLACE *******
-                    cd = 2.0 * (pow2 ( sin(0.5 * dr * rad)) );
-*******************************************************************************/
-    xx =  sin(0.5 * dr * rad);
-    cd = 2.0 * xx * xx;
-    sd = sin(dr * rad);
-    kk = 1;
-    if (nfac[++i]!=2) goto lbl110;
-/*
- * transform for factor of 2 (including rotation factor)
- */
-    kspan /= 2;
-    k1 = kspan + 2;
-    do {
-      do {
-        k2 = kk + kspan;
-        ak = a[k2];
-        bk = b[k2];
-        a[k2] = (a[kk]) - (MYFLT)ak;
-        b[k2] = (b[kk]) - (MYFLT)bk;
-        a[kk] = (a[kk]) + (MYFLT)ak;
-        b[kk] = (b[kk]) + (MYFLT)bk;
-        kk = k2 + kspan;
-      } while (kk <= nn);
-      kk -= nn;
-    } while (kk <= jc);
-    if (kk > kspan) goto lbl350;
- lbl60:
-    c1 = 1.0 - cd;
-    s1 = sd;
-    mm = (k1/2 < klim ? k1/2 :klim);
-    goto lbl80;
- lbl70:
-    ak = c1 - ((cd*c1)+(sd*s1));
-    s1 = ((sd*c1)-(cd*s1)) + s1;
-    c1 = ak;
- lbl80:
-    do {
-      do {
-        k2 = kk + kspan;
-        ak = a[kk] - a[k2];
-        bk = b[kk] - b[k2];
-        a[kk] = a[kk] + a[k2];
-        b[kk] = b[kk] + b[k2];
-        a[k2] = (MYFLT)((c1 * ak) - (s1 * bk));
-        b[k2] = (MYFLT)((s1 * ak) + (c1 * bk));
-        kk = k2 + kspan;
-      } while (kk < nt);
-      k2 = kk - nt;
-      c1 = -c1;
-      kk = k1 - k2;
-    } while (kk > k2);
-    kk += jc;
-    if (kk <= mm) goto lbl70;
-    if (kk < k2)  goto lbl90;
-    k1 += (inc + inc);
-    kk = ((k1-kspan)/2) + jc;
-    if (kk <= (jc+jc)) goto lbl60;
-    goto lbl40;
- lbl90:
-    s1 = ((double)((kk-1)/jc)) * dr * rad;
-    c1 = cos(s1);
-    s1 = sin(s1);
-    mm = (k1/2 < mm+klim ? k1/2 : mm+klim);
-    goto lbl80;
-/*
- * transform for factor of 3 (optional code)
- */
+static void real_inverse_even(const CS_FFT_PLAN *plan, MYFLT *buf,
+                              MYFLT *work, int32_t packed)
+{
+    int32_t n = plan->n, k;
+    MYFLT   x0 = buf[0], xn = (packed ? buf[1] : buf[2 * n]);
+
+    buf[0] = FL(0.5) * (x0 + xn);
+    buf[1] = FL(0.5) * (x0 - xn);
+    for (k = 1; 2 * k <= n; k++) {
+      const MYFLT *w = plan->rtw + 2 * k;
+      MYFLT *xk = buf + 2 * k, *xm = buf + 2 * (n - k);
+      MYFLT er = FL(0.5) * (xk[0] + xm[0]), ei = FL(0.5) * (xk[1] - xm[1]);
+      MYFLT dr = FL(0.5) * (xk[0] - xm[0]), di = FL(0.5) * (xk[1] + xm[1]);
+      /* O = (X_k - conj X_n-k) / 2 * conj W^k */
+      MYFLT qr = dr * w[0] + di * w[1], qi = di * w[0] - dr * w[1];
+      /* Z_k = E + iO, Z_n-k = conj E + i conj O */
+      xk[0] = er - qi;   xk[1] = ei + qr;
+      xm[0] = er + qi;   xm[1] = qr - ei;
+    }
+    csoundFFTPlanComplex(plan, buf, work, 1);
+    if (!packed)
+      buf[2 * n] = buf[2 * n + 1] = FL(0.0);
+}
 
- lbl100:
-    k1 = kk + kspan;
-    k2 = k1 + kspan;
-    ak = a[kk];
-    bk = b[kk];
-    aj = a[k1] + a[k2];
-    bj = b[k1] + b[k2];
-    a[kk] = (MYFLT)(ak + aj);
-    b[kk] = (MYFLT)(bk + bj);
-    ak += (-0.5 * aj);
-    bk += (-0.5 * bj);
-    aj = (a[k1] - a[k2]) * s120;
-    bj = (b[k1] - b[k2]) * s120;
-    a[k1] = (MYFLT)(ak - bj);
-    b[k1] = (MYFLT)(bk + aj);
-    a[k2] = (MYFLT)(ak + bj);
-    b[k2] = (MYFLT)(bk - aj);
-    kk = k2 + kspan;
-    if (kk < nn)     goto lbl100;
-    kk -= nn;
-    if (kk <= kspan) goto lbl100;
-    goto lbl290;
+/* odd lengths are transformed as complex data with a zero imaginary part */
+static void real_odd(const CS_FFT_PLAN *plan, MYFLT *buf, MYFLT *work,
+                     int32_t inverse)
+{
+    int32_t n = plan->n, h = (n - 1) >> 1, k;
+    MYFLT   *c = work;
 
-/*
- * transform for factor of 4
- */
+    if (!inverse) {
+      for (k = 0; k < n; k++) {
+        c[2*k] = buf[k];
+        c[2*k+1] = FL(0.0);
+      }
+      fft_forward(plan, c, work + 2 * n);
+      memcpy(buf, c, 2 * (h + 1) * sizeof(MYFLT));
+      buf[1] = buf[n + 1] = FL(0.0);
+    }
+    else {
+      c[0] = buf[0];
+      c[1] = FL(0.0);
+      for (k = 1; k <= h; k++) {
+        c[2*k] = c[2*(n-k)] = buf[2*k];
+        c[2*k+1] = buf[2*k+1];
+        c[2*(n-k)+1] = -buf[2*k+1];
+      }
+      csoundFFTPlanComplex(plan, c, work + 2 * n, 1);
+      for (k = 0; k < n; k++)
+        buf[k] = c[2*k];
+      buf[n] = buf[n + 1] = FL(0.0);
+    }
+}
 
- lbl110:
-    if (nfac[i] != 4) goto lbl230;
-    //kspnn = kspan;
-    kspan = kspan/4;
- lbl120:
-    c1 = 1.0;
-    s1 = 0;
-    mm = (kspan < klim ? kspan : klim);
-    goto lbl150;
- lbl130:
-    c2 = c1 - ((cd*c1)+(sd*s1));
-    s1 = ((sd*c1)-(cd*s1)) + s1;
-/*
- * the following three statements compensate for truncation
- * error.  if rounded arithmetic is used, substitute
- * c1=c2
- *
- * c1 = (0.5/(pow2(c2)+pow2(s1))) + 0.5;
- * s1 = c1*s1;
- * c1 = c1*c2;
+/**
+ * Real FFT of N values using a plan from csoundGetRealFFTPlan(csound, N).
+ * If 'packed' is zero, buf holds N + 2 values and the spectrum is stored
+ * as in csoundRealFFTnp2(); otherwise N must be even, buf holds N values
+ * and the real part of the Nyquist frequency is stored in buf[1], as in
+ * csoundRealFFT(). The inverse transform is scaled by 1/N.
  */
-    c1 = c2;
- lbl140:
-    c2 = (c1 * c1) - (s1 * s1);
-    s2 = c1 * s1 * 2.0;
-    c3 = (c2 * c1) - (s2 * s1);
-    s3 = (c2 * s1) + (s2 * c1);
- lbl150:
-    k1 = kk + kspan;
-    k2 = k1 + kspan;
-    k3 = k2 + kspan;
-    akp = a[kk] + a[k2];
-    akm = a[kk] - a[k2];
-    ajp = a[k1] + a[k3];
-    ajm = a[k1] - a[k3];
-    a[kk] = (MYFLT)(akp + ajp);
-    ajp = akp - ajp;
-    bkp = b[kk] + b[k2];
-    bkm = b[kk] - b[k2];
-    bjp = b[k1] + b[k3];
-    bjm = b[k1] - b[k3];
-    b[kk] = (MYFLT)(bkp + bjp);
-    bjp = bkp - bjp;
-    if (isn < 0) goto lbl180;
-    akp = akm - bjm;
-    akm = akm + bjm;
-    bkp = bkm + ajm;
-    bkm = bkm - ajm;
-    if (s1 == 0.0) goto lbl190;
- lbl160:
-    a[k1] = (MYFLT)((akp*c1) - (bkp*s1));
-    b[k1] = (MYFLT)((akp*s1) + (bkp*c1));
-    a[k2] = (MYFLT)((ajp*c2) - (bjp*s2));
-    b[k2] = (MYFLT)((ajp*s2) + (bjp*c2));
-    a[k3] = (MYFLT)((akm*c3) - (bkm*s3));
-    b[k3] = (MYFLT)((akm*s3) + (bkm*c3));
-    kk = k3 + kspan;
-    if (kk <= nt)   goto lbl150;
- lbl170:
-    kk -= (nt - jc);
-    if (kk <= mm)   goto lbl130;
-    if (kk < kspan) goto lbl200;
-    kk -= (kspan - inc);
-    if (kk <= jc)   goto lbl120;
-    if (kspan==jc)  goto lbl350;
-    goto lbl40;
- lbl180:
-    akp = akm + bjm;
-    akm = akm - bjm;
-    bkp = bkm - ajm;
-    bkm = bkm + ajm;
-    if (s1 != 0.0)  goto lbl160;
- lbl190:
-    a[k1] = (MYFLT)akp;
-    b[k1] = (MYFLT)bkp;
-    a[k2] = (MYFLT)ajp;
-    b[k2] = (MYFLT)bjp;
-    a[k3] = (MYFLT)akm;
-    b[k3] = (MYFLT)bkm;
-    kk = k3 + kspan;
-    if (kk <= nt) goto lbl150;
-    goto lbl170;
- lbl200:
-    s1 = ((double)((kk-1)/jc)) * dr * rad;
-    c1 = cos(s1);
-    s1 = sin(s1);
-    mm = (kspan < mm+klim ? kspan : mm+klim);
-    goto lbl140;
+void csoundFFTPlanReal(const CS_FFT_PLAN *plan, MYFLT *buf, MYFLT *work,
+                       int32_t N, int32_t inverse, int32_t packed)
+{
+    if (N & 1)
+      real_odd(plan, buf, work, inverse);
+    else if (inverse)
+      real_inverse_even(plan, buf, work, packed);
+    else
+      real_forward_even(plan, buf, work, packed);
+}
 
-/*
- * transform for factor of 5 (optional code)
- */
+/* PLANS */
 
- lbl210:
-    c2 = (c72*c72) - (s72*s72);
-    s2 = 2.0 * c72 * s72;
- lbl220:
-    k1 = kk + kspan;
-    k2 = k1 + kspan;
-    k3 = k2 + kspan;
-    k4 = k3 + kspan;
-    akp = a[k1] + a[k4];
-    akm = a[k1] - a[k4];
-    bkp = b[k1] + b[k4];
-    bkm = b[k1] - b[k4];
-    ajp = a[k2] + a[k3];
-    ajm = a[k2] - a[k3];
-    bjp = b[k2] + b[k3];
-    bjm = b[k2] - b[k3];
-    aa = a[kk];
-    bb = b[kk];
-    a[kk] = (MYFLT)(aa + akp + ajp);
-    b[kk] = (MYFLT)(bb + bkp + bjp);
-    ak = (akp*c72) + (ajp*c2) + aa;
-    bk = (bkp*c72) + (bjp*c2) + bb;
-    aj = (akm*s72) + (ajm*s2);
-    bj = (bkm*s72) + (bjm*s2);
-    a[k1] = (MYFLT)(ak - bj);
-    a[k4] = (MYFLT)(ak + bj);
-    b[k1] = (MYFLT)(bk + aj);
-    b[k4] = (MYFLT)(bk - aj);
-    ak = (akp*c2) + (ajp*c72) + aa;
-    bk = (bkp*c2) + (bjp*c72) + bb;
-    aj = (akm*s2) - (ajm*s72);
-    bj = (bkm*s2) - (bjm*s72);
-    a[k2] = (MYFLT)(ak - bj);
-    a[k3] = (MYFLT)(ak + bj);
-    b[k2] = (MYFLT)(bk + aj);
-    b[k3] = (MYFLT)(bk - aj);
-    kk = k4 + kspan;
-    if (kk < nn)     goto lbl220;
-    kk -= nn;
-    if (kk <= kspan) goto lbl220;
-    goto lbl290;
+static CS_FFT_PLAN *plan_new(CSOUND *csound, int32_t n);
 
-/*
- * transform for odd factors
- */
+static int32_t pow2_ceil(int32_t n)
+{
+    int32_t m = 1;
+    while (m < n) m <<= 1;
+    return m;
+}
 
- lbl230:
-    k = nfac[i];
-    kspnn = kspan;
-    kspan /= k;
-    if (k==3)   goto lbl100;
-    if (k==5)   goto lbl210;
-    if (k==jf)  goto lbl250;
-    jf = k;
-    s1 = rad/(((double)(k))/8.0);
-    c1 = cos(s1);
-    s1 = sin(s1);
-    ck[jf] = FL(1.0);
-    sk[jf] = FL(0.0);
-    for (j=1; j<k ; j++) {
-      ck[j] = (MYFLT)((ck[k])*c1 + (sk[k])*s1);
-      sk[j] = (MYFLT)((ck[k])*s1 - (sk[k])*c1);
-      k--;
-      ck[k] = ck[j];
-      sk[k] = -(sk[j]);
+static void plan_bluestein(CSOUND *csound, CS_FFT_PLAN *plan)
+{
+    int32_t n = plan->n, m = pow2_ceil(2 * n - 1), k;
+    MYFLT   *b, *work;
+
+    plan->m = m;
+    plan->sub = plan_new(csound, m);
+    plan->chirp = (MYFLT*) csound->Malloc(csound, 2 * n * sizeof(MYFLT));
+    plan->bfilt = b = (MYFLT*) csound->Calloc(csound, 2 * m * sizeof(MYFLT));
+    for (k = 0; k < n; k++) {
+      /* k^2 mod 2n keeps the phase exact for large k */
+      int64_t kk = ((int64_t) k * k) % (2 * (int64_t) n);
+      double  a = PI * (double) kk / (double) n;
+      plan->chirp[2*k] = (MYFLT) cos(a);
+      plan->chirp[2*k+1] = (MYFLT) -sin(a);
+      b[2*k] = (MYFLT) (cos(a) / m);
+      b[2*k+1] = (MYFLT) (sin(a) / m);
+      if (k) {
+        b[2*(m-k)] = b[2*k];
+        b[2*(m-k)+1] = b[2*k+1];
+      }
     }
- lbl250:
-    k1 = kk;
-    k2 = kk + kspnn;
-    aa = a[kk];
-    bb = b[kk];
-    ak = aa;
-    bk = bb;
-    j = 1;
-    k1 += kspan;
-    do {
-      k2 -= kspan;
-      j++;
-      at[j] = a[k1] + a[k2];
-      ak = at[j] + ak;
-      bt[j] = b[k1] + b[k2];
-      bk = bt[j] + bk;
-      j++;
-      at[j] = a[k1] - a[k2];
-      bt[j] = b[k1] - b[k2];
-      k1 += kspan;
-    } while (k1 < k2);
-    a[kk] = (MYFLT)ak;
-    b[kk] = (MYFLT)bk;
-    k1 = kk;
-    k2 = kk + kspnn;
-    j = 1;
- lbl270:
-    k1 += kspan;
-    k2 -= kspan;
-    jj = j;
-    ak = aa;
-    bk = bb;
-    aj = 0.0;
-    bj = 0.0;
-    k = 1;
-    do {
-      k++;
-      ak = (at[k] * ck[jj]) + ak;
-      bk = (bt[k] * ck[jj]) + bk;
-      k++;
-      aj = (at[k] * sk[jj]) + aj;
-      bj = (bt[k] * sk[jj]) + bj;
-      jj += j;
-      if (jj > jf)
-        jj -= jf;
-    } while (k < jf);
-    k = jf - j;
-    a[k1] = (MYFLT)(ak - bj);
-    b[k1] = (MYFLT)(bk + aj);
-    a[k2] = (MYFLT)(ak + bj);
-    b[k2] = (MYFLT)(bk - aj);
-    j++;
-    if (j < k)     goto lbl270;
-    kk += kspnn;
-    if (kk <= nn)  goto lbl250;
-    kk -= nn;
-    if (kk<=kspan) goto lbl250;
-
-/*
- * multiply by rotation factor (except for factors of 2 and 4)
- */
-
- lbl290:
-    if (i==m) goto lbl350;
-    kk = jc + 1;
- lbl300:
-    c2 = 1.0 - cd;
-    s1 = sd;
-    mm = (kspan < klim ? kspan : klim);
-    goto lbl320;
- lbl310:
-    c2 = c1 - ((cd*c1) + (sd*s1));
-    s1 = s1 + ((sd*c1) - (cd*s1));
- lbl320:
-    c1 = c2;
-    s2 = s1;
-    kk += kspan;
- lbl330:
-    ak = a[kk];
-    a[kk] = (MYFLT)((c2*ak) - (s2 * b[kk]));
-    b[kk] = (MYFLT)((s2*ak) + (c2 * b[kk]));
-    kk += kspnn;
-    if (kk <= nt) goto lbl330;
-    ak = s1*s2;
-    s2 = (s1*c2) + (c1*s2);
-    c2 = (c1*c2) - ak;
-    kk -= (nt - kspan);
-    if (kk <= kspnn) goto lbl330;
-    kk -= (kspnn - jc);
-    if (kk <= mm)   goto lbl310;
-    if (kk < kspan) goto lbl340;
-    kk -= (kspan - jc - inc);
-    if (kk <= (jc+jc)) goto lbl300;
-    goto lbl40;
- lbl340:
-    s1 = ((double)((kk-1)/jc)) * dr * rad;
-    c2 = cos(s1);
-    s1 = sin(s1);
-    mm = (kspan < mm+klim ?  kspan :mm+klim);
-    goto lbl320;
-
-/*
- * permute the results to normal order---done in two stages
- * permutation for square factors of n
- */
+    work = (MYFLT*) csound->Malloc(csound, 2 * m * sizeof(MYFLT));
+    fft_forward(plan->sub, b, work);
+    csound->Free(csound, work);
+}
 
- lbl350:
-    np[1] = ks;
-    if (!(*kt)) goto lbl440;
-    k = *kt + *kt + 1;
-    if (m < k)
-      k--;
-    np[k+1] = jc;
-    for (j=1; j < k; j++,k--) {
-      np[j+1] = np[j] / nfac[j];
-      np[k] = np[k+1] * nfac[j];
+static CS_FFT_PLAN *plan_new(CSOUND *csound, int32_t n)
+{
+    CS_FFT_PLAN *plan = (CS_FFT_PLAN*) csound->Calloc(csound,
+                                                      sizeof(CS_FFT_PLAN));
+    int32_t     rest = n, ns = 1, i, k, r;
+
+    plan->n = n;
+    while (rest > 1 && plan->nstages < FFT_MAX_STAGES) {
+      int32_t p = (rest % 4 == 0 ? 4 : rest % 2 == 0 ? 2 :
+                   rest % 3 == 0 ? 3 : rest % 5 == 0 ? 5 :
+                   rest % 7 == 0 ? 7 : 0);
+      if (p == 0)
+        break;
+      plan->radix[plan->nstages++] = p;
+      rest /= p;
     }
-    k3 = np[k+1];
-    kspan = np[2];
-    kk = jc + 1;
-    k2 = kspan + 1;
-    j = 1;
-    if (n != ntot) goto lbl400;
-/*
- * permutation for single-variate transform (optional code)
- */
- lbl370:
-    do {
-      ak = a[kk];
-      a[kk] = a[k2];
-      a[k2] = (MYFLT)ak;
-      bk = b[kk];
-      b[kk] = b[k2];
-      b[k2] = (MYFLT)bk;
-      kk += inc;
-      k2 += kspan;
-    } while (k2 < ks);
-lbl380:
-    do {
-      k2 -= np[j++];
-      k2 += np[j+1];
-    } while (k2 > np[j]);
-    j = 1;
- lbl390:
-    if (kk < k2) {
-      goto lbl370;
+    if (rest > 1) {
+      plan->nstages = 0;
+      plan_bluestein(csound, plan);
     }
-    kk += inc;
-    k2 += kspan;
-    if (k2 < ks) goto lbl390;
-    if (kk < ks) goto lbl380;
-    jc = k3;
-    goto lbl440;
-/*
- * permutation for multivariate transform
- */
- lbl400:
-    do {
-      do {
-        k = kk + jc;
-        do {
-          ak = a[kk];
-          a[kk] = a[k2];
-          a[k2] = (MYFLT)ak;
-          bk = b[kk];
-          b[kk] = b[k2];
-          b[k2] = (MYFLT)bk;
-          kk += inc;
-          k2 += inc;
-        } while (kk < k);
-        kk += (ks - jc);
-        k2 += (ks - jc);
-      } while (kk < nt);
-      k2 -= (nt - kspan);
-      kk -= (nt - jc);
-    } while (k2 < ks);
- lbl420:
-    do {
-      k2 -= np[j++];
-      k2 += np[j+1];
-    } while (k2 > np[j]);
-    j = 1;
- lbl430:
-    if (kk < k2)         goto lbl400;
-    kk += jc;
-    k2 += kspan;
-    if (k2 < ks)      goto lbl430;
-    if (kk < ks)      goto lbl420;
-    jc = k3;
- lbl440:
-    if ((2*(*kt))+1 >= m)
-      return;
+    else {
+      for (i = 0; i < plan->nstages; i++) {
+        int32_t p = plan->radix[i];
+        MYFLT   *tw = (MYFLT*) csound->Malloc(csound, 2 * ns * (p - 1)
+                                              * sizeof(MYFLT));
+        for (k = 0; k < ns; k++)
+          for (r = 1; r < p; r++) {
+            double a = -TWOPI * (double) (r * k) / (double) (ns * p);
+            tw[2 * (k * (p - 1) + r - 1)] = (MYFLT) cos(a);
+            tw[2 * (k * (p - 1) + r - 1) + 1] = (MYFLT) sin(a);
+          }
+        plan->tw[i] = tw;
+        ns *= p;
+      }
+    }
+    plan->rtw = (MYFLT*) csound->Malloc(csound, 2 * (n / 2 + 1)
+                                        * sizeof(MYFLT));
+    for (k = 0; k <= n / 2; k++) {
+      double a = -PI * (double) k / (double) n;
+      plan->rtw[2*k] = (MYFLT) cos(a);
+      plan->rtw[2*k+1] = (MYFLT) sin(a);
+    }
+    return plan;
+}
 
-    kspnn = *(np + *(kt) + 1);
-    j = m - *kt;
-    nfac[j+1] = 1;
- lbl450:
-    nfac[j] = nfac[j] * nfac[j+1];
-    j--;
-    if (j != *kt) goto lbl450;
-    *kt = *(kt) + 1;
-    nn = nfac[*kt] - 1;
-    jj = 0;
-    j = 0;
-    goto lbl480;
- lbl460:
-    jj -= k2;
-    k2 = kk;
-    kk = nfac[++k];
- lbl470:
-    jj += kk;
-    if (jj >= k2) goto lbl460;
-    np[j] = jj;
- lbl480:
-    k2 = nfac[*kt];
-    k = *kt + 1;
-    kk = nfac[k];
-    j++;
-    if (j <= nn) goto lbl470;
-/* Determine permutation cycles of length greater than 1 */
-    j = 0;
-    goto lbl500;
- lbl490:
-    k = kk;
-    kk = np[k];
-    np[k] = -kk;
-    if (kk != j) goto lbl490;
-    k3 = kk;
- lbl500:
-    kk = np[++j];
-    if (kk < 0)  goto lbl500;
-    if (kk != j) goto lbl490;
-    np[j] = -j;
-    if (j != nn) goto lbl500;
-    maxf *= inc;
-    /* Perform reordering following permutation cycles */
-    goto lbl570;
- lbl510:
-    j--;
-    if (np[j] < 0) goto lbl510;
-    jj = jc;
- lbl520:
-    kspan = jj;
-    if (jj > maxf)
-      kspan = maxf;
-    jj -= kspan;
-    k = np[j];
-    kk = (jc*k) + i + jj;
-    k1 = kk + kspan;
-    k2 = 0;
- lbl530:
-    k2++;
-    at[k2] = a[k1];
-    bt[k2] = b[k1];
-    k1 -= inc;
-    if (k1 != kk) goto lbl530;
- lbl540:
-    k1 = kk + kspan;
-    k2 = k1 - (jc * (k + np[k]));
-    k = -(np[k]);
- lbl550:
-    a[k1] = a[k2];
-    b[k1] = b[k2];
-    k1 -= inc;
-    k2 -= inc;
-    if (k1 != kk) goto lbl550;
-    kk = k2;
-    if (k != j)   goto lbl540;
-    k1 = kk + kspan;
-    k2 = 0;
- lbl560:
-    k2++;
-    a[k1] = at[k2];
-    b[k1] = bt[k2];
-    k1 -= inc;
-    if (k1 != kk) goto lbl560;
-    if (jj)       goto lbl520;
-    if (j  != 1)  goto lbl510;
-lbl570:
-    j = k3 + 1;
-    nt -= kspnn;
-    i = nt - inc + 1;
-    if (nt >= 0)  goto lbl510;
-    return;
+/**
+ * Returns the plan for complex transforms of length n, creating and
+ * caching it on first use.
+ */
+CS_FFT_PLAN *csoundGetFFTPlan(CSOUND *csound, int32_t n)
+{
+    CS_FFT_PLAN **cache, *plan;
+
+    if (UNLIKELY(n < 1))
+      return NULL;
+    cache = (CS_FFT_PLAN**) csound->QueryGlobalVariable(csound, FFT_PLAN_CACHE);
+    if (cache == NULL) {
+      if (UNLIKELY(csound->CreateGlobalVariable(csound, FFT_PLAN_CACHE,
+                                                sizeof(CS_FFT_PLAN*)) != 0))
+        return NULL;
+      cache = (CS_FFT_PLAN**)
+        csound->QueryGlobalVariable(csound, FFT_PLAN_CACHE);
+    }
+    for (plan = *cache; plan != NULL; plan = plan->nxt)
+      if (plan->n == n)
+        return plan;
+    plan = plan_new(csound, n);
+    plan->nxt = *cache;
+    *cache = plan;
+    return plan;
 }
 
-/*
- *-----------------------------------------------------------------------
- * subroutine:
- * reals
- * used with 'fft' to compute fourier transform or inverse for real data
- *-----------------------------------------------------------------------
- *      this is the call from C:
- *
- *              reals_(anal,banal,N2,mtwo);
- *      which has been changed from CARL call
- *              reals_(csound,anal,banal,&N2,&mtwo);
+/**
+ * Returns the plan for real transforms of length N.
  */
+CS_FFT_PLAN *csoundGetRealFFTPlan(CSOUND *csound, int32_t N)
+{
+    return csoundGetFFTPlan(csound, (N & 1) ? N : (N >> 1));
+}
 
-static void reals_(CSOUND *csound, MYFLT *a, MYFLT *b, int32_t n, int32_t isn)
+/**
+ * Number of MYFLT values needed for the work buffer of a plan, for both
+ * complex and real transforms.
+ */
+int32_t csoundFFTPlanWorkSize(const CS_FFT_PLAN *plan)
+{
+    return 2 * plan->n + (plan->m ? 4 * plan->m : 2 * plan->n);
+}
 
-  /*    *a,       a refers to an array of floats 'anal'   */
-  /*    *b;       b refers to an array of floats 'banal'  */
-  /* See IEEE book for a long comment here on usage */
+/* LEGACY INTERFACE */
 
+static MYFLT *plan_work(CSOUND *csound, const CS_FFT_PLAN *plan)
 {
-    IGN(csound);
-    int32_t inc,
-      j,
-      k,
-      lim,
-      mm,ml,
-      nf,nk,nh;
-
-    double      aa,ab,
-      ba,bb,
-      cd,cn,
-      dr,
-      em,
-      rad,re,
-      sd,sn;
-    double      xx;     /******* ADDED APRIL 1991 ******/
-    /* adjust  input array pointers (called from C) */
-    a--;        b--;
-    inc = abs(isn);
-    nf = abs(n);
-    nk = (nf*inc) + 2;
-    nh = nk/2;
-/*****************************
-        rad  = atan((double)1.0);
-******************************/
-    rad = 0.785398163397448278900;
-    dr = -4.0/(double)(nf);
-/********************************** POW2 REMOVED APRIL 1991 *****************
-                                cd = 2.0 * (pow2(sin((double)0.5 * dr * rad)));
-*****************************************************************************/
-    xx = sin((double)0.5 * dr * rad);
-    cd = 2.0 * xx * xx;
-    sd = sin(dr * rad);
-/*
- * sin,cos values are re-initialised each lim steps
- */
-    lim = 32;
-    mm = lim;
-    ml = 0;
-    sn = 0.0;
-    if (isn<0) {
-      cn = 1.0;
-      a[nk-1] = a[1];
-      b[nk-1] = b[1]; }
-    else {
-      cn = -1.0;
-      sd = -sd;
-    }
-    for (j=1;j<=nh;j+=inc)      {
-      k = nk - j;
-      aa = a[j] + a[k];
-      ab = a[j] - a[k];
-      ba = b[j] + b[k];
-      bb = b[j] - b[k];
-      re = (cn*ba) + (sn*ab);
-      em = (sn*ba) - (cn*ab);
-      b[k] = (MYFLT)((em-bb)*0.5);
-      b[j] = (MYFLT)((em+bb)*0.5);
-      a[k] = (MYFLT)((aa-re)*0.5);
-      a[j] = (MYFLT)((aa+re)*0.5);
-      ml++;
-      if (ml!=mm) {
-        aa = cn - ((cd*cn)+(sd*sn));
-        sn = ((sd*cn) - (cd*sn)) + sn;
-        cn = aa;}
-      else {
-        mm +=lim;
-        sn = ((MYFLT)ml) * dr * rad;
-        cn = cos(sn);
-        if (isn>0)
-          cn = -cn;
-        sn = sin(sn);
-      }
-    }
-    return;
+    return (MYFLT*) csound->Malloc(csound, csoundFFTPlanWorkSize(plan)
+                                   * sizeof(MYFLT));
 }
 
 /**
@@ -926,27 +545,29 @@ static void reals_(CSOUND *csound, MYFLT *a, MYFLT *b, int32_t n, int32_t isn)
  * buf:     array of FFTsize + 2 MYFLT values; output is in interleaved
  *          real/imaginary format (note: the real part of the Nyquist
  *          frequency is stored in buf[FFTsize], and not in buf[1]).
- * FFTsize: FFT length in samples; not required to be an integer power of two,
- *          but should be even and not have too many factors.
+ * FFTsize: FFT length in samples; not required to be an integer power of two.
  */
 void csoundRealFFTnp2(CSOUND *csound, MYFLT *buf, int32_t FFTsize)
 {
+    CS_FFT_PLAN *plan;
+    MYFLT       *work;
+
     if (!(FFTsize & (FFTsize - 1))) {
       /* if FFT size is power of two: */
       csound->RealFFT(csound, buf, FFTsize);
       buf[FFTsize] = buf[1];
+      buf[1] = buf[FFTsize + 1] = FL(0.0);
+      return;
     }
-    else {
-      if (UNLIKELY(FFTsize < 2 || (FFTsize & 1))) {
-        csound->Warning(csound,
-                        Str("csoundRealFFTnp2(): invalid FFT size, %d"), FFTsize);
-        return;
-      }
-      buf[FFTsize] = buf[FFTsize + 1] = FL(0.0);
-      fft_(csound, buf, &(buf[1]), 1, (FFTsize >> 1), 1, -2);
-      reals_(csound, buf, &(buf[1]), (FFTsize >> 1), -2);
+    if (UNLIKELY(FFTsize < 2)) {
+      csound->Warning(csound,
+                      Str("csoundRealFFTnp2(): invalid FFT size, %d"), FFTsize);
+      return;
     }
-    buf[1] = buf[FFTsize + 1] = FL(0.0);
+    plan = csoundGetRealFFTPlan(csound, FFTsize);
+    work = plan_work(csound, plan);
+    csoundFFTPlanReal(plan, buf, work, FFTsize, 0, 0);
+    csound->Free(csound, work);
 }
 
 /**
@@ -956,35 +577,57 @@ void csoundRealFFTnp2(CSOUND *csound, MYFLT *buf, int32_t FFTsize)
  * buf:     array of FFTsize + 2 MYFLT values, in interleaved real/imaginary
  *          format (note: the real part of the Nyquist frequency is stored
  *          in buf[FFTsize], and not in buf[1]).
- * FFTsize: FFT length in samples; not required to be an integer power of two,
- *          but should be even and not have too many factors.
+ * FFTsize: FFT length in samples; not required to be an integer power of two.
  */
 void csoundInverseRealFFTnp2(CSOUND *csound, MYFLT *buf, int32_t FFTsize)
 {
-  if (UNLIKELY(FFTsize < 2 || (FFTsize & 1))){
+    CS_FFT_PLAN *plan;
+    MYFLT       *work;
+
+    if (UNLIKELY(FFTsize < 2)) {
       csound->Warning(csound, Str("csoundInverseRealFFTnp2(): invalid FFT size"));
       return;
-  }
-    buf[1] = buf[FFTsize + 1] = FL(0.0);
-    reals_(csound, buf, &(buf[1]), (FFTsize >> 1), 2);
-    fft_(csound, buf, &(buf[1]), 1, (FFTsize >> 1), 1, 2);
-    buf[FFTsize] = buf[FFTsize + 1] = FL(0.0);
+    }
+    plan = csoundGetRealFFTPlan(csound, FFTsize);
+    work = plan_work(csound, plan);
+    csoundFFTPlanReal(plan, buf, work, FFTsize, 1, 0);
+    csound->Free(csound, work);
 }
 
+/**
+ * Compute in-place inverse complex FFT of FFTsize interleaved values,
+ * allowing non power of two sizes. The output is scaled by 1/FFTsize.
+ */
 void csoundInverseComplexFFTnp2(CSOUND *csound, MYFLT *buf, int32_t FFTsize)
 {
-  if (UNLIKELY(FFTsize < 2 || (FFTsize & 1))){
+    CS_FFT_PLAN *plan;
+    MYFLT       *work;
+
+    if (UNLIKELY(FFTsize < 1)) {
       csound->Warning(csound, Str("csoundInverseRealFFTnp2(): invalid FFT size"));
       return;
-  }
-    fft_(csound, buf, buf, 1, FFTsize, 1, 2);
+    }
+    plan = csoundGetFFTPlan(csound, FFTsize);
+    work = plan_work(csound, plan);
+    csoundFFTPlanComplex(plan, buf, work, 1);
+    csound->Free(csound, work);
 }
 
+/**
+ * Compute in-place complex FFT of FFTsize interleaved values,
+ * allowing non power of two sizes.
+ */
 void csoundComplexFFTnp2(CSOUND *csound, MYFLT *buf, int32_t FFTsize)
 {
-      if (UNLIKELY(FFTsize < 2 || (FFTsize & 1))) {
-        csound->Warning(csound, Str("csoundRealFFTnp2(): invalid FFT size"));
-        return;
-      }
-      fft_(csound, buf, buf, 1, FFTsize, 1, -2);
+    CS_FFT_PLAN *plan;
+    MYFLT       *work;
+
+    if (UNLIKELY(FFTsize < 1)) {
+      csound->Warning(csound, Str("csoundRealFFTnp2(): invalid FFT size"));
+      return;
+    }
+    plan = csoundGetFFTPlan(csound, FFTsize);
+    work = plan_work(csound, plan);
+    csoundFFTPlanComplex(plan, buf, work, 0);
+    csound->Free(csound, work);
 }
@@ -0,0 +1,525 @@
+/*
+    oscbank.c:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Sinusoidal oscillator bank, shared by the additive resynthesis
+ * opcodes (pvsadsyn, adsynt, tradsyn, sinsyn and resyn).
+ *
+ * The state is kept in double precision, structure of arrays, in groups
+ * of OB_LANES oscillators.  Over a block the phase of each oscillator is
+ * a polynomial of degree at most 3 in the sample index, so that it can
+ * be generated without any table lookup or trigonometric function:
+ * a phasor z is rotated each sample by r, which is itself rotated by q
+ * when the frequency glides, and q by s for cubic phase interpolation.
+ * The inner loops run over the lanes of a group, with no dependency
+ * between lanes, so that the compiler can vectorise them; the lanes are
+ * summed once per block.  Phasors and rotations are renormalised at the
+ * end of each block, and reset to their exact values when a phase target
+ * is reached, so that errors do not accumulate.
+ *
+ * Tables holding anything else than a single sinusoid are read with
+ * linear interpolation, with the same phase polynomials.
+ */
+
+#include "csoundCore.h"
+#include "oscbank.h"
+#include <math.h>
+
+#define OB_LANES    8
+#define OB_ALIGN    64
+#define OB_FRESH    0x100       /* restarted: no glide into the first target */
+#define OB_MODES    0xff
+#define OB_MAXSINE  (1 << 20)   /* longest table checked for a sinusoid */
+#define OB_SINETOL  1.0e-4      /* relative tolerance of that check */
+
+typedef struct {
+    int32_t count, ngroups, maxblock;
+    int32_t sine;               /* render sinusoids, not table lookups */
+    double  tpidsr;
+    double  tabamp, tabphs;     /* of a sinusoidal table */
+    MYFLT   *ftable;
+    int32_t flen;
+    /* per oscillator */
+    double  *amp, *tamp;        /* current and target amplitudes */
+    double  *w, *tw;            /* frequencies, radians per sample */
+    double  *tph;               /* target phase of CS_OSCBANK_PHASE */
+    double  *zr, *zi;           /* phasor, sine kernel */
+    double  *rr, *ri;           /* rotation e^jw, sine kernel */
+    double  *ph;                /* phase in cycles, table kernel */
+    int32_t *flags;
+    double  *acc;               /* maxblock x OB_LANES */
+} OSCBANK;
+
+/* sin and cos, by their series for the small angles of the rotations */
+
+static inline void ob_sincos(double x, double *c, double *s)
+{
+    if (fabs(x) < 0.1) {
+      double x2 = x * x;
+      *s = x * (1.0 - x2 / 6.0 * (1.0 - x2 / 20.0 *
+                (1.0 - x2 / 42.0 * (1.0 - x2 / 72.0))));
+      *c = 1.0 - x2 / 2.0 * (1.0 - x2 / 12.0 * (1.0 - x2 / 30.0 *
+                (1.0 - x2 / 56.0 * (1.0 - x2 / 90.0))));
+    }
+    else {
+      *c = cos(x);
+      *s = sin(x);
+    }
+}
+
+static double ob_wrap(double x)
+{
+    return x - TWOPI * floor(x / TWOPI + 0.5);
+}
+
+/* does the table hold A sin(x + phs)? its first harmonic gives A and phs,
+   which are then checked against every point */
+
+static int ob_is_sine(FUNC *ftp, double *amp, double *phs)
+{
+    int32_t n = (int32_t) ftp->flen, k;
+    MYFLT   *t = ftp->ftable;
+    double  xr = 0.0, xi = 0.0, cr = 1.0, ci = 0.0, dr, di, tmp, a, p, tol;
+
+    if (n < 4 || n > OB_MAXSINE)
+      return 0;
+    ob_sincos(TWOPI / n, &dr, &di);
+    for (k = 0; k < n; k++) {
+      /* exact every 256 points, rotated in between */
+      if ((k & 255) == 0) {
+        cr = cos(TWOPI * k / n);
+        ci = sin(TWOPI * k / n);
+      }
+      xr += t[k] * cr;
+      xi -= t[k] * ci;
+      tmp = cr * dr - ci * di;
+      ci = cr * di + ci * dr;
+      cr = tmp;
+    }
+    a = 2.0 * hypot(xr, xi) / n;
+    if (a <= 0.0)
+      return 0;
+    p = atan2(xi, xr) + HALFPI;
+    tol = OB_SINETOL * a;
+    for (k = 0; k < n; k++) {
+      if ((k & 255) == 0) {
+        cr = cos(TWOPI * k / n + p);
+        ci = sin(TWOPI * k / n + p);
+      }
+      if (fabs(t[k] - a * ci) > tol)
+        return 0;
+      tmp = cr * dr - ci * di;
+      ci = cr * di + ci * dr;
+      cr = tmp;
+    }
+    *amp = a;
+    *phs = p;
+    return 1;
+}
+
+void *csoundOscBankCreate(CSOUND *csound, AUXCH *aux, int count,
+                          int maxblock, FUNC *ftp)
+{
+    OSCBANK *b;
+    size_t  nosc, size;
+    char    *mem;
+    int32_t i;
+
+    if (UNLIKELY(count < 1 || maxblock < 1 || aux == NULL))
+      return NULL;
+    nosc = (size_t) ((count + OB_LANES - 1) / OB_LANES) * OB_LANES;
+    size = sizeof(OSCBANK) + OB_ALIGN
+      + nosc * (11 * sizeof(double) + sizeof(int32_t))
+      + (size_t) maxblock * OB_LANES * sizeof(double);
+    csound->AuxAlloc(csound, size, aux);
+    b = (OSCBANK*) aux->auxp;
+    b->count = count;
+    b->ngroups = (int32_t) (nosc / OB_LANES);
+    b->maxblock = maxblock;
+    b->tpidsr = TWOPI / csound->GetSr(csound);
+    mem = (char*) b + sizeof(OSCBANK);
+    mem += (OB_ALIGN - ((uintptr_t) mem & (OB_ALIGN - 1))) & (OB_ALIGN - 1);
+    b->acc = (double*) mem;
+    mem += (size_t) maxblock * OB_LANES * sizeof(double);
+    b->amp = (double*) mem;
+    b->tamp = b->amp + nosc;
+    b->w = b->tamp + nosc;
+    b->tw = b->w + nosc;
+    b->tph = b->tw + nosc;
+    b->zr = b->tph + nosc;
+    b->zi = b->zr + nosc;
+    b->rr = b->zi + nosc;
+    b->ri = b->rr + nosc;
+    b->ph = b->ri + nosc;
+    b->flags = (int32_t*) (b->ph + nosc);
+    b->tabamp = 1.0;
+    b->tabphs = 0.0;
+    b->sine = 1;
+    if (ftp != NULL) {
+      b->sine = ob_is_sine(ftp, &b->tabamp, &b->tabphs);
+      b->ftable = ftp->ftable;
+      b->flen = (int32_t) ftp->flen;
+    }
+    for (i = 0; i < (int32_t) nosc; i++) {
+      b->zr[i] = cos(b->tabphs);
+      b->zi[i] = sin(b->tabphs);
+      b->rr[i] = 1.0;
+      b->flags[i] = CS_OSCBANK_GLIDE | OB_FRESH;
+    }
+    return (void*) b;
+}
+
+void csoundOscBankSet(CSOUND *csound, void *bank, int n, MYFLT amp,
+                      MYFLT freq, MYFLT phase, int mode)
+{
+    OSCBANK *b = (OSCBANK*) bank;
+    double  w = (double) freq * b->tpidsr;
+    (void) csound;
+
+    b->tamp[n] = (double) amp;
+    b->tw[n] = w;
+    switch (mode) {
+    case CS_OSCBANK_START:
+      b->amp[n] = 0.0;
+      b->ph[n] = (double) phase / TWOPI;
+      b->zr[n] = cos(phase + b->tabphs);
+      b->zi[n] = sin(phase + b->tabphs);
+      b->flags[n] = CS_OSCBANK_GLIDE | OB_FRESH;
+      break;
+    case CS_OSCBANK_PHASE:
+      b->tph[n] = (double) phase;
+      b->flags[n] = CS_OSCBANK_PHASE | (b->flags[n] & OB_FRESH);
+      break;
+    default:
+      b->flags[n] = CS_OSCBANK_GLIDE | (b->flags[n] & OB_FRESH);
+      break;
+    }
+    if (b->flags[n] & OB_FRESH) {
+      b->w[n] = w;
+      ob_sincos(w, &b->rr[n], &b->ri[n]);
+    }
+}
+
+void csoundOscBankMove(CSOUND *csound, void *bank, int dst, int src)
+{
+    OSCBANK *b = (OSCBANK*) bank;
+    (void) csound;
+
+    if (dst == src)
+      return;
+    b->amp[dst] = b->amp[src];
+    b->tamp[dst] = b->tamp[src];
+    b->w[dst] = b->w[src];
+    b->tw[dst] = b->tw[src];
+    b->tph[dst] = b->tph[src];
+    b->zr[dst] = b->zr[src];
+    b->zi[dst] = b->zi[src];
+    b->rr[dst] = b->rr[src];
+    b->ri[dst] = b->ri[src];
+    b->ph[dst] = b->ph[src];
+    b->flags[dst] = b->flags[src];
+}
+
+/* Phase of one oscillator over a block of n samples, as the increments
+   from sample m to m + 1:
+     glide: w + dw m, reaching the target frequency on the last sample
+     cubic: w + c2 (2m + 1) + c3 (3m^2 + 3m + 1), from the polynomial
+            ph + w m + c2 m^2 + c3 m^3 reaching the target phase (modulo
+            2 pi) and frequency at m = n, as in McAulay and Quatieri.
+   d1, d2 and d3 are the initial first, second and third differences. */
+
+typedef struct {
+    double d1[OB_LANES], d2[OB_LANES], d3[OB_LANES];
+    double a[OB_LANES], da[OB_LANES];
+} OB_BLOCK;
+
+static int ob_setup(OSCBANK *b, int32_t base, int32_t nl, int32_t n,
+                    OB_BLOCK *k)
+{
+    int32_t l, order = 0, audible = 0;
+
+    for (l = 0; l < OB_LANES; l++) {
+      int32_t i = base + l;
+      if (l >= nl) {
+        k->d1[l] = k->d2[l] = k->d3[l] = k->a[l] = k->da[l] = 0.0;
+        continue;
+      }
+      k->a[l] = b->amp[i];
+      k->da[l] = (b->tamp[i] - b->amp[i]) / n;
+      if ((b->flags[i] & OB_MODES) == CS_OSCBANK_PHASE) {
+        double w0 = b->w[i], w1 = b->tw[i], ph, pd, c2, c3;
+        if (b->sine)
+          ph = atan2(b->zi[i], b->zr[i]) - b->tabphs;
+        else
+          ph = b->ph[i] * TWOPI;
+        pd = ob_wrap(b->tph[i] - ph);
+        pd += TWOPI * floor(((w0 + w1) * n * 0.5 - pd) / TWOPI + 0.5);
+        c2 = 3.0 / ((double) n * n) * (pd - n / 3.0 * (2.0 * w0 + w1));
+        c3 = 1.0 / (3.0 * n * n) * (w1 - w0 - 2.0 * c2 * n);
+        k->d1[l] = w0 + c2 + c3;
+        k->d2[l] = 2.0 * c2 + 6.0 * c3;
+        k->d3[l] = 6.0 * c3;
+        order = 3;
+      }
+      else {
+        k->d1[l] = b->w[i];
+        k->d2[l] = (b->tw[i] - b->w[i]) / n;
+        k->d3[l] = 0.0;
+        if (k->d2[l] != 0.0 && order < 2)
+          order = 2;
+      }
+      if (k->a[l] != 0.0 || k->da[l] != 0.0)
+        audible = 1;
+    }
+    if (!audible)
+      return 0;
+    return (order > 1 ? order : 1);
+}
+
+/* State at the end of the block: phase targets are set exactly, and the
+   phasors and rotations carried over from the kernels renormalised.  The
+   phase of a silent group is not advanced, as it does not matter. */
+
+static void ob_finish(OSCBANK *b, int32_t base, int32_t nl, int32_t n,
+                      const OB_BLOCK *k, int rendered)
+{
+    int32_t l;
+
+    for (l = 0; l < nl; l++) {
+      int32_t i = base + l;
+      double  g;
+      if ((b->flags[i] & OB_MODES) == CS_OSCBANK_PHASE) {
+        b->zr[i] = cos(b->tph[i] + b->tabphs);
+        b->zi[i] = sin(b->tph[i] + b->tabphs);
+        b->ph[i] = b->tph[i] / TWOPI - floor(b->tph[i] / TWOPI);
+        ob_sincos(b->tw[i], &b->rr[i], &b->ri[i]);
+      }
+      else if (!rendered || !b->sine) {
+        if (rendered) {
+          /* w n + dw n (n - 1) / 2 */
+          double adv = (k->d1[l] + k->d2[l] * (n - 1) * 0.5) * n / TWOPI;
+          b->ph[i] += adv - floor(b->ph[i] + adv);
+        }
+        if (b->w[i] != b->tw[i])
+          ob_sincos(b->tw[i], &b->rr[i], &b->ri[i]);
+      }
+      else {
+        g = 1.5 - 0.5 * (b->zr[i] * b->zr[i] + b->zi[i] * b->zi[i]);
+        b->zr[i] *= g;
+        b->zi[i] *= g;
+        g = 1.5 - 0.5 * (b->rr[i] * b->rr[i] + b->ri[i] * b->ri[i]);
+        b->rr[i] *= g;
+        b->ri[i] *= g;
+      }
+      b->amp[i] = b->tamp[i];
+      b->w[i] = b->tw[i];
+      b->flags[i] = CS_OSCBANK_GLIDE;
+    }
+}
+
+/* the three sine kernels, by order of the phase polynomial */
+
+static void ob_sine1(OSCBANK *b, int32_t base, int32_t nl, int32_t n,
+                     OB_BLOCK *k)
+{
+    double  zr[OB_LANES], zi[OB_LANES], rr[OB_LANES], ri[OB_LANES];
+    double  *acc = b->acc, *a = k->a, *da = k->da;
+    int32_t l, m;
+
+    for (l = 0; l < OB_LANES; l++) {
+      zr[l] = b->zr[base + l];
+      zi[l] = b->zi[base + l];
+      rr[l] = b->rr[base + l];
+      ri[l] = b->ri[base + l];
+    }
+    for (m = 0; m < n; m++, acc += OB_LANES) {
+      for (l = 0; l < OB_LANES; l++) {
+        double tmp = zr[l] * rr[l] - zi[l] * ri[l];
+        acc[l] += a[l] * zi[l];
+        zi[l] = zr[l] * ri[l] + zi[l] * rr[l];
+        zr[l] = tmp;
+        a[l] += da[l];
+      }
+    }
+    for (l = 0; l < nl; l++) {
+      b->zr[base + l] = zr[l];
+      b->zi[base + l] = zi[l];
+    }
+}
+
+static void ob_sine2(OSCBANK *b, int32_t base, int32_t nl, int32_t n,
+                     OB_BLOCK *k)
+{
+    double  zr[OB_LANES], zi[OB_LANES], rr[OB_LANES], ri[OB_LANES];
+    double  qr[OB_LANES], qi[OB_LANES];
+    double  *acc = b->acc, *a = k->a, *da = k->da;
+    int32_t l, m;
+
+    for (l = 0; l < OB_LANES; l++) {
+      zr[l] = b->zr[base + l];
+      zi[l] = b->zi[base + l];
+      rr[l] = b->rr[base + l];
+      ri[l] = b->ri[base + l];
+      ob_sincos(k->d2[l], &qr[l], &qi[l]);
+    }
+    for (m = 0; m < n; m++, acc += OB_LANES) {
+      for (l = 0; l < OB_LANES; l++) {
+        double tmp = zr[l] * rr[l] - zi[l] * ri[l];
+        acc[l] += a[l] * zi[l];
+        zi[l] = zr[l] * ri[l] + zi[l] * rr[l];
+        zr[l] = tmp;
+        tmp = rr[l] * qr[l] - ri[l] * qi[l];
+        ri[l] = rr[l] * qi[l] + ri[l] * qr[l];
+        rr[l] = tmp;
+        a[l] += da[l];
+      }
+    }
+    for (l = 0; l < nl; l++) {
+      b->zr[base + l] = zr[l];
+      b->zi[base + l] = zi[l];
+      b->rr[base + l] = rr[l];
+      b->ri[base + l] = ri[l];
+    }
+}
+
+static void ob_sine3(OSCBANK *b, int32_t base, int32_t nl, int32_t n,
+                     OB_BLOCK *k)
+{
+    double  zr[OB_LANES], zi[OB_LANES], rr[OB_LANES], ri[OB_LANES];
+    double  qr[OB_LANES], qi[OB_LANES], sr[OB_LANES], si[OB_LANES];
+    double  *acc = b->acc, *a = k->a, *da = k->da;
+    int32_t l, m;
+
+    for (l = 0; l < OB_LANES; l++) {
+      double cr, ci;
+      zr[l] = b->zr[base + l];
+      zi[l] = b->zi[base + l];
+      /* from the carried rotation, e^jw, to the first increment */
+      ob_sincos(l < nl ? k->d1[l] - b->w[base + l] : 0.0, &cr, &ci);
+      rr[l] = b->rr[base + l] * cr - b->ri[base + l] * ci;
+      ri[l] = b->rr[base + l] * ci + b->ri[base + l] * cr;
+      ob_sincos(k->d2[l], &qr[l], &qi[l]);
+      ob_sincos(k->d3[l], &sr[l], &si[l]);
+    }
+    for (m = 0; m < n; m++, acc += OB_LANES) {
+      for (l = 0; l < OB_LANES; l++) {
+        double tmp = zr[l] * rr[l] - zi[l] * ri[l];
+        acc[l] += a[l] * zi[l];
+        zi[l] = zr[l] * ri[l] + zi[l] * rr[l];
+        zr[l] = tmp;
+        tmp = rr[l] * qr[l] - ri[l] * qi[l];
+        ri[l] = rr[l] * qi[l] + ri[l] * qr[l];
+        rr[l] = tmp;
+        tmp = qr[l] * sr[l] - qi[l] * si[l];
+        qi[l] = qr[l] * si[l] + qi[l] * sr[l];
+        qr[l] = tmp;
+        a[l] += da[l];
+      }
+    }
+    for (l = 0; l < nl; l++) {
+      b->zr[base + l] = zr[l];
+      b->zi[base + l] = zi[l];
+      b->rr[base + l] = rr[l];
+      b->ri[base + l] = ri[l];
+    }
+}
+
+/* any other waveform, with linear interpolation; the guard point is
+   read at the end of the table */
+
+static void ob_table(OSCBANK *b, int32_t base, int32_t n, OB_BLOCK *k)
+{
+    double  p[OB_LANES], d1[OB_LANES], d2[OB_LANES], d3[OB_LANES];
+    double  *acc = b->acc, *a = k->a, *da = k->da;
+    double  flen = (double) b->flen;
+    MYFLT   *ftab = b->ftable;
+    int32_t l, m;
+
+    for (l = 0; l < OB_LANES; l++) {
+      p[l] = b->ph[base + l];
+      d1[l] = k->d1[l] / TWOPI;
+      d2[l] = k->d2[l] / TWOPI;
+      d3[l] = k->d3[l] / TWOPI;
+    }
+    for (m = 0; m < n; m++, acc += OB_LANES) {
+      for (l = 0; l < OB_LANES; l++) {
+        double  x = (p[l] - floor(p[l])) * flen;
+        int32_t j = (int32_t) x;
+        double  fr;
+        j = (j < b->flen ? j : j - b->flen);
+        fr = x - j;
+        acc[l] += a[l] * (ftab[j] + fr * (ftab[j + 1] - ftab[j]));
+        p[l] += d1[l];
+        d1[l] += d2[l];
+        d2[l] += d3[l];
+        a[l] += da[l];
+      }
+    }
+}
+
+void csoundOscBankRun(CSOUND *csound, void *bank, MYFLT *out, int nsmps,
+                      int count)
+{
+    OSCBANK  *b = (OSCBANK*) bank;
+    OB_BLOCK k;
+    double   *acc = b->acc, scal = b->tabamp;
+    int32_t  g, l, m, ngroups, any = 0;
+    (void) csound;
+
+    if (nsmps > b->maxblock)
+      nsmps = b->maxblock;
+    if (count > b->count)
+      count = b->count;
+    if (UNLIKELY(nsmps <= 0))
+      return;
+    memset(acc, 0, (size_t) nsmps * OB_LANES * sizeof(double));
+    ngroups = (count + OB_LANES - 1) / OB_LANES;
+    for (g = 0; g < ngroups; g++) {
+      int32_t base = g * OB_LANES;
+      int32_t nl = (count - base < OB_LANES ? count - base : OB_LANES);
+      int     order = ob_setup(b, base, nl, nsmps, &k);
+      if (order == 0) {
+        ob_finish(b, base, nl, nsmps, &k, 0);
+        continue;
+      }
+      if (!b->sine)
+        ob_table(b, base, nsmps, &k);
+      else if (order == 1)
+        ob_sine1(b, base, nl, nsmps, &k);
+      else if (order == 2)
+        ob_sine2(b, base, nl, nsmps, &k);
+      else
+        ob_sine3(b, base, nl, nsmps, &k);
+      ob_finish(b, base, nl, nsmps, &k, 1);
+      any = 1;
+    }
+    if (!any) {
+      memset(out, 0, nsmps * sizeof(MYFLT));
+      return;
+    }
+    for (m = 0; m < nsmps; m++, acc += OB_LANES) {
+      double sum = 0.0;
+      for (l = 0; l < OB_LANES; l++)
+        sum += acc[l];
+      out[m] = (MYFLT) (sum * scal);
+    }
+}
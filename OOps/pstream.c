@@ -116,12 +116,10 @@ int32_t pvadsynset(CSOUND *csound, PVADS *p)
 {
     /* get params from input fsig */
     /* we trust they are legit! */
-    int32_t i;
     PVSDAT  *fs = p->fsig;
     int32_t N = fs->N;
     int32_t noscs,n_oscs;
     int32_t startbin,binoffset;
-    MYFLT *p_x;
 
     if (UNLIKELY(fs->sliding))
       return csound->InitError(csound, Str("Sliding version not yet available"));
@@ -164,85 +162,46 @@ int32_t pvadsynset(CSOUND *csound, PVADS *p)
 /*  p->one_over_sr = (float) csound->onedsr; */
 /*  p->pi_over_sr = (float) csound->pidsr; */
     p->one_over_overlap = (float)(FL(1.0) / p->overlap);
-    /* alloc for all oscs;
-       in case we can do something with them dynamically, one day */
-    csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->a);
-    csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->x);
-    csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->y);
-    csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->amps);
-    csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->lastamps);
-    csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->freqs);
+    /* one oscillator per bin used */
+    p->noscs = (p->maxosc - startbin + binoffset - 1) / binoffset;
+    if (UNLIKELY(csound->OscBankCreate(csound, &p->bank, p->noscs,
+                                       p->overlap, NULL) == NULL))
+      return csound->InitError(csound, Str("pvadsyn: bad value for inoscs\n"));
     csound->AuxAlloc(csound, p->overlap * sizeof(MYFLT),&p->outbuf);
-    /* initialize oscbank */
-    p_x = (MYFLT *) p->x.auxp;
-    for (i=0;i < noscs;i++)
-      p_x[i] = FL(1.0);
 
     return OK;
 }
-/* c/o John Lazzaro, for SAOL, and many other sources */
-static inline MYFLT fastoscil(MYFLT *a, MYFLT *x, MYFLT *y)
-{
-    *x = *x - *a * *y;
-    *y = *y + *a * *x;
-    /* expensive, but worth it for evenness ? */
-    if (*y < FL(-1.0)) *y = FL(-1.0);
-    if (*y > FL(1.0))  *y = FL(1.0);
-    return *y;
-}
 
 static void adsyn_frame(CSOUND *csound, PVADS *p)
 {
-    int32_t i,j;
+    int32_t i,n;
     int32_t startbin,lastbin,binoffset;
     MYFLT *outbuf = (MYFLT *) (p->outbuf.auxp);
 
     float *frame;        /* RWD MUST be 32bit */
-    MYFLT *a,*x,*y;
-    MYFLT *amps,*freqs,*lastamps;
+    MYFLT amp,freq;
     MYFLT ffac    = *p->kfmod;
     MYFLT nyquist = csound->esr * FL(0.5);
-    /* we add to outbuf, so clear it first*/
-    memset(p->outbuf.auxp,0,p->overlap * sizeof(MYFLT));
 
     frame     = (float *) p->fsig->frame.auxp;
-    a         = (MYFLT *) p->a.auxp;
-    x         = (MYFLT *) p->x.auxp;
-    y         = (MYFLT *) p->y.auxp;
-    amps      = (MYFLT *) p->amps.auxp;
-    freqs     = (MYFLT *) p->freqs.auxp;
-    lastamps  = (MYFLT *) p->lastamps.auxp;
     startbin  = (int32_t) *p->ibin;
     binoffset = (int32_t) *p->ibinoffset;
     lastbin   = p->maxosc;
 
-    /*update amps, freqs*/
-    for (i=startbin;i < lastbin;i+= binoffset) {
-      amps[i] = frame[i*2];
+    /* amplitudes are interpolated across the frame, and frequencies glide */
+    for (i=startbin,n=0;i < lastbin;i+= binoffset,n++) {
+      amp = frame[i*2];
       /* lazy: force all freqs positive! */
-      freqs[i] = ffac * FABS(frame[(i*2)+1]);
+      freq = ffac * FABS(frame[(i*2)+1]);
       /* kill stuff over Nyquist. Need to worry about vlf values? */
-      if (freqs[i] > nyquist)
-        amps[i] = FL(0.0);
-      a[i] = FL(2.0) * SIN(freqs[i] * csound->pidsr);
-    }
-
-    /* we need to interp amplitude, but seems we can avoid doing freqs too,
-       for pvoc so can use direct calc for speed.
-       But large overlap size is not a good idea.
-       If compiler cannot inline fastoscil,
-       would be worth doing so by hand here ?
-     */
-    for (i=startbin;i < lastbin;i+=binoffset) {
-      MYFLT thisamp = lastamps[i];
-      MYFLT delta_amp = (amps[i] - thisamp) * p->one_over_overlap;
-
-      for (j=0;j < p->overlap;j++) {
-        outbuf[j] += thisamp *  fastoscil(a+i,x+i,y+i);
-        thisamp += delta_amp;
+      if (freq > nyquist) {
+        amp = FL(0.0);
+        freq = nyquist;
       }
-      lastamps[i] = amps[i];
+      csound->OscBankSet(csound, p->bank.auxp, n, amp, freq, FL(0.0),
+                         CS_OSCBANK_GLIDE);
     }
+    csound->OscBankRun(csound, p->bank.auxp, outbuf, p->overlap, p->noscs);
 }
 
 static MYFLT adsyn_tick(CSOUND *csound, PVADS *p)
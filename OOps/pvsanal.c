@@ -263,7 +263,7 @@ int32_t pvsanalset(CSOUND *csound, PVSANAL *p)
     p->fsig->format = PVS_AMP_FREQ;      /* only this, for now */
     p->fsig->sliding = 0;
 
-    if (!(N & (N - 1))) /* if pow of two use this */
+    if (!(N & 1)) /* even sizes use the planned transform */
      p->setup = csound->RealFFT2Setup(csound,N,FFT_FWD);
     return OK;
 }
@@ -330,7 +330,7 @@ static void generate_frame(CSOUND *csound, PVSANAL *p)
       /* *(anal + k) += *(analWindow + i) * *(input + j); */
       anal[k] += analWindow[i] * input[j];
     }
-    if (!(N & (N - 1))) {
+    if (!(N & 1)) {
       /* csound->RealFFT(csound, anal, N);*/
       csound->RealFFT2(csound,p->setup,anal);
       anal[N] = anal[1];
@@ -837,7 +837,7 @@ int32_t pvsynthset(CSOUND *csound, PVSYNTH *p)
     p->nextOut = (MYFLT *) (p->output.auxp);
     p->buflen = buflen;
 
-    if (!(N & (N - 1))) /* if pow of two use this */
+    if (!(N & 1)) /* even sizes use the planned transform */
       p->setup = csound->RealFFT2Setup(csound,N,FFT_INV);
     return OK;
 }
@@ -939,7 +939,7 @@ static void process_frame(CSOUND *csound, PVSYNTH *p)
        program must take care to zero each location which it "shifts"
        out (to standard output). The subroutines reals and fft
        together perform an efficient inverse FFT.  */
-    if (!(NO & (NO - 1))) {
+    if (!(NO & 1)) {
       /*printf("N %d %d \n", NO, NO & (NO-1));*/
       syn[1] = syn[NO];
       /* csound->InverseRealFFT(csound, syn, NO);*/
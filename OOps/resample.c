@@ -0,0 +1,368 @@
+/*
+    resample.c:
+
+    Copyright (C) 2026
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Polyphase sample rate conversion.
+ *
+ * The filter is a Kaiser windowed sinc, precomputed as a bank of phases:
+ * when the ratio of the rates is p / q in lowest terms with q small
+ * enough, the bank holds the q phases that are actually needed and the
+ * conversion is exact; otherwise it holds RS_PHASES phases and the
+ * coefficients are interpolated linearly between two of them.  An exact
+ * bank of fewer than RS_PHASES phases (down to one, at 2:1) is made
+ * finer by a whole factor, so that csoundResamplerCoefs() has as many
+ * phases to interpolate from at any position; conversion only reads the
+ * rows of the q phases.  Banks are
+ * cached for the lifetime of the instance.
+ *
+ * Each output sample is then one (or two) inner products over contiguous
+ * input and coefficients, with independent partial sums so that the
+ * compiler can vectorise them.  Input is streamed through a short history
+ * per channel, so memory does not depend on the length of the signal, and
+ * channels do not share any state apart from the (read only) bank.
+ */
+
+#include "csoundCore.h"
+#include "resample.h"
+#include <math.h>
+
+#define RS_BANK_CACHE   "::resamplerBanks"
+#define RS_MAX_PHASES   1024    /* largest exact polyphase bank */
+#define RS_PHASES       512     /* phases of an interpolated bank */
+#define RS_SUB_BITS     16      /* position resolution between phases */
+#define RS_BLOCK        1024    /* input frames per inner loop */
+#define RS_BETA         9.0     /* Kaiser window, about 90 dB stopband */
+
+extern double besseli(double);
+
+typedef struct RS_BANK_ {
+    MYFLT   insr, outsr;
+    int32_t quality;
+    int32_t ntaps;              /* per phase, a multiple of 4 */
+    int32_t nphases;
+    int32_t interp;             /* interpolate between phases */
+    int64_t unit;               /* position units per input frame */
+    int64_t step;               /* position increment per output frame */
+    MYFLT   *coefs;             /* nphases + 1 rows of ntaps */
+    void    *shared;            /* converter for csoundResamplerCoefs() */
+    struct RS_BANK_ *nxt;
+} RS_BANK;
+
+typedef struct {
+    MYFLT   *hist;              /* input not yet consumed */
+    int32_t fill;               /* frames in hist */
+    int64_t acc;                /* position of the next output in hist */
+    int64_t nin, nout;          /* totals, to end the output exactly */
+    int32_t done;
+} RS_CHAN;
+
+typedef struct {
+    RS_BANK *bank;
+    int32_t nchnls;
+    RS_CHAN *chan;
+} RESAMPLER;
+
+static int64_t rs_gcd(int64_t a, int64_t b)
+{
+    while (b) {
+      int64_t t = a % b;
+      a = b; b = t;
+    }
+    return a;
+}
+
+/* filter length at the lower of the two rates */
+static int32_t rs_taps(RS_BANK *b)
+{
+    double  ratio = (double) b->outsr / (double) b->insr;
+    int32_t half = 8 * b->quality;
+
+    if (ratio < 1.0)
+      half = (int32_t) ceil(half / ratio);
+    return 2 * ((half + 1) & ~1);
+}
+
+static void rs_design(RS_BANK *b)
+{
+    double  ratio = (double) b->outsr / (double) b->insr;
+    double  fc, ibeta = 1.0 / besseli(RS_BETA);
+    int32_t half = b->ntaps >> 1, p, k;
+
+    /* cutoff just below the lower Nyquist frequency */
+    fc = 0.5 * (ratio < 1.0 ? ratio : 1.0) * (1.0 - 1.0 / b->ntaps);
+    for (p = 0; p <= b->nphases; p++) {
+      MYFLT  *h = b->coefs + p * b->ntaps;
+      double frac = (double) p / b->nphases, sum = 0.0;
+      for (k = 0; k < b->ntaps; k++) {
+        double t = frac + (half - 1 - k), x = t / half, v;
+        if (x <= -1.0 || x >= 1.0)
+          v = 0.0;
+        else {
+          v = besseli(RS_BETA * sqrt(1.0 - x * x)) * ibeta;
+          v *= (t == 0.0 ? 2.0 * fc : sin(TWOPI * fc * t) / (PI * t));
+        }
+        h[k] = (MYFLT) v;
+        sum += v;
+      }
+      /* unity gain at DC for every phase */
+      for (k = 0; k < b->ntaps; k++)
+        h[k] = (MYFLT) (h[k] / sum);
+    }
+}
+
+static RS_BANK *rs_bank(CSOUND *csound, MYFLT insr, MYFLT outsr,
+                        int32_t quality)
+{
+    RS_BANK **cache, *b;
+    double  in = (double) insr, out = (double) outsr;
+
+    cache = (RS_BANK**) csound->QueryGlobalVariable(csound, RS_BANK_CACHE);
+    if (cache == NULL) {
+      if (UNLIKELY(csound->CreateGlobalVariable(csound, RS_BANK_CACHE,
+                                                sizeof(RS_BANK*)) != 0))
+        return NULL;
+      cache = (RS_BANK**) csound->QueryGlobalVariable(csound, RS_BANK_CACHE);
+    }
+    for (b = *cache; b != NULL; b = b->nxt)
+      if (b->insr == insr && b->outsr == outsr && b->quality == quality)
+        return b;
+    b = (RS_BANK*) csound->Calloc(csound, sizeof(RS_BANK));
+    b->insr = insr;
+    b->outsr = outsr;
+    b->quality = quality;
+    if (in == floor(in) && out == floor(out) && in < 2147483648.0 &&
+        out < 2147483648.0) {
+      int64_t g = rs_gcd((int64_t) in, (int64_t) out);
+      if ((int64_t) out / g <= RS_MAX_PHASES) {
+        int64_t q = (int64_t) out / g, m = (RS_PHASES + q - 1) / q;
+        b->nphases = (int32_t) (q * m);
+        b->unit = b->nphases;
+        b->step = (int64_t) in / g * m;
+      }
+    }
+    if (b->nphases == 0) {
+      b->interp = 1;
+      b->nphases = RS_PHASES;
+      b->unit = (int64_t) RS_PHASES << RS_SUB_BITS;
+      b->step = (int64_t) llrint((double) b->unit * in / out);
+      if (b->step < 1)
+        b->step = 1;
+    }
+    b->ntaps = rs_taps(b);
+    b->coefs = (MYFLT*) csound->Malloc(csound, (b->nphases + 1) * b->ntaps
+                                       * sizeof(MYFLT));
+    rs_design(b);
+    b->nxt = *cache;
+    *cache = b;
+    return b;
+}
+
+void *csoundResamplerCreate(CSOUND *csound, MYFLT insr, MYFLT outsr,
+                            int nchnls, int quality)
+{
+    RESAMPLER *rs;
+    RS_BANK   *b;
+    int32_t   c, size;
+
+    if (UNLIKELY(insr <= FL(0.0) || outsr <= FL(0.0) || nchnls < 0))
+      return NULL;
+    if (quality < 1)
+      quality = 1;
+    else if (quality > 8)
+      quality = 8;
+    if (UNLIKELY((b = rs_bank(csound, insr, outsr, quality)) == NULL))
+      return NULL;
+    if (nchnls == 0 && b->shared != NULL)
+      return b->shared;
+    rs = (RESAMPLER*) csound->Calloc(csound, sizeof(RESAMPLER));
+    rs->bank = b;
+    rs->nchnls = nchnls;
+    if (nchnls == 0) {
+      b->shared = rs;
+      return rs;
+    }
+    size = b->ntaps + RS_BLOCK;
+    rs->chan = (RS_CHAN*) csound->Calloc(csound, nchnls * sizeof(RS_CHAN));
+    rs->chan[0].hist = (MYFLT*) csound->Calloc(csound, nchnls * size
+                                               * sizeof(MYFLT));
+    for (c = 0; c < nchnls; c++) {
+      RS_CHAN *ch = &rs->chan[c];
+      ch->hist = rs->chan[0].hist + c * size;
+      /* zeros before the first input frame, which is the position of the
+         first output, so that there is no delay */
+      ch->fill = b->ntaps / 2 - 1;
+      ch->acc = ch->fill * b->unit;
+    }
+    return rs;
+}
+
+void csoundResamplerDestroy(CSOUND *csound, void *p)
+{
+    RESAMPLER *rs = (RESAMPLER*) p;
+
+    if (rs == NULL || rs->nchnls == 0)
+      return;
+    csound->Free(csound, rs->chan[0].hist);
+    csound->Free(csound, rs->chan);
+    csound->Free(csound, rs);
+}
+
+int csoundResamplerFrames(CSOUND *csound, void *p, int nin)
+{
+    RS_BANK *b = ((RESAMPLER*) p)->bank;
+    IGN(csound);
+    return (int) (((int64_t) (nin + b->ntaps) * b->unit) / b->step) + 2;
+}
+
+static inline MYFLT rs_dot(const MYFLT *x, const MYFLT *h, int32_t n)
+{
+    MYFLT   s0 = FL(0.0), s1 = FL(0.0), s2 = FL(0.0), s3 = FL(0.0);
+    int32_t k;
+
+    for (k = 0; k < n; k += 4) {
+      s0 += x[k] * h[k];
+      s1 += x[k + 1] * h[k + 1];
+      s2 += x[k + 2] * h[k + 2];
+      s3 += x[k + 3] * h[k + 3];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+int csoundResamplerCoefs(CSOUND *csound, void *p, double frac, MYFLT *coefs)
+{
+    RS_BANK *b = ((RESAMPLER*) p)->bank;
+    const MYFLT *h0, *h1;
+    double  x = frac * b->nphases;
+    int32_t row, k;
+    MYFLT   t;
+    IGN(csound);
+
+    if (coefs == NULL)
+      return b->ntaps;
+    row = (int32_t) x;
+    if (UNLIKELY(row < 0))
+      row = 0;
+    else if (UNLIKELY(row >= b->nphases))
+      row = b->nphases - 1;
+    t = (MYFLT) (x - row);
+    h0 = b->coefs + row * b->ntaps;
+    h1 = h0 + b->ntaps;
+    for (k = 0; k < b->ntaps; k++)
+      coefs[k] = h0[k] + t * (h1[k] - h0[k]);
+    return b->ntaps;
+}
+
+/* produce the outputs that the history allows; out has stride nchnls */
+static int32_t rs_run(RESAMPLER *rs, RS_CHAN *ch, MYFLT *out, int64_t limit)
+{
+    RS_BANK *b = rs->bank;
+    int32_t ntaps = b->ntaps, half = ntaps >> 1, nout = 0, d;
+    int64_t acc = ch->acc, unit = b->unit;
+
+    while (ch->nout < limit) {
+      int64_t n = acc / unit, r = acc - n * unit;
+      const MYFLT *x, *h;
+      if (n + half >= ch->fill)
+        break;
+      x = ch->hist + (n - half + 1);
+      if (!b->interp) {
+        h = b->coefs + r * ntaps;
+        *out = rs_dot(x, h, ntaps);
+      }
+      else {
+        MYFLT t = (MYFLT) (r & ((1 << RS_SUB_BITS) - 1))
+                  * (FL(1.0) / (MYFLT) (1 << RS_SUB_BITS));
+        h = b->coefs + (r >> RS_SUB_BITS) * ntaps;
+        *out = rs_dot(x, h, ntaps);
+        if (t != FL(0.0))
+          *out += t * (rs_dot(x, h + ntaps, ntaps) - *out);
+      }
+      out += rs->nchnls;
+      nout++;
+      ch->nout++;
+      acc += b->step;
+    }
+    /* drop the input that no later output needs */
+    d = (int32_t) (acc / unit) - (half - 1);
+    if (d > ch->fill)
+      d = ch->fill;
+    if (d > 0) {
+      memmove(ch->hist, ch->hist + d, (ch->fill - d) * sizeof(MYFLT));
+      ch->fill -= d;
+      acc -= d * unit;
+    }
+    ch->acc = acc;
+    return nout;
+}
+
+static int32_t rs_channel(RESAMPLER *rs, int32_t c, const MYFLT *in,
+                          int32_t nin, MYFLT *out)
+{
+    RS_BANK *b = rs->bank;
+    RS_CHAN *ch = &rs->chan[c];
+    int32_t nchnls = rs->nchnls, size = b->ntaps + RS_BLOCK, nout = 0, i;
+    int64_t limit = INT64_MAX;
+
+    if (ch->done)
+      return 0;
+    if (in == NULL) {
+      /* end of input: the outputs up to its length, with zeros after it */
+      ch->done = 1;
+      nin = b->ntaps >> 1;
+      limit = (ch->nin * b->unit + b->step - 1) / b->step;
+    }
+    while (nin > 0) {
+      int32_t n = size - ch->fill;
+      MYFLT   *x = ch->hist + ch->fill;
+      if (n > nin)
+        n = nin;
+      if (in != NULL) {
+        const MYFLT *src = in + c;
+        for (i = 0; i < n; i++, src += nchnls)
+          x[i] = *src;
+        in += n * nchnls;
+        ch->nin += n;
+      }
+      else
+        memset(x, 0, n * sizeof(MYFLT));
+      ch->fill += n;
+      nin -= n;
+      nout += rs_run(rs, ch, out + nout * nchnls + c, limit);
+    }
+    return nout;
+}
+
+int csoundResample(CSOUND *csound, void *p, int chn,
+                   const MYFLT *in, int nin, MYFLT *out)
+{
+    RESAMPLER *rs = (RESAMPLER*) p;
+    int32_t   c, nout = 0;
+    IGN(csound);
+
+    if (UNLIKELY(rs->nchnls == 0 || chn >= rs->nchnls))
+      return 0;
+    if (chn >= 0)
+      return rs_channel(rs, chn, in, nin, out);
+    for (c = 0; c < rs->nchnls; c++)
+      nout = rs_channel(rs, c, in, nin, out);
+    return nout;
+}
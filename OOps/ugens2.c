@@ -23,6 +23,7 @@
 
 #include "csoundCore.h" /*                              UGENS2.C        */
 #include "ugens2.h"
+#include "ftmipmap.h"
 #include <math.h>
 
 /* Macro form of Istvan's speedup ; constant should be 3fefffffffffffff */
@@ -1191,6 +1192,75 @@ int32_t oscsetA(CSOUND *csound, OSC *p)
     else return csound->InitError(csound, Str("array size not pow-of-two\n"));
 }
 
+/* band-limited oscil, oscili and oscil3: each sample mixes the two
+   levels of the table around the phase increment; the a-rate routines
+   hand over to it while p->mip is set */
+
+static int32_t oscbl(CSOUND *csound, OSC *p)
+{
+    FTMIPMAP *mip = p->mip;
+    MYFLT   *ar, *amp, *cps, w;
+    MYFLT   lodiv, sicvt = csound->sicvt;
+    int32_t phs, inc, k, order;
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t n, nsmps = CS_KSMPS;
+
+    lodiv = mip->level[0].lodiv;
+    order = p->order;
+    phs = p->lphs;
+    amp = p->xamp;
+    cps = p->xcps;
+    ar = p->sr;
+    if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
+    }
+    inc = MYFLT2LONG(*cps * sicvt);
+    k = ftmip_level(mip, inc * lodiv, &w);
+    for (n=offset;n<nsmps;n++) {
+      if (p->cpscod) {
+        inc = MYFLT2LONG(cps[n] * sicvt);
+        k = ftmip_level(mip, inc * lodiv, &w);
+      }
+      ar[n] = ftmip_mix(mip, k, w, phs, order) * amp[p->ampcod ? n : 0];
+      phs = (phs+inc) & PHMASK;
+    }
+    p->lphs = phs;
+    return OK;
+}
+
+static int32_t oscbl_deinit(CSOUND *csound, void *p)
+{
+    ftmipmap_release(csound, ((OSC*) p)->mip);
+    ((OSC*) p)->mip = NULL;
+    return OK;
+}
+
+/* a mip-map still held here comes from an earlier pass of a reinit,
+   which has already registered the deinit callback */
+
+static int32_t oscblset(CSOUND *csound, OSC *p, int order)
+{
+    int     held = (p->mip != NULL);
+
+    ftmipmap_release(csound, p->mip);
+    p->mip = NULL;
+    if (p->ibl == NULL || *p->ibl == FL(0.0))
+      return OK;
+    if (UNLIKELY((p->mip = csound->FTMipMap(csound, p->ftp)) == NULL))
+      return csound->InitError(csound, Str("table %d cannot be band-limited "
+                                           "(not a mono table with a power "
+                                           "of two size)"), p->ftp->fno);
+    if (!held)
+      csound->RegisterDeinitCallback(csound, p, oscbl_deinit);
+    p->order = order;
+    p->ampcod = IS_ASIG_ARG(p->xamp) ? 1 : 0;
+    p->cpscod = IS_ASIG_ARG(p->xcps) ? 1 : 0;
+    return OK;
+}
+
 int32_t oscset(CSOUND *csound, OSC *p)
 {
     FUNC        *ftp;
@@ -1198,11 +1268,19 @@ int32_t oscset(CSOUND *csound, OSC *p)
       p->ftp = ftp;
       if (*p->iphs >= 0)
         p->lphs = ((int32_t)(*p->iphs * FMAXLEN)) & PHMASK;
-      return OK;
+      return oscblset(csound, p, 1);
     }
     return NOTOK;
 }
 
+int32_t oscset3(CSOUND *csound, OSC *p)
+{
+    if (UNLIKELY(oscset(csound, p) != OK))
+      return NOTOK;
+    p->order = 3;
+    return OK;
+}
+
 int32_t koscil(CSOUND *csound, OSC *p)
 {
     FUNC    *ftp;
@@ -1231,6 +1309,8 @@ int32_t osckk(CSOUND *csound, OSC *p)
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     ftbl = ftp->ftable;
@@ -1268,6 +1348,8 @@ int32_t oscka(CSOUND *csound, OSC *p)
     uint32_t n, nsmps = CS_KSMPS;
     MYFLT   sicvt = csound->sicvt;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     ftbl = ftp->ftable;
@@ -1303,6 +1385,8 @@ int32_t oscak(CSOUND *csound, OSC *p)
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     ftbl = ftp->ftable;
@@ -1337,6 +1421,8 @@ int32_t oscaa(CSOUND *csound, OSC *p)
     uint32_t n, nsmps = CS_KSMPS;
     MYFLT   sicvt = csound->sicvt;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     ftbl = ftp->ftable;
@@ -1394,6 +1480,8 @@ int32_t osckki(CSOUND *csound, OSC   *p)
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     if (UNLIKELY((ftp = p->ftp)==NULL)) goto err1;
     lobits = ftp->lobits;
     phs = p->lphs;
@@ -1430,6 +1518,8 @@ int32_t osckai(CSOUND *csound, OSC   *p)
     uint32_t n, nsmps = CS_KSMPS;
     MYFLT   sicvt = csound->sicvt;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     lobits = ftp->lobits;
@@ -1469,6 +1559,8 @@ int32_t oscaki(CSOUND *csound, OSC   *p)
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     lobits = ftp->lobits;
@@ -1506,6 +1598,8 @@ int32_t oscaai(CSOUND *csound, OSC   *p)
     uint32_t n, nsmps = CS_KSMPS;
     MYFLT   sicvt = csound->sicvt;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     ft = ftp->ftable;
@@ -1587,6 +1681,8 @@ int32_t osckk3(CSOUND *csound, OSC   *p)
     int32_t   x0;
     MYFLT   y0, y1, ym1, y2;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     ftab = ftp->ftable;
@@ -1647,6 +1743,8 @@ int32_t oscka3(CSOUND *csound, OSC   *p)
     MYFLT   y0, y1, ym1, y2;
     MYFLT   sicvt = csound->sicvt;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     ftab = ftp->ftable;
@@ -1702,6 +1800,8 @@ int32_t oscak3(CSOUND *csound, OSC   *p)
     int32_t   x0;
     MYFLT   y0, y1, ym1, y2;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     ftab = ftp->ftable;
@@ -1756,6 +1856,8 @@ int32_t oscaa3(CSOUND *csound, OSC   *p)
     MYFLT    y0, y1, ym1, y2;
     MYFLT    sicvt = csound->sicvt;
 
+    if (p->mip != NULL)
+      return oscbl(csound, p);
     ftp = p->ftp;
     if (UNLIKELY(ftp==NULL)) goto err1;
     ftab = ftp->ftable;
@@ -24,6 +24,7 @@
 
 #include "csoundCore.h" /*                              UGENS6.C        */
 #include "ugens6.h"
+#include "delayline.h"
 #include <math.h>
 
 #define log001 (-FL(6.9078))    /* log(.001) */
@@ -256,8 +257,7 @@ int32_t samphold(CSOUND *csound, SAMPHOLD *p)
 
 int32_t delset(CSOUND *csound, DELAY *p)
 {
-    int32_t      npts;
-    char        *auxp;
+    int32_t      npts, len;
 
     if (UNLIKELY(*p->istor && p->auxch.auxp != NULL))
       return OK;
@@ -265,25 +265,20 @@ int32_t delset(CSOUND *csound, DELAY *p)
     if (UNLIKELY((npts = MYFLT2LRND(*p->idlt * csound->esr)) <= 0)) {
       return csound->InitError(csound, Str("illegal delay time"));
     }
-
-    if ((auxp = p->auxch.auxp) == NULL ||
-        npts != p->npts) { /* new space if reqd */
-      csound->AuxAlloc(csound, (int32_t)npts*sizeof(MYFLT), &p->auxch);
-      auxp = p->auxch.auxp;
-      p->npts = npts;
-    }
-    else if (!(*p->istor)) {                    /* else if requested */
-      memset(auxp, '\0', npts*sizeof(MYFLT));
-    }
-    p->curp = (MYFLT *) auxp;
-
+    /* new space if reqd, else cleared: one sample more than the delay, as
+       the block is written before it is read */
+    len = npts + 1;
+    p->line = csound->DelayLineCreate(csound, &p->auxch, 1, &len, CS_KSMPS);
+    if (UNLIKELY(p->line == NULL))
+      return csound->InitError(csound, Str("illegal delay time"));
+    p->npts = npts;
     return OK;
 }
 
 int32_t delrset(CSOUND *csound, DELAYR *p)
 {
     uint32_t    npts;
-    MYFLT       *auxp;
+    int32       len;
 
     if (UNLIKELY(!IS_ASIG_ARG(p->ar)))
       return csound->InitError(csound, Str("delayr: invalid outarg type"));
@@ -307,16 +302,13 @@ int32_t delrset(CSOUND *csound, DELAYR *p)
     if (UNLIKELY((npts=(uint32_t)MYFLT2LRND(*p->idlt*csound->esr)) < CS_KSMPS)) {
       return csound->InitError(csound, Str("illegal delay time"));
     }
-    if ((auxp = (MYFLT*)p->auxch.auxp) == NULL ||       /* new space if reqd */
-        npts != p->npts) {
-      csound->AuxAlloc(csound, (int32_t)npts*sizeof(MYFLT), &p->auxch);
-      auxp = (MYFLT*)p->auxch.auxp;
-      p->npts = npts;
-    }
-    else if (*p->istor == FL(0.0)) {            /* else if requested */
-      memset(auxp, 0, npts*sizeof(MYFLT));
-    }
-    p->curp = auxp;
+    /* new space if reqd, else cleared; room for the window of deltapx */
+    len = (int32) npts;
+    p->line = csound->DelayLineCreate(csound, &p->auxch, 1, &len,
+                                      CS_KSMPS + CS_DELAY_MAXWIN);
+    if (UNLIKELY(p->line == NULL))
+      return csound->InitError(csound, Str("illegal delay time"));
+    p->npts = npts;
     return OK;
 }
 
@@ -371,13 +363,36 @@ int32_t tapset(CSOUND *csound, DELTAP *p)
     return (p->delayr != NULL ? OK : NOTOK);
 }
 
+/* one tap of a delay line, for samples offset to nsmps - 1 of the block
+   starting at the write position; delays of the taps of delayr are read
+   before delayw has written the block, and wrap around npts as they did
+   in its circular buffer */
+
+static void delay_tap(CSOUND *csound, CS_DELAYLINE *line, MYFLT *out,
+                      MYFLT *del, MYFLT scale, int arate, int interp,
+                      int wsize, uint32_t offset, uint32_t nsmps)
+{
+    CS_DELAYTAP tap;
+
+    tap.out = out;
+    tap.del = del;
+    tap.scale = scale;
+    tap.gain = FL(1.0);
+    tap.arate = arate;
+    tap.add = 0;
+    csound->DelayLineRead(csound, line, &tap, 1,
+                          line->wpos - (int32) offset, offset, nsmps,
+                          interp, wsize);
+}
+
 int32_t delay(CSOUND *csound, DELAY *p)
 {
-    MYFLT       *ar, *asig, *curp, *endp;
+    MYFLT       *ar, del;
     uint32_t offset = 0;
-    uint32_t n, nsmps = CS_KSMPS;
+    uint32_t nsmps = CS_KSMPS;
+    int32       start;
 
-    if (UNLIKELY(p->auxch.auxp==NULL)) goto err1;  /* RWD fix */
+    if (UNLIKELY(p->line==NULL)) goto err1;  /* RWD fix */
     ar = p->ar;
     if (csound->oparms->sampleAccurate) {
       uint32_t early  = p->h.insdshead->ksmps_no_end;
@@ -389,18 +404,18 @@ int32_t delay(CSOUND *csound, DELAY *p)
         memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
       }
     }
-    asig = p->asig;
-    curp = p->curp;
-    endp = (MYFLT *) p->auxch.endp;
-    for (n=offset; n<nsmps; n++) {
-      MYFLT in = asig[n];       /* Allow overwriting form */
-      ar[n] = *curp;
-      *curp = in;
-      if (UNLIKELY(++curp >= endp))
-        curp = (MYFLT *) p->auxch.auxp;
+    if (UNLIKELY(nsmps <= offset)) return OK;
+    /* written first, allowing overwriting form */
+    start = p->line->wpos - (int32) offset;
+    csound->DelayLineWrite(csound, p->line, p->asig + offset, nsmps - offset);
+    del = (MYFLT) p->npts;
+    {
+      CS_DELAYTAP tap;
+      tap.out = ar; tap.del = &del; tap.scale = FL(1.0); tap.gain = FL(1.0);
+      tap.arate = 0; tap.add = 0;
+      csound->DelayLineRead(csound, p->line, &tap, 1, start, offset, nsmps,
+                            CS_DELAY_NONE, 0);
     }
-    p->curp = curp;             /* sav the new curp */
-
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
@@ -409,25 +424,21 @@ int32_t delay(CSOUND *csound, DELAY *p)
 
 int32_t delayr(CSOUND *csound, DELAYR *p)
 {
-    MYFLT       *ar, *curp, *endp;
+    MYFLT       *ar, del;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
+    uint32_t nsmps = CS_KSMPS;
 
-    if (UNLIKELY(p->auxch.auxp==NULL)) goto err1; /* RWD fix */
+    if (UNLIKELY(p->line==NULL)) goto err1; /* RWD fix */
     ar = p->ar;
     if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    curp = p->curp;
-    endp = (MYFLT *) p->auxch.endp;
-    for (n=offset; n<nsmps; n++) {
-      ar[n] = *curp++;
-      if (UNLIKELY(curp >= endp))
-        curp = (MYFLT *) p->auxch.auxp;
-    }
+    del = (MYFLT) p->npts;
+    delay_tap(csound, p->line, ar, &del, FL(1.0), 0, CS_DELAY_NONE, 0,
+              offset, nsmps);
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
@@ -437,22 +448,15 @@ int32_t delayr(CSOUND *csound, DELAYR *p)
 int32_t delayw(CSOUND *csound, DELAYW *p)
 {
     DELAYR      *q = p->delayr;
-    MYFLT       *asig, *curp, *endp;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
+    uint32_t nsmps = CS_KSMPS;
 
-    if (UNLIKELY(q->auxch.auxp==NULL)) goto err1; /* RWD fix */
-    asig = p->asig;
-    curp = q->curp;
-    endp = (MYFLT *) q->auxch.endp;
+    if (UNLIKELY(q->line==NULL)) goto err1; /* RWD fix */
     if (UNLIKELY(early)) nsmps -= early;
-    for (n=offset; n<nsmps; n++) {
-      *curp = asig[n];
-      if (UNLIKELY(++curp >= endp))
-        curp = (MYFLT *) q->auxch.auxp;
-    }
-    q->curp = curp;                                     /* now sav new curp */
+    if (LIKELY(nsmps > offset))
+      csound->DelayLineWrite(csound, q->line, p->asig + offset,
+                             nsmps - offset);
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
@@ -462,84 +466,59 @@ int32_t delayw(CSOUND *csound, DELAYW *p)
 int32_t deltap(CSOUND *csound, DELTAP *p)
 {
     DELAYR      *q = p->delayr;
-    MYFLT       *ar, *tap, *endp;
+    MYFLT       *ar, del;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
+    uint32_t nsmps = CS_KSMPS;
 
-    if (UNLIKELY(q->auxch.auxp==NULL)) goto err1; /* RWD fix */
+    if (UNLIKELY(q->line==NULL)) goto err1; /* RWD fix */
     ar = p->ar;
     if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    tap = q->curp - MYFLT2LRND(*p->xdlt * csound->esr);
-    while (tap < (MYFLT *) q->auxch.auxp)
-      tap += q->npts;
-    endp = (MYFLT *) q->auxch.endp;
-    for (n=offset; n<nsmps; n++) {
-      if (UNLIKELY(tap >= endp))
-        tap -= q->npts;
-      ar[n] = *tap++;
-    }
+    del = (MYFLT) MYFLT2LRND(*p->xdlt * csound->esr);
+    delay_tap(csound, q->line, ar, &del, FL(1.0), 0, CS_DELAY_NONE, 0,
+              offset, nsmps);
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
                              Str("deltap: not initialised"));
 }
 
+/* an infinite delay time for deltapi and deltap3 */
+
+static int deltap_inf(DELTAP *p, uint32_t offset, uint32_t nsmps)
+{
+    uint32_t n;
+
+    if (!IS_ASIG_ARG(p->xdlt))
+      return (*p->xdlt == INFINITY);
+    for (n = offset; n < nsmps; n++)
+      if (p->xdlt[n] == INFINITY)
+        return 1;
+    return 0;
+}
+
 int32_t deltapi(CSOUND *csound, DELTAP *p)
 {
     DELAYR      *q = p->delayr;
-    MYFLT       *ar, *tap, *prv, *begp, *endp;
+    MYFLT       *ar;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-    int32_t       idelsmps;
-    MYFLT       delsmps, delfrac;
+    uint32_t nsmps = CS_KSMPS;
 
-    if (UNLIKELY(q->auxch.auxp==NULL)) goto err1;
+    if (UNLIKELY(q->line==NULL)) goto err1;
     ar = p->ar;
     if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    begp = (MYFLT *) q->auxch.auxp;
-    endp = (MYFLT *) q->auxch.endp;
-    if (!IS_ASIG_ARG(p->xdlt)) {
-      if (*p->xdlt == INFINITY) goto err2;
-      delsmps = *p->xdlt * csound->esr;
-      idelsmps = (int32_t)delsmps;
-      delfrac = delsmps - idelsmps;
-      tap = q->curp - idelsmps;
-      while (tap < begp) tap += q->npts;
-      for (n=offset; n<nsmps; n++) {
-        if (UNLIKELY(tap >= endp))
-          tap -= q->npts;
-        if (UNLIKELY((prv = tap - 1) < begp))
-          prv += q->npts;
-        ar[n] = *tap + (*prv - *tap) * delfrac;
-        tap++;
-      }
-    }
-    else {
-      MYFLT *timp = p->xdlt, *curq = q->curp;
-      for (n=offset; n<nsmps; n++) {
-        if (timp[n] == INFINITY) goto err2;
-        delsmps = timp[n] * csound->esr;
-        idelsmps = (int32_t)delsmps;
-        delfrac = delsmps - idelsmps;
-        tap = curq++ - idelsmps;
-        if (UNLIKELY(tap < begp)) tap += q->npts;
-        else if (UNLIKELY(tap >= endp))
-          tap -= q->npts;
-        if (UNLIKELY((prv = tap - 1) < begp))
-          prv += q->npts;
-        ar[n] = *tap + (*prv - *tap) * delfrac;
-      }
-    }
+    if (UNLIKELY(deltap_inf(p, offset, nsmps))) goto err2;
+    delay_tap(csound, q->line, ar, p->xdlt, csound->esr,
+              IS_ASIG_ARG(p->xdlt), CS_DELAY_LINEAR, 0, offset, nsmps);
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
@@ -554,48 +533,20 @@ int32_t deltapi(CSOUND *csound, DELTAP *p)
 int32_t deltapn(CSOUND *csound, DELTAP *p)
 {
     DELAYR *q = p->delayr;
-    MYFLT  *ar, *tap, *begp, *endp;
+    MYFLT  *ar;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-    int32_t  idelsmps;
-    MYFLT  delsmps;
+    uint32_t nsmps = CS_KSMPS;
 
-    if (UNLIKELY(q->auxch.auxp==NULL)) goto err1;
+    if (UNLIKELY(q->line==NULL)) goto err1;
     ar = p->ar;
     if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    begp = (MYFLT *) q->auxch.auxp;
-    endp = (MYFLT *) q->auxch.endp;
-    if (!IS_ASIG_ARG(p->xdlt)) {
-      delsmps = *p->xdlt;
-      idelsmps = (int32_t)delsmps;
-      tap = q->curp - idelsmps;
-      while (tap < begp) tap += q->npts;
-      for (n=offset; n<nsmps; n++) {
-        while (UNLIKELY(tap >= endp ))
-          tap -= q->npts;
-        while (UNLIKELY(tap < begp))
-          tap += q->npts;
-        ar[n] = *tap;
-        tap++;
-      }
-    }
-    else {
-      MYFLT *timp = p->xdlt, *curq = q->curp;
-      for (n=offset; n<nsmps; n++) {
-        delsmps = timp[n];
-        idelsmps = (int32_t)delsmps;
-        if (UNLIKELY((tap = curq++ - idelsmps) < begp))
-          tap += q->npts;
-        else if (UNLIKELY(tap >= endp))
-          tap -= q->npts;
-        ar[n] = *tap;
-      }
-    }
+    delay_tap(csound, q->line, ar, p->xdlt, FL(1.0), IS_ASIG_ARG(p->xdlt),
+              CS_DELAY_NONE, 0, offset, nsmps);
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
@@ -606,82 +557,21 @@ int32_t deltapn(CSOUND *csound, DELTAP *p)
 int32_t deltap3(CSOUND *csound, DELTAP *p)
 {
     DELAYR      *q = p->delayr;
-    MYFLT       *ar, *tap, *prv, *begp, *endp;
+    MYFLT       *ar;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-    int32_t       idelsmps;
-    MYFLT       delsmps, delfrac;
+    uint32_t nsmps = CS_KSMPS;
 
-    if (UNLIKELY(q->auxch.auxp==NULL)) goto err1;
+    if (UNLIKELY(q->line==NULL)) goto err1;
     ar = p->ar;
     if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    begp = (MYFLT *) q->auxch.auxp;
-    endp = (MYFLT *) q->auxch.endp;
-    if (!IS_ASIG_ARG(p->xdlt)) {
-      if (*p->xdlt == INFINITY) goto err2;
-      delsmps = *p->xdlt * csound->esr;
-      idelsmps = (int32_t)delsmps;
-      delfrac = delsmps - idelsmps;
-      tap = q->curp - idelsmps;
-      while (tap < begp) tap += q->npts;
-      for (n=offset; n<nsmps; n++) {
-        MYFLT ym1, y0, y1, y2;
-        if (UNLIKELY(tap >= endp))
-          tap -= q->npts;
-        if (UNLIKELY((prv = tap - 1) < begp))
-          prv += q->npts;
-        if (UNLIKELY(prv - 1 < begp))
-          y2 = *(prv-1+q->npts);
-        else
-          y2 = *(prv-1);
-        if (UNLIKELY(tap + 1 >= endp))
-          ym1 = *(tap+1-q->npts);
-        else
-          ym1 = *(tap+1);
-        y0 = *tap; y1 = *prv;
-        {
-          MYFLT w, x, y, z;
-          z = delfrac * delfrac; z--; z *= FL(0.16666666666667);
-          y = delfrac; y++; w = (y *= FL(0.5)); w--;
-          x = FL(3.0) * z; y -= x; w -= z; x -= delfrac;
-          ar[n] = (w*ym1 + x*y0 + y*y1 + z*y2) * delfrac + y0;
-        }
-        tap++;
-      }
-    }
-    else {
-      MYFLT *timp = p->xdlt, *curq = q->curp;
-      for (n=offset; n<nsmps; n++) {
-        MYFLT ym1, y0, y1, y2;
-        if (timp[n] == INFINITY) goto err2;
-        delsmps = *timp++ * csound->esr;
-        idelsmps = (int32_t)delsmps;
-        delfrac = delsmps - idelsmps;
-        if (UNLIKELY((tap = curq++ - idelsmps) < begp))
-          tap += q->npts;
-        else if (UNLIKELY(tap >= endp))
-          tap -= q->npts;
-        if (UNLIKELY((prv = tap - 1) < begp))
-          prv += q->npts;
-        if (UNLIKELY(prv - 1 < begp)) y2 = *(prv-1+q->npts);
-        else                          y2 = *(prv-1);
-        if (UNLIKELY(tap + 1 >= endp)) ym1 = *(tap+1-q->npts);
-        else                           ym1 = *(tap+1);
-        y0 = *tap; y1 = *prv;
-        {
-          MYFLT w, x, y, z;
-          z = delfrac * delfrac; z--; z *= FL(0.1666666667);
-          y = delfrac; y++; w = (y *= FL(0.5)); w--;
-          x = FL(3.0) * z; y -= x; w -= z; x -= delfrac;
-          ar[n] = (w*ym1 + x*y0 + y*y1 + z*y2) * delfrac + y0;
-        }
-      }
-    }
+    if (UNLIKELY(deltap_inf(p, offset, nsmps))) goto err2;
+    delay_tap(csound, q->line, ar, p->xdlt, csound->esr,
+              IS_ASIG_ARG(p->xdlt), CS_DELAY_CUBIC, 0, offset, nsmps);
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
@@ -705,94 +595,29 @@ int32_t tapxset(CSOUND *csound, DELTAPX *p)
     if (UNLIKELY(p->wsize < 4)) p->wsize = 4;
     if (UNLIKELY(p->wsize > 1024)) p->wsize = 1024;
     /* wsize = 4: d2x = 1 - 1/3, wsize = 64: d2x = 1 - 1/36 */
-    p->d2x = 1.0 - pow((double)p->wsize * 0.85172, -0.89624);
-    p->d2x /= (double)((p->wsize * p->wsize) >> 2);
+    p->d2x = csoundDelayLineD2x(p->wsize);
     return OK;
 }
 
 int32_t deltapx(CSOUND *csound, DELTAPX *p)                 /* deltapx opcode */
 {
     DELAYR  *q = p->delayr;
-    MYFLT   *out1, *del, *buf1, *bufp, *bufend;
+    MYFLT   *out1;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-    int32_t   indx, maxd, xpos;
+    uint32_t nsmps = CS_KSMPS;
 
-    if (UNLIKELY(q->auxch.auxp == NULL)) goto err1; /* RWD fix */
-    out1 = p->ar; del = p->adlt;
+    if (UNLIKELY(q->line == NULL)) goto err1; /* RWD fix */
+    out1 = p->ar;
     if (UNLIKELY(offset)) memset(out1, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
       memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
     }
-    buf1 = (MYFLT *) q->auxch.auxp;
-    indx = (int32_t) (q->curp - buf1);
-    maxd = q->npts; bufend = buf1 + maxd;
-
-    if (p->wsize != 4) {                /* window size >= 8 */
-      double  d, x1, n1, w, d2x;
-      int32_t     i2, i;
-      i2 = (p->wsize >> 1);
-      /* wsize = 4: d2x = 1 - 1/3, wsize = 64: d2x = 1 - 1/36 */
-      d2x = p->d2x;
-      for (n=offset; n<nsmps; n++) {
-        /* x1: fractional part of delay time */
-        /* x2: sine of x1 (for interpolation) */
-        /* xpos: integer part of delay time (buffer position to read from) */
-
-        x1 = (double)indx - (double)*(del++) * (double)csound->esr;
-        while (x1 < 0.0) x1 += (double)maxd;
-        xpos = (int32_t)x1; x1 -= (double)xpos;
-        while (xpos >= maxd) xpos -= maxd;
-
-        if (x1 > 0.00000001 && x1 < 0.99999999) {
-          xpos -= i2;
-          while (xpos < 0) xpos += maxd;
-          d = (double)(1 - i2) - x1;
-          bufp = buf1 + xpos;
-          i = i2;
-          n1 = 0.0;
-          do {
-            w = 1.0 - d * d * d2x;
-            if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-            n1 += w * w * (double)*bufp / d; d++;
-            w = 1.0 - d * d * d2x;
-            if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-            n1 -= w * w * (double)*bufp / d; d++;
-          } while (--i);
-          out1[n] = (MYFLT)(n1 * sin(PI * x1) / PI);
-        }
-        else {                                          /* integer sample */
-          xpos = MYFLT2LRND((double)xpos + x1);         /* position */
-          if (xpos >= maxd) xpos -= maxd;
-          out1[n] = buf1[xpos];
-        }
-        indx++;
-      }
-    }
-    else {                          /* window size = 4, cubic interpolation */
-      double  x, am1, a0, a1, a2;
-      for (n=offset; n<nsmps; n++) {
-        am1 = (double)indx - (double)*(del++) * (double)csound->esr;
-        while (am1 < 0.0) am1 += (double)maxd;
-        xpos = (int32_t) am1; am1 -= (double)xpos;
-
-        a0  = am1 * am1; a2 = 0.16666667 * (am1 * a0 - am1);    /* sample +2 */
-        a1  = 0.5 * (a0 + am1) - 3.0 * a2;                      /* sample +1 */
-        am1 = 0.5 * (a0 - am1) - a2;                            /* sample -1 */
-        a0  = 3.0 * a2 - a0; a0++;                              /* sample 0  */
-
-        bufp = (xpos ? (buf1 + (xpos - 1L)) : (bufend - 1));
-        while (bufp >= bufend) bufp -= maxd;
-        x = am1 * (double)*bufp;   if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-        x += a0 * (double)*bufp;   if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-        x += a1 * (double)*bufp;   if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-        x += a2 * (double)*bufp;
-
-        indx++; out1[n] = (MYFLT)x;
-      }
-    }
+    /* window size = 4 is cubic interpolation */
+    delay_tap(csound, q->line, out1, p->adlt, csound->esr, 1,
+              p->wsize == 4 ? CS_DELAY_CUBICX : CS_DELAY_SINC, p->wsize,
+              offset, nsmps);
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
@@ -802,65 +627,36 @@ int32_t deltapx(CSOUND *csound, DELTAPX *p)                 /* deltapx opcode */
 int32_t deltapxw(CSOUND *csound, DELTAPX *p)                /* deltapxw opcode */
 {
     DELAYR  *q = p->delayr;
-    MYFLT   *in1, *del, *buf1, *bufp, *bufend;
+    CS_DELAYLINE *line = q->line;
+    MYFLT   *in1, *del;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
-    int32_t   indx, maxd, xpos;
+    int32_t   start, mask, xpos;
+    double  esr = csound->esr, rlen, pos;
 
-    if (UNLIKELY(q->auxch.auxp == NULL)) goto err1; /* RWD fix */
+    if (UNLIKELY(line == NULL)) goto err1; /* RWD fix */
     in1 = p->ar; del = p->adlt;
     if (UNLIKELY(early)) nsmps -= early;
-    buf1 = (MYFLT *) q->auxch.auxp;
-    indx = (int32_t) (q->curp - buf1);
-    maxd = q->npts; bufend = buf1 + maxd;
-
-    if (p->wsize != 4) {                /* window size >= 8 */
-      double  d, x1, n1, w, d2x;
-      int32_t     i2, i;
-      i2 = (p->wsize >> 1);
-      /* wsize = 4: d2x = 1 - 1/3, wsize = 64: d2x = 1 - 1/36 */
-      d2x = p->d2x;
-      for (n=offset; n<nsmps; n++) {
-        /* x1: fractional part of delay time */
-        /* x2: sine of x1 (for interpolation) */
-        /* xpos: integer part of delay time (buffer position to read from) */
-
-        x1 = (double)indx - (double)*(del++) * (double)csound->esr;
-        while (x1 < 0.0) x1 += (double)maxd;
-        xpos = (int32_t) x1; x1 -= (double)xpos;
-        while (xpos >= maxd) xpos -= maxd;
-
-        if (x1 > 0.00000001 && x1 < 0.99999999) {
-          n1 = (double)*in1 * (sin(PI * x1) / PI);
-          xpos -= i2;
-          while (xpos < 0) xpos += maxd;
-          d = (double)(1 - i2) - x1;
-          bufp = buf1 + xpos;
-          i = i2;
-          do {
-            w = 1.0 - d * d * d2x;
-            if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-            *bufp = (MYFLT)((double)*bufp + w * w * n1 / d); d++;
-            w = 1.0 - d * d * d2x;
-            if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-            *bufp = (MYFLT)((double)*bufp - w * w * n1 / d); d++;
-          } while (--i);
-        }
-        else {                                          /* integer sample */
-          xpos = MYFLT2LRND((double)xpos + x1);         /* position */
-          if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-          buf1[xpos] += in1[n];
-        }
-        indx++;
-      }
-    }
-    else {                          /* window size = 4, cubic interpolation */
-      double  x, am1, a0, a1, a2;
-      for (n=offset; n<nsmps; n++) {
-        am1 = (double)indx - (double)*(del++) * (double)csound->esr;
-        while (am1 < 0.0) am1 += (double)maxd;
-        xpos = (int32_t) am1; am1 -= (double)xpos;
+    start = line->wpos - (int32) offset;
+    mask = line->mask;
+    rlen = 1.0 / line->len;
+
+    /* written at the delay behind the write position, taken as deltapx
+       reads it */
+    for (n=offset; n<nsmps; n++) {
+      pos = (double) (start + (int32) n) -
+        csoundDelayLineWrap((double) del[n] * esr, n - offset + 1, line->len,
+                            rlen);
+      if (p->wsize != 4)                /* window size >= 8 */
+        csoundDelayLineAddSinc(line, pos, in1[n], p->wsize, p->d2x);
+      else {                        /* window size = 4, cubic interpolation */
+        double  x, am1, a0, a1, a2;
+        MYFLT   *buf = line->buf;
+
+        xpos = (int32_t) pos;
+        xpos -= (pos < xpos);
+        am1 = pos - xpos;
 
         a0  = am1 * am1; a2 = 0.16666667 * (am1 * a0 - am1);    /* sample +2 */
         a1  = 0.5 * (a0 + am1) - 3.0 * a2;                      /* sample +1 */
@@ -868,14 +664,10 @@ int32_t deltapxw(CSOUND *csound, DELTAPX *p)                /* deltapxw opcode *
         a0  = 3.0 * a2 - a0; a0++;                              /* sample 0  */
 
         x = (double)in1[n];
-        bufp = (xpos ? (buf1 + (xpos - 1L)) : (bufend - 1));
-        while (bufp >= bufend) bufp -= maxd;
-        *bufp += (MYFLT)(am1 * x); if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-        *bufp += (MYFLT)(a0 * x);  if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-        *bufp += (MYFLT)(a1 * x);  if (UNLIKELY(++bufp >= bufend)) bufp = buf1;
-        *bufp += (MYFLT)(a2 * x);
-
-        indx++;
+        buf[(xpos - 1) & mask] += (MYFLT)(am1 * x);
+        buf[xpos & mask] += (MYFLT)(a0 * x);
+        buf[(xpos + 1) & mask] += (MYFLT)(a1 * x);
+        buf[(xpos + 2) & mask] += (MYFLT)(a2 * x);
       }
     }
     return OK;
@@ -33,6 +33,143 @@ static inline unsigned int isPowerOfTwo (unsigned int x) {
   return (x > 0) && !(x & (x - 1)) ? 1 : 0;
 }
 
+/* Reading kernels of the audio rate readers, one for each index mode
+ * (raw or normalised), treatment of indices out of range (limited,
+ * wrapped to a power of two length, wrapped to any length) and
+ * interpolation order (none, linear, cubic).  They give the results of
+ * the per-sample code of the k-rate readers, cubic interpolation falling
+ * back to linear at the ends of the table, but with selects and blends
+ * in place of branches, so that the compiler can vectorise the loops and
+ * use gathers for the table reads where the target has them.  The output,
+ * being an a-rate variable, never lies in the table; it may be the index
+ * itself, each sample of which is read before it is written.
+ */
+
+#define TABL_NDX(NORM)                                                  \
+    tmp = (NORM ? (ndx_f[n] + offset) * mul : ndx_f[n] + offset);       \
+    ndx = (int32_t) tmp;                                                \
+    ndx -= (tmp < ndx);           /* floor(), which does not vectorise */
+
+/* fractional part, taken before the index is wrapped; only the
+ * interpolating kernels need it */
+#define TABL_FRAC                                                       \
+    MYFLT frac = tmp - ndx;
+#define TABL_NOFRAC
+
+#define TABL_LIMIT                                                      \
+    ndx = (ndx < 0 ? 0 : ndx);                                          \
+    ndx = (ndx >= len ? len - 1 : ndx);
+
+#define TABL_WRAP2                                                      \
+    ndx &= mask;
+
+#define TABL_WRAPN                                                      \
+    ndx -= (int32_t) (ndx * rlen) * len;                                \
+    ndx += (ndx < 0 ? len : 0);                                         \
+    ndx -= (ndx >= len ? len : 0);
+
+#define TABL_READ0                                                      \
+    out[n] = func[ndx];
+
+#define TABL_READ1                                                      \
+    {                                                                   \
+      MYFLT x1 = func[ndx], x2 = func[ndx + 1];                         \
+      out[n] = x1 + (x2 - x1) * frac;                                   \
+    }
+
+#define TABL_READ3                                                      \
+    {                                                                   \
+      int32_t lo = (ndx < 1), hi = (ndx == len - 1);                    \
+      MYFLT x0 = func[ndx - 1 + lo], x1 = func[ndx];                    \
+      MYFLT x2 = func[ndx + 1], x3 = func[ndx + 2 - hi];                \
+      MYFLT fracsq = frac * frac, fracub = fracsq * x0;                 \
+      MYFLT temp1 = x3 + x1 + x1 + x1, lin, cub;                        \
+      cub = x1 + FL(0.5) * fracub +                                     \
+        frac * (x2 - fracub / FL(6.0) - temp1 / FL(6.0) - x0 / FL(3.0)) + \
+        fracsq * frac * (temp1 / FL(6.0) - FL(0.5) * x2) +              \
+        fracsq * (FL(0.5) * x2 - x1);                                   \
+      lin = x1 + (x2 - x1) * frac;                                      \
+      out[n] = cub + (MYFLT) (lo | hi) * (lin - cub);                   \
+    }
+
+#define TABL_KERNEL(NAME, NORM, FRAC, WRAP, READ)                       \
+static void NAME(const TABL *p, MYFLT *CS_RESTRICT out,                 \
+                 const MYFLT *ndx_f, uint32_t n0, uint32_t n1)          \
+{                                                                       \
+    const MYFLT *CS_RESTRICT func = p->ftp->ftable;                     \
+    MYFLT   offset = *p->offset, mul = p->mul, tmp;                     \
+    int32_t len = p->len, mask = len - 1, ndx;                          \
+    double  rlen = 1.0 / len;                                           \
+    uint32_t n;                                                         \
+    IGN(mul); IGN(mask); IGN(rlen);                                     \
+    for (n = n0; n < n1; n++) {                                         \
+      TABL_NDX(NORM)                                                    \
+      FRAC                                                              \
+      WRAP                                                              \
+      READ                                                              \
+    }                                                                   \
+}
+
+TABL_KERNEL(tabl_r0_limit, 0, TABL_NOFRAC, TABL_LIMIT, TABL_READ0)
+TABL_KERNEL(tabl_n0_limit, 1, TABL_NOFRAC, TABL_LIMIT, TABL_READ0)
+TABL_KERNEL(tabl_r0_wrap2, 0, TABL_NOFRAC, TABL_WRAP2, TABL_READ0)
+TABL_KERNEL(tabl_n0_wrap2, 1, TABL_NOFRAC, TABL_WRAP2, TABL_READ0)
+TABL_KERNEL(tabl_r0_wrapn, 0, TABL_NOFRAC, TABL_WRAPN, TABL_READ0)
+TABL_KERNEL(tabl_n0_wrapn, 1, TABL_NOFRAC, TABL_WRAPN, TABL_READ0)
+TABL_KERNEL(tabl_r1_limit, 0, TABL_FRAC, TABL_LIMIT, TABL_READ1)
+TABL_KERNEL(tabl_n1_limit, 1, TABL_FRAC, TABL_LIMIT, TABL_READ1)
+TABL_KERNEL(tabl_r1_wrap2, 0, TABL_FRAC, TABL_WRAP2, TABL_READ1)
+TABL_KERNEL(tabl_n1_wrap2, 1, TABL_FRAC, TABL_WRAP2, TABL_READ1)
+TABL_KERNEL(tabl_r1_wrapn, 0, TABL_FRAC, TABL_WRAPN, TABL_READ1)
+TABL_KERNEL(tabl_n1_wrapn, 1, TABL_FRAC, TABL_WRAPN, TABL_READ1)
+TABL_KERNEL(tabl_r3_limit, 0, TABL_FRAC, TABL_LIMIT, TABL_READ3)
+TABL_KERNEL(tabl_n3_limit, 1, TABL_FRAC, TABL_LIMIT, TABL_READ3)
+TABL_KERNEL(tabl_r3_wrap2, 0, TABL_FRAC, TABL_WRAP2, TABL_READ3)
+TABL_KERNEL(tabl_n3_wrap2, 1, TABL_FRAC, TABL_WRAP2, TABL_READ3)
+TABL_KERNEL(tabl_r3_wrapn, 0, TABL_FRAC, TABL_WRAPN, TABL_READ3)
+TABL_KERNEL(tabl_n3_wrapn, 1, TABL_FRAC, TABL_WRAPN, TABL_READ3)
+
+/* [order][limit, wrap2, wrapn][raw, normalised] */
+static void (*const tabl_kernels[3][3][2])(const TABL *, MYFLT *,
+                                           const MYFLT *,
+                                           uint32_t, uint32_t) = {
+    { { tabl_r0_limit, tabl_n0_limit }, { tabl_r0_wrap2, tabl_n0_wrap2 },
+      { tabl_r0_wrapn, tabl_n0_wrapn } },
+    { { tabl_r1_limit, tabl_n1_limit }, { tabl_r1_wrap2, tabl_n1_wrap2 },
+      { tabl_r1_wrapn, tabl_n1_wrapn } },
+    { { tabl_r3_limit, tabl_n3_limit }, { tabl_r3_wrap2, tabl_n3_wrap2 },
+      { tabl_r3_wrapn, tabl_n3_wrapn } }
+};
+
+/* choose the kernel for the table, mode and wrap of p */
+static void tabl_kernel(TABL *p, int32_t order)
+{
+    int32_t wrap = (!p->iwrap ? 0 : isPowerOfTwo(p->len) ? 1 : 2);
+
+    if (order == 3 && p->len < 4)         /* too short for cubic */
+      order = 1;
+    p->kern = tabl_kernels[order == 3 ? 2 : order][wrap][p->mul != FL(1.0)];
+}
+
+static int32_t tabl_audio(CSOUND *csound, TABL *p, int32_t order)
+{
+    IGN(csound);
+    MYFLT    *sig = p->sig;
+    uint32_t koffset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t nsmps = CS_KSMPS;
+
+    if (UNLIKELY(koffset)) memset(sig, '\0', koffset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&sig[nsmps], '\0', early*sizeof(MYFLT));
+    }
+    if (UNLIKELY(p->kern == NULL))
+      tabl_kernel(p, order);
+    p->kern(p, sig, p->ndx, koffset, nsmps);
+    return OK;
+}
+
 int32_t tabler_init(CSOUND *csound, TABL *p) {
 
     int32_t ndx, len;
@@ -90,6 +227,7 @@ int32_t tabl_setup(CSOUND *csound, TABL *p) {
     p->len = p->ftp->flen;
 
     p->iwrap = (int32_t) *p->wrap;
+    p->kern = NULL;
     return OK;
 }
 
@@ -117,40 +255,7 @@ int32_t tabler_kontrol(CSOUND *csound, TABL *p) {
 
 int32_t tabler_audio(CSOUND *csound, TABL *p)
 {
-    IGN(csound);
-    int32_t ndx, len = p->len, n, nsmps = CS_KSMPS;
-    int32_t mask = p->ftp->lenmask;
-    MYFLT *sig = p->sig;
-    MYFLT *ndx_f = p->ndx;
-    MYFLT *func = p->ftp->ftable;
-    MYFLT offset = *p->offset;
-    MYFLT mul = p->mul;
-    int32_t iwrap = p->iwrap;
-    uint32_t    koffset = p->h.insdshead->ksmps_offset;
-    uint32_t    early  = p->h.insdshead->ksmps_no_end;
-
-    if (UNLIKELY(koffset)) memset(sig, '\0', koffset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&sig[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    for (n=koffset; n < nsmps; n++) {
-      ndx = MYFLOOR((ndx_f[n] + offset)*mul);
-      if (iwrap) {
-        if (p->np2) {
-          while(ndx >= len) ndx -= len;
-          while(ndx < 0)  ndx += len;
-        }
-        else ndx &= mask;
-      } else {
-        if (UNLIKELY(ndx >= len)) ndx = len - 1;
-        else if (UNLIKELY(ndx < 0)) ndx = 0;
-      }
-      p->sig[n] = func[ndx];
-    }
-
-    return OK;
+    return tabl_audio(csound, p, 0);
 }
 
 int32_t tableir_init(CSOUND *csound, TABL *p) {
@@ -224,45 +329,7 @@ int32_t tableir_kontrol(CSOUND *csound, TABL *p) {
 
 int32_t tableir_audio(CSOUND *csound, TABL *p)
 {
-    IGN(csound);
-    int32_t ndx, len    = p->len, n, nsmps = CS_KSMPS;
-    int32_t mask        = p->ftp->lenmask;
-    MYFLT *sig          = p->sig;
-    MYFLT *ndx_f        = p->ndx;
-    MYFLT *func         = p->ftp->ftable;
-    MYFLT offset        = *p->offset;
-    MYFLT mul           = p->mul, tmp, frac;
-    int32_t iwrap       = p->iwrap;
-    uint32_t    koffset = p->h.insdshead->ksmps_offset;
-    uint32_t    early   = p->h.insdshead->ksmps_no_end;
-
-    if (UNLIKELY(koffset)) memset(sig, '\0', koffset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&sig[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    for (n=koffset; n < nsmps; n++) {
-      MYFLT x1, x2;
-      tmp = (ndx_f[n] + offset)*mul;
-      ndx = MYFLOOR(tmp);
-      frac = tmp - ndx;
-      if (iwrap) {
-        if (p->np2) {
-          while(ndx >= len) ndx -= len;
-          while(ndx < 0)  ndx += len;
-        }
-        else ndx &= mask;
-      } else {
-        if (UNLIKELY(ndx >= len)) ndx = len - 1;
-        else if (UNLIKELY(ndx < 0)) ndx = 0;
-      }
-      x1 = func[ndx];
-      x2 = func[ndx+1];
-      p->sig[n] = x1 + (x2 - x1)*frac;
-    }
-
-    return OK;
+    return tabl_audio(csound, p, 1);
 }
 
 int32_t table3r_init(CSOUND *csound, TABL *p) {
@@ -368,58 +435,7 @@ int32_t table3r_kontrol(CSOUND *csound, TABL *p) {
 
 int32_t table3r_audio(CSOUND *csound, TABL *p)
 {
-    IGN(csound);
-    int32_t ndx, len = p->len, n, nsmps = CS_KSMPS;
-    int32_t mask = p->ftp->lenmask;
-    MYFLT *sig = p->sig;
-    MYFLT *ndx_f = p->ndx;
-    MYFLT *func = p->ftp->ftable;
-    MYFLT offset = *p->offset;
-    MYFLT mul = p->mul, tmp, frac;
-    int32_t iwrap = p->iwrap;
-    uint32_t    koffset = p->h.insdshead->ksmps_offset;
-    uint32_t    early  = p->h.insdshead->ksmps_no_end;
-
-    if (UNLIKELY(koffset)) memset(sig, '\0', koffset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&sig[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    for (n=koffset; n < nsmps; n++) {
-      MYFLT x0,x1,x2,x3,temp1,fracub,fracsq;
-      tmp = (ndx_f[n] + offset)*mul;
-      ndx = MYFLOOR(tmp);
-      frac = tmp - ndx;
-      if (iwrap) {
-        if (p->np2) {
-          while(ndx >= len) ndx -= len;
-          while(ndx < 0)  ndx += len;
-        }
-        else ndx &= mask;
-      } else {
-        if (UNLIKELY(ndx >= len)) ndx = len - 1;
-        else if (UNLIKELY(ndx < 0)) ndx = 0;
-      }
-
-      if (UNLIKELY(ndx<1 || ndx==len-1 || len <4)) {
-        x1 = func[ndx];
-        x2 = func[ndx+1];
-        p->sig[n] = x1 + (x2 - x1)*frac;
-      } else {
-        x0 = func[ndx-1];
-        x1 = func[ndx];
-        x2 = func[ndx+1];
-        x3 = func[ndx+2];
-        fracsq = frac*frac;
-        fracub = fracsq*x0;
-        temp1 = x3+x1+x1+x1;
-        p->sig[n] =  x1 + FL(0.5)*fracub +
-          frac*(x2 - fracub/FL(6.0) - temp1/FL(6.0) - x0/FL(3.0)) +
-          fracsq*frac*(temp1/FL(6.0) - FL(0.5)*x2) + fracsq*(FL(0.5)*x2 - x1);
-      }
-    }
-    return OK;
+    return tabl_audio(csound, p, 3);
 }
 
 int32_t tablkt_setup(CSOUND *csound, TABL *p) {
@@ -432,6 +448,7 @@ int32_t tablkt_setup(CSOUND *csound, TABL *p) {
     }
 
     p->iwrap = (int32_t) *p->wrap;
+    p->kern = NULL;
     return OK;
 }
 
@@ -464,6 +481,7 @@ int32_t tablerkt_audio(CSOUND *csound, TABL *p) {
     else
       p->mul = 1;
     p->len = p->ftp->flen;
+    tabl_kernel(p, 0);
 
     return tabler_audio(csound,p);
 }
@@ -497,6 +515,7 @@ int32_t tableirkt_audio(CSOUND *csound, TABL *p)
     else
       p->mul = 1;
     p->len = p->ftp->flen;
+    tabl_kernel(p, 1);
     return tableir_audio(csound,p);
 }
 
@@ -527,6 +546,7 @@ int32_t table3rkt_audio(CSOUND *csound, TABL *p) {
     else
       p->mul = 1;
     p->len = p->ftp->flen;
+    tabl_kernel(p, 3);
     return table3r_audio(csound,p);
 }
 
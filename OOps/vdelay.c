@@ -30,6 +30,7 @@
 
 #include <math.h>
 #include "vdelay.h"
+#include "delayline.h"
 
 //#define ESR     (csound->esr/FL(1000.0))
 #define ESR     (csound->esr*FL(0.001))
@@ -38,796 +39,257 @@ int32_t vdelset(CSOUND *csound, VDEL *p)            /*  vdelay set-up   */
 {
     uint32 n = (int32_t)(*p->imaxd * ESR)+1;
 
+    p->maxd = n - 1;
     if (!*p->istod) {
-      if (p->aux.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux.size)
-        /* allocate space for delay buffer */
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux);
-      else {     /*    make sure buffer is empty       */
-        memset(p->aux.auxp, '\0', n*sizeof(MYFLT));
-      }
-      p->left = 0;
+      int32 len = (p->maxd > 0 ? (int32) p->maxd : 1);
+      /* allocate space for delay buffer, or make sure it is empty */
+      p->line = csound->DelayLineCreate(csound, &p->aux, 1, &len, CS_KSMPS);
+      if (UNLIKELY(p->line == NULL))
+        return csound->InitError(csound, Str("vdelay: illegal delay time"));
     }
-    p->maxd = n - 1;
     return OK;
 }
 
-int32_t vdelay(CSOUND *csound, VDEL *p)               /*      vdelay  routine */
+/* the block is written first, then read with delays taken modulo maxd */
+
+static int32_t vdel_perf(CSOUND *csound, VDEL *p, int interp)
 {
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t nn, nsmps = CS_KSMPS;
-    int32_t  maxd, indx;
-    MYFLT *out = p->sr;     /* assign object data to local variables   */
-    MYFLT *in = p->ain;
-    MYFLT *del = p->adel;
-    MYFLT *buf = (MYFLT *)p->aux.auxp;
-    MYFLT esr = ESR;
-
-    if (UNLIKELY(buf==NULL)) goto err1;        /* RWD fix */
-    maxd = p->maxd;
-    indx = p->left;
-    if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
+    uint32_t nsmps = CS_KSMPS;
+    CS_DELAYLINE *line = p->line;
+    CS_DELAYTAP tap;
+    int32   start;
+
+    if (UNLIKELY(line == NULL)) goto err1;        /* RWD fix */
+    if (UNLIKELY(offset)) memset(p->sr, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
-      memset(&out[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    if (IS_ASIG_ARG(p->adel)) {          /*      if delay is a-rate      */
-      for (nn=offset; nn<nsmps; nn++) {
-        MYFLT  fv1, fv2;
-        int32_t   v1, v2;
-
-        buf[indx] = in[nn];
-        fv1 = indx - (del[nn]) * esr;
-        /* Make sure Inside the buffer      */
-        /*
-         * The following has been fixed by adding a cast and making a
-         * ">=" instead of a ">" comparison. The order of the comparisons
-         * has been swapped as well (a bit of a nit, but comparing a
-         * possibly negative number to an unsigned isn't a good idea--and
-         * broke on Alpha).
-         * heh 981101
-         */
-        while (UNLIKELY(fv1 < FL(0.0)))
-          fv1 += (MYFLT)maxd;
-        while (UNLIKELY(fv1 >= (MYFLT)maxd))
-          fv1 -= (MYFLT)maxd;
-
-        if (LIKELY(fv1 < maxd - 1)) /* Find next sample for interpolation      */
-          fv2 = fv1 + FL(1.0);
-        else
-          fv2 = FL(0.0);
-
-        v1 = (int32_t)fv1;
-        v2 = (int32_t)fv2;
-        out[nn] = buf[v1] + (fv1 - v1) * ( buf[v2] - buf[v1]);
-
-        if (UNLIKELY(++indx == maxd))
-          indx = 0;             /* Advance current pointer */
-
-      }
-    }
-    else {                      /* and, if delay is k-rate */
-      MYFLT fdel=*del;
-      for (nn=offset; nn<nsmps; nn++) {
-        MYFLT  fv1, fv2;
-        int32_t   v1, v2;
-
-        buf[indx] = in[nn];
-        fv1 = indx - fdel * esr;
-        /* Make sure inside the buffer      */
-        /*
-         * See comment above--same fix applied here.  heh 981101
-         */
-        while (UNLIKELY(fv1 < FL(0.0)))
-          fv1 += (MYFLT)maxd;
-        while (UNLIKELY(fv1 >= (MYFLT)maxd))
-          fv1 -= (MYFLT)maxd;
-
-        if (LIKELY(fv1 < maxd - 1)) /* Find next sample for interpolation      */
-          fv2 = fv1 + FL(1.0);
-        else
-          fv2 = FL(0.0);
-
-        v1 = (int32_t)fv1;
-        v2 = (int32_t)fv2;
-        out[nn] = buf[v1] + (fv1 - v1) * ( buf[v2] - buf[v1]);
-
-        if (UNLIKELY(++indx == maxd)) indx = 0;   /*      Advance current pointer */
-
-      }
-    }
-    p->left = indx;             /*      and keep track of where you are */
+      memset(&p->sr[nsmps], '\0', early*sizeof(MYFLT));
+    }
+    if (UNLIKELY(nsmps <= offset)) return OK;
+    start = line->wpos - (int32) offset;
+    csound->DelayLineWrite(csound, line, p->ain + offset, nsmps - offset);
+    tap.out = p->sr;
+    tap.del = p->adel;
+    tap.scale = ESR;
+    tap.gain = FL(1.0);
+    tap.arate = IS_ASIG_ARG(p->adel);
+    tap.add = 0;
+    csound->DelayLineRead(csound, line, &tap, 1, start, offset, nsmps,
+                          interp, 0);
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
+                             interp == CS_DELAY_CUBIC ?
+                             Str("vdelay3: not initialised") :
                              Str("vdelay: not initialised"));
 }
 
-int32_t vdelay3(CSOUND *csound, VDEL *p)    /*  vdelay routine with cubic interp */
+int32_t vdelay(CSOUND *csound, VDEL *p)               /*      vdelay  routine */
 {
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t nn, nsmps = CS_KSMPS;
-    int32_t  maxd, indx;
-    MYFLT *out = p->sr;  /* assign object data to local variables   */
-    MYFLT *in = p->ain;
-    MYFLT *del = p->adel;
-    MYFLT *buf = (MYFLT *)p->aux.auxp;
-    MYFLT esr = ESR;
-
-    if (UNLIKELY(buf==NULL)) goto err1;            /* RWD fix */
-    maxd = p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    if (IS_ASIG_ARG(p->adel)) {              /*      if delay is a-rate      */
-      for (nn=offset; nn<nsmps; nn++) {
-        MYFLT  fv1;
-        int32_t   v0, v1, v2, v3;
-
-        buf[indx] = in[nn];      /* IV Oct 2001 */
-        fv1 = del[nn] * (-esr);
-        v1 = (int32_t)fv1;
-        fv1 -= (MYFLT) v1;
-        v1 += (int32_t)indx;
-        /* Make sure Inside the buffer      */
-        if ((v1 < 0L) || (fv1 < FL(0.0))) {
-          fv1++; v1--; while (UNLIKELY(v1 < 0L)) v1 += (int32_t)maxd;
-        }
-        else {
-          while (UNLIKELY(v1 >= (int32_t)maxd)) v1 -= (int32_t)maxd;
-        }
-        /* Find next sample for interpolation      */
-        v2 = (v1 == (int32_t)(maxd - 1UL) ? 0L : v1 + 1L);
-
-        if (maxd<4) {
-          out[nn] = buf[v1] + fv1 * (buf[v2] - buf[v1]);
-        }
-        else {
-          v0 = (v1==0 ? maxd-1 : v1-1);
-          v3 = (v2==(int32_t)maxd-1 ? 0 : v2+1);
-          {                     /* optimized by Istvan Varga (Oct 2001) */
-            MYFLT w, x, y, z;
-            z = fv1 * fv1; z--; z *= FL(0.1666666667);
-            y = fv1; y++; w = (y *= FL(0.5)); w--;
-            x = FL(3.0) * z; y -= x; w -= z; x -= fv1;
-            out[nn] = (w*buf[v0] + x*buf[v1] + y*buf[v2] + z*buf[v3])
-              * fv1 + buf[v1];
-          }
-        }
-        if (UNLIKELY(++indx == maxd))
-          indx = 0;             /* Advance current pointer */
-
-      };
-    }
-    else {                      /* and, if delay is k-rate */
-      MYFLT  fv1, w, x, y, z;
-      int32_t   v0, v1, v2, v3;
-
-      fv1 = *del * -esr; v1 = (int32_t)fv1; fv1 -= (MYFLT) v1;
-      v1 += (int32_t)indx;
-      /* Make sure Inside the buffer      */
-      if ((v1 < 0L) || (fv1 < FL(0.0))) {
-        fv1++; v1--; while (UNLIKELY(v1 < 0L)) v1 += (int32_t)maxd;
-      }
-      else {
-        while (UNLIKELY(v1 >= (int32_t)maxd)) v1 -= (int32_t)maxd;
-      }
+    return vdel_perf(csound, p, CS_DELAY_LINEAR);
+}
 
-      if (maxd<4) {
-        for (nn=offset; nn<nsmps; nn++) {
-          /* Find next sample for interpolation      */
-          v2 = (v1 == (int32_t)(maxd - 1UL) ? 0L : v1 + 1L);
-          out[nn] = buf[v1] + fv1 * (buf[v2] - buf[v1]);
-          if (UNLIKELY(++v1 >= (int32_t)maxd)) v1 -= (int32_t)maxd;
-              if (UNLIKELY(++indx >= maxd)) indx -= maxd;
-        }
-      }
-      else {
-        /* calculate interpolation coeffs */
-        z = fv1 * fv1; z--; z *= FL(0.1666666667);      /* IV Oct 2001 */
-        y = fv1; y++; w = (y *= FL(0.5)); w--;
-        x = FL(3.0) * z; y -= x; w -= z; x -= fv1;
-        for (nn=offset; nn<nsmps; nn++) {
-          buf[indx] = in[nn];
-          /* Find next sample for interpolation      */
-          v2 = (v1 == (int32_t)(maxd - 1UL) ? 0L : v1 + 1L);
-          v0 = (v1 == 0L ? (int32_t)(maxd - 1UL) : v1 - 1L);
-          v3 = (v2 == (int32_t)(maxd - 1UL) ? 0L : v2 + 1L);
-          out[nn] = (w*buf[v0] + x*buf[v1] + y*buf[v2] + z*buf[v3])
-                     * fv1 + buf[v1];
-          if (UNLIKELY(++v1 >= (int32_t)maxd)) v1 -= (int32_t)maxd;
-          if (UNLIKELY(++indx >= maxd))
-            indx -= maxd;     /* Advance current pointer */
-        }
-      }
-    }
-    p->left = indx;             /*      and keep track of where you are */
-    return OK;
- err1:
-    return csound->PerfError(csound, &(p->h),
-                             Str("vdelay3: not initialised"));
+int32_t vdelay3(CSOUND *csound, VDEL *p)    /*  vdelay routine with cubic interp */
+{
+    return vdel_perf(csound, p, p->maxd < 4 ? CS_DELAY_LINEAR : CS_DELAY_CUBIC);
 }
 
 /* vdelayx, vdelayxs, vdelayxq, vdelayxw, vdelayxws, vdelayxwq */
 /* coded by Istvan Varga, Mar 2001 */
 
-int32_t vdelxset(CSOUND *csound, VDELX *p)      /*  vdelayx set-up (1 channel) */
-{
-    uint32_t n = (int32_t)(*p->imaxd * csound->esr);
+/* one line for each channel, with room for the interpolation window */
 
-    if (UNLIKELY(n == 0)) n = 1;          /* fix due to Troxler */
+static CS_DELAYLINE *vdelx_lines(CSOUND *csound, OPDS *h, AUXCH *aux,
+                                 int nchnls, MYFLT imaxd, MYFLT iquality,
+                                 int *interp_size)
+{
+    int32   len[4], n = (int32)(imaxd * csound->esr);
+    int     i;
+
+    if (UNLIKELY(n <= 0)) n = 1;          /* fix due to Troxler */
+    for (i = 0; i < nchnls; i++)
+      len[i] = n;
+    *interp_size = 4 * (int32_t) (FL(0.5) + FL(0.25) * iquality);
+    *interp_size = (*interp_size < 4 ? 4 : *interp_size);
+    *interp_size = (*interp_size > 1024 ? 1024 : *interp_size);
+    return csound->DelayLineCreate(csound, aux, nchnls, len,
+                                   (int32) h->insdshead->ksmps + *interp_size);
+}
 
+int32_t vdelxset(CSOUND *csound, VDELX *p)      /*  vdelayx set-up (1 channel) */
+{
     if (!*p->istod) {
-      if (p->aux1.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux1.size)
-        /* allocate space for delay buffer */
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux1);
-      else
-        memset(p->aux1.auxp, 0, n*sizeof(MYFLT));
-      p->left = 0;
-      p->interp_size = 4 * (int32_t) (FL(0.5) + FL(0.25) * *(p->iquality));
-      p->interp_size = (p->interp_size < 4 ? 4 : p->interp_size);
-      p->interp_size = (p->interp_size > 1024 ? 1024 : p->interp_size);
+      p->line = vdelx_lines(csound, &p->h, &p->aux1, 1, *p->imaxd,
+                            *p->iquality, &p->interp_size);
+      if (UNLIKELY(p->line == NULL))
+        return csound->InitError(csound, Str("vdelay: illegal delay time"));
     }
-    p->maxd = (uint32) n;
     return OK;
 }
 
 int32_t vdelxsset(CSOUND *csound, VDELXS *p)    /*  vdelayxs set-up (stereo) */
 {
-    uint32_t n = (int32_t)(*p->imaxd * csound->esr);
-
-    if (UNLIKELY(n == 0)) n = 1;          /* fix due to Troxler */
-
     if (!*p->istod) {
-      if (p->aux1.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux1.size)
-        /* allocate space for delay buffer */
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux1);
-      else
-        memset(p->aux1.auxp, 0, n*sizeof(MYFLT));
-      if (p->aux2.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux2.size)
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux2);
-      else
-        memset(p->aux2.auxp, 0, n*sizeof(MYFLT));
-
-      p->left = 0;
-      p->interp_size = 4 * (int32_t) (FL(0.5) + FL(0.25) * *(p->iquality));
-      p->interp_size = (p->interp_size < 4 ? 4 : p->interp_size);
-      p->interp_size = (p->interp_size > 1024 ? 1024 : p->interp_size);
+      p->line = vdelx_lines(csound, &p->h, &p->aux1, 2, *p->imaxd,
+                            *p->iquality, &p->interp_size);
+      if (UNLIKELY(p->line == NULL))
+        return csound->InitError(csound, Str("vdelay: illegal delay time"));
     }
-    p->maxd = (uint32) n;
     return OK;
 }
 
 int32_t vdelxqset(CSOUND *csound, VDELXQ *p) /* vdelayxq set-up (quad channels) */
 {
-    uint32_t n = (int32_t)(*p->imaxd * csound->esr);
-
-    if (UNLIKELY(n == 0)) n = 1;          /* fix due to Troxler */
-
     if (!*p->istod) {
-      if (p->aux1.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux1.size)
-        /* allocate space for delay buffer */
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux1);
-      else
-        memset(p->aux1.auxp, 0, n*sizeof(MYFLT));
-      if (p->aux2.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux2.size)
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux2);
-      else
-        memset(p->aux2.auxp, 0, n*sizeof(MYFLT));
-      if (p->aux3.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux3.size)
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux3);
-      else
-        memset(p->aux3.auxp, 0, n*sizeof(MYFLT));
-      if (p->aux4.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux4.size)
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux4);
-      else
-        memset(p->aux4.auxp, 0, n*sizeof(MYFLT));
-
-      p->left = 0;
-      p->interp_size = 4 * (int32_t) (FL(0.5) + FL(0.25) * *(p->iquality));
-      p->interp_size = (p->interp_size < 4 ? 4 : p->interp_size);
-      p->interp_size = (p->interp_size > 1024 ? 1024 : p->interp_size);
+      p->line = vdelx_lines(csound, &p->h, &p->aux1, 4, *p->imaxd,
+                            *p->iquality, &p->interp_size);
+      if (UNLIKELY(p->line == NULL))
+        return csound->InitError(csound, Str("vdelay: illegal delay time"));
     }
-    p->maxd = (uint32) n;
     return OK;
 }
 
-int32_t vdelayx(CSOUND *csound, VDELX *p)               /*      vdelayx routine  */
-{
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t nn, nsmps = CS_KSMPS;
-    int32_t indx, maxd;
-    MYFLT *out1 = p->sr1;  /* assign object data to local variables   */
-    MYFLT *in1 = p->ain1;
-    MYFLT *del = p->adel;
-    MYFLT *buf1 = (MYFLT *)p->aux1.auxp;
-    int32_t   wsize = p->interp_size;
-    double x1, x2, w, d, d2x, n1;
-    int32_t   i, i2, xpos;
-
-    if (UNLIKELY(buf1 == NULL)) goto err1;                          /* RWD fix */
-    maxd = p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    i2 = (wsize >> 1);
-    d2x = (1.0 - pow ((double)wsize * 0.85172, -0.89624)) / (double)(i2 * i2);
-    if (UNLIKELY(offset)) memset(out1, '\0', offset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    for (nn=offset; nn<nsmps; nn++) {
-      buf1[indx] = in1[nn];
-      n1 = 0.0;
-
-      /* x1: fractional part of delay time */
-      /* x2: sine of x1 (for interpolation) */
-      /* xpos: integer part of delay time (buffer position to read from) */
-
-      x1 = (double)indx - ((double)del[nn] * (double)csound->esr);
-      while (x1 < 0.0) x1 += (double)maxd;
-      xpos = (int32_t)x1;
-      x1 -= (double)xpos;
-      x2 = sin (PI * x1) / PI;
-      while (xpos >= maxd) xpos -= maxd;
-
-      if (x1 * (1.0 - x1) > 0.00000001) {
-        xpos += (1 - i2);
-        while (xpos < 0) xpos += maxd;
-        d = (double)(1 - i2) - x1;
-        for (i = i2; i--;) {
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 += (double)buf1[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 -= (double)buf1[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-        }
-        out1[nn] = (MYFLT) (n1 * x2);
-      }
-      else {                                            /* integer sample */
-        xpos = (int32_t)((double)xpos + x1 + 0.5);      /* position */
-        if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-        out1[nn] = buf1[xpos];
-      }
+/* each channel written, then read with the windowed sinc at the same
+   a-rate delay in seconds */
 
-      if (UNLIKELY(++indx == maxd)) indx = 0;
+static int32_t vdelx_perf(CSOUND *csound, OPDS *h, CS_DELAYLINE *line,
+                          int nchnls, MYFLT **out, MYFLT **in, MYFLT *del,
+                          int wsize)
+{
+    uint32_t offset = h->insdshead->ksmps_offset;
+    uint32_t early  = h->insdshead->ksmps_no_end;
+    uint32_t nsmps = h->insdshead->ksmps;
+    CS_DELAYTAP tap;
+    int32   start;
+    int     i;
+
+    if (UNLIKELY(line == NULL)) goto err1;      /* RWD fix */
+    if (UNLIKELY(early)) nsmps -= early;
+    for (i = 0; i < nchnls; i++) {
+      if (UNLIKELY(offset)) memset(out[i], '\0', offset*sizeof(MYFLT));
+      if (UNLIKELY(early))
+        memset(&out[i][nsmps], '\0', early*sizeof(MYFLT));
+      if (UNLIKELY(nsmps <= offset)) continue;
+      start = line[i].wpos - (int32) offset;
+      csound->DelayLineWrite(csound, &line[i], in[i] + offset,
+                             nsmps - offset);
+      tap.out = out[i];
+      tap.del = del;
+      tap.scale = csound->esr;
+      tap.gain = FL(1.0);
+      tap.arate = 1;
+      tap.add = 0;
+      csound->DelayLineRead(csound, &line[i], &tap, 1, start, offset, nsmps,
+                            CS_DELAY_SINC, wsize);
     }
-
-    p->left = indx;
     return OK;
  err1:
-    return csound->PerfError(csound, &(p->h),
-                             Str("vdelay: not initialised"));
+    return csound->PerfError(csound, h, Str("vdelay: not initialised"));
 }
 
-int32_t vdelayxw(CSOUND *csound, VDELX *p)      /*      vdelayxw routine  */
+/* the input of each channel added to the line at the delay ahead of the
+   sample read, which is then cleared */
+
+static int32_t vdelxw_perf(CSOUND *csound, OPDS *h, CS_DELAYLINE *line,
+                           int nchnls, MYFLT **out, MYFLT **in, MYFLT *del,
+                           int wsize)
 {
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t nn, nsmps = CS_KSMPS;
-    int32_t  maxd, indx;
-    MYFLT *out1 = p->sr1;  /* assign object data to local variables   */
-    MYFLT *in1 = p->ain1;
-    MYFLT *del = p->adel;
-    MYFLT *buf1 = (MYFLT *)p->aux1.auxp;
-    int32_t   wsize = p->interp_size;
-    double x1, x2, w, d, d2x, n1;
-    int32_t   i, i2, xpos;
-
-    if (UNLIKELY(buf1 == NULL)) goto err1;                          /* RWD fix */
-    maxd =  p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    i2 = (wsize >> 1);
-    d2x = (1.0 - pow ((double)wsize * 0.85172, -0.89624)) / (double)(i2 * i2);
-
-    if (UNLIKELY(offset)) memset(out1, '\0', offset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
-    }
-    for (nn=offset;nn<nsmps;nn++) {
-      /* x1: fractional part of delay time */
-      /* x2: sine of x1 (for interpolation) */
-      /* xpos: integer part of delay time (buffer position to read from) */
-
-      x1 = (double)indx + ((double)del[nn] * (double)csound->esr);
-      while (x1 < 0.0) x1 += (double)maxd;
-      xpos = (int32_t)x1;
-      x1 -= (double)xpos;
-      x2 = sin (PI * x1) / PI;
-      while (xpos >= maxd) xpos -= maxd;
-
-      if (LIKELY(x1 * (1.0 - x1) > 0.00000001)) {
-        n1 = (double)in1[nn] * x2;
-        xpos += (1 - i2);
-        while (xpos < 0) xpos += maxd;
-        d = (double)(1 - i2) - x1;
-        for (i = i2; i--;) {
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          buf1[xpos] += (MYFLT) (n1 * w);
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          buf1[xpos] -= (MYFLT) (n1 * w);
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-        }
-      }
-      else {                                            /* integer sample */
-        xpos = (int32_t)((double)xpos + x1 + 0.5);      /* position */
-        if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-        buf1[xpos] += in1[nn];
-      }
+    uint32_t offset = h->insdshead->ksmps_offset;
+    uint32_t early  = h->insdshead->ksmps_no_end;
+    uint32_t n, nsmps = h->insdshead->ksmps;
+    double  d2x = csoundDelayLineD2x(wsize), esr = csound->esr;
+    int     i;
 
-      out1[nn] = buf1[indx]; buf1[indx] = FL(0.0);
-      if (UNLIKELY(++indx == maxd)) indx = 0;
+    if (UNLIKELY(line == NULL)) goto err1;      /* RWD fix */
+    if (UNLIKELY(early)) nsmps -= early;
+    for (i = 0; i < nchnls; i++) {
+      CS_DELAYLINE *l = &line[i];
+      double  rlen = 1.0 / l->len;
+      int32   indx = l->wpos;
+
+      if (UNLIKELY(offset)) memset(out[i], '\0', offset*sizeof(MYFLT));
+      if (UNLIKELY(early))
+        memset(&out[i][nsmps], '\0', early*sizeof(MYFLT));
+      for (n = offset; n < nsmps; n++) {
+        csoundDelayLineAddSinc(l, indx + csoundDelayLineWrap((double) del[n]
+                                                             * esr, 0,
+                                                             l->len, rlen),
+                               in[i][n], wsize, d2x);
+        out[i][n] = l->buf[indx]; l->buf[indx] = FL(0.0);
+        indx = (indx + 1) & l->mask;
+      }
+      l->wpos = indx;
     }
-
-    p->left = indx;
     return OK;
  err1:
-    return csound->PerfError(csound, &(p->h),
-                             Str("vdelay: not initialised"));
+    return csound->PerfError(csound, h, Str("vdelay: not initialised"));
 }
 
-int32_t vdelayxs(CSOUND *csound, VDELXS *p)     /*      vdelayxs routine  */
+int32_t vdelayx(CSOUND *csound, VDELX *p)               /*      vdelayx routine  */
 {
-    int32_t  maxd, indx;
-    MYFLT *out1 = p->sr1;  /* assign object data to local variables   */
-    MYFLT *out2 = p->sr2;
-    MYFLT *in1 = p->ain1;
-    MYFLT *in2 = p->ain2;
-    MYFLT *del = p->adel;
-    MYFLT *buf1 = (MYFLT *)p->aux1.auxp;
-    MYFLT *buf2 = (MYFLT *)p->aux2.auxp;
-    int32_t   wsize = p->interp_size;
-    double x1, x2, w, d, d2x, n1, n2;
-    int32_t   i, i2, xpos;
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
+    MYFLT   *out[1], *in[1];
 
-    if (UNLIKELY((buf1 == NULL) || (buf2 == NULL))) goto err1; /* RWD fix */
-    maxd =  p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    i2 = (wsize >> 1);
-    d2x = (1.0 - pow ((double)wsize * 0.85172, -0.89624)) / (double)(i2 * i2);
-    if (UNLIKELY(offset)) {
-      memset(out1, '\0', offset*sizeof(MYFLT));
-      memset(out2, '\0', offset*sizeof(MYFLT));
-    }
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out2[nsmps], '\0', early*sizeof(MYFLT));
-    }
+    out[0] = p->sr1; in[0] = p->ain1;
+    return vdelx_perf(csound, &p->h, p->line, 1, out, in, p->adel,
+                      p->interp_size);
+}
 
-    for (n=offset; n<nsmps; n++) {
-      buf1[indx] = in1[n]; buf2[indx] = in2[n];
-      n1 = 0.0; n2 = 0.0;
-
-      /* x1: fractional part of delay time */
-      /* x2: sine of x1 (for interpolation) */
-      /* xpos: integer part of delay time (buffer position to read from) */
-
-      x1 = (double)indx - ((double)del[n] * (double)csound->esr);
-      while (UNLIKELY(x1 < 0.0)) x1 += (double)maxd;
-      xpos = (int32_t)x1;
-      x1 -= (double)xpos;
-      x2 = sin (PI * x1) / PI;
-      while (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-
-      if (x1 * (1.0 - x1) > 0.00000001) {
-        xpos += (1 - i2);
-        while (UNLIKELY(xpos < 0)) xpos += maxd;
-        d = (double)(1 - i2) - x1;
-        for (i = i2; i--;) {
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 += (double)buf1[xpos] * w; n2 += (double)buf2[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 -= (double)buf1[xpos] * w; n2 -= (double)buf2[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-        }
-        out1[n] = (MYFLT) (n1 * x2); out2[n] = (MYFLT) (n2 * x2);
-      }
-      else {                                            /* integer sample */
-        xpos = (int32_t)((double)xpos + x1 + 0.5);      /* position */
-        if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-        out1[n] = buf1[xpos]; out2[n] = buf2[xpos];
-      }
+int32_t vdelayxw(CSOUND *csound, VDELX *p)      /*      vdelayxw routine  */
+{
+    MYFLT   *out[1], *in[1];
 
-      if (UNLIKELY(++indx == maxd)) indx = 0;
-    }
+    out[0] = p->sr1; in[0] = p->ain1;
+    return vdelxw_perf(csound, &p->h, p->line, 1, out, in, p->adel,
+                       p->interp_size);
+}
 
-    p->left = indx;
-    return OK;
- err1:
-    return csound->PerfError(csound, &(p->h),
-                             Str("vdelay: not initialised"));
+int32_t vdelayxs(CSOUND *csound, VDELXS *p)     /*      vdelayxs routine  */
+{
+    MYFLT   *out[2], *in[2];
+
+    out[0] = p->sr1; out[1] = p->sr2;
+    in[0] = p->ain1; in[1] = p->ain2;
+    return vdelx_perf(csound, &p->h, p->line, 2, out, in, p->adel,
+                      p->interp_size);
 }
 
 int32_t vdelayxws(CSOUND *csound, VDELXS *p)    /*      vdelayxws routine  */
 {
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-    int32_t  maxd, indx;
-    MYFLT *out1 = p->sr1;  /* assign object data to local variables   */
-    MYFLT *out2 = p->sr2;
-    MYFLT *in1 = p->ain1;
-    MYFLT *in2 = p->ain2;
-    MYFLT *del = p->adel;
-    MYFLT *buf1 = (MYFLT *)p->aux1.auxp;
-    MYFLT *buf2 = (MYFLT *)p->aux2.auxp;
-    int32_t   wsize = p->interp_size;
-    double x1, x2, w, d, d2x, n1, n2;
-    int32_t   i, i2, xpos;
-
-    if (UNLIKELY((buf1 == NULL) || (buf2 == NULL))) goto err1;     /* RWD fix */
-    maxd =  p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    i2 = (wsize >> 1);
-    d2x = (1.0 - pow ((double)wsize * 0.85172, -0.89624)) / (double)(i2 * i2);
-
-    if (UNLIKELY(offset)) {
-      memset(out1, '\0', offset*sizeof(MYFLT));
-      memset(out2, '\0', offset*sizeof(MYFLT));
-    }
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out2[nsmps], '\0', early*sizeof(MYFLT));
-    }
-    for (n=offset; n<nsmps; n++) {
-      /* x1: fractional part of delay time */
-      /* x2: sine of x1 (for interpolation) */
-      /* xpos: integer part of delay time (buffer position to read from) */
-
-      x1 = (double)indx + ((double)del[n] * (double)csound->esr);
-      while (UNLIKELY(x1 < 0.0)) x1 += (double)maxd;
-      xpos = (int32_t)x1;
-      x1 -= (double)xpos;
-      x2 = sin (PI * x1) / PI;
-      while (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-
-      if (x1 * (1.0 - x1) > 0.00000001) {
-        n1 = (double)in1[n] * x2; n2 = (double)in2[n] * x2;
-        xpos += (1 - i2);
-        while (UNLIKELY(xpos < 0)) xpos += maxd;
-        d = (double)(1 - i2) - x1;
-        for (i = i2; i--;) {
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          buf1[xpos] += (MYFLT) (n1 * w); buf2[xpos] += (MYFLT) (n2 * w);
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          buf1[xpos] -= (MYFLT) (n1 * w); buf2[xpos] -= (MYFLT) (n2 * w);
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-        }
-      }
-      else {                                            /* integer sample */
-        xpos = (int32_t)((double)xpos + x1 + 0.5);       /* position */
-        if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-        buf1[xpos] += in1[n]; buf2[xpos] += in2[n];
-      }
+    MYFLT   *out[2], *in[2];
 
-      out1[n] = buf1[indx]; buf1[indx] = FL(0.0);
-      out2[n] = buf2[indx]; buf2[indx] = FL(0.0);
-      if (UNLIKELY(++indx == maxd)) indx = 0;
-    }
-
-    p->left = indx;
-    return OK;
- err1:
-    return csound->PerfError(csound, &(p->h),
-                             Str("vdelay: not initialised"));
+    out[0] = p->sr1; out[1] = p->sr2;
+    in[0] = p->ain1; in[1] = p->ain2;
+    return vdelxw_perf(csound, &p->h, p->line, 2, out, in, p->adel,
+                       p->interp_size);
 }
 
 int32_t vdelayxq(CSOUND *csound, VDELXQ *p)     /*      vdelayxq routine  */
 {
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-    int32_t  maxd, indx;
-    MYFLT *out1 = p->sr1;  /* assign object data to local variables   */
-    MYFLT *out2 = p->sr2;
-    MYFLT *out3 = p->sr3;
-    MYFLT *out4 = p->sr4;
-    MYFLT *in1 = p->ain1;
-    MYFLT *in2 = p->ain2;
-    MYFLT *in3 = p->ain3;
-    MYFLT *in4 = p->ain4;
-    MYFLT *del = p->adel;
-    MYFLT *buf1 = (MYFLT *)p->aux1.auxp;
-    MYFLT *buf2 = (MYFLT *)p->aux2.auxp;
-    MYFLT *buf3 = (MYFLT *)p->aux3.auxp;
-    MYFLT *buf4 = (MYFLT *)p->aux4.auxp;
-    int32_t   wsize = p->interp_size;
-    double x1, x2, w, d, d2x, n1, n2, n3, n4;
-    int32_t   i, i2, xpos;
-    /* RWD fix */
-    if (UNLIKELY((buf1 == NULL) || (buf2 == NULL) ||
-                 (buf3 == NULL) || (buf4 == NULL))) goto err1;
-    maxd =  p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    i2 = (wsize >> 1);
-    d2x = (1.0 - pow ((double)wsize * 0.85172, -0.89624)) / (double)(i2 * i2);
-
-    if (UNLIKELY(offset)) {
-      memset(out1, '\0', offset*sizeof(MYFLT));
-      memset(out2, '\0', offset*sizeof(MYFLT));
-      memset(out3, '\0', offset*sizeof(MYFLT));
-      memset(out4, '\0', offset*sizeof(MYFLT));
-    }
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out2[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out3[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out4[nsmps], '\0', early*sizeof(MYFLT));
-    }
+    MYFLT   *out[4], *in[4];
 
-    for (n=offset; n<nsmps; n++) {
-      buf1[indx] = in1[n]; buf2[indx] = in2[n];
-      buf3[indx] = in3[n]; buf4[indx] = in4[n];
-      n1 = 0.0; n2 = 0.0; n3 = 0.0; n4 = 0.0;
-
-      /* x1: fractional part of delay time */
-      /* x2: sine of x1 (for interpolation) */
-      /* xpos: integer part of delay time (buffer position to read from) */
-
-      x1 = (double)indx - ((double)*del++ * (double)csound->esr);
-      while (UNLIKELY(x1 < 0.0)) x1 += (double)maxd;
-      xpos = (int32_t)x1;
-      x1 -= (double)xpos;
-      x2 = sin (PI * x1) / PI;
-      while (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-
-      if (LIKELY(x1 * (1.0 - x1) > 0.00000001)) {
-        xpos += (1 - i2);
-        while (UNLIKELY(xpos < 0)) xpos += maxd;
-        d = (double)(1 - i2) - x1;
-        for (i = i2; i--;) {
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 += (double)buf1[xpos] * w; n2 += (double)buf2[xpos] * w;
-          n3 += (double)buf3[xpos] * w; n4 += (double)buf4[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 -= (double)buf1[xpos] * w; n2 -= (double)buf2[xpos] * w;
-          n3 -= (double)buf3[xpos] * w; n4 -= (double)buf4[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-        }
-        out1[n] = (MYFLT) (n1 * x2); out2[n] = (MYFLT) (n2 * x2);
-        out3[n] = (MYFLT) (n3 * x2); out4[n] = (MYFLT) (n4 * x2);
-      }
-      else {                                            /* integer sample */
-        xpos = (int32_t)((double)xpos + x1 + 0.5);       /* position */
-        if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-        out1[n] = buf1[xpos]; out2[n] = buf2[xpos];
-        out3[n] = buf3[xpos]; out4[n] = buf4[xpos];
-      }
-
-      if (UNLIKELY(++indx == maxd)) indx = 0;
-    }
-
-    p->left = indx;
-    return OK;
- err1:
-    return csound->PerfError(csound, &(p->h),
-                             Str("vdelay: not initialised"));
+    out[0] = p->sr1; out[1] = p->sr2; out[2] = p->sr3; out[3] = p->sr4;
+    in[0] = p->ain1; in[1] = p->ain2; in[2] = p->ain3; in[3] = p->ain4;
+    return vdelx_perf(csound, &p->h, p->line, 4, out, in, p->adel,
+                      p->interp_size);
 }
 
 int32_t vdelayxwq(CSOUND *csound, VDELXQ *p)    /*      vdelayxwq routine  */
 {
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-    int32_t  maxd, indx;
-    MYFLT *out1 = p->sr1;  /* assign object data to local variables   */
-    MYFLT *out2 = p->sr2;
-    MYFLT *out3 = p->sr3;
-    MYFLT *out4 = p->sr4;
-    MYFLT *in1 = p->ain1;
-    MYFLT *in2 = p->ain2;
-    MYFLT *in3 = p->ain3;
-    MYFLT *in4 = p->ain4;
-    MYFLT *del = p->adel;
-    MYFLT *buf1 = (MYFLT *)p->aux1.auxp;
-    MYFLT *buf2 = (MYFLT *)p->aux2.auxp;
-    MYFLT *buf3 = (MYFLT *)p->aux3.auxp;
-    MYFLT *buf4 = (MYFLT *)p->aux4.auxp;
-    int32_t   wsize = p->interp_size;
-    double x1, x2, w, d, d2x, n1, n2, n3, n4;
-    int32_t   i, i2, xpos;
-    /* RWD fix */
-    if (UNLIKELY((buf1 == NULL) || (buf2 == NULL) ||
-                 (buf3 == NULL) || (buf4 == NULL))) goto err1;
-    maxd =  p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    i2 = (wsize >> 1);
-    d2x = (1.0 - pow ((double)wsize * 0.85172, -0.89624)) / (double)(i2 * i2);
-
-    if (UNLIKELY(offset)) {
-      memset(out1, '\0', offset*sizeof(MYFLT));
-      memset(out2, '\0', offset*sizeof(MYFLT));
-      memset(out3, '\0', offset*sizeof(MYFLT));
-      memset(out4, '\0', offset*sizeof(MYFLT));
-    }
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out2[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out3[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out4[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    for (n=offset; n<nsmps; n++) {
-      /* x1: fractional part of delay time */
-      /* x2: sine of x1 (for interpolation) */
-      /* xpos: integer part of delay time (buffer position to read from) */
-
-      x1 = (double)indx + ((double)del[n] * (double)csound->esr);
-      while (UNLIKELY(x1 < 0.0)) x1 += (double)maxd;
-      xpos = (int32_t)x1;
-      x1 -= (double)xpos;
-      x2 = sin (PI * x1) / PI;
-      while (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-
-      if (x1 * (1.0 - x1) > 0.00000001) {
-        n1 = (double)in1[n] * x2; n2 = (double)in2[n] * x2;
-        n3 = (double)in3[n] * x2; n4 = (double)in4[n] * x2;
-        xpos += (1 - i2);
-        while (UNLIKELY(xpos < 0)) xpos += maxd;
-        d = (double)(1 - i2) - x1;
-        for (i = i2; i--;) {
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          buf1[xpos] += (MYFLT) (n1 * w); buf2[xpos] += (MYFLT) (n2 * w);
-          buf3[xpos] += (MYFLT) (n3 * w); buf4[xpos] += (MYFLT) (n4 * w);
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          buf1[xpos] -= (MYFLT) (n1 * w); buf2[xpos] -= (MYFLT) (n2 * w);
-          buf3[xpos] -= (MYFLT) (n3 * w); buf4[xpos] -= (MYFLT) (n4 * w);
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-        }
-      }
-      else {                                            /* integer sample */
-        xpos = (int32_t)((double)xpos + x1 + 0.5);       /* position */
-        if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-        buf1[xpos] += in1[n]; buf2[xpos] += in2[n];
-        buf3[xpos] += in3[n]; buf4[xpos] += in4[n];
-      }
+    MYFLT   *out[4], *in[4];
 
-      out1[n] = buf1[indx]; buf1[indx] = FL(0.0);
-      out2[n] = buf2[indx]; buf2[indx] = FL(0.0);
-      out3[n] = buf3[indx]; buf3[indx] = FL(0.0);
-      out4[n] = buf4[indx]; buf4[indx] = FL(0.0);
-      if (UNLIKELY(++indx == maxd)) indx = 0;
-    }
-
-    p->left = indx;
-    return OK;
- err1:
-    return csound->PerfError(csound, &(p->h),
-                             Str("vdelay: not initialised"));
+    out[0] = p->sr1; out[1] = p->sr2; out[2] = p->sr3; out[3] = p->sr4;
+    in[0] = p->ain1; in[1] = p->ain2; in[2] = p->ain3; in[3] = p->ain4;
+    return vdelxw_perf(csound, &p->h, p->line, 4, out, in, p->adel,
+                       p->interp_size);
 }
 
 int32_t multitap_set(CSOUND *csound, MDEL *p)
 {
     uint32_t n, i;
-    MYFLT max = FL(0.0);
+    int32   len;
+    MYFLT   max = FL(0.0), *dels;
 
     //if (UNLIKELY(p->INOCOUNT/2 == (MYFLT)p->INOCOUNT*FL(0.5)))
     /* Should this test just be p->INOCOUNT&1 ==  */
@@ -838,49 +300,59 @@ int32_t multitap_set(CSOUND *csound, MDEL *p)
       if (max < *p->ndel[i]) max = *p->ndel[i];
     }
 
-    n = (uint32_t)(csound->esr * max * sizeof(MYFLT));
-    if (p->aux.auxp == NULL ||    /* allocate space for delay buffer */
-        n > p->aux.size)
-      csound->AuxAlloc(csound, n, &p->aux);
-    else {
-      memset(p->aux.auxp, 0, n);
+    /* allocate space for delay buffer */
+    len = (int32)(csound->esr * max);
+    if (len < 1) len = 1;
+    p->line = csound->DelayLineCreate(csound, &p->aux, 1, &len, CS_KSMPS);
+    if (UNLIKELY(p->line == NULL))
+      return csound->InitError(csound, Str("multitap: illegal delay time"));
+
+    p->ntaps = (p->INOCOUNT - 1) >> 1;
+    n = p->ntaps * (sizeof(CS_DELAYTAP) + sizeof(MYFLT));
+    if (p->auxt.auxp == NULL || n > p->auxt.size)
+      csound->AuxAlloc(csound, n, &p->auxt);
+    p->taps = (CS_DELAYTAP*) p->auxt.auxp;
+    dels = (MYFLT*) (p->taps + p->ntaps);
+    for (i = 0; i < (uint32_t) p->ntaps; i++) {
+      /* read after the input pointer has moved on from the sample
+         written: a delay of 0 is the oldest sample in the line */
+      dels[i] = (MYFLT) ((int32_t)(csound->esr * *p->ndel[2*i]) - 1);
+      p->taps[i].del = &dels[i];
+      p->taps[i].scale = FL(1.0);
+      p->taps[i].gain = *p->ndel[2*i+1];
+      p->taps[i].arate = 0;
+      p->taps[i].add = (i > 0);
     }
-
-    p->left = 0;
-    p->max = (int32_t)(csound->esr * max);
     return OK;
 }
 
 int32_t multitap_play(CSOUND *csound, MDEL *p)
-{                               /* assign object data to local variables   */
-    int32_t  indx = p->left, delay;
+{
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t i, n, nsmps = CS_KSMPS;
-    MYFLT *out = p->sr, *in = p->ain;
-    MYFLT *buf = (MYFLT *)p->aux.auxp;
-    MYFLT max = (MYFLT)p->max;
+    uint32_t nsmps = CS_KSMPS;
+    CS_DELAYLINE *line = p->line;
+    MYFLT   *out = p->sr;
+    int32   start;
+    int     i;
 
-    if (UNLIKELY(buf==NULL)) goto err1;           /* RWD fix */
+    if (UNLIKELY(line==NULL)) goto err1;          /* RWD fix */
     if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
       memset(&out[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset; n<nsmps; n++) {
-      MYFLT v = FL(0.0);
-      buf[indx] = in[n];        /*      Write input     */
-
-      if (UNLIKELY(++indx == max)) indx = 0;   /*      Advance input pointer   */
-      for (i = 0; i < p->INOCOUNT - 1; i += 2) {
-        delay = indx - (int32_t)(csound->esr * *p->ndel[i]);
-        if (UNLIKELY(delay < 0))
-          delay += (int32_t)max;
-        v += buf[delay] * *p->ndel[i+1]; /*      Write output    */
-      }
-      out[n] = v;
-    }
-    p->left = indx;
+    if (UNLIKELY(nsmps <= offset)) return OK;
+    start = line->wpos - (int32) offset;
+    csound->DelayLineWrite(csound, line, p->ain + offset, nsmps - offset);
+    if (UNLIKELY(p->ntaps == 0)) {
+      memset(&out[offset], '\0', (nsmps - offset)*sizeof(MYFLT));
+      return OK;
+    }
+    for (i = 0; i < p->ntaps; i++)
+      p->taps[i].out = out;
+    csound->DelayLineRead(csound, line, p->taps, p->ntaps, start, offset,
+                          nsmps, CS_DELAY_NONE, 0);
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
@@ -485,100 +485,211 @@ static int32_t tabarithset2(CSOUND *csound, TABARITH2 *p)
     return OK;
 }
 
-static int32_t tabadd(CSOUND *csound, TABARITH *p)
+/* number of elements over all dimensions */
+static inline int32_t tab_elems(const ARRAYDAT *t)
 {
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->left;
-    ARRAYDAT *r   = p->right;
-    int32_t sizel    = l->sizes[0];
-    int32_t sizer    = r->sizes[0];
-    int32_t i;
+    int32_t i, size = t->sizes[0];
+    for (i=1; i<t->dimensions; i++)
+      size *= t->sizes[i];
+    return size;
+}
 
-    if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
+/* Element-wise kernels.  The output is written in place when it is the
+   left operand (k[] = k[] + k[], or the compound forms); the restrict
+   qualified loops then vectorise without runtime overlap checks.  Any
+   other aliasing falls back to the plain loop. */
+#define TAB_KERNEL(name, OP)                                            \
+  static inline void name##_2(MYFLT *restrict out,                      \
+                              const MYFLT *restrict a,                  \
+                              const MYFLT *restrict b, int32_t n)       \
+  {                                                                     \
+    int32_t i;                                                          \
+    for (i=0; i<n; i++) out[i] = a[i] OP b[i];                          \
+  }                                                                     \
+  static inline void name##_in(MYFLT *restrict out,                     \
+                               const MYFLT *restrict b, int32_t n)      \
+  {                                                                     \
+    int32_t i;                                                          \
+    for (i=0; i<n; i++) out[i] = out[i] OP b[i];                        \
+  }                                                                     \
+  static inline void name(MYFLT *out, const MYFLT *a,                   \
+                          const MYFLT *b, int32_t n)                    \
+  {                                                                     \
+    int32_t i;                                                          \
+    if (out != a && out != b) name##_2(out, a, b, n);                   \
+    else if (out == a && a != b) name##_in(out, b, n);                  \
+    else for (i=0; i<n; i++) out[i] = a[i] OP b[i];                     \
+  }
 
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=l->sizes[i];
-      sizer*=r->sizes[i];
-    }
-    if (sizer<sizel) sizel= sizer;
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] + r->data[i];
-    return OK;
-}
+TAB_KERNEL(vec_add, +)
+TAB_KERNEL(vec_sub, -)
+TAB_KERNEL(vec_mul, *)
+TAB_KERNEL(vec_div, /)
+
+/* Array and scalar kernels: x is the array element, s the scalar.  The
+   output may only alias the array operand as a whole. */
+#define TAB_SKERNEL(name, EXPR)                                         \
+  static inline void name##_2(MYFLT *restrict out,                      \
+                              const MYFLT *restrict a, MYFLT s,         \
+                              int32_t n)                                \
+  {                                                                     \
+    int32_t i;                                                          \
+    for (i=0; i<n; i++) { MYFLT x = a[i]; out[i] = EXPR; }              \
+  }                                                                     \
+  static inline void name(MYFLT *out, const MYFLT *a, MYFLT s,          \
+                          int32_t n)                                    \
+  {                                                                     \
+    int32_t i;                                                          \
+    if (out != a) name##_2(out, a, s, n);                               \
+    else for (i=0; i<n; i++) { MYFLT x = out[i]; out[i] = EXPR; }       \
+  }
+
+TAB_SKERNEL(vec_adds, x + s)
+TAB_SKERNEL(vec_subs, x - s)
+TAB_SKERNEL(vec_rsubs, s - x)
+TAB_SKERNEL(vec_muls, x * s)
+TAB_SKERNEL(vec_divs, x / s)
+TAB_SKERNEL(vec_rdivs, s / x)
 
-static int32_t tabsub(CSOUND *csound, TABARITH *p)
+/* index of the first zero divisor in b[0..n), or -1; checked before the
+   division kernels run so that they stay branch free */
+static inline int32_t vec_zero(const MYFLT *b, int32_t n)
 {
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->left;
-    ARRAYDAT *r   = p->right;
-    int32_t sizel    = l->sizes[0];
-    int32_t sizer    = r->sizes[0];
     int32_t i;
-
-    if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=l->sizes[i];
-      sizer*=r->sizes[i];
-    }
-    if (sizer<sizel) sizel= sizer;
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] - r->data[i];
-    return OK;
+    for (i=0; i<n; i++)
+      if (UNLIKELY(b[i] == FL(0.0))) return i;
+    return -1;
 }
 
-static int32_t tabmult(CSOUND *csound, TABARITH *p)
+/* Audio arrays: every member is a ksmps vector.  The kernels run on the
+   live samples [offset, nsmps) of each member and the rest is cleared. */
+static inline void tab_aframe(MYFLT *aa, uint32_t offset, uint32_t early,
+                              int32_t nsmps)
 {
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->left;
-    ARRAYDAT *r   = p->right;
-    int32_t sizel    = l->sizes[0];
-    int32_t sizer    = r->sizes[0];
-    int32_t i;
+    if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
+}
+
+/* a[] op a[]; with DIV set the divisors are checked first */
+#define TABARITH_AA(opcode, kernel, DIV)                                \
+  static int32_t opcode(CSOUND *csound, TABARITH *p)                    \
+  {                                                                     \
+    ARRAYDAT *ans = p->ans;                                             \
+    ARRAYDAT *l   = p->left;                                            \
+    ARRAYDAT *r   = p->right;                                           \
+    uint32_t offset = p->h.insdshead->ksmps_offset;                     \
+    uint32_t early  = p->h.insdshead->ksmps_no_end;                     \
+    int32_t i, z, size, nsmps = CS_KSMPS-early;                         \
+    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);                \
+                                                                        \
+    if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))  \
+      return csound->PerfError(csound, &(p->h),                         \
+                               Str("array-variable not initialised"));  \
+    size = tab_elems(l);                                                \
+    if (tab_elems(r) < size) size = tab_elems(r);                       \
+    for (i=0; i<size; i++) {                                            \
+      MYFLT *aa = &(ans->data[i*span]);                                 \
+      const MYFLT *a = &(l->data[i*span]), *b = &(r->data[i*span]);     \
+      if (DIV && UNLIKELY((z = vec_zero(&b[offset], nsmps-offset)) >= 0)) \
+        return csound->PerfError(csound, &(p->h),                       \
+                                 Str("division by zero in array-var "   \
+                                     "at index %d/%d"), i, z+offset);   \
+      tab_aframe(aa, offset, early, nsmps);                             \
+      kernel(&aa[offset], &a[offset], &b[offset], nsmps-offset);        \
+    }                                                                   \
+    return OK;                                                          \
+  }
 
-    if (UNLIKELY(ans->data == NULL || l->data== NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
+/* a[] op= a[] */
+#define TABARITHIN_AA(opcode, kernel)                                   \
+  static int32_t opcode(CSOUND *csound, TABARITHIN *p)                  \
+  {                                                                     \
+    ARRAYDAT *ans = p->ans;                                             \
+    ARRAYDAT *r   = p->right;                                           \
+    uint32_t offset = p->h.insdshead->ksmps_offset;                     \
+    uint32_t early  = p->h.insdshead->ksmps_no_end;                     \
+    int32_t i, size, nsmps = CS_KSMPS-early;                            \
+    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);                \
+                                                                        \
+    if (UNLIKELY(ans->data == NULL || r->data==NULL))                   \
+      return csound->PerfError(csound, &(p->h),                         \
+                               Str("array-variable not initialised"));  \
+    size = tab_elems(ans);                                              \
+    if (tab_elems(r) < size) size = tab_elems(r);                       \
+    for (i=0; i<size; i++) {                                            \
+      MYFLT *aa = &(ans->data[i*span]);                                 \
+      tab_aframe(aa, offset, early, nsmps);                             \
+      kernel(&aa[offset], &aa[offset], &(r->data[i*span+offset]),       \
+             nsmps-offset);                                             \
+    }                                                                   \
+    return OK;                                                          \
+  }
 
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=l->sizes[i];
-      sizer*=r->sizes[i];
-    }
-    if (sizer<sizel) sizel= sizer;
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] * r->data[i];
-    return OK;
-}
+/* a[] op k and k op a[]: arr and scal name the operand fields of TYPE */
+#define TABARITH_AK(opcode, TYPE, arr, scal, kernel)                    \
+  static int32_t opcode(CSOUND *csound, TYPE *p)                        \
+  {                                                                     \
+    ARRAYDAT *ans = p->ans;                                             \
+    ARRAYDAT *r   = p->arr;                                             \
+    MYFLT    s    = *p->scal;                                           \
+    uint32_t offset = p->h.insdshead->ksmps_offset;                     \
+    uint32_t early  = p->h.insdshead->ksmps_no_end;                     \
+    int32_t i, size, nsmps = CS_KSMPS-early;                            \
+    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);                \
+                                                                        \
+    if (UNLIKELY(ans->data == NULL || r->data==NULL))                   \
+      return csound->PerfError(csound, &(p->h),                         \
+                               Str("array-variable not initialised"));  \
+    size = tab_elems(r);                                                \
+    for (i=0; i<size; i++) {                                            \
+      MYFLT *aa = &(ans->data[i*span]);                                 \
+      const MYFLT *b = &(r->data[i*span]);                              \
+      tab_aframe(aa, offset, early, nsmps);                             \
+      kernel(&aa[offset], &b[offset], s, nsmps-offset);                 \
+    }                                                                   \
+    return OK;                                                          \
+  }
+
+#define TABARITH_KK(opcode, kernel)                                     \
+  static int32_t opcode(CSOUND *csound, TABARITH *p)                    \
+  {                                                                     \
+    ARRAYDAT *ans = p->ans;                                             \
+    ARRAYDAT *l   = p->left;                                            \
+    ARRAYDAT *r   = p->right;                                           \
+    int32_t sizel, sizer;                                               \
+                                                                        \
+    if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))  \
+      return csound->PerfError(csound, &(p->h),                         \
+                               Str("array-variable not initialised"));  \
+    sizel = tab_elems(l);                                               \
+    sizer = tab_elems(r);                                               \
+    if (sizer<sizel) sizel = sizer;                                     \
+    kernel(ans->data, l->data, r->data, sizel);                         \
+    return OK;                                                          \
+  }
+
+TABARITH_KK(tabadd, vec_add)
+TABARITH_KK(tabsub, vec_sub)
+TABARITH_KK(tabmult, vec_mul)
 
 static int32_t tabdiv(CSOUND *csound, TABARITH *p)
 {
     ARRAYDAT *ans = p->ans;
     ARRAYDAT *l   = p->left;
     ARRAYDAT *r   = p->right;
-    int32_t sizel = l->sizes[0];
-    int32_t sizer = r->sizes[0];
-    int32_t i;
+    int32_t sizel, sizer, z;
 
     if (UNLIKELY(ans->data == NULL || l->data== NULL || r->data==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=l->sizes[i];
-      sizer*=r->sizes[i];
-    }
+    sizel = tab_elems(l);
+    sizer = tab_elems(r);
     if (sizer<sizel) sizel = sizer;
-    for (i=0; i<sizel; i++)
-      if (LIKELY(r->data[i]!=0))
-        ans->data[i] = l->data[i] / r->data[i];
-      else
-        return
-          csound->PerfError(csound, &(p->h),
-                            Str("division by zero in array-var at index %d"), i);
+    if (UNLIKELY((z = vec_zero(r->data, sizel)) >= 0))
+      return
+        csound->PerfError(csound, &(p->h),
+                          Str("division by zero in array-var at index %d"), z);
+    vec_div(ans->data, l->data, r->data, sizel);
     return OK;
 }
 
@@ -658,18 +769,10 @@ IIARRAY(tabpowi,tabpow)
 // Add array and scalar
 static int32_t tabiadd(CSOUND *csound, ARRAYDAT *ans, ARRAYDAT *l, MYFLT r, void *p)
 {
-    int32_t sizel = l->sizes[0];
-    int32_t i;
-
     if (UNLIKELY(ans->data == NULL || l->data== NULL))
       return csound->PerfError(csound, &(((TABARITH *) p)->h),
                                Str("array-variable not initialised"));
-
-   for (i=1; i<l->dimensions; i++) {
-      sizel*=l->sizes[i];
-    }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] + r;
+    vec_adds(ans->data, l->data, r, tab_elems(l));
     return OK;
 }
 
@@ -721,88 +824,15 @@ static int32_t tabaddinkk(CSOUND *csound, TABARITHIN *p)
       sizer*=r->sizes[i];
     }
     if (sizer<sizel) sizel= sizer;
-    for (i=0; i<sizel; i++)
-      ans->data[i] += r->data[i];
+    vec_add(ans->data, ans->data, r->data, sizel);
     return OK;
 }
 
 //a[]+=a[]
-static int32_t tabaaddin(CSOUND *csound, TABARITHIN *p)
-{
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *r   = p->right;
-    int32_t sizel    = ans->sizes[0];
-    int32_t sizer    = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=ans->sizes[i];
-      sizer*=r->sizes[i];
-    }
-    if (sizer<sizel) sizel= sizer;
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-    }
-    for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] += b[n];
-    }
-    return OK;
-}
+TABARITHIN_AA(tabaaddin, vec_add)
 
 // a[]-=a[]
-static int32_t tabaasubin(CSOUND *csound, TABARITHIN *p)
-{
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *r   = p->right;
-    int32_t sizel    = ans->sizes[0];
-    int32_t sizer    = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=ans->sizes[i];
-      sizer*=r->sizes[i];
-    }
-    if (sizer<sizel) sizel= sizer;
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-    }
-    for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] -= b[n];
-    }
-    return OK;
-}
+TABARITHIN_AA(tabaasubin, vec_sub)
 
 //a[]+=k[]
 static int32_t tabarkrddin(CSOUND *csound, TABARITHIN *p)
@@ -877,99 +907,13 @@ static int32_t tabarkrsbin(CSOUND *csound, TABARITH *p)
 }
 
 //a[]+=k
-static int32_t tabakaddin(CSOUND *csound, TABARITHIN1 *p)
-{
-    ARRAYDAT *ans   = p->ans;
-    MYFLT l         = *p->right;
-    int32_t sizel   = ans->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=ans->sizes[i];
-    for (i=0; i<sizel; i++) {
-      MYFLT *aa;
-      int32_t j = i*span;
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] += l;
-    }
-    return OK;
-}
+TABARITH_AK(tabakaddin, TABARITHIN1, ans, right, vec_adds)
 //========================
 //a[]-=k
-static int32_t tabaksubin(CSOUND *csound, TABARITHIN1 *p)
-{
-    ARRAYDAT *ans   = p->ans;
-    MYFLT l         = *p->right;
-    int32_t sizel   = ans->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=ans->sizes[i];
-    for (i=0; i<sizel; i++) {
-      MYFLT *aa;
-      int32_t j = i*span;
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] -= l;
-    }
-    return OK;
-}
+TABARITH_AK(tabaksubin, TABARITHIN1, ans, right, vec_subs)
 
 // a[] - k
-static int32_t tabaksub(CSOUND *csound, TABARITH1 *p)
-{
-    ARRAYDAT *ans   = p->ans;
-    MYFLT l         = *p->right;
-    ARRAYDAT *r     = p->left;
-    int32_t sizel   = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=r->sizes[i];
-    for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = b[n] - l;
-    }
-    return OK;
-}
+TABARITH_AK(tabaksub, TABARITH1, left, right, vec_subs)
 
 
 // K[] -= K
@@ -990,8 +934,7 @@ static int32_t subinAA(CSOUND *csound, TABARITHIN *p)
       sizer*=r->sizes[i];
     }
     if (sizer<sizel) sizel= sizer;
-    for (i=0; i<sizel; i++)
-      ans->data[i] -=r->data[i];
+    vec_sub(ans->data, ans->data, r->data, sizel);
     return OK;
 }
 
@@ -1014,8 +957,7 @@ static int32_t tabsubinkk(CSOUND *csound, TABARITHIN *p)
       sizer*=r->sizes[i];
     }
     if (sizer<sizel) sizel= sizer;
-    for (i=0; i<sizel; i++)
-      ans->data[i] -= r->data[i];
+    vec_sub(ans->data, ans->data, r->data, sizel);
     return OK;
 }
 
@@ -1028,18 +970,11 @@ static int32_t tabaisub(CSOUND *csound, TABARITH1 *p)
     ARRAYDAT *ans = p->ans;
     ARRAYDAT *l   = p->left;
     MYFLT r       = *p->right;
-    int32_t sizel = l->sizes[0];
-    int32_t i;
 
     if (UNLIKELY(ans->data == NULL || l->data== NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not initialised"));
-
-   for (i=1; i<l->dimensions; i++) {
-      sizel*=l->sizes[i];
-    }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] - r;
+    vec_subs(ans->data, l->data, r, tab_elems(l));
     return OK;
 }
 
@@ -1048,19 +983,12 @@ static int32_t tabiasub(CSOUND *csound, TABARITH2 *p)
 {
     ARRAYDAT *ans = p->ans;
     ARRAYDAT *l   = p->right;
-    MYFLT r     = *p->left;
-    int32_t sizel = l->sizes[0];
-    int32_t i;
+    MYFLT r       = *p->left;
 
     if (UNLIKELY(ans->data == NULL || l->data== NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not initialised"));
-
-   for (i=1; i<l->dimensions; i++) {
-      sizel*=l->sizes[i];
-    }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = r - l->data[i];
+    vec_rsubs(ans->data, l->data, r, tab_elems(l));
     return OK;
 }
 
@@ -1068,18 +996,10 @@ static int32_t tabiasub(CSOUND *csound, TABARITH2 *p)
 static int32_t tabimult(CSOUND *csound, ARRAYDAT *ans, ARRAYDAT *l,
                         MYFLT r, void *p)
 {
-    int32_t sizel    = l->sizes[0];
-    int32_t i;
-
     if (UNLIKELY(ans->data == NULL || l->data== NULL))
       return csound->PerfError(csound, &(((TABARITH1 *)p)->h),
                                Str("array-variable not initialised"));
-
-    for (i=1; i<l->dimensions; i++) {
-      sizel*=l->sizes[i];
-    }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] * r;
+    vec_muls(ans->data, l->data, r, tab_elems(l));
     return OK;
 }
 
@@ -1107,8 +1027,6 @@ static int32_t tabaidiv(CSOUND *csound, TABARITH1 *p)
     ARRAYDAT *ans = p->ans;
     ARRAYDAT *l   = p->left;
     MYFLT r       = *p->right;
-    int32_t sizel = l->sizes[0];
-    int32_t i;
 
     if (UNLIKELY(r==FL(0.0)))
       return csound->PerfError(csound, &(p->h),
@@ -1116,12 +1034,7 @@ static int32_t tabaidiv(CSOUND *csound, TABARITH1 *p)
     if (UNLIKELY(ans->data == NULL || l->data== NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not initialised"));
-
-    for (i=1; i<l->dimensions; i++) {
-      sizel*=l->sizes[i];
-    }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] / r;
+    vec_divs(ans->data, l->data, r, tab_elems(l));
     return OK;
 }
 
@@ -1131,22 +1044,16 @@ static int32_t tabiadiv(CSOUND *csound, TABARITH2 *p)
     ARRAYDAT *ans = p->ans;
     ARRAYDAT *l   = p->right;
     MYFLT r     = *p->left;
-    int32_t sizel    = l->sizes[0];
-    int32_t i;
+    int32_t sizel;
 
     if (UNLIKELY(ans->data == NULL || l->data== NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not initialised"));
-
-    for (i=1; i<l->dimensions; i++) {
-      sizel*=l->sizes[i];
-    }
-    for (i=0; i<sizel; i++) {
-      if (UNLIKELY(l->data[i]==FL(0.0)))
-        return csound->PerfError(csound, &(p->h),
-                                 Str("division by zero in array-var"));
-      ans->data[i] = r / l->data[i];
-    }
+    sizel = tab_elems(l);
+    if (UNLIKELY(vec_zero(l->data, sizel) >= 0))
+      return csound->PerfError(csound, &(p->h),
+                               Str("division by zero in array-var"));
+    vec_rdivs(ans->data, l->data, r, sizel);
     return OK;
 }
 
@@ -1175,520 +1082,182 @@ static int32_t tabairem(CSOUND *csound, TABARITH1 *p)
 }
 
 // K % K[]
-static int32_t tabiarem(CSOUND *csound, TABARITH2 *p)
-{
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->right;
-    MYFLT r       = *p->left;
-    int32_t sizel = l->sizes[0];
-    int32_t i;
-
-    if (UNLIKELY(ans->data == NULL || l->data== NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<l->dimensions; i++) {
-      sizel*=l->sizes[i];
-    }
-    for (i=0; i<sizel; i++) {
-      if (UNLIKELY(l->data[i]==FL(0.0)))
-        return
-          csound->PerfError(csound, &(p->h),
-                            Str("division by zero in array-var at index %d"), i);
-      else
-        ans->data[i] = MOD(r,l->data[i]);
-    }
-    return OK;
-}
-
-// K[] pow K
-static int32_t tabaipow(CSOUND *csound, TABARITH1 *p)
-{
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->left;
-    MYFLT r       = *p->right;
-    int32_t sizel = l->sizes[0];
-    int32_t i;
-    MYFLT tmp;
-    int32_t intcase = (MODF(r,&tmp)==FL(0.0));
-
-    if (UNLIKELY(ans->data == NULL || l->data== NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<l->dimensions; i++) {
-      sizel*=l->sizes[i];
-    }
-    for (i=0; i<sizel; i++) {
-      if (intcase || LIKELY(l->data[i]>=0))
-        ans->data[i] = POWER(l->data[i], r);
-      else
-        return csound->PerfError(csound, &(p->h),
-                                 Str("undefined power in array-var at index %d"),
-                                 i);
-    }
-    return OK;
-}
-
-// K ^ K[]
-static int32_t tabiapow(CSOUND *csound, TABARITH2 *p)
-{
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->right;
-    MYFLT r     = *p->left;
-    int32_t sizel = l->sizes[0];
-    int32_t i;
-    MYFLT tmp;
-    int32_t poscase = (r>=FL(0.0));
-
-    if (UNLIKELY(ans->data == NULL || l->data== NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<l->dimensions; i++) {
-      sizel*=l->sizes[i];
-    }
-    for (i=0; i<sizel; i++) {
-      if (LIKELY(poscase || MODF(l->data[i],&tmp)==FL(0.0)))
-        ans->data[i] = POWER(r,l->data[i]);
-      else
-        return csound->PerfError(csound, &(p->h),
-                                 Str("undefined power in array-var at index %d"),
-                                    i);
-    }
-    return OK;
-}
-
-#define IiARRAY(opcode,fn)                              \
-  static int32_t opcode(CSOUND *csound, TABARITH1 *p)   \
-  {                                                     \
-    if (!tabarithset1(csound, p)) return fn(csound, p); \
-    else return NOTOK;                                  \
-  }
-
-IiARRAY(tabaiaddi,tabaiadd)
-IiARRAY(tabaisubi,tabaisub)
-IiARRAY(tabaimulti,tabaimult)
-IiARRAY(tabaidivi,tabaidiv)
-IiARRAY(tabairemi,tabairem)
-IiARRAY(tabaipowi,tabaipow)
-
-#define iIARRAY(opcode,fn)                              \
-  static int32_t opcode(CSOUND *csound, TABARITH2 *p)   \
-  {                                                     \
-    if (!tabarithset2(csound, p)) return fn(csound, p); \
-    else return NOTOK;                                  \
-  }
-
-iIARRAY(tabiaaddi,tabiaadd)
-iIARRAY(tabiasubi,tabiasub)
-iIARRAY(tabiamulti,tabiamult)
-iIARRAY(tabiadivi,tabiadiv)
-iIARRAY(tabiaremi,tabiarem)
-iIARRAY(tabiapowi,tabiapow)
-
-//a[]+a[]
-static int32_t tabaadd(CSOUND *csound, TABARITH *p)
-{
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->left;
-    ARRAYDAT *r   = p->right;
-    int32_t sizel    = l->sizes[0];
-    int32_t sizer    = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=l->sizes[i];
-      sizer*=r->sizes[i];
-    }
-    if (sizer<sizel) sizel= sizer;
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-    }
-    for (i=0; i<sizel; i++) {
-      MYFLT *a,*b,*aa;
-      int32_t j = i*span;
-      a = (MYFLT*)&(l->data[j]); b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] + b[n];
-    }
-    return OK;
-}
-
-// a[]-a[]
-static int32_t tabasub(CSOUND *csound, TABARITH *p)
-{
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->left;
-    ARRAYDAT *r   = p->right;
-    int32_t sizel    = l->sizes[0];
-    int32_t sizer    = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=l->sizes[i];
-      sizer*=r->sizes[i];
-    }
-    if (sizer<sizel) sizel= sizer;
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-    }
-    for (i=0; i<sizel; i++) {
-      MYFLT *a,*b,*aa;
-      int32_t j = i*span;
-      a = (MYFLT*)&(l->data[j]); b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] - b[n];
-    }
-    return OK;
-}
-
-// a[]*a[]
-static int32_t tabamul(CSOUND *csound, TABARITH *p)
-{
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->left;
-    ARRAYDAT *r   = p->right;
-    int32_t sizel    = l->sizes[0];
-    int32_t sizer    = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=l->sizes[i];
-      sizer*=r->sizes[i];
-    }
-    if (sizer<sizel) sizel= sizer;
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-    }
-    for (i=0; i<sizel; i++) {
-      MYFLT *a,*b,*aa;
-      int32_t j = i*span;
-      a = (MYFLT*)&(l->data[j]); b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] * b[n];
-    }
-    return OK;
-}
-
-// a[]/a[]
-static int32_t tabadiv(CSOUND *csound, TABARITH *p)
-{
-    ARRAYDAT *ans = p->ans;
-    ARRAYDAT *l   = p->left;
-    ARRAYDAT *r   = p->right;
-    int32_t sizel    = l->sizes[0];
-    int32_t sizer    = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++) {
-      sizel*=l->sizes[i];
-      sizer*=r->sizes[i];
-    }
-    if (sizer<sizel) sizel= sizer;
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-    }
-    for (i=0; i<sizel; i++) {
-      MYFLT *a,*b,*aa;
-      int32_t j = i*span;
-      a = (MYFLT*)&(l->data[j]); b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++) {
-        if (UNLIKELY(b[n]==FL(0.0)))
-          return csound->PerfError(csound, &(p->h),
-                                  Str("division by zero in array-var "
-                                      "at index %d/%d"), i,n);
-        aa[n] = a[n] / b[n];
-      }
-    }
-    return OK;
-}
-
-// k * a[]
-static int32_t tabkamult(CSOUND *csound, TABARITH2 *p)
-{
-    ARRAYDAT *ans   = p->ans;
-    MYFLT l         = *p->left;
-    ARRAYDAT *r     = p->right;
-    int32_t sizel        = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=r->sizes[i];
-    for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l * b[n];
-    }
-    return OK;
-}
-
-// a[] * k
-static int32_t tabakmult(CSOUND *csound, TABARITH1 *p)
-{
-    ARRAYDAT *ans   = p->ans;
-    MYFLT l         = *p->right;
-    ARRAYDAT *r     = p->left;
-    int32_t sizel        = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=r->sizes[i];
-    for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l * b[n];
-    }
-    return OK;
-}
-
-// k + a[]
-static int32_t tabkaadd(CSOUND *csound, TABARITH2 *p)
+static int32_t tabiarem(CSOUND *csound, TABARITH2 *p)
 {
-    ARRAYDAT *ans   = p->ans;
-    MYFLT l         = *p->left;
-    ARRAYDAT *r     = p->right;
-    int32_t sizel   = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
+    ARRAYDAT *ans = p->ans;
+    ARRAYDAT *l   = p->right;
+    MYFLT r       = *p->left;
+    int32_t sizel = l->sizes[0];
+    int32_t i;
 
-    if (UNLIKELY(ans->data == NULL || r->data==NULL))
+    if (UNLIKELY(ans->data == NULL || l->data== NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not initialised"));
 
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=r->sizes[i];
+    for (i=1; i<l->dimensions; i++) {
+      sizel*=l->sizes[i];
+    }
     for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l + b[n];
+      if (UNLIKELY(l->data[i]==FL(0.0)))
+        return
+          csound->PerfError(csound, &(p->h),
+                            Str("division by zero in array-var at index %d"), i);
+      else
+        ans->data[i] = MOD(r,l->data[i]);
     }
     return OK;
 }
 
-// a[] + k
-static int32_t tabakadd(CSOUND *csound, TABARITH1 *p)
+// K[] pow K
+static int32_t tabaipow(CSOUND *csound, TABARITH1 *p)
 {
-    ARRAYDAT *ans   = p->ans;
-    MYFLT l         = *p->right;
-    ARRAYDAT *r     = p->left;
-    int32_t sizel   = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
+    ARRAYDAT *ans = p->ans;
+    ARRAYDAT *l   = p->left;
+    MYFLT r       = *p->right;
+    int32_t sizel = l->sizes[0];
+    int32_t i;
+    MYFLT tmp;
+    int32_t intcase = (MODF(r,&tmp)==FL(0.0));
 
-    if (UNLIKELY(ans->data == NULL || r->data==NULL))
+    if (UNLIKELY(ans->data == NULL || l->data== NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not initialised"));
 
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=r->sizes[i];
+    for (i=1; i<l->dimensions; i++) {
+      sizel*=l->sizes[i];
+    }
     for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l + b[n];
+      if (intcase || LIKELY(l->data[i]>=0))
+        ans->data[i] = POWER(l->data[i], r);
+      else
+        return csound->PerfError(csound, &(p->h),
+                                 Str("undefined power in array-var at index %d"),
+                                 i);
     }
     return OK;
 }
-//========================
-//k - a[]
-static int32_t tabkasub(CSOUND *csound, TABARITH2 *p)
+
+// K ^ K[]
+static int32_t tabiapow(CSOUND *csound, TABARITH2 *p)
 {
-    ARRAYDAT *ans   = p->ans;
-    MYFLT l         = *p->left;
-    ARRAYDAT *r     = p->right;
-    int32_t sizel   = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
+    ARRAYDAT *ans = p->ans;
+    ARRAYDAT *l   = p->right;
+    MYFLT r     = *p->left;
+    int32_t sizel = l->sizes[0];
+    int32_t i;
+    MYFLT tmp;
+    int32_t poscase = (r>=FL(0.0));
 
-    if (UNLIKELY(ans->data == NULL || r->data==NULL))
+    if (UNLIKELY(ans->data == NULL || l->data== NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not initialised"));
 
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=r->sizes[i];
+    for (i=1; i<l->dimensions; i++) {
+      sizel*=l->sizes[i];
+    }
     for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l - b[n];
+      if (LIKELY(poscase || MODF(l->data[i],&tmp)==FL(0.0)))
+        ans->data[i] = POWER(r,l->data[i]);
+      else
+        return csound->PerfError(csound, &(p->h),
+                                 Str("undefined power in array-var at index %d"),
+                                    i);
     }
     return OK;
 }
 
+#define IiARRAY(opcode,fn)                              \
+  static int32_t opcode(CSOUND *csound, TABARITH1 *p)   \
+  {                                                     \
+    if (!tabarithset1(csound, p)) return fn(csound, p); \
+    else return NOTOK;                                  \
+  }
+
+IiARRAY(tabaiaddi,tabaiadd)
+IiARRAY(tabaisubi,tabaisub)
+IiARRAY(tabaimulti,tabaimult)
+IiARRAY(tabaidivi,tabaidiv)
+IiARRAY(tabairemi,tabairem)
+IiARRAY(tabaipowi,tabaipow)
+
+#define iIARRAY(opcode,fn)                              \
+  static int32_t opcode(CSOUND *csound, TABARITH2 *p)   \
+  {                                                     \
+    if (!tabarithset2(csound, p)) return fn(csound, p); \
+    else return NOTOK;                                  \
+  }
+
+iIARRAY(tabiaaddi,tabiaadd)
+iIARRAY(tabiasubi,tabiasub)
+iIARRAY(tabiamulti,tabiamult)
+iIARRAY(tabiadivi,tabiadiv)
+iIARRAY(tabiaremi,tabiarem)
+iIARRAY(tabiapowi,tabiapow)
+
+//a[]+a[]
+TABARITH_AA(tabaadd, vec_add, 0)
+
+// a[]-a[]
+TABARITH_AA(tabasub, vec_sub, 0)
+
+// a[]*a[]
+TABARITH_AA(tabamul, vec_mul, 0)
+
+// a[]/a[]
+TABARITH_AA(tabadiv, vec_div, 1)
+
+// k * a[]
+TABARITH_AK(tabkamult, TABARITH2, right, left, vec_muls)
+
+// a[] * k
+TABARITH_AK(tabakmult, TABARITH1, left, right, vec_muls)
+
+// k + a[]
+TABARITH_AK(tabkaadd, TABARITH2, right, left, vec_adds)
+
+// a[] + k
+TABARITH_AK(tabakadd, TABARITH1, left, right, vec_adds)
+//========================
+//k - a[]
+TABARITH_AK(tabkasub, TABARITH2, right, left, vec_rsubs)
+
 //k / a[]
 static int32_t tabkadiv(CSOUND *csound, TABARITH2 *p)
 {
     ARRAYDAT *ans   = p->ans;
     MYFLT l         = *p->left;
     ARRAYDAT *r     = p->right;
-    int32_t sizel   = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, z, size, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not initialised"));
-
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=r->sizes[i];
-    for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++) {
-        if (UNLIKELY(b[n]==FL(0.0)))
-          return csound->PerfError(csound, &(p->h),
-                            Str("division by zero in array-var "
-                                "at index %d/%d"), i,n);
-        aa[n] = l / b[n];
-      }
+    size = tab_elems(r);
+    for (i=0; i<size; i++) {
+      MYFLT *aa = &(ans->data[i*span]);
+      const MYFLT *b = &(r->data[i*span]);
+      if (UNLIKELY((z = vec_zero(&b[offset], nsmps-offset)) >= 0))
+        return csound->PerfError(csound, &(p->h),
+                                 Str("division by zero in array-var "
+                                     "at index %d/%d"), i, z+offset);
+      tab_aframe(aa, offset, early, nsmps);
+      vec_rdivs(&aa[offset], &b[offset], l, nsmps-offset);
     }
     return OK;
 }
 
 // a[] / k
+TABARITH_AK(tabakdiv_, TABARITH1, left, right, vec_divs)
+
 static int32_t tabakdiv(CSOUND *csound, TABARITH1 *p)
 {
-    ARRAYDAT *ans   = p->ans;
-    MYFLT l         = *p->right;
-    ARRAYDAT *r     = p->left;
-    int32_t sizel    = r->sizes[0];
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
-    int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
-
-    if (UNLIKELY(ans->data == NULL || r->data==NULL))
-      return csound->PerfError(csound, &(p->h),
-                               Str("array-variable not initialised"));
-    if (UNLIKELY(l==FL(0.0)))
+    if (UNLIKELY(*p->right==FL(0.0)))
       return csound->PerfError(csound, &(p->h),
                                Str("division by zero in array-var"));
-
-    for (i=1; i<ans->dimensions; i++)
-      sizel*=r->sizes[i];
-    for (i=0; i<sizel; i++) {
-      MYFLT *b,*aa;
-      int32_t j = i*span;
-      b = (MYFLT*)&(r->data[j]);
-      aa = (MYFLT*)&(ans->data[j]);
-      if (UNLIKELY(offset)) memset(aa, '\0', offset*sizeof(MYFLT));
-      if (UNLIKELY(early)) {
-        memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
-      }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = b[n] / l;
-    }
-    return OK;
+    return tabakdiv_(csound, p);
 }
 
 // a[] % k
@@ -2646,6 +2215,75 @@ static int32_t tabsum1(CSOUND *csound, TABQUERY1 *p)
     else return NOTOK;
 }
 
+typedef struct {
+  OPDS h;
+  MYFLT  *ans;
+  ARRAYDAT *l, *r;
+} TABDOT;
+
+/* dotarray: sumarray(l*r) without the temporary product array.  As in
+   the array arithmetic, the shorter array sets the length, and k- and
+   a-arrays need not have been filled at init time. */
+static int32_t tabdot(CSOUND *csound, TABDOT *p)
+{
+    const MYFLT *a = p->l->data, *b = p->r->data;
+    int32_t i, size;
+    MYFLT s0 = FL(0.0), s1 = FL(0.0), s2 = FL(0.0), s3 = FL(0.0);
+
+    if (UNLIKELY(a == NULL || b == NULL))
+      return csound->PerfError(csound, &(p->h),
+                               Str("array-variable not initialised"));
+    size = tab_elems(p->l);
+    if (tab_elems(p->r) < size) size = tab_elems(p->r);
+    /* four partial sums break the dependency chain */
+    for (i=0; i+4<=size; i+=4) {
+      s0 += a[i] * b[i];
+      s1 += a[i+1] * b[i+1];
+      s2 += a[i+2] * b[i+2];
+      s3 += a[i+3] * b[i+3];
+    }
+    for (; i<size; i++)
+      s0 += a[i] * b[i];
+    *p->ans = (s0 + s1) + (s2 + s3);
+    return OK;
+}
+
+static int32_t tabdot1(CSOUND *csound, TABDOT *p)
+{
+    if (UNLIKELY(p->l->data == NULL || p->r->data == NULL))
+      return csound->InitError(csound, "%s",
+                               Str("array-variable not initialised"));
+    return tabdot(csound, p);
+}
+
+static int32_t tabdota(CSOUND *csound, TABDOT *p)
+{
+    ARRAYDAT *l = p->l, *r = p->r;
+    MYFLT *ans = p->ans;
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    int32_t i, n, size, nsmps = CS_KSMPS;
+    int32_t span = (l->arrayMemberSize)/sizeof(MYFLT);
+
+    if (UNLIKELY(l->data == NULL || r->data == NULL))
+      return csound->PerfError(csound, &(p->h),
+                               Str("array-variable not initialised"));
+    size = tab_elems(l);
+    if (tab_elems(r) < size) size = tab_elems(r);
+    if (UNLIKELY(offset)) memset(ans, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&ans[nsmps], '\0', early*sizeof(MYFLT));
+    }
+    memset(&ans[offset], '\0', (nsmps-offset)*sizeof(MYFLT));
+    for (i=0; i<size; i++) {
+      const MYFLT *a = &(l->data[i*span]), *b = &(r->data[i*span]);
+      for (n=offset; n<nsmps; n++)
+        ans[n] += a[n] * b[n];
+    }
+    return OK;
+}
+
 static int32_t tabscaleset(CSOUND *csound, TABSCALE *p)
 {
     if (LIKELY(p->tab->data && p->tab->dimensions==1)) return OK;
@@ -3099,8 +2737,23 @@ static int32_t tabslice(CSOUND *csound, TABSLICE *p) {
     if (UNLIKELY(inc<=0))
       return csound->InitError(csound, "%s",
                                Str("slice increment must be positive"));
-    tabinit(csound, p->tab, size);
+    /* the slice keeps its size from one k-cycle to the next, so only
+       (re)initialise the output when that changes */
+    if (p->tab->data == NULL || p->tab->dimensions != 1 ||
+        p->tab->sizes[0] != size)
+      tabinit(csound, p->tab, size);
 
+    if (p->tabin->arrayType->varTypeName[0] != 'S') {
+      /* numeric members are plain MYFLT blocks */
+      if (inc == 1)
+        memmove(p->tab->data, tabin + memMyfltSize * start,
+                size * memMyfltSize * sizeof(MYFLT));
+      else
+        for (i = start, destIndex = 0; i < end + 1; i+=inc, destIndex++)
+          memcpy(p->tab->data + (destIndex * memMyfltSize),
+                 tabin + (memMyfltSize * i), memMyfltSize * sizeof(MYFLT));
+      return OK;
+    }
     for (i = start, destIndex = 0; i < end + 1; i+=inc, destIndex++) {
       p->tab->arrayType->copyValue(csound,
                                    p->tab->data + (destIndex * memMyfltSize),
@@ -3412,20 +3065,30 @@ int32_t init_rfft(CSOUND *csound, FFT *p) {
     tabinit(csound, p->out,N);
     p->setup = csound->RealFFT2Setup(csound, N, FFT_FWD);
   }
-  else
+  else {
     tabinit(csound, p->out, N+2);
+    /* even sizes use a planned transform */
+    if (!(N & 1))
+      p->setup = csound->RealFFT2Setup(csound, N, FFT_FWD);
+  }
   return OK;
 }
 
 int32_t perf_rfft(CSOUND *csound, FFT *p) {
-    int32_t N = p->out->sizes[0];
-    memcpy(p->out->data,p->in->data,N*sizeof(MYFLT));
+    int32_t N = p->in->sizes[0];
+    MYFLT *data = p->out->data;
+    memcpy(data,p->in->data,N*sizeof(MYFLT));
     if (isPowerOfTwo(N)) {
-      csound->RealFFT2(csound,p->setup,p->out->data);
+      csound->RealFFT2(csound,p->setup,data);
+    }
+    else if (!(N & 1)) {
+      csound->RealFFT2(csound,p->setup,data);
+      data[N] = data[1];
+      data[1] = data[N+1] = FL(0.0);
     }
     else{
-      p->out->data[N] = FL(0.0);
-      csound->RealFFTnp2(csound,p->out->data,N);
+      data[N] = FL(0.0);
+      csound->RealFFTnp2(csound,data,N);
     }
     return OK;
 }
@@ -3445,19 +3108,29 @@ int32_t init_rifft(CSOUND *csound, FFT *p) {
     p->setup = csound->RealFFT2Setup(csound, N, FFT_INV);
     tabinit(csound, p->out, N);
   }
-  else
+  else {
     tabinit(csound, p->out, N+2);
+    if (!(N & 1))
+      p->setup = csound->RealFFT2Setup(csound, N, FFT_INV);
+  }
   return OK;
 }
 
 int32_t perf_rifft(CSOUND *csound, FFT *p) {
     int32_t N = p->in->sizes[0];
-    memcpy(p->out->data,p->in->data,N*sizeof(MYFLT));
+    MYFLT *data = p->out->data;
+    memcpy(data,p->in->data,N*sizeof(MYFLT));
     if (isPowerOfTwo(N))
-      csound->RealFFT2(csound,p->setup,p->out->data);
+      csound->RealFFT2(csound,p->setup,data);
+    else if (!(N & 1)) {
+      /* no Nyquist term in an N-point input */
+      data[1] = FL(0.0);
+      csound->RealFFT2(csound,p->setup,data);
+      data[N] = data[N+1] = FL(0.0);
+    }
     else{
-      p->out->data[N] = FL(0.0);
-      csound->InverseRealFFTnp2(csound,p->out->data,N);
+      data[N] = FL(0.0);
+      csound->InverseRealFFTnp2(csound,data,N);
     }
     return OK;
 }
@@ -4657,6 +4330,9 @@ static OENTRY arrayvars_localops[] =
     { "sumarray.a", sizeof(TABQUERY1),0, 3, "a", "a[]",
       (SUBR) tabqset1, (SUBR) tabsuma1 },
     { "sumarray.i", sizeof(TABQUERY1),0, 1, "i", "i[]", (SUBR) tabsum1   },
+    { "dotarray.k", sizeof(TABDOT),0, 2, "k", "k[]k[]", NULL, (SUBR) tabdot },
+    { "dotarray.a", sizeof(TABDOT),0, 2, "a", "a[]a[]", NULL, (SUBR) tabdota },
+    { "dotarray.i", sizeof(TABDOT),0, 1, "i", "i[]i[]", (SUBR) tabdot1   },
     { "scalet", sizeof(TABSCALE), _QQ|WI, 3, "",  "k[]kkOJ",
       (SUBR) tabscaleset,(SUBR) tabscale },
     { "scalearray.k", sizeof(TABSCALE), WI, 3, "",  "k[]kkOJ",
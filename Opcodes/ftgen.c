@@ -28,6 +28,17 @@ typedef struct {
     MYFLT   *ifno, *p1, *p2, *p3, *p4, *p5, *argums[VARGMAX-5];
 } FTGEN;
 
+typedef struct {
+    OPDS    h;
+    MYFLT   *ifno, *kready, *p1, *p2, *p3, *p4, *p5, *argums[VARGMAX-5];
+    int32_t fno, ready;
+} FTGENASYNC;
+
+typedef struct {
+    OPDS    h;
+    MYFLT   *kready, *kfno;
+} FTREADY;
+
 typedef struct {
     OPDS    h;
     MYFLT   *ifilno, *iflag, *argums[VARGMAX-2];
@@ -75,30 +86,29 @@ static int32_t register_ftable_delete(CSOUND *csound, void *p, int32_t tableNum)
     return csound->RegisterDeinitCallback(csound, op, ftable_delete);
 }
 
-/* set up and call any GEN routine */
-static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istring2)
+/* the f-statement of ftgen arguments args (p1 to p5, then the rest) */
+static EVTBLK *ftgen_event(CSOUND *csound, OPDS *h, MYFLT **args,
+                           int32_t istring1, int32_t istring2)
 {
     MYFLT   *fp;
-    FUNC    *ftp;
     EVTBLK  *ftevt;
     int32_t     n;
 
-    *p->ifno = FL(0.0);
     ftevt =(EVTBLK*) csound->Malloc(csound, sizeof(EVTBLK));
     ftevt->opcod = 'f';
     ftevt->strarg = NULL;
     fp = &ftevt->p[0];
     fp[0] = FL(0.0);
-    fp[1] = *p->p1;                                     /* copy p1 - p5 */
+    fp[1] = *args[0];                                   /* copy p1 - p5 */
     fp[2] = ftevt->p2orig = FL(0.0);                    /* force time 0 */
-    fp[3] = ftevt->p3orig = *p->p3;
-    fp[4] = *p->p4;
+    fp[3] = ftevt->p3orig = *args[2];
+    fp[4] = *args[3];
 
 
     if (istring1) {              /* Named gen */
       NAMEDGEN *named = (NAMEDGEN*) csound->GetNamedGens(csound);
       while (named) {
-        if (strcmp(named->name, ((STRINGDAT *) p->p4)->data) == 0) {
+        if (strcmp(named->name, ((STRINGDAT *) args[3])->data) == 0) {
           /* Look up by name */
           fp[4] = named->genum;
           break;
@@ -107,9 +117,9 @@ static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istrin
       }
       if (UNLIKELY(named == NULL)) {
         csound->Free(csound,ftevt);
-        return csound->InitError(csound,
-                                 Str("Named gen \"%s\" not defined"),
-                                 (char *)p->p4);
+        csound->InitError(csound, Str("Named gen \"%s\" not defined"),
+                          (char *)args[3]);
+        return NULL;
       }
       // else fp[4] = named->genum;
     }
@@ -125,26 +135,41 @@ static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istrin
       case 28:
       case 43:
       case 49:
-        ftevt->strarg = ((STRINGDAT *) p->p5)->data;
+        ftevt->strarg = ((STRINGDAT *) args[4])->data;
         break;
       default:
         csound->Free(csound, ftevt);
-        return csound->InitError(csound, Str("ftgen string arg not allowed"));
+        csound->InitError(csound, Str("ftgen string arg not allowed"));
+        return NULL;
       }
     }
     else {
-      fp[5] = *p->p5;                                   /* else no string */
+      fp[5] = *args[4];                                 /* else no string */
     }
-    n = csound->GetInputArgCnt(p);
+    n = csound->GetInputArgCnt(h);
     ftevt->pcnt = (int16) n;
     n -= 5;
     if (n > 0) {
-      MYFLT **argp = p->argums;
+      MYFLT **argp = &args[5];
       fp += 6;
       do {
         *fp++ = **argp++;                               /* copy rem arglist */
       } while (--n);
     }
+    return ftevt;
+}
+
+/* set up and call any GEN routine */
+static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istring2)
+{
+    FUNC    *ftp;
+    EVTBLK  *ftevt;
+    int32_t     n;
+
+    *p->ifno = FL(0.0);
+    ftevt = ftgen_event(csound, &p->h, &p->p1, istring1, istring2);
+    if (UNLIKELY(ftevt == NULL))
+      return NOTOK;
     n = csound->hfgens(csound, &ftp, ftevt, 1);         /* call the fgen */
     csound->Free(csound, ftevt);
     if (UNLIKELY(n != 0))
@@ -223,6 +248,79 @@ static int32_t ftgentmp_SS(CSOUND *csound, FTGEN *p)
     return register_ftable_delete(csound, p, fno);
 }
 
+/* as ftgen, with the GEN routine run in the background: the table number
+   is known at once, and kready becomes 1 when the table can be used (-1
+   if it failed) */
+static int32_t ftgenasync_(CSOUND *csound, FTGENASYNC *p, int32_t istring1,
+                           int32_t istring2, int32_t tmp)
+{
+    EVTBLK  *ftevt;
+
+    *p->ifno = *p->kready = FL(0.0);
+    p->fno = p->ready = 0;
+    ftevt = ftgen_event(csound, &p->h, &p->p1, istring1, istring2);
+    if (UNLIKELY(ftevt == NULL))
+      return NOTOK;
+    p->fno = csound->FTGenAsync(csound, ftevt, 1);
+    csound->Free(csound, ftevt);
+    if (UNLIKELY(p->fno < 0))
+      return csound->InitError(csound, Str("ftgen error"));
+    *p->ifno = (MYFLT) p->fno;
+    p->ready = csound->FTGenReady(csound, p->fno);
+    *p->kready = (MYFLT) p->ready;
+    if (tmp && p->fno > 0 && (int32_t) MYFLT2LRND(*p->p1) == 0)
+      return register_ftable_delete(csound, p, p->fno);
+    return OK;
+}
+
+static int32_t ftgenasync(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,0,0,0);
+}
+
+static int32_t ftgenasync_S(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,1,0,0);
+}
+
+static int32_t ftgenasync_iS(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,0,1,0);
+}
+
+static int32_t ftgenasync_SS(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,1,1,0);
+}
+
+static int32_t ftgentmpasync(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,0,0,1);
+}
+
+static int32_t ftgentmpasync_S(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,1,0,1);
+}
+
+static int32_t ftgentmpasync_iS(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,0,1,1);
+}
+
+static int32_t ftgentmpasync_SS(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,1,1,1);
+}
+
+static int32_t ftgenasync_poll(CSOUND *csound, FTGENASYNC *p)
+{
+    if (p->ready == 0 && p->fno > 0) {
+      p->ready = csound->FTGenReady(csound, p->fno);
+      *p->kready = (MYFLT) p->ready;
+    }
+    return OK;
+}
+
+static int32_t ftready(CSOUND *csound, FTREADY *p)
+{
+    *p->kready = (MYFLT) csound->FTGenReady(csound,
+                                            (int32_t) MYFLT2LRND(*p->kfno));
+    return OK;
+}
+
 static int32_t ftfree(CSOUND *csound, FTFREE *p)
 {
     int32_t fno = (int32_t) MYFLT2LRND(*p->iftno);
@@ -789,6 +887,24 @@ static OENTRY localops[] = {
   { "ftgentmp.iS", S(FTGEN),  TW, 1,  "i",  "iiiiSm", (SUBR) ftgentmp_S, NULL,NULL},
   { "ftgentmp.Si", S(FTGEN),  TW, 1,  "i",  "iiiSim", (SUBR) ftgentmp_Si,NULL,NULL},
   { "ftgentmp.SS", S(FTGEN),  TW, 1,  "i",  "iiiSSm", (SUBR) ftgentmp_SS,NULL,NULL},
+  { "ftgenasync", S(FTGENASYNC), TW, 3, "ik", "iiiiim",
+                         (SUBR) ftgenasync, (SUBR) ftgenasync_poll, NULL     },
+  { "ftgenasync.S", S(FTGENASYNC), TW, 3, "ik", "iiiSim",
+                         (SUBR) ftgenasync_S, (SUBR) ftgenasync_poll, NULL   },
+  { "ftgenasync.iS", S(FTGENASYNC), TW, 3, "ik", "iiiiSm",
+                         (SUBR) ftgenasync_iS, (SUBR) ftgenasync_poll, NULL  },
+  { "ftgenasync.SS", S(FTGENASYNC), TW, 3, "ik", "iiiSSm",
+                         (SUBR) ftgenasync_SS, (SUBR) ftgenasync_poll, NULL  },
+  { "ftgentmpasync", S(FTGENASYNC), TW, 3, "ik", "iiiiim",
+                         (SUBR) ftgentmpasync, (SUBR) ftgenasync_poll, NULL  },
+  { "ftgentmpasync.S", S(FTGENASYNC), TW, 3, "ik", "iiiSim",
+                         (SUBR) ftgentmpasync_S, (SUBR) ftgenasync_poll, NULL },
+  { "ftgentmpasync.iS", S(FTGENASYNC), TW, 3, "ik", "iiiiSm",
+                         (SUBR) ftgentmpasync_iS, (SUBR) ftgenasync_poll, NULL},
+  { "ftgentmpasync.SS", S(FTGENASYNC), TW, 3, "ik", "iiiSSm",
+                         (SUBR) ftgentmpasync_SS, (SUBR) ftgenasync_poll, NULL},
+  { "ftready",  S(FTREADY),   TR, 3,  "k",  "k",      (SUBR) ftready,
+                                                      (SUBR) ftready, NULL   },
   { "ftfree",   S(FTFREE),    TW, 1,  "",   "ii",     (SUBR) ftfree, NULL, NULL   },
   { "ftsave",   S(FTLOAD),    TR, 1,  "",   "iim",    (SUBR) ftsave, NULL, NULL   },
   { "ftsave.S",   S(FTLOAD),  TR, 1,  "",   "Sim",    (SUBR) ftsave_S, NULL, NULL },
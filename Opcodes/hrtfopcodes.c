@@ -2661,6 +2661,568 @@ static int32_t hrtfmove2_process(CSOUND *csound, hrtfmove2 *p)
     return OK;
 }
 
+/* Shared HRTF database and batched multi-source renderer */
+
+/* aleft, aright hrtfout Sfilel, Sfiler [, ibus = 0, isr = 0]
+   hrtfsrc asrc, kaz, kel, Sfilel, Sfiler [, ibus = 0, ifade = 8, isr = 0] */
+
+/* Every hrtfsrc adds its source, filtered by the HRTF pair for its
+   position, to the spectrum of a bus; each hrtfout reads the bus and needs
+   one inverse FFT per ear and per block, whatever the number of sources.
+   hrtfout must be in an instrument numbered higher than the sources.
+   The HRTFs are stored once per data file pair and sr in a database held
+   as the log magnitude and minimum phase of each measured position (the
+   Fourier transform of the folded real cepstrum, see Oppenheim and
+   Schafer), which can be interpolated linearly between positions; the
+   interaural delay is added as a linear phase. Position changes are
+   crossfaded in the frequency domain, over ifade blocks of irlength
+   samples as in hrtfmove. */
+
+/* measured positions stored in the data files */
+#define HRTF_NPOS     (368)
+
+typedef struct hrtfdb_
+{
+    struct hrtfdb_ *next;
+    char    filel[MAXNAME], filer[MAXNAME];
+    MYFLT   sr;
+    /* impulse length, fft size and hop size */
+    int32_t irlength, fftsize, hopsize;
+    /* maximum interaural delay, in samples */
+    MYFLT   mdt;
+    /* log magnitude and minimum phase, fftsize values per position and
+       ear, in the packed format of RealFFT() */
+    MYFLT   *spec;
+}
+HRTFDB;
+
+typedef struct hrtfbus_
+{
+    struct hrtfbus_ *next;
+    int32_t num;
+    HRTFDB  *db;
+    /* slots for the blocks completed during one k-cycle */
+    int32_t nslots;
+    /* block accumulated in each slot, -1 for none */
+    int64_t *block;
+    /* output spectra, nslots per ear */
+    MYFLT   *specl, *specr;
+    /* input spectrum, used by each source in turn */
+    MYFLT   *work;
+}
+HRTFBUS;
+
+typedef struct
+{
+    HRTFDB  *dbs;
+    HRTFBUS *buses;
+}
+HRTFSHARED;
+
+static HRTFSHARED *hrtf_shared(CSOUND *csound)
+{
+    HRTFSHARED *s =
+      (HRTFSHARED*) csound->QueryGlobalVariable(csound, "hrtfopcodes.shared");
+
+    if (s == NULL) {
+      if (UNLIKELY(csound->CreateGlobalVariable(csound, "hrtfopcodes.shared",
+                                                sizeof(HRTFSHARED)) != 0))
+        return NULL;
+      s = (HRTFSHARED*) csound->QueryGlobalVariable(csound,
+                                                    "hrtfopcodes.shared");
+    }
+    return s;
+}
+
+/* index of a measured position in the data files, which hold the half
+   circle up to 180 degrees at each elevation: the other half is read
+   mirrored, with the ears swapped */
+static int32_t hrtf_index(int32_t elevindex, int32_t angleindex, int32_t *swap)
+{
+    int32_t i, skip = 0, n = elevationarray[elevindex];
+
+    for (i = 0; i < elevindex; i++)
+      skip += elevationarray[i] / 2 + 1;
+    if (angleindex > n / 2) {
+      *swap = 1;
+      return skip + n - angleindex;
+    }
+    *swap = 0;
+    return skip + angleindex;
+}
+
+/* log magnitude and minimum phase of one impulse from its magnitudes */
+static void hrtf_minphase(CSOUND *csound, HRTFDB *db, const float *mag,
+                          MYFLT *spec, MYFLT *buf)
+{
+    int32_t i, irlength = db->irlength, fftsize = db->fftsize;
+    MYFLT   m;
+
+    /* 0 Hz and Nyquist are real */
+    for (i = 0; i < 2; i++) {
+      m = FABS((MYFLT) mag[i]);
+      buf[i] = LOG(m == FL(0.0) ? FL(0.00000001) : m);
+    }
+    for (i = 2; i < irlength; i += 2) {
+      m = FABS((MYFLT) mag[i]);
+      buf[i] = LOG(m == FL(0.0) ? FL(0.00000001) : m);
+      buf[i + 1] = FL(0.0);
+    }
+    /* real cepstrum, folded onto its causal half */
+    csound->InverseRealFFT(csound, buf, irlength);
+    for (i = 1; i < irlength / 2; i++)
+      spec[i] = FL(2.0) * buf[i];
+    spec[0] = buf[0];
+    spec[irlength / 2] = buf[irlength / 2];
+    memset(&spec[irlength / 2 + 1], 0,
+           (fftsize - irlength / 2 - 1) * sizeof(MYFLT));
+    /* log magnitude and phase at the padded resolution */
+    csound->RealFFT(csound, spec, fftsize);
+}
+
+static HRTFDB *hrtf_database(CSOUND *csound, const char *filel,
+                             const char *filer, MYFLT sr)
+{
+    HRTFSHARED *s = hrtf_shared(csound);
+    HRTFDB  *db;
+    MEMFIL  *fpl, *fpr;
+    MYFLT   *buf;
+    int32_t i, irlength;
+
+    if (UNLIKELY(s == NULL))
+      return NULL;
+    for (db = s->dbs; db != NULL; db = db->next)
+      if (db->sr == sr && !strcmp(db->filel, filel) &&
+          !strcmp(db->filer, filer))
+        return db;
+
+    irlength = (sr == FL(96000.0) ? 256 : 128);
+    fpl = csound->ldmemfile2withCB(csound, filel, CSFTYPE_FLOATS_BINARY,
+                                   swap4bytes);
+    if (UNLIKELY(fpl == NULL)) {
+      csound->ErrorMsg(csound, Str("Cannot load left data file %s"), filel);
+      return NULL;
+    }
+    fpr = csound->ldmemfile2withCB(csound, filer, CSFTYPE_FLOATS_BINARY,
+                                   swap4bytes);
+    if (UNLIKELY(fpr == NULL)) {
+      csound->ErrorMsg(csound, Str("Cannot load right data file %s"), filer);
+      return NULL;
+    }
+    if (UNLIKELY(fpl->length < HRTF_NPOS * irlength * (int64_t) sizeof(float) ||
+                 fpr->length < HRTF_NPOS * irlength * (int64_t) sizeof(float))) {
+      csound->ErrorMsg(csound, Str("HRTF data files %s and %s are too short "
+                                   "for sr = %.0f"), filel, filer, sr);
+      return NULL;
+    }
+
+    db = (HRTFDB*) csound->Calloc(csound, sizeof(HRTFDB));
+    strNcpy(db->filel, filel, MAXNAME);
+    strNcpy(db->filer, filer, MAXNAME);
+    db->sr = sr;
+    db->irlength = irlength;
+    /* blocks of 2 * irlength samples leave room for the impulse and the
+       interaural delay in the padded convolution */
+    db->fftsize = 4 * irlength;
+    db->hopsize = 2 * irlength;
+    db->mdt = (MYFLT) ((int32_t) (FL(0.00095) * sr));
+    db->spec = (MYFLT*) csound->Malloc(csound, 2 * HRTF_NPOS * db->fftsize *
+                                               sizeof(MYFLT));
+    buf = (MYFLT*) csound->Malloc(csound, irlength * sizeof(MYFLT));
+    for (i = 0; i < HRTF_NPOS; i++) {
+      hrtf_minphase(csound, db, (float*) fpl->beginp + i * irlength,
+                    db->spec + (2 * i) * db->fftsize, buf);
+      hrtf_minphase(csound, db, (float*) fpr->beginp + i * irlength,
+                    db->spec + (2 * i + 1) * db->fftsize, buf);
+    }
+    csound->Free(csound, buf);
+    db->next = s->dbs;
+    s->dbs = db;
+    return db;
+}
+
+static HRTFBUS *hrtf_bus(CSOUND *csound, int32_t num, HRTFDB *db)
+{
+    HRTFSHARED *s = hrtf_shared(csound);
+    HRTFBUS *bus;
+    int32_t i, fftsize = db->fftsize;
+
+    for (bus = s->buses; bus != NULL; bus = bus->next)
+      if (bus->num == num)
+        return (bus->db == db ? bus : NULL);
+    bus = (HRTFBUS*) csound->Calloc(csound, sizeof(HRTFBUS));
+    bus->num = num;
+    bus->db = db;
+    bus->nslots = (int32_t) csound->ksmps / db->hopsize + 2;
+    bus->block = (int64_t*) csound->Malloc(csound,
+                                           bus->nslots * sizeof(int64_t));
+    for (i = 0; i < bus->nslots; i++)
+      bus->block[i] = -1;
+    bus->specl = (MYFLT*) csound->Calloc(csound, bus->nslots * fftsize *
+                                                 sizeof(MYFLT));
+    bus->specr = (MYFLT*) csound->Calloc(csound, bus->nslots * fftsize *
+                                                 sizeof(MYFLT));
+    bus->work = (MYFLT*) csound->Calloc(csound, fftsize * sizeof(MYFLT));
+    bus->next = s->buses;
+    s->buses = bus;
+    return bus;
+}
+
+static int32_t hrtf_bus_init(CSOUND *csound, OPDS *h, STRINGDAT *ifilel,
+                             STRINGDAT *ifiler, MYFLT ibus, MYFLT osr,
+                             HRTFBUS **bus)
+{
+    HRTFDB  *db;
+    MYFLT   sr = osr;
+
+    if (UNLIKELY(h->insdshead->ksmps != csound->ksmps))
+      return csound->InitError(csound, Str("%s: local ksmps not supported"),
+                               csound->GetOpcodeName(h));
+    if (sr == 0) sr = CS_ESR;
+    if (sr != FL(44100.0) && sr != FL(48000.0) && sr != FL(96000.0))
+      sr = FL(44100.0);
+    if (UNLIKELY(CS_ESR != sr))
+      csound->Message(csound,
+                      Str("\n\nWARNING!!:\nOrchestra SR not compatible with "
+                          "HRTF processing SR of: %.0f\n\n"), sr);
+    db = hrtf_database(csound, (char*) ifilel->data, (char*) ifiler->data, sr);
+    if (UNLIKELY(db == NULL))
+      return csound->InitError(csound, Str("%s: cannot load HRTF data"),
+                               csound->GetOpcodeName(h));
+    *bus = hrtf_bus(csound, (int32_t) ibus, db);
+    if (UNLIKELY(*bus == NULL))
+      return csound->InitError(csound, Str("%s: bus %d is used with other "
+                                           "HRTF data"),
+                               csound->GetOpcodeName(h), (int32_t) ibus);
+    return OK;
+}
+
+typedef struct
+{
+        OPDS  h;
+        /* inputs */
+        MYFLT *in, *kangle, *kelev;
+        STRINGDAT *ifilel, *ifiler;
+        MYFLT *ibus, *ofade, *osr;
+
+        HRTFBUS *bus;
+
+        /* position of the current hrtfs */
+        MYFLT anglev, elevv;
+
+        /* fade length and position, in blocks */
+        int32_t fade, l;
+
+        /* input block */
+        AUXCH insig;
+        /* current and previous hrtf spectra, complex */
+        AUXCH hrtfl, hrtfr, oldhrtfl, oldhrtfr;
+}
+hrtfsrc;
+
+static int32_t hrtfsrc_init(CSOUND *csound, hrtfsrc *p)
+{
+    int32_t fade = (int32_t) *p->ofade, fftsize;
+
+    if (UNLIKELY(hrtf_bus_init(csound, &p->h, p->ifilel, p->ifiler, *p->ibus,
+                               *p->osr, &p->bus) != OK))
+      return NOTOK;
+    fftsize = p->bus->db->fftsize;
+
+    /* fade length: default 8, max 24, min 1, in impulse lengths */
+    if (fade < 1 || fade > 24)
+      fade = 8;
+    p->fade = (fade * p->bus->db->irlength + p->bus->db->hopsize - 1) /
+      p->bus->db->hopsize;
+    p->l = p->fade;
+
+    csound->AuxAlloc(csound, p->bus->db->hopsize * sizeof(MYFLT), &p->insig);
+    csound->AuxAlloc(csound, fftsize * sizeof(MYFLT), &p->hrtfl);
+    csound->AuxAlloc(csound, fftsize * sizeof(MYFLT), &p->hrtfr);
+    csound->AuxAlloc(csound, fftsize * sizeof(MYFLT), &p->oldhrtfl);
+    csound->AuxAlloc(csound, fftsize * sizeof(MYFLT), &p->oldhrtfr);
+
+    /* illegal values to ensure first read */
+    p->anglev = -1;
+    p->elevv = -41;
+    return OK;
+}
+
+/* complex hrtf spectrum from log magnitude and phase, delayed by del
+   samples */
+static void hrtf_polar(MYFLT *spec, int32_t fftsize, MYFLT del)
+{
+    int32_t i;
+    MYFLT   mag, ph, w = -TWOPI * del / fftsize;
+
+    spec[0] = EXP(spec[0]);
+    spec[1] = EXP(spec[1]) * COS(PI * del);
+    for (i = 2; i < fftsize; i += 2) {
+      mag = EXP(spec[i]);
+      ph = spec[i + 1] + w * (i >> 1);
+      spec[i] = mag * COS(ph);
+      spec[i + 1] = mag * SIN(ph);
+    }
+}
+
+/* new target hrtfs, interpolated between the 4 nearest measured
+   positions */
+static void hrtfsrc_position(CSOUND *csound, hrtfsrc *p,
+                             MYFLT angle, MYFLT elev)
+{
+    HRTFDB  *db = p->bus->db;
+    int32_t fftsize = db->fftsize;
+    MYFLT   *hrtfl = (MYFLT *)p->hrtfl.auxp;
+    MYFLT   *hrtfr = (MYFLT *)p->hrtfr.auxp;
+    MYFLT   *oldhrtfl = (MYFLT *)p->oldhrtfl.auxp;
+    MYFLT   *oldhrtfr = (MYFLT *)p->oldhrtfr.auxp;
+    MYFLT   elevindexstore, angleindexlowstore, angleindexhighstore;
+    MYFLT   elevindexhighper, angleindex2per, angleindex4per;
+    MYFLT   w[4], del = FL(0.0), g;
+    int32_t elevindexlow, elevindexhigh, angleindex1, angleindex3;
+    int32_t idx[4], swap[4], i, n;
+    IGN(csound);
+
+    /* continue from the hrtfs heard last */
+    if (p->l < p->fade) {
+      g = (MYFLT) p->l / p->fade;
+      for (i = 0; i < fftsize; i++) {
+        oldhrtfl[i] += g * (hrtfl[i] - oldhrtfl[i]);
+        oldhrtfr[i] += g * (hrtfr[i] - oldhrtfr[i]);
+      }
+    }
+    else {
+      memcpy(oldhrtfl, hrtfl, fftsize * sizeof(MYFLT));
+      memcpy(oldhrtfr, hrtfr, fftsize * sizeof(MYFLT));
+    }
+    /* no fade in on the first block */
+    p->l = (p->elevv < FL(-40.0) ? p->fade : 0);
+    p->anglev = angle;
+    p->elevv = elev;
+
+    elevindexstore = (elev - minelev) / elevincrement;
+    elevindexlow = (int32_t) elevindexstore;
+    elevindexhigh = (elevindexlow < 13 ? elevindexlow + 1 : elevindexlow);
+    elevindexhighper = elevindexstore - elevindexlow;
+
+    angleindexlowstore = angle / (FL(360.0) / elevationarray[elevindexlow]);
+    angleindexhighstore = angle / (FL(360.0) / elevationarray[elevindexhigh]);
+    angleindex1 = (int32_t) angleindexlowstore;
+    angleindex3 = (int32_t) angleindexhighstore;
+    angleindex2per = angleindexlowstore - angleindex1;
+    angleindex4per = angleindexhighstore - angleindex3;
+
+    idx[0] = hrtf_index(elevindexlow, angleindex1, &swap[0]);
+    idx[1] = hrtf_index(elevindexlow,
+                        (angleindex1 + 1) % elevationarray[elevindexlow],
+                        &swap[1]);
+    idx[2] = hrtf_index(elevindexhigh, angleindex3, &swap[2]);
+    idx[3] = hrtf_index(elevindexhigh,
+                        (angleindex3 + 1) % elevationarray[elevindexhigh],
+                        &swap[3]);
+    w[0] = (FL(1.0) - elevindexhighper) * (FL(1.0) - angleindex2per);
+    w[1] = (FL(1.0) - elevindexhighper) * angleindex2per;
+    w[2] = elevindexhighper * (FL(1.0) - angleindex4per);
+    w[3] = elevindexhighper * angleindex4per;
+
+    /* interpolate log magnitudes and phases */
+    memset(hrtfl, 0, fftsize * sizeof(MYFLT));
+    memset(hrtfr, 0, fftsize * sizeof(MYFLT));
+    for (n = 0; n < 4; n++) {
+      MYFLT *specl = db->spec + (2 * idx[n] + swap[n]) * fftsize;
+      MYFLT *specr = db->spec + (2 * idx[n] + 1 - swap[n]) * fftsize;
+      if (w[n] == FL(0.0))
+        continue;
+      for (i = 0; i < fftsize; i++) {
+        hrtfl[i] += w[n] * specl[i];
+        hrtfr[i] += w[n] * specr[i];
+      }
+      del += w[n] * (MYFLT) minphasedels[idx[n]];
+    }
+
+    /* interaural delay on the far ear */
+    del *= db->sr;
+    if (del > db->mdt)
+      del = db->mdt;
+    hrtf_polar(hrtfl, fftsize, angle > FL(180.0) ? FL(0.0) : del);
+    hrtf_polar(hrtfr, fftsize, angle > FL(180.0) ? del : FL(0.0));
+}
+
+/* out += in * (old + g * (new - old)) */
+static void hrtf_mac(MYFLT *out, const MYFLT *in, const MYFLT *hrtf,
+                     const MYFLT *old, MYFLT g, int32_t fftsize)
+{
+    int32_t i;
+    MYFLT   re, im;
+
+    if (old == NULL) {
+      out[0] += in[0] * hrtf[0];
+      out[1] += in[1] * hrtf[1];
+      for (i = 2; i < fftsize; i += 2) {
+        out[i] += in[i] * hrtf[i] - in[i + 1] * hrtf[i + 1];
+        out[i + 1] += in[i] * hrtf[i + 1] + in[i + 1] * hrtf[i];
+      }
+      return;
+    }
+    out[0] += in[0] * (old[0] + g * (hrtf[0] - old[0]));
+    out[1] += in[1] * (old[1] + g * (hrtf[1] - old[1]));
+    for (i = 2; i < fftsize; i += 2) {
+      re = old[i] + g * (hrtf[i] - old[i]);
+      im = old[i + 1] + g * (hrtf[i + 1] - old[i + 1]);
+      out[i] += in[i] * re - in[i + 1] * im;
+      out[i + 1] += in[i] * im + in[i + 1] * re;
+    }
+}
+
+/* add a complete input block to the bus */
+static void hrtfsrc_block(CSOUND *csound, hrtfsrc *p, int64_t block)
+{
+    HRTFBUS *bus = p->bus;
+    int32_t fftsize = bus->db->fftsize, hopsize = bus->db->hopsize;
+    int32_t slot = (int32_t) (block % bus->nslots);
+    MYFLT   *work = bus->work, *specl, *specr;
+    MYFLT   elev = *p->kelev, angle = *p->kangle;
+
+    if (elev > FL(90.0))
+      elev = FL(90.0);
+    if (elev < FL(-40.0))
+      elev = FL(-40.0);
+    while (angle < FL(0.0))
+      angle += FL(360.0);
+    while (angle >= FL(360.0))
+      angle -= FL(360.0);
+    /* only update if location changes! */
+    if (angle != p->anglev || elev != p->elevv)
+      hrtfsrc_position(csound, p, angle, elev);
+
+    memcpy(work, p->insig.auxp, hopsize * sizeof(MYFLT));
+    memset(&work[hopsize], 0, (fftsize - hopsize) * sizeof(MYFLT));
+    csound->RealFFT(csound, work, fftsize);
+
+    specl = bus->specl + slot * fftsize;
+    specr = bus->specr + slot * fftsize;
+    if (bus->block[slot] != block) {
+      memset(specl, 0, fftsize * sizeof(MYFLT));
+      memset(specr, 0, fftsize * sizeof(MYFLT));
+      bus->block[slot] = block;
+    }
+    if (p->l < p->fade) {
+      MYFLT g = (MYFLT) ++p->l / p->fade;
+      hrtf_mac(specl, work, (MYFLT*) p->hrtfl.auxp, (MYFLT*) p->oldhrtfl.auxp,
+               g, fftsize);
+      hrtf_mac(specr, work, (MYFLT*) p->hrtfr.auxp, (MYFLT*) p->oldhrtfr.auxp,
+               g, fftsize);
+    }
+    else {
+      hrtf_mac(specl, work, (MYFLT*) p->hrtfl.auxp, NULL, FL(1.0), fftsize);
+      hrtf_mac(specr, work, (MYFLT*) p->hrtfr.auxp, NULL, FL(1.0), fftsize);
+    }
+}
+
+static int32_t hrtfsrc_process(CSOUND *csound, hrtfsrc *p)
+{
+    MYFLT   *in = p->in;
+    MYFLT   *insig = (MYFLT *)p->insig.auxp;
+    int32_t hopsize = p->bus->db->hopsize;
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t j, nsmps = CS_KSMPS, end = nsmps - early;
+    /* samples are placed in blocks by orchestra time, so that all sources
+       on a bus complete their blocks together */
+    int64_t t = csound->icurTime - nsmps;
+
+    for (j = 0; j < nsmps; j++, t++) {
+      int32_t k = (int32_t) (t % hopsize);
+      insig[k] = (j >= offset && j < end ? in[j] : FL(0.0));
+      if (k == hopsize - 1)
+        hrtfsrc_block(csound, p, t / hopsize);
+    }
+    return OK;
+}
+
+typedef struct
+{
+        OPDS  h;
+        /* outputs and inputs */
+        MYFLT *outsigl, *outsigr;
+        STRINGDAT *ifilel, *ifiler;
+        MYFLT *ibus, *osr;
+
+        HRTFBUS *bus;
+        MYFLT scale;
+
+        /* overlap add buffers, and inverse fft */
+        AUXCH outl, outr, outspec;
+}
+hrtfout;
+
+static int32_t hrtfout_init(CSOUND *csound, hrtfout *p)
+{
+    int32_t fftsize;
+
+    if (UNLIKELY(hrtf_bus_init(csound, &p->h, p->ifilel, p->ifiler, *p->ibus,
+                               *p->osr, &p->bus) != OK))
+      return NOTOK;
+    fftsize = p->bus->db->fftsize;
+    /* scaled (by a little more than usual to ensure no clipping) sr
+       related, as in hrtfmove */
+    p->scale = FL(38000.0) / p->bus->db->sr;
+
+    csound->AuxAlloc(csound, fftsize * sizeof(MYFLT), &p->outl);
+    csound->AuxAlloc(csound, fftsize * sizeof(MYFLT), &p->outr);
+    csound->AuxAlloc(csound, fftsize * sizeof(MYFLT), &p->outspec);
+    return OK;
+}
+
+/* overlap add the output of a complete block */
+static void hrtfout_add(CSOUND *csound, hrtfout *p, MYFLT *out,
+                        MYFLT *spec, int32_t ok)
+{
+    int32_t i, fftsize = p->bus->db->fftsize, hopsize = p->bus->db->hopsize;
+    MYFLT   *outspec = (MYFLT *)p->outspec.auxp;
+
+    memmove(out, &out[hopsize], (fftsize - hopsize) * sizeof(MYFLT));
+    memset(&out[fftsize - hopsize], 0, hopsize * sizeof(MYFLT));
+    if (!ok)
+      return;
+    memcpy(outspec, spec, fftsize * sizeof(MYFLT));
+    csound->InverseRealFFT(csound, outspec, fftsize);
+    for (i = 0; i < fftsize; i++)
+      out[i] += outspec[i] * p->scale;
+}
+
+static int32_t hrtfout_process(CSOUND *csound, hrtfout *p)
+{
+    HRTFBUS *bus = p->bus;
+    MYFLT   *outsigl = p->outsigl, *outsigr = p->outsigr;
+    MYFLT   *outl = (MYFLT *)p->outl.auxp;
+    MYFLT   *outr = (MYFLT *)p->outr.auxp;
+    int32_t fftsize = bus->db->fftsize, hopsize = bus->db->hopsize;
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t j, nsmps = CS_KSMPS, end = nsmps - early;
+    int64_t t = csound->icurTime - nsmps;
+
+    for (j = 0; j < nsmps; j++, t++) {
+      int32_t k = (int32_t) (t % hopsize);
+      if (j >= offset && j < end) {
+        outsigl[j] = outl[k];
+        outsigr[j] = outr[k];
+      }
+      else
+        outsigl[j] = outsigr[j] = FL(0.0);
+      if (k == hopsize - 1) {
+        int64_t block = t / hopsize;
+        int32_t slot = (int32_t) (block % bus->nslots);
+        /* no source has written to the slot for this block */
+        int32_t ok = (bus->block[slot] == block);
+        hrtfout_add(csound, p, outl, bus->specl + slot * fftsize, ok);
+        hrtfout_add(csound, p, outr, bus->specr + slot * fftsize, ok);
+      }
+    }
+    return OK;
+}
+
 /* see csound manual (extending csound) for details of below */
 static OENTRY hrtfopcodes_localops[] =
 {
@@ -2669,7 +3231,11 @@ static OENTRY hrtfopcodes_localops[] =
  { "hrtfstat", sizeof(hrtfstat),0, 3, "aa", "aiiSSoo",
     (SUBR)hrtfstat_init, (SUBR)hrtfstat_process },
  { "hrtfmove2",  sizeof(hrtfmove2),0, 3, "aa", "akkSSooo",
-    (SUBR)hrtfmove2_init, (SUBR)hrtfmove2_process }
+    (SUBR)hrtfmove2_init, (SUBR)hrtfmove2_process },
+ { "hrtfsrc",  sizeof(hrtfsrc), _CB, 3, "", "akkSSooo",
+    (SUBR)hrtfsrc_init, (SUBR)hrtfsrc_process },
+ { "hrtfout",  sizeof(hrtfout), _CR, 3, "aa", "SSoo",
+    (SUBR)hrtfout_init, (SUBR)hrtfout_process }
 };
 
 LINKAGE_BUILTIN(hrtfopcodes_localops)
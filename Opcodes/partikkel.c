@@ -40,55 +40,46 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
     if (index > (uint32_t)(to) || index < (uint32_t)(from)) \
         index = (uint32_t)(from);
 
-/* here follows routines for maintaining a linked list of grains */
+/* grains rendered per thread before the worker threads are used at all */
+#define PARTIKKEL_MIN_GRAINS 32
+#define PARTIKKEL_MAX_THREADS 64
 
-/* initialises a linked list of NODEs */
-static void init_pool(GRAINPOOL *s, uint32_t max_grains)
-{
-    uint32_t i;
-    NODE **p = &s->grainlist;
-    NODE *grainpool = (NODE *)s->mempool;
-
-    s->free_nodes = max_grains;
-    /* build list of grains in pool */
-    for (i = 0; i < max_grains; ++i) {
-        NODE *node;
-        *p = grainpool + i;
-        node = *p;
-        node->next = NULL;
-        p = &(node->next);
-    }
-}
+/* here follows routines for maintaining the grain store */
 
-/* returns pointer to new node */
-static NODE *get_grain(GRAINPOOL *s)
+/* lays out the grain store in a block of memory for max_grains grains */
+static void init_store(GRAINSTORE *s, char *mem, uint32_t max_grains)
 {
-    NODE *ret = s->grainlist;
-
-    if (s->grainlist)
-        s->grainlist = s->grainlist->next;
-    s->free_nodes--;
-    return ret;
+    s->grain = (GRAIN *)mem;
+    s->start = (uint32_t *)(s->grain + max_grains);
+    s->stop = s->start + max_grains;
+    s->birth = s->stop + max_grains;
+    s->active = 0;
+    s->max = max_grains;
+    s->serial = 0;
 }
 
-/* returns a NODE to the pool. function returns pointer to next node */
-static NODE *return_grain(GRAINPOOL *s, NODE *c)
+/* removes the grain in slot i by moving the last active grain into it */
+static void remove_grain(GRAINSTORE *s, uint32_t i)
 {
-    NODE *oldnext = c->next;
+    uint32_t last = --s->active;
 
-    c->next = s->grainlist;
-    s->grainlist = c;
-    s->free_nodes++;
-    return oldnext;
+    if (i != last) {
+        s->grain[i] = s->grain[last];
+        s->start[i] = s->start[last];
+        s->stop[i] = s->stop[last];
+        s->birth[i] = s->birth[last];
+    }
 }
 
-/* return oldest grain to the pool, we use this when we're out of grains */
-static void kill_oldest_grain(GRAINPOOL *s, NODE *n)
+/* remove oldest grain from the store, we use this when we're out of grains */
+static void kill_oldest_grain(GRAINSTORE *s)
 {
-    while (n->next->next)
-        n = n->next;
-    return_grain(s, n->next);
-    n->next = NULL;
+    uint32_t i, oldest = 0;
+
+    for (i = 1; i < s->active; ++i)
+        if (s->serial - s->birth[i] > s->serial - s->birth[oldest])
+            oldest = i;
+    remove_grain(s, oldest);
 }
 
 static int32_t setup_globals(CSOUND *csound, PARTIKKEL *p)
@@ -217,15 +208,103 @@ static inline MYFLT dsf(FUNC *tab, GRAIN *grain, double beta, MYFLT zscale,
     return result;
 }
 
+static uintptr_t render_thread(void *data);
+static int32_t partikkel_deinit(CSOUND *csound, void *pp);
+
+/* sets up renderers for nthreads threads, renderer 0 mixing directly into
+ * the opcode outputs and the others into buffers of their own */
+static int32_t setup_renderers(CSOUND *csound, PARTIKKEL *p, uint32_t nthreads)
+{
+    const uint32_t ksmps = CS_KSMPS;
+    /* mix, fm and interpolation buffers, plus outputs of the workers */
+    const size_t nbuf = (3*nthreads + (nthreads - 1)*p->num_outputs)*ksmps;
+    size_t size;
+    MYFLT *buf;
+    uint32_t *index;
+    uint32_t i, j;
+
+    /* stop the workers of a previous initialisation pass */
+    partikkel_deinit(csound, p);
+    size = nthreads*sizeof(PARTIKKEL_RENDER) + nbuf*sizeof(MYFLT)
+         + nthreads*ksmps*sizeof(uint32_t);
+    if (p->aux.auxp == NULL || p->aux.size < size)
+        csound->AuxAlloc(csound, size, &p->aux);
+    else
+        memset(p->aux.auxp, 0, size);
+    p->render = (PARTIKKEL_RENDER *)p->aux.auxp;
+    buf = (MYFLT *)(p->render + nthreads);
+    index = (uint32_t *)(buf + nbuf);
+    for (i = 0; i < nthreads; ++i) {
+        PARTIKKEL_RENDER *r = &p->render[i];
+
+        r->p = p;
+        r->mix = buf; buf += ksmps;
+        r->fmod = buf; buf += ksmps;
+        r->frac = buf; buf += ksmps;
+        r->index = index; index += ksmps;
+        for (j = 0; j < p->num_outputs; ++j) {
+            if (i == 0) {
+                r->out[j] = *(&p->output1 + j);
+            } else {
+                r->out[j] = buf;
+                buf += ksmps;
+            }
+        }
+    }
+    p->num_threads = 1;
+    if (nthreads < 2)
+        return OK;
+
+    /* the workers wait on p->go until the barriers are made, so that
+     * these can be sized for the threads that could be started */
+    p->quit = 0;
+    if (UNLIKELY((p->go = csound->CreateThreadLock()) == NULL)) {
+        WARNING("could not create worker threads, rendering in one thread");
+        return OK;
+    }
+    csound->WaitThreadLock(p->go, 0);
+    for (i = 1; i < nthreads; ++i) {
+        p->render[i].thread = csound->CreateThread(render_thread,
+                                                   &p->render[i]);
+        if (UNLIKELY(p->render[i].thread == NULL))
+            break;
+    }
+    if (i > 1) {
+        p->start_barrier = csound->CreateBarrier(i);
+        p->end_barrier = csound->CreateBarrier(i);
+    }
+    if (UNLIKELY(p->start_barrier == NULL || p->end_barrier == NULL)) {
+        /* let the workers started see p->quit, and stop */
+        p->quit = 1;
+        csound->NotifyThreadLock(p->go);
+        for (j = 1; j < i; ++j)
+            csound->JoinThread(p->render[j].thread);
+        if (p->start_barrier) csound->DestroyBarrier(p->start_barrier);
+        if (p->end_barrier) csound->DestroyBarrier(p->end_barrier);
+        p->start_barrier = p->end_barrier = NULL;
+        csound->DestroyThreadLock(p->go);
+        p->go = NULL;
+        WARNING("could not create worker threads, rendering in one thread");
+        return OK;
+    }
+    if (UNLIKELY(i < nthreads))
+        csound->Warning(csound, Str("partikkel: could only start %d of %d "
+                                    "rendering threads"),
+                        (int)i, (int)nthreads);
+    p->num_threads = i;
+    csound->NotifyThreadLock(p->go);
+    csound->RegisterDeinitCallback(csound, p, partikkel_deinit);
+    return OK;
+}
+
 static int32_t partikkel_init(CSOUND *csound, PARTIKKEL *p)
 {
-    uint32_t size;
+    uint32_t size, nthreads;
     int32_t ret;
 
     if ((ret = setup_globals(csound, p)) != OK)
         return ret;
 
-    p->grainroot = NULL;
     /* set grainphase to 1.0 to make grain scheduler create a grain immediately
      * after starting opcode */
     p->grainphase = 1.0;
@@ -303,22 +382,21 @@ static int32_t partikkel_init(CSOUND *csound, PARTIKKEL *p)
     p->synced = 0;
     p->graininc = 0.0;
 
-    /* allocate memory for the grain mix buffer */
-    size = CS_KSMPS*sizeof(MYFLT);
-    if (p->aux.auxp == NULL || p->aux.size < size)
-        csound->AuxAlloc(csound, size, &p->aux);
-    else
-      memset(p->aux.auxp, 0, size);
-
-    /* allocate memory for the grain pool and initialize it*/
+    /* allocate memory for the grain store and initialize it*/
     if (UNLIKELY(*p->max_grains < FL(1.0)))
         return INITERROR("maximum number of grains needs to be non-zero "
                          "and positive");
-    size = ((uint32_t)*p->max_grains)*sizeof(NODE);
+    size = ((uint32_t)*p->max_grains)*(sizeof(GRAIN) + 3*sizeof(uint32_t));
     if (p->aux2.auxp == NULL || p->aux2.size < size)
         csound->AuxAlloc(csound, size, &p->aux2);
-    p->gpool.mempool = p->aux2.auxp;
-    init_pool(&p->gpool, (uint32_t)*p->max_grains);
+    init_store(&p->gstore, p->aux2.auxp, (uint32_t)*p->max_grains);
+
+    /* allocate the grain mix buffers and start worker threads, if any */
+    nthreads = *p->threads > FL(1.0) ? (uint32_t)*p->threads : 1;
+    if (nthreads > PARTIKKEL_MAX_THREADS)
+        nthreads = PARTIKKEL_MAX_THREADS;
+    if ((ret = setup_renderers(csound, p, nthreads)) != OK)
+        return ret;
 
     /* find out which of the xrate parameters are arate */
     p->grainfreq_arate = IS_ASIG_ARG(p->grainfreq) ? 1 : 0;
@@ -329,13 +407,15 @@ static int32_t partikkel_init(CSOUND *csound, PARTIKKEL *p)
 
 /* n is sample number for which the grain is to be scheduled
  * offset is time offset for grain in seconds, passed separately for hints */
-static int32_t schedule_grain(CSOUND *csound, PARTIKKEL *p, NODE *node, int32 n,
-                          double offset)
+static int32_t schedule_grain(CSOUND *csound, PARTIKKEL *p, int32 n,
+                              double offset)
 {
-    /* make a new grain */
+    /* make a new grain in the first free slot of the store */
     MYFLT startfreqscale, endfreqscale;
     MYFLT maskgain, maskchannel;
-    GRAIN *grain = &node->grain;
+    GRAINSTORE *s = &p->gstore;
+    const uint32_t slot = s->active;
+    GRAIN *grain = &s->grain[slot];
     uint32_t i;
     uint32_t chan;
     MYFLT graingain;
@@ -384,7 +464,6 @@ static int32_t schedule_grain(CSOUND *csound, PARTIKKEL *p, NODE *node, int32 n,
     if ((fabs(graingain) < FL(1e-8)) || (frand() > 1.0 - *p->randommask)) {
         /* grain is either masked out or has a zero amplitude, so we cancel it
          * and proceed with scheduling our next grain */
-        return_grain(&p->gpool, node);
         return OK;
     }
 
@@ -396,7 +475,6 @@ static int32_t schedule_grain(CSOUND *csound, PARTIKKEL *p, NODE *node, int32 n,
     /* place a grain in between two channels according to channel mask value */
     chan = (uint32_t)maskchannel;
     if (UNLIKELY(chan >= p->num_outputs)) {
-        return_grain(&p->gpool, node);
         return PERFERROR("channel mask specifies non-existing output channel");
     }
     /* use panning law table if specified */
@@ -420,10 +498,8 @@ static int32_t schedule_grain(CSOUND *csound, PARTIKKEL *p, NODE *node, int32 n,
     /* duration in samples */
     const double dur_samples = CS_ESR*(*p->duration)/1000.0;
     /* if grainlength is below one sample, we'll just cancel it */
-    if (dur_samples < 1.0) {
-        return_grain(&p->gpool, node);
+    if (dur_samples < 1.0)
         return OK;
-    }
     /* the grain is supposed to start at grainphase = 0, so calculate how far
      * we overshot that and correct all relevant wave and envelope phases
      * for proper sub-sample grain placement. if offset != 0, our grains
@@ -434,8 +510,8 @@ static int32_t schedule_grain(CSOUND *csound, PARTIKKEL *p, NODE *node, int32 n,
                             ? p->grainphase/p->graininc
                             : 0.0;
     const double rcp_samples = 1.0/dur_samples;
-    grain->start = (uint32_t)((double)n + offset*CS_ESR + phase_corr);
-    grain->stop = (uint32_t)(grain->start + dur_samples - phase_corr) + 1;
+    s->start[slot] = (uint32_t)((double)n + offset*CS_ESR + phase_corr);
+    s->stop[slot] = (uint32_t)(s->start[slot] + dur_samples - phase_corr) + 1;
     /* set up the four wavetables and dsf to use in the grain */
     for (i = 0; i < 5; ++i) {
         WAVEDATA *curwav = &grain->wav[i];
@@ -538,9 +614,9 @@ static int32_t schedule_grain(CSOUND *csound, PARTIKKEL *p, NODE *node, int32 n,
 
     grain->envinc = rcp_samples;
     grain->envphase = phase_corr*grain->envinc;
-    /* link new grain into the list */
-    node->next = p->grainroot;
-    p->grainroot = node;
+    /* make the new grain active */
+    s->birth[slot] = s->serial++;
+    s->active++;
     return OK;
 }
 
@@ -550,7 +626,6 @@ static int32_t schedule_grains(CSOUND *csound, PARTIKKEL *p)
     uint32_t koffset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
-    NODE *node;
     MYFLT **waveformparams = &p->waveform1;
     MYFLT grainfreq = fabs(*p->grainfreq);
 
@@ -623,20 +698,17 @@ static int32_t schedule_grains(CSOUND *csound, PARTIKKEL *p)
                 offset /= grainfreq;
                 if (offset > 10.0) offset = 10.0;
             }
-            /* check if there are any grains left in the pool */
-            if (!p->gpool.free_nodes) {
+            /* check if there are any grains left in the store */
+            if (p->gstore.active == p->gstore.max) {
                 if (!p->out_of_voices_warning) {
                     WARNING("maximum number of grains reached");
                     p->out_of_voices_warning = 1; /* we only warn once */
                 }
-                kill_oldest_grain(&p->gpool, p->grainroot);
+                kill_oldest_grain(&p->gstore);
             }
             /* add a new grain */
-            node = get_grain(&p->gpool);
-            /* check first, in case we'll change the above behaviour of
-             * killing a grain */
-            if (node) {
-                int32_t ret = schedule_grain(csound, p, node, n, offset);
+            {
+                int32_t ret = schedule_grain(csound, p, n, offset);
 
                 if (ret != OK)
                     return ret;
@@ -659,19 +731,41 @@ static int32_t schedule_grains(CSOUND *csound, PARTIKKEL *p)
 }
 
 /* Main synthesis loops */
-/* NOTE: the main synthesis loop is duplicated for both wavetable and
- * trainlet synthesis for speed */
-static inline void render_wave(PARTIKKEL *p, GRAIN *grain, WAVEDATA *wav,
-                               MYFLT *buf, uint32_t stop)
+/* each grain is rendered in stages: the phase accumulators are inherently
+ * sequential, so they are run first and store table positions, which the
+ * following loops turn into independent (gathered) table reads and
+ * multiply-adds over the whole grain segment */
+
+/* fm amount per sample, shared by all waveforms of the grain */
+static inline void render_fm(PARTIKKEL *p, GRAIN *grain, MYFLT *fmod,
+                             uint32_t start, uint32_t stop)
 {
     uint32_t n;
     double fmenvphase = grain->envphase;
+    const FUNC *fmenvtab = grain->fmenvtab;
+
+    for (n = start; n < stop; ++n) {
+        MYFLT fmenv = fmenvtab->ftable[(size_t)(fmenvphase*FMAXLEN)
+                                       >> fmenvtab->lobits];
+        fmenvphase += grain->envinc;
+        fmod[n] = p->fm[n]*grain->fmamp*fmenv;
+    }
+}
 
-    /* wavetable synthesis */
-    for (n = grain->start; n < stop; ++n) {
-        double tablen = (double)wav->table->flen;
+static inline void render_wave(PARTIKKEL_RENDER *r, WAVEDATA *wav,
+                               uint32_t start, uint32_t stop)
+{
+    uint32_t n;
+    const double tablen = (double)wav->table->flen;
+    const MYFLT *ftable = wav->table->ftable;
+    const MYFLT gain = wav->gain;
+    const MYFLT *fmod = r->fmod;
+    MYFLT *frac = r->frac, *mix = r->mix;
+    uint32_t *index = r->index;
+
+    /* phase accumulation, with frequency sweep and fm */
+    for (n = start; n < stop; ++n) {
         uint32_t x0;
-        MYFLT frac, fmenv;
 
         /* make sure phase accumulator stays within bounds */
         while (UNLIKELY(wav->phase >= tablen))
@@ -679,62 +773,64 @@ static inline void render_wave(PARTIKKEL *p, GRAIN *grain, WAVEDATA *wav,
         while (UNLIKELY(wav->phase < 0.0))
             wav->phase += tablen;
 
-        /* sample table lookup with linear interpolation */
         x0 = (uint32_t)wav->phase;
-        frac = (MYFLT)(wav->phase - x0);
-        buf[n] += lrp(wav->table->ftable[x0], wav->table->ftable[x0 + 1],
-                      frac)*wav->gain;
-
-        fmenv = grain->fmenvtab->ftable[(size_t)(fmenvphase*FMAXLEN)
-                                        >> grain->fmenvtab->lobits];
-        fmenvphase += grain->envinc;
-        wav->phase += wav->delta + wav->delta*p->fm[n]*grain->fmamp*fmenv;
+        index[n] = x0;
+        frac[n] = (MYFLT)(wav->phase - x0);
+        wav->phase += wav->delta + wav->delta*fmod[n];
         /* apply sweep */
         wav->delta = wav->delta*wav->sweepdecay + wav->sweepoffset;
-     }
+    }
+    /* sample table lookup with linear interpolation */
+    for (n = start; n < stop; ++n) {
+        const MYFLT a = ftable[index[n]];
+
+        mix[n] += lrp(a, ftable[index[n] + 1], frac[n])*gain;
+    }
 }
 
-static inline void render_trainlet(PARTIKKEL *p, GRAIN *grain, WAVEDATA *wav,
-                                   MYFLT *buf, uint32_t stop)
+static inline void render_trainlet(PARTIKKEL *p, PARTIKKEL_RENDER *r,
+                                   GRAIN *grain, WAVEDATA *wav,
+                                   uint32_t start, uint32_t stop)
 {
     uint32_t n;
-    double fmenvphase = grain->envphase;
+    const MYFLT *fmod = r->fmod;
+    MYFLT *mix = r->mix;
 
     /* trainlet synthesis */
-    for (n = grain->start; n < stop; ++n) {
-        MYFLT fmenv;
-
+    for (n = start; n < stop; ++n) {
         while (UNLIKELY(wav->phase >= 1.0))
             wav->phase -= 1.0;
         while (UNLIKELY(wav->phase < 0.0))
             wav->phase += 1.0;
 
         /* dsf/trainlet synthesis */
-        buf[n] += wav->gain*dsf(p->costab, grain, wav->phase, p->zscale,
+        mix[n] += wav->gain*dsf(p->costab, grain, wav->phase, p->zscale,
                                 p->cosineshift);
 
-        fmenv = grain->fmenvtab->ftable[(size_t)(fmenvphase*FMAXLEN)
-                                        >> grain->fmenvtab->lobits];
-        fmenvphase += grain->envinc;
-        wav->phase += wav->delta + wav->delta*p->fm[n]*grain->fmamp*fmenv;
+        wav->phase += wav->delta + wav->delta*fmod[n];
         wav->delta = wav->delta*wav->sweepdecay + wav->sweepoffset;
     }
 }
 
 /* do the actual waveform synthesis */
-static inline void render_grain(CSOUND *csound, PARTIKKEL *p, GRAIN *grain)
+static inline void render_grain(PARTIKKEL *p, PARTIKKEL_RENDER *r,
+                                uint32_t slot)
 {
-    IGN(csound);
+    GRAINSTORE *s = &p->gstore;
+    GRAIN *grain = &s->grain[slot];
     int32_t i;
     uint32_t n;
-    MYFLT *out1 = *(&(p->output1) + grain->chan1);
-    MYFLT *out2 = *(&(p->output1) + grain->chan2);
-    uint32_t stop = grain->stop > CS_KSMPS
-                    ? CS_KSMPS : grain->stop;
-    MYFLT *buf = (MYFLT *)p->aux.auxp;
-
-    if (grain->start >= CS_KSMPS)
+    const uint32_t start = s->start[slot];
+    const uint32_t stop = s->stop[slot] > CS_KSMPS
+                          ? CS_KSMPS : s->stop[slot];
+    MYFLT *out1 = r->out[grain->chan1];
+    MYFLT *out2 = r->out[grain->chan2];
+    const MYFLT gain1 = grain->gain1, gain2 = grain->gain2;
+    MYFLT *mix = r->mix;
+
+    if (start >= CS_KSMPS)
         return; /* grain starts at a later kperiod */
+    render_fm(p, grain, r->fmod, start, stop);
     for (i = 0; i < 5; ++i) {
         WAVEDATA *curwav = &grain->wav[i];
 
@@ -743,14 +839,14 @@ static inline void render_grain(CSOUND *csound, PARTIKKEL *p, GRAIN *grain)
             continue;
 
         if (i != WAV_TRAINLET)
-            render_wave(p, grain, curwav, buf, stop);
+            render_wave(r, curwav, start, stop);
         else
-            render_trainlet(p, grain, curwav, buf, stop);
+            render_trainlet(p, r, grain, curwav, start, stop);
     }
 
     /* apply envelopes */
-    for (n = grain->start; n < stop; ++n) {
-        MYFLT env, env2, output;
+    for (n = start; n < stop; ++n) {
+        MYFLT env, env2;
         double envphase;
         FUNC *envtable;
 
@@ -781,21 +877,80 @@ static inline void render_grain(CSOUND *csound, PARTIKKEL *p, GRAIN *grain)
         env2 = FL(1.0) - grain->env2amount + grain->env2amount*env2;
         grain->envphase += grain->envinc;
         /* generate grain output sample */
-        output = buf[n]*env*env2;
-        /* now distribute this grain to the output channels it's supposed to
-         * end up in, as decided by the channel mask */
-        out1[n] += output*grain->gain1;
-        out2[n] += output*grain->gain2;
+        mix[n] *= env*env2;
     }
+    /* now distribute this grain to the output channels it's supposed to
+     * end up in, as decided by the channel mask */
+    for (n = start; n < stop; ++n)
+        out1[n] += mix[n]*gain1;
+    for (n = start; n < stop; ++n)
+        out2[n] += mix[n]*gain2;
     /* now clear the area we just worked in */
-    memset(buf + grain->start, 0, (stop - grain->start)*sizeof(MYFLT));
+    memset(mix + start, 0, (stop - start)*sizeof(MYFLT));
+}
+
+static void render_grains(PARTIKKEL *p, PARTIKKEL_RENDER *r)
+{
+    uint32_t i;
+
+    if (r != p->render) {
+        /* workers accumulate into their own buffers */
+        for (i = 0; i < p->num_outputs; ++i)
+            memset(r->out[i], 0, CS_KSMPS*sizeof(MYFLT));
+    }
+    for (i = r->first; i < r->last; ++i)
+        render_grain(p, r, i);
+}
+
+/* worker thread, renders its share of the grains each k-period */
+static uintptr_t render_thread(void *data)
+{
+    PARTIKKEL_RENDER *r = (PARTIKKEL_RENDER *)data;
+    PARTIKKEL *p = r->p;
+    CSOUND *csound = p->h.insdshead->csound;
+
+    /* passed on to the next worker waiting */
+    csound->WaitThreadLockNoTimeout(p->go);
+    csound->NotifyThreadLock(p->go);
+    if (p->quit)
+        return 0;
+    for (;;) {
+        csound->WaitBarrier(p->start_barrier);
+        if (p->quit)
+            break;
+        render_grains(p, r);
+        csound->WaitBarrier(p->end_barrier);
+    }
+    return 0;
+}
+
+static int32_t partikkel_deinit(CSOUND *csound, void *pp)
+{
+    PARTIKKEL *p = (PARTIKKEL *)pp;
+    uint32_t i;
+
+    if (p->start_barrier == NULL)
+        return OK;
+    p->quit = 1;
+    csound->WaitBarrier(p->start_barrier);
+    for (i = 1; i < p->num_threads; ++i)
+        if (p->render[i].thread != NULL)
+            csound->JoinThread(p->render[i].thread);
+    csound->DestroyBarrier(p->start_barrier);
+    csound->DestroyBarrier(p->end_barrier);
+    csound->DestroyThreadLock(p->go);
+    p->start_barrier = p->end_barrier = NULL;
+    p->go = NULL;
+    p->num_threads = 1;
+    return OK;
 }
 
 static int32_t partikkel(CSOUND *csound, PARTIKKEL *p)
 {
     int32_t ret;
-    uint32_t n;
-    NODE **nodeptr;
+    uint32_t i, n;
+    GRAINSTORE *s = &p->gstore;
+    const uint32_t ksmps = CS_KSMPS;
     MYFLT **outputs = &p->output1;
 
     if (UNLIKELY(p->aux.auxp == NULL || p->aux2.auxp == NULL))
@@ -806,28 +961,46 @@ static int32_t partikkel(CSOUND *csound, PARTIKKEL *p)
 
     /* clear output buffers, we'll be accumulating our outputs */
     for (n = 0; n < p->num_outputs; ++n)
-        memset(outputs[n], 0, sizeof(MYFLT)*CS_KSMPS);
-
-    /* prepare to traverse grain list */
-    nodeptr = &p->grainroot;
-    while (*nodeptr) {
-        GRAIN *grain = &((*nodeptr)->grain);
-
-        /* render current grain to outputs */
-        render_grain(csound, p, grain);
-        /* check if grain is finished */
-        if (grain->stop <= CS_KSMPS) {
-            /* grain is finished, deactivate it */
-            *nodeptr = return_grain(&p->gpool, *nodeptr);
-        } else {
-            /* extend grain lifetime with one k-period and find next grain */
-            if (CS_KSMPS > grain->start)
-                grain->start = 0; /* grain is active */
-            else
-                grain->start -= CS_KSMPS; /* grain is not yet active */
-            grain->stop -= CS_KSMPS;
-            nodeptr = &((*nodeptr)->next);
+        memset(outputs[n], 0, sizeof(MYFLT)*ksmps);
+
+    /* render grains to outputs, split across the worker threads if there
+     * are enough of them */
+    if (p->num_threads > 1 &&
+        s->active >= PARTIKKEL_MIN_GRAINS*p->num_threads) {
+        const uint32_t share = (s->active + p->num_threads - 1)/p->num_threads;
+
+        for (i = 0; i < p->num_threads; ++i) {
+            p->render[i].first = i*share < s->active ? i*share : s->active;
+            p->render[i].last = (i + 1)*share < s->active
+                                ? (i + 1)*share : s->active;
         }
+        csound->WaitBarrier(p->start_barrier);
+        render_grains(p, &p->render[0]);
+        csound->WaitBarrier(p->end_barrier);
+        for (i = 1; i < p->num_threads; ++i)
+            for (n = 0; n < p->num_outputs; ++n) {
+                MYFLT *out = outputs[n], *part = p->render[i].out[n];
+                uint32_t k;
+
+                for (k = 0; k < ksmps; ++k)
+                    out[k] += part[k];
+            }
+    } else {
+        p->render[0].first = 0;
+        p->render[0].last = s->active;
+        render_grains(p, &p->render[0]);
+    }
+
+    /* deactivate finished grains */
+    for (i = 0; i < s->active; )
+        if (s->stop[i] <= ksmps)
+            remove_grain(s, i);
+        else
+            ++i;
+    /* extend grain lifetime with one k-period */
+    for (i = 0; i < s->active; ++i) {
+        s->start[i] = s->start[i] > ksmps ? s->start[i] - ksmps : 0;
+        s->stop[i] -= ksmps;
     }
     return OK;
 }
@@ -964,7 +1137,7 @@ static OENTRY partikkel_localops[] = {
     {
      "partikkel", sizeof(PARTIKKEL), TR, 3,
         "ammmmmmm",
-        "xkiakiiikkkkikkiiaikikkkikkkkkiaaaakkkkioj",
+        "xkiakiiikkkkikkiiaikikkkikkkkkiaaaakkkkiojo",
         (SUBR)partikkel_init,
         (SUBR)partikkel
     },
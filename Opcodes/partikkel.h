@@ -29,7 +29,6 @@ typedef struct {
 } WAVEDATA;
 
 typedef struct {
-    uint32_t start, stop;
     double envphase, envinc;
     double envattacklen, envdecaystart;
     double env2amount;
@@ -45,20 +44,29 @@ typedef struct {
 /* which of the wav[] entries above correspond to the trainlet generator */
 #define WAV_TRAINLET 4
 
-/* support structs for the grain pool routines */
-typedef struct NODE {
-    GRAIN grain;
-    struct NODE *next;
-} NODE;
-
+/* grain store: the active grains occupy slots 0..active-1, finished grains
+ * are replaced by the last one. the fields touched for every grain on every
+ * k-period are kept in separate arrays */
 typedef struct {
-    NODE *grainlist;
-    char *mempool;
-    uint32_t free_nodes;
-} GRAINPOOL;
+    GRAIN *grain;
+    uint32_t *start, *stop;   /* sample offsets relative to this k-period */
+    uint32_t *birth;          /* scheduling order, to find the oldest grain */
+    uint32_t active, max;
+    uint32_t serial;
+} GRAINSTORE;
 
 struct PARTIKKEL;
 
+/* scratch buffers and output accumulators of one rendering thread */
+typedef struct {
+    struct PARTIKKEL *p;
+    void *thread;
+    uint32_t first, last;     /* range of grain slots to render */
+    MYFLT *mix, *fmod, *frac;
+    uint32_t *index;
+    MYFLT *out[8];
+} PARTIKKEL_RENDER;
+
 typedef struct PARTIKKEL_GLOBALS_ENTRY {
     MYFLT id;
     MYFLT *synctab;
@@ -117,12 +125,18 @@ typedef struct PARTIKKEL {
     MYFLT *max_grains;
     MYFLT *opcodeid;
     MYFLT *pantable;
+    MYFLT *threads;
 
     /* internal variables */
     PARTIKKEL_GLOBALS *globals;
     PARTIKKEL_GLOBALS_ENTRY *globals_entry;
-    GRAINPOOL gpool;
-    NODE *grainroot;
+    GRAINSTORE gstore;
+    /* renderer 0 runs in the performance thread, the others in workers */
+    PARTIKKEL_RENDER *render;
+    uint32_t num_threads;
+    void *start_barrier, *end_barrier;
+    void *go;                   /* held until the workers may start */
+    volatile int32_t quit;
     int32_t out_of_voices_warning;
     uint32_t num_outputs;
     int32_t grainfreq_arate;
@@ -615,9 +615,9 @@ int32_t scratchwrite(CSOUND *csound, SCRATCHPAD *p)
 
 int32_t adsyntset(CSOUND *csound, ADSYNT *p)
 {
-    FUNC    *ftp;
-    uint32_t     count;
-    int32   *lphs;
+    FUNC    *ftp, *oldftp = p->ftp;
+    uint32_t     count, oldcount = p->count, c;
+    MYFLT   phs;
 
     p->inerr = 0;
 
@@ -660,20 +660,24 @@ int32_t adsyntset(CSOUND *csound, ADSYNT *p)
                     "adsynt: partial count is greater than amptable size!"));
     }
 
-    if (p->lphs.auxp==NULL || p->lphs.size < (size_t)sizeof(int32)*count)
-      csound->AuxAlloc(csound, sizeof(int32)*count, &p->lphs);
-
-    lphs = (int32*)p->lphs.auxp;
-    if (*p->iphs > 1) {
-      do {
-        *lphs++ = ((int32) ((MYFLT) ((double) rand_31(csound) / 2147483645.0)
-                           * FMAXLEN)) & PHMASK;
-      } while (--count);
+    /* a negative iphs keeps the phases of the previous note */
+    if (*p->iphs < 0 && p->bank.auxp != NULL &&
+        count == oldcount && p->ftp == oldftp)
+      return OK;
+    if (UNLIKELY(csound->OscBankCreate(csound, &p->bank, count, CS_KSMPS,
+                                       p->ftp) == NULL)) {
+      p->inerr = 1;
+      return csound->InitError(csound, Str("adsynt: not initialised"));
     }
-    else if (*p->iphs >= 0) {
-      do {
-        *lphs++ = ((int32) (*p->iphs * FMAXLEN)) & PHMASK;
-      } while (--count);
+    for (c = 0; c < count; c++) {
+      if (*p->iphs > 1)
+        phs = (MYFLT) ((double) rand_31(csound) / 2147483645.0);
+      else if (*p->iphs >= 0)
+        phs = *p->iphs;
+      else
+        phs = FL(0.0);
+      csound->OscBankSet(csound, p->bank.auxp, c, FL(0.0), FL(0.0),
+                         phs * TWOPI_F, CS_OSCBANK_START);
     }
 
     return OK;
@@ -681,49 +685,40 @@ int32_t adsyntset(CSOUND *csound, ADSYNT *p)
 
 int32_t adsynt(CSOUND *csound, ADSYNT *p)
 {
-    FUNC    *ftp, *freqtp, *amptp;
-    MYFLT   *ar, *ftbl, *freqtbl, *amptbl;
-    MYFLT    amp0, amp, cps0, cps;
-    int32    phs, inc, lobits;
-    int32   *lphs;
+    MYFLT   *ar, *freqtbl, *amptbl;
+    MYFLT    amp0, cps0;
+    void    *bank;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
+    uint32_t nsmps = CS_KSMPS;
     int32_t      c, count;
 
     if (UNLIKELY(p->inerr)) {
       return csound->PerfError(csound, &(p->h),
                                Str("adsynt: not initialised"));
     }
-    ftp = p->ftp;
-    ftbl = ftp->ftable;
-    lobits = ftp->lobits;
-    freqtp = p->freqtp;
-    freqtbl = freqtp->ftable;
-    amptp = p->amptp;
-    amptbl = amptp->ftable;
-    lphs = (int32*)p->lphs.auxp;
+    freqtbl = p->freqtp->ftable;
+    amptbl = p->amptp->ftable;
+    bank = p->bank.auxp;
 
     cps0 = *p->kcps;
     amp0 = *p->kamp;
     count = p->count;
 
     ar = p->sr;
-    memset(ar, 0, nsmps*sizeof(MYFLT));
-    if (UNLIKELY(early)) nsmps -= early;
-
-    for (c=0; c<count; c++) {
-      amp = amptbl[c] * amp0;
-      cps = freqtbl[c] * cps0;
-      inc = (int32) (cps * csound->sicvt);
-      phs = lphs[c];
-      for (n=offset; n<nsmps; n++) {
-        ar[n] += *(ftbl + (phs >> lobits)) * amp;
-        phs += inc;
-        phs &= PHMASK;
-      }
-      lphs[c] = phs;
+    if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
+    if (UNLIKELY(offset >= nsmps))
+      return OK;
+
+    /* amplitudes and frequencies are interpolated across the cycle */
+    for (c=0; c<count; c++)
+      csound->OscBankSet(csound, bank, c, amptbl[c] * amp0,
+                         freqtbl[c] * cps0, FL(0.0), CS_OSCBANK_GLIDE);
+    csound->OscBankRun(csound, bank, ar + offset, nsmps - offset, count);
     return OK;
 }
 
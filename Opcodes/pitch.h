@@ -98,7 +98,7 @@ typedef struct {
     FUNC    *amptp;
     uint32_t     count;
     int32_t     inerr;
-    AUXCH   lphs;
+    AUXCH   bank;           /* oscillator bank */
 } ADSYNT;
 
 typedef struct {
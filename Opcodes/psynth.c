@@ -73,7 +73,7 @@ typedef struct _psyn {
     MYFLT   *scal, *pitch, *maxtracks, *ftb, *thresh;
     int32_t     tracks, pos, numbins, hopsize;
     FUNC    *func;
-    AUXCH   sum, amps, freqs, phases, trackID;
+    AUXCH   sum, freqs, trackID, keep, bank;
     double   factor, facsqr, min;
 } _PSYN;
 
@@ -84,7 +84,7 @@ typedef struct _psyn2 {
     MYFLT   *scal, *maxtracks, *ftb, *thresh;
     int32_t     tracks, pos, numbins, hopsize;
     FUNC    *func;
-    AUXCH   sum, amps, freqs, phases, trackID;
+    AUXCH   sum, freqs, trackID, keep, bank;
     double   factor, facsqr, min;
 } _PSYN2;
 
@@ -110,21 +110,11 @@ static int32_t psynth_init(CSOUND *csound, _PSYN *p)
     if(*p->thresh == -1) p->min = 0.00002*csound->Get0dBFS(csound);
     else p->min = *p->thresh*csound->Get0dBFS(csound);
 
-    if (p->amps.auxp == NULL ||
-        (uint32_t) p->amps.size < sizeof(double) * numbins)
-      csound->AuxAlloc(csound, sizeof(double) * numbins, &p->amps);
-    else
-      memset(p->amps.auxp, 0, sizeof(double) * numbins );
     if (p->freqs.auxp == NULL ||
         (uint32_t) p->freqs.size < sizeof(double) * numbins)
       csound->AuxAlloc(csound, sizeof(double) * numbins, &p->freqs);
     else
       memset(p->freqs.auxp, 0, sizeof(double) * numbins );
-    if (p->phases.auxp == NULL ||
-        (uint32_t) p->phases.size < sizeof(double) * numbins)
-      csound->AuxAlloc(csound, sizeof(double) * numbins, &p->phases);
-    else
-      memset(p->phases.auxp, 0, sizeof(double) * numbins );
     if (p->sum.auxp == NULL ||
         (uint32_t) p->sum.size < sizeof(double) * p->hopsize)
       csound->AuxAlloc(csound, sizeof(double) * p->hopsize, &p->sum);
@@ -135,34 +125,91 @@ static int32_t psynth_init(CSOUND *csound, _PSYN *p)
       csound->AuxAlloc(csound, sizeof(int32_t) * numbins, &p->trackID);
     else
       memset(p->trackID.auxp, 0, sizeof(int32_t) * numbins );
+    if (p->keep.auxp == NULL ||
+        (uint32_t) p->keep.size < sizeof(int32_t) * numbins)
+      csound->AuxAlloc(csound, sizeof(int32_t) * numbins, &p->keep);
+    /* old tracks, then new ones */
+    csound->OscBankCreate(csound, &p->bank, 2 * numbins, p->hopsize, p->func);
 
     return OK;
 }
 
+/* Synthesis of one hop of the tracks in fin into outsum, on an oscillator
+   bank.  The oscillators of the tracks of the previous hop are the first
+   ones, in the same order: continuing tracks carry on with theirs, and
+   dead tracks fade out.  New tracks start on free oscillators after them,
+   fading in from phase - 2 pi freq hop / sr if useph is set (0 otherwise)
+   so as to reach their phase at the end of the hop.  The oscillators of
+   the tracks that go on are then moved down, in the order of the tracks.
+   Frequencies are in Hz; mode sets how continuing tracks are interpolated.
+   returns: the number of tracks */
+
+static int32_t psynth_hop(CSOUND *csound, float *fin, int32_t tracks,
+                          int32_t maxtracks, MYFLT scale, MYFLT pitch,
+                          int32_t mode, int32_t useph, double factor,
+                          double min, double *freqs, int32_t *trackID,
+                          int32_t *keep, void *bank, MYFLT *outsum,
+                          int32_t hopsize)
+{
+    double  amp, freq, phase;
+    int32_t i = 0, j, k = 0, id;
+    int32_t notcontin = 0, next = tracks;
+
+    while (i < maxtracks * 4 && (id = (int32_t) fin[i + 3]) != -1) {
+      amp = (double) fin[i] * scale;
+      freq = (double) fin[i + 1] * pitch;
+      phase = (double) fin[i + 2];
+      if (amp <= min)
+        amp = 0.0;
+      j = k + notcontin;
+      if (j < tracks) {
+        if (trackID[j] != id) {
+          /* if this is a dead track */
+          csound->OscBankSet(csound, bank, j, FL(0.0), (MYFLT) freqs[j],
+                             FL(0.0), CS_OSCBANK_GLIDE);
+          notcontin++;
+          continue;
+        }
+        /* if this is a continuing track */
+        csound->OscBankSet(csound, bank, j, amp, freq, phase, mode);
+      }
+      else {
+        /* new track */
+        j = next++;
+        csound->OscBankSet(csound, bank, j, FL(0.0), freq,
+                           useph ? phase - TWOPI * freq * factor : 0.0,
+                           CS_OSCBANK_START);
+        csound->OscBankSet(csound, bank, j, amp, freq, phase, mode);
+      }
+      /* keep track and frequency for next time */
+      keep[k] = j;
+      freqs[k] = freq;
+      trackID[k] = id;
+      i += 4;
+      k++;
+    }
+    /* the old tracks not matched are dead too */
+    for (j = k + notcontin; j < tracks; j++)
+      csound->OscBankSet(csound, bank, j, FL(0.0), (MYFLT) freqs[j],
+                         FL(0.0), CS_OSCBANK_GLIDE);
+    csound->OscBankRun(csound, bank, outsum, hopsize, next);
+    for (j = 0; j < k; j++)
+      csound->OscBankMove(csound, bank, j, keep[j]);
+    return k;
+}
+
 static int32_t psynth_process(CSOUND *csound, _PSYN *p)
 {
-    double  ampnext, amp, freq, freqnext, phase, ratio;
-    double  a, f, frac, incra, incrph, factor;
     MYFLT   scale = *p->scal, pitch = *p->pitch;
-    int32_t     ndx, size = p->func->flen;
-    int32_t     i, j, k, m, id;
-    int32_t     notcontin = 0;
-    int32_t     contin = 0;
-    int32_t     tracks = p->tracks, maxtracks = (int32_t) *p->maxtracks;
-    MYFLT   *tab = p->func->ftable, *out = p->out;
+    int32_t     maxtracks = (int32_t) *p->maxtracks;
+    MYFLT   *out = p->out;
     float   *fin = (float *) p->fin->frame.auxp;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
     int32_t      pos = p->pos;
-    double   *amps = (double *) p->amps.auxp, *freqs = (double *) p->freqs.auxp;
-    double   *phases = (double *) p->phases.auxp;
     MYFLT    *outsum = (MYFLT *) p->sum.auxp;
-    int32_t     *trackID = (int32_t *) p->trackID.auxp;
     int32_t     hopsize = p->hopsize;
-    double  min = p->min;
-    ratio = size * csound->onedsr;
-    factor = p->factor;
 
     maxtracks = p->numbins > maxtracks ? maxtracks : p->numbins;
 
@@ -175,80 +222,14 @@ static int32_t psynth_process(CSOUND *csound, _PSYN *p)
       out[n] = outsum[pos];
       pos++;
       if (pos == hopsize) {
-        memset(outsum, 0, sizeof(MYFLT) * hopsize);
-        /* for each track */
-        i = j = k = 0;
-        while (i < maxtracks * 4) {
-
-          ampnext = (double) fin[i] * scale;
-          freqnext = (double) fin[i + 1] * pitch;
-          if ((id = (int32_t) fin[i + 3]) != -1) {
-            j = k + notcontin;
-
-            if (k < tracks - notcontin) {
-              if (trackID[j] == id) {
-                /* if this is a continuing track */
-                contin = 1;
-                freq = freqs[j];
-                phase = phases[j];
-                amp = amps[j];
-
-              }
-              else {
-                /* if this is  a dead track */
-                contin = 0;
-                freqnext = freq = freqs[j];
-                phase = phases[j];
-                amp = amps[j];
-                ampnext = FL(0.0);
-              }
-            }
-            else {
-              /* new track */
-              contin = 1;
-              freq = freqnext;
-              phase = -freq * factor;
-              amp = FL(0.0);
-
-            }
-            if (amp > min) {
-              /* interpolation & track synthesis loop */
-              a = amp;
-              f = freq;
-              incra = (ampnext - amp) / hopsize;
-              incrph = (freqnext - freq) / hopsize;
-              for (m = 0; m < hopsize; m++) {
-                /* table lookup oscillator */
-                phase += f * ratio;
-                while (phase < 0)
-                  phase += size;
-                while (phase >= size)
-                  phase -= size;
-                ndx = (int32_t) phase;
-                frac = phase - ndx;
-                outsum[m] += a * (tab[ndx] + (tab[ndx + 1] - tab[ndx]) * frac);
-                a += incra;
-                f += incrph;
-              }
-            }
-            /* keep amp, freq, and phase values for next time */
-            if (contin) {
-
-              amps[k] = ampnext;
-              freqs[k] = freqnext;
-              phases[k] = phase;
-              trackID[k] = id;
-              i += 4;
-              k++;
-            }
-            else
-              notcontin++;
-          }
-          else
-            break;
-        }
+        /* linear frequency interpolation */
+        p->tracks = psynth_hop(csound, fin, p->tracks, maxtracks, scale,
+                               pitch, CS_OSCBANK_GLIDE, 0, p->factor, p->min,
+                               (double *) p->freqs.auxp,
+                               (int32_t *) p->trackID.auxp,
+                               (int32_t *) p->keep.auxp, p->bank.auxp,
+                               outsum, hopsize);
         pos = 0;
-        p->tracks = k;
       }
     }
     p->pos = pos;
@@ -277,21 +258,11 @@ static int32_t psynth2_init(CSOUND *csound, _PSYN2 *p)
     if(*p->thresh == -1) p->min = 0.00002*csound->Get0dBFS(csound);
     else p->min = *p->thresh*csound->Get0dBFS(csound);
 
-    if (p->amps.auxp == NULL ||
-        (uint32_t) p->amps.size < sizeof(double) * numbins)
-      csound->AuxAlloc(csound, sizeof(double) * numbins, &p->amps);
-    else
-      memset(p->amps.auxp, 0, sizeof(double) * numbins );
     if (p->freqs.auxp == NULL ||
         (uint32_t) p->freqs.size < sizeof(double) * numbins)
       csound->AuxAlloc(csound, sizeof(double) * numbins, &p->freqs);
     else
       memset(p->freqs.auxp, 0, sizeof(double) * numbins );
-    if (p->phases.auxp == NULL ||
-        (uint32_t) p->phases.size < sizeof(double) * numbins)
-      csound->AuxAlloc(csound, sizeof(double) * numbins, &p->phases);
-    else
-      memset(p->phases.auxp, 0, sizeof(double) * numbins  );
     if (p->sum.auxp == NULL ||
         (uint32_t) p->sum.size < sizeof(double) * p->hopsize)
       csound->AuxAlloc(csound, sizeof(double) * p->hopsize, &p->sum);
@@ -302,39 +273,28 @@ static int32_t psynth2_init(CSOUND *csound, _PSYN2 *p)
       csound->AuxAlloc(csound, sizeof(int32_t) * numbins, &p->trackID);
     else
       memset(p->trackID.auxp, 0, sizeof(int32_t) * numbins );
+    if (p->keep.auxp == NULL ||
+        (uint32_t) p->keep.size < sizeof(int32_t) * numbins)
+      csound->AuxAlloc(csound, sizeof(int32_t) * numbins, &p->keep);
+    /* old tracks, then new ones */
+    csound->OscBankCreate(csound, &p->bank, 2 * numbins, p->hopsize, p->func);
 
     return OK;
 }
 
 static int32_t psynth2_process(CSOUND *csound, _PSYN2 *p)
 {
-    double   ampnext, amp, freq, freqnext, phase, phasenext;
-    double  a2, a3, cph;
-    double   phasediff, facsqr, ph;
-    double   a, frac, incra, incrph, factor, lotwopi, cnt;
     MYFLT   scale = *p->scal;
-    int32_t     ndx, size = p->func->flen;
-    int32_t     i=0, j, k, m, id;
-    int32_t     notcontin = 0;
-    int32_t     contin = 0;
-    int32_t     tracks = p->tracks, maxtracks = (int32_t) *p->maxtracks;
-    MYFLT   *tab = p->func->ftable, *out = p->out;
+    int32_t     maxtracks = (int32_t) *p->maxtracks;
+    MYFLT   *out = p->out;
     float   *fin = (float *) p->fin->frame.auxp;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
     int32_t      pos = p->pos;
-    double   *amps = (double *) p->amps.auxp, *freqs = (double *) p->freqs.auxp;
-    double   *phases = (double *) p->phases.auxp;
     MYFLT   *outsum = (MYFLT *) p->sum.auxp;
-    int32_t     *trackID = (int32_t *) p->trackID.auxp;
     int32_t     hopsize = p->hopsize;
-    double  min = p->min;
 
-    incrph = csound->onedsr;
-    lotwopi = (double)(size) / TWOPI_F;
-    factor = p->factor;
-    facsqr = p->facsqr;
     maxtracks = p->numbins > maxtracks ? maxtracks : p->numbins;
 
     if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
@@ -346,104 +306,15 @@ static int32_t psynth2_process(CSOUND *csound, _PSYN2 *p)
       out[n] = outsum[pos];
       pos++;
       if (UNLIKELY(pos == hopsize)) {
-
-        memset(outsum, 0, sizeof(MYFLT) * hopsize);
-        /* for each track */
-        i = j = k = 0;
-        while (i < maxtracks * 4) {
-          ampnext = (double) fin[i] * scale;
-          freqnext = (double) fin[i + 1] * TWOPI_F;
-          phasenext = (double) fin[i + 2];
-          if ((id = (int32_t) fin[i + 3]) != -1) {
-
-            j = k + notcontin;
-
-            if (k < tracks - notcontin) {
-              if (trackID[j] == id) {
-                /* if this is a continuing track */
-                contin = 1;
-                freq = freqs[j];
-                phase = phases[j];
-                amp = amps[j];
-              }
-              else {
-                /* if this is  a dead track */
-                contin = 0;
-                freqnext = freq = freqs[j];
-                phase = phases[j];
-                phasenext = phase + freq * factor;
-                amp = amps[j];
-                ampnext = FL(0.0);
-              }
-            }
-            else {
-              /* new track */
-              contin = 1;
-              goto cont;
-#if 0
-              freq = freqnext;
-              phase = phasenext - freq * factor;
-              amp = FL(0.0);
-#endif
-            }
-            if (amp > min) {
-              /* phasediff */
-              phasediff = phasenext - phase;
-              while (phasediff >= PI_F)
-                phasediff -= TWOPI_F;
-              while (phasediff < -PI_F)
-                phasediff += TWOPI_F;
-
-              /* update phasediff to match the freq */
-              cph = ((freq + freqnext) * factor * 0.5 - phasediff) / TWOPI;
-
-              phasediff += TWOPI_F * (int32_t) (cph + 0.5);
-              /* interpolation coefs */
-              a2 = 3.0 / facsqr * (phasediff -
-                                   factor / 3.0 * (2.0 * freq + freqnext));
-              a3 = 1.0 / (3.0 * facsqr) * (freqnext - freq - 2.0 * a2 * factor);
-              //printf("%f %f \n", a2, a3);
-              /* interpolation & track synthesis loop */
-              a = amp;
-              ph = phase;
-              cnt = 0;
-              incra = (ampnext - amp) / hopsize;
-              for (m = 0; m < hopsize; m++) {
-                /* table lookup oscillator */
-                ph *= lotwopi;
-                while (ph < 0)
-                  ph += size;
-                while (ph >= size)
-                  ph -= size;
-                ndx = (int32_t) ph;
-                frac = ph - ndx;
-                outsum[m] += a * (tab[ndx] + (tab[ndx + 1] - tab[ndx]) * frac);
-                a += incra;
-                cnt += incrph;
-                ph = phase + cnt * (freq + cnt * (a2 + a3 * cnt));
-              }
-            }
-            /* keep amp, freq, and phase values for next time */
-          cont:
-            if (contin) {
-              amps[k] = ampnext;
-              freqs[k] = freqnext;
-              phases[k] = phasenext;
-              trackID[k] = id;
-              i += 4;
-              k++;
-            }
-            else
-              notcontin++;
-          }
-          else
-            break;
-
-        }
+        /* cubic phase interpolation */
+        p->tracks = psynth_hop(csound, fin, p->tracks, maxtracks, scale,
+                               FL(1.0), CS_OSCBANK_PHASE, 1, p->factor,
+                               p->min, (double *) p->freqs.auxp,
+                               (int32_t *) p->trackID.auxp,
+                               (int32_t *) p->keep.auxp, p->bank.auxp,
+                               outsum, hopsize);
         pos = 0;
-        p->tracks = k;
       }
-
     }
     p->pos = pos;
 
@@ -452,33 +323,17 @@ static int32_t psynth2_process(CSOUND *csound, _PSYN2 *p)
 
 static int32_t psynth3_process(CSOUND *csound, _PSYN *p)
 {
-    double   ampnext, amp, freq, freqnext, phase, phasenext;
-    double  a2, a3, cph=0.0;
-    double   phasediff, facsqr, ph;
-    double   a, frac, incra, incrph, factor, lotwopi, cnt;
     MYFLT   scale = *p->scal, pitch = *p->pitch;
-    int32_t     ndx, size = p->func->flen;
-    int32_t     i, j, k, m, id;
-    int32_t     notcontin = 0;
-    int32_t     contin = 0;
-    int32_t     tracks = p->tracks, maxtracks = (int32_t) *p->maxtracks;
-    MYFLT   *tab = p->func->ftable, *out = p->out;
+    int32_t     maxtracks = (int32_t) *p->maxtracks;
+    MYFLT   *out = p->out;
     float   *fin = (float *) p->fin->frame.auxp;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
     int32_t      pos = p->pos;
-    double   *amps = (double *) p->amps.auxp, *freqs = (double *) p->freqs.auxp;
-    double   *phases = (double *) p->phases.auxp;
     MYFLT    *outsum = (MYFLT *) p->sum.auxp;
-    int32_t     *trackID = (int32_t *) p->trackID.auxp;
     int32_t     hopsize = p->hopsize;
-    double  min = p->min;
 
-    incrph = csound->onedsr;
-    lotwopi = (double) (size) / TWOPI_F;
-    factor = p->factor;
-    facsqr = p->facsqr;
     maxtracks = p->numbins > maxtracks ? maxtracks : p->numbins;
 
     if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
@@ -490,99 +345,15 @@ static int32_t psynth3_process(CSOUND *csound, _PSYN *p)
       out[n] = outsum[pos];
       pos++;
       if (UNLIKELY(pos == hopsize)) {
-        memset(outsum, 0, sizeof(MYFLT) * hopsize);
-        /* for each track */
-        i = j = k = 0;
-        while (i < maxtracks * 4) {
-          ampnext = (double) fin[i] * scale;
-          freqnext = (double) fin[i + 1] * TWOPI_F * pitch;
-          phasenext = (double) fin[i + 2];
-          if ((id = (int32_t) fin[i + 3]) != -1) {
-            j = k + notcontin;
-
-            if (k < tracks - notcontin) {
-              if (trackID[j] == id) {
-                /* if this is a continuing track */
-                contin = 1;
-                freq = freqs[j];
-                phase = phases[j];
-                amp = amps[j];
-              }
-              else {
-                /* if this is  a dead track */
-                contin = 0;
-                freqnext = freq = freqs[j];
-                phase = phases[j];
-                phasenext = phase + freq * factor;
-                amp = amps[j];
-                ampnext = FL(0.0);
-              }
-            }
-            else {
-              /* new track */
-              contin = 1;
-              freq = freqnext;
-              phase = phasenext - freq * factor;
-              amp = FL(0.0);
-            }
-            if (amp > min) {
-              /* phasediff */
-              phasediff = phasenext - phase;
-              while (phasediff >= PI_F)
-                phasediff -= TWOPI_F;
-              while (phasediff < -PI_F)
-                phasediff += TWOPI_F;
-
-              /* update phasediff to match the freq */
-              cph = ((freq + freqnext) * factor *0.5 - phasediff) / TWOPI;
-              phasediff += TWOPI_F * cph;
-              /* interpolation coefs */
-              a2 = 3.0 / facsqr * (phasediff -
-                                   factor / 3.0 * (2.0 * freq + freqnext));
-              a3 = 1.0 / (3.0 * facsqr) * (freqnext - freq - 2.0 * a2 * factor);
-              /* interpolation & track synthesis loop */
-              a = amp;
-              ph = phase;
-              cnt = 0;
-              incra = (ampnext - amp) / hopsize;
-              for (m = 0; m < hopsize; m++) {
-                /* table lookup oscillator */
-                ph *= lotwopi;
-                while (ph < 0)
-                  ph += size;
-                while (ph >= size)
-                  ph -= size;
-                ndx = (int32_t) ph;
-                frac = ph - ndx;
-                outsum[m] += a * (tab[ndx] + (tab[ndx + 1] - tab[ndx]) * frac);
-                a += incra;
-                cnt += incrph;
-                ph = phase + cnt * (freq + cnt * (a2 + a3 * cnt));
-              }
-            }
-            /* keep amp, freq, and phase values for next time */
-            if (contin) {
-              amps[k] = ampnext;
-              freqs[k] = freqnext;
-              phasenext += (cph - (int32_t) cph) * TWOPI;
-              while (phasenext < 0)
-                phasenext += TWOPI_F;
-              while (phasenext >= TWOPI_F)
-                phasenext -= TWOPI_F;
-              phases[k] = phasenext;
-              trackID[k] = id;
-              i += 4;
-              k++;
-            }
-            else
-              notcontin++;
-          }
-          else
-            break;
-        }
+        /* the phases of pitch-shifted or time-scaled tracks are not
+           followed, only those of new tracks */
+        p->tracks = psynth_hop(csound, fin, p->tracks, maxtracks, scale,
+                               pitch, CS_OSCBANK_GLIDE, 1, p->factor, p->min,
+                               (double *) p->freqs.auxp,
+                               (int32_t *) p->trackID.auxp,
+                               (int32_t *) p->keep.auxp, p->bank.auxp,
+                               outsum, hopsize);
         pos = 0;
-        p->tracks = k;
-
       }
     }
     p->pos = pos;
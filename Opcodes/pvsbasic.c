@@ -242,10 +242,6 @@ static int32_t pvsfwriteset_(CSOUND *csound, PVSFWRITE *p, int32_t stringname)
   if (csound->oparms->realtime) {
     int32_t bufframes = 16;
     p->csound = csound;
-    if (p->frame.auxp == NULL || p->frame.size < sizeof(MYFLT) * (N + 2))
-      csound->AuxAlloc(csound, (N + 2) * sizeof(MYFLT), &p->frame);
-    if (p->buf.auxp == NULL || p->buf.size < sizeof(MYFLT) * (N + 2))
-      csound->AuxAlloc(csound, (N + 2) * sizeof(MYFLT), &p->buf);
     if (p->dframe.auxp == NULL || p->dframe.size < sizeof(float) * (N + 2))
       csound->AuxAlloc(csound, (N + 2) * sizeof(float), &p->dframe);
     p->cb = csound->CreateCircularBuffer(csound, (N+2)*sizeof(float)*bufframes,
@@ -278,15 +274,19 @@ static int32_t pvsfwriteset_S(CSOUND *csound, PVSFWRITE *p){
 uintptr_t pvs_io_thread(void *pp){
   PVSFWRITE *p = (PVSFWRITE *) pp;
   CSOUND *csound = p->csound;
-  MYFLT  *buf = (MYFLT *) p->buf.auxp;
   float  *frame = (float *) p->dframe.auxp;
   int32_t  *on = &p->async;
-  int32_t lc,n, N2=p->N+2;
+  int32_t j, n, k, N2=p->N+2;
+  CS_CIRCULAR_REGION r;
   _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
   while (*on) {
-    lc = csound->ReadCircularBuffer(csound, p->cb, buf, N2);
-    if (lc) {
-      for (n=0; n < N2; n++) frame[n] = (float) buf[n];
+    /* convert whole frames in place */
+    if (csound->ReadCircularBufferReserve(csound, p->cb, N2, &r) == N2) {
+      for (j = k = 0; j < 2; j++) {
+        MYFLT *buf = (MYFLT *) r.data[j];
+        for (n=0; n < r.items[j]; n++) frame[k++] = (float) buf[n];
+      }
+      csound->ReadCircularBufferCommit(csound, p->cb, N2);
       csound->PVOC_PutFrames(csound, p->pvfile, frame, 1);
     }
   }
@@ -312,13 +312,20 @@ static int32_t pvsfwrite(CSOUND *csound, PVSFWRITE *p)
                                  Str("pvsfwrite: could not write data\n"));
     }
     else {
-      MYFLT *fout = p->frame.auxp;
+      /* scale straight into the circular buffer, or drop the frame */
+      /* if there is no room for all of it                          */
+      CS_CIRCULAR_REGION r;
       MYFLT _0dbfs = csound->Get0dBFS(csound);
-      for (i=0;i < framesize; i+=2){
-        fout[i] = (MYFLT) fin[i]/_0dbfs;
-        fout[i+1] = (MYFLT) fin[i+1];
+      int32 j, n;
+      if (csound->WriteCircularBufferReserve(csound, p->cb, framesize,
+                                             &r) == framesize) {
+        for (j = i = 0; j < 2; j++) {
+          MYFLT *fout = (MYFLT *) r.data[j];
+          for (n = 0; n < r.items[j]; n++, i++)
+            fout[n] = (i & 1) ? (MYFLT) fin[i] : (MYFLT) fin[i]/_0dbfs;
+        }
+        csound->WriteCircularBufferCommit(csound, p->cb, framesize);
       }
-      csound->WriteCircularBuffer(csound, p->cb, fout, framesize);
     }
     p->lastframe = p->fin->framecount;
   }
@@ -59,11 +59,30 @@ struct _splitType {
 } PACKED;
 typedef struct _splitType splitType;
 
+/* a sounding zone: a split, and for presets the layer it belongs to */
+struct _zoneType {
+        struct _layerType *layer;
+        splitType *split;
+} PACKED;
+typedef struct _zoneType zoneType;
+
+/* key x velocity lookup of the zones of a preset or instrument, built
+   at load time: the zones for key k and velocity v are
+   zone[first[c]] .. zone[first[c+1]-1], c = k*bands + velBand[v] */
+struct _zoneIndex {
+        BYTE velBand[128];
+        int32_t bands;
+        int32_t *first;
+        zoneType *zone;
+} PACKED;
+typedef struct _zoneIndex zoneIndex;
+
 struct _instrType {
         int32_t num;
         char *name;
         BYTE splits_num;
         splitType *split;
+        zoneIndex zones;
 } PACKED;
 typedef struct _instrType instrType;
 
@@ -91,6 +110,7 @@ struct _presetType {
         WORD bank;
         int32_t layers_num;
         layerType *layer;
+        zoneIndex zones;
 } PACKED;
 typedef struct _presetType presetType;
 
@@ -125,6 +145,8 @@ struct _SFBANK {
         instrType *instr;
         SHORT *sampleData;
         CHUNKS chunk;
+        BYTE *map;              /* file mapping, or NULL if read */
+        size_t mapSize;
 } PACKED;
 typedef struct _SFBANK SFBANK;
 
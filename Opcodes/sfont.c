@@ -42,11 +42,22 @@
 #include "sfenum.h"
 #include "sfont.h"
 
+/* map the file instead of reading it: sample data is paged in on use */
+#if !defined(WIN32) && !defined(__wasi__) && !defined(WORDS_BIGENDIAN)
+#define SF_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #define s2d(x)  *((DWORD *) (x))
 
 
 
 static int32_t chunk_read(CSOUND *, FILE *f, CHUNK *chunk);
+#ifdef SF_MMAP
+static int32_t chunk_map(CSOUND *, FILE *f, SFBANK *sf);
+#endif
+static void build_zone_indexes(CSOUND *, SFBANK *sf);
 static void fill_SfPointers(CSOUND *);
 static int32_t  fill_SfStruct(CSOUND *);
 static void layerDefaults(layerType *layer);
@@ -84,13 +95,22 @@ int32_t sfont_ModuleDestroy(CSOUND *csound)
           csound->Free(csound, sfArray[j].preset[k].layer[l].split);
         }
         csound->Free(csound, sfArray[j].preset[k].layer);
+        csound->Free(csound, sfArray[j].preset[k].zones.first);
+        csound->Free(csound, sfArray[j].preset[k].zones.zone);
       }
       csound->Free(csound, sfArray[j].preset);
       for (l=0; l< sfArray[j].instrs_num; l++) {
         csound->Free(csound, sfArray[j].instr[l].split);
+        csound->Free(csound, sfArray[j].instr[l].zones.first);
+        csound->Free(csound, sfArray[j].instr[l].zones.zone);
       }
       csound->Free(csound, sfArray[j].instr);
-      csound->Free(csound, sfArray[j].chunk.main_chunk.ckDATA);
+#ifdef SF_MMAP
+      if (sfArray[j].map != NULL)
+        munmap(sfArray[j].map, sfArray[j].mapSize);
+      else
+#endif
+        csound->Free(csound, sfArray[j].chunk.main_chunk.ckDATA);
     }
     csound->Free(csound, sfArray);
     globals->currSFndx = 0;
@@ -137,12 +157,17 @@ static int SoundFontLoad(CSOUND *csound, char *fname)
     /* } */
     strNcpy(soundFont->name, csound->GetFileName(fd), 256);
     //soundFont->name[255]='\0';
+    soundFont->map = NULL;
+#ifdef SF_MMAP
+    if (chunk_map(csound, fil, soundFont) <= 0)
+#endif
     if (UNLIKELY(chunk_read(csound, fil, &soundFont->chunk.main_chunk)<0))
       csound->Message(csound, Str("sfont: failed to read file\n"));
     csound->FileClose(csound, fd);
     globals->soundFont = soundFont;
     fill_SfPointers(csound);
-    fill_SfStruct(csound);
+    if (fill_SfStruct(csound) == OK)
+      build_zone_indexes(csound, soundFont);
     return -1;
 }
 
@@ -209,6 +234,22 @@ static int32_t SfLoad_S(CSOUND *csound, SFLOAD *p){
   return SfLoad_(csound,p,1);
 }
 
+/* zones of a preset or instrument sounding at (key, vel) */
+
+static inline int32_t sf_zones(const zoneIndex *ix, int32_t key, int32_t vel,
+                               const zoneType **zone)
+{
+    int32_t c, n;
+    if (UNLIKELY(ix->first == NULL || key < 0 || key > 127 ||
+                 vel < 0 || vel > 127))
+      return 0;
+    c = key * ix->bands + ix->velBand[vel];
+    n = ix->first[c + 1] - ix->first[c];
+    if (n > 0)
+      *zone = &ix->zone[ix->first[c]];
+    return n;
+}
+
 static char *filter_string(char *s, char temp_string[24])
 {
     int32_t i=0, j=0;
@@ -375,7 +416,8 @@ static int32_t SfPlay_set(CSOUND *csound, SFPLAY *p)
     DWORD index = (DWORD) *p->ipresethandle;
     presetType *preset;
     SHORT *sBase;
-    int32_t layersNum, j, spltNum = 0, flag = (int32_t) *p->iflag;
+    const zoneType *zone;
+    int32_t zonesNum, j, spltNum = 0, flag = (int32_t) *p->iflag;
     sfontg *globals;
 
     globals = (sfontg *) (csound->QueryGlobalVariable(csound, "::sfontg"));
@@ -388,87 +430,75 @@ static int32_t SfPlay_set(CSOUND *csound, SFPLAY *p)
       return csound->InitError(csound, Str("sfplay: invalid or "
                                            "out-of-range preset number"));
     }
-    layersNum = preset->layers_num;
-    for (j =0; j < layersNum; j++) {
-      layerType *layer = &preset->layer[j];
-      int32_t vel= (int32_t) *p->ivel, notnum= (int32_t) *p->inotnum;
-      if (notnum >= layer->minNoteRange &&
-          notnum <= layer->maxNoteRange &&
-          vel    >= layer->minVelRange  &&
-          vel    <= layer->maxVelRange) {
-        int32_t splitsNum = layer->splits_num, k;
-        for (k = 0; k < splitsNum; k++) {
-          splitType *split = &layer->split[k];
-          if (notnum  >= split->minNoteRange &&
-              notnum  <= split->maxNoteRange &&
-              vel     >= split->minVelRange  &&
-              vel     <= split->maxVelRange) {
-            sfSample *sample = split->sample;
-            DWORD start=sample->dwStart;
-            MYFLT attenuation;
-            double pan;
-            double freq, orgfreq;
-            double tuneCorrection = split->coarseTune + layer->coarseTune +
-              (split->fineTune + layer->fineTune)*0.01;
-            int32_t orgkey = split->overridingRootKey;
-            if (orgkey == -1) orgkey = sample->byOriginalKey;
-            orgfreq = globals->pitches[orgkey];
-            if (flag) {
-              freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
-              p->si[spltNum]= (freq/(orgfreq*orgfreq))*
-                               sample->dwSampleRate*csound->onedsr;
-            }
-            else {
-              freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection) *
-                pow(2.0, ONETWELTH * (split->scaleTuning*0.01) * (notnum-orgkey));
-              p->si[spltNum]= (freq/orgfreq) * sample->dwSampleRate*csound->onedsr;
-            }
-            attenuation = (MYFLT) (layer->initialAttenuation +
-                                   split->initialAttenuation);
-            attenuation = POWER(FL(2.0), (-FL(1.0)/FL(60.0)) * attenuation )
-              * GLOBAL_ATTENUATION;
-            pan = (double)(split->pan + layer->pan) / 1000.0 + 0.5;
-            if (pan > 1.0) pan = 1.0;
-            else if (pan < 0.0) pan = 0.0;
-            /* Suggested fix from steven yi Oct 2002 */
-            p->base[spltNum] = sBase + start;
-            p->phs[spltNum] = (double) split->startOffset + *p->ioffset;
-            p->end[spltNum] = sample->dwEnd + split->endOffset - start;
-            p->startloop[spltNum] =
-              sample->dwStartloop + split->startLoopOffset  - start;
-            p->endloop[spltNum] =
-              sample->dwEndloop + split->endLoopOffset - start;
-            p->leftlevel[spltNum] = (MYFLT) sqrt(1.0-pan) * attenuation;
-            p->rightlevel[spltNum] = (MYFLT) sqrt(pan) * attenuation;
-            p->mode[spltNum]= split->sampleModes;
-            p->attack[spltNum] = split->attack*CS_EKR;
-            p->decay[spltNum] = split->decay*CS_EKR;
-            p->sustain[spltNum] = split->sustain;
-            p->release[spltNum] = split->release*CS_EKR;
-
-            if (*p->ienv > 1) {
-              p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
-              p->decr[spltNum] = pow((split->sustain+0.0001),
-                                     1.0/(CS_EKR*
-                                          split->decay+0.0001));
-              if (split->attack != 0.0) p->env[spltNum] = 0.0;
-              else p->env[spltNum] = 1.0;
-            }
-            else if (*p->ienv > 0) {
-              p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
-              p->decr[spltNum] = (split->sustain-1.0)/(CS_EKR*
-                                                       split->decay);
-              if (split->attack != 0.0) p->env[spltNum] = 0.0;
-              else p->env[spltNum] = 1.0;
-            }
-            else {
-              p->env[spltNum] = 1.0;
-            }
-            p->ti[spltNum] = 0;
-            spltNum++;
-          }
-        }
+    zonesNum = sf_zones(&preset->zones, (int32_t) *p->inotnum,
+                        (int32_t) *p->ivel, &zone);
+    for (j = 0; j < zonesNum; j++) {
+      layerType *layer = zone[j].layer;
+      splitType *split = zone[j].split;
+      int32_t notnum= (int32_t) *p->inotnum;
+      sfSample *sample = split->sample;
+      DWORD start=sample->dwStart;
+      MYFLT attenuation;
+      double pan;
+      double freq, orgfreq;
+      double tuneCorrection = split->coarseTune + layer->coarseTune +
+        (split->fineTune + layer->fineTune)*0.01;
+      int32_t orgkey = split->overridingRootKey;
+      if (orgkey == -1) orgkey = sample->byOriginalKey;
+      orgfreq = globals->pitches[orgkey];
+      if (flag) {
+        freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
+        p->si[spltNum]= (freq/(orgfreq*orgfreq))*
+                         sample->dwSampleRate*csound->onedsr;
+      }
+      else {
+        freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection) *
+          pow(2.0, ONETWELTH * (split->scaleTuning*0.01) * (notnum-orgkey));
+        p->si[spltNum]= (freq/orgfreq) * sample->dwSampleRate*csound->onedsr;
+      }
+      attenuation = (MYFLT) (layer->initialAttenuation +
+                             split->initialAttenuation);
+      attenuation = POWER(FL(2.0), (-FL(1.0)/FL(60.0)) * attenuation )
+        * GLOBAL_ATTENUATION;
+      pan = (double)(split->pan + layer->pan) / 1000.0 + 0.5;
+      if (pan > 1.0) pan = 1.0;
+      else if (pan < 0.0) pan = 0.0;
+      /* Suggested fix from steven yi Oct 2002 */
+      p->base[spltNum] = sBase + start;
+      p->phs[spltNum] = (double) split->startOffset + *p->ioffset;
+      p->end[spltNum] = sample->dwEnd + split->endOffset - start;
+      p->startloop[spltNum] =
+        sample->dwStartloop + split->startLoopOffset  - start;
+      p->endloop[spltNum] =
+        sample->dwEndloop + split->endLoopOffset - start;
+      p->leftlevel[spltNum] = (MYFLT) sqrt(1.0-pan) * attenuation;
+      p->rightlevel[spltNum] = (MYFLT) sqrt(pan) * attenuation;
+      p->mode[spltNum]= split->sampleModes;
+      p->attack[spltNum] = split->attack*CS_EKR;
+      p->decay[spltNum] = split->decay*CS_EKR;
+      p->sustain[spltNum] = split->sustain;
+      p->release[spltNum] = split->release*CS_EKR;
+
+      if (*p->ienv > 1) {
+        p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
+        p->decr[spltNum] = pow((split->sustain+0.0001),
+                               1.0/(CS_EKR*
+                                    split->decay+0.0001));
+        if (split->attack != 0.0) p->env[spltNum] = 0.0;
+        else p->env[spltNum] = 1.0;
+      }
+      else if (*p->ienv > 0) {
+        p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
+        p->decr[spltNum] = (split->sustain-1.0)/(CS_EKR*
+                                                 split->decay);
+        if (split->attack != 0.0) p->env[spltNum] = 0.0;
+        else p->env[spltNum] = 1.0;
+      }
+      else {
+        p->env[spltNum] = 1.0;
       }
+      p->ti[spltNum] = 0;
+      spltNum++;
     }
     p->spltNum = spltNum;
     return OK;
@@ -713,7 +743,8 @@ static int32_t SfPlayMono_set(CSOUND *csound, SFPLAYMONO *p)
     DWORD index = (DWORD) *p->ipresethandle;
     presetType *preset;
     SHORT *sBase;
-    int32_t layersNum, j, spltNum = 0, flag=(int32_t) *p->iflag;
+    const zoneType *zone;
+    int32_t zonesNum, j, spltNum = 0, flag=(int32_t) *p->iflag;
     sfontg *globals;
     globals = (sfontg *) (csound->QueryGlobalVariable(csound, "::sfontg"));
     //printf("*** index= %d  maximum = %d\n", index, globals->currSFndx);
@@ -727,78 +758,66 @@ static int32_t SfPlayMono_set(CSOUND *csound, SFPLAYMONO *p)
       return csound->InitError(csound, Str("sfplaym: invalid or "
                                            "out-of-range preset number"));
     }
-    layersNum= preset->layers_num;
-    for (j =0; j < layersNum; j++) {
-      layerType *layer = &preset->layer[j];
-      int32_t vel= (int32_t) *p->ivel, notnum= (int32_t) *p->inotnum;
-      if (notnum >= layer->minNoteRange &&
-          notnum <= layer->maxNoteRange &&
-          vel >= layer->minVelRange  &&
-          vel <= layer->maxVelRange) {
-        int32_t splitsNum = layer->splits_num, k;
-        for (k = 0; k < splitsNum; k++) {
-          splitType *split = &layer->split[k];
-          if (notnum >= split->minNoteRange &&
-              notnum <= split->maxNoteRange &&
-              vel >= split->minVelRange  &&
-              vel <= split->maxVelRange) {
-            sfSample *sample = split->sample;
-            DWORD start=sample->dwStart;
-            double freq, orgfreq;
-            double tuneCorrection = split->coarseTune + layer->coarseTune +
-              (split->fineTune + layer->fineTune)*0.01;
-            int32_t orgkey = split->overridingRootKey;
-            if (orgkey == -1) orgkey = sample->byOriginalKey;
-            orgfreq = globals->pitches[orgkey] ;
-            if (flag) {
-              freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
-              p->si[spltNum]= (freq/(orgfreq*orgfreq))*
-                               sample->dwSampleRate*csound->onedsr;
-            }
-            else {
-              freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection) *
-                pow( 2.0, ONETWELTH* (split->scaleTuning*0.01) * (notnum-orgkey));
-              p->si[spltNum]= (freq/orgfreq) * sample->dwSampleRate*csound->onedsr;
-            }
-            p->attenuation[spltNum] =
-              POWER(FL(2.0), (-FL(1.0)/FL(60.0)) * (layer->initialAttenuation +
-                                                    split->initialAttenuation)) *
-              GLOBAL_ATTENUATION;
-            p->base[spltNum] =  sBase+ start;
-            p->phs[spltNum] = (double) split->startOffset + *p->ioffset;
-            p->end[spltNum] = sample->dwEnd + split->endOffset - start;
-            p->startloop[spltNum] = sample->dwStartloop +
-              split->startLoopOffset - start;
-            p->endloop[spltNum] = sample->dwEndloop + split->endLoopOffset - start;
-            p->mode[spltNum]= split->sampleModes;
-            p->attack[spltNum] = split->attack*CS_EKR;
-            p->decay[spltNum] = split->decay*CS_EKR;
-            p->sustain[spltNum] = split->sustain;
-            p->release[spltNum] = split->release*CS_EKR;
-
-            if (*p->ienv > 1) {
-             p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
-             p->decr[spltNum] = pow((split->sustain+0.0001),
-                                    1.0/(CS_EKR*
-                                         split->decay+0.0001));
-            if (split->attack != 0.0) p->env[spltNum] = 0.0;
-            else p->env[spltNum] = 1.0;
-            }
-            else if (*p->ienv > 0) {
-            p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
-            p->decr[spltNum] = (split->sustain-1.0)/(CS_EKR*
-                                                     split->decay);
-            if (split->attack != 0.0) p->env[spltNum] = 0.0;
-            else p->env[spltNum] = 1.0;
-            }
-            else {
-              p->env[spltNum] = 1.0;
-            }
-            p->ti[spltNum] = 0;
-            spltNum++;
-          }
-        }
+    zonesNum = sf_zones(&preset->zones, (int32_t) *p->inotnum,
+                        (int32_t) *p->ivel, &zone);
+    for (j = 0; j < zonesNum; j++) {
+      layerType *layer = zone[j].layer;
+      splitType *split = zone[j].split;
+      int32_t notnum= (int32_t) *p->inotnum;
+      sfSample *sample = split->sample;
+      DWORD start=sample->dwStart;
+      double freq, orgfreq;
+      double tuneCorrection = split->coarseTune + layer->coarseTune +
+        (split->fineTune + layer->fineTune)*0.01;
+      int32_t orgkey = split->overridingRootKey;
+      if (orgkey == -1) orgkey = sample->byOriginalKey;
+      orgfreq = globals->pitches[orgkey] ;
+      if (flag) {
+        freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
+        p->si[spltNum]= (freq/(orgfreq*orgfreq))*
+                         sample->dwSampleRate*csound->onedsr;
+      }
+      else {
+        freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection) *
+          pow( 2.0, ONETWELTH* (split->scaleTuning*0.01) * (notnum-orgkey));
+        p->si[spltNum]= (freq/orgfreq) * sample->dwSampleRate*csound->onedsr;
+      }
+      p->attenuation[spltNum] =
+        POWER(FL(2.0), (-FL(1.0)/FL(60.0)) * (layer->initialAttenuation +
+                                              split->initialAttenuation)) *
+        GLOBAL_ATTENUATION;
+      p->base[spltNum] =  sBase+ start;
+      p->phs[spltNum] = (double) split->startOffset + *p->ioffset;
+      p->end[spltNum] = sample->dwEnd + split->endOffset - start;
+      p->startloop[spltNum] = sample->dwStartloop +
+        split->startLoopOffset - start;
+      p->endloop[spltNum] = sample->dwEndloop + split->endLoopOffset - start;
+      p->mode[spltNum]= split->sampleModes;
+      p->attack[spltNum] = split->attack*CS_EKR;
+      p->decay[spltNum] = split->decay*CS_EKR;
+      p->sustain[spltNum] = split->sustain;
+      p->release[spltNum] = split->release*CS_EKR;
+
+      if (*p->ienv > 1) {
+       p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
+       p->decr[spltNum] = pow((split->sustain+0.0001),
+                              1.0/(CS_EKR*
+                                   split->decay+0.0001));
+      if (split->attack != 0.0) p->env[spltNum] = 0.0;
+      else p->env[spltNum] = 1.0;
       }
+      else if (*p->ienv > 0) {
+      p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
+      p->decr[spltNum] = (split->sustain-1.0)/(CS_EKR*
+                                               split->decay);
+      if (split->attack != 0.0) p->env[spltNum] = 0.0;
+      else p->env[spltNum] = 1.0;
+      }
+      else {
+        p->env[spltNum] = 1.0;
+      }
+      p->ti[spltNum] = 0;
+      spltNum++;
     }
     p->spltNum = spltNum;
     return OK;
@@ -996,72 +1015,68 @@ static int32_t SfInstrPlay_set(CSOUND *csound, SFIPLAY *p)
       SHORT *sBase = sf->sampleData;
       int32_t spltNum = 0, flag=(int32_t) *p->iflag;
       int32_t vel= (int32_t) *p->ivel, notnum= (int32_t) *p->inotnum;
-      int32_t splitsNum = layer->splits_num, k;
+      const zoneType *zone;
+      int32_t splitsNum = sf_zones(&layer->zones, notnum, vel, &zone), k;
       for (k = 0; k < splitsNum; k++) {
-        splitType *split = &layer->split[k];
-        if (notnum >= split->minNoteRange &&
-            notnum <= split->maxNoteRange &&
-            vel >= split->minVelRange  &&
-            vel <= split->maxVelRange) {
-          sfSample *sample = split->sample;
-          DWORD start=sample->dwStart;
-          MYFLT attenuation, pan;
-          double freq, orgfreq;
-          double tuneCorrection = split->coarseTune + split->fineTune*0.01;
-          int32_t orgkey = split->overridingRootKey;
-          if (orgkey == -1) orgkey = sample->byOriginalKey;
-          orgfreq = globals->pitches[orgkey] ;
-          if (flag) {
-            freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
-            p->si[spltNum] = (freq/(orgfreq*orgfreq))*
-                              sample->dwSampleRate*csound->onedsr;
-          }
-          else {
-            freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection)
-              * pow( 2.0, ONETWELTH* (split->scaleTuning*0.01)*(notnum - orgkey));
-            p->si[spltNum] = (freq/orgfreq)*(sample->dwSampleRate*csound->onedsr);
-          }
-          attenuation = (MYFLT) (split->initialAttenuation);
-          attenuation = POWER(FL(2.0), (-FL(1.0)/FL(60.0)) * attenuation) *
-            GLOBAL_ATTENUATION;
-          pan = (MYFLT)  split->pan / FL(1000.0) + FL(0.5);
-          if (pan > FL(1.0)) pan =FL(1.0);
-          else if (pan < FL(0.0)) pan = FL(0.0);
-          p->base[spltNum] = sBase + start;
-          p->phs[spltNum] = (double) split->startOffset + *p->ioffset;
-          p->end[spltNum] = sample->dwEnd + split->endOffset - start;
-          p->startloop[spltNum] = sample->dwStartloop +
-            split->startLoopOffset - start;
-          p->endloop[spltNum] = sample->dwEndloop + split->endLoopOffset - start;
-          p->leftlevel[spltNum] = (FL(1.0)-pan) * attenuation;
-          p->rightlevel[spltNum] = pan * attenuation;
-          p->mode[spltNum]= split->sampleModes;
-
-          p->attack[spltNum] = split->attack*CS_EKR;
-          p->decay[spltNum] = split->decay*CS_EKR;
-          p->sustain[spltNum] = split->sustain;
-          p->release[spltNum] = split->release*CS_EKR;
-
-          if (*p->ienv > 1) {
-            p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
-            p->decr[spltNum] = pow((split->sustain+0.0001),
-                                   1.0/(CS_EKR*split->decay+0.0001));
-            if (split->attack != 0.0) p->env[spltNum] = 0.0;
-            else p->env[spltNum] = 1.0;
-          }
-          else if (*p->ienv > 0) {
-            p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
-            p->decr[spltNum] = (split->sustain-1.0)/(CS_EKR*
-                                                     split->decay);
-            if (split->attack != 0.0) p->env[spltNum] = 0.0;
-            else p->env[spltNum] = 1.0;
-          }
-          else {
-            p->env[spltNum] = 1.0;
-          }
-          p->ti[spltNum] = 0;
-          spltNum++;
+        splitType *split = zone[k].split;
+        sfSample *sample = split->sample;
+        DWORD start=sample->dwStart;
+        MYFLT attenuation, pan;
+        double freq, orgfreq;
+        double tuneCorrection = split->coarseTune + split->fineTune*0.01;
+        int32_t orgkey = split->overridingRootKey;
+        if (orgkey == -1) orgkey = sample->byOriginalKey;
+        orgfreq = globals->pitches[orgkey] ;
+        if (flag) {
+          freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
+          p->si[spltNum] = (freq/(orgfreq*orgfreq))*
+                            sample->dwSampleRate*csound->onedsr;
+        }
+        else {
+          freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection)
+            * pow( 2.0, ONETWELTH* (split->scaleTuning*0.01)*(notnum - orgkey));
+          p->si[spltNum] = (freq/orgfreq)*(sample->dwSampleRate*csound->onedsr);
+        }
+        attenuation = (MYFLT) (split->initialAttenuation);
+        attenuation = POWER(FL(2.0), (-FL(1.0)/FL(60.0)) * attenuation) *
+          GLOBAL_ATTENUATION;
+        pan = (MYFLT)  split->pan / FL(1000.0) + FL(0.5);
+        if (pan > FL(1.0)) pan =FL(1.0);
+        else if (pan < FL(0.0)) pan = FL(0.0);
+        p->base[spltNum] = sBase + start;
+        p->phs[spltNum] = (double) split->startOffset + *p->ioffset;
+        p->end[spltNum] = sample->dwEnd + split->endOffset - start;
+        p->startloop[spltNum] = sample->dwStartloop +
+          split->startLoopOffset - start;
+        p->endloop[spltNum] = sample->dwEndloop + split->endLoopOffset - start;
+        p->leftlevel[spltNum] = (FL(1.0)-pan) * attenuation;
+        p->rightlevel[spltNum] = pan * attenuation;
+        p->mode[spltNum]= split->sampleModes;
+
+        p->attack[spltNum] = split->attack*CS_EKR;
+        p->decay[spltNum] = split->decay*CS_EKR;
+        p->sustain[spltNum] = split->sustain;
+        p->release[spltNum] = split->release*CS_EKR;
+
+        if (*p->ienv > 1) {
+          p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
+          p->decr[spltNum] = pow((split->sustain+0.0001),
+                                 1.0/(CS_EKR*split->decay+0.0001));
+          if (split->attack != 0.0) p->env[spltNum] = 0.0;
+          else p->env[spltNum] = 1.0;
         }
+        else if (*p->ienv > 0) {
+          p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
+          p->decr[spltNum] = (split->sustain-1.0)/(CS_EKR*
+                                                   split->decay);
+          if (split->attack != 0.0) p->env[spltNum] = 0.0;
+          else p->env[spltNum] = 1.0;
+        }
+        else {
+          p->env[spltNum] = 1.0;
+        }
+        p->ti[spltNum] = 0;
+        spltNum++;
       }
       p->spltNum = spltNum;
     }
@@ -1269,66 +1284,62 @@ static int32_t SfInstrPlayMono_set(CSOUND *csound, SFIPLAYMONO *p)
       SHORT *sBase = sf->sampleData;
       int32_t spltNum = 0, flag=(int32_t) *p->iflag;
       int32_t vel= (int32_t) *p->ivel, notnum= (int32_t) *p->inotnum;
-      int32_t splitsNum = layer->splits_num, k;
+      const zoneType *zone;
+      int32_t splitsNum = sf_zones(&layer->zones, notnum, vel, &zone), k;
       for (k = 0; k < splitsNum; k++) {
-        splitType *split = &layer->split[k];
-        if (notnum >= split->minNoteRange &&
-            notnum <= split->maxNoteRange &&
-            vel >= split->minVelRange  &&
-            vel     <= split->maxVelRange) {
-          sfSample *sample = split->sample;
-          DWORD start=sample->dwStart;
-          double freq, orgfreq;
-          double tuneCorrection = split->coarseTune + split->fineTune/100.0;
-          int32_t orgkey = split->overridingRootKey;
-          if (orgkey == -1) orgkey = sample->byOriginalKey;
-          orgfreq = globals->pitches[orgkey];
-          if (flag) {
-            freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
-            p->si[spltNum] = (freq/(orgfreq*orgfreq))*
-                              sample->dwSampleRate*csound->onedsr;
-          }
-          else {
-            freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection)
-              * pow( 2.0, ONETWELTH* (split->scaleTuning*0.01) * (notnum-orgkey));
-            p->si[spltNum] = (freq/orgfreq)*(sample->dwSampleRate*csound->onedsr);
-          }
-          p->attenuation[spltNum] = (MYFLT) pow(2.0, (-1.0/60.0)*
-                                                split->initialAttenuation)
-            * GLOBAL_ATTENUATION;
-          p->base[spltNum] = sBase+ start;
-          p->phs[spltNum] = (double) split->startOffset + *p->ioffset;
-          p->end[spltNum] = sample->dwEnd + split->endOffset - start;
-          p->startloop[spltNum] = sample->dwStartloop +
-            split->startLoopOffset - start;
-          p->endloop[spltNum] = sample->dwEndloop + split->endLoopOffset - start;
-          p->mode[spltNum]= split->sampleModes;
-          p->attack[spltNum] = split->attack*CS_EKR;
-          p->decay[spltNum] = split->decay*CS_EKR;
-          p->sustain[spltNum] = split->sustain;
-          p->release[spltNum] = split->release*CS_EKR;
-
-          if (*p->ienv > 1) {
-            p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
-            p->decr[spltNum] = pow((split->sustain+0.0001),
-                                   1.0/(CS_EKR*
-                                        split->decay+0.0001));
-            if (split->attack != 0.0) p->env[spltNum] = 0.0;
-            else p->env[spltNum] = 1.0;
-          }
-          else if (*p->ienv > 0) {
-            p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
-            p->decr[spltNum] = (split->sustain-1.0)/(CS_EKR*
-                                                     split->decay);
-            if (split->attack != 0.0) p->env[spltNum] = 0.0;
-            else p->env[spltNum] = 1.0;
-          }
-          else {
-            p->env[spltNum] = 1.0;
-          }
-          p->ti[spltNum] = 0;
-          spltNum++;
+        splitType *split = zone[k].split;
+        sfSample *sample = split->sample;
+        DWORD start=sample->dwStart;
+        double freq, orgfreq;
+        double tuneCorrection = split->coarseTune + split->fineTune/100.0;
+        int32_t orgkey = split->overridingRootKey;
+        if (orgkey == -1) orgkey = sample->byOriginalKey;
+        orgfreq = globals->pitches[orgkey];
+        if (flag) {
+          freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
+          p->si[spltNum] = (freq/(orgfreq*orgfreq))*
+                            sample->dwSampleRate*csound->onedsr;
+        }
+        else {
+          freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection)
+            * pow( 2.0, ONETWELTH* (split->scaleTuning*0.01) * (notnum-orgkey));
+          p->si[spltNum] = (freq/orgfreq)*(sample->dwSampleRate*csound->onedsr);
+        }
+        p->attenuation[spltNum] = (MYFLT) pow(2.0, (-1.0/60.0)*
+                                              split->initialAttenuation)
+          * GLOBAL_ATTENUATION;
+        p->base[spltNum] = sBase+ start;
+        p->phs[spltNum] = (double) split->startOffset + *p->ioffset;
+        p->end[spltNum] = sample->dwEnd + split->endOffset - start;
+        p->startloop[spltNum] = sample->dwStartloop +
+          split->startLoopOffset - start;
+        p->endloop[spltNum] = sample->dwEndloop + split->endLoopOffset - start;
+        p->mode[spltNum]= split->sampleModes;
+        p->attack[spltNum] = split->attack*CS_EKR;
+        p->decay[spltNum] = split->decay*CS_EKR;
+        p->sustain[spltNum] = split->sustain;
+        p->release[spltNum] = split->release*CS_EKR;
+
+        if (*p->ienv > 1) {
+          p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
+          p->decr[spltNum] = pow((split->sustain+0.0001),
+                                 1.0/(CS_EKR*
+                                      split->decay+0.0001));
+          if (split->attack != 0.0) p->env[spltNum] = 0.0;
+          else p->env[spltNum] = 1.0;
         }
+        else if (*p->ienv > 0) {
+          p->attr[spltNum] = 1.0/(CS_EKR*split->attack);
+          p->decr[spltNum] = (split->sustain-1.0)/(CS_EKR*
+                                                   split->decay);
+          if (split->attack != 0.0) p->env[spltNum] = 0.0;
+          else p->env[spltNum] = 1.0;
+        }
+        else {
+          p->env[spltNum] = 1.0;
+        }
+        p->ti[spltNum] = 0;
+        spltNum++;
       }
       p->spltNum = spltNum;
     }
@@ -1588,7 +1599,7 @@ static int32_t fill_SfStruct(CSOUND *csound)
 
     size = phdrChunk->ckSize / sizeof(sfPresetHeader);
     soundFont->presets_num = size;
-    preset = (presetType *) csound->Malloc(csound, size * sizeof(presetType));
+    preset = (presetType *) csound->Calloc(csound, size * sizeof(presetType));
     for (j=0; j < size; j++) {
       preset[j].name = phdr[j].achPresetName;
       if (strcmp(preset[j].name,"EOP")==0) {
@@ -1862,7 +1873,7 @@ static int32_t fill_SfStruct(CSOUND *csound)
       instrType *instru;
       size = soundFont->chunk.instChunk->ckSize / sizeof(sfInst);
       soundFont->instrs_num = size;
-      instru = (instrType *) csound->Malloc(csound, size * sizeof(layerType));
+      instru = (instrType *) csound->Calloc(csound, size * sizeof(instrType));
       for (j=0; j < size; j++) {
 #define UNUSE 0x7fffffff
         int32_t GsampleModes=UNUSE, GcoarseTune=UNUSE, GfineTune=UNUSE;
@@ -2108,6 +2119,139 @@ static DWORD dword(char *p)
     return x.i;
 }
 
+#ifdef SF_MMAP
+/* map the whole file read-only; only the pages of the (small) preset and
+   instrument chunks are touched while loading, sample data is paged in
+   when played. Returns 0 if the file cannot be mapped. */
+static int32_t chunk_map(CSOUND *csound, FILE *fil, SFBANK *sf)
+{
+    CHUNK *chunk = &sf->chunk.main_chunk;
+    struct stat st;
+    BYTE *map;
+    IGN(csound);
+
+    if (fstat(fileno(fil), &st) != 0 || st.st_size < 8)
+      return 0;
+    map = (BYTE *) mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+                        fileno(fil), 0);
+    if (map == (BYTE *) MAP_FAILED)
+      return 0;
+    sf->map = map;
+    sf->mapSize = (size_t) st.st_size;
+    memcpy(chunk->ckID, map, 4);
+    chunk->ckSize = dword((char *) map + 4);
+    if (chunk->ckSize > sf->mapSize - 8)
+      chunk->ckSize = (DWORD) (sf->mapSize - 8);
+    chunk->ckDATA = map + 8;
+    return (int32_t) chunk->ckSize;
+}
+#endif
+
+/* key x velocity indexes of the zones of all presets and instruments */
+
+typedef struct {
+    layerType *layer;
+    splitType *split;
+    int32_t   lokey, hikey, lovel, hivel;
+} zoneRange;
+
+static void index_zones(CSOUND *csound, zoneIndex *ix,
+                        const zoneRange *zr, int32_t n)
+{
+    BYTE    mark[129];
+    int32_t i, k, b, v, cells, *fill;
+
+    /* velocity bands: ranges in which the set of zones does not change */
+    memset(mark, 0, sizeof(mark));
+    mark[0] = 1;
+    for (i = 0; i < n; i++) {
+      mark[zr[i].lovel] = 1;
+      mark[zr[i].hivel + 1] = 1;
+    }
+    for (v = 0, b = -1; v < 128; v++) {
+      if (mark[v]) b++;
+      ix->velBand[v] = (BYTE) b;
+    }
+    ix->bands = b + 1;
+    cells = 128 * ix->bands;
+    ix->first = (int32_t *) csound->Calloc(csound, (cells + 1) * sizeof(int32_t));
+    /* count zones per cell, in file order, at most MAXSPLT */
+    for (i = 0; i < n; i++)
+      for (k = zr[i].lokey; k <= zr[i].hikey; k++)
+        for (b = ix->velBand[zr[i].lovel]; b <= ix->velBand[zr[i].hivel]; b++)
+          if (ix->first[k * ix->bands + b + 1] < MAXSPLT)
+            ix->first[k * ix->bands + b + 1]++;
+    for (i = 0; i < cells; i++)
+      ix->first[i + 1] += ix->first[i];
+    if (ix->first[cells] == 0)
+      return;
+    ix->zone = (zoneType *) csound->Malloc(csound,
+                                           ix->first[cells] * sizeof(zoneType));
+    fill = (int32_t *) csound->Calloc(csound, cells * sizeof(int32_t));
+    for (i = 0; i < n; i++)
+      for (k = zr[i].lokey; k <= zr[i].hikey; k++)
+        for (b = ix->velBand[zr[i].lovel]; b <= ix->velBand[zr[i].hivel]; b++) {
+          int32_t c = k * ix->bands + b;
+          if (ix->first[c] + fill[c] < ix->first[c + 1]) {
+            zoneType *z = &ix->zone[ix->first[c] + fill[c]++];
+            z->layer = zr[i].layer;
+            z->split = zr[i].split;
+          }
+        }
+    csound->Free(csound, fill);
+}
+
+/* intersect key and velocity ranges, zero if empty */
+static int32_t zone_range(zoneRange *zr, layerType *layer, splitType *split)
+{
+    zr->layer = layer;
+    zr->split = split;
+    zr->lokey = split->minNoteRange;
+    zr->hikey = split->maxNoteRange;
+    zr->lovel = split->minVelRange;
+    zr->hivel = split->maxVelRange;
+    if (layer != NULL) {
+      if (layer->minNoteRange > zr->lokey) zr->lokey = layer->minNoteRange;
+      if (layer->maxNoteRange < zr->hikey) zr->hikey = layer->maxNoteRange;
+      if (layer->minVelRange > zr->lovel) zr->lovel = layer->minVelRange;
+      if (layer->maxVelRange < zr->hivel) zr->hivel = layer->maxVelRange;
+    }
+    if (zr->hikey > 127) zr->hikey = 127;
+    if (zr->hivel > 127) zr->hivel = 127;
+    return (zr->lokey <= zr->hikey && zr->lovel <= zr->hivel);
+}
+
+static void build_zone_indexes(CSOUND *csound, SFBANK *sf)
+{
+    zoneRange *zr = NULL;
+    int32_t   j, k, l, n, max = 0;
+
+    for (j = 0; j < sf->presets_num; j++) {
+      presetType *preset = &sf->preset[j];
+      for (n = 0, k = 0; k < preset->layers_num; k++)
+        n += preset->layer[k].splits_num;
+      if (n > max) {
+        max = n;
+        zr = (zoneRange *) csound->ReAlloc(csound, zr, max * sizeof(zoneRange));
+      }
+      for (n = 0, k = 0; k < preset->layers_num; k++)
+        for (l = 0; l < preset->layer[k].splits_num; l++)
+          n += zone_range(&zr[n], &preset->layer[k], &preset->layer[k].split[l]);
+      index_zones(csound, &preset->zones, zr, n);
+    }
+    for (j = 0; j < sf->instrs_num; j++) {
+      instrType *instr = &sf->instr[j];
+      if (instr->splits_num > max) {
+        max = instr->splits_num;
+        zr = (zoneRange *) csound->ReAlloc(csound, zr, max * sizeof(zoneRange));
+      }
+      for (n = 0, l = 0; l < instr->splits_num; l++)
+        n += zone_range(&zr[n], NULL, &instr->split[l]);
+      index_zones(csound, &instr->zones, zr, n);
+    }
+    csound->Free(csound, zr);
+}
+
 static void fill_SfPointers(CSOUND *csound)
 {
     char *chkp;
@@ -2324,7 +2468,8 @@ static int32_t sflooper_init(CSOUND *csound, sflooper *p)
     DWORD index = (DWORD) *p->ipresethandle;
     presetType *preset;
     SHORT *sBase;
-    int32_t layersNum, j, spltNum = 0;
+    const zoneType *zone;
+    int32_t zonesNum, j, spltNum = 0;
     sfontg *globals;
     globals = (sfontg *) (csound->QueryGlobalVariable(csound, "::sfontg"));
 
@@ -2334,59 +2479,47 @@ static int32_t sflooper_init(CSOUND *csound, sflooper *p)
       return csound->InitError(csound, Str("sfplay: invalid or "
                                            "out-of-range preset number"));
     }
-    layersNum = preset->layers_num;
-    for (j =0; j < layersNum; j++) {
-      layerType *layer = &preset->layer[j];
-      int32_t vel= (int32_t) *p->ivel, notnum= (int32_t) *p->inotnum;
-      if (notnum >= layer->minNoteRange &&
-          notnum <= layer->maxNoteRange &&
-          vel    >= layer->minVelRange  &&
-          vel    <= layer->maxVelRange) {
-        int32_t splitsNum = layer->splits_num, k;
-        for (k = 0; k < splitsNum; k++) {
-          splitType *split = &layer->split[k];
-          if (notnum  >= split->minNoteRange &&
-              notnum  <= split->maxNoteRange &&
-              vel     >= split->minVelRange  &&
-              vel     <= split->maxVelRange) {
-            sfSample *sample = split->sample;
-            DWORD start=sample->dwStart;
-            MYFLT attenuation;
-            double pan;
-            double freq, orgfreq;
-            double tuneCorrection = split->coarseTune + layer->coarseTune +
-              (split->fineTune + layer->fineTune)*0.01;
-            int32_t orgkey = split->overridingRootKey;
-            if (orgkey == -1) orgkey = sample->byOriginalKey;
-            orgfreq = globals->pitches[orgkey];
-
-            if (*p->iflag) {
-              freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
-              p->freq[spltNum]= (freq/(orgfreq*orgfreq))*
-                               sample->dwSampleRate*csound->onedsr;
-            }
-            else {
-              freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection) *
-                pow(2.0, ONETWELTH * (split->scaleTuning*0.01) * (notnum-orgkey));
-              p->freq[spltNum]= (freq/orgfreq) * sample->dwSampleRate*csound->onedsr;
-            }
-
-            attenuation = (MYFLT) (layer->initialAttenuation +
-                                   split->initialAttenuation);
-            attenuation = POWER(FL(2.0), (-FL(1.0)/FL(60.0)) * attenuation )
-              * GLOBAL_ATTENUATION;
-            pan = (double)(split->pan + layer->pan) / 1000.0 + 0.5;
-            if (pan > 1.0) pan = 1.0;
-            else if (pan < 0.0) pan = 0.0;
-            p->sBase[spltNum] = sBase;
-            p->sstart[spltNum] = start;
-            p->end[spltNum] = sample->dwEnd + split->endOffset;
-            p->leftlevel[spltNum] = (MYFLT) sqrt(1.0-pan) * attenuation;
-            p->rightlevel[spltNum] = (MYFLT) sqrt(pan) * attenuation;
-            spltNum++;
-          }
-        }
+    zonesNum = sf_zones(&preset->zones, (int32_t) *p->inotnum,
+                        (int32_t) *p->ivel, &zone);
+    for (j = 0; j < zonesNum; j++) {
+      layerType *layer = zone[j].layer;
+      splitType *split = zone[j].split;
+      int32_t notnum= (int32_t) *p->inotnum;
+      sfSample *sample = split->sample;
+      DWORD start=sample->dwStart;
+      MYFLT attenuation;
+      double pan;
+      double freq, orgfreq;
+      double tuneCorrection = split->coarseTune + layer->coarseTune +
+        (split->fineTune + layer->fineTune)*0.01;
+      int32_t orgkey = split->overridingRootKey;
+      if (orgkey == -1) orgkey = sample->byOriginalKey;
+      orgfreq = globals->pitches[orgkey];
+
+      if (*p->iflag) {
+        freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection);
+        p->freq[spltNum]= (freq/(orgfreq*orgfreq))*
+                         sample->dwSampleRate*csound->onedsr;
       }
+      else {
+        freq = orgfreq * pow(2.0, ONETWELTH * tuneCorrection) *
+          pow(2.0, ONETWELTH * (split->scaleTuning*0.01) * (notnum-orgkey));
+        p->freq[spltNum]= (freq/orgfreq) * sample->dwSampleRate*csound->onedsr;
+      }
+
+      attenuation = (MYFLT) (layer->initialAttenuation +
+                             split->initialAttenuation);
+      attenuation = POWER(FL(2.0), (-FL(1.0)/FL(60.0)) * attenuation )
+        * GLOBAL_ATTENUATION;
+      pan = (double)(split->pan + layer->pan) / 1000.0 + 0.5;
+      if (pan > 1.0) pan = 1.0;
+      else if (pan < 0.0) pan = 0.0;
+      p->sBase[spltNum] = sBase;
+      p->sstart[spltNum] = start;
+      p->end[spltNum] = sample->dwEnd + split->endOffset;
+      p->leftlevel[spltNum] = (MYFLT) sqrt(1.0-pan) * attenuation;
+      p->rightlevel[spltNum] = (MYFLT) sqrt(pan) * attenuation;
+      spltNum++;
     }
   p->spltNum = spltNum;
   if (*p->ifn2 != 0) p->efunc = csound->FTnp2Finde(csound, p->ifn2);
@@ -29,6 +29,7 @@
 
 #include "stdopcod.h"
 #include "uggab.h"
+#include "ftmipmap.h"
 #include <math.h>
 
 static int32_t wrap(CSOUND *csound, WRAP *p)
@@ -234,9 +235,57 @@ static int32_t anterpol(CSOUND *csound, INTERPOL *p)
 
 /* Oscilators */
 
+/* band-limited poscil and poscil3, reading the levels of the table
+   at the fixed point equivalent of the phase; the a-rate routines hand
+   over to it while p->mip is set */
+
+static int32_t poscbl(CSOUND *csound, POSC *p)
+{
+    FTMIPMAP    *mip = p->mip;
+    MYFLT       *out = p->out, *amp = p->amp, *freq = p->freq, w;
+    double      phs = p->phs, si, tomax;
+    int32_t     k, order = p->order;
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t n, nsmps = CS_KSMPS;
+
+    IGN(csound);
+    tomax = FMAXLEN / (double) p->tablen;
+    if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&out[nsmps], '\0', early*sizeof(MYFLT));
+    }
+    si = *freq * p->tablenUPsr;
+    k = ftmip_level(mip, si, &w);
+    for (n=offset; n<nsmps; n++) {
+      if (p->cpscod) {
+        si = freq[n] * p->tablenUPsr;
+        k = ftmip_level(mip, si, &w);
+      }
+      out[n] = amp[p->ampcod ? n : 0] *
+               ftmip_mix(mip, k, w, (int32) (phs * tomax) & PHMASK, order);
+      phs += si;
+      while (UNLIKELY(phs >= p->tablen))
+        phs -= p->tablen;
+      while (UNLIKELY(phs < 0.0 ))
+        phs += p->tablen;
+    }
+    p->phs = phs;
+    return OK;
+}
+
+static int32_t poscbl_deinit(CSOUND *csound, void *p)
+{
+    ftmipmap_release(csound, ((POSC*) p)->mip);
+    ((POSC*) p)->mip = NULL;
+    return OK;
+}
+
 static int32_t posc_set(CSOUND *csound, POSC *p)
 {
     FUNC *ftp;
+    int  held = (p->mip != NULL);   /* from an earlier pass of a reinit */
 
     if (UNLIKELY((ftp = csound->FTnp2Find(csound, p->ift)) == NULL))
       return csound->InitError(csound, Str("table not found in poscil"));
@@ -247,6 +296,27 @@ static int32_t posc_set(CSOUND *csound, POSC *p)
       p->phs      = *p->iphs * p->tablen;
     while (UNLIKELY(p->phs >= p->tablen))
       p->phs     -= p->tablen;
+    ftmipmap_release(csound, p->mip);
+    p->mip = NULL;
+    if (p->ibl != NULL && *p->ibl != FL(0.0)) {
+      if (UNLIKELY((p->mip = csound->FTMipMap(csound, ftp)) == NULL))
+        return csound->InitError(csound, Str("table %d cannot be band-limited "
+                                             "(not a mono table with a power "
+                                             "of two size)"), ftp->fno);
+      if (!held)
+        csound->RegisterDeinitCallback(csound, p, poscbl_deinit);
+      p->order = 1;
+      p->ampcod = IS_ASIG_ARG(p->amp) ? 1 : 0;
+      p->cpscod = IS_ASIG_ARG(p->freq) ? 1 : 0;
+    }
+    return OK;
+}
+
+static int32_t posc3_set(CSOUND *csound, POSC *p)
+{
+    if (UNLIKELY(posc_set(csound, p) != OK))
+      return NOTOK;
+    p->order = 3;
     return OK;
 }
 
@@ -262,6 +332,8 @@ static int32_t posckk(CSOUND *csound, POSC *p)
     uint32_t n, nsmps = CS_KSMPS;
     MYFLT       amp = *p->amp;
 
+    if (p->mip != NULL)
+      return poscbl(csound, p);
     if (UNLIKELY(ftp==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("poscil: not initialised"));
@@ -293,6 +365,8 @@ static int32_t poscaa(CSOUND *csound, POSC *p)
     uint32_t n, nsmps = CS_KSMPS;
     MYFLT       *amp = p->amp; /*gab c3*/
 
+    if (p->mip != NULL)
+      return poscbl(csound, p);
     if (UNLIKELY(ftp==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("poscil: not initialised"));
@@ -330,6 +404,8 @@ static int32_t poscka(CSOUND *csound, POSC *p)
     MYFLT       amp = *p->amp;
     MYFLT       *freq = p->freq;
 
+    if (p->mip != NULL)
+      return poscbl(csound, p);
     if (UNLIKELY(ftp==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("poscil: not initialised"));
@@ -367,6 +443,8 @@ static int32_t poscak(CSOUND *csound, POSC *p)
     uint32_t n, nsmps = CS_KSMPS;
     MYFLT       *amp = p->amp; /*gab c3*/
 
+    if (p->mip != NULL)
+      return poscbl(csound, p);
     if (UNLIKELY(ftp==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("poscil: not initialised"));
@@ -423,6 +501,8 @@ static int32_t posc3kk(CSOUND *csound, POSC *p)
     int32_t     x0;
     MYFLT       y0, y1, ym1, y2;
 
+    if (p->mip != NULL)
+      return poscbl(csound, p);
     if (UNLIKELY(ftp==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("poscil3: not initialised"));
@@ -478,6 +558,8 @@ static int32_t posc3ak(CSOUND *csound, POSC *p)
     int32_t     x0;
     MYFLT       y0, y1, ym1, y2;
 
+    if (p->mip != NULL)
+      return poscbl(csound, p);
     if (UNLIKELY(ftp==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("poscil3: not initialised"));
@@ -534,6 +616,8 @@ static int32_t posc3ka(CSOUND *csound, POSC *p)
     int32_t     x0;
     MYFLT       y0, y1, ym1, y2;
 
+    if (p->mip != NULL)
+      return poscbl(csound, p);
     if (UNLIKELY(ftp==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("poscil3: not initialised"));
@@ -591,6 +675,8 @@ static int32_t posc3aa(CSOUND *csound, POSC *p)
     int32_t     x0;
     MYFLT       y0, y1, ym1, y2;
 
+    if (p->mip != NULL)
+      return poscbl(csound, p);
     if (UNLIKELY(ftp==NULL))
       return csound->PerfError(csound, &(p->h),
                                Str("poscil3: not initialised"));
@@ -2130,20 +2216,20 @@ static OENTRY localops[] = {
 { "duserrnd.a", S(DURAND),0,2, "a", "k",
                                 (SUBR)Cuserrnd_set,(SUBR)aDiscreteUserRand },
 //{ "poscil", 0xfffe, TR                                                          },
-{ "poscil.a", S(POSC), TR,3, "a", "kkjo", (SUBR)posc_set,(SUBR)posckk },
+{ "poscil.a", S(POSC), TR,3, "a", "kkjoo", (SUBR)posc_set,(SUBR)posckk },
 { "poscil.kk", S(POSC), TR,3, "k", "kkjo", (SUBR)posc_set,(SUBR)kposc,NULL },
-{ "poscil.ka", S(POSC), TR,3, "a", "kajo", (SUBR)posc_set,  (SUBR)poscka },
-{ "poscil.ak", S(POSC), TR,3, "a", "akjo", (SUBR)posc_set,  (SUBR)poscak },
-{ "poscil.aa", S(POSC), TR,3, "a", "aajo", (SUBR)posc_set,  (SUBR)poscaa },
+{ "poscil.ka", S(POSC), TR,3, "a", "kajoo", (SUBR)posc_set,  (SUBR)poscka },
+{ "poscil.ak", S(POSC), TR,3, "a", "akjoo", (SUBR)posc_set,  (SUBR)poscak },
+{ "poscil.aa", S(POSC), TR,3, "a", "aajoo", (SUBR)posc_set,  (SUBR)poscaa },
 { "lposcil",  S(LPOSC), TR, 3, "a", "kkkkjo", (SUBR)lposc_set, (SUBR)lposc},
 //{ "poscil3", 0xfffe, TR                                                     },
-{ "poscil3.a",S(POSC), TR,3, "a", "kkjo",
-                                     (SUBR)posc_set,(SUBR)posc3kk },
+{ "poscil3.a",S(POSC), TR,3, "a", "kkjoo",
+                                     (SUBR)posc3_set,(SUBR)posc3kk },
 { "poscil3.kk",S(POSC), TR,3, "k", "kkjo",
                                      (SUBR)posc_set,(SUBR)kposc3,NULL},
-{ "poscil3.ak", S(POSC), TR,3, "a", "akjo", (SUBR)posc_set, (SUBR)posc3ak },
-{ "poscil3.ka", S(POSC), TR,3, "a", "kajo", (SUBR)posc_set, (SUBR)posc3ka },
-{ "poscil3.aa", S(POSC), TR,3, "a", "aajo", (SUBR)posc_set, (SUBR)posc3aa },
+{ "poscil3.ak", S(POSC), TR,3, "a", "akjoo", (SUBR)posc3_set, (SUBR)posc3ak },
+{ "poscil3.ka", S(POSC), TR,3, "a", "kajoo", (SUBR)posc3_set, (SUBR)posc3ka },
+{ "poscil3.aa", S(POSC), TR,3, "a", "aajoo", (SUBR)posc3_set, (SUBR)posc3aa },
 { "lposcil3", S(LPOSC), TR, 3, "a", "kkkkjo", (SUBR)lposc_set,(SUBR)lposc3},
 { "trigger",  S(TRIG),  0,3, "k", "kkk",  (SUBR)trig_set, (SUBR)trig,   NULL  },
 { "sum",      S(SUM),   0,3, "a", "y",    (SUBR)sum_init, (SUBR)sum_               },
@@ -46,11 +46,13 @@ typedef struct {
 
 typedef struct  {
     OPDS        h;
-    MYFLT       *out, *amp, *freq, *ift, *iphs;
+    MYFLT       *out, *amp, *freq, *ift, *iphs, *ibl;
     FUNC        *ftp;
     int32       tablen;
     double      tablenUPsr;
     double      phs;
+    FTMIPMAP    *mip;           /* band-limited mode */
+    int16       order, ampcod, cpscod;
 } POSC;
 
 typedef struct  {
@@ -58,6 +58,11 @@
 #include "pvfileio.h"
 #include "fftlib.h"
 #include "lpred.h"
+#include "resample.h"
+#include "housekeep.h"
+#include "oscbank.h"
+#include "ftmipmap.h"
+#include "delayline.h"
 #include "cs_par_base.h"
 #include "cs_par_orc_semantics.h"
 #include "namedins.h"
@@ -87,6 +92,8 @@ static int  defaultCsoundYield(CSOUND *);
 static int  csoundDoCallback_(CSOUND *, void *, unsigned int);
 static void reset(CSOUND *);
 static int  csoundPerformKsmpsInternal(CSOUND *csound);
+static int  csoundPerformKsmpsInCallback(CSOUND *csound);
+static int  exitjmp_value(CSOUND *csound, int returnValue, const char *msg);
 void csoundTableSetInternal(CSOUND *csound, int table, int index,
                                    MYFLT value);
 static INSTRTXT **csoundGetInstrumentList(CSOUND *csound);
@@ -109,8 +116,6 @@ INSTRTXT *csoundGetInstrument(CSOUND *csound, int insno, const char *name);
 void csoundDebuggerBreakpointReached(CSOUND *csound);
 void message_dequeue(CSOUND *csound);
 
-extern OENTRY opcodlst_1[];
-
 #define STRING_HASH(arg) STRSH(arg)
 #define STRSH(arg) #arg
 
@@ -179,20 +184,12 @@ static void free_opcode_table(CSOUND* csound) {
 }
 static void create_opcode_table(CSOUND *csound)
 {
-
-    int err;
-
     if (csound->opcodes != NULL) {
       free_opcode_table(csound);
     }
+    /* Basic Entry1 stuff lives in the shared table built by
+       csoundInitialize(); this one only holds appended opcodes */
     csound->opcodes = cs_hash_table_create(csound);
-
-    /* Basic Entry1 stuff */
-    err = csoundAppendOpcodes(csound, &(opcodlst_1[0]), -1);
-
-    if (UNLIKELY(err))
-      csoundDie(csound, Str("Error allocating opcode list"));
-
 }
 
 #define MAX_MODULES 64
@@ -536,10 +533,29 @@ static const CSOUND cenviron_ = {
     csoundCepsLP,
     csoundLPrms,
     csoundCreateThread2,
+    csoundPerformKsmpsInCallback,
+    csoundSetExternalMidiReadTimedCallback,
+    csoundResamplerCreate,
+    csoundResample,
+    csoundResamplerFrames,
+    csoundResamplerCoefs,
+    csoundResamplerDestroy,
+    csoundWriteCircularBufferReserve,
+    csoundWriteCircularBufferCommit,
+    csoundReadCircularBufferReserve,
+    csoundReadCircularBufferCommit,
+    csoundOscBankCreate,
+    csoundOscBankSet,
+    csoundOscBankMove,
+    csoundOscBankRun,
+    csoundFTGenAsync,
+    csoundFTGenReady,
+    csoundFTMipMap,
+    csoundDelayLineCreate,
+    csoundDelayLineWrite,
+    csoundDelayLineRead,
     {
-      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-      NULL, NULL
+      NULL
     },
     /* ------- private data (not to be used by hosts or externals) ------- */
     /* callback function pointers */
@@ -1020,7 +1036,17 @@ static const CSOUND cenviron_ = {
     0,              /* mode */
     NULL,           /* opcodedir */
     NULL,           /* score_srt */
-    0               /* mp3 mode */
+    0,              /* mp3 mode */
+    NULL,           /* housekeep */
+    0,              /* housekeep_kcnt */
+    HOUSEKEEP_IDLE, /* housekeep_idle */
+    HOUSEKEEP_KEEP, /* housekeep_keep */
+    NULL,           /* file_uring */
+    NULL,           /* file_index */
+    SPINLOCK_INIT,  /* open_files_lock */
+    NULL,           /* fgens_async */
+    NULL,           /* memalloc_maps */
+    NULL            /* ft_mipmaps */
 };
 
 void csound_aops_init_tables(CSOUND *cs);
@@ -1307,7 +1333,7 @@ PUBLIC int csoundInitialize(int flags)
     } while (n);
     init_done = 2;
     csoundUnLock();
-    if (getTimeResolution() != 0) {
+    if (getTimeResolution() != 0 || init_static_opcode_table() != 0) {
       csoundLock();
       init_done = -1;
       csoundUnLock();
@@ -1728,6 +1754,13 @@ int kperf_nodebug(CSOUND *csound)
    /* call message_dequeue to run API calls */
     message_dequeue(csound);
 
+    /* reclaim idle instances, once a second */
+    if (UNLIKELY(--csound->housekeep_kcnt <= 0))
+      csoundHousekeep(csound);
+    /* list the tables generated in the background */
+    if (UNLIKELY(csound->fgens_async != NULL))
+      csoundFTGenPublish(csound);
+
 
     /* if skipping time on request by 'a' score statement: */
     if (UNLIKELY(UNLIKELY(csound->advanceCnt))) {
@@ -1977,6 +2010,10 @@ int kperf_debug(CSOUND *csound)
       csound->kcounter = ++(csound->global_kcounter);
       csound->icurTime += csound->ksmps;
       csound->curBeat += csound->curBeat_inc;
+      if (UNLIKELY(--csound->housekeep_kcnt <= 0))
+        csoundHousekeep(csound);
+      if (UNLIKELY(csound->fgens_async != NULL))
+        csoundFTGenPublish(csound);
     }
 
     /* if skipping time on request by 'a' score statement: */
@@ -2249,12 +2286,9 @@ static int csoundPerformKsmpsInternal(CSOUND *csound)
       return CSOUND_ERROR;
     }
     /* setup jmp for return after an exit() */
-        if (UNLIKELY((returnValue = setjmp(csound->exitjmp)))) {
-#ifndef MACOSX
-      csoundMessage(csound, Str("Early return from csoundPerformKsmps().\n"));
-#endif
-      return ((returnValue - CSOUND_EXITJMP_SUCCESS) | CSOUND_EXITJMP_SUCCESS);
-    }
+    if (UNLIKELY((returnValue = setjmp(csound->exitjmp))))
+      return exitjmp_value(csound, returnValue,
+                           Str("Early return from csoundPerformKsmps().\n"));
    do {
      if (UNLIKELY((done = sensevents(csound)))) {
        csoundMessage(csound,
@@ -2265,6 +2299,62 @@ static int csoundPerformKsmpsInternal(CSOUND *csound)
     return 0;
 }
 
+/* The performance run by csoundPerformKsmpsInCallback() ended with value:
+   the parked thread unwinds to its performance function, which returns
+   value as if the performance had ended there */
+static int callback_end(CSOUND *csound, int value)
+{
+    csound->cb_value = value;
+    csound->cb_ended = 1;
+    return value;
+}
+
+/* value to return from a performance function after an exit jump */
+static int exitjmp_value(CSOUND *csound, int returnValue, const char *msg)
+{
+    if (csound->cb_ended) {
+      csound->cb_ended = 0;
+      return csound->cb_value;
+    }
+#ifndef MACOSX
+    csoundMessage(csound, "%s", msg);
+#else
+    IGN(msg);
+#endif
+    return ((returnValue - CSOUND_EXITJMP_SUCCESS) | CSOUND_EXITJMP_SUCCESS);
+}
+
+/* Perform one control period from an audio module's process callback,
+   while the performance thread is parked inside that module (see the
+   callback mode of rtjack).  No API lock is taken, so this is only used
+   in realtime mode, and the exit jump buffer of the parked thread is
+   restored on return so that it can still unwind its own stack. */
+static int csoundPerformKsmpsInCallback(CSOUND *csound)
+{
+    jmp_buf saved;
+    int     done = 0;
+    int     returnValue;
+
+    /* csoundStop() cannot reach the parked thread, so honour it here */
+    if (UNLIKELY(csound->performState))
+      return callback_end(csound, 1);
+    memcpy(saved, csound->exitjmp, sizeof(jmp_buf));
+    if (UNLIKELY((returnValue = setjmp(csound->exitjmp)))) {
+      memcpy(csound->exitjmp, saved, sizeof(jmp_buf));
+      return callback_end(csound, ((returnValue - CSOUND_EXITJMP_SUCCESS)
+                                   | CSOUND_EXITJMP_SUCCESS));
+    }
+    do {
+      if (UNLIKELY((done = sensevents(csound)))) {
+        csoundMessage(csound, Str("Score finished in the audio callback.\n"));
+        memcpy(csound->exitjmp, saved, sizeof(jmp_buf));
+        return callback_end(csound, done);
+      }
+    } while (csound->kperf(csound));
+    memcpy(csound->exitjmp, saved, sizeof(jmp_buf));
+    return 0;
+}
+
 /* external host's outbuffer passed in csoundPerformBuffer() */
 PUBLIC int csoundPerformBuffer(CSOUND *csound)
 {
@@ -2278,12 +2368,9 @@ PUBLIC int csoundPerformBuffer(CSOUND *csound)
       return CSOUND_ERROR;
     }
     /* Setup jmp for return after an exit(). */
-    if (UNLIKELY((returnValue = setjmp(csound->exitjmp)))) {
-#ifndef MACOSX
-      csoundMessage(csound, Str("Early return from csoundPerformBuffer().\n"));
-#endif
-      return ((returnValue - CSOUND_EXITJMP_SUCCESS) | CSOUND_EXITJMP_SUCCESS);
-    }
+    if (UNLIKELY((returnValue = setjmp(csound->exitjmp))))
+      return exitjmp_value(csound, returnValue,
+                           Str("Early return from csoundPerformBuffer().\n"));
     csound->sampsNeeded += csound->oparms_.outbufsamps;
     while (csound->sampsNeeded > 0) {
      if(!csound->oparms->realtime) {// no API lock in realtime mode
@@ -2321,12 +2408,9 @@ PUBLIC int csoundPerform(CSOUND *csound)
 
     csound->performState = 0;
     /* setup jmp for return after an exit() */
-    if (UNLIKELY((returnValue = setjmp(csound->exitjmp)))) {
-#ifndef MACOSX
-      csoundMessage(csound, Str("Early return from csoundPerform().\n"));
-#endif
-      return ((returnValue - CSOUND_EXITJMP_SUCCESS) | CSOUND_EXITJMP_SUCCESS);
-    }
+    if (UNLIKELY((returnValue = setjmp(csound->exitjmp))))
+      return exitjmp_value(csound, returnValue,
+                           Str("Early return from csoundPerform().\n"));
     do {
         if(!csound->oparms->realtime)
            csoundLockMutex(csound->API_lock);
@@ -3109,6 +3193,16 @@ PUBLIC void csoundSetExternalMidiReadCallback(CSOUND *csound,
                                                           unsigned char *, int))
 {
     csound->midiGlobals->MidiReadCallback = func;
+    csound->midiGlobals->MidiReadTimedCallback = NULL;
+}
+
+PUBLIC void csoundSetExternalMidiReadTimedCallback(CSOUND *csound,
+                                                   int (*func)(CSOUND *,
+                                                               void *,
+                                                               unsigned char *,
+                                                               int, int *))
+{
+    csound->midiGlobals->MidiReadTimedCallback = func;
 }
 
 PUBLIC void csoundSetExternalMidiInCloseCallback(CSOUND *csound,
@@ -3203,7 +3297,8 @@ static CS_NOINLINE int opcode_list_new_oentry(CSOUND *csound,
 
     shortName = get_opcode_short_name(csound, ep->opname);
 
-    head = cs_hash_table_get(csound, csound->opcodes, shortName);
+    /* built-in overloads of this name are copied in first */
+    head = materialise_opcode_entries(csound, shortName);
     entryCopy = csound->Malloc(csound, sizeof(OENTRY));
     //printf("%p\n", entryCopy);
     memcpy(entryCopy, ep, sizeof(OENTRY));
@@ -4146,6 +4241,37 @@ int csoundDeinitialiseOpcodes(CSOUND *csound, INSDS *ip)
     return err;
 }
 
+/* called from deact_batch() in insert.c, with a list of instances linked */
+/* through nxtoff and sorted by instrument: the callbacks of all instances */
+/* of an instrument are run in turn, one of each instance at a time, so   */
+/* that those of the same opcode run together, while each instance keeps  */
+/* the order of its own callbacks                                         */
+
+int csoundDeinitialiseOpcodesBatch(CSOUND *csound, INSDS *list)
+{
+    INSDS   *grp, *end, *ip;
+    int     err = 0, more;
+
+    for (grp = list; grp != NULL; grp = end) {
+      end = grp->nxtoff;
+      while (end != NULL && end->insno == grp->insno)
+        end = end->nxtoff;
+      do {
+        more = 0;
+        for (ip = grp; ip != end; ip = ip->nxtoff) {
+          opcodeDeinit_t  *dp = (opcodeDeinit_t*) ip->nxtd;
+          if (dp == NULL)
+            continue;
+          err |= dp->func(csound, dp->p);
+          ip->nxtd = (void*) dp->nxt;
+          free(dp);
+          more |= (ip->nxtd != NULL);
+        }
+      } while (more);
+    }
+    return err;
+}
+
 /**
  * Returns the name of the opcode of which the data structure
  * is pointed to by 'p'.
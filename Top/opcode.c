@@ -73,7 +73,7 @@ PUBLIC int csoundNewOpcodeList(CSOUND *csound, opcodeListEntry **lstp)
     if (UNLIKELY(csound->opcodes == NULL))
       return -1;
 
-    head = items = cs_hash_table_values(csound, csound->opcodes);
+    head = items = opcode_table_values(csound);
 
     /* count the number of opcodes, and bytes to allocate */
     while (items != NULL) {
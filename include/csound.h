@@ -540,6 +540,22 @@ extern "C" {
     int isOutput;
   } CS_MIDIDEVICE;
 
+  /**
+   * Instance memory statistics, see csoundGetMemoryStats()
+   */
+  typedef struct {
+    /** instrument instances currently allocated, active or free */
+    uint64_t instances;
+    /** highest number of instances allocated at once */
+    uint64_t instances_peak;
+    /** instances freed since the start of performance */
+    uint64_t instances_reclaimed;
+    /** bytes of opcode (AUXCH) memory freed with them */
+    uint64_t bytes_reclaimed;
+    /** deleted function tables freed */
+    uint64_t tables_reclaimed;
+  } CS_MEMORY_STATS;
+
 
   /**
    * Real-time audio parameters structure
@@ -1090,6 +1106,23 @@ extern "C" {
    */
   PUBLIC MYFLT csoundSystemSr(CSOUND *csound, MYFLT val);
 
+  /**
+   * Fills in 'stats' with the number of instrument instances allocated
+   * and reclaimed so far. Returns CSOUND_SUCCESS, or CSOUND_ERROR if
+   * 'stats' is NULL.
+   */
+  PUBLIC int csoundGetMemoryStats(CSOUND *, CS_MEMORY_STATS *stats);
+
+  /**
+   * Sets how inactive instrument instances are reclaimed during
+   * performance: once a second, free instances idle for more than 'idle'
+   * seconds are released by a background thread, keeping at least 'keep'
+   * of them (or the number given to prealloc) for each instrument.
+   * An idle time of zero or less disables this. The defaults are 10
+   * seconds and 1 instance; they are restored by csoundReset().
+   */
+  PUBLIC void csoundSetHousekeeping(CSOUND *, double idle, int keep);
+
 
   /** @}*/
   /** @defgroup FILEIO General Input/Output
@@ -1421,6 +1454,24 @@ extern "C" {
                                                             unsigned char *buf,
                                                             int nBytes));
 
+  /**
+   * Sets callback for reading timestamped real time MIDI input.
+   * The callback works like the one set by
+   * csoundSetExternalMidiReadCallback(), and in addition stores in
+   * age[i] the number of sample frames elapsed between the arrival of
+   * buf[i] and the call, or -1 if unknown. When --sample-accurate is
+   * enabled, note-ons are then started at the matching sample of the
+   * k-cycle, delaying input by at most one k-period but removing the
+   * ksmps jitter. If set, it is used instead of the plain read callback;
+   * setting the plain read callback clears it.
+   */
+  PUBLIC void csoundSetExternalMidiReadTimedCallback(CSOUND *,
+                                                     int (*func)(CSOUND *,
+                                                                 void *userData,
+                                                                 unsigned char *buf,
+                                                                 int nBytes,
+                                                                 int *age));
+
   /**
    * Sets callback for closing real time MIDI input.
    */
@@ -2405,6 +2456,15 @@ extern "C" {
    */
   PUBLIC int csoundSetGlobalEnv(const char *name, const char *value);
 
+  /**
+   * Forget the listings of the directories searched for input files,
+   * and the file names resolved through them. Input files are looked up
+   * in these listings, which are kept up to date with inotify on Linux;
+   * elsewhere, or after changing the working directory, this makes new
+   * files shadowing others in the search paths visible.
+   */
+  PUBLIC void csoundClearFileCache(CSOUND *csound);
+
   /**
    * Allocate nbytes bytes of memory that can be accessed later by calling
    * csoundQueryGlobalVariable() with the specified name; the space is
@@ -2552,6 +2612,59 @@ extern "C" {
    */
   PUBLIC void csoundFlushCircularBuffer(CSOUND *csound, void *p);
 
+  /**
+   * A region of a circular buffer, made of up to two contiguous spans
+   * (the second one when the region wraps around the end of the buffer).
+   */
+  typedef struct {
+    /** start of each span, NULL if unused */
+    void *data[2];
+    /** number of elements in each span */
+    int  items[2];
+  } CS_CIRCULAR_REGION;
+
+  /**
+   * Get a region of up to items free elements of a circular buffer, to be
+   * filled in place and then made available to the reader with
+   * csoundWriteCircularBufferCommit(). Only the writer may call this.
+   * @param csound This value is currently ignored.
+   * @param p pointer to an existing circular buffer
+   * @param items number of elements wanted
+   * @param region filled with the spans of the writable region
+   * @returns the number of elements in the region (0 <= n <= items)
+   */
+  PUBLIC int csoundWriteCircularBufferReserve(CSOUND *csound, void *p,
+                                              int items,
+                                              CS_CIRCULAR_REGION *region);
+
+  /**
+   * Make the first items elements of the region returned by the last
+   * csoundWriteCircularBufferReserve() available to the reader.
+   */
+  PUBLIC void csoundWriteCircularBufferCommit(CSOUND *csound, void *p,
+                                              int items);
+
+  /**
+   * Get a region of up to items elements available for reading from a
+   * circular buffer, to be used in place and then released with
+   * csoundReadCircularBufferCommit(). Only the reader may call this.
+   * @param csound This value is currently ignored.
+   * @param p pointer to an existing circular buffer
+   * @param items number of elements wanted
+   * @param region filled with the spans of the readable region
+   * @returns the number of elements in the region (0 <= n <= items)
+   */
+  PUBLIC int csoundReadCircularBufferReserve(CSOUND *csound, void *p,
+                                             int items,
+                                             CS_CIRCULAR_REGION *region);
+
+  /**
+   * Remove the first items elements of the region returned by the last
+   * csoundReadCircularBufferReserve() from the buffer.
+   */
+  PUBLIC void csoundReadCircularBufferCommit(CSOUND *csound, void *p,
+                                             int items);
+
   /**
    * Free circular buffer
    */
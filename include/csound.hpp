@@ -934,6 +934,19 @@ public:
   virtual MYFLT SystemSr(MYFLT value) {
     return csoundSystemSr(csound, value);
   }
+  virtual void SetExternalMidiReadTimedCallback(
+      int (*func)(CSOUND *, void *, unsigned char *, int, int *))
+  {
+    csoundSetExternalMidiReadTimedCallback(csound, func);
+  }
+  virtual int GetMemoryStats(CS_MEMORY_STATS *stats)
+  {
+    return csoundGetMemoryStats(csound, stats);
+  }
+  virtual void SetHousekeeping(double idle, int keep)
+  {
+    csoundSetHousekeeping(csound, idle, keep);
+  }
 };
 
 class CsoundThreadLock {
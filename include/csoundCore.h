@@ -207,6 +207,19 @@ extern int ISSTRCOD(MYFLT);
 #define CS_TIMEMSG 0x80
 #define CS_NOQQ    0x400
 
+/* MODES OF OscBankSet() */
+#define CS_OSCBANK_GLIDE 0      /* linear frequency glide */
+#define CS_OSCBANK_PHASE 1      /* cubic phase interpolation */
+#define CS_OSCBANK_START 2      /* restart at a given phase */
+
+/* INTERPOLATION OF DelayLineRead() */
+#define CS_DELAY_NONE    0      /* integer part of the delay */
+#define CS_DELAY_LINEAR  1
+#define CS_DELAY_CUBIC   3      /* 4 point Lagrange */
+#define CS_DELAY_SINC    4      /* windowed sinc of vdelayx and deltapx */
+#define CS_DELAY_CUBICX  5      /* CS_DELAY_CUBIC in double, as deltapx */
+#define CS_DELAY_MAXWIN  1024   /* longest sinc window */
+
 #define IGN(X)  (void) X
 
 #define ARG_CONSTANT 0
@@ -218,6 +231,7 @@ extern int ISSTRCOD(MYFLT);
 
 #define ASYNC_GLOBAL 1
 #define ASYNC_LOCAL  2
+#define ASYNC_URING  3
 
 enum {FFT_LIB=0, PFFT_LIB, VDSP_LIB};
 enum {FFT_FWD=0, FFT_INV};
@@ -353,6 +367,7 @@ typedef struct CORFIL {
     int     instcnt;                /* Count number of instances ever */
     int     isNew;                  /* is this a new definition */
     int     nocheckpcnt;            /* Control checks on pcnt */
+    int     nkeep;                  /* free instances kept by housekeeping */
   } INSTRTXT;
 
   typedef struct namedInstr {
@@ -692,11 +707,65 @@ typedef struct CORFIL {
     MYFLT   *ftable;
   } FUNC;
 
+  /** one band-limited copy of a function table (see FTMipMap()) */
+  typedef struct {
+    /** length, a power of two; ftable[-1] to ftable[flen + 2] are valid */
+    int32   flen;
+    /** log2(MAXLEN / flen), 2^lobits - 1 */
+    int32   lobits, lomask;
+    /** 1 / 2^lobits */
+    MYFLT   lodiv;
+    MYFLT   *ftable;
+  } FTMIPLEVEL;
+
+  /** octave-spaced band-limited copies of a function table */
+  typedef struct {
+    /** the table they were made from */
+    FUNC    *ftp;
+    /** number of levels: level k holds the harmonics up to
+        ftp->flen >> (k + 1), level 0 the table as it is */
+    int32   nlevels;
+    FTMIPLEVEL level[32];
+  } FTMIPMAP;
+
+  /** delay line of DelayLineCreate() */
+  typedef struct {
+    /** size samples, a power of two; mask = size - 1 */
+    MYFLT   *buf;
+    int32   size, mask;
+    /** delays are taken modulo len, as in a circular buffer of len */
+    int32   len;
+    /** where the next sample is written */
+    int32   wpos;
+  } CS_DELAYLINE;
+
+  /** one tap of DelayLineRead() */
+  typedef struct {
+    /** output, set to gain * tap, or added to if add is non-zero */
+    MYFLT   *out;
+    /** delay, one value for the block or one per sample if arate */
+    MYFLT   *del;
+    /** samples per unit of del */
+    MYFLT   scale, gain;
+    int16   arate, add;
+  } CS_DELAYTAP;
+
+  /** a table read by a GEN routine, looked up before it runs */
+  typedef struct {
+    int     fno;
+    FUNC    *ftp;
+  } FTSRC;
+
   typedef struct {
     CSOUND  *csound;
     int32   flen;
     int     fno, guardreq;
     EVTBLK  e;
+    /** table generated in the background, or NULL to use flist[fno] */
+    FUNC    **bg;
+    /** the tables it may read, if generated in the background */
+    const FTSRC *src;
+    int     nsrc;
   } FGDATA;
 
   typedef struct {
@@ -719,6 +788,7 @@ typedef struct CORFIL {
     int16   chan;
     int16   dat1;
     int16   dat2;
+    int32   ofs;            /* sample offset in the k-cycle */
   } MEVENT;
 
   typedef struct SNDMEMFILE_ {
@@ -828,6 +898,9 @@ typedef struct CORFIL {
     unsigned char mbuf[MBUFSIZ];
     unsigned char *bufp, *endatp;
     int16   datreq, datcnt;
+    int     (*MidiReadTimedCallback)(CSOUND *, void *, unsigned char *, int,
+                                     int *);
+    int     mage[MBUFSIZ];  /* age in samples of each byte in mbuf */
   } MGLOBAL;
 
   typedef struct eventnode {
@@ -1410,11 +1483,44 @@ typedef struct _message_queue_t_ {
     MYFLT* (*CepsLP)(CSOUND *, MYFLT *, MYFLT *, int, int);
     MYFLT (*LPrms)(CSOUND *, void *);
     void *(*CreateThread2)(uintptr_t (*threadRoutine)(void *), unsigned int, void *userdata);
+    int (*PerformKsmpsInCallback)(CSOUND *);
+    void (*SetExternalMidiReadTimedCallback)(CSOUND *,
+                int (*func)(CSOUND *, void *, unsigned char *, int, int *));
+    void *(*ResamplerCreate)(CSOUND *, MYFLT insr, MYFLT outsr,
+                             int nchnls, int quality);
+    int (*Resample)(CSOUND *, void *, int chn, const MYFLT *in, int nin,
+                    MYFLT *out);
+    int (*ResamplerFrames)(CSOUND *, void *, int nin);
+    int (*ResamplerCoefs)(CSOUND *, void *, double frac, MYFLT *coefs);
+    void (*ResamplerDestroy)(CSOUND *, void *);
+    int (*WriteCircularBufferReserve)(CSOUND *, void *, int,
+                                      CS_CIRCULAR_REGION *);
+    void (*WriteCircularBufferCommit)(CSOUND *, void *, int);
+    int (*ReadCircularBufferReserve)(CSOUND *, void *, int,
+                                     CS_CIRCULAR_REGION *);
+    void (*ReadCircularBufferCommit)(CSOUND *, void *, int);
+    void *(*OscBankCreate)(CSOUND *, AUXCH *aux, int count, int maxblock,
+                           FUNC *ftp);
+    void (*OscBankSet)(CSOUND *, void *bank, int n, MYFLT amp, MYFLT freq,
+                       MYFLT phase, int mode);
+    void (*OscBankMove)(CSOUND *, void *bank, int dst, int src);
+    void (*OscBankRun)(CSOUND *, void *bank, MYFLT *out, int nsmps,
+                       int count);
+    int (*FTGenAsync)(CSOUND *, const EVTBLK *, int mode);
+    int (*FTGenReady)(CSOUND *, int fno);
+    FTMIPMAP *(*FTMipMap)(CSOUND *, FUNC *ftp);
+    CS_DELAYLINE *(*DelayLineCreate)(CSOUND *, AUXCH *aux, int count,
+                                     const int32 *len, int32 maxblock);
+    void (*DelayLineWrite)(CSOUND *, CS_DELAYLINE *line, const MYFLT *in,
+                           int32 nsmps);
+    void (*DelayLineRead)(CSOUND *, CS_DELAYLINE *line,
+                          const CS_DELAYTAP *taps, int ntaps, int32 start,
+                          int32 offset, int32 nsmps, int interp, int wsize);
     /**@}*/
     /** @name Placeholders
         To allow the API to grow while maintining backward binary compatibility. */
     /**@{ */
-    SUBR dummyfn_2[22];
+    SUBR dummyfn_2[1];
     /**@}*/
 #ifdef __BUILDING_LIBCSOUND
     /* ------- private data (not to be used by hosts or externals) ------- */
@@ -1839,6 +1945,18 @@ typedef struct _message_queue_t_ {
     char *opcodedir;
     char *score_srt;
     int mp3_mode;
+    void *housekeep;              /* housekeeping thread state */
+    int housekeep_kcnt;           /* k-cycles to next housekeeping pass */
+    double housekeep_idle;        /* age in seconds of reclaimed instances */
+    int housekeep_keep;           /* free instances kept per instrument */
+    void *file_uring;             /* io_uring engine of async files */
+    void *file_index;             /* listings of the search directories */
+    spin_lock_t open_files_lock;  /* protects the chain of open files */
+    void *fgens_async;            /* background table generation */
+    void *memalloc_maps;          /* file mappings handed out as memory */
+    void *ft_mipmaps;             /* band-limited copies of tables */
+    int cb_ended;                 /* the performance ended in a callback */
+    int cb_value;                 /*   with this return value            */
     /*struct CSOUND_ **self;*/
     /**@}*/
 #endif  /* __BUILDING_LIBCSOUND */
@@ -32,4 +32,12 @@ PUBLIC OENTRY* find_opcode_exact(CSOUND* csound, char* opname,
 /* find OENTRY with the specified name in opcode list */
 
 OENTRY* find_opcode(CSOUND *, char *);
+
+/* shared built-in opcode table, layered under csound->opcodes */
+int init_static_opcode_table(void);
+CONS_CELL* find_static_opcode_entries(const char* shortName);
+int is_static_opcode_entry(const OENTRY* ep);
+CONS_CELL* find_opcode_entries(CSOUND* csound, char* shortName);
+CONS_CELL* materialise_opcode_entries(CSOUND* csound, char* shortName);
+CONS_CELL* opcode_table_values(CSOUND* csound);
 #endif
@@ -192,12 +192,7 @@ typedef struct {
         int32    maxosc;
         float   one_over_overlap,pi_over_sr, one_over_sr;
         float   fmod;
-        AUXCH   a;
-        AUXCH   x;
-        AUXCH   y;
-        AUXCH   amps;
-        AUXCH   lastamps;
-        AUXCH   freqs;
+        AUXCH   bank;           /* oscillator bank */
         AUXCH   outbuf;
 } PVADS;
 
@@ -241,6 +241,18 @@ typedef uint_least16_t uint16;
 #  endif
 #endif
 
+/* restrict qualifier: C99, or the spelling of GCC, Clang and MSVC in C++
+   and older C, or nothing                                               */
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L && \
+    !defined(__cplusplus)
+#  define CS_RESTRICT   restrict
+#elif defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#  define CS_RESTRICT   __restrict
+#else
+#  define CS_RESTRICT
+#endif
+
 #define DIRSEP '/'
 #ifdef WIN32
 #  undef  DIRSEP
@@ -0,0 +1,188 @@
+/*
+ * File:   array_arith_test.c
+ *
+ * Tests for the element-wise array arithmetic kernels and dotarray
+ * (Opcodes/arrays.c)
+ */
+
+#include <stdio.h>
+#include "csound.h"
+#include "CUnit/Basic.h"
+
+/* Each result array r is reported as r[0] + 10 r[1] + 100 r[2] + ... so
+   that one channel checks every element (and their order). */
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 16\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "opcode digits, k, k[]\n"
+    "  kR[] xin\n"
+    "  ks = 0\n"
+    "  kw = 1\n"
+    "  ki = 0\n"
+    "  while ki < lenarray(kR) do\n"
+    "    ks += kR[ki] * kw\n"
+    "    kw *= 10\n"
+    "    ki += 1\n"
+    "  od\n"
+    "  xout ks\n"
+    "endop\n"
+    "instr 1\n"
+    "  kA[] fillarray 1, 2, 3, 4\n"
+    "  kB[] fillarray 4, 3, 2, 1\n"
+    "  kS[] fillarray 1, 1\n"
+    "  kC[] = kA + kB\n"             /* not aliased */
+    "  chnset digits(kC), \"kadd\"\n"
+    "  kD[] = kA\n"
+    "  kD = kD - kB\n"               /* in place */
+    "  chnset digits(kD), \"ksubin\"\n"
+    "  kE[] = kA\n"
+    "  kE = kE + kE\n"               /* both operands are the output */
+    "  chnset digits(kE), \"kaliased\"\n"
+    "  kF[] = kA * kA\n"             /* both operands are the same */
+    "  chnset digits(kF), \"ksquare\"\n"
+    "  kG[] = kA * 12\n"
+    "  kG = kG / kB\n"
+    "  chnset digits(kG), \"kdiv\"\n"
+    "  kH[] = 12 / kA\n"
+    "  chnset digits(kH), \"krdiv\"\n"
+    "  kI[] = kB * 2 - 1\n"
+    "  chnset digits(kI), \"kscalar\"\n"
+    "  kJ[] = 5 - kA\n"
+    "  chnset digits(kJ), \"krsub\"\n"
+    "  chnset dotarray(kA, kB), \"kdot\"\n"
+    "  chnset dotarray(kA, kS), \"kdotshort\"\n"
+    "  chnset dotarray(kA, kA), \"kdotself\"\n"
+    "  iA[] fillarray 1, 2, 3, 4\n"
+    "  iB[] fillarray 4, 3, 2, 1\n"
+    "  iS[] fillarray 1, 1\n"
+    "  idot dotarray iA, iB\n"
+    "  idotshort dotarray iA, iS\n"
+    "  chnset idot, \"idot\"\n"
+    "  chnset idotshort, \"idotshort\"\n"
+    "  aA[] init 2\n"
+    "  aB[] init 2\n"
+    "  aone init 1\n"
+    "  aA[0] = aone\n"
+    "  aA[1] = aone * 2\n"
+    "  aB[0] = aone * 3\n"
+    "  aB[1] = aone * 4\n"
+    "  aC[] = aA + aB\n"
+    "  aC = aC + aC\n"               /* aliased, in place */
+    "  aD[] = aB / aA\n"
+    "  aE[] = aA * 2 - aB\n"
+    "  aF[] = aA\n"
+    "  aF += aB\n"
+    "  aF -= 1\n"
+    "  adot dotarray aA, aB\n"
+    "  a0 = aC[0]\n"
+    "  a1 = aC[1]\n"
+    "  chnset k(a0) + 10 * k(a1), \"aaliased\"\n"
+    "  a0 = aD[0]\n"
+    "  a1 = aD[1]\n"
+    "  chnset k(a0) + 10 * k(a1), \"adiv\"\n"
+    "  a0 = aE[0]\n"
+    "  a1 = aE[1]\n"
+    "  chnset k(a0) + 10 * k(a1), \"ascalar\"\n"
+    "  a0 = aF[0]\n"
+    "  a1 = aF[1]\n"
+    "  chnset k(a0) + 10 * k(a1), \"ain\"\n"
+    "  chnset k(adot), \"adot\"\n"
+    "endin\n";
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static CSOUND *start(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    int    k;
+
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    CU_ASSERT(csoundCompileOrc(csound, orc) == 0);
+    csoundReadScore(csound, "i 1 0 1");
+    csoundStart(csound);
+    for (k = 0; k < 4; k++)
+      csoundPerformKsmps(csound);
+    return csound;
+}
+
+static double chn(CSOUND *csound, const char *name) {
+    return csoundGetControlChannel(csound, name, NULL);
+}
+
+/* k-rate arithmetic, aliased or not, and with scalars */
+void test_karith(void) {
+    CSOUND *csound = start();
+
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "kadd"), 5555.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "ksubin"), 3087.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "kaliased"), 8642.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "ksquare"), 16941.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "kdiv"), 49883.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "krdiv"), 3472.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "kscalar"), 1357.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "krsub"), 1234.0, 1e-9);
+    csoundDestroy(csound);
+}
+
+/* a-rate arithmetic, aliased, in place and with scalars */
+void test_aarith(void) {
+    CSOUND *csound = start();
+
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "aaliased"), 128.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "adiv"), 23.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "ascalar"), -1.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "ain"), 53.0, 1e-9);
+    csoundDestroy(csound);
+}
+
+/* dotarray at i, k and a rate; the shorter array sets the length */
+void test_dotarray(void) {
+    CSOUND *csound = start();
+
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "kdot"), 20.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "kdotshort"), 3.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "kdotself"), 30.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "idot"), 20.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "idotshort"), 3.0, 1e-9);
+    CU_ASSERT_DOUBLE_EQUAL(chn(csound, "adot"), 11.0, 1e-9);
+    csoundDestroy(csound);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("array arithmetic tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test k-rate array arithmetic",
+                             test_karith)) ||
+        (NULL == CU_add_test(pSuite, "Test a-rate array arithmetic",
+                             test_aarith)) ||
+        (NULL == CU_add_test(pSuite, "Test dotarray", test_dotarray))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,226 @@
+/*
+ * File:   async_file_test.c
+ *
+ * Tests for the asynchronous sound file streams
+ * (csoundFileOpenWithType_Async() in Engine/envvar.c)
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "csoundCore.h"
+#include "CUnit/Basic.h"
+
+#define AF_NAME     "async_file_test.wav"
+#define AF_FRAMES   100000
+#define AF_CHANS    2
+#define AF_BUF      (512 * AF_CHANS)
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    remove(AF_NAME);
+    return 0;
+}
+
+static MYFLT sample(int n) {
+    return (MYFLT) ((float) (n % 20011) / 20011.0f - 0.5f);
+}
+
+/* read items samples from n, waiting for the stream */
+static int read_from(CSOUND *csound, void *fd, int n, int items) {
+    MYFLT buf[256];
+    int   i, got, bad = 0, tries = 0;
+
+    while (items > 0 && tries < 10000) {
+      got = csound->ReadAsync(csound, fd, buf, items < 256 ? items : 256);
+      if (got == 0) {
+        csoundSleep(1);
+        tries++;
+        continue;
+      }
+      for (i = 0; i < got; i++)
+        bad += (buf[i] != sample(n + i));
+      n += got;
+      items -= got;
+    }
+    return (items == 0 ? bad : -1);
+}
+
+static void make_file(void) {
+    SF_INFO sfinfo;
+    SNDFILE *sf;
+    float   *buf = (float*) malloc(sizeof(float) * AF_FRAMES * AF_CHANS);
+    int     i;
+
+    memset(&sfinfo, 0, sizeof(SF_INFO));
+    sfinfo.samplerate = 44100;
+    sfinfo.channels = AF_CHANS;
+    sfinfo.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+    for (i = 0; i < AF_FRAMES * AF_CHANS; i++)
+      buf[i] = (float) sample(i);
+    sf = sf_open(AF_NAME, SFM_WRITE, &sfinfo);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(sf);
+    sf_write_float(sf, buf, AF_FRAMES * AF_CHANS);
+    sf_close(sf);
+    free(buf);
+}
+
+/* the whole file from a seek, then a seek back while streaming */
+void test_async_read(void) {
+    CSOUND  *csound = csoundCreate(NULL);
+    SF_INFO sfinfo;
+    SNDFILE *sf = NULL;
+    void    *fd;
+
+    make_file();
+    memset(&sfinfo, 0, sizeof(SF_INFO));
+    fd = csound->FileOpenAsync(csound, &sf, CSFILE_SND_R, AF_NAME, &sfinfo,
+                               NULL, CSFTYPE_UNKNOWN_AUDIO, AF_BUF, 0);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(fd);
+    CU_ASSERT_EQUAL(sfinfo.channels, AF_CHANS);
+    csound->FSeekAsync(csound, fd, 1000, SEEK_SET);
+    CU_ASSERT_EQUAL(read_from(csound, fd, 1000 * AF_CHANS,
+                              (AF_FRAMES - 1000) * AF_CHANS), 0);
+    csound->FSeekAsync(csound, fd, 50000, SEEK_SET);
+    CU_ASSERT_EQUAL(read_from(csound, fd, 50000 * AF_CHANS, 10000), 0);
+    csound->FSeekAsync(csound, fd, 0, SEEK_SET);
+    CU_ASSERT_EQUAL(read_from(csound, fd, 0, 20000), 0);
+    CU_ASSERT_EQUAL(csound->FileClose(csound, fd), 0);
+    csoundDestroy(csound);
+}
+
+/* samples written come back in order */
+void test_async_write(void) {
+    CSOUND  *csound = csoundCreate(NULL);
+    SF_INFO sfinfo;
+    SNDFILE *sf = NULL;
+    MYFLT   buf[300];
+    float   *back;
+    void    *fd;
+    int     i, n = 0, got, tries = 0, bad = 0;
+
+    memset(&sfinfo, 0, sizeof(SF_INFO));
+    sfinfo.samplerate = 44100;
+    sfinfo.channels = AF_CHANS;
+    sfinfo.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+    fd = csound->FileOpenAsync(csound, &sf, CSFILE_SND_W, AF_NAME, &sfinfo,
+                               NULL, CSFTYPE_WAVE, AF_BUF, 0);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(fd);
+    while (n < AF_FRAMES * AF_CHANS && tries < 10000) {
+      for (i = 0; i < 300; i++)
+        buf[i] = sample(n + i);
+      got = csound->WriteAsync(csound, fd, buf, 300);
+      if (got < 300) {
+        csoundSleep(1);
+        tries++;
+      }
+      n += got;
+    }
+    CU_ASSERT_EQUAL(csound->FileClose(csound, fd), 0);
+    csoundDestroy(csound);
+
+    memset(&sfinfo, 0, sizeof(SF_INFO));
+    sf = sf_open(AF_NAME, SFM_READ, &sfinfo);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(sf);
+    back = (float*) malloc(sizeof(float) * n);
+    got = (int) sf_read_float(sf, back, n);
+    sf_close(sf);
+    CU_ASSERT_EQUAL(got, n);
+    for (i = 0; i < got; i++)
+      bad += ((MYFLT) back[i] != sample(i));
+    CU_ASSERT_EQUAL(bad, 0);
+    free(back);
+}
+
+/* a seek of a stream written applies after the samples queued before
+   it, without waiting for them; the file is complete once closed */
+void test_async_write_seek(void) {
+    CSOUND  *csound = csoundCreate(NULL);
+    SF_INFO sfinfo;
+    SNDFILE *sf = NULL;
+    MYFLT   buf[AF_CHANS * 100];
+    float   *back;
+    void    *fd;
+    int     i, n = 0, got, tries = 0, bad = 0;
+
+    memset(&sfinfo, 0, sizeof(SF_INFO));
+    sfinfo.samplerate = 44100;
+    sfinfo.channels = AF_CHANS;
+    sfinfo.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+    fd = csound->FileOpenAsync(csound, &sf, CSFILE_SND_W, AF_NAME, &sfinfo,
+                               NULL, CSFTYPE_WAVE, AF_BUF, 0);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(fd);
+    while (n < 10000 * AF_CHANS && tries < 10000) {
+      for (i = 0; i < AF_CHANS * 100; i++)
+        buf[i] = sample(n + i);
+      got = csound->WriteAsync(csound, fd, buf, AF_CHANS * 100);
+      if (got < AF_CHANS * 100) {
+        csoundSleep(1);
+        tries++;
+      }
+      n += got;
+    }
+    CU_ASSERT_EQUAL(n, 10000 * AF_CHANS);
+    /* the file I/O thread used without io_uring drops what it has not
+       written yet at a seek */
+    csoundSleep(200);
+    /* frames 1000 to 1099 overwritten */
+    CU_ASSERT_EQUAL(csound->FSeekAsync(csound, fd, 1000, SEEK_SET), 1000);
+    for (i = 0; i < AF_CHANS * 100; i++)
+      buf[i] = FL(0.25);
+    CU_ASSERT_EQUAL(csound->WriteAsync(csound, fd, buf, AF_CHANS * 100),
+                    AF_CHANS * 100);
+    CU_ASSERT_EQUAL(csound->FileClose(csound, fd), 0);
+    csoundDestroy(csound);
+
+    memset(&sfinfo, 0, sizeof(SF_INFO));
+    sf = sf_open(AF_NAME, SFM_READ, &sfinfo);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(sf);
+    CU_ASSERT_EQUAL(sfinfo.frames, 10000);
+    back = (float*) malloc(sizeof(float) * n);
+    got = (int) sf_read_float(sf, back, n);
+    sf_close(sf);
+    CU_ASSERT_EQUAL(got, n);
+    for (i = 0; i < got; i++) {
+      int over = (i >= 1000 * AF_CHANS && i < 1100 * AF_CHANS);
+      bad += ((MYFLT) back[i] != (over ? FL(0.25) : sample(i)));
+    }
+    CU_ASSERT_EQUAL(bad, 0);
+    free(back);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("async sound file tests", init_suite1,
+                          clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test reading and seeking",
+                             test_async_read)) ||
+        (NULL == CU_add_test(pSuite, "Test writing", test_async_write)) ||
+        (NULL == CU_add_test(pSuite, "Test seeking while writing",
+                             test_async_write_seek))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -5,6 +5,9 @@
  * Created on June 7, 2012, 4:03 PM
  */
 
+#include <stdio.h>
+#include <time.h>
+#include <sched.h>
 #include "csound.h"
 #include "pthread.h"
 #include "CUnit/Basic.h"
@@ -132,6 +135,127 @@ void test_wrap(void) {
     csoundDestroy(csound);
 }
 
+void test_reserve_commit(void) {
+    int i, j, k, n, next = 0, expect = 0;
+    CSOUND* csound = csoundCreate(NULL);
+    void *rb = csoundCreateCircularBuffer(csound, 100, sizeof(float));
+    CS_CIRCULAR_REGION r;
+
+    /* one element is always kept free */
+    CU_ASSERT_EQUAL(csoundWriteCircularBufferReserve(csound, rb, 200, &r), 99);
+    CU_ASSERT_EQUAL(r.items[0], 99);
+    CU_ASSERT_EQUAL(r.items[1], 0);
+    CU_ASSERT_PTR_NULL(r.data[1]);
+    CU_ASSERT_EQUAL(csoundReadCircularBufferReserve(csound, rb, 10, &r), 0);
+    /* blocks of 37 wrap around the end in two spans */
+    for (k = 0; k < 20; k++) {
+      n = csoundWriteCircularBufferReserve(csound, rb, 37, &r);
+      CU_ASSERT_EQUAL(n, 37);
+      CU_ASSERT_EQUAL(r.items[0] + r.items[1], n);
+      for (j = 0; j < 2; j++)
+        for (i = 0; i < r.items[j]; i++)
+          ((float *) r.data[j])[i] = next++;
+      csoundWriteCircularBufferCommit(csound, rb, n);
+      CU_ASSERT_EQUAL(csoundReadCircularBufferReserve(csound, rb, 100, &r), 37);
+      n = csoundReadCircularBufferReserve(csound, rb, 30, &r);
+      CU_ASSERT_EQUAL(n, 30);
+      for (j = 0; j < 2; j++)
+        for (i = 0; i < r.items[j]; i++)
+          CU_ASSERT_EQUAL(((float *) r.data[j])[i], expect++);
+      csoundReadCircularBufferCommit(csound, rb, n);
+      /* the rest with the copying API */
+      for (i = 0; i < 7; i++) {
+        float val;
+        CU_ASSERT_EQUAL(csoundReadCircularBuffer(csound, rb, &val, 1), 1);
+        CU_ASSERT_EQUAL(val, expect++);
+      }
+    }
+    csoundDestroyCircularBuffer(csound, rb);
+    csoundDestroy(csound);
+}
+
+#define BENCH_BLOCK 256
+#define BENCH_ITEMS (1 << 24)
+
+typedef struct {
+    void  *rb;
+    int   zerocopy;
+    long  errors;
+} bench_data;
+
+static void *bench_consumer(void *p) {
+    bench_data *d = (bench_data *) p;
+    float buf[BENCH_BLOCK];
+    long  n = 0;
+    int   i, j, got;
+    CS_CIRCULAR_REGION r;
+
+    while (n < BENCH_ITEMS) {
+      if (d->zerocopy) {
+        got = csoundReadCircularBufferReserve(NULL, d->rb, BENCH_BLOCK, &r);
+        for (j = 0; j < 2; j++)
+          for (i = 0; i < r.items[j]; i++)
+            d->errors += (((float *) r.data[j])[i] != (float) (n++ & 0xFFFF));
+        csoundReadCircularBufferCommit(NULL, d->rb, got);
+      }
+      else {
+        got = csoundReadCircularBuffer(NULL, d->rb, buf, BENCH_BLOCK);
+        for (i = 0; i < got; i++)
+          d->errors += (buf[i] != (float) (n++ & 0xFFFF));
+      }
+      if (got == 0)
+        sched_yield();
+    }
+    return NULL;
+}
+
+/* million elements per second from a producer to a consumer thread */
+static double bench_run(int zerocopy) {
+    CSOUND *csound = csoundCreate(NULL);
+    bench_data d;
+    pthread_t thread;
+    float buf[BENCH_BLOCK];
+    long  n = 0;
+    int   i, j, put;
+    struct timespec ts0, ts1;
+    CS_CIRCULAR_REGION r;
+
+    d.rb = csoundCreateCircularBuffer(csound, 8192, sizeof(float));
+    d.zerocopy = zerocopy;
+    d.errors = 0;
+    clock_gettime(CLOCK_MONOTONIC, &ts0);
+    pthread_create(&thread, NULL, bench_consumer, &d);
+    while (n < BENCH_ITEMS) {
+      if (zerocopy) {
+        put = csoundWriteCircularBufferReserve(NULL, d.rb, BENCH_BLOCK, &r);
+        for (j = 0; j < 2; j++)
+          for (i = 0; i < r.items[j]; i++)
+            ((float *) r.data[j])[i] = (float) (n++ & 0xFFFF);
+        csoundWriteCircularBufferCommit(NULL, d.rb, put);
+      }
+      else {
+        for (i = 0; i < BENCH_BLOCK; i++)
+          buf[i] = (float) ((n + i) & 0xFFFF);
+        put = csoundWriteCircularBuffer(NULL, d.rb, buf, BENCH_BLOCK);
+        n += put;
+      }
+      if (put == 0)
+        sched_yield();
+    }
+    pthread_join(thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &ts1);
+    CU_ASSERT_EQUAL(d.errors, 0);
+    csoundDestroyCircularBuffer(csound, d.rb);
+    csoundDestroy(csound);
+    return BENCH_ITEMS * 1e-6 / ((ts1.tv_sec - ts0.tv_sec) +
+                                 1e-9 * (ts1.tv_nsec - ts0.tv_nsec));
+}
+
+void test_benchmark(void) {
+    printf("\n%24s %10.1f M/s\n", "copy", bench_run(0));
+    printf("%24s %10.1f M/s\n", "reserve/commit", bench_run(1));
+    CU_PASS("benchmark");
+}
 
 int main()
 {
@@ -152,6 +276,8 @@ int main()
             || (NULL == CU_add_test(pSuite, "Test read and write diff sizes", test_read_write_diff_size))
             || (NULL == CU_add_test(pSuite, "Test peek", test_peek))
             || (NULL == CU_add_test(pSuite, "Test wrap", test_wrap))
+            || (NULL == CU_add_test(pSuite, "Test reserve and commit", test_reserve_commit))
+            || (NULL == CU_add_test(pSuite, "Benchmark threads", test_benchmark))
         )
     {
         CU_cleanup_registry();
@@ -10,7 +10,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <dirent.h>
 #include "csoundCore.h"
+#include "csound_orc.h"
 #include "CUnit/Basic.h"
 
 extern int argsRequired(char* arrayName);
@@ -166,6 +168,191 @@ void test_linenum(void)
 }
 
 
+void test_orc_cache(void)
+{
+    CSOUND  *csound;
+    DIR     *dir;
+    struct dirent *ent;
+    char    cachedir[] = "/tmp/csorccacheXXXXXX";
+    char    option[64], path[256];
+    int     i, cnt = 0, result;
+    TREE    *tree[2];
+    char  *orc =
+            "opcode Twice, k, k \n"
+            "kin xin \n"
+            "xout kin*2 \n"
+            "endop \n"
+            "instr 1 \n"
+            "k1 Twice p4 \n"
+            "a1 oscili k1, p5 \n"
+            "out  a1   \n"
+            "endin \n";
+
+    CU_ASSERT_PTR_NOT_NULL(mkdtemp(cachedir));
+    snprintf(option, 64, "--env:CSORCCACHE=%s", cachedir);
+    /* first instance parses and stores, second loads from the cache */
+    for (i = 0; i < 2; i++) {
+      csound = csoundCreate(NULL);
+      csoundSetOption(csound, "-n");
+      csoundSetOption(csound, option);
+      tree[i] = csoundParseOrc(csound, orc);
+      CU_ASSERT_PTR_NOT_NULL(tree[i]);
+      if (tree[i] != NULL)
+        CU_ASSERT_EQUAL(tree[i]->next->type, UDO_TOKEN);
+      csoundReset(csound);
+      csoundSetOption(csound, "-n");
+      csoundSetOption(csound, option);
+      result = csoundCompileOrc(csound, orc);
+      CU_ASSERT(result == 0);
+      csoundDestroy(csound);
+    }
+
+    dir = opendir(cachedir);
+    while ((ent = readdir(dir)) != NULL) {
+      if (ent->d_name[0] == '.') continue;
+      cnt++;
+      snprintf(path, 256, "%s/%s", cachedir, ent->d_name);
+      remove(path);
+    }
+    closedir(dir);
+    remove(cachedir);
+    CU_ASSERT_EQUAL(cnt, 1);
+}
+
+static int cache_ignored, udo_redefined;
+
+static void cache_messages(CSOUND *csound, int attr, const char *str)
+{
+    (void) csound; (void) attr;
+    if (strstr(str, "orchestra cache: ignoring") != NULL)
+      cache_ignored++;
+    if (strstr(str, "redefined opcode") != NULL)
+      udo_redefined++;
+}
+
+/* an entry whose second UDO header is invalid is rejected without the
+ * first one being registered, so the parse that follows does not see it
+ * as a redefinition */
+void test_orc_cache_invalid_udo(void)
+{
+    CSOUND  *csound;
+    DIR     *dir;
+    struct dirent *ent;
+    FILE    *f;
+    char    cachedir[] = "/tmp/csorccacheXXXXXX";
+    char    option[64], path[256], pattern[7], *buf;
+    uint32_t slen = 3;
+    long    len, i;
+    int     result, patched = 0;
+    char  *orc =
+            "opcode Once, k, k \n"
+            "kin xin \n"
+            "xout kin \n"
+            "endop \n"
+            "opcode Thrice, k, kkk \n"
+            "k1, k2, k3 xin \n"
+            "xout k1+k2+k3 \n"
+            "endop \n"
+            "instr 1 \n"
+            "k0 Once p4 \n"
+            "k1 Thrice k0, p4, p4 \n"
+            "endin \n";
+
+    CU_ASSERT_PTR_NOT_NULL(mkdtemp(cachedir));
+    snprintf(option, 64, "--env:CSORCCACHE=%s", cachedir);
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, option);
+    CU_ASSERT(csoundCompileOrc(csound, orc) == 0);
+    csoundDestroy(csound);
+
+    /* give the second UDO an unknown input type in the stored tree,
+     * where strings are a native uint32_t length and the characters */
+    memcpy(pattern, &slen, 4);
+    memcpy(pattern + 4, "kkk", 3);
+    dir = opendir(cachedir);
+    while ((ent = readdir(dir)) != NULL) {
+      if (ent->d_name[0] == '.') continue;
+      snprintf(path, 256, "%s/%s", cachedir, ent->d_name);
+      f = fopen(path, "rb");
+      fseek(f, 0, SEEK_END);
+      len = ftell(f);
+      rewind(f);
+      buf = malloc(len);
+      CU_ASSERT(fread(buf, 1, len, f) == (size_t) len);
+      fclose(f);
+      for (i = 0; i + 7 <= len; i++)
+        if (memcmp(buf + i, pattern, 7) == 0) {
+          buf[i + 5] = '#';
+          patched++;
+        }
+      f = fopen(path, "wb");
+      fwrite(buf, 1, len, f);
+      fclose(f);
+      free(buf);
+    }
+    closedir(dir);
+    CU_ASSERT_EQUAL(patched, 1);
+
+    cache_ignored = udo_redefined = 0;
+    csound = csoundCreate(NULL);
+    csoundSetMessageStringCallback(csound, cache_messages);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, option);
+    result = csoundCompileOrc(csound, orc);
+    CU_ASSERT(result == 0);
+    CU_ASSERT_EQUAL(cache_ignored, 1);
+    CU_ASSERT_EQUAL(udo_redefined, 0);
+    csoundDestroy(csound);
+
+    dir = opendir(cachedir);
+    while ((ent = readdir(dir)) != NULL) {
+      if (ent->d_name[0] == '.') continue;
+      snprintf(path, 256, "%s/%s", cachedir, ent->d_name);
+      remove(path);
+    }
+    closedir(dir);
+    remove(cachedir);
+}
+
+void test_recompile_unchanged(void)
+{
+    CSOUND  *csound;
+    INSTRTXT *ip1, *ip2;
+    int     result;
+    char  *orc =
+            "instr 1 \n"
+            "k1 expon p4, p3, p4*0.001 \n"
+            "a1 randi  k1, p5   \n"
+            "out  a1   \n"
+            "endin \n";
+    char  *orc2 =
+            "\n"
+            "instr 1 \n"
+            "k1 expon p4, p3, p4*0.001 \n"
+            "a1 randi  k1, p5   \n"
+            "out  a1   \n"
+            "endin \n"
+            "instr 2 \n"
+            "a1 oscili p4, p5 \n"
+            "out  a1   \n"
+            "endin \n";
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    result = csoundCompileOrc(csound, orc);
+    CU_ASSERT(result == 0);
+    result = csoundStart(csound);
+    CU_ASSERT(result == 0);
+    ip1 = csound->engineState.instrtxtp[1];
+    /* instr 1 only moved down a line: its template is kept */
+    result = csoundCompileOrc(csound, orc2);
+    CU_ASSERT(result == 0);
+    ip2 = csound->engineState.instrtxtp[1];
+    CU_ASSERT_PTR_EQUAL(ip1, ip2);
+    CU_ASSERT_PTR_NOT_NULL(csound->engineState.instrtxtp[2]);
+    csoundDestroy(csound);
+}
 
 int main() {
     CU_pSuite pSuite = NULL;
@@ -186,7 +373,12 @@ int main() {
             (NULL == CU_add_test(pSuite, "Test splitArgs", test_split_args)) ||
             (NULL == CU_add_test(pSuite, "Test Compilation", test_compile)) ||
             (NULL == CU_add_test(pSuite, "Test Reuse Instance", test_reuse)) ||
-        (NULL == CU_add_test(pSuite, "Test Line Numbers", test_linenum))) {
+        (NULL == CU_add_test(pSuite, "Test Line Numbers", test_linenum)) ||
+        (NULL == CU_add_test(pSuite, "Test Orchestra Cache", test_orc_cache)) ||
+        (NULL == CU_add_test(pSuite, "Test Orchestra Cache Invalid UDO",
+                             test_orc_cache_invalid_udo)) ||
+        (NULL == CU_add_test(pSuite, "Test Recompile Unchanged",
+                             test_recompile_unchanged))) {
         CU_cleanup_registry();
         return CU_get_error();
     }
@@ -0,0 +1,772 @@
+/*
+ * File:   delay_opcodes_test.c
+ *
+ * Regression tests for the delay opcodes on the shared delay lines
+ * (OOps/ugens6.c, OOps/vdelay.c): each opcode is run in an orchestra
+ * and checked against the per-sample loop it replaced
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "csoundCore.h"
+#include "CUnit/Basic.h"
+
+#ifdef USE_DOUBLE
+#define TOL     1e-7
+#else
+#define TOL     1e-3
+#endif
+
+/* sr a power of two, so that delays of whole samples are exact in
+   seconds; delays sweep from 0 to MAXDEL samples and back */
+#define SR      32768
+#define KSMPS   16
+#define NBLK    1000
+#define NSMPS   (NBLK * KSMPS)
+#define MAXDEL  2048
+#define PERIOD  4000
+#define KPERIOD 3200
+#define NOUT    10
+
+/* the inputs and delays set by the host each cycle, and outputs o1, o2...
+   set by the body of the instrument */
+static const char *head =
+    "sr = 32768\n"
+    "ksmps = 16\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "  ain1 chnget \"in1\"\n"
+    "  ain2 chnget \"in2\"\n"
+    "  ain3 chnget \"in3\"\n"
+    "  ain4 chnget \"in4\"\n"
+    "  adel chnget \"del\"\n"
+    "  kdel chnget \"kdel\"\n"
+    "  kn   chnget \"kn\"\n"
+    "  imax = 0.0625\n";
+
+static MYFLT in[4][NSMPS], adel[NSMPS], kdel[NBLK], kn[NBLK];
+static MYFLT got[NOUT][NSMPS], want[NOUT][NSMPS];
+static const MYFLT esr = FL(32768.0);
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+/* 1 at multiples of period, 0 half way */
+static double tri(int t, int period) {
+    return fabs(2.0 * (t % period) / period - 1.0);
+}
+
+static void signals(void) {
+    uint32_t s = 1;
+    int      c, t;
+
+    for (c = 0; c < 4; c++)
+      for (t = 0; t < NSMPS; t++) {
+        s = s * 1103515245 + 12345;
+        in[c][t] = (MYFLT) ((s >> 8) & 0xffff) / FL(65536.0) - FL(0.5);
+      }
+    for (t = 0; t < NSMPS; t++)
+      adel[t] = (MYFLT) (MAXDEL * tri(t, PERIOD) / SR);
+    for (t = 0; t < NBLK; t++) {
+      kn[t] = (MYFLT) (int) (MAXDEL * tri(t * KSMPS, KPERIOD));
+      kdel[t] = kn[t] / SR;
+    }
+}
+
+/* runs body for NBLK cycles, its outputs into got */
+static int render(const char *body, int nout) {
+    CSOUND *csound = csoundCreate(NULL);
+    char   *orc = malloc(strlen(head) + strlen(body) + 8), name[8];
+    int    b, i, ret;
+
+    sprintf(orc, "%s%sendin\n", head, body);
+    csoundSetOption(csound, "-n");
+    ret = csoundCompileOrc(csound, orc);
+    if (ret == 0) {
+      csoundReadScore(csound, "i 1 0 1\n");
+      ret = csoundStart(csound);
+    }
+    memset(got, 0, sizeof(got));
+    for (b = 0; ret == 0 && b < NBLK; b++) {
+      for (i = 0; i < 4; i++) {
+        snprintf(name, 8, "in%d", i + 1);
+        csoundSetAudioChannel(csound, name, &in[i][b * KSMPS]);
+      }
+      csoundSetAudioChannel(csound, "del", &adel[b * KSMPS]);
+      csoundSetControlChannel(csound, "kdel", kdel[b]);
+      csoundSetControlChannel(csound, "kn", kn[b]);
+      ret = csoundPerformKsmps(csound);
+      for (i = 0; i < nout; i++) {
+        snprintf(name, 8, "o%d", i + 1);
+        csoundGetAudioChannel(csound, name, &got[i][b * KSMPS]);
+      }
+    }
+    csoundDestroy(csound);
+    free(orc);
+    return ret;
+}
+
+static void check(const char *what, int i) {
+    double err = 0.0, e;
+    int    t;
+
+    for (t = 0; t < NSMPS; t++) {
+      e = fabs((double) got[i][t] - (double) want[i][t]);
+      if (!(e <= err))
+        err = e;
+    }
+    printf("\n%s: max error %g", what, err);
+    CU_ASSERT(err < TOL);
+}
+
+/* as limit does it */
+static MYFLT lim(MYFLT x, MYFLT lo, MYFLT hi) {
+    return x > hi ? hi : x < lo ? lo : x;
+}
+
+/* delays of the whole run between lo and hi samples */
+static void arange(MYFLT *d, int lo, int hi) {
+    int    t;
+
+    for (t = 0; t < NSMPS; t++)
+      d[t] = lim(adel[t], (MYFLT) lo / esr, (MYFLT) hi / esr);
+}
+
+static void krange(MYFLT *d, int lo, int hi) {
+    int    b;
+
+    for (b = 0; b < NBLK; b++)
+      d[b] = lim(kdel[b], (MYFLT) lo / esr, (MYFLT) hi / esr);
+}
+
+/*
+ * The old opcodes, on a circular buffer of len samples: pos is the
+ * next slot written by delay and delayw, and the slot of the sample
+ * just written by the vdelay family
+ */
+
+typedef struct {
+    MYFLT   buf[MAXDEL + 64];
+    int32   len, pos;
+} RING;
+
+static RING ring[NOUT];
+
+static void ring_init(RING *r, int32 len) {
+    memset(r->buf, 0, sizeof(r->buf));
+    r->len = len;
+    r->pos = 0;
+}
+
+static MYFLT *slot(RING *r, int32 i) {
+    i %= r->len;
+    return &r->buf[i < 0 ? i + r->len : i];
+}
+
+static void old_delay(RING *r, const MYFLT *in, MYFLT *out) {
+    int    n;
+
+    for (n = 0; n < KSMPS; n++) {
+      MYFLT x = in[n];
+      out[n] = r->buf[r->pos];
+      r->buf[r->pos] = x;
+      if (++r->pos >= r->len)
+        r->pos = 0;
+    }
+}
+
+static void old_delayr(RING *r, MYFLT *out) {
+    int    n;
+
+    for (n = 0; n < KSMPS; n++)
+      out[n] = *slot(r, r->pos + n);
+}
+
+static void old_delayw(RING *r, const MYFLT *in) {
+    int    n;
+
+    for (n = 0; n < KSMPS; n++)
+      *slot(r, r->pos + n) = in[n];
+    r->pos = (r->pos + KSMPS) % r->len;
+}
+
+static void old_deltap(RING *r, MYFLT del, MYFLT *out) {
+    int32  tap = r->pos - MYFLT2LRND(del * esr);
+    int    n;
+
+    for (n = 0; n < KSMPS; n++)
+      out[n] = *slot(r, tap + n);
+}
+
+/* del of sample n is del[n] if arate, del[0] otherwise */
+static void old_deltapi(RING *r, const MYFLT *del, int arate, MYFLT *out) {
+    int    n;
+
+    for (n = 0; n < KSMPS; n++) {
+      MYFLT  delsmps = del[arate ? n : 0] * esr, delfrac, y0, y1;
+      int32  idelsmps = (int32) delsmps;
+
+      delfrac = delsmps - idelsmps;
+      y0 = *slot(r, r->pos + n - idelsmps);
+      y1 = *slot(r, r->pos + n - idelsmps - 1);
+      out[n] = y0 + (y1 - y0) * delfrac;
+    }
+}
+
+static void old_deltapn(RING *r, MYFLT del, MYFLT *out) {
+    int32  tap = r->pos - (int32) del;
+    int    n;
+
+    for (n = 0; n < KSMPS; n++)
+      out[n] = *slot(r, tap + n);
+}
+
+static void old_deltap3(RING *r, const MYFLT *del, int arate, MYFLT *out) {
+    MYFLT  sixth = arate ? FL(0.1666666667) : FL(0.16666666666667);
+    int    n;
+
+    for (n = 0; n < KSMPS; n++) {
+      MYFLT  delsmps = del[arate ? n : 0] * esr, delfrac;
+      MYFLT  ym1, y0, y1, y2, w, x, y, z;
+      int32  tap = r->pos + n - (int32) delsmps;
+
+      delfrac = delsmps - (int32) delsmps;
+      ym1 = *slot(r, tap + 1); y0 = *slot(r, tap);
+      y1 = *slot(r, tap - 1); y2 = *slot(r, tap - 2);
+      z = delfrac * delfrac; z--; z *= sixth;
+      y = delfrac; y++; w = (y *= FL(0.5)); w--;
+      x = FL(3.0) * z; y -= x; w -= z; x -= delfrac;
+      out[n] = (w*ym1 + x*y0 + y*y1 + z*y2) * delfrac + y0;
+    }
+}
+
+static double tapx_d2x(int wsize) {
+    return (1.0 - pow((double) wsize * 0.85172, -0.89624))
+      / (double) ((wsize * wsize) >> 2);
+}
+
+/* the position and fraction of a delay read or written at sample n */
+static int32 tapx_pos(RING *r, int32 indx, MYFLT del, double *x1) {
+    double x = (double) indx - (double) del * (double) esr;
+    int32  xpos;
+
+    while (x < 0.0) x += (double) r->len;
+    xpos = (int32) x;
+    *x1 = x - (double) xpos;
+    return xpos;
+}
+
+static void old_deltapx(RING *r, const MYFLT *del, int wsize, MYFLT *out) {
+    double d2x = tapx_d2x(wsize), x1, n1, w, d, am1, a0, a1, a2;
+    int32  xpos, i, i2 = wsize >> 1;
+    int    n;
+
+    for (n = 0; n < KSMPS; n++) {
+      xpos = tapx_pos(r, r->pos + n, del[n], &x1);
+      if (wsize != 4) {
+        if (x1 > 0.00000001 && x1 < 0.99999999) {
+          xpos -= i2;
+          d = (double) (1 - i2) - x1;
+          n1 = 0.0;
+          for (i = 0; i < i2; i++) {
+            w = 1.0 - d * d * d2x;
+            n1 += w * w * (double) *slot(r, ++xpos) / d; d++;
+            w = 1.0 - d * d * d2x;
+            n1 -= w * w * (double) *slot(r, ++xpos) / d; d++;
+          }
+          out[n] = (MYFLT) (n1 * sin(PI * x1) / PI);
+        }
+        else
+          out[n] = *slot(r, MYFLT2LRND((double) xpos + x1));
+      }
+      else {
+        am1 = x1;
+        a0  = am1 * am1; a2 = 0.16666667 * (am1 * a0 - am1);
+        a1  = 0.5 * (a0 + am1) - 3.0 * a2;
+        am1 = 0.5 * (a0 - am1) - a2;
+        a0  = 3.0 * a2 - a0; a0++;
+        out[n] = (MYFLT) (am1 * (double) *slot(r, xpos - 1)
+                          + a0 * (double) *slot(r, xpos)
+                          + a1 * (double) *slot(r, xpos + 1)
+                          + a2 * (double) *slot(r, xpos + 2));
+      }
+    }
+}
+
+/* each input sample written at its own delay: the old sinc path wrote
+   the first sample of the block at every delay of it */
+static void old_deltapxw(RING *r, const MYFLT *in, const MYFLT *del,
+                         int wsize) {
+    double d2x = tapx_d2x(wsize), x1, n1, w, d, am1, a0, a1, a2;
+    int32  xpos, i, i2 = wsize >> 1;
+    MYFLT  *b;
+    int    n;
+
+    for (n = 0; n < KSMPS; n++) {
+      xpos = tapx_pos(r, r->pos + n, del[n], &x1);
+      if (wsize != 4) {
+        if (x1 > 0.00000001 && x1 < 0.99999999) {
+          n1 = (double) in[n] * (sin(PI * x1) / PI);
+          xpos -= i2;
+          d = (double) (1 - i2) - x1;
+          for (i = 0; i < i2; i++) {
+            w = 1.0 - d * d * d2x;
+            b = slot(r, ++xpos);
+            *b = (MYFLT) ((double) *b + w * w * n1 / d); d++;
+            w = 1.0 - d * d * d2x;
+            b = slot(r, ++xpos);
+            *b = (MYFLT) ((double) *b - w * w * n1 / d); d++;
+          }
+        }
+        else
+          *slot(r, MYFLT2LRND((double) xpos + x1)) += in[n];
+      }
+      else {
+        am1 = x1;
+        a0  = am1 * am1; a2 = 0.16666667 * (am1 * a0 - am1);
+        a1  = 0.5 * (a0 + am1) - 3.0 * a2;
+        am1 = 0.5 * (a0 - am1) - a2;
+        a0  = 3.0 * a2 - a0; a0++;
+        *slot(r, xpos - 1) += (MYFLT) (am1 * in[n]);
+        *slot(r, xpos) += (MYFLT) (a0 * in[n]);
+        *slot(r, xpos + 1) += (MYFLT) (a1 * in[n]);
+        *slot(r, xpos + 2) += (MYFLT) (a2 * in[n]);
+      }
+    }
+}
+
+/* del in ms */
+static void old_vdelay(RING *r, const MYFLT *in, const MYFLT *del, int arate,
+                       MYFLT *out) {
+    MYFLT  esr_ms = esr * FL(0.001), maxd = (MYFLT) r->len;
+    int    n;
+
+    for (n = 0; n < KSMPS; n++) {
+      MYFLT  fv1, fv2;
+      int32  v1, v2;
+
+      r->buf[r->pos] = in[n];
+      fv1 = r->pos - del[arate ? n : 0] * esr_ms;
+      while (fv1 < FL(0.0)) fv1 += maxd;
+      while (fv1 >= maxd) fv1 -= maxd;
+      fv2 = (fv1 < maxd - 1 ? fv1 + FL(1.0) : FL(0.0));
+      v1 = (int32) fv1;
+      v2 = (int32) fv2;
+      out[n] = r->buf[v1] + (fv1 - v1) * (r->buf[v2] - r->buf[v1]);
+      if (++r->pos == r->len) r->pos = 0;
+    }
+}
+
+static void old_vdelay3(RING *r, const MYFLT *in, const MYFLT *del, int arate,
+                        MYFLT *out) {
+    MYFLT  esr_ms = esr * FL(0.001), fv1 = FL(0.0), w, x, y, z;
+    int32  maxd = r->len, v0, v1 = 0, v2, v3;
+    int    n;
+
+    for (n = 0; n < KSMPS; n++) {
+      r->buf[r->pos] = in[n];
+      if (arate || n == 0) {
+        fv1 = del[arate ? n : 0] * (-esr_ms);
+        v1 = (int32) fv1;
+        fv1 -= (MYFLT) v1;
+        v1 += r->pos;
+        if (v1 < 0 || fv1 < FL(0.0)) {
+          fv1++; v1--; while (v1 < 0) v1 += maxd;
+        }
+        else
+          while (v1 >= maxd) v1 -= maxd;
+      }
+      v2 = (v1 == maxd - 1 ? 0 : v1 + 1);
+      v0 = (v1 == 0 ? maxd - 1 : v1 - 1);
+      v3 = (v2 == maxd - 1 ? 0 : v2 + 1);
+      z = fv1 * fv1; z--; z *= FL(0.1666666667);
+      y = fv1; y++; w = (y *= FL(0.5)); w--;
+      x = FL(3.0) * z; y -= x; w -= z; x -= fv1;
+      out[n] = (w*r->buf[v0] + x*r->buf[v1] + y*r->buf[v2] + z*r->buf[v3])
+        * fv1 + r->buf[v1];
+      if (++v1 >= maxd) v1 -= maxd;
+      if (++r->pos == maxd) r->pos = 0;
+    }
+}
+
+static int vdelx_wsize(MYFLT iquality) {
+    int    wsize = 4 * (int32_t) (FL(0.5) + FL(0.25) * iquality);
+
+    return wsize < 4 ? 4 : wsize > 1024 ? 1024 : wsize;
+}
+
+static void old_vdelayx(RING *r, const MYFLT *in, const MYFLT *del,
+                        int wsize, MYFLT *out) {
+    double x1, x2, w, d, n1, d2x;
+    int32  maxd = r->len, i, i2 = wsize >> 1, xpos;
+    int    n;
+
+    d2x = (1.0 - pow((double) wsize * 0.85172, -0.89624)) / (double) (i2*i2);
+    for (n = 0; n < KSMPS; n++) {
+      r->buf[r->pos] = in[n];
+      n1 = 0.0;
+      x1 = (double) r->pos - ((double) del[n] * (double) esr);
+      while (x1 < 0.0) x1 += (double) maxd;
+      xpos = (int32) x1;
+      x1 -= (double) xpos;
+      x2 = sin(PI * x1) / PI;
+      while (xpos >= maxd) xpos -= maxd;
+      if (x1 * (1.0 - x1) > 0.00000001) {
+        xpos += (1 - i2);
+        while (xpos < 0) xpos += maxd;
+        d = (double) (1 - i2) - x1;
+        for (i = i2; i--;) {
+          w = 1.0 - d*d*d2x; w *= (w / d++);
+          n1 += (double) r->buf[xpos] * w;
+          if (++xpos >= maxd) xpos -= maxd;
+          w = 1.0 - d*d*d2x; w *= (w / d++);
+          n1 -= (double) r->buf[xpos] * w;
+          if (++xpos >= maxd) xpos -= maxd;
+        }
+        out[n] = (MYFLT) (n1 * x2);
+      }
+      else {
+        xpos = (int32) ((double) xpos + x1 + 0.5);
+        if (xpos >= maxd) xpos -= maxd;
+        out[n] = r->buf[xpos];
+      }
+      if (++r->pos == maxd) r->pos = 0;
+    }
+}
+
+static void old_vdelayxw(RING *r, const MYFLT *in, const MYFLT *del,
+                         int wsize, MYFLT *out) {
+    double x1, x2, w, d, n1, d2x;
+    int32  maxd = r->len, i, i2 = wsize >> 1, xpos;
+    int    n;
+
+    d2x = (1.0 - pow((double) wsize * 0.85172, -0.89624)) / (double) (i2*i2);
+    for (n = 0; n < KSMPS; n++) {
+      x1 = (double) r->pos + ((double) del[n] * (double) esr);
+      while (x1 < 0.0) x1 += (double) maxd;
+      xpos = (int32) x1;
+      x1 -= (double) xpos;
+      x2 = sin(PI * x1) / PI;
+      while (xpos >= maxd) xpos -= maxd;
+      if (x1 * (1.0 - x1) > 0.00000001) {
+        n1 = (double) in[n] * x2;
+        xpos += (1 - i2);
+        while (xpos < 0) xpos += maxd;
+        d = (double) (1 - i2) - x1;
+        for (i = i2; i--;) {
+          w = 1.0 - d*d*d2x; w *= (w / d++);
+          r->buf[xpos] += (MYFLT) (n1 * w);
+          if (++xpos >= maxd) xpos -= maxd;
+          w = 1.0 - d*d*d2x; w *= (w / d++);
+          r->buf[xpos] -= (MYFLT) (n1 * w);
+          if (++xpos >= maxd) xpos -= maxd;
+        }
+      }
+      else {
+        xpos = (int32) ((double) xpos + x1 + 0.5);
+        if (xpos >= maxd) xpos -= maxd;
+        r->buf[xpos] += in[n];
+      }
+      out[n] = r->buf[r->pos]; r->buf[r->pos] = FL(0.0);
+      if (++r->pos == maxd) r->pos = 0;
+    }
+}
+
+/* times and gains in pairs */
+static void old_multitap(RING *r, const MYFLT *in, const MYFLT *tg, int ntaps,
+                         MYFLT *out) {
+    int32  delay;
+    int    n, i;
+
+    for (n = 0; n < KSMPS; n++) {
+      MYFLT v = FL(0.0);
+      r->buf[r->pos] = in[n];
+      if (++r->pos == r->len) r->pos = 0;
+      for (i = 0; i < 2 * ntaps; i += 2) {
+        delay = r->pos - (int32) (esr * tg[i]);
+        if (delay < 0)
+          delay += r->len;
+        v += r->buf[delay] * tg[i+1];
+      }
+      out[n] = v;
+    }
+}
+
+/* delay of a whole line, and of a line of 1 sample */
+void test_delay(void) {
+    static const char *body =
+      "  a1 delay ain1, imax\n"
+      "  a2 delay ain1, 1/sr\n"
+      "  chnset a1, \"o1\"\n"
+      "  chnset a2, \"o2\"\n";
+    int    b, t;
+
+    CU_ASSERT_EQUAL(render(body, 2), 0);
+    ring_init(&ring[0], MAXDEL);
+    ring_init(&ring[1], 1);
+    for (b = 0; b < NBLK; b++) {
+      t = b * KSMPS;
+      old_delay(&ring[0], &in[0][t], &want[0][t]);
+      old_delay(&ring[1], &in[0][t], &want[1][t]);
+    }
+    check("delay", 0);
+    check("delay, 1 sample", 1);
+}
+
+/* each tap from the shortest delay its interpolation allows before the
+   block is written (ksmps) up to maxdel, the longest it allows */
+void test_deltap(void) {
+    static const char *body =
+      "  ad delayr imax\n"
+      "  a1 deltap  limit(kdel, 16/sr, imax)\n"
+      "  a2 deltapi limit(kdel, 16/sr, imax)\n"
+      "  a3 deltapi limit(adel, 16/sr, imax)\n"
+      "  a4 deltapn limit(kn, 16, 2048)\n"
+      "  a5 deltap3 limit(kdel, 17/sr, 2047/sr)\n"
+      "  a6 deltap3 limit(adel, 17/sr, 2047/sr)\n"
+      "  a7 deltapx limit(adel, 18/sr, 2047/sr), 4\n"
+      "  a8 deltapx limit(adel, 24/sr, 2041/sr), 16\n"
+      "  delayw ain1\n"
+      "  chnset ad, \"o1\"\n"
+      "  chnset a1, \"o2\"\n"
+      "  chnset a2, \"o3\"\n"
+      "  chnset a3, \"o4\"\n"
+      "  chnset a4, \"o5\"\n"
+      "  chnset a5, \"o6\"\n"
+      "  chnset a6, \"o7\"\n"
+      "  chnset a7, \"o8\"\n"
+      "  chnset a8, \"o9\"\n";
+    static MYFLT k16[NBLK], k17[NBLK], a16[NSMPS], a17[NSMPS];
+    static MYFLT a18[NSMPS], a24[NSMPS];
+    RING   *r = &ring[0];
+    int    b, t;
+
+    CU_ASSERT_EQUAL(render(body, 9), 0);
+    krange(k16, 16, MAXDEL);
+    krange(k17, 17, 2047);
+    arange(a16, 16, MAXDEL);
+    arange(a17, 17, 2047);
+    arange(a18, 18, 2047);
+    arange(a24, 24, 2041);
+    ring_init(r, MAXDEL);
+    for (b = 0; b < NBLK; b++) {
+      t = b * KSMPS;
+      old_delayr(r, &want[0][t]);
+      old_deltap(r, k16[b], &want[1][t]);
+      old_deltapi(r, &k16[b], 0, &want[2][t]);
+      old_deltapi(r, &a16[t], 1, &want[3][t]);
+      old_deltapn(r, lim(kn[b], FL(16.0), FL(2048.0)), &want[4][t]);
+      old_deltap3(r, &k17[b], 0, &want[5][t]);
+      old_deltap3(r, &a17[t], 1, &want[6][t]);
+      old_deltapx(r, &a18[t], 4, &want[7][t]);
+      old_deltapx(r, &a24[t], 16, &want[8][t]);
+      old_delayw(r, &in[0][t]);
+    }
+    check("delayr", 0);
+    check("deltap", 1);
+    check("deltapi, k-rate", 2);
+    check("deltapi, a-rate", 3);
+    check("deltapn", 4);
+    check("deltap3, k-rate", 5);
+    check("deltap3, a-rate", 6);
+    check("deltapx, cubic", 7);
+    check("deltapx, sinc", 8);
+}
+
+/* written back between the block being written and the oldest block,
+   and read by the taps and delayr */
+void test_deltapxw(void) {
+    static const char *body =
+      "  ad delayr imax\n"
+      "  a1 deltapi limit(kdel, 16/sr, imax)\n"
+      "  deltapxw ain2, limit(adel, 18/sr, 2030/sr), 4\n"
+      "  deltapxw ain3, limit(adel, 24/sr, 2024/sr), 16\n"
+      "  delayw ain1\n"
+      "  chnset ad, \"o1\"\n"
+      "  chnset a1, \"o2\"\n";
+    static MYFLT k16[NBLK], a18[NSMPS], a24[NSMPS];
+    RING   *r = &ring[0];
+    int    b, t;
+
+    CU_ASSERT_EQUAL(render(body, 2), 0);
+    krange(k16, 16, MAXDEL);
+    arange(a18, 18, 2030);
+    arange(a24, 24, 2024);
+    ring_init(r, MAXDEL);
+    for (b = 0; b < NBLK; b++) {
+      t = b * KSMPS;
+      old_delayr(r, &want[0][t]);
+      old_deltapi(r, &k16[b], 0, &want[1][t]);
+      old_deltapxw(r, &in[1][t], &a18[t], 4);
+      old_deltapxw(r, &in[2][t], &a24[t], 16);
+      old_delayw(r, &in[0][t]);
+    }
+    check("deltapxw, delayr", 0);
+    check("deltapxw, deltapi", 1);
+}
+
+/* from 0 (2 samples for the cubic) up to maxdel, in a line of 2051 */
+void test_vdelay(void) {
+    static const char *body =
+      "  a1 vdelay  ain1, adel*1000, 62.6\n"
+      "  a2 vdelay  ain1, kdel*1000, 62.6\n"
+      "  a3 vdelay3 ain1, limit(adel, 2/sr, imax)*1000, 62.6\n"
+      "  a4 vdelay3 ain1, limit(kdel, 2/sr, imax)*1000, 62.6\n"
+      "  chnset a1, \"o1\"\n"
+      "  chnset a2, \"o2\"\n"
+      "  chnset a3, \"o3\"\n"
+      "  chnset a4, \"o4\"\n";
+    static MYFLT a0[NSMPS], k0[NBLK], a2[NSMPS], k2[NBLK];
+    int32  len = (int32) (FL(62.6) * (esr * FL(0.001)));
+    int    b, t;
+
+    CU_ASSERT_EQUAL(render(body, 4), 0);
+    for (t = 0; t < NSMPS; t++) {
+      a0[t] = adel[t] * FL(1000.0);
+      a2[t] = lim(adel[t], FL(2.0) / esr, FL(0.0625)) * FL(1000.0);
+    }
+    for (b = 0; b < NBLK; b++) {
+      k0[b] = kdel[b] * FL(1000.0);
+      k2[b] = lim(kdel[b], FL(2.0) / esr, FL(0.0625)) * FL(1000.0);
+    }
+    for (t = 0; t < 4; t++)
+      ring_init(&ring[t], len);
+    for (b = 0; b < NBLK; b++) {
+      t = b * KSMPS;
+      old_vdelay(&ring[0], &in[0][t], &a0[t], 1, &want[0][t]);
+      old_vdelay(&ring[1], &in[0][t], &k0[b], 0, &want[1][t]);
+      old_vdelay3(&ring[2], &in[0][t], &a2[t], 1, &want[2][t]);
+      old_vdelay3(&ring[3], &in[0][t], &k2[b], 0, &want[3][t]);
+    }
+    check("vdelay, a-rate", 0);
+    check("vdelay, k-rate", 1);
+    check("vdelay3, a-rate", 2);
+    check("vdelay3, k-rate", 3);
+}
+
+/* from half the window up to maxdel, in a line of 2064 */
+static void run_vdelayx(int w) {
+    static const char *body[2] = {
+      "  a1 vdelayx ain1, limit(adel, 4/sr, imax), 0.063, 8\n"
+      "  a2, a3 vdelayxs ain1, ain2, limit(adel, 4/sr, imax), 0.063, 8\n"
+      "  a4, a5, a6, a7 vdelayxq ain1, ain2, ain3, ain4, "
+      "limit(adel, 8/sr, imax), 0.063, 16\n",
+      "  a1 vdelayxw ain1, limit(adel, 4/sr, imax), 0.063, 8\n"
+      "  a2, a3 vdelayxws ain1, ain2, limit(adel, 4/sr, imax), 0.063, 8\n"
+      "  a4, a5, a6, a7 vdelayxwq ain1, ain2, ain3, ain4, "
+      "limit(adel, 8/sr, imax), 0.063, 16\n"
+    };
+    static const char *outs =
+      "  chnset a1, \"o1\"\n"
+      "  chnset a2, \"o2\"\n"
+      "  chnset a3, \"o3\"\n"
+      "  chnset a4, \"o4\"\n"
+      "  chnset a5, \"o5\"\n"
+      "  chnset a6, \"o6\"\n"
+      "  chnset a7, \"o7\"\n";
+    static MYFLT a4[NSMPS], a8[NSMPS];
+    static const int chn[7] = { 0, 0, 1, 0, 1, 2, 3 };
+    char   orc[1024];
+    int32  len = (int32) (FL(0.063) * esr);
+    int    b, t, i, wsize;
+
+    snprintf(orc, 1024, "%s%s", body[w], outs);
+    CU_ASSERT_EQUAL(render(orc, 7), 0);
+    arange(a4, 4, MAXDEL);
+    arange(a8, 8, MAXDEL);
+    for (i = 0; i < 7; i++)
+      ring_init(&ring[i], len);
+    for (b = 0; b < NBLK; b++) {
+      t = b * KSMPS;
+      for (i = 0; i < 7; i++) {
+        wsize = vdelx_wsize(i < 3 ? FL(8.0) : FL(16.0));
+        if (w)
+          old_vdelayxw(&ring[i], &in[chn[i]][t], i < 3 ? &a4[t] : &a8[t],
+                       wsize, &want[i][t]);
+        else
+          old_vdelayx(&ring[i], &in[chn[i]][t], i < 3 ? &a4[t] : &a8[t],
+                      wsize, &want[i][t]);
+      }
+    }
+    check(w ? "vdelayxw" : "vdelayx", 0);
+    check(w ? "vdelayxws, 1" : "vdelayxs, 1", 1);
+    check(w ? "vdelayxws, 2" : "vdelayxs, 2", 2);
+    for (i = 3; i < 7; i++)
+      check(w ? "vdelayxwq" : "vdelayxq", i);
+}
+
+void test_vdelayx(void) {
+    run_vdelayx(0);
+}
+
+void test_vdelayxw(void) {
+    run_vdelayx(1);
+}
+
+/* taps at maxdel, 0 (maxdel again), 2 samples and in between */
+void test_multitap(void) {
+    static const char *body =
+      "  a1 multitap ain1, 0.0625, 0.5, 0, 0.125, 0.00006103515625, 0.75, "
+      "0.015625, -0.25\n"
+      "  chnset a1, \"o1\"\n";
+    static const MYFLT tg[8] = {
+      FL(0.0625), FL(0.5), FL(0.0), FL(0.125),
+      FL(0.00006103515625), FL(0.75), FL(0.015625), FL(-0.25)
+    };
+    int    b;
+
+    CU_ASSERT_EQUAL(render(body, 1), 0);
+    ring_init(&ring[0], MAXDEL);
+    for (b = 0; b < NBLK; b++)
+      old_multitap(&ring[0], &in[0][b * KSMPS], tg, 4, &want[0][b * KSMPS]);
+    check("multitap", 0);
+}
+
+int main(int argc, char **argv)
+{
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Delay opcode tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "delay", test_delay))
+        || (NULL == CU_add_test(pSuite, "delayr, delayw and the taps",
+                                test_deltap))
+        || (NULL == CU_add_test(pSuite, "deltapxw", test_deltapxw))
+        || (NULL == CU_add_test(pSuite, "vdelay and vdelay3", test_vdelay))
+        || (NULL == CU_add_test(pSuite, "vdelayx, vdelayxs and vdelayxq",
+                                test_vdelayx))
+        || (NULL == CU_add_test(pSuite, "vdelayxw, vdelayxws and vdelayxwq",
+                                test_vdelayxw))
+        || (NULL == CU_add_test(pSuite, "multitap", test_multitap))
+        ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    signals();
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,322 @@
+/*
+ * File:   delayline_test.c
+ *
+ * Tests and benchmark for the multi-tap delay lines
+ * (OOps/delayline.c)
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "csoundCore.h"
+#include "CUnit/Basic.h"
+
+#ifdef USE_DOUBLE
+#define DL_TOL 1e-9
+#else
+#define DL_TOL 1e-4
+#endif
+
+#define BLK     64
+#define NBLK    100
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+/* the lines live in an AUXCH, which needs an instance */
+static INSDS ins;
+
+static CSOUND *start(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    memset(&ins, 0, sizeof(INSDS));
+    csound->curip = &ins;
+    return csound;
+}
+
+static void stop(CSOUND *csound, AUXCH *aux) {
+    csound->Free(csound, aux->auxp);
+    csoundDestroy(csound);
+}
+
+/* everything written to the line, silence before it */
+static double hist[NBLK * BLK];
+
+static double at(int32 j) {
+    return j < 0 ? 0.0 : hist[j];
+}
+
+/* the interpolations, at time t and a delay d in the line */
+static double ref_read(int32 t, double d, int interp, int wsize) {
+    double  pos = t - d, x, sum = 0.0, d2x;
+    int32   i = (int32) floor(pos), k, i2 = wsize >> 1;
+
+    x = pos - i;
+    switch (interp) {
+    case CS_DELAY_NONE:
+      return at(t - (int32) d);
+    case CS_DELAY_LINEAR:
+      return at(i) + x * (at(i + 1) - at(i));
+    case CS_DELAY_CUBIC:
+    case CS_DELAY_CUBICX:
+      return at(i) + x * (-at(i - 1) / 3.0 - at(i) / 2.0 + at(i + 1)
+                          - at(i + 2) / 6.0)
+        + x * x * (at(i - 1) / 2.0 - at(i) + at(i + 1) / 2.0)
+        + x * x * x * (-at(i - 1) / 6.0 + at(i) / 2.0 - at(i + 1) / 2.0
+                       + at(i + 2) / 6.0);
+    }
+    if (x < 1e-8)
+      return at(i);
+    d2x = (1.0 - pow(wsize * 0.85172, -0.89624)) / (i2 * i2);
+    for (k = 1 - i2; k <= i2; k++) {
+      double w = 1.0 - (k - x) * (k - x) * d2x;
+      sum += at(i + k) * w * w * sin(PI * (x - k)) / (PI * (x - k));
+    }
+    return sum;
+}
+
+static void fill(MYFLT *in, int32 t) {
+    int     n;
+
+    for (n = 0; n < BLK; n++) {
+      hist[t + n] = (double) rand() / RAND_MAX - 0.5;
+      in[n] = (MYFLT) hist[t + n];
+    }
+}
+
+/* each interpolation with k and a-rate delays, read after the block is
+   written as vdelay does */
+void test_delayline_interp(void) {
+    CSOUND  *csound = start();
+    AUXCH   aux = { NULL, 0, NULL, NULL };
+    int32   len = 1000;
+    int     modes[6] = { CS_DELAY_NONE, CS_DELAY_LINEAR, CS_DELAY_CUBIC,
+                         CS_DELAY_CUBICX, CS_DELAY_SINC, CS_DELAY_SINC };
+    int     wsizes[6] = { 0, 0, 0, 0, 8, 64 }, m, k, n, r;
+    MYFLT   in[BLK], out[BLK], del[BLK];
+    CS_DELAYTAP tap;
+    CS_DELAYLINE *line;
+
+    srand(1);
+    for (m = 0; m < 6; m++) {
+      double err = 0.0;
+      line = csound->DelayLineCreate(csound, &aux, 1, &len,
+                                     BLK + CS_DELAY_MAXWIN);
+      CU_ASSERT_PTR_NOT_NULL_FATAL(line);
+      memset(hist, 0, sizeof(hist));
+      for (k = 0; k < NBLK; k++) {
+        int32 s = line->wpos;
+        fill(in, k * BLK);
+        csound->DelayLineWrite(csound, line, in, BLK);
+        for (r = 0; r < 2; r++) {
+          tap.out = out; tap.del = del;
+          tap.scale = FL(1.0); tap.gain = FL(1.0);
+          tap.arate = r; tap.add = 0;
+          for (n = 0; n < BLK; n++)
+            del[n] = 40.0 + (len - 80.0) * rand() / RAND_MAX;
+          csound->DelayLineRead(csound, line, &tap, 1, s, 0, BLK,
+                                modes[m], wsizes[m]);
+          for (n = 0; n < BLK; n++) {
+            double ref = ref_read(k * BLK + n, del[r ? n : 0], modes[m],
+                                  wsizes[m]);
+            if (fabs(out[n] - ref) > err)
+              err = fabs(out[n] - ref);
+          }
+        }
+      }
+      CU_ASSERT(err < DL_TOL);
+    }
+    stop(csound, &aux);
+}
+
+/* delays wrap as in a circular buffer of the nominal length, whether the
+   block is read before (delayr and deltap) or after (vdelay) it is
+   written */
+void test_delayline_wrap(void) {
+    CSOUND  *csound = start();
+    AUXCH   aux = { NULL, 0, NULL, NULL };
+    int32   len = 100, dels[8] = { 0, 1, 5, 63, 64, 99, 100, 250 };
+    MYFLT   in[BLK], out[8][BLK], del[8];
+    CS_DELAYTAP taps[8];
+    CS_DELAYLINE *line;
+    int     k, n, j, after;
+    double  err = 0.0;
+
+    for (after = 0; after < 2; after++) {
+      line = csound->DelayLineCreate(csound, &aux, 1, &len, BLK);
+      memset(hist, 0, sizeof(hist));
+      for (j = 0; j < 8; j++) {
+        del[j] = dels[j];
+        taps[j].out = out[j]; taps[j].del = &del[j];
+        taps[j].scale = FL(1.0); taps[j].gain = FL(1.0);
+        taps[j].arate = 0; taps[j].add = 0;
+      }
+      for (k = 0; k < NBLK; k++) {
+        int32 t = k * BLK, s = line->wpos;
+        fill(in, t);
+        if (after)
+          csound->DelayLineWrite(csound, line, in, BLK);
+        csound->DelayLineRead(csound, line, taps, 8, s, 0, BLK,
+                              CS_DELAY_NONE, 0);
+        if (!after)
+          csound->DelayLineWrite(csound, line, in, BLK);
+        for (j = 0; j < 8; j++)
+          for (n = 0; n < BLK; n++) {
+            /* the last sample written to the slot */
+            int32 i = t + n - dels[j] % len;
+            while (i >= t + (after ? BLK : 0))
+              i -= len;
+            if (fabs(out[j][n] - at(i)) > err)
+              err = fabs(out[j][n] - at(i));
+          }
+      }
+    }
+    CU_ASSERT(err < DL_TOL);
+    stop(csound, &aux);
+}
+
+/* taps summed with gains, and a sample accurate start and end */
+void test_delayline_taps(void) {
+    CSOUND  *csound = start();
+    AUXCH   aux = { NULL, 0, NULL, NULL };
+    int32   lens[2] = { 500, 3000 };
+    MYFLT   in[BLK], out[BLK], del[16];
+    CS_DELAYTAP taps[16];
+    CS_DELAYLINE *line;
+    int     k, n, j;
+    double  err = 0.0;
+
+    line = csound->DelayLineCreate(csound, &aux, 2, lens, BLK);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(line);
+    CU_ASSERT_EQUAL(line[1].len, 3000);
+    memset(hist, 0, sizeof(hist));
+    for (j = 0; j < 16; j++) {
+      del[j] = 2.0 + 27.7 * j;
+      taps[j].out = out; taps[j].del = &del[j];
+      taps[j].scale = FL(0.5); taps[j].gain = FL(1.0) / (j + 1);
+      taps[j].arate = 0; taps[j].add = (j > 0);
+    }
+    for (k = 0; k < NBLK; k++) {
+      int32 s = line[1].wpos;
+      fill(in, k * BLK);
+      csound->DelayLineWrite(csound, &line[1], in, BLK);
+      for (n = 0; n < BLK; n++)
+        out[n] = FL(-1.0);
+      csound->DelayLineRead(csound, &line[1], taps, 16, s, 3, BLK - 5,
+                            CS_DELAY_LINEAR, 0);
+      CU_ASSERT_EQUAL(out[2], FL(-1.0));
+      CU_ASSERT_EQUAL(out[BLK - 5], FL(-1.0));
+      for (n = 3; n < BLK - 5; n++) {
+        double ref = 0.0;
+        for (j = 0; j < 16; j++)
+          ref += ref_read(k * BLK + n, 0.5 * del[j], CS_DELAY_LINEAR, 0)
+            / (j + 1);
+        if (fabs(out[n] - ref) > err)
+          err = fabs(out[n] - ref);
+      }
+    }
+    CU_ASSERT(err < DL_TOL * 10);
+    stop(csound, &aux);
+}
+
+/* 16 taps with linear interpolation, per sample as vdelay read them and
+   by block, with modulated and with fixed delays */
+void test_delayline_benchmark(void) {
+    CSOUND  *csound = start();
+    AUXCH   aux = { NULL, 0, NULL, NULL };
+    int32   len = 48000, blocks = 20000, indx = 0, b, n, j, r;
+    MYFLT   *buf = (MYFLT*) calloc(len, sizeof(MYFLT));
+    MYFLT   in[BLK], out[BLK], del[16][BLK];
+    CS_DELAYTAP taps[16];
+    CS_DELAYLINE *line = csound->DelayLineCreate(csound, &aux, 1, &len, BLK);
+    clock_t t0;
+    double  told, tnew;
+
+    for (n = 0; n < BLK; n++)
+      in[n] = sin(0.1 * n);
+    for (r = 1; r >= 0; r--) {
+      for (j = 0; j < 16; j++) {
+        for (n = 0; n < BLK; n++)
+          del[j][n] = 1000.5 + 2000.0 * j + r * 10.0 * sin(0.01 * n + j);
+        taps[j].out = out; taps[j].del = del[j];
+        taps[j].scale = FL(1.0); taps[j].gain = FL(1.0);
+        taps[j].arate = r; taps[j].add = (j > 0);
+      }
+      t0 = clock();
+      for (b = 0; b < blocks; b++) {
+        for (n = 0; n < BLK; n++) {
+          buf[indx] = in[n];
+          out[n] = FL(0.0);
+          for (j = 0; j < 16; j++) {
+            MYFLT fv1 = indx - del[j][r ? n : 0], fv2, frac;
+            int32 v1, v2;
+            while (fv1 < FL(0.0))
+              fv1 += len;
+            v1 = (int32) fv1;
+            v2 = (v1 == len - 1 ? 0 : v1 + 1);
+            frac = fv1 - v1;
+            fv2 = buf[v1];
+            out[n] += fv2 + frac * (buf[v2] - fv2);
+          }
+          if (++indx == len)
+            indx = 0;
+        }
+      }
+      told = (double) (clock() - t0) / CLOCKS_PER_SEC;
+      t0 = clock();
+      for (b = 0; b < blocks; b++) {
+        int32 s = line->wpos;
+        csound->DelayLineWrite(csound, line, in, BLK);
+        csound->DelayLineRead(csound, line, taps, 16, s, 0, BLK,
+                              CS_DELAY_LINEAR, 0);
+      }
+      tnew = (double) (clock() - t0) / CLOCKS_PER_SEC;
+      printf("\n16 %s taps, %d blocks of %d: %.3f s per sample, "
+             "%.3f s by block", r ? "a-rate" : "k-rate", blocks, BLK,
+             told, tnew);
+    }
+    printf("\n");
+    free(buf);
+    CU_PASS("benchmark");
+    stop(csound, &aux);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("delay line tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test interpolations",
+                             test_delayline_interp)) ||
+        (NULL == CU_add_test(pSuite, "Test wrap-around",
+                             test_delayline_wrap)) ||
+        (NULL == CU_add_test(pSuite, "Test taps", test_delayline_taps)) ||
+        (NULL == CU_add_test(pSuite, "Benchmark",
+                             test_delayline_benchmark))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,210 @@
+/*
+ * File:   fft_test.c
+ *
+ * Tests and benchmark for the planned mixed-radix FFT (OOps/mxfft.c)
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "csoundCore.h"
+#include "fftlib.h"
+#include "CUnit/Basic.h"
+
+#ifdef USE_DOUBLE
+#define FFT_TOL 1e-9
+#else
+#define FFT_TOL 1e-3
+#endif
+
+/* powers of two, 2/3/5/7-smooth sizes, odd sizes and prime factors */
+static const int sizes[] = { 6, 10, 12, 14, 22, 30, 96, 100, 210, 1000,
+                             1323, 1920, 2018, 2400, 2646, 4410, 9, 15,
+                             49, 97, 0 };
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static void fill(MYFLT *buf, int N) {
+    int i;
+    for (i = 0; i < N; i++)
+      buf[i] = sin(i * 0.37) + 0.5 * cos(i * i * 0.01) + (i % 7) * 0.1;
+}
+
+/* largest deviation from a direct DFT, relative to the spectrum peak */
+static double dft_error(const MYFLT *in, const MYFLT *spec, int N) {
+    double err = 0.0, peak = 0.0;
+    int    j, k;
+    for (k = 0; k <= N / 2; k++) {
+      double re = 0.0, im = 0.0, sr, si;
+      for (j = 0; j < N; j++) {
+        double a = -2.0 * PI * (double) (((long) j * k) % N) / N;
+        re += in[j] * cos(a);
+        im += in[j] * sin(a);
+      }
+      sr = (k == N / 2 && !(N & 1)) ? spec[N] : spec[2 * k];
+      si = (k == 0 || (k == N / 2 && !(N & 1))) ? 0.0 : spec[2 * k + 1];
+      err = fmax(err, fabs(sr - re) + fabs(si - im));
+      peak = fmax(peak, fabs(re) + fabs(im));
+    }
+    return err / peak;
+}
+
+void test_real_fft_np2(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    int    s, i;
+
+    for (s = 0; sizes[s]; s++) {
+      int   N = sizes[s];
+      MYFLT *in = csound->Malloc(csound, (N + 2) * sizeof(MYFLT));
+      MYFLT *buf = csound->Malloc(csound, (N + 2) * sizeof(MYFLT));
+      double err = 0.0;
+      fill(in, N);
+      memcpy(buf, in, N * sizeof(MYFLT));
+      buf[N] = buf[N + 1] = FL(0.0);
+      csoundRealFFTnp2(csound, buf, N);
+      CU_ASSERT(dft_error(in, buf, N) < FFT_TOL);
+      csoundInverseRealFFTnp2(csound, buf, N);
+      for (i = 0; i < N; i++)
+        err = fmax(err, fabs(buf[i] - in[i]));
+      CU_ASSERT(err < FFT_TOL);
+      csound->Free(csound, in);
+      csound->Free(csound, buf);
+    }
+    csoundDestroy(csound);
+}
+
+void test_real_fft2_setup(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    int    s, i;
+
+    csoundSetOption(csound, "-n");
+    for (s = 0; sizes[s]; s++) {
+      int   N = sizes[s];
+      void  *fwd, *inv;
+      MYFLT *in, *buf;
+      double err = 0.0;
+      if (N & 1)
+        continue;
+      in = csound->Malloc(csound, (N + 2) * sizeof(MYFLT));
+      buf = csound->Malloc(csound, (N + 2) * sizeof(MYFLT));
+      fwd = csound->RealFFT2Setup(csound, N, FFT_FWD);
+      inv = csound->RealFFT2Setup(csound, N, FFT_INV);
+      fill(in, N);
+      memcpy(buf, in, N * sizeof(MYFLT));
+      csound->RealFFT2(csound, fwd, buf);
+      /* packed format: Nyquist in buf[1] */
+      buf[N] = buf[1];
+      buf[1] = FL(0.0);
+      CU_ASSERT(dft_error(in, buf, N) < FFT_TOL);
+      buf[1] = buf[N];
+      csound->RealFFT2(csound, inv, buf);
+      for (i = 0; i < N; i++)
+        err = fmax(err, fabs(buf[i] - in[i]));
+      CU_ASSERT(err < FFT_TOL);
+      csound->Free(csound, in);
+      csound->Free(csound, buf);
+    }
+    csoundDestroy(csound);
+}
+
+void test_complex_fft_np2(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    int    s, i;
+
+    for (s = 0; sizes[s]; s++) {
+      int   n = sizes[s];
+      MYFLT *in = csound->Malloc(csound, 2 * n * sizeof(MYFLT));
+      MYFLT *buf = csound->Malloc(csound, 2 * n * sizeof(MYFLT));
+      double err = 0.0;
+      fill(in, 2 * n);
+      memcpy(buf, in, 2 * n * sizeof(MYFLT));
+      csoundComplexFFTnp2(csound, buf, n);
+      csoundInverseComplexFFTnp2(csound, buf, n);
+      for (i = 0; i < 2 * n; i++)
+        err = fmax(err, fabs(buf[i] - in[i]));
+      CU_ASSERT(err < FFT_TOL);
+      csound->Free(csound, in);
+      csound->Free(csound, buf);
+    }
+    csoundDestroy(csound);
+}
+
+/* microseconds per forward + inverse pair */
+static double time_fft2(CSOUND *csound, int N, int reps) {
+    void    *fwd = csound->RealFFT2Setup(csound, N, FFT_FWD);
+    void    *inv = csound->RealFFT2Setup(csound, N, FFT_INV);
+    MYFLT   *buf = csound->Malloc(csound, (N + 2) * sizeof(MYFLT));
+    clock_t t0;
+    int     i;
+
+    fill(buf, N);
+    t0 = clock();
+    for (i = 0; i < reps; i++) {
+      csound->RealFFT2(csound, fwd, buf);
+      csound->RealFFT2(csound, inv, buf);
+    }
+    csound->Free(csound, buf);
+    return 1e6 * (double) (clock() - t0) / CLOCKS_PER_SEC / reps;
+}
+
+/* with fft_lib=0 only powers of two use fftlib, with fft_lib=1 pffft is
+   used for 32 * 2^a * 3^b * 5^c; all other sizes use the planned FFT */
+void test_fft_benchmark(void) {
+    static const int bsizes[] = { 960, 1024, 1920, 2048, 2400, 2646,
+                                  4096, 4410, 4800, 0 };
+    CSOUND *fftlib = csoundCreate(NULL), *pffft = csoundCreate(NULL);
+    int    s;
+
+    csoundSetOption(fftlib, "--fftlib=0");
+    csoundSetOption(pffft, "--fftlib=1");
+    printf("\n%8s %16s %16s\n", "size", "fft_lib=0 (us)", "fft_lib=1 (us)");
+    for (s = 0; bsizes[s]; s++) {
+      int N = bsizes[s], reps = 2000000 / N;
+      printf("%8d %16.2f %16.2f\n", N, time_fft2(fftlib, N, reps),
+             time_fft2(pffft, N, reps));
+    }
+    csoundDestroy(fftlib);
+    csoundDestroy(pffft);
+    CU_PASS("benchmark");
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("FFT tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test real FFT np2", test_real_fft_np2)) ||
+        (NULL == CU_add_test(pSuite, "Test RealFFT2Setup",
+                             test_real_fft2_setup)) ||
+        (NULL == CU_add_test(pSuite, "Test complex FFT np2",
+                             test_complex_fft_np2)) ||
+        (NULL == CU_add_test(pSuite, "Benchmark FFT", test_fft_benchmark))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
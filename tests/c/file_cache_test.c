@@ -0,0 +1,138 @@
+/*
+ * File:   file_cache_test.c
+ *
+ * Tests for the cached search path resolution of input files
+ * (file_index_resolve() in Engine/envvar.c)
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "csoundCore.h"
+#include "envvar.h"
+#include "CUnit/Basic.h"
+
+#define FC_DIR1     "file_cache_d1"
+#define FC_DIR2     "file_cache_d2"
+
+int init_suite1(void) {
+    mkdir(FC_DIR1, 0755);
+    mkdir(FC_DIR2, 0755);
+    mkdir(FC_DIR1 "/sub", 0755);
+    mkdir(FC_DIR2 "/sub", 0755);
+    return 0;
+}
+
+int clean_suite1(void) {
+    remove(FC_DIR1 "/a.wav");
+    remove(FC_DIR2 "/a.wav");
+    remove(FC_DIR1 "/sub/b.wav");
+    remove(FC_DIR2 "/sub/b.wav");
+    rmdir(FC_DIR1 "/sub");
+    rmdir(FC_DIR2 "/sub");
+    rmdir(FC_DIR1);
+    rmdir(FC_DIR2);
+    return 0;
+}
+
+static void touch(const char *name) {
+    FILE *f = fopen(name, "w");
+    if (f != NULL)
+      fclose(f);
+}
+
+/* the directory name of the file found, or "" */
+static char *found(CSOUND *csound, const char *name, char *dir) {
+    char *path = csoundFindInputFile(csound, name, "SFDIR");
+    dir[0] = '\0';
+    if (path != NULL) {
+      strncpy(dir, path, strlen(FC_DIR1));
+      dir[strlen(FC_DIR1)] = '\0';
+      csound->Free(csound, path);
+    }
+    return dir;
+}
+
+void test_file_cache(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    char   dir[64];
+    int    i;
+
+    /* the last directory of the list is searched first */
+    csoundSetEnv(csound, "SFDIR", FC_DIR1 ";" FC_DIR2);
+    CU_ASSERT_STRING_EQUAL(found(csound, "a.wav", dir), "");
+    touch(FC_DIR1 "/a.wav");
+    for (i = 0; i < 100; i++)
+      CU_ASSERT_STRING_EQUAL(found(csound, "a.wav", dir), FC_DIR1);
+    /* a file shadowing the one found */
+    touch(FC_DIR2 "/a.wav");
+    csoundClearFileCache(csound);
+    CU_ASSERT_STRING_EQUAL(found(csound, "a.wav", dir), FC_DIR2);
+    /* a stale name is looked up again */
+    remove(FC_DIR2 "/a.wav");
+    CU_ASSERT_STRING_EQUAL(found(csound, "a.wav", dir), FC_DIR1);
+    remove(FC_DIR1 "/a.wav");
+    csoundClearFileCache(csound);
+    CU_ASSERT_STRING_EQUAL(found(csound, "a.wav", dir), "");
+    /* resolved names are dropped with the search paths */
+    touch(FC_DIR2 "/a.wav");
+    csoundSetEnv(csound, "SFDIR", FC_DIR2);
+    CU_ASSERT_STRING_EQUAL(found(csound, "a.wav", dir), FC_DIR2);
+    csoundDestroy(csound);
+}
+
+/* names with directories are looked up in the listing of their own
+ * directory, not of its first component */
+void test_file_cache_subdir(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    char   dir[64];
+    int    i;
+
+    /* FC_DIR2/sub, searched first, does not have the file */
+    csoundSetEnv(csound, "SFDIR", FC_DIR1 ";" FC_DIR2);
+    touch(FC_DIR1 "/sub/b.wav");
+    for (i = 0; i < 100; i++)
+      CU_ASSERT_STRING_EQUAL(found(csound, "sub/b.wav", dir), FC_DIR1);
+    touch(FC_DIR2 "/sub/b.wav");
+    csoundClearFileCache(csound);
+    CU_ASSERT_STRING_EQUAL(found(csound, "sub/b.wav", dir), FC_DIR2);
+    remove(FC_DIR2 "/sub/b.wav");
+    CU_ASSERT_STRING_EQUAL(found(csound, "sub/b.wav", dir), FC_DIR1);
+    remove(FC_DIR1 "/sub/b.wav");
+    csoundClearFileCache(csound);
+    CU_ASSERT_STRING_EQUAL(found(csound, "sub/b.wav", dir), "");
+    csoundDestroy(csound);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("file cache tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test search path cache",
+                             test_file_cache)) ||
+        (NULL == CU_add_test(pSuite, "Test search path cache subdirectories",
+                             test_file_cache_subdir))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
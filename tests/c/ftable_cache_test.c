@@ -0,0 +1,303 @@
+/*
+ * File:   ftable_cache_test.c
+ *
+ * Tests for the persistent cache of function tables
+ * (Engine/fgens_cache.c)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "csound.h"
+#include "CUnit/Basic.h"
+
+#define LEN     65536
+
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "gi1 ftgen 1, 0, 65536, 10, 1, 0.5, 0.3, 0.25, 0.2\n"
+    "gi2 ftgen 2, 0, 65536, 30, 1, 1, 3\n"
+    "gi3 ftgen 3, 0, 16, 10, 1\n";
+
+static char cachedir[] = "/tmp/csftcacheXXXXXX";
+
+int init_suite1(void) {
+    return (mkdtemp(cachedir) == NULL);
+}
+
+int clean_suite1(void) {
+    DIR     *dir = opendir(cachedir);
+    struct dirent *ent;
+    char    path[256];
+
+    while (dir != NULL && (ent = readdir(dir)) != NULL) {
+      if (ent->d_name[0] == '.') continue;
+      snprintf(path, 256, "%s/%s", cachedir, ent->d_name);
+      remove(path);
+    }
+    if (dir != NULL)
+      closedir(dir);
+    remove(cachedir);
+    return 0;
+}
+
+static int cache_files(void) {
+    DIR     *dir = opendir(cachedir);
+    struct dirent *ent;
+    int     cnt = 0;
+
+    while ((ent = readdir(dir)) != NULL)
+      cnt += (strstr(ent->d_name, ".ft") != NULL);
+    closedir(dir);
+    return cnt;
+}
+
+/* bytes of the cache files */
+static long cache_bytes(void) {
+    DIR     *dir = opendir(cachedir);
+    struct dirent *ent;
+    struct stat st;
+    char    path[256];
+    long    n = 0;
+
+    while ((ent = readdir(dir)) != NULL) {
+      if (strstr(ent->d_name, ".ft") == NULL) continue;
+      snprintf(path, 256, "%s/%s", cachedir, ent->d_name);
+      if (stat(path, &st) == 0)
+        n += (long) st.st_size;
+    }
+    closedir(dir);
+    return n;
+}
+
+/* swap sample n of each cache file with x[], in directory order; the
+   data offset is the last field of the file header, at byte 28 */
+static int tamper(int n, MYFLT *x) {
+    DIR     *dir = opendir(cachedir);
+    struct dirent *ent;
+    char    path[256];
+    FILE    *f;
+    uint32_t offset;
+    MYFLT   old;
+    int     cnt = 0;
+
+    while ((ent = readdir(dir)) != NULL) {
+      if (strstr(ent->d_name, ".ft") == NULL) continue;
+      snprintf(path, 256, "%s/%s", cachedir, ent->d_name);
+      f = fopen(path, "r+b");
+      CU_ASSERT_PTR_NOT_NULL_FATAL(f);
+      fseek(f, 28L, SEEK_SET);
+      CU_ASSERT_EQUAL(fread(&offset, sizeof(uint32_t), 1, f), 1);
+      fseek(f, (long) (offset + n * sizeof(MYFLT)), SEEK_SET);
+      CU_ASSERT_EQUAL(fread(&old, sizeof(MYFLT), 1, f), 1);
+      fseek(f, (long) (offset + n * sizeof(MYFLT)), SEEK_SET);
+      fwrite(&x[cnt], sizeof(MYFLT), 1, f);
+      fclose(f);
+      x[cnt++] = old;
+    }
+    closedir(dir);
+    return cnt;
+}
+
+/* make the tables of orc, copying tables 1 and 2 to tab */
+static CSOUND *start(const char *orch, MYFLT *tab) {
+    CSOUND *csound = csoundCreate(NULL);
+    char   option[64];
+    MYFLT  *t;
+    int    i;
+
+    snprintf(option, 64, "--env:CSFTCACHE=%s", cachedir);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, option);
+    CU_ASSERT_EQUAL(csoundCompileOrc(csound, orch), 0);
+    csoundStart(csound);
+    for (i = 1; i <= 2; i++) {
+      CU_ASSERT_EQUAL_FATAL(csoundGetTable(csound, &t, i), LEN);
+      memcpy(tab + (i - 1) * (LEN + 1), t, sizeof(MYFLT) * (LEN + 1));
+    }
+    return csound;
+}
+
+/* tables read back are the ones made; small tables are not stored */
+void test_ftable_cache(void) {
+    MYFLT  *ref = malloc(sizeof(MYFLT) * 2 * (LEN + 1));
+    MYFLT  *tab = malloc(sizeof(MYFLT) * 2 * (LEN + 1));
+    MYFLT  *t;
+    CSOUND *csound;
+
+    csound = start(orc, ref);
+    csoundDestroy(csound);
+    CU_ASSERT_EQUAL(cache_files(), 2);
+    csound = start(orc, tab);
+    CU_ASSERT_EQUAL(memcmp(ref, tab, sizeof(MYFLT) * 2 * (LEN + 1)), 0);
+    /* cached tables can be written to */
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &t, 1), LEN);
+    csoundTableSet(csound, 1, 5, FL(0.125));
+    CU_ASSERT_EQUAL(csoundTableGet(csound, 1, 5), FL(0.125));
+    csoundDestroy(csound);
+    CU_ASSERT_EQUAL(cache_files(), 2);
+    free(ref);
+    free(tab);
+}
+
+/* tables are read from the cache and not made again: data written
+   into the cache files shows in the tables.  Only table 1 is made, as
+   a changed table 1 would give table 2 a new key. */
+void test_ftable_cache_hit(void) {
+    static const char *orc1 =
+      "sr = 48000\n"
+      "ksmps = 64\n"
+      "nchnls = 1\n"
+      "0dbfs = 1\n"
+      "gi1 ftgen 1, 0, 65536, 10, 1, 0.5, 0.3, 0.25, 0.2\n";
+    MYFLT  x[2] = { FL(0.875), FL(0.875) };
+    MYFLT  *t;
+    char   option[64];
+    CSOUND *csound;
+
+    CU_ASSERT_EQUAL_FATAL(tamper(7, x), 2);
+    csound = csoundCreate(NULL);
+    snprintf(option, 64, "--env:CSFTCACHE=%s", cachedir);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, option);
+    CU_ASSERT_EQUAL(csoundCompileOrc(csound, orc1), 0);
+    csoundStart(csound);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &t, 1), LEN);
+    CU_ASSERT_EQUAL(t[7], FL(0.875));
+    CU_ASSERT_NOT_EQUAL(t[8], FL(0.875));
+    csoundDestroy(csound);
+    CU_ASSERT_EQUAL(cache_files(), 2);
+    /* put the tables back as they were made */
+    tamper(7, x);
+}
+
+/* a change of the source table makes a new key for GEN30 */
+void test_ftable_cache_source(void) {
+    MYFLT  *tab = malloc(sizeof(MYFLT) * 2 * (LEN + 1));
+    char   *orc2 = malloc(strlen(orc) + 1), *s;
+    CSOUND *csound;
+
+    strcpy(orc2, orc);
+    s = strstr(orc2, "0.25");
+    s[3] = '6';
+    csound = start(orc2, tab);
+    csoundDestroy(csound);
+    CU_ASSERT_EQUAL(cache_files(), 4);
+    free(orc2);
+    free(tab);
+}
+
+/* a GEN30 of a missing table is not cached, and is not read back from
+   any cache file */
+void test_ftable_cache_missing(void) {
+    static const char *orc3 =
+      "sr = 48000\n"
+      "ksmps = 64\n"
+      "nchnls = 1\n"
+      "0dbfs = 1\n"
+      "gi2 ftgen 2, 0, 65536, 30, 9, 1, 3\n";
+    DIR     *dir = opendir(cachedir);
+    struct dirent *ent;
+    char    src[256], dst[256], option[64];
+    FILE    *f, *g;
+    int     c;
+    MYFLT   *t;
+    CSOUND  *csound;
+
+    /* a valid cache file under the smallest key */
+    while ((ent = readdir(dir)) != NULL)
+      if (strstr(ent->d_name, ".ft") != NULL)
+        break;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(ent);
+    snprintf(src, 256, "%s/%s", cachedir, ent->d_name);
+    snprintf(dst, 256, "%s/%016llx.ft", cachedir, 1ULL);
+    closedir(dir);
+    f = fopen(src, "rb");
+    g = fopen(dst, "wb");
+    while ((c = getc(f)) != EOF)
+      putc(c, g);
+    fclose(f);
+    fclose(g);
+    csound = csoundCreate(NULL);
+    snprintf(option, 64, "--env:CSFTCACHE=%s", cachedir);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, option);
+    csoundCompileOrc(csound, orc3);
+    csoundStart(csound);
+    CU_ASSERT(csoundGetTable(csound, &t, 2) < 0);
+    csoundDestroy(csound);
+    CU_ASSERT_EQUAL(cache_files(), 5);
+}
+
+/* least recently used tables go once the cache is over its size */
+void test_ftable_cache_limit(void) {
+    static const char *orc4 =
+      "sr = 48000\n"
+      "ksmps = 64\n"
+      "nchnls = 1\n"
+      "0dbfs = 1\n"
+      "gi1 ftgen 1, 0, 65536, 10, 1\n"
+      "gi2 ftgen 2, 0, 65536, 10, 1, 1\n"
+      "gi3 ftgen 3, 0, 65536, 10, 1, 1, 1\n"
+      "gi4 ftgen 4, 0, 65536, 10, 1, 1, 1, 1\n"
+      "gi5 ftgen 5, 0, 65536, 10, 1, 1, 1, 1, 1\n";
+    CSOUND *csound;
+    char   option[64];
+    long   table = (long) sizeof(MYFLT) * (LEN + 1);
+
+    CU_ASSERT(cache_bytes() > 4 * table);
+    csound = csoundCreate(NULL);
+    snprintf(option, 64, "--env:CSFTCACHE=%s", cachedir);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, option);
+    /* room for three tables of 64K doubles, or seven of floats */
+    csoundSetOption(csound, "--env:CSFTCACHESIZE=2");
+    csoundCompileOrc(csound, orc4);
+    csoundStart(csound);
+    csoundDestroy(csound);
+    CU_ASSERT(cache_bytes() <= 2L << 20);
+    CU_ASSERT(cache_files() >= (int) ((2L << 20) / (table + 256)) - 1);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("function table cache tests", init_suite1,
+                          clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test table cache",
+                             test_ftable_cache)) ||
+        (NULL == CU_add_test(pSuite, "Test cache hits",
+                             test_ftable_cache_hit)) ||
+        (NULL == CU_add_test(pSuite, "Test source tables",
+                             test_ftable_cache_source)) ||
+        (NULL == CU_add_test(pSuite, "Test missing source tables",
+                             test_ftable_cache_missing)) ||
+        (NULL == CU_add_test(pSuite, "Test cache size limit",
+                             test_ftable_cache_limit))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,188 @@
+/*
+ * File:   ftgen_async_test.c
+ *
+ * Tests for the background generation of function tables
+ * (csoundFTGenAsync() in Engine/fgens.c, ftgenasync and ftready)
+ */
+
+#include <stdio.h>
+#include "csound.h"
+#include "CUnit/Basic.h"
+
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "gifn, gkok ftgenasync 0, 0, 1024, -7, 0, 1024, 1\n"
+    "instr 1\n"
+    "  ifn, kok ftgenasync 0, 0, 262144, 10, 1, 0.5, 0.3, 0.25\n"
+    "  iref ftgen 0, 0, 262144, 10, 1, 0.5, 0.3, 0.25\n"
+    "  chnset ifn, \"fn\"\n"
+    "  chnset iref, \"ref\"\n"
+    "  chnset kok, \"ok\"\n"
+    "endin\n"
+    "instr 2\n"
+    "  kok ftready gifn\n"
+    "  chnset kok, \"gok\"\n"
+    "endin\n"
+    "instr 3\n"
+    "  ifn, kok ftgentmpasync 0, 0, 65536, 10, 1\n"
+    "  chnset ifn, \"tmp\"\n"
+    "endin\n"
+    "instr 4\n"
+    "  ifn, kok ftgenasync 0, 0, 1024, 999, 1\n"
+    "  chnset kok, \"bad\"\n"
+    "endin\n"
+    "instr 5\n"
+    "  isrc ftgen 0, 0, 4096, 10, 1, 1\n"
+    "  ifn, kok ftgenasync 0, 0, 4096, 30, isrc, 1, 2\n"
+    "  iref ftgen 0, 0, 4096, 30, isrc, 1, 2\n"
+    "  chnset ifn, \"fn30\"\n"
+    "  chnset iref, \"ref30\"\n"
+    "  chnset kok, \"ok30\"\n"
+    "endin\n"
+    "instr 6\n"
+    "  ifn, kok ftgenasync 0, 0, 4096, 18, 99, 1, 0, 4095\n"
+    "  chnset 1, \"missing\"\n"
+    "endin\n"
+    "instr 7\n"
+    "  ifn, kok ftgenasync 0, 0, 4096, 21, 1\n"
+    "  chnset i(kok), \"ok21\"\n"
+    "endin\n";
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static CSOUND *start(const char *score) {
+    CSOUND *csound = csoundCreate(NULL);
+
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, orc);
+    csoundReadScore(csound, score);
+    csoundStart(csound);
+    return csound;
+}
+
+/* perform until channel name is not 0, or for 2 seconds */
+static MYFLT wait_for(CSOUND *csound, const char *name) {
+    MYFLT val = 0.0;
+    int   k, err;
+
+    for (k = 0; k < 1500 && val == 0.0; k++) {
+      csoundPerformKsmps(csound);
+      val = csoundGetControlChannel(csound, name, &err);
+      if (val == 0.0)
+        csoundSleep(1);
+    }
+    return val;
+}
+
+/* the table made in the background is the one made at once */
+void test_ftgen_async(void) {
+    CSOUND *csound = start("i 1 0 10\ni 2 0 10\n");
+    MYFLT  *tab, *ref;
+    int    err, fn, fnref, n, i, diff = 0;
+
+    CU_ASSERT_EQUAL(wait_for(csound, "ok"), 1.0);
+    fn = (int) csoundGetControlChannel(csound, "fn", &err);
+    fnref = (int) csoundGetControlChannel(csound, "ref", &err);
+    CU_ASSERT(fn > 0 && fnref > 0 && fn != fnref);
+    n = csoundGetTable(csound, &tab, fn);
+    CU_ASSERT_EQUAL(n, 262144);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &ref, fnref), n);
+    for (i = 0; i < n; i++)
+      diff += (tab[i] != ref[i]);
+    CU_ASSERT_EQUAL(diff, 0);
+    /* generated in the global space, polled by another instrument */
+    CU_ASSERT_EQUAL(wait_for(csound, "gok"), 1.0);
+    csoundDestroy(csound);
+}
+
+/* temporary tables go with their note, failures are reported */
+void test_ftgentmp_async(void) {
+    CSOUND *csound = start("i 3 0 0.1\ni 4 0 1\n");
+    MYFLT  *tab;
+    int    err, fn;
+
+    CU_ASSERT_EQUAL(wait_for(csound, "bad"), -1.0);
+    fn = (int) csoundGetControlChannel(csound, "tmp", &err);
+    CU_ASSERT(fn > 0);
+    while (csoundGetScoreTime(csound) < 0.2)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &tab, fn), -1);
+    csoundDestroy(csound);
+}
+
+/* a table reading another is made from it in the background; one
+   reading a missing table fails at init, on the calling thread */
+void test_ftgen_async_sources(void) {
+    CSOUND *csound = start("i 5 0 1\ni 6 0 1\n");
+    MYFLT  *tab, *ref;
+    int    err, fn, fnref, n, i, diff = 0;
+
+    CU_ASSERT_EQUAL(wait_for(csound, "ok30"), 1.0);
+    fn = (int) csoundGetControlChannel(csound, "fn30", &err);
+    fnref = (int) csoundGetControlChannel(csound, "ref30", &err);
+    n = csoundGetTable(csound, &tab, fn);
+    CU_ASSERT_EQUAL(n, 4096);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &ref, fnref), n);
+    for (i = 0; i < n; i++)
+      diff += (tab[i] != ref[i]);
+    CU_ASSERT_EQUAL(diff, 0);
+    for (i = 0; i < 10; i++)
+      CU_ASSERT_EQUAL(csoundPerformKsmps(csound), 0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "missing", &err), 0.0);
+    csoundDestroy(csound);
+}
+
+/* random tables draw from the generator of the calling thread, so they
+   are made at once */
+void test_ftgen_async_random(void) {
+    CSOUND *csound = start("i 7 0 1\n");
+    int    err;
+
+    CU_ASSERT_EQUAL(csoundPerformKsmps(csound), 0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "ok21", &err), 1.0);
+    csoundDestroy(csound);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("background table generation tests", init_suite1,
+                          clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test ftgenasync", test_ftgen_async)) ||
+        (NULL == CU_add_test(pSuite, "Test ftgentmpasync",
+                             test_ftgentmp_async)) ||
+        (NULL == CU_add_test(pSuite, "Test source tables",
+                             test_ftgen_async_sources)) ||
+        (NULL == CU_add_test(pSuite, "Test random tables",
+                             test_ftgen_async_random))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,204 @@
+/*
+ * File:   ftgen_score_test.c
+ *
+ * Tests for the parallel generation of score f-statements
+ * (csoundFTGenScore() in Engine/fgens.c)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "csound.h"
+#include "CUnit/Basic.h"
+
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "endin\n";
+
+/* tables 21 and 22 read tables made in the same batch,
+   table 3 is replaced and table 4 deleted */
+static const char *sco =
+    "f 1 0 65536 10 1 0.5 0.3 0.25 0.2\n"
+    "f 2 0 65536 10 1 0 0.3 0 0.2\n"
+    "f 3 0 65536 7 0 65536 1\n"
+    "f 4 0 65536 9 1 1 0 3 0.3 0\n"
+    "f 5 0 65536 19 0.5 1 270 1\n"
+    "f 6 0 65536 -10 1 1 1 1 1 1 1 1\n"
+    "f 21 0 4096 18 1 1 0 2047 2 1 2048 4095\n"
+    "f 22 0 4096 -4 21 1\n"
+    "f 3 0 1024 7 1 1024 0\n"
+    "f -4 0\n"
+    "f 7 0.5 4096 10 1 1\n"
+    "f 8 0.5 4096 30 7 1 2\n"
+    "i 1 0 1\n";
+
+static const int fnums[] = { 1, 2, 3, 5, 6, 7, 8, 21, 22 };
+#define NFN ((int) (sizeof(fnums) / sizeof(int)))
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static CSOUND *start(const char *threads) {
+    CSOUND *csound = csoundCreate(NULL);
+
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, threads);
+    csoundCompileOrc(csound, orc);
+    csoundReadScore(csound, sco);
+    csoundStart(csound);
+    while (csoundPerformKsmps(csound) == 0)
+      ;
+    return csound;
+}
+
+/* the tables made by 4 threads are the ones made by one */
+void test_ftgen_score(void) {
+    CSOUND *ref = start("-j1"), *csound = start("-j4");
+    MYFLT  *t, *r;
+    int    i, n;
+
+    for (i = 0; i < NFN; i++) {
+      n = csoundGetTable(ref, &r, fnums[i]);
+      CU_ASSERT(n > 0);
+      CU_ASSERT_EQUAL(csoundGetTable(csound, &t, fnums[i]), n);
+      if (n > 0 && csoundGetTable(csound, &t, fnums[i]) == n)
+        CU_ASSERT_EQUAL(memcmp(t, r, sizeof(MYFLT) * (n + 1)), 0);
+    }
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &t, 3), 1024);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &t, 4), -1);
+    csoundDestroy(ref);
+    csoundDestroy(csound);
+}
+
+/* tables reading missing tables fail, the others are made */
+static const char *sco2 =
+    "f 1 0 4096 10 1\n"
+    "f 30 0 4096 18 99 1 0 4095\n"
+    "f 31 0 4096 52 1 99 0 1\n"
+    "f 32 0 4096 -4 98 1\n"
+    "f 33 0 4096 -4 1 1\n"
+    "f 34 0 4096 18 1 1 0 4095\n"
+    "i 1 0 0.1\n";
+
+static CSOUND *start2(const char *threads) {
+    CSOUND *csound = csoundCreate(NULL);
+
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, threads);
+    csoundCompileOrc(csound, orc);
+    csoundReadScore(csound, sco2);
+    csoundStart(csound);
+    while (csoundPerformKsmps(csound) == 0)
+      ;
+    return csound;
+}
+
+void test_ftgen_score_missing(void) {
+    CSOUND *ref = start2("-j1"), *csound = start2("-j4");
+    MYFLT  *t, *r;
+    int    i, n;
+
+    for (i = 30; i <= 32; i++)
+      CU_ASSERT_EQUAL(csoundGetTable(csound, &t, i), -1);
+    for (i = 33; i <= 34; i++) {
+      n = csoundGetTable(ref, &r, i);
+      CU_ASSERT_EQUAL(n, 4096);
+      CU_ASSERT_EQUAL(csoundGetTable(csound, &t, i), n);
+      if (n > 0 && csoundGetTable(csound, &t, i) == n)
+        CU_ASSERT_EQUAL(memcmp(t, r, sizeof(MYFLT) * (n + 1)), 0);
+    }
+    csoundDestroy(ref);
+    csoundDestroy(csound);
+}
+
+/* random tables take numbers from the seeded generator in score order */
+static const char *orc3 =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "seed 1234\n"
+    "instr 1\n"
+    "endin\n";
+
+static const char *sco3 =
+    "f 1 0 65536 21 1\n"
+    "f 2 0 65536 10 1 0.5 0.3 0.25 0.2\n"
+    "f 3 0 65536 21 6 2\n"
+    "f 4 0 65536 21 4\n"
+    "f 5 0 65536 9 1 1 0 3 0.3 0\n"
+    "f 6 0 65536 21 1 0.5\n"
+    "i 1 0 0.1\n";
+
+static CSOUND *start3(const char *threads) {
+    CSOUND *csound = csoundCreate(NULL);
+
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, threads);
+    csoundCompileOrc(csound, orc3);
+    csoundReadScore(csound, sco3);
+    csoundStart(csound);
+    while (csoundPerformKsmps(csound) == 0)
+      ;
+    return csound;
+}
+
+void test_ftgen_score_random(void) {
+    CSOUND *ref = start3("-j1"), *csound = start3("-j4");
+    MYFLT  *t, *r;
+    int    i, n;
+
+    for (i = 1; i <= 6; i++) {
+      n = csoundGetTable(ref, &r, i);
+      CU_ASSERT_EQUAL(n, 65536);
+      CU_ASSERT_EQUAL(csoundGetTable(csound, &t, i), n);
+      if (n > 0 && csoundGetTable(csound, &t, i) == n)
+        CU_ASSERT_EQUAL(memcmp(t, r, sizeof(MYFLT) * (n + 1)), 0);
+    }
+    csoundDestroy(ref);
+    csoundDestroy(csound);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("score f-statement tests", init_suite1,
+                          clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test parallel f-statements",
+                             test_ftgen_score)) ||
+        (NULL == CU_add_test(pSuite, "Test missing source tables",
+                             test_ftgen_score_missing)) ||
+        (NULL == CU_add_test(pSuite, "Test random tables",
+                             test_ftgen_score_random))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,231 @@
+/*
+ * File:   ftmipmap_test.c
+ *
+ * Tests for the band-limited copies of function tables
+ * (Engine/fgens_mipmap.c) and the oscillators reading them
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "csoundCore.h"
+#include "CUnit/Basic.h"
+
+#define LEN     4096
+#define NSMPS   4800
+
+/* a sawtooth, and one oscillator at p5 Hz, band-limited if p4 is 1 */
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "gisaw ftgen 1, 0, 4096, 7, 1, 4096, -1\n"
+    "instr 1\n"
+    "  asig oscili 0.5, p5, 1, 0, p4\n"
+    "  out asig\n"
+    "endin\n"
+    "instr 2\n"
+    "  asig poscil3 0.5, p5, 1, 0, p4\n"
+    "  out asig\n"
+    "endin\n";
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+/* magnitude of harmonic h of len points of t, over one period */
+static double harmonic(const MYFLT *t, int len, int h) {
+    double re = 0.0, im = 0.0;
+    int    i;
+
+    for (i = 0; i < len; i++) {
+      re += t[i] * cos(TWOPI * h * i / len);
+      im += t[i] * sin(TWOPI * h * i / len);
+    }
+    return 2.0 * sqrt(re * re + im * im) / len;
+}
+
+/* level k keeps harmonics up to LEN >> (k + 1) and nothing above */
+void test_ftmipmap_levels(void) {
+    CSOUND   *csound = csoundCreate(NULL);
+    MYFLT    fno = FL(1.0);
+    FUNC     *ftp;
+    FTMIPMAP *mip;
+    int      k, h;
+
+    csoundSetOption(csound, "-n");
+    csoundCompileOrc(csound, orc);
+    csoundStart(csound);
+    ftp = csound->FTnp2Find(csound, &fno);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(ftp);
+    mip = csound->FTMipMap(csound, ftp);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(mip);
+    CU_ASSERT_EQUAL(mip->nlevels, 12);
+    CU_ASSERT_PTR_EQUAL(csound->FTMipMap(csound, ftp), mip);
+    for (k = 1; k < mip->nlevels; k++) {
+      FTMIPLEVEL *l = &mip->level[k];
+      h = LEN >> (k + 1);
+      CU_ASSERT(fabs(harmonic(l->ftable, l->flen, h) -
+                     harmonic(ftp->ftable, LEN, h)) < 1e-4);
+      CU_ASSERT(harmonic(l->ftable, l->flen, h + 1) < 1e-4);
+      CU_ASSERT(harmonic(l->ftable, l->flen, 2 * h + 1) < 1e-4);
+      CU_ASSERT_EQUAL(l->ftable[-1], l->ftable[l->flen - 1]);
+      CU_ASSERT_EQUAL(l->ftable[l->flen + 2], l->ftable[2]);
+    }
+    csoundDestroy(csound);
+}
+
+/* nsmps samples of the output of score sco */
+static void render(const char *sco, MYFLT *out, int nsmps) {
+    CSOUND *csound = csoundCreate(NULL);
+    int    n = 0, ksmps;
+
+    csoundSetOption(csound, "-n");
+    csoundCompileOrc(csound, orc);
+    csoundReadScore(csound, sco);
+    csoundStart(csound);
+    ksmps = csoundGetKsmps(csound);
+    memset(out, 0, sizeof(MYFLT) * nsmps);
+    while (n + ksmps <= nsmps && csoundPerformKsmps(csound) == 0) {
+      memcpy(out + n, csoundGetSpout(csound), sizeof(MYFLT) * ksmps);
+      n += ksmps;
+    }
+    csoundDestroy(csound);
+}
+
+/* the alias of the 5th harmonic at 7 kHz (55 kHz folded) */
+static double alias(int instr, int bl) {
+    MYFLT  *out = malloc(sizeof(MYFLT) * NSMPS);
+    char   sco[64];
+    double mag;
+
+    snprintf(sco, 64, "i %d 0 1 %d 11000\n", instr, bl);
+    render(sco, out, NSMPS);
+    mag = harmonic(out, NSMPS, 700);
+    free(out);
+    return mag;
+}
+
+/* magnitude at bin of len points, as harmonic() but by Goertzel */
+static double bin_mag(const MYFLT *x, int len, int bin) {
+    double c = 2.0 * cos(TWOPI * bin / len), s0, s1 = 0.0, s2 = 0.0;
+    int    i;
+
+    for (i = 0; i < len; i++) {
+      s0 = x[i] + c * s1 - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+    return 2.0 * sqrt(fabs(s1 * s1 + s2 * s2 - c * s1 * s2)) / len;
+}
+
+void test_ftmipmap_alias(void) {
+    int    i;
+
+    for (i = 1; i <= 2; i++) {
+      double plain = alias(i, 0), bl = alias(i, 1);
+      printf("\ninstr %d: alias at 7 kHz %g, band-limited %g\n", i, plain, bl);
+      CU_ASSERT(plain > 0.02);
+      CU_ASSERT(bl < 0.01 * plain);
+    }
+}
+
+/* at increments between powers of two no harmonic of the sawtooth is
+   folded back below the Nyquist frequency: with NSMPS samples at 48 kHz
+   every frequency that is a multiple of 10 Hz falls on a bin */
+void test_ftmipmap_folded(void) {
+    static const int freq[] = { 1370, 3130, 5290, 9010 };
+    MYFLT  *out = malloc(sizeof(MYFLT) * NSMPS);
+    char   *folded = malloc(NSMPS / 2 + 1), sco[64];
+    int    i, j, h, bin;
+
+    for (i = 1; i <= 2; i++)
+      for (j = 0; j < 4; j++) {
+        double worst = 0.0;
+        memset(folded, 0, NSMPS / 2 + 1);
+        for (h = 1; h <= LEN / 2; h++) {
+          bin = (int) (((long) h * freq[j] % 48000) / 10);
+          if (bin > NSMPS / 2)
+            bin = NSMPS - bin;
+          if ((long) h * freq[j] > 24000)
+            folded[bin] = 1;
+        }
+        snprintf(sco, 64, "i %d 0 1 1 %d\n", i, freq[j]);
+        render(sco, out, NSMPS);
+        CU_ASSERT(bin_mag(out, NSMPS, freq[j] / 10) > 0.1);
+        for (bin = 1; bin <= NSMPS / 2; bin++)
+          if (folded[bin]) {
+            double mag = bin_mag(out, NSMPS, bin);
+            if (mag > worst)
+              worst = mag;
+            CU_ASSERT(mag < 1e-3);
+          }
+        printf("\ninstr %d at %d Hz: worst folded bin %g\n",
+               i, freq[j], worst);
+      }
+    free(folded);
+    free(out);
+}
+
+/* a recycled instance played without band-limiting reads the table
+   itself, not the copies of its earlier note */
+void test_ftmipmap_recycled(void) {
+    MYFLT  *seq = malloc(sizeof(MYFLT) * 2 * NSMPS);
+    MYFLT  *one = malloc(sizeof(MYFLT) * NSMPS);
+    int    i, n;
+
+    for (i = 1; i <= 2; i++) {
+      char sco[128];
+      snprintf(sco, 128, "i %d 0 0.05 1 11000\ni %d 0.1 0.05 0 11000\n",
+               i, i);
+      render(sco, seq, 2 * NSMPS);
+      snprintf(sco, 128, "i %d 0 0.05 0 11000\n", i);
+      render(sco, one, NSMPS);
+      for (n = 0; n < NSMPS; n++)
+        if (seq[NSMPS + n] != one[n])
+          break;
+      CU_ASSERT_EQUAL(n, NSMPS);
+    }
+    free(one);
+    free(seq);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("band-limited table tests", init_suite1,
+                          clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test levels", test_ftmipmap_levels)) ||
+        (NULL == CU_add_test(pSuite, "Test aliasing", test_ftmipmap_alias)) ||
+        (NULL == CU_add_test(pSuite, "Test folded bins",
+                             test_ftmipmap_folded)) ||
+        (NULL == CU_add_test(pSuite, "Test recycled instance",
+                             test_ftmipmap_recycled))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,129 @@
+/*
+ * File:   housekeep_test.c
+ *
+ * Tests for the background reclamation of idle instances and deleted
+ * tables (Engine/housekeep.c)
+ */
+
+#include <stdio.h>
+#include "csound.h"
+#include "CUnit/Basic.h"
+
+/* instr 2 starts p4 short notes of instr 1 at once */
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "  a1 oscili 0.0001, 440\n"
+    "  adel delay a1, 0.5\n"
+    "  out adel\n"
+    "endin\n"
+    "instr 2\n"
+    "  icnt = 0\n"
+    "  while icnt < p4 do\n"
+    "    event_i \"i\", 1, 0, 0.1\n"
+    "    icnt += 1\n"
+    "  od\n"
+    "endin\n";
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static CSOUND *start(const char *header, const char *score,
+                     double idle, int keep) {
+    CSOUND *csound = csoundCreate(NULL);
+    char   code[1024];
+
+    snprintf(code, sizeof(code), "%s%s", header, orc);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetHousekeeping(csound, idle, keep);
+    csoundCompileOrc(csound, code);
+    csoundReadScore(csound, score);
+    csoundStart(csound);
+    return csound;
+}
+
+/* run for secs seconds, then give the housekeeping thread some time */
+static void run(CSOUND *csound, double secs, CS_MEMORY_STATS *stats,
+                uint64_t reclaimed) {
+    int k, n = (int) (secs * 750);
+
+    for (k = 0; k < n; k++)
+      csoundPerformKsmps(csound);
+    for (k = 0; k < 200; k++) {
+      csoundGetMemoryStats(csound, stats);
+      if (stats->instances_reclaimed >= reclaimed)
+        break;
+      csoundSleep(10);
+    }
+}
+
+/* after a spike of 50 notes, all but 2 free instances are released */
+void test_trim_idle(void) {
+    CS_MEMORY_STATS stats;
+    CSOUND *csound = start("", "i 2 0 0 50\nf 1 0 1024 10 1\nf -1 0.5",
+                           0.5, 2);
+
+    csoundGetMemoryStats(csound, &stats);
+    CU_ASSERT(stats.instances_reclaimed == 0);
+    run(csound, 3.0, &stats, 48);
+    CU_ASSERT(stats.instances_peak >= 50);
+    CU_ASSERT(stats.instances_reclaimed == 48);
+    CU_ASSERT(stats.instances == stats.instances_peak - 48);
+    CU_ASSERT(stats.bytes_reclaimed >= 48 * 0.5 * 48000 * sizeof(MYFLT));
+    CU_ASSERT(stats.tables_reclaimed == 1);
+    csoundDestroy(csound);
+}
+
+/* instances are not released before they have been idle long enough,
+ * nor below the number preallocated */
+void test_keep(void) {
+    CS_MEMORY_STATS stats;
+    CSOUND *csound = start("", "i 2 0 0 50", 10.0, 1);
+
+    run(csound, 3.0, &stats, 0);
+    CU_ASSERT(stats.instances_reclaimed == 0);
+    csoundDestroy(csound);
+
+    csound = start("prealloc 1, 40\n", "i 2 0 0 50", 0.5, 1);
+    run(csound, 3.0, &stats, 10);
+    CU_ASSERT(stats.instances_reclaimed == 10);
+    csoundDestroy(csound);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("housekeeping tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test trimming idle instances",
+                             test_trim_idle)) ||
+        (NULL == CU_add_test(pSuite, "Test kept instances", test_keep))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
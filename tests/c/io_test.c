@@ -283,6 +283,72 @@ void test_midi_hostbased(void)
     csoundReset(csound);
 }
 
+static int timed_midi_sent = 0;
+
+static int timed_midi_open(CSOUND *csound, void **userData, const char *dev)
+{
+    *userData = NULL;
+    return 0;
+}
+
+static int timed_midi_close(CSOUND *csound, void *userData)
+{
+    return 0;
+}
+
+/* one note on, received 100 samples before the k-cycle that reads it */
+static int timed_midi_read(CSOUND *csound, void *userData,
+                           unsigned char *buf, int nbytes, int *age)
+{
+    if (timed_midi_sent || nbytes < 3)
+      return 0;
+    timed_midi_sent = 1;
+    buf[0] = 0x90; buf[1] = 60; buf[2] = 100;
+    age[0] = age[1] = age[2] = 100;
+    return 3;
+}
+
+void test_midi_hostbased_timed(void)
+{
+    CSOUND  *csound;
+    csound = csoundCreate(NULL);
+    const char  *instrument =
+            "ksmps = 256\n"
+            "nchnls = 1\n"
+            "0dbfs = 1\n"
+            "instr 1 \n"
+            "asig linseg 1, 1, 1\n"
+            "out asig\n"
+            "endin \n";
+    int ret, k, first = -1;
+    MYFLT *spout;
+    csoundSetOption(csound, "-odac");
+    csoundSetOption(csound, "-M0");
+    csoundSetOption(csound, "--sample-accurate");
+    csoundCompileOrc(csound, instrument);
+    csoundReadScore(csound, "f 0 1");
+    csoundSetHostImplementedAudioIO(csound, 1, 0);
+    csoundSetHostImplementedMIDIIO(csound, 1);
+    csoundSetExternalMidiInOpenCallback(csound, timed_midi_open);
+    csoundSetExternalMidiReadTimedCallback(csound, timed_midi_read);
+    csoundSetExternalMidiInCloseCallback(csound, timed_midi_close);
+    timed_midi_sent = 0;
+    ret = csoundStart(csound);
+    CU_ASSERT(ret == 0);
+    spout = csoundGetSpout(csound);
+    for (k = 0; k < 4 && first < 0; k++) {
+      int n;
+      csoundPerformKsmps(csound);
+      for (n = 0; n < 256; n++)
+        if (spout[n] != 0.0) {
+          first = n;
+          break;
+        }
+    }
+    /* the note starts at ksmps - 1 - age */
+    CU_ASSERT_EQUAL(first, 155);
+    csoundReset(csound);
+}
 
 int main()
 {
@@ -306,6 +372,7 @@ int main()
             || (NULL == CU_add_test(pSuite, "Audio Hostbased\n", test_audio_hostbased))
             || (NULL == CU_add_test(pSuite, "MIDI Modules\n", test_midi_modules))
             || (NULL == CU_add_test(pSuite, "MIDI Hostbased\n", test_midi_hostbased))
+            || (NULL == CU_add_test(pSuite, "MIDI Hostbased timed\n", test_midi_hostbased_timed))
             || (NULL == CU_add_test(pSuite, "Audio realtime mode\n", test_audio_realtime_mode))
         )
     {
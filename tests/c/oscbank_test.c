@@ -0,0 +1,258 @@
+/*
+ * File:   oscbank_test.c
+ *
+ * Tests and benchmark for the sinusoidal oscillator bank
+ * (OOps/oscbank.c)
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "csoundCore.h"
+#include "CUnit/Basic.h"
+
+#ifdef USE_DOUBLE
+#define OB_TOL 1e-6
+#else
+#define OB_TOL 1e-4
+#endif
+
+#define BLK     64
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+/* the bank lives in an AUXCH, which needs an instance */
+static INSDS ins;
+
+static CSOUND *start(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    memset(&ins, 0, sizeof(INSDS));
+    csound->curip = &ins;
+    return csound;
+}
+
+static void stop(CSOUND *csound, AUXCH *aux) {
+    csound->Free(csound, aux->auxp);
+    csoundDestroy(csound);
+}
+
+/* 64 steady sinusoids against sin() */
+void test_oscbank_steady(void) {
+    CSOUND *csound = start();
+    AUXCH  aux = { NULL, 0, NULL, NULL };
+    double tpidsr = TWOPI / csound->GetSr(csound), err = 0.0;
+    MYFLT  f[64], ph[64];
+    MYFLT  out[BLK];
+    int    n = 64, i, k, m;
+    void   *bank = csound->OscBankCreate(csound, &aux, n, BLK, NULL);
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(bank);
+    for (i = 0; i < n; i++) {
+      f[i] = 100.0 + 137.3 * i;
+      ph[i] = 0.1 * i;
+      csound->OscBankSet(csound, bank, i, FL(0.0), f[i], ph[i],
+                         CS_OSCBANK_START);
+    }
+    for (k = 0; k < 2000; k++) {
+      for (i = 0; i < n; i++)
+        csound->OscBankSet(csound, bank, i, FL(1.0) / n, f[i], FL(0.0),
+                           CS_OSCBANK_GLIDE);
+      csound->OscBankRun(csound, bank, out, BLK, n);
+      /* the first block fades in */
+      for (m = 0; k > 0 && m < BLK; m++) {
+        double ref = 0.0, t = (double) (k * BLK + m);
+        for (i = 0; i < n; i++)
+          ref += sin(ph[i] + f[i] * tpidsr * t) / n;
+        if (fabs(out[m] - ref) > err)
+          err = fabs(out[m] - ref);
+      }
+    }
+    CU_ASSERT(err < OB_TOL);
+    stop(csound, &aux);
+}
+
+/* a glide from 200 to 2000 Hz over one block, then held */
+void test_oscbank_glide(void) {
+    CSOUND *csound = start();
+    AUXCH  aux = { NULL, 0, NULL, NULL };
+    double tpidsr = TWOPI / csound->GetSr(csound), err = 0.0;
+    double w0 = 200.0 * tpidsr, w1 = 2000.0 * tpidsr, phs = 0.0, w;
+    MYFLT  out[256];
+    int    k, m;
+    void   *bank = csound->OscBankCreate(csound, &aux, 1, 256, NULL);
+
+    csound->OscBankSet(csound, bank, 0, FL(1.0), FL(200.0), FL(0.0),
+                       CS_OSCBANK_START);
+    csound->OscBankSet(csound, bank, 0, FL(1.0), FL(200.0), FL(0.0),
+                       CS_OSCBANK_GLIDE);
+    csound->OscBankRun(csound, bank, out, 256, 1);
+    phs = w0 * 256;
+    for (k = 0; k < 4; k++) {
+      csound->OscBankSet(csound, bank, 0, FL(1.0), FL(2000.0), FL(0.0),
+                         CS_OSCBANK_GLIDE);
+      csound->OscBankRun(csound, bank, out, 256, 1);
+      for (m = 0; m < 256; m++) {
+        w = (k == 0 ? w0 + (w1 - w0) * m / 256.0 : w1);
+        if (fabs(out[m] - sin(phs)) > err)
+          err = fabs(out[m] - sin(phs));
+        phs += w;
+      }
+    }
+    CU_ASSERT(err < OB_TOL);
+    stop(csound, &aux);
+}
+
+/* cubic phase interpolation reaches the target phase and frequency */
+void test_oscbank_phase(void) {
+    CSOUND *csound = start();
+    AUXCH  aux = { NULL, 0, NULL, NULL };
+    double tpidsr = TWOPI / csound->GetSr(csound), err = 0.0, jump = 0.0;
+    MYFLT  out[BLK], last;
+    int    k, m;
+    void   *bank = csound->OscBankCreate(csound, &aux, 1, BLK, NULL);
+
+    csound->OscBankSet(csound, bank, 0, FL(1.0), FL(440.0), FL(0.0),
+                       CS_OSCBANK_START);
+    csound->OscBankRun(csound, bank, out, BLK, 1);
+    last = out[BLK - 1];
+    for (k = 0; k < 100; k++) {
+      double tph = 0.37 * k, f = 440.0 + 3.0 * k;
+      csound->OscBankSet(csound, bank, 0, FL(1.0), f, tph,
+                         CS_OSCBANK_PHASE);
+      csound->OscBankRun(csound, bank, out, BLK, 1);
+      for (m = 0; m < BLK; m++) {
+        if (fabs(out[m] - last) > jump)
+          jump = fabs(out[m] - last);
+        last = out[m];
+      }
+      /* held for a block from the target */
+      csound->OscBankRun(csound, bank, out, BLK, 1);
+      for (m = 0; m < BLK; m++) {
+        double ref = sin(tph + f * tpidsr * m);
+        if (fabs(out[m] - ref) > err)
+          err = fabs(out[m] - ref);
+      }
+      last = out[BLK - 1];
+    }
+    CU_ASSERT(err < OB_TOL);
+    /* no discontinuity: at most a little more than the steepest step */
+    CU_ASSERT(jump < 2.0 * 800.0 * tpidsr);
+    stop(csound, &aux);
+}
+
+/* sinusoidal tables are recognised, others read with interpolation */
+void test_oscbank_table(void) {
+    CSOUND *csound = start();
+    AUXCH  aux = { NULL, 0, NULL, NULL };
+    double tpidsr = TWOPI / csound->GetSr(csound), err, x;
+    FUNC   ftp;
+    MYFLT  tab[4097], out[BLK];
+    int    i, k, m;
+    void   *bank;
+
+    memset(&ftp, 0, sizeof(FUNC));
+    ftp.flen = 4096;
+    ftp.ftable = tab;
+    for (k = 0; k < 2; k++) {
+      for (i = 0; i <= 4096; i++) {
+        x = TWOPI * i / 4096.0;
+        tab[i] = (k == 0 ? 0.5 * cos(x) : 0.5 * sin(x) + 0.25 * sin(3 * x));
+      }
+      bank = csound->OscBankCreate(csound, &aux, 1, BLK, &ftp);
+      csound->OscBankSet(csound, bank, 0, FL(0.0), FL(441.0), FL(1.0),
+                         CS_OSCBANK_START);
+      err = 0.0;
+      for (i = 0; i < 100; i++) {
+        csound->OscBankSet(csound, bank, 0, FL(1.0), FL(441.0), FL(0.0),
+                           CS_OSCBANK_GLIDE);
+        csound->OscBankRun(csound, bank, out, BLK, 1);
+        if (i == 0)
+          continue;
+        for (m = 0; m < BLK; m++) {
+          double t = 1.0 + 441.0 * tpidsr * (i * BLK + m), ref;
+          ref = (k == 0 ? 0.5 * cos(t) : 0.5 * sin(t) + 0.25 * sin(3 * t));
+          if (fabs(out[m] - ref) > err)
+            err = fabs(out[m] - ref);
+        }
+      }
+      /* exact for the cosine, interpolation error otherwise */
+      CU_ASSERT(err < (k == 0 ? OB_TOL : 1e-5));
+    }
+    stop(csound, &aux);
+}
+
+/* partials rendered in real time on one core, gliding every block */
+void test_oscbank_benchmark(void) {
+    CSOUND  *csound = start();
+    AUXCH   aux = { NULL, 0, NULL, NULL };
+    int     n = 1024, i, k, nk = 750;
+    MYFLT   out[BLK];
+    clock_t t0;
+    double  secs, rate;
+    void    *bank = csound->OscBankCreate(csound, &aux, n, BLK, NULL);
+
+    for (i = 0; i < n; i++)
+      csound->OscBankSet(csound, bank, i, FL(0.0), 50.0 + 10.0 * i, FL(0.0),
+                         CS_OSCBANK_START);
+    t0 = clock();
+    for (k = 0; k < nk; k++) {
+      for (i = 0; i < n; i++)
+        csound->OscBankSet(csound, bank, i, FL(0.001),
+                           (50.0 + 10.0 * i) * (1.0 + 0.01 * (k & 1)),
+                           FL(0.0), CS_OSCBANK_GLIDE);
+      csound->OscBankRun(csound, bank, out, BLK, n);
+    }
+    secs = (double) (clock() - t0) / CLOCKS_PER_SEC;
+    rate = n * nk * BLK / csound->GetSr(csound) / (secs > 0.0 ? secs : 1e-9);
+    printf("\n%d partials for %.2f s at %.0f Hz in %.3f s: %.0f partials, "
+           "or %.0f voices of 64 partials per core\n", n,
+           nk * BLK / csound->GetSr(csound), csound->GetSr(csound), secs,
+           rate, rate / 64.0);
+    CU_PASS("benchmark");
+    stop(csound, &aux);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("oscillator bank tests", init_suite1,
+                          clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test steady sinusoids",
+                             test_oscbank_steady)) ||
+        (NULL == CU_add_test(pSuite, "Test frequency glide",
+                             test_oscbank_glide)) ||
+        (NULL == CU_add_test(pSuite, "Test cubic phase",
+                             test_oscbank_phase)) ||
+        (NULL == CU_add_test(pSuite, "Test tables", test_oscbank_table)) ||
+        (NULL == CU_add_test(pSuite, "Benchmark",
+                             test_oscbank_benchmark))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,148 @@
+/*
+ * File:   partikkel_test.c
+ *
+ * Tests and grains-per-second benchmark for the partikkel grain renderer
+ * (Opcodes/partikkel.c)
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "csound.h"
+#include "CUnit/Basic.h"
+
+/* a dense cloud: 2000 grains/s of 1 s each, so about 2000 overlapping
+ * grains, using all four waveforms, trainlets, fm and stereo panning.
+ * p4 is the number of rendering threads, p5 the grain rate */
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 2\n"
+    "0dbfs = 1\n"
+    "giSine  ftgen 0, 0, 8192, 10, 1\n"
+    "giSaw   ftgen 0, 0, 8192, 10, 1, 0.5, 0.33, 0.25\n"
+    "giCos   ftgen 0, 0, 8193, 9, 1, 1, 90\n"
+    "giWin   ftgen 0, 0, 4096, 20, 2, 1\n"
+    "giMask  ftgen 0, 0, 8, -2, 0, 3, 0.1, 0.4, 0.6, 0.9\n"
+    "giGains ftgen 0, 0, 8, -2, 0, 0, 0.3, 0.2, 0.2, 0.1, 0.2\n"
+    "instr 1\n"
+    "  ithreads = p4\n"
+    "  agrainfreq = p5\n"
+    "  async = 0\n"
+    "  afm oscili 0.1, 3\n"
+    "  apos phasor 0.5\n"
+    "  aL, aR partikkel agrainfreq, 0, -1, async, 1, giWin, -1, -1, \\\n"
+    "      0.5, 0.5, 1000, 0.0005, -1, 220, 0.5, -1, -1, afm, -1, -1, \\\n"
+    "      giCos, 110, 8, 0.7, giMask, 0, giSine, giSaw, giSine, giSaw, giGains, \\\n"
+    "      apos, apos, apos, apos, 1, 1.5, 2, 3, 4000, 0, -1, ithreads\n"
+    "  outs aL, aR\n"
+    "endin\n";
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static CSOUND *start_partikkel(int threads, int grainrate) {
+    CSOUND *csound = csoundCreate(NULL);
+    char   score[64];
+
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, orc);
+    snprintf(score, sizeof(score), "i 1 0 60 %d %d", threads, grainrate);
+    csoundReadScore(csound, score);
+    csoundStart(csound);
+    return csound;
+}
+
+/* rendering on worker threads only changes the order of summation */
+void test_partikkel_threads(void) {
+    CSOUND *serial = start_partikkel(1, 2000);
+    CSOUND *threaded = start_partikkel(4, 2000);
+    MYFLT  *out1 = csoundGetSpout(serial), *out2 = csoundGetSpout(threaded);
+    double err = 0.0, peak = 0.0;
+    int    k, n;
+
+    for (k = 0; k < 1500; k++) {
+      csoundPerformKsmps(serial);
+      csoundPerformKsmps(threaded);
+      for (n = 0; n < 2 * 64; n++) {
+        err = fmax(err, fabs(out1[n] - out2[n]));
+        peak = fmax(peak, fabs(out1[n]));
+      }
+    }
+    CU_ASSERT(peak > 0.0);
+    CU_ASSERT(err <= 1e-4 * peak);
+    csoundDestroy(serial);
+    csoundDestroy(threaded);
+}
+
+/* grains scheduled per second of processing time */
+static double time_partikkel(int threads, int grainrate, int kcycles) {
+    CSOUND *csound = start_partikkel(threads, grainrate);
+    double secs, wall;
+    int    k;
+    struct timespec ts0, ts1;
+
+    /* wall clock time, the worker threads would add to clock() */
+    clock_gettime(CLOCK_MONOTONIC, &ts0);
+    for (k = 0; k < kcycles; k++)
+      csoundPerformKsmps(csound);
+    clock_gettime(CLOCK_MONOTONIC, &ts1);
+    wall = (ts1.tv_sec - ts0.tv_sec) + 1e-9 * (ts1.tv_nsec - ts0.tv_nsec);
+    secs = kcycles * 64 / 48000.0;
+    csoundDestroy(csound);
+    return grainrate * secs / wall;
+}
+
+void test_partikkel_benchmark(void) {
+    static const int rates[] = { 500, 2000, 8000, 0 };
+    static const int threads[] = { 1, 2, 4, 0 };
+    int r, t;
+
+    printf("\n%10s", "grains/s");
+    for (t = 0; threads[t]; t++)
+      printf(" %10d thr", threads[t]);
+    printf("\n");
+    for (r = 0; rates[r]; r++) {
+      printf("%10d", rates[r]);
+      for (t = 0; threads[t]; t++)
+        printf(" %14.0f", time_partikkel(threads[t], rates[r], 2250));
+      printf("\n");
+    }
+    CU_PASS("benchmark");
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("partikkel tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test threaded rendering",
+                             test_partikkel_threads)) ||
+        (NULL == CU_add_test(pSuite, "Benchmark partikkel",
+                             test_partikkel_benchmark))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,290 @@
+/*
+ * File:   resample_test.c
+ *
+ * Tests and benchmark for the polyphase sample rate converter
+ * (OOps/resample.c)
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "csoundCore.h"
+#include "resample.h"
+#include "CUnit/Basic.h"
+
+#ifdef USE_DOUBLE
+#define RS_TOL 1e-4
+#else
+#define RS_TOL 1e-3
+#endif
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static void sine(MYFLT *buf, int N, int nchnls, double f, double sr) {
+    int i, c;
+    for (i = 0; i < N; i++)
+      for (c = 0; c < nchnls; c++)
+        buf[i * nchnls + c] = 0.5 * sin(2.0 * PI * f * (c + 1) * i / sr);
+}
+
+/* convert all of in in blocks of blk frames, returns the output length */
+static int convert(CSOUND *csound, void *rs, int chn, const MYFLT *in,
+                   int N, int nchnls, int blk, MYFLT *out) {
+    int i, nout = 0;
+    for (i = 0; i < N; i += blk) {
+      int n = (N - i < blk ? N - i : blk);
+      nout += csound->Resample(csound, rs, chn, in + i * nchnls, n,
+                               out + nout * nchnls);
+    }
+    return nout + csound->Resample(csound, rs, chn, NULL, 0,
+                                   out + nout * nchnls);
+}
+
+/* a sine converted from 44100 to 48000 Hz, in the middle of the output */
+void test_resample_sine(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    int    N = 44100, q, i, c;
+    MYFLT  *in = csound->Malloc(csound, 2 * N * sizeof(MYFLT));
+
+    sine(in, N, 2, 1000.0, 44100.0);
+    for (q = 1; q <= 4; q++) {
+      void  *rs = csound->ResamplerCreate(csound, FL(44100.0), FL(48000.0),
+                                          2, q);
+      MYFLT *out = csound->Malloc(csound,
+                                  2 * csound->ResamplerFrames(csound, rs, N)
+                                  * sizeof(MYFLT));
+      double err = 0.0;
+      int    nout = convert(csound, rs, -1, in, N, 2, N, out);
+      CU_ASSERT_EQUAL(nout, 48000);
+      for (i = 1000; i < nout - 1000; i++)
+        for (c = 0; c < 2; c++)
+          err = fmax(err, fabs(out[2 * i + c]
+                               - 0.5 * sin(2.0 * PI * 1000.0 * (c + 1)
+                                           * i / 48000.0)));
+      CU_ASSERT(err < (q == 1 ? 1e-2 : RS_TOL));
+      csound->ResamplerDestroy(csound, rs);
+      csound->Free(csound, out);
+    }
+    csound->Free(csound, in);
+    csoundDestroy(csound);
+}
+
+/* streaming in blocks, one channel at a time, matches a single call */
+void test_resample_blocks(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    static const double rates[][2] = { { 44100, 48000 }, { 48000, 44100 },
+                                       { 96000, 48000 }, { 22050, 96000 },
+                                       { 44100, 44100.5 }, { 0, 0 } };
+    int    N = 10000, r, i;
+    MYFLT  *in = csound->Malloc(csound, 2 * N * sizeof(MYFLT));
+
+    sine(in, N, 2, 440.0, 44100.0);
+    for (r = 0; rates[r][0] > 0.0; r++) {
+      void  *rs1 = csound->ResamplerCreate(csound, rates[r][0], rates[r][1],
+                                           2, 2);
+      void  *rs2 = csound->ResamplerCreate(csound, rates[r][0], rates[r][1],
+                                           2, 2);
+      int   size = 2 * csound->ResamplerFrames(csound, rs1, N);
+      MYFLT *out1 = csound->Calloc(csound, size * sizeof(MYFLT));
+      MYFLT *out2 = csound->Calloc(csound, size * sizeof(MYFLT));
+      int   n1 = convert(csound, rs1, -1, in, N, 2, N, out1);
+      int   n2 = convert(csound, rs2, 0, in, N, 2, 37, out2);
+      double err = 0.0;
+      CU_ASSERT_EQUAL(convert(csound, rs2, 1, in, N, 2, 1000, out2), n2);
+      CU_ASSERT_EQUAL(n1, n2);
+      CU_ASSERT_EQUAL(n1, (int) ceil(N * rates[r][1] / rates[r][0]));
+      for (i = 0; i < 2 * n1; i++)
+        err = fmax(err, fabs(out1[i] - out2[i]));
+      CU_ASSERT(err == 0.0);
+      csound->ResamplerDestroy(csound, rs1);
+      csound->ResamplerDestroy(csound, rs2);
+      csound->Free(csound, out1);
+      csound->Free(csound, out2);
+    }
+    csound->Free(csound, in);
+    csoundDestroy(csound);
+}
+
+/* peak level of a 27 kHz sine, above the Nyquist frequency of the output,
+   converted from 96 to 48 kHz */
+void test_resample_alias(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    int    N = 96000, q, i;
+    MYFLT  *in = csound->Malloc(csound, N * sizeof(MYFLT));
+
+    sine(in, N, 1, 27000.0, 96000.0);
+    for (q = 2; q <= 3; q++) {
+      void   *rs = csound->ResamplerCreate(csound, FL(96000.0), FL(48000.0),
+                                           1, q);
+      MYFLT  *out = csound->Malloc(csound,
+                                   csound->ResamplerFrames(csound, rs, N)
+                                   * sizeof(MYFLT));
+      double peak = 0.0;
+      int    nout = convert(csound, rs, -1, in, N, 1, 4096, out);
+      for (i = 1000; i < nout - 1000; i++)
+        peak = fmax(peak, fabs(out[i]));
+      CU_ASSERT(20.0 * log10(peak / 0.5) < (q == 2 ? -40.0 : -90.0));
+      csound->ResamplerDestroy(csound, rs);
+      csound->Free(csound, out);
+    }
+    csound->Free(csound, in);
+    csoundDestroy(csound);
+}
+
+/* the coefficients are those of the streaming filter */
+void test_resample_coefs(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    void   *rs = csound->ResamplerCreate(csound, FL(44100.0), FL(48000.0),
+                                         0, 2);
+    int    ntaps = csound->ResamplerCoefs(csound, rs, 0.0, NULL), i;
+    MYFLT  *coefs = csound->Malloc(csound, ntaps * sizeof(MYFLT));
+    double sum = 0.0;
+
+    CU_ASSERT(ntaps > 0 && !(ntaps & 1));
+    CU_ASSERT_PTR_EQUAL(rs, csound->ResamplerCreate(csound, FL(44100.0),
+                                                    FL(48000.0), 0, 2));
+    csound->ResamplerCoefs(csound, rs, 0.3, coefs);
+    for (i = 0; i < ntaps; i++)
+      sum += coefs[i];
+    CU_ASSERT(fabs(sum - 1.0) < 1e-3);
+    csound->Free(csound, coefs);
+    csoundDestroy(csound);
+}
+
+/* at 2:1 the conversion needs one phase only, each output being the
+   phase 0 filter over the input around an even frame; the shared bank
+   still gives accurate coefficients between input frames */
+void test_resample_half(void) {
+    CSOUND *csound = csoundCreate(NULL);
+    int    N = 9600, nout = 0, ntaps, i, k;
+    void   *rs = csound->ResamplerCreate(csound, FL(96000.0), FL(48000.0),
+                                         1, 2);
+    void   *sh = csound->ResamplerCreate(csound, FL(96000.0), FL(48000.0),
+                                         0, 2);
+    MYFLT  *in = csound->Malloc(csound, N * sizeof(MYFLT));
+    MYFLT  *out = csound->Malloc(csound, csound->ResamplerFrames(csound, rs, N)
+                                 * sizeof(MYFLT));
+    MYFLT  *h;
+    double err = 0.0, err2 = 0.0;
+
+    sine(in, N, 1, 5000.0, 96000.0);
+    nout = convert(csound, rs, -1, in, N, 1, 1000, out);
+    CU_ASSERT_EQUAL(nout, N / 2);
+    ntaps = csound->ResamplerCoefs(csound, sh, 0.0, NULL);
+    h = csound->Malloc(csound, ntaps * sizeof(MYFLT));
+    csound->ResamplerCoefs(csound, sh, 0.0, h);
+    for (i = ntaps; i < nout - ntaps; i++) {
+      double s = 0.0;
+      for (k = 0; k < ntaps; k++)
+        s += h[k] * in[2 * i + k - (ntaps / 2 - 1)];
+      err = fmax(err, fabs(out[i] - s));
+    }
+    CU_ASSERT(err < (sizeof(MYFLT) == 8 ? 1e-12 : 1e-6));
+    /* half way between two input frames */
+    csound->ResamplerCoefs(csound, sh, 0.5, h);
+    for (i = ntaps; i < N - ntaps; i++) {
+      double s = 0.0;
+      for (k = 0; k < ntaps; k++)
+        s += h[k] * in[i + k - (ntaps / 2 - 1)];
+      err2 = fmax(err2, fabs(s - 0.5 * sin(2.0 * PI * 5000.0 * (i + 0.5)
+                                           / 96000.0)));
+    }
+    CU_ASSERT(err2 < RS_TOL);
+    csound->ResamplerDestroy(csound, rs);
+    csound->Free(csound, in);
+    csound->Free(csound, out);
+    csound->Free(csound, h);
+    csoundDestroy(csound);
+}
+
+/* million output frames per second */
+static double time_resample(CSOUND *csound, double insr, double outsr,
+                            int q, int nchnls) {
+    int     N = 1 << 16, reps = 16, k;
+    void    *rs = csound->ResamplerCreate(csound, insr, outsr, nchnls, q);
+    MYFLT   *in = csound->Malloc(csound, N * nchnls * sizeof(MYFLT));
+    MYFLT   *out = csound->Malloc(csound,
+                                  csound->ResamplerFrames(csound, rs, N)
+                                  * nchnls * sizeof(MYFLT));
+    double  frames = 0.0;
+    clock_t t0;
+
+    sine(in, N, nchnls, 440.0, insr);
+    t0 = clock();
+    for (k = 0; k < reps; k++)
+      frames += csound->Resample(csound, rs, -1, in, N, out);
+    frames /= (double) (clock() - t0) / CLOCKS_PER_SEC;
+    csound->ResamplerDestroy(csound, rs);
+    csound->Free(csound, in);
+    csound->Free(csound, out);
+    return 1e-6 * frames;
+}
+
+void test_resample_benchmark(void) {
+    static const double rates[][2] = { { 44100, 48000 }, { 48000, 44100 },
+                                       { 96000, 48000 }, { 44100, 44101 },
+                                       { 0, 0 } };
+    CSOUND *csound = csoundCreate(NULL);
+    int    r, q;
+
+    printf("\n%16s", "Mframes/s");
+    for (q = 1; q <= 4; q++)
+      printf("      Q=%d", q);
+    printf("\n");
+    for (r = 0; rates[r][0] > 0.0; r++) {
+      printf("%7.0f->%7.0f", rates[r][0], rates[r][1]);
+      for (q = 1; q <= 4; q++)
+        printf(" %9.2f", time_resample(csound, rates[r][0], rates[r][1],
+                                       q, 2));
+      printf("\n");
+    }
+    csoundDestroy(csound);
+    CU_PASS("benchmark");
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Resampler tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test sine conversion",
+                             test_resample_sine)) ||
+        (NULL == CU_add_test(pSuite, "Test streaming in blocks",
+                             test_resample_blocks)) ||
+        (NULL == CU_add_test(pSuite, "Test alias rejection",
+                             test_resample_alias)) ||
+        (NULL == CU_add_test(pSuite, "Test 2:1 conversion",
+                             test_resample_half)) ||
+        (NULL == CU_add_test(pSuite, "Test shared coefficients",
+                             test_resample_coefs)) ||
+        (NULL == CU_add_test(pSuite, "Benchmark resampler",
+                             test_resample_benchmark))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
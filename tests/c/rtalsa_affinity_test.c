@@ -0,0 +1,127 @@
+/*
+ * File:   rtalsa_affinity_test.c
+ *
+ * Tests that -+alsa_cpu pins only the thread doing the ALSA I/O
+ * (InOut/rtalsa.c), using the ALSA null device
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "csound.h"
+#include "CUnit/Basic.h"
+
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 2\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "  a1 oscili 0.1, 440\n"
+    "  outs a1, a1\n"
+    "endin\n";
+
+typedef struct {
+    CSOUND    *csound;
+    cpu_set_t cpus;             /* affinity of the performing thread */
+} PERF;
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static void *perform(void *p) {
+    PERF *perf = (PERF*) p;
+    int  k;
+
+    for (k = 0; k < 100; k++)
+      csoundPerformKsmps(perf->csound);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &perf->cpus);
+    return NULL;
+}
+
+/* the thread that starts Csound keeps its affinity, the one performing
+ * (and so writing to the device) is pinned to the requested CPU */
+void test_pin_io_thread(void) {
+    cpu_set_t before, after;
+    pthread_t thread;
+    PERF      perf;
+    int       cpu;
+
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &before);
+    for (cpu = 0; cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &before); cpu++)
+      ;
+    CU_ASSERT_FATAL(cpu < CPU_SETSIZE);
+
+    perf.csound = csoundCreate(NULL);
+    {
+      char opt[32];
+      snprintf(opt, sizeof(opt), "-+alsa_cpu=%d", cpu);
+      csoundSetOption(perf.csound, opt);
+    }
+    csoundSetOption(perf.csound, "-+rtaudio=alsa");
+    csoundSetOption(perf.csound, "-odac:null");
+    csoundSetOption(perf.csound, "-b256");
+    csoundSetOption(perf.csound, "-B1024");
+    csoundSetOption(perf.csound, "-m0");
+    csoundCompileOrc(perf.csound, orc);
+    csoundReadScore(perf.csound, "i 1 0 10");
+    if (csoundStart(perf.csound) != CSOUND_SUCCESS) {
+      /* no ALSA (or no rtalsa module) on this machine */
+      printf("ALSA null device not available, skipped\n");
+      csoundDestroy(perf.csound);
+      return;
+    }
+    pthread_create(&thread, NULL, perform, &perf);
+    pthread_join(thread, NULL);
+
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &after);
+    CU_ASSERT(CPU_EQUAL(&before, &after));
+    CU_ASSERT(CPU_COUNT(&perf.cpus) == 1);
+    CU_ASSERT(CPU_ISSET(cpu, &perf.cpus));
+    csoundDestroy(perf.csound);
+}
+
+int main(int argc, char **argv) {
+    CU_pSuite pSuite = NULL;
+    int       i;
+
+    /* the plugin directory is passed as -+env:OPCODE6DIR64=...; modules
+     * are loaded by csoundCreate(), so it must be in the environment */
+    for (i = 1; i < argc; i++)
+      if (strncmp(argv[i], "-+env:", 6) == 0)
+        putenv(argv[i] + 6);
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("ALSA affinity tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if (NULL == CU_add_test(pSuite, "Test pinning the I/O thread",
+                            test_pin_io_thread)) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,158 @@
+/*
+ * File:   rtalsa_mmap_test.c
+ *
+ * Tests that -+alsa_mmap transfers write the same samples as read/write
+ * transfers (InOut/rtalsa.c), using the ALSA file plugin, which records
+ * what is played to the null device into a file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "csound.h"
+#include "CUnit/Basic.h"
+
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 2\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "  a1 oscili 0.5, 440\n"
+    "  a2 oscili 0.25, 1000\n"
+    "  outs a1, a2\n"
+    "endin\n";
+
+#define FRAMES  (48000 / 2)     /* the score plays half a second */
+#define BYTES   (FRAMES * 2 * 2)
+
+static char rwname[] = "/tmp/csalsarwXXXXXX";
+static char mmname[] = "/tmp/csalsammXXXXXX";
+
+int init_suite1(void) {
+    int fd1 = mkstemp(rwname), fd2 = mkstemp(mmname);
+
+    if (fd1 >= 0) close(fd1);
+    if (fd2 >= 0) close(fd2);
+    return (fd1 < 0 || fd2 < 0);
+}
+
+int clean_suite1(void) {
+    remove(rwname);
+    remove(mmname);
+    return 0;
+}
+
+/* play the score to the file plugin, writing 16 bit samples to name;
+ * returns -1 if ALSA is not available, 1 if mmap access was refused */
+static int play(const char *name, int mmap) {
+    CSOUND     *csound = csoundCreate(NULL);
+    char       opt[256];
+    const char *msg;
+    int        ret = 0;
+
+    csoundCreateMessageBuffer(csound, 0);
+    snprintf(opt, sizeof(opt), "-odac:file:FILE=%s", name);
+    csoundSetOption(csound, opt);
+    csoundSetOption(csound, "-+rtaudio=alsa");
+    csoundSetOption(csound, mmap ? "-+alsa_mmap=1" : "-+alsa_mmap=0");
+    csoundSetOption(csound, "-s");
+    csoundSetOption(csound, "-b256");
+    csoundSetOption(csound, "-B1024");
+    csoundCompileOrc(csound, orc);
+    csoundReadScore(csound, "i 1 0 0.5");
+    if (csoundStart(csound) != CSOUND_SUCCESS)
+      ret = -1;
+    else {
+      while (csoundPerformKsmps(csound) == 0)
+        ;
+      csoundCleanup(csound);
+    }
+    while (csoundGetMessageCnt(csound) > 0) {
+      msg = csoundGetFirstMessage(csound);
+      if (strstr(msg, "mmap access not supported") != NULL)
+        ret = 1;
+      csoundPopFirstMessage(csound);
+    }
+    csoundDestroyMessageBuffer(csound);
+    csoundDestroy(csound);
+    return ret;
+}
+
+static long read_file(const char *name, char *buf, long size) {
+    FILE *f = fopen(name, "rb");
+    long n;
+
+    if (f == NULL)
+      return -1;
+    n = (long) fread(buf, 1, size, f);
+    fclose(f);
+    return n;
+}
+
+/* mmap transfers give the samples of read/write transfers; the devices
+ * may have played different amounts of silence when they are closed,
+ * so only the score is compared */
+void test_mmap_transfer(void) {
+    char *rw = calloc(2, BYTES), *mm = calloc(2, BYTES);
+    long nrw, nmm, i;
+
+    if (play(rwname, 0) < 0) {
+      /* no ALSA (or no rtalsa module) on this machine */
+      printf("ALSA file plugin not available, skipped\n");
+      free(rw); free(mm);
+      return;
+    }
+    if (play(mmname, 1) != 0) {
+      printf("mmap access refused by the ALSA file plugin, skipped\n");
+      free(rw); free(mm);
+      return;
+    }
+    nrw = read_file(rwname, rw, 2 * BYTES);
+    nmm = read_file(mmname, mm, 2 * BYTES);
+    CU_ASSERT(nrw >= BYTES);
+    CU_ASSERT(nmm >= BYTES);
+    CU_ASSERT_EQUAL(memcmp(rw, mm, BYTES), 0);
+    /* not silence */
+    for (i = 0; i < BYTES && rw[i] == 0; i++)
+      ;
+    CU_ASSERT(i < BYTES);
+    free(rw);
+    free(mm);
+}
+
+int main(int argc, char **argv) {
+    CU_pSuite pSuite = NULL;
+    int       i;
+
+    /* the plugin directory is passed as -+env:OPCODE6DIR64=...; modules
+     * are loaded by csoundCreate(), so it must be in the environment */
+    for (i = 1; i < argc; i++)
+      if (strncmp(argv[i], "-+env:", 6) == 0)
+        putenv(argv[i] + 6);
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("ALSA mmap tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if (NULL == CU_add_test(pSuite, "Test mmap transfers",
+                            test_mmap_transfer)) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
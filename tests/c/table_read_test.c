@@ -0,0 +1,218 @@
+/*
+ * File:   table_read_test.c
+ *
+ * Tests and benchmark for the audio rate table readers
+ * (OOps/ugtabs.c)
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "csoundCore.h"
+#include "entry1.h"
+#include "CUnit/Basic.h"
+
+#ifdef USE_DOUBLE
+#define TR_TOL 1e-9
+#else
+#define TR_TOL 1e-4
+#endif
+
+#define BLK     64
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static INSDS insds;
+static FUNC  ftab;
+static MYFLT ndx[BLK], out[BLK], ref[BLK];
+static MYFLT offs, fmode, fwrap;
+
+/* the readers as they were, one sample at a time */
+static void ref_read(TABL *p, int order, MYFLT *sig) {
+    int32_t ndx, len = p->len, n, nsmps = BLK;
+    int32_t mask = p->ftp->lenmask;
+    MYFLT   *ndx_f = p->ndx, *func = p->ftp->ftable;
+    MYFLT   offset = *p->offset, mul = p->mul, tmp, frac;
+
+    for (n = 0; n < nsmps; n++) {
+      MYFLT x0, x1, x2, x3, temp1, fracub, fracsq;
+      tmp = (ndx_f[n] + offset)*mul;
+      ndx = FLOOR(tmp);
+      frac = tmp - ndx;
+      if (p->iwrap) {
+        if (p->np2) {
+          while (ndx >= len) ndx -= len;
+          while (ndx < 0)  ndx += len;
+        }
+        else ndx &= mask;
+      } else {
+        if (ndx >= len) ndx = len - 1;
+        else if (ndx < 0) ndx = 0;
+      }
+      if (order == 0)
+        sig[n] = func[ndx];
+      else if (order == 1 || ndx < 1 || ndx == len-1 || len < 4) {
+        x1 = func[ndx];
+        x2 = func[ndx+1];
+        sig[n] = x1 + (x2 - x1)*frac;
+      } else {
+        x0 = func[ndx-1];
+        x1 = func[ndx];
+        x2 = func[ndx+1];
+        x3 = func[ndx+2];
+        fracsq = frac*frac;
+        fracub = fracsq*x0;
+        temp1 = x3+x1+x1+x1;
+        sig[n] =  x1 + FL(0.5)*fracub +
+          frac*(x2 - fracub/FL(6.0) - temp1/FL(6.0) - x0/FL(3.0)) +
+          fracsq*frac*(temp1/FL(6.0) - FL(0.5)*x2) + fracsq*(FL(0.5)*x2 - x1);
+      }
+    }
+}
+
+static void setup(TABL *p, int32_t len, int mode, int wrap) {
+    int32_t i;
+
+    ftab.ftable = (MYFLT*) realloc(ftab.ftable, sizeof(MYFLT) * (len + 1));
+    for (i = 0; i <= len; i++)
+      ftab.ftable[i] = sin(i * 2.0 * PI / len) + 0.25 * cos(i * 0.37);
+    ftab.flen = len;
+    ftab.lenmask = len - 1;
+    memset(&insds, 0, sizeof(INSDS));
+    insds.ksmps = BLK;
+    memset(p, 0, sizeof(TABL));
+    p->h.insdshead = &insds;
+    p->sig = out;
+    p->ndx = ndx;
+    offs = mode ? 0.125 : 3.0;
+    fmode = mode;
+    fwrap = wrap;
+    p->offset = &offs;
+    p->mode = &fmode;
+    p->wrap = &fwrap;
+    p->ftp = &ftab;
+    p->len = len;
+    p->mul = mode ? len : 1;
+    p->np2 = (len & (len - 1)) ? 1 : 0;
+    p->iwrap = wrap;
+    p->kern = NULL;
+}
+
+/* every reader, mode and wrap against the old code, indices in and
+   out of range */
+void test_table_read(void) {
+    CSOUND  *csound = csoundCreate(NULL);
+    int32_t lens[3] = { 1024, 1000, 3 };
+    int     orders[3] = { 0, 1, 3 };
+    int32_t (*rd[3])(CSOUND *, TABL *) =
+      { tabler_audio, tableir_audio, table3r_audio };
+    TABL    t;
+    int     l, o, mode, wrap, n, k;
+    double  err = 0.0;
+
+    srand(1);
+    for (l = 0; l < 3; l++)
+      for (o = 0; o < 3; o++)
+        for (mode = 0; mode < 2; mode++)
+          for (wrap = 0; wrap < 2; wrap++) {
+            setup(&t, lens[l], mode, wrap);
+            for (k = 0; k < 8; k++) {
+              for (n = 0; n < BLK; n++) {
+                double r = (double) rand() / RAND_MAX * 5.0 - 2.0;
+                ndx[n] = mode ? r : r * lens[l];
+              }
+              if (k == 0)                 /* ends of the table */
+                for (n = 0; n < 8; n++) {
+                  double pos = (n & 1 ? lens[l] : 0) + (n >> 1) - 2.5;
+                  ndx[n] = (mode ? pos / lens[l] : pos) - offs;
+                }
+              rd[o](csound, &t);
+              ref_read(&t, orders[o], ref);
+              for (n = 0; n < BLK; n++)
+                if (fabs(out[n] - ref[n]) > err)
+                  err = fabs(out[n] - ref[n]);
+            }
+          }
+    CU_ASSERT(err < TR_TOL);
+    /* sample accurate start and end */
+    setup(&t, 1024, 1, 1);
+    for (n = 0; n < BLK; n++)
+      ndx[n] = n / (MYFLT) BLK;
+    insds.ksmps_offset = 3;
+    insds.ksmps_no_end = 5;
+    tableir_audio(csound, &t);
+    ref_read(&t, 1, ref);
+    CU_ASSERT_EQUAL(out[2], FL(0.0));
+    CU_ASSERT_EQUAL(out[BLK - 5], FL(0.0));
+    CU_ASSERT(fabs(out[3] - ref[3]) < TR_TOL);
+    CU_ASSERT(fabs(out[BLK - 6] - ref[BLK - 6]) < TR_TOL);
+    csoundDestroy(csound);
+}
+
+/* linear and cubic reading of a wrapped normalised index, old and new */
+void test_table_read_benchmark(void) {
+    CSOUND  *csound = csoundCreate(NULL);
+    int     blocks = 200000, b, n, o;
+    TABL    t;
+    clock_t t0;
+    double  told, tnew;
+
+    for (o = 1; o <= 3; o += 2) {
+      setup(&t, 4096, 1, 1);
+      for (n = 0; n < BLK; n++)
+        ndx[n] = n * 0.0137;
+      t0 = clock();
+      for (b = 0; b < blocks; b++)
+        ref_read(&t, o, ref);
+      told = (double) (clock() - t0) / CLOCKS_PER_SEC;
+      t0 = clock();
+      for (b = 0; b < blocks; b++)
+        (o == 1 ? tableir_audio : table3r_audio)(csound, &t);
+      tnew = (double) (clock() - t0) / CLOCKS_PER_SEC;
+      printf("\n%s: %d blocks of %d in %.3f s per sample, %.3f s by block",
+             o == 1 ? "tablei" : "table3", blocks, BLK, told, tnew);
+    }
+    printf("\n");
+    csoundDestroy(csound);
+    CU_PASS("benchmark");
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("table reader tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test table readers",
+                             test_table_read)) ||
+        (NULL == CU_add_test(pSuite, "Benchmark table readers",
+                             test_table_read_benchmark))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    free(ftab.ftable);
+    return CU_get_error();
+}
@@ -0,0 +1,156 @@
+/*
+ * File:   turnoff_test.c
+ *
+ * Tests and benchmark for the batched release and deactivation of
+ * notes (Engine/insert.c)
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "csound.h"
+#include "CUnit/Basic.h"
+
+/* instr 2 starts p4 notes of instr 1, of duration p5, which have a
+ * release stage of p6 seconds; instr 3 turns off all of them with
+ * turnoff2, allowing release if p4 is non-zero */
+static const char *orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "  xtratim p4\n"
+    "  a1 oscili 0.0001, 440\n"
+    "  out a1\n"
+    "endin\n"
+    "instr 2\n"
+    "  icnt = 0\n"
+    "  while icnt < p4 do\n"
+    "    event_i \"i\", 1, 0, p5, p6\n"
+    "    icnt += 1\n"
+    "  od\n"
+    "endin\n"
+    "instr 3\n"
+    "  turnoff2 1, 0, p4\n"
+    "  turnoff\n"
+    "endin\n"
+    "instr 4\n"
+    "  chnset active:k(1), \"active\"\n"
+    "endin\n";
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+static CSOUND *start_notes(int n, double dur, double rel) {
+    CSOUND *csound = csoundCreate(NULL);
+    char   score[128];
+
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, orc);
+    snprintf(score, sizeof(score), "i 4 0 60\ni 2 0 0 %d %f %f",
+             n, dur, rel);
+    csoundReadScore(csound, score);
+    csoundStart(csound);
+    csoundPerformKsmps(csound);
+    csoundPerformKsmps(csound);
+    return csound;
+}
+
+static int active(CSOUND *csound) {
+    csoundPerformKsmps(csound);
+    return (int) csoundGetControlChannel(csound, "active", NULL);
+}
+
+/* notes of finite duration expire together, and then release */
+void test_expire(void) {
+    CSOUND *csound = start_notes(2000, 0.1, 0.05);
+    int    k;
+
+    CU_ASSERT_EQUAL(active(csound), 2000);
+    for (k = 0; k < 75; k++)        /* 0.1 s */
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(active(csound), 2000);  /* releasing */
+    for (k = 0; k < 45; k++)        /* 0.06 s */
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(active(csound), 0);
+    csoundDestroy(csound);
+}
+
+/* turnoff2 with and without release */
+void test_turnoff2(void) {
+    CSOUND *csound = start_notes(2000, -1.0, 0.05);
+    int    k;
+
+    CU_ASSERT_EQUAL(active(csound), 2000);
+    csoundInputMessage(csound, "i 3 0 0.1 1");
+    CU_ASSERT_EQUAL(active(csound), 2000);  /* releasing */
+    for (k = 0; k < 45; k++)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(active(csound), 0);
+    csoundInputMessage(csound, "i 2 0 0 1000 -1 0.05");
+    CU_ASSERT_EQUAL(active(csound), 1000);
+    csoundInputMessage(csound, "i 3 0 0.1 0");
+    CU_ASSERT_EQUAL(active(csound), 0);
+    csoundDestroy(csound);
+}
+
+/* milliseconds for the k-cycle in which n notes are turned off */
+static double time_turnoff(int n, int release) {
+    CSOUND  *csound = start_notes(n, -1.0, 0.05);
+    clock_t t0;
+    double  ms;
+
+    csoundInputMessage(csound, release ? "i 3 0 0.1 1" : "i 3 0 0.1 0");
+    t0 = clock();
+    csoundPerformKsmps(csound);
+    ms = 1e3 * (double) (clock() - t0) / CLOCKS_PER_SEC;
+    csoundDestroy(csound);
+    return ms;
+}
+
+void test_turnoff_benchmark(void) {
+    static const int notes[] = { 1000, 4000, 16000, 0 };
+    int n;
+
+    printf("\n%8s %14s %14s\n", "notes", "release (ms)", "now (ms)");
+    for (n = 0; notes[n]; n++)
+      printf("%8d %14.2f %14.2f\n", notes[n], time_turnoff(notes[n], 1),
+             time_turnoff(notes[n], 0));
+    CU_PASS("benchmark");
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("turnoff tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test expiry of notes", test_expire)) ||
+        (NULL == CU_add_test(pSuite, "Test turnoff2", test_turnoff2)) ||
+        (NULL == CU_add_test(pSuite, "Benchmark turnoff",
+                             test_turnoff_benchmark))) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,199 @@
+/*
+ * File:   util_threads_test.c
+ *
+ * Tests that the analysis utilities write the same bytes whatever the
+ * number of threads given with -j (util_parallel() in util/std_util.c)
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "csoundCore.h"
+#include "CUnit/Basic.h"
+
+#define UT_MONO     "util_threads_mono.wav"
+#define UT_STEREO   "util_threads_stereo.wav"
+#define UT_SERIAL   "util_threads_j1.out"
+#define UT_THREADED "util_threads_j4.out"
+#define UT_AGAIN    "util_threads_j4b.out"
+#define UT_SR       22050
+#define UT_FRAMES   UT_SR
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    remove(UT_MONO);
+    remove(UT_STEREO);
+    remove(UT_SERIAL);
+    remove(UT_THREADED);
+    remove(UT_AGAIN);
+    return 0;
+}
+
+/* a 220 Hz tone with a few harmonics, a glide and some noise, so that
+   every frame of the analyses has something to find */
+static void make_file(const char *name, int chans) {
+    SF_INFO sfinfo;
+    SNDFILE *sf;
+    short   *buf = (short*) malloc(sizeof(short) * UT_FRAMES * chans);
+    double  ph = 0.0;
+    unsigned int seed = 1;
+    int     i, c, h;
+
+    for (i = 0; i < UT_FRAMES; i++) {
+      double x = 0.0;
+      ph += 2.0 * M_PI * (220.0 + 20.0 * i / UT_FRAMES) / UT_SR;
+      for (h = 1; h <= 6; h++)
+        x += sin(h * ph) / (h * 4.0);
+      for (c = 0; c < chans; c++) {
+        seed = seed * 1664525u + 1013904223u;
+        buf[i * chans + c] =
+          (short) (12000.0 * (x + ((seed >> 16) / 65536.0 - 0.5) * 0.05)
+                   / (c + 1));
+      }
+    }
+    memset(&sfinfo, 0, sizeof(SF_INFO));
+    sfinfo.samplerate = UT_SR;
+    sfinfo.channels = chans;
+    sfinfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+    sf = sf_open(name, SFM_WRITE, &sfinfo);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(sf);
+    sf_write_short(sf, buf, UT_FRAMES * chans);
+    sf_close(sf);
+    free(buf);
+}
+
+static char *read_all(const char *name, long *size) {
+    FILE *f = fopen(name, "rb");
+    char *buf;
+
+    *size = -1;
+    if (f == NULL)
+      return NULL;
+    fseek(f, 0L, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0L, SEEK_SET);
+    buf = (char*) malloc(*size > 0 ? *size : 1);
+    if (fread(buf, 1, *size, f) != (size_t) *size)
+      *size = -1;
+    fclose(f);
+    return buf;
+}
+
+/* 0 if the two files have the same bytes */
+static int compare_files(const char *a, const char *b) {
+    long na, nb;
+    char *da = read_all(a, &na), *db = read_all(b, &nb);
+    int  ret = (na > 0 && na == nb && memcmp(da, db, na) == 0) ? 0 : -1;
+
+    free(da);
+    free(db);
+    return ret;
+}
+
+/* run the utility with -j and args, OUT standing for the output file */
+static int run(CSOUND *csound, const char *name, const char **args,
+               const char *j, const char *out) {
+    char *argv[16];
+    int  argc = 0;
+
+    argv[argc++] = (char*) name;
+    argv[argc++] = (char*) j;
+    for ( ; *args != NULL; args++)
+      argv[argc++] = (char*) (strcmp(*args, "OUT") == 0 ? out : *args);
+    remove(out);
+    return csoundRunUtility(csound, name, argc, argv);
+}
+
+/* serially, with four threads, and with four threads again on the same
+   instance (so from the pool left by the first run) */
+static void check_utility(const char *name, const char **args) {
+    CSOUND *csound = csoundCreate(NULL);
+
+    csoundCreateMessageBuffer(csound, 0);
+    CU_ASSERT_EQUAL(run(csound, name, args, "-j1", UT_SERIAL), 0);
+    CU_ASSERT_EQUAL(run(csound, name, args, "-j4", UT_THREADED), 0);
+    CU_ASSERT_EQUAL(run(csound, name, args, "-j4", UT_AGAIN), 0);
+    csoundDestroyMessageBuffer(csound);
+    csoundDestroy(csound);
+    CU_ASSERT_EQUAL(compare_files(UT_SERIAL, UT_THREADED), 0);
+    CU_ASSERT_EQUAL(compare_files(UT_SERIAL, UT_AGAIN), 0);
+}
+
+void test_pvanal(void) {
+    const char *args[] = { "-n1024", "-h128", UT_MONO, "OUT", NULL };
+    make_file(UT_MONO, 1);
+    check_utility("pvanal", args);
+}
+
+void test_lpanal(void) {
+    const char *args[] = { "-p24", "-h200", UT_MONO, "OUT", NULL };
+    make_file(UT_MONO, 1);
+    check_utility("lpanal", args);
+}
+
+void test_hetro(void) {
+    const char *args[] = { "-f220", "-h8", UT_MONO, "OUT", NULL };
+    make_file(UT_MONO, 1);
+    check_utility("hetro", args);
+}
+
+/* type 1 (amplitudes only) leaves out the residual, which is written to
+   a fixed temporary file */
+void test_atsa(void) {
+    const char *args[] = { "-F1", UT_MONO, "OUT", NULL };
+    make_file(UT_MONO, 1);
+    check_utility("atsa", args);
+}
+
+/* 16 bit output, since float files carry a time stamp */
+void test_srconv(void) {
+    const char *args[] = { "-r44100", "-W", "-s", "-o", "OUT", UT_STEREO,
+                           NULL };
+    make_file(UT_STEREO, 2);
+    check_utility("srconv", args);
+}
+
+int main(int argc, char **argv) {
+    CU_pSuite pSuite = NULL;
+    int       i;
+
+    /* the plugin directory is passed as -+env:OPCODE6DIR64=...; modules
+     * are loaded by csoundCreate(), so it must be in the environment */
+    for (i = 1; i < argc; i++)
+      if (strncmp(argv[i], "-+env:", 6) == 0)
+        putenv(argv[i] + 6);
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Utility thread tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test pvanal threads", test_pvanal))
+        || (NULL == CU_add_test(pSuite, "Test lpanal threads", test_lpanal))
+        || (NULL == CU_add_test(pSuite, "Test hetro threads", test_hetro))
+        || (NULL == CU_add_test(pSuite, "Test atsa threads", test_atsa))
+        || (NULL == CU_add_test(pSuite, "Test srconv threads", test_srconv))
+        ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
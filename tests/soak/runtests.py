@@ -388,6 +388,7 @@ testFiles = [
 "hrtfer",
 "hrtfmove2",
 "hrtfmove",
+"hrtfsrc",
 "hrtfstat-2",
 "hrtfstat",
 "hsboscil",
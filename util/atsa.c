@@ -158,6 +158,7 @@ typedef struct {
     int     highest_bin;
     int     frames;
     int     type;
+    int     threads;
 } ANARGS;
 
 /* ATS_FFT
@@ -596,6 +597,8 @@ static CS_NOINLINE CS_NORETURN void usage(CSOUND *csound)
                     ATSA_LPKCONT);
     csound->Message(csound, Str("\t -M SMR contribution (%f)\n"), ATSA_SMRCONT);
     csound->Message(csound, Str("\t -F File Type (type: %d)\n"), ATSA_TYPE);
+    csound->Message(csound, "%s", Str("\t -j number of analysis threads "
+                                      "(as csound -j)\n"));
     csound->Message(csound, "%s", Str("\t\t(Options: 1=amp.and freq. only, "
                                 "2=amp.,freq. and phase, "
                                 "3=amp.,freq. and residual, "
@@ -712,6 +715,9 @@ static int atsa_main(CSOUND *csound, int argc, char **argv)
       case 'F':
         anargs->type = (int) atoi(s);
         break;
+      case 'j':
+        anargs->threads = (int) atoi(s);
+        break;
       default:
         usage(csound);
       }
@@ -1997,12 +2003,61 @@ static int compute_frames(ANARGS *anargs);
  * soundfile: path to input file
  * returns an ATS_SOUND with data issued from analysis
  */
+/* the spectra and peaks of all frames, which do not depend on each other,
+   are found in parallel before the (sequential) peak tracking */
+typedef struct {
+    ANARGS  *anargs;
+    float   *window, norm;
+    mus_sample_t *smps;
+    int     sflen, M_2, first_point, first_filptr;
+    MYFLT   *fft_data[UTIL_MAX_THREADS];
+    ATS_PEAK **peaks;
+    int     *peaks_size, *win_samps;
+} ATSA_FRAMES;
+
+static void atsa_frame(CSOUND *csound, void *data, int thread, int frame_n)
+{
+    ATSA_FRAMES *q = (ATSA_FRAMES *) data;
+    ANARGS  *anargs = q->anargs;
+    ATS_FFT fft;
+    ATS_PEAK *peaks;
+    int     k, peaks_size = 0;
+    int     filptr = q->first_filptr + frame_n * anargs->hop_smp;
+
+    fft.size = anargs->fft_size;
+    fft.rate = anargs->srate;
+    fft.data = q->fft_data[thread];
+    /* clear fft arrays */
+    for (k = 0; k < (fft.size + 2); k++)
+      fft.data[k] = (MYFLT) 0;
+    /* multiply by window */
+    for (k = 0; k < anargs->win_size; k++) {
+      if ((filptr >= 0) && (filptr < q->sflen))
+        fft.data[(k + q->first_point) % anargs->fft_size] =
+            (MYFLT) q->window[k] * (MYFLT) q->smps[filptr];
+      filptr++;
+    }
+    /* we keep sample numbers of window midpoints in win_samps array */
+    q->win_samps[frame_n] = filptr - q->M_2 - 1;
+    /* take the fft */
+    csound->RealFFTnp2(csound, fft.data, fft.size);
+    /* peak detection */
+    peaks =
+        peak_detection(csound, &fft, anargs->lowest_bin, anargs->highest_bin,
+                       anargs->lowest_mag, q->norm, &peaks_size);
+    /* evaluate peaks SMR (masking curves) */
+    if (peaks != NULL)
+      evaluate_smr(peaks, peaks_size);
+    q->peaks[frame_n] = peaks;
+    q->peaks_size[frame_n] = peaks_size;
+}
+
 static ATS_SOUND *tracker(CSOUND *csound, ANARGS *anargs, char *soundfile,
                           char *resfile)
 {
     int     M_2, first_point, filptr, n_partials = 0;
     int     frame_n, k, sflen, *win_samps, peaks_size, tracks_size = 0;
-    int     i, frame, i_tmp;
+    int     i, frame, i_tmp, nthreads;
     float   *window, norm, sfdur, f_tmp;
 
     /* declare structures and buffers */
@@ -2010,7 +2065,7 @@ static ATS_SOUND *tracker(CSOUND *csound, ANARGS *anargs, char *soundfile,
     ATS_PEAK *peaks, *tracks = NULL, cpy_peak;
     ATS_FRAME *ana_frames = NULL, *unmatched_peaks = NULL;
     mus_sample_t **bufs;
-    ATS_FFT fft;
+    ATSA_FRAMES q;
     SF_INFO sfinfo;
     SNDFILE *sf;
     void    *fd;
@@ -2241,40 +2296,36 @@ static ATS_SOUND *tracker(CSOUND *csound, ANARGS *anargs, char *soundfile,
     /* read sound into memory */
     atsa_sound_read_noninterleaved(sf, bufs, 1, sflen);
 
-    /* make our fft-struct */
-    fft.size = anargs->fft_size;
-    fft.rate = anargs->srate;
-    fft.data =
-        (MYFLT *) csound->Malloc(csound,
-                                 (anargs->fft_size + 2) * sizeof(MYFLT));
+    /* spectra and peaks of all frames */
+    nthreads = util_threads(csound, anargs->threads);
+    if (nthreads > anargs->frames)
+      nthreads = anargs->frames;
+    q.anargs = anargs;
+    q.window = window;
+    q.norm = norm;
+    q.smps = bufs[0];
+    q.sflen = sflen;
+    q.M_2 = M_2;
+    q.first_point = first_point;
+    q.first_filptr = filptr;
+    q.peaks = (ATS_PEAK **) csound->Malloc(csound,
+                                           anargs->frames * sizeof(ATS_PEAK *));
+    q.peaks_size = (int *) csound->Malloc(csound, anargs->frames * sizeof(int));
+    q.win_samps = win_samps;
+    for (i = 0; i < nthreads; i++)
+      q.fft_data[i] =
+          (MYFLT *) csound->Calloc(csound,
+                                   (anargs->fft_size + 2) * sizeof(MYFLT));
+    /* set up the transform before it is shared by the threads */
+    csound->RealFFTnp2(csound, q.fft_data[0], anargs->fft_size);
+    util_parallel(csound, nthreads, anargs->frames, atsa_frame, &q);
 
     /* main loop */
     for (frame_n = 0; frame_n < anargs->frames; frame_n++) {
-      /* clear fft arrays */
-      for (k = 0; k < (fft.size + 2); k++)
-        fft.data[k] = (MYFLT) 0;
-      /* multiply by window */
-      for (k = 0; k < anargs->win_size; k++) {
-        if ((filptr >= 0) && (filptr < sflen))
-          fft.data[(k + first_point) % anargs->fft_size] =
-              (MYFLT) window[k] * (MYFLT) bufs[0][filptr];
-        filptr++;
-      }
-      /* we keep sample numbers of window midpoints in win_samps array */
-      win_samps[frame_n] = filptr - M_2 - 1;
-      /* move file pointer back */
-      filptr = filptr - anargs->win_size + anargs->hop_smp;
-      /* take the fft */
-      csound->RealFFTnp2(csound, fft.data, fft.size);
-      /* peak detection */
-      peaks_size = 0;
-      peaks =
-          peak_detection(csound, &fft, anargs->lowest_bin, anargs->highest_bin,
-                         anargs->lowest_mag, norm, &peaks_size);
+      peaks = q.peaks[frame_n];
+      peaks_size = q.peaks_size[frame_n];
       /* peak tracking */
       if (peaks != NULL) {
-        /* evaluate peaks SMR (masking curves) */
-        evaluate_smr(peaks, peaks_size);
         if (frame_n) {
           /* initialise or update tracks */
           if ((tracks =
@@ -2345,7 +2396,10 @@ static ATS_SOUND *tracker(CSOUND *csound, ANARGS *anargs, char *soundfile,
     /* free up some memory */
     csound->Free(csound, window);
     csound->Free(csound, tracks);
-    csound->Free(csound, fft.data);
+    for (i = 0; i < nthreads; i++)
+      csound->Free(csound, q.fft_data[i]);
+    csound->Free(csound, q.peaks);
+    csound->Free(csound, q.peaks_size);
     /* init sound */
     csound->Message(csound, "%s", Str("Initializing ATS data..."));
     sound = (ATS_SOUND *) csound->Malloc(csound, sizeof(ATS_SOUND));
@@ -96,8 +96,25 @@ typedef struct {
   MYFLT  *adp;                  /* pointer to front of sample file */
   double *c_p,*s_p;             /* pointers to space for sine and cos terms */
   int32_t newformat;             /* flag for m/c independent format */
+  double first_ph;              /* phase at the first sample of a harmonic */
+  int32_t nojump,                /* no phase unwrap at the first sample */
+         events;                /* thread may call CheckEvents */
 } HET;
 
+/* harmonics are analysed independently apart from the phase unwrap at the
+   first sample, which compares with the last phase of the previous one.
+   With several threads a first pass assumes no jump, and the harmonics
+   where there should have been one are analysed again, so the output is
+   identical whatever the number of threads */
+typedef struct {
+  HET     *thr;                 /* scratch copy of the analysis per thread */
+  int32_t *hno;                 /* harmonics to analyse in this pass */
+  MYFLT   *est, *max_frq, *max_amp;    /* per harmonic */
+  double  *prev_ph, *first_ph, *last_ph;
+  int32_t nojump;
+  volatile int32_t abort;
+} HET_PASS;
+
 #if INCSDIF
 static int32_t writesdif(CSOUND*, HET*);
 #endif
@@ -105,6 +122,7 @@ static  double  GETVAL(HET *, double *, int32);
 //static  double  sq(double);
 static  void    PUTVAL(HET *,double *, int32, double);
 static  int32_t hetdyn(CSOUND *csound, HET *, int32_t);
+static  void    het_harmonic(CSOUND *, void *, int32_t, int32_t);
 static  void    lpinit(HET*);
 static  void    lowpass(HET *,double *, double *, int32);
 static  void    average(HET *,int32, double *, double *, int32);
@@ -137,17 +155,19 @@ static void init_het(HET *t)
     t->bufsiz    = 1;             /* circular buffer size */
     t->skip      = 0;             /* JPff: this was missing */
     t->newformat = 1;
+    t->nojump    = 0;
+    t->events    = 1;
 }
 
 static int32_t hetro(CSOUND *csound, int32_t argc, char **argv)
 {
     SNDFILE *infd;
-    int32_t i, hno, channel = 1, retval = 0;
+    int32_t i, hno, channel = 1, retval = 0, nthreads = 0, nrerun;
     int32   nsamps, smpspc, bufspc, mgfrspc;
     char    *dsp, *dspace;
-    double  *begbufs, *endbufs;
     HET     het;
     HET     *t = &het;
+    HET_PASS q;
     SOUNDIN *p;         /* space allocated by SAsndgetset() */
 
  /* csound->dbfs_to_float = csound->e0dbfs = FL(1.0);   Needed ? */
@@ -228,6 +248,10 @@ static int32_t hetro(CSOUND *csound, int32_t argc, char **argv)
           csound->sscanf(s,"%f",&t->freq_c);
 #endif
           break;
+        case 'j':
+          FIND(Str("no number of threads"))
+          sscanf(s,"%d",&nthreads);
+          break;
         case 'X':
           het.newformat = 1;
           break;
@@ -304,24 +328,6 @@ static int32_t hetro(CSOUND *csound, int32_t argc, char **argv)
     smpspc = t->smpsin * sizeof(double);
     bufspc = t->bufsiz * sizeof(double);
 //printf("sizes2: smpspc - %d  bufspc - %d\n", smpspc, bufspc);
-    dsp = dspace = csound->Calloc(csound, smpspc * 2 + bufspc * 13);
-    t->c_p = (double *) dsp;      dsp += smpspc;  /* space for the    */
-    t->s_p = (double *) dsp;      dsp += smpspc;  /* quadrature terms */
-    begbufs = (double *) dsp;
-    t->cos_mul = (double *) dsp;  dsp += bufspc;  /* bufs that will be */
-    t->sin_mul = (double *) dsp;  dsp += bufspc;  /* refilled each hno */
-    t->a_term = (double *) dsp;   dsp += bufspc;
-    t->b_term = (double *) dsp;   dsp += bufspc;
-    t->r_ampl = (double *) dsp;   dsp += bufspc;
-    t->ph_av1 = (double *) dsp;   dsp += bufspc;
-    t->ph_av2 = (double *) dsp;   dsp += bufspc;
-    t->ph_av3 = (double *) dsp;   dsp += bufspc;
-    t->r_phase = (double *) dsp;  dsp += bufspc;
-    t->amp_av1 = (double *) dsp;  dsp += bufspc;
-    t->amp_av2 = (double *) dsp;  dsp += bufspc;
-    t->amp_av3 = (double *) dsp;  dsp += bufspc;
-    t->a_avg = (double *) dsp;    dsp += bufspc;
-    endbufs = (double *) dsp;
 
     mgfrspc = t->num_pts * sizeof(MYFLT);
     dsp = csound->Malloc(csound, mgfrspc * t->hmax * 2);
@@ -335,27 +341,81 @@ static int32_t hetro(CSOUND *csound, int32_t argc, char **argv)
     }
     lpinit(t);                        /* calculate LPF coeffs.  */
     t->adp = t->auxp;           /* point to beg sample data block */
-    for (hno = 0; hno < t->hmax; hno++) { /* for requested harmonics */
-      double *dblp;
-      t->freq_est += t->fund_est; /*   do analysis */
-      t->cur_est = t->freq_est;
-      dblp = begbufs;
-      // TODO? memset(begbufs, '\0', (endbufs-begbufs)*sizeof(double));
-      do {
-        *dblp++ = FL(0.0);                    /* clear all refilling buffers */
-      } while (dblp < endbufs);
-      t->max_frq = FL(0.0);
-      t->max_amp = -FL(1.0);
 
+    nthreads = util_threads(csound, nthreads);
+    if (nthreads > t->hmax)
+      nthreads = t->hmax;
+    q.thr = (HET *) csound->Malloc(csound, nthreads * sizeof(HET));
+    q.hno = (int32_t *) csound->Malloc(csound, t->hmax * sizeof(int32_t));
+    q.est = (MYFLT *) csound->Malloc(csound, t->hmax * 3 * sizeof(MYFLT));
+    q.max_frq = q.est + t->hmax;
+    q.max_amp = q.max_frq + t->hmax;
+    q.prev_ph = (double *) csound->Calloc(csound,
+                                          t->hmax * 3 * sizeof(double));
+    q.first_ph = q.prev_ph + t->hmax;
+    q.last_ph = q.first_ph + t->hmax;
+    q.abort = 0;
+    dsp = dspace = csound->Calloc(csound,
+                                  (smpspc * 2 + bufspc * 13) * nthreads);
+    for (i = 0; i < nthreads; i++) {
+      HET *h = &q.thr[i];
+      *h = *t;
+      h->events = (i == 0);
+      h->c_p = (double *) dsp;      dsp += smpspc;  /* space for the    */
+      h->s_p = (double *) dsp;      dsp += smpspc;  /* quadrature terms */
+      h->cos_mul = (double *) dsp;  dsp += bufspc;  /* bufs that will be */
+      h->sin_mul = (double *) dsp;  dsp += bufspc;  /* refilled each hno */
+      h->a_term = (double *) dsp;   dsp += bufspc;
+      h->b_term = (double *) dsp;   dsp += bufspc;
+      h->r_ampl = (double *) dsp;   dsp += bufspc;
+      h->ph_av1 = (double *) dsp;   dsp += bufspc;
+      h->ph_av2 = (double *) dsp;   dsp += bufspc;
+      h->ph_av3 = (double *) dsp;   dsp += bufspc;
+      h->r_phase = (double *) dsp;  dsp += bufspc;
+      h->amp_av1 = (double *) dsp;  dsp += bufspc;
+      h->amp_av2 = (double *) dsp;  dsp += bufspc;
+      h->amp_av3 = (double *) dsp;  dsp += bufspc;
+      h->a_avg = (double *) dsp;    dsp += bufspc;
+    }
+    for (hno = 0; hno < t->hmax; hno++) { /* for requested harmonics */
+      t->freq_est += t->fund_est;
+      q.est[hno] = t->freq_est;
+      q.hno[hno] = hno;
+    }
+    if (nthreads == 1) {
+      /* one after the other, each continuing from the last phase */
+      q.nojump = 0;
+      for (hno = 0; hno < t->hmax && !q.abort; hno++) {
+        q.prev_ph[hno] = t->old_ph;
+        het_harmonic(csound, &q, 0, hno);
+        t->old_ph = q.last_ph[hno];
+      }
+    }
+    else {
+      q.nojump = 1;
+      util_parallel(csound, nthreads, t->hmax, het_harmonic, &q);
+      for (hno = nrerun = 0; hno < t->hmax; hno++) {
+        q.prev_ph[hno] = t->old_ph;
+        if (fabs(q.first_ph[hno] - t->old_ph) > PI)
+          q.hno[nrerun++] = hno;
+        t->old_ph = q.last_ph[hno];
+      }
+      q.nojump = 0;
+      if (nrerun && !q.abort)
+        util_parallel(csound, nthreads, nrerun, het_harmonic, &q);
+    }
+    if (q.abort || !csound->CheckEvents(csound))
+      return -1;
+    for (hno = 0; hno < t->hmax; hno++) {
       csound->Message(csound,Str("analyzing harmonic #%d\n"),hno);
-      csound->Message(csound,Str("freq estimate %6.1f,"), t->cur_est);
-      if (hetdyn(csound, t, hno) != 0)  /* perform actual computation */
-        return -1;
-      if (!csound->CheckEvents(csound))
-        return -1;
+      csound->Message(csound,Str("freq estimate %6.1f,"), q.est[hno]);
       csound->Message(csound, Str(" max found %6.1f, rel amp %6.1f\n"),
-                              t->max_frq, t->max_amp);
+                              q.max_frq[hno], q.max_amp[hno]);
     }
+    csound->Free(csound, q.thr);
+    csound->Free(csound, q.hno);
+    csound->Free(csound, q.est);
+    csound->Free(csound, q.prev_ph);
     csound->Free(csound, dspace);
 #if INCSDIF
     /* RWD if extension is .sdif, write as 1TRC frames */
@@ -372,6 +432,33 @@ static int32_t hetro(CSOUND *csound, int32_t argc, char **argv)
     return retval;
 }
 
+/* analyse harmonic q->hno[item] with the scratch buffers of the thread */
+static void het_harmonic(CSOUND *csound, void *data,
+                         int32_t thread, int32_t item)
+{
+    HET_PASS *q = (HET_PASS *) data;
+    HET     *t = &q->thr[thread];
+    int32_t hno = q->hno[item];
+
+    if (q->abort)
+      return;
+    memset(t->cos_mul, 0, 13 * t->bufsiz * sizeof(double));
+    t->cur_est = q->est[hno];
+    t->max_frq = FL(0.0);
+    t->max_amp = -FL(1.0);
+    t->old_ph = q->prev_ph[hno];
+    t->first_ph = t->old_ph;
+    t->nojump = q->nojump;
+    if (hetdyn(csound, t, hno) != 0) {  /* perform actual computation */
+      q->abort = 1;
+      return;
+    }
+    q->max_frq[hno] = t->max_frq;
+    q->max_amp[hno] = t->max_amp;
+    q->first_ph[hno] = t->first_ph;
+    q->last_ph[hno] = t->old_ph;
+}
+
 static double GETVAL(HET* t, double *inb, int32 smpl)
 {                               /* get value at position smpl in array inb */
     if (smpl<0) return 0.0;
@@ -454,7 +541,7 @@ static int32_t hetdyn(CSOUND *csound,
         /* if next out-time */
         output(t, smplno, hno, outpnt);  /*     place in     */
         lastout = outpnt;                      /*     output array */
-        if (!csound->CheckEvents(csound))
+        if (t->events && !csound->CheckEvents(csound))
           return -1;
       }
       if (t->skip) {
@@ -542,7 +629,10 @@ static void output_ph(HET *t,int32 smpl)
     else t->new_ph=
            -atan(GETVAL(t,t->b_term,smpl)/temp_a) - PI*u(-temp_a);
 
-    if (fabs((double)t->new_ph - t->old_ph)>PI)
+    if (smpl == 0)
+      t->first_ph = t->new_ph;
+    if (!(smpl == 0 && t->nojump) &&
+        fabs((double)t->new_ph - t->old_ph)>PI)
       t->jmp_ph -= TWOPI*sgn(temp_a);
 
     //printf("output-ph: %f ->%f\n",t->old_ph, t->new_ph);
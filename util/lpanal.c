@@ -54,8 +54,22 @@ typedef struct {
   int32_t newmethod;
   void *setup;
   uint32_t storePoles;
+  MYFLT *noise;                 /* added to the signal for pole storage */
 } LPC;
 
+/* frames analysed per thread in one batch */
+#define LP_BATCH  32
+
+/* a batch of frames and the per thread analysis state */
+typedef struct {
+  LPC      lpc[UTIL_MAX_THREADS];
+  int32_t  nthreads, batch, slice, nvals, storePoles;
+  MYFLT    *sig;        /* signal of the batch, (batch + 1) slices */
+  MYFLT    *noise;      /* noise per frame, or NULL */
+  MYFLT    *coef;       /* output frames */
+  int32_t  *found;      /* number of poles found per frame */
+} LP_FRAMES;
+
 #ifdef TRACE
 static  FILE *trace;
 #endif
@@ -89,6 +103,8 @@ static  void    quit(CSOUND *, char *), lpdieu(CSOUND *, char *);
 static  void    usage(CSOUND *);
 static  void    ptable(CSOUND *, MYFLT, MYFLT, MYFLT, int32_t, LPANAL_GLOBALS*);
 static  MYFLT   getpch(CSOUND *, MYFLT *, LPANAL_GLOBALS*);
+static  void    lp_frame(CSOUND *, void *, int32_t, int32_t);
+static  MYFLT   noise(MYFLT);
 
 /* Search for an argument and report of not found */
 #define FIND(MSG)   if (*s == '\0')  \
@@ -350,11 +366,9 @@ static int32_t lpanal(CSOUND *csound, int32_t argc, char **argv)
 {
     SNDFILE *infd;
     int32_t     slice, analframes, counter, channel;
-    MYFLT   *coef, beg_time, input_dur, sr = FL(0.0);
+    MYFLT   beg_time, input_dur, sr = FL(0.0);
     char    *infilnam, *outfilnam;
     int32_t     ofd;
-    double  errn, rms1, rms2, filterCoef[MAXPOLES+1];
-    MYFLT   *sigbuf, *sigbuf2;      /* changed from short */
     int64_t    n;
     uint32_t     osiz, nb;
     int32_t     hsize;
@@ -366,14 +380,9 @@ static int32_t lpanal(CSOUND *csound, int32_t argc, char **argv)
 
 /* Added by MR to handle pole storage */
 
-    int32_t     i, j, indic, storePoles;
-    int32_t     poleFound;
-    double  pr, pi, pm, pp, dPI;
-    double  polePart1[MAXPOLES], polePart2[MAXPOLES];
-    double  z1, workArray1[MAXPOLES];
-#ifdef _DEBUG
-    double  polyReal[MAXPOLES], polyImag[MAXPOLES];
-#endif
+    int32_t     i, storePoles;
+    int32_t     nthreads = 0, eof;
+    LP_FRAMES   fr;
     LPANAL_GLOBALS *lpg;
     int32_t new_format=0;
     FILE    *oFd;
@@ -402,7 +411,6 @@ static int32_t lpanal(CSOUND *csound, int32_t argc, char **argv)
     *tp           = '\0';
     pchlow        = PITCHMIN;
     pchhigh       = PITCHMAX;
-    dPI           = atan2(0,-1);
 
     /* Default is to store filter coefficients */
     storePoles = FALSE;
@@ -486,6 +494,8 @@ static int32_t lpanal(CSOUND *csound, int32_t argc, char **argv)
           // new
           lpc.newmethod = 1;
           break;
+        case 'j':       FIND(Str("no number of threads"))
+                        sscanf(s,"%d",&nthreads); break;
         default:
           {
             char errmsg[256];
@@ -505,9 +515,6 @@ static int32_t lpanal(CSOUND *csound, int32_t argc, char **argv)
     outfilnam = *argv;
     if (UNLIKELY(lpc.poleCount > MAXPOLES))
       quit(csound,Str("poles exceeds maximum allowed"));
-    /* Allocate space now */
-    coef = (MYFLT*) csound->Malloc(csound, (NDATA+lpc.poleCount*2)*sizeof(MYFLT));
-    /* Space allocated */
     if (UNLIKELY(slice < lpc.poleCount * 5))
       csound->Warning(csound,"%s", Str("hopsize may be too small, "
                                  "recommend at least poleCount * 5\n"));
@@ -593,12 +600,30 @@ static int32_t lpanal(CSOUND *csound, int32_t argc, char **argv)
        filtercoef or poles + freq/rms/... */
     osiz = (lpc.poleCount*(storePoles?2:1) + NDATA) * sizeof(MYFLT);
 
-    /* Allocate signal buffer for sound frame */
-    sigbuf = (MYFLT *) csound->Malloc(csound, (int64_t)lpc.WINDIN * sizeof(MYFLT));
-    sigbuf2 = sigbuf + slice;
+    /* Frames are analysed in batches, each frame of a batch on one of the
+       threads. The signal of a whole batch is kept, with its frames
+       overlapping by one slice, and the results are written out in order */
+    nthreads = util_threads(csound, nthreads);
+    fr.nthreads = nthreads;
+    fr.batch = LP_BATCH * nthreads;
+    fr.slice = slice;
+    fr.nvals = lph->nvals;
+    fr.storePoles = storePoles;
+    fr.sig = (MYFLT *) csound->Malloc(csound,
+                                      (int64_t)(fr.batch + 2) * slice *
+                                      sizeof(MYFLT));
+    fr.coef = (MYFLT *) csound->Malloc(csound,
+                                       (int64_t)fr.batch * osiz);
+    fr.found = (int32_t *) csound->Malloc(csound, fr.batch * sizeof(int32_t));
+    /* the noise added for pole analysis comes from rand(), so it is drawn
+       in frame order here rather than in the threads */
+    fr.noise = storePoles && !lpc.newmethod ?
+      (MYFLT *) csound->Malloc(csound,
+                               (int64_t)fr.batch * lpc.WINDIN * sizeof(MYFLT)) :
+      NULL;
 
     /* Try to read first frame in buffer */
-    if (UNLIKELY((n = csound->getsndin(csound, infd, sigbuf, lpc.WINDIN, p)) <
+    if (UNLIKELY((n = csound->getsndin(csound, infd, fr.sig, lpc.WINDIN, p)) <
                  lpc.WINDIN))
       quit(csound,Str("soundfile read error, could not fill first frame"));
 
@@ -616,168 +641,103 @@ static int32_t lpanal(CSOUND *csound, int32_t argc, char **argv)
     csound->dispset(csound, &lpc.pwindow, coef + 4, lpc.poleCount,
                     "pitch: 0000.00   ", 0, "LPC/POLES");
 #endif
-    /* Space for a array */
-    lpc.a = (double (*)[MAXPOLES])
-      csound->Malloc(csound, MAXPOLES * MAXPOLES * sizeof(double));
-    lpc.x = (double *) csound->Malloc(csound,   /* alloc a double array */
-                                      lpc.WINDIN * sizeof(double));
 #ifdef TRACE
     csound->FileOpen2(csound, &trace, CSFILE_STD, "lpanal.trace", "w", NULL,
                       CSFTYPE_OTHER_TEXT, 0);
 #endif
 
-    // for new lpred method
-    lpc.setup = csound->LPsetup(csound,lpc.WINDIN,lpc.poleCount);
     if(lpc.newmethod)
       csound->Message(csound, "using Durbin method \n");
     lpc.storePoles = storePoles;
+    /* per thread analysis state */
+    for (i = 0; i < nthreads; i++) {
+      fr.lpc[i] = lpc;
+      /* Space for a array */
+      fr.lpc[i].a = (double (*)[MAXPOLES])
+        csound->Malloc(csound, MAXPOLES * MAXPOLES * sizeof(double));
+      fr.lpc[i].x = (double *) csound->Malloc(csound,   /* alloc a double array */
+                                              lpc.WINDIN * sizeof(double));
+      // for new lpred method
+      fr.lpc[i].setup = csound->LPsetup(csound,lpc.WINDIN,lpc.poleCount);
+    }
 
     /* Do the analysis */
+    eof = 0;
     do {
-      MYFLT *fp1;
-      double *dfp;
-
-      /* Analyze current frame */
-#ifdef TRACE_POLES
-      csound->Message
-        (csound, "%s", Str("Starting new frame...\n"));
-#endif
-      counter++;
-      alpol(csound, &lpc, sigbuf, &errn, &rms1, &rms2, filterCoef);
-      /* Transfer results */
-      coef[0] = (MYFLT)rms2;
-      coef[1] = (MYFLT)rms1;
-      coef[2] = (MYFLT)errn;
-      if (lpc.doPitch)
-        coef[3] = getpch(csound, sigbuf, lpg);
-      else coef[3] = FL(0.0);
-      if (lpc.debug) csound->Message(csound,"%d\t%9.4f\t%9.4f\t%9.4f\t%9.4f\n",
-                                 counter, coef[0], coef[1], coef[2], coef[3]);
+      int32_t nf = 0, f;
+
+      /* Collect a batch of frames */
+      do {
+        if (fr.noise != NULL)
+          for (i = 0; i < lpc.WINDIN; i++)
+            fr.noise[nf * lpc.WINDIN + i] = noise(FL(0.0001));
+        nf++;
+        counter++;
+        /* Get next sound frame */
+        if (counter < analframes &&
+            csound->getsndin(csound, infd, fr.sig + (nf + 1) * slice,
+                             slice, p) == 0)
+          eof = 1;          /* refill til EOF */
+      } while (nf < fr.batch && counter < analframes && !eof);
+
+      /* Analyze the frames */
+      util_parallel(csound, nthreads, nf, lp_frame, &fr);
+
+      for (f = 0; f < nf; f++) {
+        MYFLT *coef = fr.coef + f * fr.nvals;
+
+        if (lpc.doPitch)
+          coef[3] = getpch(csound, fr.sig + f * slice, lpg);
+        else coef[3] = FL(0.0);
+        if (lpc.debug) csound->Message(csound,"%d\t%9.4f\t%9.4f\t%9.4f\t%9.4f\n",
+                                       counter - nf + f + 1,
+                                       coef[0], coef[1], coef[2], coef[3]);
 #ifdef TRACE
-      if (lpc.debug) fprintf(trace,"%d\t%9.4f\t%9.4f\t%9.4f\t%9.4f\n",
-                         counter, coef[0], coef[1], coef[2], coef[3]);
+        if (lpc.debug) fprintf(trace,"%d\t%9.4f\t%9.4f\t%9.4f\t%9.4f\n",
+                               counter - nf + f + 1,
+                               coef[0], coef[1], coef[2], coef[3]);
 #endif
-  /*  for (fp1=coef+NDATA, dfp=cc+poleCount, n=poleCount; n--; ) */
-  /*    *fp1++ = - (MYFLT) *--dfp; */  /* rev coefs & chng sgn */
 #if 0
-      CS_SPRINTF(lpc.pwindow.caption, "pitch: %8.2f", coef[3]);
-      display(csound, &lpc.pwindow);
+        CS_SPRINTF(lpc.pwindow.caption, "pitch: %8.2f", coef[3]);
+        display(csound, &lpc.pwindow);
 #endif
-
-      /* Prepare buffer for output */
-
-      if (storePoles) {
-        /* Treat (swap) filter coefs for resolution */
-
-        filterCoef[lpc.poleCount] = 1.0;
-        for (i=0; i<(lpc.poleCount+1)/2; i++) {
-          j = lpc.poleCount-1-i;
-          z1 = filterCoef[i];
-          filterCoef[i] = filterCoef[j];
-          filterCoef[j] = z1;
-        }
-
-        /* Get the Filter Poles */
-
-        polyzero(lpc.poleCount,filterCoef,polePart1,polePart2,
-                 &poleFound,2000,&indic,workArray1);
-
-        if (UNLIKELY(poleFound<lpc.poleCount)) {
+        if (UNLIKELY(fr.found[f] < lpc.poleCount)) {
           csound->Message(csound,
-                          Str("Found only %d poles...sorry\n"), poleFound);
+                          Str("Found only %d poles...sorry\n"), fr.found[f]);
           csound->Message(csound,
                           Str("wanted %d poles\n"), lpc.poleCount);
           return -1;
         }
-        InvertPoles(lpc.poleCount,polePart1,polePart2);
 
-#ifdef TRACE_POLES
-        DumpPoles(csound,
-                  lpc.poleCount, polePart1, polePart2, 0, "Extracted Poles");
-#endif
-
-#ifdef _DEBUG
-        /* Resynthetize the filter for check */
-        InvertPoles(lpc.poleCount,polePart1,polePart2);
-
-        synthetize(lpc.poleCount,polePart1,polePart2,polyReal,polyImag);
-        for (i=0; i<lpc.poleCount; i++) {
-#ifdef TRACE_FILTER
-          csound->Message(csound, "filterCoef: %f\n", filterCoef[i]);
-#endif
-          if (UNLIKELY(filterCoef[i]-polyReal[lpc.poleCount-i]>1e-10))
-            csound->Message(csound, Str("Error in coef %d : %f <> %f\n"),
-                                    i, filterCoef[i], polyReal[lpc.poleCount-i]);
-        }
-        csound->Message(csound,".");
-        InvertPoles(lpc.poleCount,polePart1,polePart2);
-#endif
-        /* Switch to pole magnitude and phase */
-
-        for (i=0; i<lpc.poleCount;i++) {
-          /* Store magnitude and phase (PI,-PI) */
-          pr = polePart1[i];
-          pi = polePart2[i];
-          pm = hypot(pr, pi);
-          if (pm!=0) {
-            pp = atan2(pi,pr);
-            if (pp>dPI)
-              pp = 2*dPI-pp;
-          }
-          else
-            pp = 0;
-          polePart1[i] = pm;
-          polePart2[i] = pp;
+        /* Write frame to disk */
+        if (new_format) {
+          uint32_t i, j;
+          for (i=0, j=0; i<osiz; i+=sizeof(MYFLT), j++)
+            fprintf(oFd, "%a\n", (double)coef[j]);
         }
-
-  /*    DumpPoles(csound, poleCount,polePart1,polePart2,1,"About to store"); */
-
-        /* Store in output buffer */
-        fp1 = coef+NDATA;
-        for (i=0; i<lpc.poleCount;i++) {
-          *fp1++ = (MYFLT)polePart1[i];
-          *fp1++ = (MYFLT)polePart2[i];
-        }
-      }
-      else {
-        /* Move filter data into output buffer */
-        dfp = filterCoef+lpc.poleCount;
-        fp1 = coef+NDATA;
-        for (n=0;n<lpc.poleCount; n++)
-          *fp1++ = - (MYFLT) *--dfp;
-      }
-
-      /* Write frame to disk */
-      if (new_format) {
-        uint32_t i, j;
-        for (i=0, j=0; i<osiz; i+=sizeof(MYFLT), j++)
-          fprintf(oFd, "%a\n", (double)coef[j]);
+        else
+          if (UNLIKELY((nb = write(ofd, (char *)coef, osiz)) != osiz))
+            quit(csound, Str("write error"));
+        if (UNLIKELY(!csound->CheckEvents(csound)))
+          return -1;
       }
-      else
-        if (UNLIKELY((nb = write(ofd, (char *)coef, osiz)) != osiz))
-          quit(csound, Str("write error"));
-      memcpy(sigbuf, sigbuf2, sizeof(MYFLT)*slice);
-
-      /* Some unused stuff. I think from when all snd was in mem */
-      /*  ( MYFLT *fp2; for (fp1=sigbuf, fp2=sigbuf2, n=slice; n--; ) */
-      /* move slice forward */
-      /*              *fp1++ = *fp2++;} */
-
-      /* Get next sound frame */
-      if ((n = csound->getsndin(csound, infd, sigbuf2, slice, p)) == 0)
-        break;          /* refill til EOF */
-      if (UNLIKELY(!csound->CheckEvents(csound)))
-        return -1;
-    } while (counter < analframes); /* or nsmps done */
+      /* move the start of the next frame to the beginning of the buffer */
+      memmove(fr.sig, fr.sig + nf * slice, sizeof(MYFLT) * lpc.WINDIN);
+    } while (counter < analframes && !eof); /* or nsmps done */
 #if 0
     /* clean up stuff */
     dispexit(csound);
 #endif
     csound->Message(csound, Str("%d lpc frames written to %s\n"),
                             counter, outfilnam);
-    csound->Free(csound, lpc.a);
-    csound->Free(csound, lpc.x);
-    csound->Free(csound, coef);
+    for (i = 0; i < nthreads; i++) {
+      csound->Free(csound, fr.lpc[i].a);
+      csound->Free(csound, fr.lpc[i].x);
+    }
+    csound->Free(csound, fr.sig);
+    csound->Free(csound, fr.coef);
+    csound->Free(csound, fr.found);
+    csound->Free(csound, fr.noise);
     csound->Free(csound, lpg->Dwind_dbuf);
     for (i=0;  i<FREQS; ++i) {
       csound->Free(csound, lpg->tphi[i]);
@@ -789,6 +749,120 @@ static int32_t lpanal(CSOUND *csound, int32_t argc, char **argv)
     return 0;
 }
 
+/* Analyse frame f of a batch: filter coefficients or poles, and the
+   rms and error values. The pitch is tracked afterwards, in order */
+
+static void lp_frame(CSOUND *csound, void *data, int32_t thread, int32_t f)
+{
+    LP_FRAMES *fr = (LP_FRAMES *) data;
+    LPC     *lpc = &fr->lpc[thread];
+    MYFLT   *coef = fr->coef + f * fr->nvals, *fp1;
+    double  errn, rms1, rms2, filterCoef[MAXPOLES+1], *dfp;
+    int32_t i, j, n, indic, poleFound;
+    double  pr, pi, pm, pp, dPI = atan2(0,-1);
+    double  polePart1[MAXPOLES], polePart2[MAXPOLES];
+    double  z1, workArray1[MAXPOLES];
+#ifdef _DEBUG
+    double  polyReal[MAXPOLES], polyImag[MAXPOLES];
+#endif
+
+    fr->found[f] = lpc->poleCount;
+    if (fr->noise != NULL)
+      lpc->noise = fr->noise + f * lpc->WINDIN;
+#ifdef TRACE_POLES
+    csound->Message
+      (csound, "%s", Str("Starting new frame...\n"));
+#endif
+    alpol(csound, lpc, fr->sig + f * fr->slice,
+          &errn, &rms1, &rms2, filterCoef);
+    /* Transfer results */
+    coef[0] = (MYFLT)rms2;
+    coef[1] = (MYFLT)rms1;
+    coef[2] = (MYFLT)errn;
+/*  for (fp1=coef+NDATA, dfp=cc+poleCount, n=poleCount; n--; ) */
+/*    *fp1++ = - (MYFLT) *--dfp; */  /* rev coefs & chng sgn */
+
+    /* Prepare buffer for output */
+
+    if (fr->storePoles) {
+      /* Treat (swap) filter coefs for resolution */
+
+      filterCoef[lpc->poleCount] = 1.0;
+      for (i=0; i<(lpc->poleCount+1)/2; i++) {
+        j = lpc->poleCount-1-i;
+        z1 = filterCoef[i];
+        filterCoef[i] = filterCoef[j];
+        filterCoef[j] = z1;
+      }
+
+      /* Get the Filter Poles */
+
+      polyzero(lpc->poleCount,filterCoef,polePart1,polePart2,
+               &poleFound,2000,&indic,workArray1);
+
+      if (UNLIKELY(poleFound<lpc->poleCount)) {
+        fr->found[f] = poleFound;       /* reported when writing */
+        return;
+      }
+      InvertPoles(lpc->poleCount,polePart1,polePart2);
+
+#ifdef TRACE_POLES
+      DumpPoles(csound,
+                lpc->poleCount, polePart1, polePart2, 0, "Extracted Poles");
+#endif
+
+#ifdef _DEBUG
+      /* Resynthetize the filter for check */
+      InvertPoles(lpc->poleCount,polePart1,polePart2);
+
+      synthetize(lpc->poleCount,polePart1,polePart2,polyReal,polyImag);
+      for (i=0; i<lpc->poleCount; i++) {
+#ifdef TRACE_FILTER
+        csound->Message(csound, "filterCoef: %f\n", filterCoef[i]);
+#endif
+        if (UNLIKELY(filterCoef[i]-polyReal[lpc->poleCount-i]>1e-10))
+          csound->Message(csound, Str("Error in coef %d : %f <> %f\n"),
+                                  i, filterCoef[i], polyReal[lpc->poleCount-i]);
+      }
+      csound->Message(csound,".");
+      InvertPoles(lpc->poleCount,polePart1,polePart2);
+#endif
+      /* Switch to pole magnitude and phase */
+
+      for (i=0; i<lpc->poleCount;i++) {
+        /* Store magnitude and phase (PI,-PI) */
+        pr = polePart1[i];
+        pi = polePart2[i];
+        pm = hypot(pr, pi);
+        if (pm!=0) {
+          pp = atan2(pi,pr);
+          if (pp>dPI)
+            pp = 2*dPI-pp;
+        }
+        else
+          pp = 0;
+        polePart1[i] = pm;
+        polePart2[i] = pp;
+      }
+
+/*    DumpPoles(csound, poleCount,polePart1,polePart2,1,"About to store"); */
+
+      /* Store in output buffer */
+      fp1 = coef+NDATA;
+      for (i=0; i<lpc->poleCount;i++) {
+        *fp1++ = (MYFLT)polePart1[i];
+        *fp1++ = (MYFLT)polePart2[i];
+      }
+    }
+    else {
+      /* Move filter data into output buffer */
+      dfp = filterCoef+lpc->poleCount;
+      fp1 = coef+NDATA;
+      for (n=0;n<lpc->poleCount; n++)
+        *fp1++ = - (MYFLT) *--dfp;
+    }
+}
+
 static void quit(CSOUND *csound, char *msg)
 {
     csound->Message(csound,"lpanal: %s\n", msg);
@@ -827,7 +901,8 @@ static void alpol(CSOUND *csound, LPC *thislp, MYFLT *sig, double *errn,
     for (xp=thislp->x; xp-thislp->x < thislp->WINDIN;++xp,++sig) {
       /* VL 24.06.21 - adding a little noise to allow pole analysis
          to be carried out with silences */
-      *xp = (double) *sig + (thislp->storePoles ? noise(0.0001) : 0.);
+      *xp = (double) *sig +
+        (thislp->storePoles ? thislp->noise[xp - thislp->x] : 0.);
     }
 
    /* Build system to be solved */
@@ -998,6 +1073,7 @@ static const char *usage_txt[] = {
   Str_noop("-g\tgraphical display of results"),
   Str_noop("-a\t\talternate (pole) file storage"),
   Str_noop("-n\t\t use Durbin method for linear prediction"),
+  Str_noop("-j<num>\tnumber of analysis threads (default as csound -j)"),
   Str_noop("-- fname\tLog output to file"),
   Str_noop("see also:  Csound Manual Appendix"),
     NULL
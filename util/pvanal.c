@@ -117,9 +117,11 @@ static  int32_t pvxanal(CSOUND *csound, SOUNDIN *p, SNDFILE *fd,
                         int64_t srate, int64_t chans, int64_t fftsize,
                         int64_t overlap, int64_t winsize,
                         pv_wtype wintype,
-                        double beta, int32_t displays);
-static  int64_t    generate_frame(CSOUND*, PVX *pvx, MYFLT *fbuf, float *outanal,
-                                        int64_t samps, int32_t frametype);
+                        double beta, int32_t displays, int32_t nthreads);
+static  void    frame_input(PVX *pvx, MYFLT *fbuf, MYFLT *anal, int64_t samps);
+static  void    frame_spectrum(CSOUND *, void *, int32_t, int32_t);
+static  void    frame_output(PVX *pvx, MYFLT *anal, const double *phase,
+                             float *outanal, int32_t frametype);
 static  void    chan_split(CSOUND*, const MYFLT *inbuf, MYFLT **chbuf,
                                     int64_t insize, int64_t chans);
 static  int32_t     init(CSOUND *csound,
@@ -145,6 +147,19 @@ static  int32_t     quit(CSOUND *, char *msg);
 #define MAXPVXCHANS     (8)
 #define DEFAULT_BUFLEN  (8192)  /* per channel */
 #define DISPFRAMES      30
+#define PVX_BATCH       16      /* frames per thread analysed together */
+
+/* frames whose input has been windowed, waiting for their FFT and
+   conversion; the FFTs of a batch are shared out among the threads */
+typedef struct {
+    PVX     *pvx[MAXPVXCHANS];
+    int32_t nthreads, batch, count;
+    int64_t N;
+    MYFLT   *anal;          /* N + 2 values per frame */
+    double  *phase;         /* N/2 + 1 phases per frame */
+    int32_t *chan;          /* channel of each frame */
+    int32_t progress;       /* print frame count while analysing */
+} PVX_FRAMES;
 
 static int32_t pvanal(CSOUND *csound, int32_t argc, char **argv)
 {
@@ -164,6 +179,7 @@ static int32_t pvanal(CSOUND *csound, int32_t argc, char **argv)
     char    err_msg[512];
     double  beta = 6.8;
     int32_t displays = 0;
+    int32_t nthreads = 0;
 
 
     if (UNLIKELY(!(--argc)))
@@ -224,6 +240,9 @@ static int32_t pvanal(CSOUND *csound, int32_t argc, char **argv)
           break;
         case 'g':  displays = 1;
             break;
+        case 'j':  FIND(Str("no number of threads"));
+          sscanf(s, "%d", &nthreads);
+          break;
         case 'G':  FIND(Str("no latch"));
           sscanf(s, "%d", &latch);
           displays = 1;
@@ -301,7 +320,8 @@ static int32_t pvanal(CSOUND *csound, int32_t argc, char **argv)
     if (UNLIKELY(pvxanal(csound, p, infd, outfilnam, p->sr,
                         ((!channel || channel == ALLCHNLS) ? p->nchanls : 1),
                         frameSize, frameIncr, frameSize * 2,
-                         WindowType, beta, displays) != 0)) {
+                         WindowType, beta, displays,
+                         util_threads(csound, nthreads)) != 0)) {
       csound->Message(csound, "%s", Str("error generating pvocex file.\n"));
       return -1;
     }
@@ -324,6 +344,7 @@ static const char *pvanal_usage_txt[] = {
   Str_noop("    -H: use Hamming window instead of the default (von Hann)"),
   Str_noop("    -K: use Kaiser window"),
   Str_noop("    -B <beta>: parameter for Kaiser window"),
+  Str_noop("    -j <threads>: number of analysis threads"),
     NULL
 };
 
@@ -403,9 +424,60 @@ static void PVDisplay_Display(PVDISPLAY *p, int32_t frame)
 
 /* cannot add display code, as we may have 8 channels here...*/
 
+/* FFTs and conversion of the queued frames, then write them out in order */
+static int32_t flush_frames(CSOUND *csound, PVX_FRAMES *q, int32_t pvfile,
+                            float **frame_c, int64_t chans,
+                            int64_t *blocks_written, int32_t displays,
+                            PVDISPLAY *disp)
+{
+    int32_t i;
+
+    util_parallel(csound, q->nthreads, q->count, frame_spectrum, q);
+    for (i = 0; i < q->count; i++) {
+      int32_t k = q->chan[i];
+      float   *frame = frame_c[k];
+
+      frame_output(q->pvx[k], q->anal + i * (q->N + 2),
+                   q->phase + i * (q->N / 2 + 1), frame, PVOC_AMP_FREQ);
+      if (UNLIKELY(!csound->PVOC_PutFrames(csound, pvfile, frame, 1))) {
+        csound->Message(csound,
+                        Str("pvxanal: error writing analysis frames: %s\n"),
+                        csound->PVOC_ErrorString(csound));
+        q->count = 0;
+        return 1;
+      }
+      (*blocks_written)++;
+      if (displays) PVDisplay_Update(disp, frame);
+      if (q->progress && (*blocks_written/chans) % 20 == 0) {
+        csound->Message(csound, "%"PRId64"\n", *blocks_written/chans);
+      }
+      if (displays && (q->progress || k == chans - 1))
+        PVDisplay_Display(disp, (int32_t) (*blocks_written / chans));
+    }
+    q->count = 0;
+    return 0;
+}
+
+/* window the next frame of channel k into the queue, analysing the queue
+   when it is full */
+static int32_t queue_frame(CSOUND *csound, PVX_FRAMES *q, int32_t k,
+                           MYFLT *chanbuf, int64_t overlap, int32_t pvfile,
+                           float **frame_c, int64_t chans,
+                           int64_t *blocks_written, int32_t displays,
+                           PVDISPLAY *disp)
+{
+    frame_input(q->pvx[k], chanbuf, q->anal + q->count * (q->N + 2), overlap);
+    q->chan[q->count++] = k;
+    if (q->count == q->batch)
+      return flush_frames(csound, q, pvfile, frame_c, chans,
+                          blocks_written, displays, disp);
+    return 0;
+}
+
 static int32_t pvxanal(CSOUND *csound, SOUNDIN *p, SNDFILE *fd, const char *fname,
                    int64_t srate, int64_t chans, int64_t fftsize, int64_t overlap,
-                   int64_t winsize, pv_wtype wintype, double beta, int32_t displays)
+                   int64_t winsize, pv_wtype wintype, double beta, int32_t displays,
+                   int32_t nthreads)
 {
     int32_t         i, k, pvfile = -1, rc = 0;
     pv_stype    stype = STYPE_16;
@@ -416,10 +488,10 @@ static int32_t pvxanal(CSOUND *csound, SOUNDIN *p, SNDFILE *fd, const char *fnam
     MYFLT       *inbuf_c[MAXPVXCHANS];
     float       *frame_c[MAXPVXCHANS];  /* RWD : MUST be 32bit  */
     MYFLT       *inbuf = NULL;
-    float       *frame;                 /* RWD : MUST be 32bit  */
     MYFLT       *chanbuf;
     int64_t        total_sampsread = 0;
     PVDISPLAY   disp;
+    PVX_FRAMES  q;
 
     switch (p->format) {
       case AE_SHORT:  stype = STYPE_16; break;
@@ -446,6 +518,22 @@ static int32_t pvxanal(CSOUND *csound, SOUNDIN *p, SNDFILE *fd, const char *fnam
     if (rc)
       goto error;
 
+    /* queue of frames to be analysed by the threads */
+    for (i = 0; i < MAXPVXCHANS; i++)
+      q.pvx[i] = pvx[i];
+    q.nthreads = nthreads;
+    q.batch = PVX_BATCH * nthreads;
+    q.count = 0;
+    q.N = pvx[0]->N;
+    q.progress = 1;
+    q.anal = (MYFLT *) csound->Calloc(csound,
+                                      q.batch * (q.N + 2) * sizeof(MYFLT));
+    q.phase = (double *) csound->Malloc(csound,
+                                        q.batch * (q.N / 2 + 1) * sizeof(double));
+    q.chan = (int32_t *) csound->Malloc(csound, q.batch * sizeof(int32_t));
+    /* set up the FFT tables before the threads use them */
+    csound->RealFFTnp2(csound, q.anal, (int32_t) q.N);
+
     /* alloc all buffers */
     buflen = DEFAULT_BUFLEN;
     /* snap to overlap size*/
@@ -487,25 +575,15 @@ static int32_t pvxanal(CSOUND *csound, SOUNDIN *p, SNDFILE *fd, const char *fnam
 
       for (i = 0; i < sampsread/chans; i+= overlap) {
         for (k = 0; k < chans; k++) {
-          frame = frame_c[k];
           chanbuf = inbuf_c[k];
           if (UNLIKELY(!csound->CheckEvents(csound)))
             csound->LongJmp(csound, 1);
-          generate_frame(csound, pvx[k],chanbuf+i,frame,overlap,PVOC_AMP_FREQ);
-          if (UNLIKELY(!csound->PVOC_PutFrames(csound, pvfile, frame, 1))) {
-            csound->Message(csound,
-                            Str("pvxanal: error writing analysis frames: %s\n"),
-                            csound->PVOC_ErrorString(csound));
+          if (UNLIKELY(queue_frame(csound, &q, k, chanbuf+i, overlap, pvfile,
+                                   frame_c, chans, &blocks_written,
+                                   displays, &disp))) {
             rc = 1;
             goto error;
           }
-          blocks_written++;
-          if (displays) PVDisplay_Update(&disp, frame);
-          if ((blocks_written/chans) % 20 == 0) {
-            csound->Message(csound, "%"PRId64"\n", blocks_written/chans);
-          }
-          if (displays)
-            PVDisplay_Display(&disp, (int32_t) (blocks_written / chans));
         }
       }
       if (total_sampsread >= p->getframes*chans)
@@ -518,24 +596,29 @@ static int32_t pvxanal(CSOUND *csound, SOUNDIN *p, SNDFILE *fd, const char *fnam
     /*   inbuf[i] = FL(0.0); */
     memset(inbuf, 0, sizeof(MYFLT)*sampsread);
     chan_split(csound,inbuf,inbuf_c,sampsread,chans);
+    if (UNLIKELY(flush_frames(csound, &q, pvfile, frame_c, chans,
+                              &blocks_written, displays, &disp))) {
+      rc = 1;
+      goto error;
+    }
+    q.progress = 0;
     for (i = 0; i < sampsread/chans; i+= overlap) {
       for (k = 0; k < chans; k++) {
-        frame = frame_c[k];
         chanbuf = inbuf_c[k];
         if (!csound->CheckEvents(csound))
           csound->LongJmp(csound, 1);
-        generate_frame(csound,pvx[k],chanbuf+i,frame,overlap,PVOC_AMP_FREQ);
-        if (UNLIKELY(!csound->PVOC_PutFrames(csound, pvfile, frame, 1))) {
-          csound->Message(csound,
-                          Str("pvxanal: error writing analysis frames: %s\n"),
-                          csound->PVOC_ErrorString(csound));
+        if (UNLIKELY(queue_frame(csound, &q, k, chanbuf+i, overlap, pvfile,
+                                 frame_c, chans, &blocks_written,
+                                 displays, &disp))) {
           rc = 1;
           goto error;
         }
-        blocks_written++;
-        if (displays) PVDisplay_Update(&disp, frame);
       }
-      if (displays) PVDisplay_Display(&disp, (int32_t) (blocks_written / chans));
+    }
+    if (UNLIKELY(flush_frames(csound, &q, pvfile, frame_c, chans,
+                              &blocks_written, displays, &disp))) {
+      rc = 1;
+      goto error;
     }
     csound->Message(csound, Str("\n%"PRId64" %d-chan blocks written to %s\n"),
                     (int64_t) blocks_written / (int64_t) chans,
@@ -705,19 +788,14 @@ static int32_t init(CSOUND *csound,
 #define MAX(a,b) (a>b ? a : b)
 #define MIN(a,b) (a<b ? a : b)
 
-/* RWD outanal MUST be 32bit */
+/* input and windowing of the next frame: this has to be done in order,
+   as the input buffer is circular */
 
-static int64_t generate_frame(CSOUND *csound, PVX *pvx,
-                                           MYFLT *fbuf, float *outanal,
-                                           int64_t samps, int32_t frametype)
+static void frame_input(PVX *pvx, MYFLT *fbuf, MYFLT *anal, int64_t samps)
 {
     int32_t     got, tocp, i, j, k;
     int64_t    N = pvx->N;
-    MYFLT   *fp, *oi, *i0, *i1, real, imag, *anal, angleDif;
-    double  rratio, phase;
-    float   *ofp;           /* RWD MUST be 32bit */
-
-    anal = pvx->anal;
+    MYFLT   *fp;
 
     got = samps;            /* always assume */
     if (got < pvx->Dd)
@@ -775,7 +853,46 @@ static int64_t generate_frame(CSOUND *csound, PVX *pvx,
         k -= N;
       *(anal + k) += *(pvx->analWindow + i) * *(pvx->input + j);
     }
-    csound->RealFFTnp2(csound, anal, pvx->N);
+
+    pvx->nI += pvx->D;                          /* increment time */
+    pvx->Dd = MIN(pvx->D,                       /* CARL */
+                  MAX(0, pvx->D + pvx->nMax - pvx->nI - pvx->analWinLen));
+}
+
+/* FFT of queued frame n, leaving magnitudes in anal and phases in phase;
+   frames are independent here, so this runs on the analysis threads */
+
+static void frame_spectrum(CSOUND *csound, void *data, int32_t thread,
+                           int32_t n)
+{
+    PVX_FRAMES *q = (PVX_FRAMES *) data;
+    const int64_t N = q->N;
+    MYFLT   *anal = q->anal + n * (N + 2), *i0, *i1, real, imag;
+    double  *phase = q->phase + n * (N / 2 + 1);
+    int32_t i;
+    IGN(thread);
+
+    csound->RealFFTnp2(csound, anal, (int32_t) N);
+    for (i=0,i0=anal,i1=anal+1; i <= N/2; i++,i0+=2,i1+=2) {
+      real = *i0;
+      imag = *i1;
+      *i0 =(MYFLT) hypot((double)real, (double)imag);
+      /*if (*i0 == 0.)*/
+      if (*i0 >= FL(1.0E-10))       /* RWD don't mess with v small numbers! */
+        phase[i] = atan2((double)imag,(double)real);
+    }
+}
+
+/* RWD outanal MUST be 32bit */
+
+static void frame_output(PVX *pvx, MYFLT *anal, const double *phase,
+                         float *outanal, int32_t frametype)
+{
+    int32_t     i;
+    int64_t    N = pvx->N;
+    MYFLT   *fp, *oi, *i0, *i1, angleDif;
+    float   *ofp;           /* RWD MUST be 32bit */
+
     /* conversion: The real and imaginary values in anal are converted to
        magnitude and angle-difference-per-second (assuming an
        intermediate sampling rate of rIn) and are returned in
@@ -785,18 +902,13 @@ static int64_t generate_frame(CSOUND *csound, PVX *pvx,
       for (i=0,i0=anal,i1=anal+1,oi=pvx->oldInPhase;
            i <= pvx->N2;
            i++,i0+=2,i1+=2, oi++) {
-        real = *i0;
-        imag = *i1;
-        *i0 =(MYFLT) hypot((double)real, (double)imag);
-        /* phase unwrapping */
-        /*if (*i0 == 0.)*/
+        /* phase unwrapping, which needs the phases of the previous frame */
         if (*i0 < FL(1.0E-10))        /* RWD don't mess with v small numbers! */
           angleDif = FL(0.0);
 
         else {
-          rratio = atan2((double)imag,(double)real);
-          angleDif  = (MYFLT)((phase = rratio) - *oi);
-          *oi = (MYFLT) phase;
+          angleDif  = (MYFLT)(phase[i] - *oi);
+          *oi = (MYFLT) phase[i];
         }
 
         if (angleDif > PI)
@@ -813,12 +925,6 @@ static int64_t generate_frame(CSOUND *csound, PVX *pvx,
     ofp = outanal;
     for (i=0;i < N+2;i++)
       *ofp++ = (float) *fp++;  /* RWD need 32bit cast incase MYFLT is double */
-
-    pvx->nI += pvx->D;                          /* increment time */
-    pvx->Dd = MIN(pvx->D,                       /* CARL */
-                  MAX(0, pvx->D + pvx->nMax - pvx->nI - pvx->analWinLen));
-
-    return pvx->D;
 }
 
 static void chan_split(CSOUND *csound, const MYFLT *inbuf, MYFLT **chbuf,
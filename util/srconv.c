@@ -28,20 +28,18 @@
  *
  *    DATE:      August 26, 1989
  *
- *    COMMENTS:  srconv takes floats on stdin at sample rate Rin and
- *               outputs them on stdout at sample rate Rout.  optionally,
- *               the ratio (Rin / Rout)  may be linearly time-varying
- *               according to a set of (time, ratio) pairs in an auxiliary file.
+ *    COMMENTS:  srconv converts a soundfile at sample rate Rin to
+ *               sample rate Rout.
  *
  *               flags:
  *
  *                    r = output sample rate (must be specified)
- *                    R = input sample rate (must be specified)
  *                    P = input sample rate / output sample rate
  *                    Q = quality factor (1 to 8: default = 2)
- *                    if a time-varying control file is given, it must be last
+ *                    j = number of threads
  *
  *    MODIFIED:  John ffitch December 2000; changes to Csound context
+ *               streaming conversion with the library resampler
  */
 
 #include "std_util.h"
@@ -49,9 +47,7 @@
 #include <math.h>
 #include <ctype.h>
 
-#define IBUF    (4096)
-#define IBUF2   (IBUF/2)
-#define OBUF    (4096)
+#define SRC_BLOCK   (65536)     /* input frames per block */
 
 #define FIND(MSG)                                                   \
 {                                                                   \
@@ -61,9 +57,6 @@
       }                                                             \
 }
 
-//static  void    kaiser(int, float *, int, int, double);
-
-#if 0
 static  void    usage(CSOUND *);
 
 static int writebuffer(CSOUND *csound, MYFLT *out_buf, int *block,
@@ -143,76 +136,56 @@ static void dieu(CSOUND *csound, char *s)
     usage(csound);
 }
 
-static int srconv(CSOUND *csound, int argc, char **argv)
+/* one block of the conversion, the channels of which are converted in
+   parallel */
+typedef struct {
+    void    *rs;
+    MYFLT   *in, *out;
+    int     nin;
+    int     nout[UTIL_MAX_THREADS];
+} SRC_BLK;
+
+static void src_channel(CSOUND *csound, void *data, int32_t thread,
+                        int32_t chn)
 {
-    MYFLT
-      *input,     /* pointer to start of input buffer */
-      *output,    /* pointer to start of output buffer */
-      *nextIn,    /* pointer to next empty word in input */
-      *nextOut,   /* pointer to next empty word in output */
-      *fxval = 0, /* pointer to startb of time-array for time-vary function */
-      *fyval = 0, /* pointer to start of P-scale-array for time-vary func */
-      *i0,        /* pointer */
-      *i1;        /* pointer */
-
-    float
-      *window,    /* pointer to center of analysis window */
-      *wj,        /* pointer to window */
-      *wj1;       /* pointer to window */
+    SRC_BLK *b = (SRC_BLK *) data;
+    int     n = csound->Resample(csound, b->rs, chn, b->in, b->nin, b->out);
 
-    int
-      M = 2401,   /* length of window impulse response */
-      N = 120,    /* length of sinc period */
-      L = 120,    /* internal sample rate is L*Rin */
-      m,          /* current input sample in buffer */
-      o,          /* current input at L*Rin mod L */
-      del,        /* increment */
-      WinLen,     /* half-length of window at L*Rin */
-      wLen,       /* half-length of window at Rin */
-      jMin,       /* initial offset in window */
-      mMax;       /* maximum valid m */
-
-    long
-      n,                        /* current input sample */
-      nMax = 2000000000;        /* last input sample (unless EOF) */
+    b->nout[thread] = n;    /* the same for all channels */
+}
+
+static int src_block(CSOUND *csound, SRC_BLK *b, int nthreads, int Chans)
+{
+    if (nthreads > 1 && Chans > 1) {
+      util_parallel(csound, nthreads, Chans, src_channel, b);
+      return b->nout[0];
+    }
+    return csound->Resample(csound, b->rs, -1, b->in, b->nin, b->out);
+}
 
+static int srconv(CSOUND *csound, int argc, char **argv)
+{
     MYFLT
-      beta = FL(6.8),           /* parameter for Kaiser window */
-      sum,                      /* scale factor for renormalizing windows */
-      fdel,                     /* float del */
-      idel,                     /* float del */
-      fo,                       /* float o */
-      of,                       /* fractional o */
-      fL = (MYFLT) L,           /* float L */
-      iw,                       /* interpolated window */
-      tvx0 = 0,                 /* current x value of time-var function */
-      tvx1 = 0,                 /* next x value of time-var function */
-      tvdx,                     /* tvx1 - tvx0 */
-      tvy0 = 0,                 /* current y value of time-var function */
-      tvy1 = 0,                 /* next y value of time-var function */
-      tvdy,                     /* tvy1 - tvy0 */
-      tvslope = 0,              /* tvdy / tvdx */
-      time,                     /* n / Rin */
-      invRin,                   /* 1. / Rin */
+      *input,     /* input block */
+      *output,    /* output block */
       P = FL(0.0),              /* Rin / Rout */
       Rin = FL(0.0),            /* input sampling rate */
-      Rout = FL(0.0);           /* output sample rate */
+      Rout = FL(0.0),           /* output sample rate */
+      scale;                    /* 1 / 0dbfs */
 
     int
-      i,k,                      /* index variables */
-      nread,                    /* number of bytes read */
-      tvflg = 0,                /* flag for time-varying time-scaling */
-      tvnxt = 0,                /* counter for stepping thru time-var func */
-      tvlen,                    /* length of time-varying function */
+      i,                        /* index variable */
+      nread,                    /* number of samples read */
+      nout,                     /* number of frames converted */
       Chans = 1,                /* number of channels */
-      chan,                     /* current channel */
-      Q = 2;                    /* quality factor */
+      Q = 2,                    /* quality factor */
+      nthreads = 0;             /* number of threads */
 
-    FILE        *tvfp = NULL;   /* time-vary function file */
+    SRC_BLK     blk;
     SOUNDIN     *p;
     int         channel = ALLCHNLS;
     MYFLT       beg_time = FL(0.0), input_dur = FL(0.0), sr = FL(0.0);
-    char        *infile = NULL, *bfile = NULL;
+    char        *infile = NULL;
     SNDFILE     *inf = NULL;
     char        c, *s;
     const char  *envoutyp;
@@ -223,7 +196,7 @@ static int srconv(CSOUND *csound, int argc, char **argv)
     int         block = 0;
     char        err_msg[256];
 
-    O.outformat = AE_SHORT;
+    memset(&O, 0, sizeof(OPARMS));
     /* csound->e0dbfs = csound->dbfs_to_float = FL(1.0);*/
 
     if ((envoutyp = csound->GetEnv(csound, "SFOUTYP")) != NULL) {
@@ -305,6 +278,11 @@ static int srconv(CSOUND *csound, int argc, char **argv)
             sscanf(s,"%d", &Q);
             while (*++s);
             break;
+          case 'j':
+            FIND(Str("no number of threads"))
+            sscanf(s,"%d", &nthreads);
+            while (*++s);
+            break;
           case 'P':
             FIND(Str("No P argument"))
 #if defined(USE_DOUBLE)
@@ -324,11 +302,9 @@ static int srconv(CSOUND *csound, int argc, char **argv)
             while (*++s);
             break;
           case 'i':
-            FIND(Str("No break file"))
-            tvflg = 1;
-            bfile = s;
-            while ((*s++)) {}; s--;
-            break;
+            csound->ErrorMsg(csound, "%s", Str("srconv: time-varying "
+                                               "conversion is not supported"));
+            return -1;
           default:
             csound->Message(csound, Str("Looking at %c\n"), c);
             usage(csound);    /* this exits with error */
@@ -356,11 +332,9 @@ static int srconv(CSOUND *csound, int argc, char **argv)
       csound->ErrorMsg(csound, Str("error while opening %s"), infile);
       return -1;
     }
-    if (Rin == FL(0.0))
-      Rin = (MYFLT)p->sr;
-    if (Chans == 0)
-      Chans = (int) p->nchanls;
-    if (Chans == 0)
+    Rin = (MYFLT) p->sr;
+    Chans = (int) p->nchanls;
+    if (Chans < 1)
       Chans = 1;
 
     if ((P != FL(0.0)) && (Rout != FL(0.0))) {
@@ -371,73 +345,11 @@ static int srconv(CSOUND *csound, int argc, char **argv)
       Rout = Rin / P;
     else if (Rout == FL(0.0))
       Rout = Rin;
-
-    if (tvflg) {
-      P = FL(0.0);        /* will be reset to max in time-vary function */
-      if ((tvfp = fopen(bfile, "r")) == NULL) {
-        strNcpy(err_msg,
-                Str("srconv: cannot open time-vary function file"), 256);
-        goto err_rtn_msg;
-      }
-      /* register file to be closed by csoundReset() */
-      (void) csound->CreateFileHandle(csound, &tvfp, CSFILE_STD, bfile);
-      if (UNLIKELY(fscanf(tvfp, "%d", &tvlen) != 1))
-        csound->Message(csound, "%s", Str("Read failure\n"));
-      if (UNLKELY(tvlen <= 0)) {
-            strNcpy(err_msg, Str("srconv: tvlen <= 0 "), 256);
-            goto err_rtn_msg;
-       }
-      fxval = (MYFLT*) csound->Malloc(csound, tvlen * sizeof(MYFLT));
-      fyval = (MYFLT*) csound->Malloc(csound, tvlen * sizeof(MYFLT));
-      i0 = fxval;
-      i1 = fyval;
-      for (i = 0; i < tvlen; i++, i0++, i1++) {
-#ifdef USE_DOUBLE
-        if ((fscanf(tvfp, "%lf %lf", i0, i1)) != 2)
-#else
-        if ((fscanf(tvfp, "%f %f", i0, i1)) != 2)
-#endif
-          {
-            strNcpy(err_msg, Str("srconv: too few x-y pairs "
-                                 "in time-vary function file"), 256);
-            goto err_rtn_msg;
-          }
-        if (*i1 > P)
-          P = *i1;
-      }
-      Rout = Rin / P;    /* this is min Rout */
-      tvx0 = fxval[0];
-      tvx1 = fxval[1];
-      tvy0 = fyval[0];
-      tvy1 = fyval[1];
-      tvdx = tvx1 - tvx0;
-      if (tvx0 != FL(0.0)) {
-        strNcpy(err_msg, Str("srconv: first x value "
-                             "in time-vary function must be 0"), 256);
-        goto err_rtn_msg;
-      }
-      if (tvy0 <= FL(0.0)) {
-        strNcpy(err_msg, Str("srconv: invalid initial y value "
-                             "in time-vary function"),256);
-        goto err_rtn_msg;
-      }
-      if (tvdx <= FL(0.0)) {
-        strNcpy(err_msg,
-                       Str("srconv: invalid x values in time-vary function"),
-                       256);
-        goto err_rtn_msg;
-      }
-      tvdy = tvy1 - tvy0;
-      tvslope = tvdy / tvdx;
-      tvnxt = 1;
-    }
-    /* This is not right *********  */
-    if (P != FL(0.0)) {
-      csound->SetUtilSr(csound,Rin);
-    }
-    if (P == FL(0.0)) {
-      csound->SetUtilSr(csound,Rout);
+    if (UNLIKELY(Rout <= FL(0.0))) {
+      strNcpy(err_msg, Str("srconv: invalid output sample rate"), 256);
+      goto err_rtn_msg;
     }
+    csound->SetUtilSr(csound, Rout);
 
     if (O.outformat == 0)
       O.outformat = AE_SHORT;//p->format;
@@ -448,12 +360,6 @@ static int srconv(CSOUND *csound, int argc, char **argv)
     }
     else
       O.sfheader = 1;
-#ifdef NeXT
-    if (O.outfilename == NULL && !O.filetyp)
-      O.outfilename = "test.snd";
-    else if (O.outfilename == NULL)
-      O.outfilename = "test";
-#else
     if (O.outfilename == NULL) {
       if (O.filetyp == TYP_WAV)
         O.outfilename = "test.wav";
@@ -462,14 +368,12 @@ static int srconv(CSOUND *csound, int argc, char **argv)
       else
         O.outfilename = "test";
     }
-#endif
     {
       SF_INFO sfinfo;
       char    *name;
       memset(&sfinfo, 0, sizeof(SF_INFO));
       sfinfo.samplerate = (int) ((double) Rout + 0.5);
-      sfinfo.channels = (int) p->nchanls;
-      //printf("filetyp=%x outformat=%x\n", O.filetyp, O.outformat);
+      sfinfo.channels = Chans;
       sfinfo.format = TYPE2SF(O.filetyp) | FORMAT2SF(O.outformat);
       if (strcmp(O.outfilename, "stdout") != 0) {
         name = csound->FindOutputFile(csound, O.outfilename, "SFDIR");
@@ -484,7 +388,8 @@ static int srconv(CSOUND *csound, int argc, char **argv)
                                                            O.outformat),
                                    1, 0);
         else {
-          snprintf(err_msg, 256, Str("libsndfile error: %s\n"), sf_strerror(NULL));
+          snprintf(err_msg, 256, Str("libsndfile error: %s\n"),
+                   sf_strerror(NULL));
           goto err_rtn_msg;
         }
         csound->Free(csound, name);
@@ -500,288 +405,68 @@ static int srconv(CSOUND *csound, int argc, char **argv)
                                       O.outfilename);
       sf_command(outfd, SFC_SET_CLIPPING, NULL, SF_TRUE);
     }
-    csound->SetUtilSr(csound, (MYFLT)p->sr);
-    csound->SetUtilNchnls(csound, Chans = p->nchanls);
+    csound->SetUtilNchnls(csound, Chans);
 
-    outbufsiz = OBUF * O.sfsampsize;                   /* calc outbuf size */
+    outbufsiz = SRC_BLOCK * O.sfsampsize;              /* calc outbuf size */
     csound->Message(csound, Str("writing %d-byte blks of %s to %s"),
                     outbufsiz, csound->getstrformat(O.outformat),
                     O.outfilename);
     csound->Message(csound, " (%s)\n", csound->type2string(O.filetyp));
 
- /* this program performs arbitrary sample-rate conversion
-    with high fidelity.  the method is to step through the
-    input at the desired sampling increment, and to compute
-    the output points as appropriately weighted averages of
-    the surrounding input points.  there are two cases to
-    consider: 1) sample rates are in a small-integer ratio -
-    weights are obtained from table, 2) sample rates are in
-    a large-integer ratio - weights are linearly
-    interpolated from table.  */
-
- /* calculate increment: if decimating, then window is impulse response of low-
-    pass filter with cutoff frequency at half of Rout; if interpolating,
-    then window is ipulse response of lowpass filter with cutoff frequency
-    at half of Rin. */
-
-    fdel = ((MYFLT) (L * Rin) / Rout);
-    del = (int) ((double) fdel + 0.5);
-    idel = (MYFLT) del;
-    if (del > L)
-      N = del;
-    if ((Q >= 1) && (Q <= 8))
-      M = Q * N * 10 + 1;
-    if (tvflg)
-      fdel = tvy0 * L;
-
-    invRin  =  FL(1.0) / Rin;
-
-    /* make window: the window is the product of a kaiser and a sin(x)/x */
-    window = (float*) csound->Calloc(csound, (size_t) (M + 2) * sizeof(float));
-    WinLen = (M-1)/2;
-    window += WinLen;
-    wLen = (M/2 - L) / L;
-
-    kaiser(M, window, WinLen, 1, (double) beta);
-
-    for (i = 1; i <= WinLen; i++) {
-      double  tmp = (double) N;
-      tmp = tmp * sin(PI * (double) i / tmp) / (PI * (double) i);
-      window[i] = (float) ((double) window[i] * tmp);
-    }
-
-    if (Rout < Rin) {
-#if 0
-      sum = (MYFLT) window[0];
-      for (i = L-1; i <= WinLen; i += L)
-        sum += (MYFLT) window[i];
-      sum = FL(2.0) / sum;
-#else
-      sum = Rout / (Rin * (MYFLT) window[0]);
-#endif
-    }
-    else
-      sum = FL(1.0) / (MYFLT) window[0];
-
-    window[0] = (float) ((double) window[0] * (double) sum);
-    for (i = 1; i <= WinLen; i++) {
-      window[i] = (float) ((double) window[i] * (double) sum);
-      *(window - i) = window[i];
-    }
-
-    window[WinLen + 1] = 0.0f;
-
- /* set up input buffer:  nextIn always points to the next empty
-    word in the input buffer.  If the buffer is full, then
-    nextIn jumps back to the beginning, and the old values
-    are written over. */
-
-    input = (MYFLT*) csound->Calloc(csound, (size_t) IBUF * sizeof(MYFLT));
-
- /* set up output buffer:  nextOut always points to the next empty
-    word in the output buffer.  If the buffer is full, then
-    it is flushed, and nextOut jumps back to the beginning. */
-
-    output = (MYFLT*) csound->Calloc(csound, (size_t) OBUF * sizeof(MYFLT));
-    nextOut = output;
-
- /* initialization: */
-
-    nread = csound->getsndin(csound, inf, input, IBUF2, p);
-    for(i=0; i < nread; i++)
-       input[i] *= 1.0/csound->Get0dBFS(csound);
-    nMax = (long)(input_dur * p->sr);
-    nextIn = input + nread;
-    for (i = nread; i < IBUF2; i++)
-      *(nextIn++) = FL(0.0);
-    jMin = -(wLen + 1) * L;
-    mMax = IBUF2;
-    o = n = m = 0;
-    fo = FL(0.0);
-
- /* main loop:   If nMax is not specified it is assumed to be very large
-    and then readjusted when read detects the end of input. */
-
-    while (n < nMax) {
-
-      time = n * invRin;
-
-      /* case 1:  (Rin / Rout) * 120 = integer  */
-
-      if ((tvflg == 0) && (idel == fdel)) {
-        /* apply window (window is sampled at L * Rin) */
-
-        for (chan = 0; chan < Chans; chan++) {
-          *nextOut = FL(0.0);
-          k = Chans * (m - wLen) + chan - Chans;
-          if (k < 0)
-            k += IBUF;
-          wj = window + jMin - o;
-          for (i = -wLen; i <= wLen+1; i++){
-            wj += L;
-            k += Chans;
-            if (k >= IBUF)
-              k -= IBUF;
-            *nextOut += (MYFLT) *wj * *(input + k);
-          }
-          nextOut++;
-          if (nextOut >= (output + OBUF)) {
-            nextOut = output;
-            writebuffer(csound, output, &block, outfd, OBUF, &O);
-          }
-        }
-
-        /* move window (window advances by del samples at L*Rin sample rate) */
-
-        o += del;
-        while (o >= L) {
-          o -= L;
-          n++;
-          m++;
-          if ((Chans * (m + wLen + 1)) >= mMax) {
-            if (!csound->CheckEvents(csound))
-              csound->LongJmp(csound, 1);
-            mMax += IBUF2;
-            if (nextIn >= (input + IBUF))
-              nextIn = input;
-            nread = csound->getsndin(csound, inf, nextIn, IBUF2, p);
-            for(i=0; i < nread; i++)
-               input[i] *= 1.0/csound->Get0dBFS(csound);
-            nextIn += nread;
-            if (nread < IBUF2)
-              nMax = n + wLen + (nread / Chans) + 1;
-            for (i = nread; i < IBUF2; i++)
-              *(nextIn++) = FL(0.0);
-          }
-          if ((Chans * m) >= IBUF) {
-            m = 0;
-            mMax = IBUF2;
-          }
-        }
-      }
-
-      /* case 2: (Rin / Rout) * 120 = non-integer constant */
-
-      else {
-
-        /* apply window (window values are linearly interpolated) */
-
-        for (chan = 0; chan < Chans; chan++) {
-          *nextOut = FL(0.0);
-          o = (int)fo;
-          of = fo - o;
-          wj = window + jMin - o;
-          wj1 = wj + 1;
-          k = Chans * (m - wLen) + chan - Chans;
-          if (k < 0)
-            k += IBUF;
-          for (i = -wLen; i <= wLen+1; i++) {
-            wj += L;
-            wj1 += L;
-            k += Chans;
-            if (k >= IBUF)
-              k -= IBUF;
-            iw = (MYFLT) *wj + of * ((MYFLT) *wj1 - (MYFLT) *wj);
-            *nextOut += iw * *(input + k);
-          }
-          nextOut++;
-          if (nextOut >= (output + OBUF)) {
-            nextOut = output;
-            writebuffer(csound, output, &block, outfd, OBUF, &O);
-          }
-        }
-
-        /* move window */
-
-        fo += fdel;
-        while (fo >= fL) {
-          fo -= fL;
-          n++;
-          m++;
-          if ((Chans * (m + wLen + 1)) >= mMax) {
-            if (!csound->CheckEvents(csound))
-              csound->LongJmp(csound, 1);
-            mMax += IBUF2;
-            if (nextIn >= (input + IBUF))
-              nextIn = input;
-            nread = csound->getsndin(csound, inf, nextIn, IBUF2, p);
-            for(i=0; i < nread; i++)
-               input[i] *= 1.0/csound->Get0dBFS(csound);
-            nextIn += nread;
-            if (nread < IBUF2)
-              nMax = n + wLen + (nread / Chans) + 1;
-            for (i = nread; i < IBUF2; i++)
-              *(nextIn++) = FL(0.0);
-          }
-          if ((Chans * m) >= IBUF) {
-            m = 0;
-            mMax = IBUF2;
-          }
-        }
-
-        if (tvflg && (time > FL(0.0))) {
-          while (tvflg && (time >= tvx1)) {
-            if (++tvnxt >= tvlen)
-              tvflg = 0;
-            else {
-              tvx0 = tvx1;
-              tvx1 = fxval[tvnxt];
-              tvy0 = tvy1;
-              tvy1 = fyval[tvnxt];
-              tvdx = tvx1 - tvx0;
-              if (tvdx <= FL(0.0)) {
-                strNcpy(err_msg, Str("srconv: invalid x values "
-                                     "in time-vary function"), 256);
-                goto err_rtn_msg;
-              }
-              tvdy = tvy1 - tvy0;
-              tvslope = tvdy / tvdx;
-            }
-          }
-          P = tvy0 + tvslope * (time - tvx0);
-          fdel = (MYFLT) L * P;
-        }
-      }
+ /* the conversion is done by the polyphase resampler of the library, a
+    block at a time, converting the channels of each block in parallel */
 
+    blk.rs = csound->ResamplerCreate(csound, Rin, Rout, Chans, Q);
+    if (UNLIKELY(blk.rs == NULL)) {
+      strNcpy(err_msg, Str("srconv: invalid sample rates"), 256);
+      goto err_rtn_msg;
     }
-    nread = nextOut - output;
-    writebuffer(csound, output, &block, outfd, nread, &O);
+    nthreads = util_threads(csound, nthreads);
+    input = (MYFLT*) csound->Malloc(csound, (size_t) SRC_BLOCK * Chans
+                                    * sizeof(MYFLT));
+    output = (MYFLT*) csound->Malloc(csound, (size_t)
+                                     csound->ResamplerFrames(csound, blk.rs,
+                                                             SRC_BLOCK)
+                                     * Chans * sizeof(MYFLT));
+    blk.in = input;
+    blk.out = output;
+    scale = FL(1.0) / csound->Get0dBFS(csound);
+    do {
+      nread = csound->getsndin(csound, inf, input, SRC_BLOCK * Chans, p);
+      if (nread <= 0)
+        break;
+      for (i = 0; i < nread; i++)
+        input[i] *= scale;
+      blk.nin = nread / Chans;
+      nout = src_block(csound, &blk, nthreads, Chans);
+      writebuffer(csound, output, &block, outfd, nout * Chans, &O);
+      if (!csound->CheckEvents(csound))
+        csound->LongJmp(csound, 1);
+    } while (nread == SRC_BLOCK * Chans);
+    blk.in = NULL;          /* end of input */
+    blk.nin = 0;
+    nout = src_block(csound, &blk, nthreads, Chans);
+    writebuffer(csound, output, &block, outfd, nout * Chans, &O);
+    csound->ResamplerDestroy(csound, blk.rs);
+    csound->Free(csound, input);
+    csound->Free(csound, output);
     csound->Message(csound, "\n\n");
     if (O.ringbell)
       csound->MessageS(csound, CSOUNDMSG_REALTIME, "\a");
     return 0;
 
  err_rtn_msg:
-    csound->ErrorMsg(csound, err_msg);
+    csound->ErrorMsg(csound, "%s", err_msg);
     return -1;
 }
-#else
-
-#ifndef WIN32
-#include <unistd.h>
-#endif
-
-static int srconv(CSOUND *csound, int argc, char **argv)
-{
-  (void) argc;
-    csound->Message(csound, "%s",
-                    Str("Do not use srconv but the src_conv program\n"));
-#ifndef MSVC
-    return execv("src_conv", argv);
-#else
-    return 0;
-#endif
-}
-#endif
 
-#if 0
 static const char *usage_txt[] = {
   Str_noop("usage: srconv [flags] infile\n\nflags:"),
   Str_noop("-P num\tpitch transposition ratio (srate/r) [do not specify "
            "both P and r]"),
   Str_noop("-Q num\tquality factor (1 to 8: default = 2)"),
-  Str_noop("-i filnam\tbreak file"),
   Str_noop("-r num\toutput sample rate (must be specified)"),
+  Str_noop("-j num\tnumber of threads converting channels (as csound -j)"),
   Str_noop("-o fnam\tsound output filename\n"),
   Str_noop("-A\tcreate an AIFF format output soundfile"),
   Str_noop("-J\tcreate an IRCAM format output soundfile"),
@@ -794,8 +479,6 @@ static const char *usage_txt[] = {
   Str_noop("-s\tshort_int sound samples"),
   Str_noop("-l\tlong_int sound samples"),
   Str_noop("-f\tfloat sound samples"),
-  Str_noop("-r N\torchestra srate override"),
-  Str_noop("-K\tDo not generate PEAK chunks"),
   Str_noop("-R\tcontinually rewrite header while writing soundfile (WAV/AIFF)"),
   Str_noop("-H#\tprint a heartbeat style 1, 2 or 3 at each soundfile write"),
   Str_noop("-N\tnotify (ring the bell) when score or miditrack is done"),
@@ -811,54 +494,6 @@ static void usage(CSOUND *csound)
       csound->Message(csound, "%s\n", Str(usage_txt[i]));
 }
 
-static double ino(double x)
-{
-    double  y, t, e, de, sde, xi;
-    int     i;
-
-    y = x * 0.5;
-    t = 1.0e-08;
-    e = 1.0;
-    de = 1.0;
-    for (i = 1; i <= 25; i++) {
-      xi = (double) i;
-      de = de * y / xi;
-      sde = de * de;
-      e += sde;
-      if (e * t > sde)
-        break;
-    }
-    return e;
-}
-
-static void kaiser(int nf, float *w, int n, int ieo, double beta)
-{
-
-/*
-   nf = filter length in samples
-    w = window array of size n
-    n = filter half length=(nf+1)/2
-  ieo = even odd indicator--ieo=0 if nf even
- beta = parameter of kaiser window
-*/
-
-    double  bes, xind, xi;
-    int     i;
-
-    bes = ino(beta);
-    xind = (double) ((nf - 1) * (nf - 1));
-
-    for (i = 0; i < n; i++) {
-      xi = (double) i;
-      if (ieo == 0)
-        xi += 0.5;
-      xi = 4.0 * xi * xi;
-      xi = sqrt(1.0 - (double) (xi / xind));
-      w[i] = (float) (ino(beta * xi) / bes);
-    }
-}
-#endif
-
 /* module interface */
 
 int srconv_init_(CSOUND *csound)
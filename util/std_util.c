@@ -55,6 +55,178 @@ strNcpy(char *dst, const char *src, size_t siz)
     return dst;        /* count does not include NUL */
 }
 
+/* Number of threads for an analysis utility: the -j flag of the utility
+   if given, otherwise that of the engine (csound -j N -U ...) */
+int32_t util_threads(CSOUND *csound, int32_t requested)
+{
+    int32_t n = requested;
+
+    if (n <= 0) {
+      OPARMS O;
+      csound->GetOParms(csound, &O);
+      n = O.numThreads;
+    }
+    if (n < 1)
+      n = 1;
+    if (n > UTIL_MAX_THREADS)
+      n = UTIL_MAX_THREADS;
+    return n;
+}
+
+/* The threads are kept from one batch to the next, in a pool that lasts
+   until the instance is reset: worker i waits on start[i] for a batch,
+   and notifies done[i] when it has run its share of it */
+
+typedef struct UTIL_POOL_ UTIL_POOL;
+
+typedef struct {
+    UTIL_POOL *pool;
+    int32_t thread;
+} UTIL_WORKER;
+
+struct UTIL_POOL_ {
+    CSOUND  *csound;
+    int32_t wanted, nthreads;   /* threads asked for, and running */
+    int32_t quit;
+    UTIL_JOB job;               /* the current batch */
+    void    *userData;
+    int32_t nitems, nused;
+    UTIL_WORKER w[UTIL_MAX_THREADS];
+    void    *thread[UTIL_MAX_THREADS];
+    void    *start[UTIL_MAX_THREADS], *done[UTIL_MAX_THREADS];
+};
+
+static void util_run_items(UTIL_POOL *pool, int32_t thread)
+{
+    int32_t i;
+
+    /* items are dealt out in a fixed order, so that each of them is computed
+       by the same code whatever the number of threads */
+    for (i = thread; i < pool->nitems; i += pool->nused)
+      pool->job(pool->csound, pool->userData, thread, i);
+}
+
+static uintptr_t util_worker(void *data)
+{
+    UTIL_WORKER *w = (UTIL_WORKER *) data;
+    UTIL_POOL   *pool = w->pool;
+    CSOUND      *csound = pool->csound;
+
+    for (;;) {
+      csound->WaitThreadLockNoTimeout(pool->start[w->thread]);
+      if (pool->quit)
+        break;
+      util_run_items(pool, w->thread);
+      csound->NotifyThreadLock(pool->done[w->thread]);
+    }
+    return 0;
+}
+
+static void util_pool_destroy(CSOUND *csound, UTIL_POOL *pool)
+{
+    int32_t i;
+
+    pool->quit = 1;
+    for (i = 1; i < pool->nthreads; i++) {
+      csound->NotifyThreadLock(pool->start[i]);
+      csound->JoinThread(pool->thread[i]);
+      csound->DestroyThreadLock(pool->start[i]);
+      csound->DestroyThreadLock(pool->done[i]);
+    }
+    csound->Free(csound, pool);
+}
+
+static int32_t util_pool_reset(CSOUND *csound, void *userData)
+{
+    UTIL_POOL **pp = (UTIL_POOL **) userData;
+
+    if (*pp != NULL)
+      util_pool_destroy(csound, *pp);
+    *pp = NULL;
+    return OK;
+}
+
+/* The pool of the instance, started with nthreads threads (the calling
+   thread being one of them) unless it already has them. Threads that
+   cannot be started are left out, the batches being shared among those
+   that could. */
+static UTIL_POOL *util_pool(CSOUND *csound, int32_t nthreads)
+{
+    UTIL_POOL **pp, *pool;
+    int32_t   i;
+
+    pp = (UTIL_POOL **) csound->QueryGlobalVariable(csound, "utilPool_");
+    if (pp == NULL) {
+      if (UNLIKELY(csound->CreateGlobalVariable(csound, "utilPool_",
+                                                sizeof(UTIL_POOL *)) != 0))
+        return NULL;
+      pp = (UTIL_POOL **) csound->QueryGlobalVariable(csound, "utilPool_");
+      csound->RegisterResetCallback(csound, (void *) pp, util_pool_reset);
+    }
+    if (*pp != NULL && (*pp)->wanted >= nthreads)
+      return *pp;
+    if (*pp != NULL)
+      util_pool_destroy(csound, *pp);
+    pool = *pp = (UTIL_POOL *) csound->Calloc(csound, sizeof(UTIL_POOL));
+    pool->csound = csound;
+    pool->wanted = nthreads;
+    for (i = 1; i < nthreads; i++) {
+      pool->start[i] = csound->CreateThreadLock();
+      pool->done[i] = csound->CreateThreadLock();
+      if (UNLIKELY(pool->start[i] == NULL || pool->done[i] == NULL))
+        break;
+      csound->WaitThreadLock(pool->start[i], 0);
+      csound->WaitThreadLock(pool->done[i], 0);
+      pool->w[i].pool = pool;
+      pool->w[i].thread = i;
+      pool->thread[i] = csound->CreateThread(util_worker, &pool->w[i]);
+      if (UNLIKELY(pool->thread[i] == NULL))
+        break;
+    }
+    if (i < nthreads) {
+      if (pool->start[i] != NULL)
+        csound->DestroyThreadLock(pool->start[i]);
+      if (pool->done[i] != NULL)
+        csound->DestroyThreadLock(pool->done[i]);
+      csound->Warning(csound, Str("analysis: could only start %d threads"),
+                      (int) i);
+    }
+    pool->nthreads = i;
+    return pool;
+}
+
+/* Run job for items 0 .. nitems-1 on nthreads threads (the calling thread
+   being one of them) and return when all are done */
+void util_parallel(CSOUND *csound, int32_t nthreads, int32_t nitems,
+                   UTIL_JOB job, void *userData)
+{
+    UTIL_POOL *pool = NULL;
+    int32_t   i;
+
+    if (nthreads > nitems)
+      nthreads = nitems;
+    if (nthreads > UTIL_MAX_THREADS)
+      nthreads = UTIL_MAX_THREADS;
+    if (nthreads > 1)
+      pool = util_pool(csound, nthreads);
+    if (pool == NULL || pool->nthreads < 2) {
+      for (i = 0; i < nitems; i++)
+        job(csound, userData, 0, i);
+      return;
+    }
+    if (nthreads > pool->nthreads)
+      nthreads = pool->nthreads;
+    pool->job = job;
+    pool->userData = userData;
+    pool->nitems = nitems;
+    pool->nused = nthreads;
+    for (i = 1; i < nthreads; i++)
+      csound->NotifyThreadLock(pool->start[i]);
+    util_run_items(pool, 0);
+    for (i = 1; i < nthreads; i++)
+      csound->WaitThreadLockNoTimeout(pool->done[i]);
+}
+
 /* module interface */
 
 PUBLIC int32_t csoundModuleCreate(CSOUND *csound)
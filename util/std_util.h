@@ -45,5 +45,18 @@ extern int32_t sndinfo_init_(CSOUND *);
 extern int32_t srconv_init_(CSOUND *);
 extern int32_t xtrct_init_(CSOUND *);
 
+/* frame-parallel execution for the analysis utilities */
+
+#define UTIL_MAX_THREADS 64
+
+/* work item 'item' of a batch, run on thread 'thread' (0 .. nthreads-1) */
+typedef void (*UTIL_JOB)(CSOUND *, void *userData, int32_t thread,
+                         int32_t item);
+
+extern int32_t util_threads(CSOUND *, int32_t requested);
+/* run a batch on the instance's thread pool, which is kept until reset */
+extern void    util_parallel(CSOUND *, int32_t nthreads, int32_t nitems,
+                             UTIL_JOB job, void *userData);
+
 #endif  /* CSOUND_STD_UTIL_H */
 